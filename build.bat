@@ -11,8 +11,17 @@ REM Either "debug" or "release" (no quotes).
 REM If not specified, will default to debug.
 SET build_mode=%1
 
+REM READ ANY OPTIONAL INSTRUMENTATION COMMAND LINE ARGUMENT.
+REM Specifying "track_allocations" (no quotes) replaces the global allocator
+REM to report allocations by compiler phase and call site.
+REM Specifying "internal_checks" (no quotes) checks the compiler's own data
+REM structures while compiling each translation unit.
+SET instrumentation=%2
+
 REM DEFINE COMPILER OPTIONS.
 SET COMMON_COMPILER_OPTIONS=/EHsc /W4 /TP /std:c++latest
+IF "%instrumentation%"=="track_allocations" SET COMMON_COMPILER_OPTIONS=%COMMON_COMPILER_OPTIONS% /DALLOCATION_TRACKING=1
+IF "%instrumentation%"=="internal_checks" SET COMMON_COMPILER_OPTIONS=%COMMON_COMPILER_OPTIONS% /DINTERNAL_CHECKS=1
 SET DEBUG_COMPILER_OPTIONS=%COMMON_COMPILER_OPTIONS% /Z7 /Od /MTd
 SET RELEASE_COMPILER_OPTIONS=%COMMON_COMPILER_OPTIONS% /O2 /MT
 
@@ -0,0 +1,51 @@
+#!/bin/sh
+
+# READ THE BUILD MODE COMMAND LINE ARGUMENT.
+# Either "debug" or "release" (no quotes).
+# If not specified, will default to debug.
+build_mode=$1
+
+# READ ANY OPTIONAL INSTRUMENTATION COMMAND LINE ARGUMENT.
+# Specifying "track_allocations" (no quotes) replaces the global allocator
+# to report allocations by compiler phase and call site.
+# Specifying "internal_checks" (no quotes) checks the compiler's own data
+# structures while compiling each translation unit.
+instrumentation=$2
+
+# DEFINE COMPILER OPTIONS.
+# The compiler can be overridden with the CXX environment variable.
+COMPILER=${CXX:-c++}
+COMMON_COMPILER_OPTIONS="-std=c++20 -Wall -Wextra -pthread -x c++"
+if [ "$instrumentation" = "track_allocations" ]; then
+    COMMON_COMPILER_OPTIONS="$COMMON_COMPILER_OPTIONS -DALLOCATION_TRACKING=1 -rdynamic"
+fi
+if [ "$instrumentation" = "internal_checks" ]; then
+    COMMON_COMPILER_OPTIONS="$COMMON_COMPILER_OPTIONS -DINTERNAL_CHECKS=1"
+fi
+DEBUG_COMPILER_OPTIONS="$COMMON_COMPILER_OPTIONS -g -O0"
+RELEASE_COMPILER_OPTIONS="$COMMON_COMPILER_OPTIONS -O2"
+
+# DEFINE FILES TO COMPILE/LINK.
+COMPILATION_FILE="../Compiler.project"
+MAIN_CODE_DIR="../code"
+
+# CREATE THE COMMAND LINE OPTIONS FOR THE FILES TO COMPILE/LINK.
+INCLUDE_DIRS="-I $MAIN_CODE_DIR"
+OUTPUT_FILE="-o Compiler"
+
+# MOVE INTO THE BUILD DIRECTORY.
+mkdir -p build
+cd build || exit 1
+
+    # BUILD THE PROGRAM BASED ON THE BUILD MODE.
+    if [ "$build_mode" = "release" ]; then
+        $COMPILER $RELEASE_COMPILER_OPTIONS $INCLUDE_DIRS $COMPILATION_FILE $OUTPUT_FILE || exit 1
+    else
+        $COMPILER $DEBUG_COMPILER_OPTIONS $INCLUDE_DIRS $COMPILATION_FILE $OUTPUT_FILE || exit 1
+    fi
+
+    ./Compiler
+
+cd ..
+
+echo Done
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace CACHING
+{
+    /// Computes fast 64-bit hashes of file contents.
+    /// The algorithm is XXH64, which processes 32 bytes per iteration and
+    /// is much faster than byte-at-a-time hashes for large files.
+    /// Hashes are identical across platforms since input is always read
+    /// as little-endian words.
+    struct ContentHash
+    {
+        /// Computes the hash of some data.
+        /// @param[in] data - The data to hash.
+        /// @param[in] seed - A seed to mix into the hash.
+        /// @return The hash of the data.
+        static std::uint64_t Compute(const std::string_view data, const std::uint64_t seed = 0)
+        {
+            const unsigned char* current_byte = reinterpret_cast<const unsigned char*>(data.data());
+            const unsigned char* end_byte = current_byte + data.size();
+            std::uint64_t hash = 0;
+
+            // PROCESS 32-BYTE STRIPES WITH 4 INDEPENDENT ACCUMULATORS.
+            constexpr std::size_t STRIPE_SIZE_IN_BYTES = 32;
+            if (data.size() >= STRIPE_SIZE_IN_BYTES)
+            {
+                std::uint64_t accumulator_1 = seed + PRIME_1 + PRIME_2;
+                std::uint64_t accumulator_2 = seed + PRIME_2;
+                std::uint64_t accumulator_3 = seed;
+                std::uint64_t accumulator_4 = seed - PRIME_1;
+
+                const unsigned char* last_stripe_start = end_byte - STRIPE_SIZE_IN_BYTES;
+                while (current_byte <= last_stripe_start)
+                {
+                    accumulator_1 = Round(accumulator_1, Read64(current_byte));
+                    accumulator_2 = Round(accumulator_2, Read64(current_byte + 8));
+                    accumulator_3 = Round(accumulator_3, Read64(current_byte + 16));
+                    accumulator_4 = Round(accumulator_4, Read64(current_byte + 24));
+                    current_byte += STRIPE_SIZE_IN_BYTES;
+                }
+
+                hash = RotateLeft(accumulator_1, 1) + RotateLeft(accumulator_2, 7) + RotateLeft(accumulator_3, 12) + RotateLeft(accumulator_4, 18);
+                hash = MergeRound(hash, accumulator_1);
+                hash = MergeRound(hash, accumulator_2);
+                hash = MergeRound(hash, accumulator_3);
+                hash = MergeRound(hash, accumulator_4);
+            }
+            else
+            {
+                hash = seed + PRIME_5;
+            }
+
+            hash += static_cast<std::uint64_t>(data.size());
+
+            // PROCESS ANY REMAINING BYTES.
+            while (current_byte + 8 <= end_byte)
+            {
+                hash ^= Round(0, Read64(current_byte));
+                hash = RotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+                current_byte += 8;
+            }
+            if (current_byte + 4 <= end_byte)
+            {
+                hash ^= static_cast<std::uint64_t>(Read32(current_byte)) * PRIME_1;
+                hash = RotateLeft(hash, 23) * PRIME_2 + PRIME_3;
+                current_byte += 4;
+            }
+            while (current_byte < end_byte)
+            {
+                hash ^= (*current_byte) * PRIME_5;
+                hash = RotateLeft(hash, 11) * PRIME_1;
+                ++current_byte;
+            }
+
+            // MIX THE FINAL BITS.
+            hash ^= hash >> 33;
+            hash *= PRIME_2;
+            hash ^= hash >> 29;
+            hash *= PRIME_3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+    private:
+        static constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+        static constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+        static constexpr std::uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+        static constexpr std::uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+        static constexpr std::uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+
+        /// Rotates bits left.
+        /// @param[in] value - The value to rotate.
+        /// @param[in] bit_count - The number of bits to rotate by.
+        /// @return The rotated value.
+        static std::uint64_t RotateLeft(const std::uint64_t value, const int bit_count)
+        {
+            return (value << bit_count) | (value >> (64 - bit_count));
+        }
+
+        /// Reads a little-endian 64-bit value.
+        /// @param[in] bytes - The bytes to read from.
+        /// @return The value.
+        static std::uint64_t Read64(const unsigned char* bytes)
+        {
+            std::uint64_t value = 0;
+            for (int byte_index = 7; byte_index >= 0; --byte_index)
+            {
+                value = (value << 8) | bytes[byte_index];
+            }
+            return value;
+        }
+
+        /// Reads a little-endian 32-bit value.
+        /// @param[in] bytes - The bytes to read from.
+        /// @return The value.
+        static std::uint32_t Read32(const unsigned char* bytes)
+        {
+            std::uint32_t value = 0;
+            for (int byte_index = 3; byte_index >= 0; --byte_index)
+            {
+                value = (value << 8) | bytes[byte_index];
+            }
+            return value;
+        }
+
+        /// Mixes a 64-bit input into an accumulator.
+        /// @param[in] accumulator - The accumulator.
+        /// @param[in] input - The input to mix in.
+        /// @return The updated accumulator.
+        static std::uint64_t Round(std::uint64_t accumulator, const std::uint64_t input)
+        {
+            accumulator += input * PRIME_2;
+            accumulator = RotateLeft(accumulator, 31);
+            accumulator *= PRIME_1;
+            return accumulator;
+        }
+
+        /// Merges an accumulator into the hash.
+        /// @param[in] hash - The hash.
+        /// @param[in] accumulator - The accumulator to merge.
+        /// @return The updated hash.
+        static std::uint64_t MergeRound(std::uint64_t hash, const std::uint64_t accumulator)
+        {
+            hash ^= Round(0, accumulator);
+            hash = hash * PRIME_1 + PRIME_4;
+            return hash;
+        }
+    };
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "Caching/ContentHash.h"
+#include "Compilation/Version.h"
+#include "Files/File.h"
+#include "Files/MemoryMappedFile.h"
+#include "Serialization/BinaryReader.h"
+#include "Serialization/BinaryWriter.h"
+
+namespace CACHING
+{
+    /// Identifies a call of a function evaluated at compile time.
+    struct EvaluationKey
+    {
+        /// The hash of everything that determines the function's behavior, including any functions it calls.
+        std::uint64_t FunctionHash = 0;
+        /// The arguments of the call.
+        std::vector<std::int64_t> Arguments = {};
+
+        /// Checks if two keys identify the same call.
+        /// @param[in] other - The key to compare with.
+        /// @return True if the keys are equal; false otherwise.
+        bool operator==(const EvaluationKey& other) const = default;
+    };
+
+    /// Hashes evaluation keys for use in unordered containers.
+    struct EvaluationKeyHash
+    {
+        /// Hashes a key.
+        /// @param[in] key - The key to hash.
+        /// @return The hash of the key.
+        std::size_t operator()(const EvaluationKey& key) const
+        {
+            std::string_view argument_bytes(reinterpret_cast<const char*>(key.Arguments.data()), key.Arguments.size() * sizeof(std::int64_t));
+            return static_cast<std::size_t>(ContentHash::Compute(argument_bytes, key.FunctionHash));
+        }
+    };
+
+    /// Results of functions evaluated at compile time, so that calling the same
+    /// function with the same arguments again (such as from another translation
+    /// unit or a later run) is a lookup rather than another evaluation.
+    ///
+    /// Only pure functions may be cached, since the key only covers the function
+    /// and its arguments.  Only successful results are stored, so failed
+    /// evaluations are always repeated and report their errors again.
+    ///
+    /// The cache may be loaded before compiling and saved afterwards.  Finding
+    /// and storing results is safe to do from multiple threads at once.
+    struct EvaluationCache
+    {
+        /// Identifies evaluation cache files.
+        static constexpr std::string_view FILE_SIGNATURE = "CISHEV\r\n";
+        /// The version of the evaluation cache file layout.
+        static constexpr std::uint32_t FILE_FORMAT_VERSION = 1;
+        /// The name of the evaluation cache file within the cache directory.
+        static constexpr std::string_view FILENAME = "evaluations.cache";
+
+        /// Loads results from a file, replacing any current results.
+        /// If the file doesn't exist, is invalid, or was written by a different
+        /// compiler version (which may evaluate differently), the cache is left empty.
+        /// @param[in] filepath - The path of the cache file.
+        void Load(const std::filesystem::path& filepath)
+        {
+            using namespace SERIALIZATION;
+
+            std::lock_guard<std::mutex> lock(ResultsMutex);
+            ResultsByKey.clear();
+            Modified = false;
+            std::optional<FILES::MemoryMappedFile> cache_file = FILES::MemoryMappedFile::Open(filepath);
+            if (!cache_file)
+            {
+                return;
+            }
+
+            // VERIFY THE FILE FORMAT.
+            BinaryReader reader = { .Data = cache_file->Contents() };
+            std::optional<std::string_view> signature = reader.ReadBytes(FILE_SIGNATURE.size());
+            std::optional<std::uint32_t> file_format_version = reader.ReadUInt32();
+            std::optional<std::uint64_t> compiler_version_hash = reader.ReadUInt64();
+            bool format_matches = (
+                !reader.Failed &&
+                FILE_SIGNATURE == *signature &&
+                FILE_FORMAT_VERSION == *file_format_version &&
+                GetCompilerVersionHash() == *compiler_version_hash);
+            if (!format_matches)
+            {
+                return;
+            }
+
+            // READ EACH RESULT.
+            std::optional<std::uint32_t> result_count = reader.ReadUInt32();
+            for (std::uint32_t result_index = 0; result_count && result_index < *result_count; ++result_index)
+            {
+                EvaluationKey key;
+                std::optional<std::uint64_t> function_hash = reader.ReadUInt64();
+                std::optional<std::uint32_t> argument_count = reader.ReadUInt32();
+                for (std::uint32_t argument_index = 0; argument_count && argument_index < *argument_count; ++argument_index)
+                {
+                    std::optional<std::uint64_t> argument = reader.ReadUInt64();
+                    if (!argument)
+                    {
+                        break;
+                    }
+                    key.Arguments.push_back(static_cast<std::int64_t>(*argument));
+                }
+                std::optional<std::uint64_t> result = reader.ReadUInt64();
+                if (reader.Failed)
+                {
+                    ResultsByKey.clear();
+                    return;
+                }
+
+                key.FunctionHash = *function_hash;
+                ResultsByKey.emplace(std::move(key), static_cast<std::int64_t>(*result));
+            }
+        }
+
+        /// Saves the cache if any results were stored since it was loaded.
+        /// @param[in] filepath - The path of the cache file.
+        /// @return True if the cache is saved; false otherwise.
+        bool Save(const std::filesystem::path& filepath)
+        {
+            std::lock_guard<std::mutex> lock(ResultsMutex);
+            if (!Modified)
+            {
+                return true;
+            }
+
+            SERIALIZATION::BinaryWriter writer;
+            writer.WriteBytes(FILE_SIGNATURE);
+            writer.WriteUInt32(FILE_FORMAT_VERSION);
+            writer.WriteUInt64(GetCompilerVersionHash());
+            writer.WriteUInt32(static_cast<std::uint32_t>(ResultsByKey.size()));
+            for (const auto& [key, result] : ResultsByKey)
+            {
+                writer.WriteUInt64(key.FunctionHash);
+                writer.WriteUInt32(static_cast<std::uint32_t>(key.Arguments.size()));
+                for (std::int64_t argument : key.Arguments)
+                {
+                    writer.WriteUInt64(static_cast<std::uint64_t>(argument));
+                }
+                writer.WriteUInt64(static_cast<std::uint64_t>(result));
+            }
+
+            std::error_code error;
+            std::filesystem::create_directories(filepath.parent_path(), error);
+            bool cache_saved = FILES::File::WriteBinaryAtomically(filepath, writer.Buffer);
+            if (cache_saved)
+            {
+                Modified = false;
+            }
+            return cache_saved;
+        }
+
+        /// Finds the result of a call.
+        /// @param[in] key - The call.
+        /// @return The result, if cached; null otherwise.
+        std::optional<std::int64_t> Find(const EvaluationKey& key)
+        {
+            std::lock_guard<std::mutex> lock(ResultsMutex);
+            auto result = ResultsByKey.find(key);
+            if (ResultsByKey.end() == result)
+            {
+                ++MissCount;
+                return std::nullopt;
+            }
+            ++HitCount;
+            return result->second;
+        }
+
+        /// Stores the result of a call.
+        /// @param[in] key - The call.
+        /// @param[in] result - The result of the call.
+        void Store(EvaluationKey key, const std::int64_t result)
+        {
+            std::lock_guard<std::mutex> lock(ResultsMutex);
+            bool result_added = ResultsByKey.insert_or_assign(std::move(key), result).second;
+            Modified = Modified || result_added;
+        }
+
+        /// Gets the number of lookups that found a result.
+        /// @return The number of cache hits.
+        std::size_t GetHitCount()
+        {
+            std::lock_guard<std::mutex> lock(ResultsMutex);
+            return HitCount;
+        }
+
+        /// Gets the number of lookups that didn't find a result.
+        /// @return The number of cache misses.
+        std::size_t GetMissCount()
+        {
+            std::lock_guard<std::mutex> lock(ResultsMutex);
+            return MissCount;
+        }
+
+    private:
+        /// Gets the hash identifying the compiler version, since results are only valid for the version that evaluated them.
+        /// @return The hash of the compiler version.
+        static std::uint64_t GetCompilerVersionHash()
+        {
+            static const std::uint64_t COMPILER_VERSION_HASH = ContentHash::Compute(COMPILATION::COMPILER_VERSION, FILE_FORMAT_VERSION);
+            return COMPILER_VERSION_HASH;
+        }
+
+        /// Protects access to all other members.
+        std::mutex ResultsMutex = {};
+        /// The results of calls.
+        std::unordered_map<EvaluationKey, std::int64_t, EvaluationKeyHash> ResultsByKey = {};
+        /// True if results were stored since the cache was loaded or saved.
+        bool Modified = false;
+        /// The number of lookups that found a result.
+        std::size_t HitCount = 0;
+        /// The number of lookups that didn't find a result.
+        std::size_t MissCount = 0;
+    };
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Caching/TranslationUnitCache.h"
+
+namespace CACHING
+{
+    /// An in-memory cache of front-end results for files, keyed by path.
+    /// Unlike the on-disk cache, entries are trusted without re-reading
+    /// files, so whoever owns the cache must invalidate entries when files
+    /// change (for example, by watching for file system changes).
+    /// All methods are safe to call from multiple threads at once.
+    struct ParsedFileCache
+    {
+        /// The result of looking up a file in the cache.
+        struct LookupResult
+        {
+            /// The cached front-end results, if the file was in the cache.
+            std::shared_ptr<const CachedTranslationUnit> Results = nullptr;
+            /// The generation of the entry at the time of lookup.  Must be passed
+            /// to Store() so that results computed from a file that changed in
+            /// the meantime are never stored.
+            std::uint64_t Generation = 0;
+        };
+
+        /// Finds cached results for a file.
+        /// When the file isn't being watched yet, the file watching callback is invoked
+        /// before returning so that changes made while the caller reads the file are detected.
+        /// @param[in] filepath - The absolute path of the file.
+        /// @return The lookup result.
+        LookupResult Find(const std::filesystem::path& filepath)
+        {
+            std::string key = filepath.lexically_normal().string();
+            bool watch_needed = false;
+            LookupResult lookup_result;
+            {
+                std::lock_guard<std::mutex> lock(EntriesMutex);
+                Entry& entry = EntriesByFilepath[key];
+                watch_needed = !entry.Watched;
+                entry.Watched = true;
+                lookup_result.Results = entry.Results;
+                lookup_result.Generation = entry.Generation;
+            }
+
+            if (watch_needed && WatchFile)
+            {
+                WatchFile(filepath);
+            }
+
+            return lookup_result;
+        }
+
+        /// Stores results for a file.
+        /// Files included by the file are watched as well, and changes to them
+        /// also invalidate the results.  The watching callback is invoked before
+        /// returning, so callers must confirm included files haven't changed since
+        /// they were read (invalidating the results if they have).
+        /// @param[in] filepath - The absolute path of the file.
+        /// @param[in] cached_translation_unit - The front-end results for the file.
+        /// @param[in] generation - The generation returned when the file was looked up.
+        ///     If the file has been invalidated since then, the results aren't stored.
+        void Store(
+            const std::filesystem::path& filepath,
+            std::shared_ptr<const CachedTranslationUnit> cached_translation_unit,
+            const std::uint64_t generation)
+        {
+            std::string key = filepath.lexically_normal().string();
+            std::vector<std::filesystem::path> newly_watched_filepaths;
+            {
+                std::lock_guard<std::mutex> lock(EntriesMutex);
+                Entry& entry = EntriesByFilepath[key];
+                bool entry_unchanged_since_lookup = (generation == entry.Generation);
+                if (!entry_unchanged_since_lookup)
+                {
+                    return;
+                }
+
+                // RECORD THE FILE AS DEPENDING ON ITS INCLUDED FILES.
+                for (const PREPROCESSING::IncludedFile& included_file : cached_translation_unit->IncludedFiles)
+                {
+                    std::string included_file_key = included_file.Filepath.lexically_normal().string();
+                    DependentFilepathsByIncludedFilepath[included_file_key].insert(key);
+                    Entry& included_file_entry = EntriesByFilepath[included_file_key];
+                    if (!included_file_entry.Watched)
+                    {
+                        included_file_entry.Watched = true;
+                        newly_watched_filepaths.push_back(included_file.Filepath);
+                    }
+                }
+                entry.Results = std::move(cached_translation_unit);
+            }
+
+            if (WatchFile)
+            {
+                for (const std::filesystem::path& newly_watched_filepath : newly_watched_filepaths)
+                {
+                    WatchFile(newly_watched_filepath);
+                }
+            }
+        }
+
+        /// Discards any cached results for a file and any files that include it.
+        /// @param[in] filepath - The absolute path of the file.
+        void Invalidate(const std::filesystem::path& filepath)
+        {
+            std::string key = filepath.lexically_normal().string();
+            std::lock_guard<std::mutex> lock(EntriesMutex);
+            InvalidateEntry(key);
+
+            auto dependent_filepaths = DependentFilepathsByIncludedFilepath.find(key);
+            if (DependentFilepathsByIncludedFilepath.end() != dependent_filepaths)
+            {
+                for (const std::string& dependent_filepath : dependent_filepaths->second)
+                {
+                    InvalidateEntry(dependent_filepath);
+                }
+                DependentFilepathsByIncludedFilepath.erase(dependent_filepaths);
+            }
+        }
+
+        /// Discards all cached results.
+        /// Used when changes may have been missed, so files are watched again
+        /// the next time they are looked up.
+        void InvalidateAll()
+        {
+            std::lock_guard<std::mutex> lock(EntriesMutex);
+            for (auto& [key, entry] : EntriesByFilepath)
+            {
+                entry.Results = nullptr;
+                entry.Watched = false;
+                ++entry.Generation;
+            }
+            DependentFilepathsByIncludedFilepath.clear();
+        }
+
+        /// Called when a file is looked up but not yet watched so that changes to it can be detected.
+        std::function<void(const std::filesystem::path&)> WatchFile = nullptr;
+
+    private:
+        /// An entry for a single file.
+        struct Entry
+        {
+            /// The cached results, if valid results exist.
+            std::shared_ptr<const CachedTranslationUnit> Results = nullptr;
+            /// Incremented each time the entry is invalidated.
+            std::uint64_t Generation = 0;
+            /// True if the file watching callback has been invoked for the file.
+            bool Watched = false;
+        };
+
+        /// Discards an entry's results.  The entries mutex must already be locked.
+        /// @param[in] key - The key of the entry.
+        void InvalidateEntry(const std::string& key)
+        {
+            auto entry = EntriesByFilepath.find(key);
+            if (EntriesByFilepath.end() != entry)
+            {
+                entry->second.Results = nullptr;
+                ++entry->second.Generation;
+            }
+        }
+
+        /// Guards access to the entries.
+        std::mutex EntriesMutex = {};
+        /// Entries by normalized absolute file path.
+        std::unordered_map<std::string, Entry> EntriesByFilepath = {};
+        /// The files with cached results that include each file, by normalized absolute path of the included file.
+        std::unordered_map<std::string, std::unordered_set<std::string>> DependentFilepathsByIncludedFilepath = {};
+    };
+}
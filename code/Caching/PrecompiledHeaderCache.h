@@ -0,0 +1,381 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "Caching/ContentHash.h"
+#include "Compilation/PrecompiledHeader.h"
+#include "Compilation/Version.h"
+#include "Files/File.h"
+#include "Files/MemoryMappedFile.h"
+#include "Preprocessing/HeaderCache.h"
+#include "Preprocessing/IncludedFile.h"
+#include "Preprocessing/MacroTable.h"
+#include "Serialization/BinaryReader.h"
+#include "Serialization/BinaryWriter.h"
+#include "Serialization/FrontEndReader.h"
+#include "Serialization/FrontEndWriter.h"
+#include "Tokenization/Token.h"
+
+namespace CACHING
+{
+    /// An on-disk cache of precompiled headers, so that a prefix header only
+    /// needs to be processed once across many runs of the compiler.
+    ///
+    /// Each entry is a header identifying the configuration it was built with,
+    /// the files it depends on (with their contents' hashes), the preprocessor
+    /// state, and finally the header's tokens and declarations in the binary
+    /// format described by FrontEndFormat, which is read directly from the
+    /// memory-mapped entry.  Names and other strings used by macros are
+    /// interned in a string table within the entry so that each is stored
+    /// (and later read) only once.
+    struct PrecompiledHeaderCache
+    {
+        /// Identifies precompiled header files.
+        static constexpr std::string_view FILE_SIGNATURE = "CISHPH\r\n";
+        /// The version of the precompiled header file layout.
+        static constexpr std::uint32_t FILE_FORMAT_VERSION = 4;
+        /// The extension for precompiled header files.
+        static constexpr std::string_view FILE_EXTENSION = ".pch";
+
+        /// Computes the key for a precompiled header.
+        /// @param[in] header_filepath - The canonical path of the header.
+        /// @param[in] include_directories - The directories searched for included files.
+        /// @param[in] macro_definitions - Macros defined on the command line.
+        /// @return The key for the precompiled header.
+        static std::uint64_t ComputeKey(
+            const std::filesystem::path& header_filepath,
+            const std::vector<std::filesystem::path>& include_directories,
+            const std::vector<std::string>& macro_definitions)
+        {
+            static const std::uint64_t COMPILER_VERSION_HASH = ContentHash::Compute(COMPILATION::COMPILER_VERSION, FILE_FORMAT_VERSION);
+            std::uint64_t key = ContentHash::Compute(header_filepath.string(), COMPILER_VERSION_HASH);
+            for (const std::filesystem::path& include_directory : include_directories)
+            {
+                key = ContentHash::Compute(include_directory.string(), key);
+            }
+            for (const std::string& macro_definition : macro_definitions)
+            {
+                key = ContentHash::Compute(macro_definition, key);
+            }
+            return key;
+        }
+
+        /// Gets the path of the precompiled header file for a key.
+        /// @param[in] key - The key of the precompiled header.
+        /// @return The path of the precompiled header file.
+        std::filesystem::path GetEntryFilepath(const std::uint64_t key) const
+        {
+            char filename[32] = {};
+            std::snprintf(filename, sizeof(filename), "%016" PRIx64, key);
+            std::filesystem::path entry_filepath = Directory / filename;
+            entry_filepath += FILE_EXTENSION;
+            return entry_filepath;
+        }
+
+        /// Loads a precompiled header.
+        /// @param[in] key - The key of the precompiled header.
+        /// @param[in,out] header_cache - The cache of included files, for checking if they changed.
+        /// @return The precompiled header, if a valid and up-to-date entry exists; null otherwise.
+        std::optional<COMPILATION::PrecompiledHeader> Load(const std::uint64_t key, PREPROCESSING::HeaderCache& header_cache) const
+        {
+            using namespace SERIALIZATION;
+
+            // MAP THE ENTRY.
+            std::optional<FILES::MemoryMappedFile> entry_file = FILES::MemoryMappedFile::Open(GetEntryFilepath(key));
+            if (!entry_file)
+            {
+                return std::nullopt;
+            }
+
+            // VERIFY THE ENTRY IS FOR THE REQUESTED HEADER.
+            BinaryReader reader = { .Data = entry_file->Contents() };
+            std::optional<std::string_view> signature = reader.ReadBytes(FILE_SIGNATURE.size());
+            std::optional<std::uint32_t> file_format_version = reader.ReadUInt32();
+            constexpr std::size_t PADDING_SIZE_IN_BYTES = sizeof(std::uint32_t);
+            reader.ReadBytes(PADDING_SIZE_IN_BYTES);
+            std::optional<std::uint64_t> entry_key = reader.ReadUInt64();
+            std::optional<std::string_view> header_filepath = reader.ReadString();
+            bool entry_matches = (
+                !reader.Failed &&
+                FILE_SIGNATURE == *signature &&
+                FILE_FORMAT_VERSION == *file_format_version &&
+                key == *entry_key);
+            if (!entry_matches)
+            {
+                return std::nullopt;
+            }
+            COMPILATION::PrecompiledHeader precompiled_header;
+            precompiled_header.Preprocessed.HeaderFilepath = *header_filepath;
+
+            // VERIFY NO INCLUDED FILES HAVE CHANGED.
+            std::optional<std::uint32_t> included_file_count = reader.ReadUInt32();
+            for (std::uint32_t included_file_index = 0; included_file_count && included_file_index < *included_file_count; ++included_file_index)
+            {
+                std::optional<std::string_view> included_filepath = reader.ReadString();
+                std::optional<std::uint64_t> included_file_content_hash = reader.ReadUInt64();
+                if (reader.Failed)
+                {
+                    return std::nullopt;
+                }
+
+                PREPROCESSING::IncludedFile included_file =
+                {
+                    .Filepath = *included_filepath,
+                    .ContentHash = *included_file_content_hash,
+                };
+                if (!included_file.IsUnchanged(header_cache))
+                {
+                    return std::nullopt;
+                }
+                precompiled_header.Preprocessed.IncludedFiles.push_back(std::move(included_file));
+            }
+
+            // READ THE REMAINING PREPROCESSOR STATE.
+            std::optional<std::uint32_t> once_only_filepath_count = reader.ReadUInt32();
+            for (std::uint32_t filepath_index = 0; once_only_filepath_count && filepath_index < *once_only_filepath_count; ++filepath_index)
+            {
+                std::optional<std::string_view> once_only_filepath = reader.ReadString();
+                if (once_only_filepath)
+                {
+                    precompiled_header.Preprocessed.OnceOnlyFilepaths.emplace_back(*once_only_filepath);
+                }
+            }
+            std::optional<std::string_view> messages = reader.ReadString();
+            if (messages)
+            {
+                precompiled_header.Preprocessed.Messages = *messages;
+            }
+            bool macros_read = ReadMacros(reader, precompiled_header.Preprocessed.Macros);
+            reader.ReadBytes(GetPaddingSize(reader.CurrentOffset));
+            if (!macros_read || reader.Failed)
+            {
+                return std::nullopt;
+            }
+
+            // READ THE TOKENS AND DECLARATIONS.
+            std::string_view front_end_data = reader.Data.substr(reader.CurrentOffset);
+            std::optional<FrontEndReader> front_end_reader = FrontEndReader::Open(front_end_data);
+            if (!front_end_reader)
+            {
+                return std::nullopt;
+            }
+            std::optional<Program> program = front_end_reader->ToProgram();
+            if (!program)
+            {
+                return std::nullopt;
+            }
+            precompiled_header.Preprocessed.Tokens = front_end_reader->ToTokenStream();
+            precompiled_header.ParsedProgram = std::move(*program);
+            return precompiled_header;
+        }
+
+        /// Stores a precompiled header.
+        /// @param[in] key - The key of the precompiled header.
+        /// @param[in] precompiled_header - The precompiled header to store.
+        /// @return True if the entry was stored; false otherwise.
+        bool Store(const std::uint64_t key, const COMPILATION::PrecompiledHeader& precompiled_header) const
+        {
+            using namespace SERIALIZATION;
+
+            // SERIALIZE THE ENTRY.
+            const PREPROCESSING::PreprocessorSnapshot& preprocessed = precompiled_header.Preprocessed;
+            BinaryWriter writer;
+            writer.WriteBytes(FILE_SIGNATURE);
+            writer.WriteUInt32(FILE_FORMAT_VERSION);
+            // Padding keeps the following fields aligned.
+            writer.WriteUInt32(0);
+            writer.WriteUInt64(key);
+            writer.WriteString(preprocessed.HeaderFilepath.string());
+            writer.WriteUInt32(static_cast<std::uint32_t>(preprocessed.IncludedFiles.size()));
+            for (const PREPROCESSING::IncludedFile& included_file : preprocessed.IncludedFiles)
+            {
+                writer.WriteString(included_file.Filepath.string());
+                writer.WriteUInt64(included_file.ContentHash);
+            }
+            writer.WriteUInt32(static_cast<std::uint32_t>(preprocessed.OnceOnlyFilepaths.size()));
+            for (const std::string& once_only_filepath : preprocessed.OnceOnlyFilepaths)
+            {
+                writer.WriteString(once_only_filepath);
+            }
+            writer.WriteString(preprocessed.Messages);
+            WriteMacros(preprocessed.Macros, writer);
+            writer.Buffer.resize(writer.Buffer.size() + GetPaddingSize(writer.Buffer.size()), '\0');
+            writer.WriteBytes(FrontEndWriter::Write(preprocessed.Tokens, precompiled_header.ParsedProgram));
+
+            // WRITE THE ENTRY.
+            std::error_code error;
+            std::filesystem::create_directories(Directory, error);
+            bool entry_stored = FILES::File::WriteBinaryAtomically(GetEntryFilepath(key), writer.Buffer);
+            return entry_stored;
+        }
+
+        /// The directory containing precompiled headers.
+        std::filesystem::path Directory = "";
+
+    private:
+        /// Flags for macro definitions.
+        enum MacroFlags : std::uint8_t
+        {
+            FUNCTION_LIKE = 1 << 0,
+            VARIADIC = 1 << 1,
+        };
+
+        /// Writes macro definitions.
+        /// The string table comes first, followed by each macro with strings replaced by their index in the table.
+        /// @param[in] macros - The macros to write.
+        /// @param[in,out] writer - The writer to write to.
+        static void WriteMacros(const PREPROCESSING::MacroTable& macros, SERIALIZATION::BinaryWriter& writer)
+        {
+            // INTERN ALL STRINGS.
+            std::vector<std::string_view> strings;
+            std::unordered_map<std::string_view, std::uint32_t> string_indices;
+            auto intern = [&strings, &string_indices](const std::string_view string)
+            {
+                auto [string_index, string_added] = string_indices.try_emplace(string, static_cast<std::uint32_t>(strings.size()));
+                if (string_added)
+                {
+                    strings.push_back(string);
+                }
+                return string_index->second;
+            };
+
+            SERIALIZATION::BinaryWriter macro_writer;
+            std::uint32_t macro_count = 0;
+            for (std::uint32_t macro_index = 0; macro_index < macros.IndexCount(); ++macro_index)
+            {
+                const PREPROCESSING::MacroDefinition* macro = macros.GetByIndex(macro_index);
+                if (!macro)
+                {
+                    continue;
+                }
+                ++macro_count;
+
+                macro_writer.WriteUInt32(intern(macro->Name));
+                std::uint8_t flags = (macro->FunctionLike ? FUNCTION_LIKE : 0) | (macro->Variadic ? VARIADIC : 0);
+                macro_writer.WriteUInt8(flags);
+                macro_writer.WriteUInt32(static_cast<std::uint32_t>(macro->ParameterNames.size()));
+                for (const std::string& parameter_name : macro->ParameterNames)
+                {
+                    macro_writer.WriteUInt32(intern(parameter_name));
+                }
+                macro_writer.WriteUInt32(static_cast<std::uint32_t>(macro->ReplacementTokens.size()));
+                for (const TOKENIZATION::Token& token : macro->ReplacementTokens)
+                {
+                    macro_writer.WriteUInt32(static_cast<std::uint32_t>(token.Type));
+                    macro_writer.WriteUInt32(intern(token.Value));
+                    macro_writer.WriteUInt32(intern(token.Filepath));
+                    macro_writer.WriteUInt32(static_cast<std::uint32_t>(token.LineNumber));
+                    macro_writer.WriteUInt32(static_cast<std::uint32_t>(token.ColumnNumber));
+                }
+            }
+
+            // WRITE THE STRING TABLE AND MACROS.
+            writer.WriteUInt32(static_cast<std::uint32_t>(strings.size()));
+            for (const std::string_view string : strings)
+            {
+                writer.WriteString(string);
+            }
+            writer.WriteUInt32(macro_count);
+            writer.WriteBytes(macro_writer.Buffer);
+        }
+
+        /// Reads macro definitions written by WriteMacros.
+        /// @param[in,out] reader - The reader to read from.
+        /// @param[out] macros - The table to define the macros in.
+        /// @return True if all macros were read; false if the data was invalid.
+        static bool ReadMacros(SERIALIZATION::BinaryReader& reader, PREPROCESSING::MacroTable& macros)
+        {
+            // READ THE STRING TABLE.
+            // Each string is only copied out of the entry once.
+            std::vector<std::string> strings;
+            std::optional<std::uint32_t> string_count = reader.ReadUInt32();
+            for (std::uint32_t string_index = 0; string_count && string_index < *string_count; ++string_index)
+            {
+                std::optional<std::string_view> string = reader.ReadString();
+                if (!string)
+                {
+                    return false;
+                }
+                strings.emplace_back(*string);
+            }
+            auto read_string = [&reader, &strings]() -> const std::string*
+            {
+                std::optional<std::uint32_t> string_index = reader.ReadUInt32();
+                bool valid = string_index && *string_index < strings.size();
+                return valid ? &strings[*string_index] : nullptr;
+            };
+
+            // READ THE MACROS.
+            std::optional<std::uint32_t> macro_count = reader.ReadUInt32();
+            for (std::uint32_t macro_index = 0; macro_count && macro_index < *macro_count; ++macro_index)
+            {
+                const std::string* name = read_string();
+                std::optional<std::uint8_t> flags = reader.ReadUInt8();
+                if (!name || !flags)
+                {
+                    return false;
+                }
+                PREPROCESSING::MacroDefinition macro =
+                {
+                    .Name = *name,
+                    .FunctionLike = 0 != (*flags & FUNCTION_LIKE),
+                    .Variadic = 0 != (*flags & VARIADIC),
+                };
+
+                std::optional<std::uint32_t> parameter_count = reader.ReadUInt32();
+                for (std::uint32_t parameter_index = 0; parameter_count && parameter_index < *parameter_count; ++parameter_index)
+                {
+                    const std::string* parameter_name = read_string();
+                    if (!parameter_name)
+                    {
+                        return false;
+                    }
+                    macro.ParameterNames.push_back(*parameter_name);
+                }
+
+                std::optional<std::uint32_t> token_count = reader.ReadUInt32();
+                for (std::uint32_t token_index = 0; token_count && token_index < *token_count; ++token_index)
+                {
+                    std::optional<std::uint32_t> token_type = reader.ReadUInt32();
+                    const std::string* value = read_string();
+                    const std::string* filepath = read_string();
+                    std::optional<std::uint32_t> line_number = reader.ReadUInt32();
+                    std::optional<std::uint32_t> column_number = reader.ReadUInt32();
+                    if (reader.Failed || !value || !filepath)
+                    {
+                        return false;
+                    }
+                    macro.ReplacementTokens.push_back(TOKENIZATION::Token
+                    {
+                        .Type = static_cast<TOKENIZATION::TokenType>(*token_type),
+                        .Value = *value,
+                        .Filepath = *filepath,
+                        .LineNumber = *line_number,
+                        .ColumnNumber = *column_number,
+                    });
+                }
+
+                macros.Define(std::move(macro));
+            }
+            return !reader.Failed;
+        }
+
+        /// Gets the padding needed before the front-end data so that its records remain aligned.
+        /// @param[in] offset - The offset of the end of the preceding data.
+        /// @return The number of padding bytes.
+        static std::size_t GetPaddingSize(const std::size_t offset)
+        {
+            constexpr std::size_t ALIGNMENT_IN_BYTES = 8;
+            std::size_t padding_size_in_bytes = (ALIGNMENT_IN_BYTES - (offset % ALIGNMENT_IN_BYTES)) % ALIGNMENT_IN_BYTES;
+            return padding_size_in_bytes;
+        }
+    };
+}
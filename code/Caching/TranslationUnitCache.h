@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "Caching/ContentHash.h"
+#include "Compilation/Version.h"
+#include "Files/File.h"
+#include "Files/MemoryMappedFile.h"
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Preprocessing/HeaderCache.h"
+#include "Preprocessing/IncludedFile.h"
+#include "Serialization/BinaryReader.h"
+#include "Serialization/BinaryWriter.h"
+#include "Serialization/FrontEndReader.h"
+#include "Serialization/FrontEndWriter.h"
+#include "Tokenization/TokenStream.h"
+
+namespace CACHING
+{
+    /// Front-end results for a translation unit loaded from the cache.
+    struct CachedTranslationUnit
+    {
+        /// Preprocessed tokens from the source file.
+        TOKENIZATION::TokenStream Tokens = {};
+        /// The program parsed from the tokens.
+        Program ParsedProgram = {};
+        /// The files included by the source file.
+        std::vector<PREPROCESSING::IncludedFile> IncludedFiles = {};
+    };
+
+    /// An on-disk cache of front-end results (tokens and parsed programs)
+    /// for translation units.  Each entry is a small header identifying
+    /// the source code followed by front-end data in the binary format
+    /// described by FrontEndFormat, which is read directly from the
+    /// memory-mapped entry.  Entries are keyed by a hash of the source
+    /// file's path and code, compiler version, and include directories,
+    /// so unchanged files can skip tokenizing, preprocessing, and parsing
+    /// entirely.  Entries also record the contents of included files so
+    /// that entries are only used if no included file has changed.  Entries
+    /// are immutable once written, so the cache is safe to use from multiple
+    /// threads and processes at once.
+    struct TranslationUnitCache
+    {
+        /// Identifies cache entry files.
+        static constexpr std::string_view FILE_SIGNATURE = "CISHTU\r\n";
+        /// The version of the cache entry file layout.
+        static constexpr std::uint32_t FILE_FORMAT_VERSION = 7;
+        /// The extension for cache entry files.
+        static constexpr std::string_view FILE_EXTENSION = ".tu";
+
+        /// Computes the key for the cache entry for some source code.
+        /// @param[in] source_filepath - The canonical path of the translation unit's source file.
+        ///     Quoted includes are found relative to the including file, and tokens record
+        ///     their file, so identical source code in different files can have different results.
+        /// @param[in] source_code - The source code of a translation unit.
+        /// @param[in] include_directories - The directories searched for included files,
+        ///     which can change which files are included.
+        /// @param[in] macro_definitions - Macros defined on the command line, which can change
+        ///     the preprocessed tokens.
+        /// @return The cache key for the source code.
+        static std::uint64_t ComputeKey(
+            const std::filesystem::path& source_filepath,
+            const std::string_view source_code,
+            const std::vector<std::filesystem::path>& include_directories,
+            const std::vector<std::string>& macro_definitions)
+        {
+            // The compiler version is used as the seed so that results from
+            // different compiler versions never collide.
+            static const std::uint64_t COMPILER_VERSION_HASH = ContentHash::Compute(COMPILATION::COMPILER_VERSION, FILE_FORMAT_VERSION);
+            std::uint64_t key = ContentHash::Compute(source_filepath.string(), COMPILER_VERSION_HASH);
+            for (const std::filesystem::path& include_directory : include_directories)
+            {
+                key = ContentHash::Compute(include_directory.string(), key);
+            }
+            for (const std::string& macro_definition : macro_definitions)
+            {
+                key = ContentHash::Compute(macro_definition, key);
+            }
+            key = ContentHash::Compute(source_code, key);
+            return key;
+        }
+
+        /// Gets the path of the cache entry for a key.
+        /// @param[in] key - The key of the cache entry.
+        /// @return The path of the cache entry file.
+        std::filesystem::path GetEntryFilepath(const std::uint64_t key) const
+        {
+            char filename[32] = {};
+            std::snprintf(filename, sizeof(filename), "%016" PRIx64, key);
+            std::filesystem::path entry_filepath = Directory / filename;
+            entry_filepath += FILE_EXTENSION;
+            return entry_filepath;
+        }
+
+        /// Loads a cached translation unit.
+        /// @param[in] key - The key of the cache entry.
+        /// @param[in] source_code_size_in_bytes - The size of the source code.  Used
+        ///     to further guard against hash collisions.
+        /// @param[in,out] header_cache - The cache of included files, for checking if they changed.
+        /// @param[in] verify_included_files - True if the entry should only be used if no included
+        ///     file has changed; false if changes are already known not to affect the results.
+        /// @return The cached translation unit, if a valid entry exists; null otherwise.
+        std::optional<CachedTranslationUnit> Load(
+            const std::uint64_t key,
+            const std::size_t source_code_size_in_bytes,
+            PREPROCESSING::HeaderCache& header_cache,
+            const bool verify_included_files = true) const
+        {
+            using namespace SERIALIZATION;
+
+            // MAP THE CACHE ENTRY.
+            std::optional<FILES::MemoryMappedFile> entry_file = FILES::MemoryMappedFile::Open(GetEntryFilepath(key));
+            if (!entry_file)
+            {
+                return std::nullopt;
+            }
+
+            // VERIFY THE ENTRY IS FOR THE REQUESTED SOURCE CODE.
+            BinaryReader reader = { .Data = entry_file->Contents() };
+            std::optional<std::string_view> signature = reader.ReadBytes(FILE_SIGNATURE.size());
+            std::optional<std::uint32_t> file_format_version = reader.ReadUInt32();
+            constexpr std::size_t PADDING_SIZE_IN_BYTES = sizeof(std::uint32_t);
+            reader.ReadBytes(PADDING_SIZE_IN_BYTES);
+            std::optional<std::uint64_t> entry_key = reader.ReadUInt64();
+            std::optional<std::uint64_t> entry_source_code_size_in_bytes = reader.ReadUInt64();
+            bool entry_matches = (
+                !reader.Failed &&
+                FILE_SIGNATURE == *signature &&
+                FILE_FORMAT_VERSION == *file_format_version &&
+                key == *entry_key &&
+                source_code_size_in_bytes == *entry_source_code_size_in_bytes);
+            if (!entry_matches)
+            {
+                return std::nullopt;
+            }
+
+            // VERIFY NO INCLUDED FILES HAVE CHANGED.
+            std::vector<PREPROCESSING::IncludedFile> included_files;
+            std::optional<std::uint32_t> included_file_count = reader.ReadUInt32();
+            for (std::uint32_t included_file_index = 0; included_file_count && included_file_index < *included_file_count; ++included_file_index)
+            {
+                std::optional<std::string_view> included_filepath = reader.ReadString();
+                std::optional<std::uint64_t> included_file_content_hash = reader.ReadUInt64();
+                if (reader.Failed)
+                {
+                    return std::nullopt;
+                }
+
+                PREPROCESSING::IncludedFile included_file =
+                {
+                    .Filepath = *included_filepath,
+                    .ContentHash = *included_file_content_hash,
+                };
+                if (verify_included_files && !included_file.IsUnchanged(header_cache))
+                {
+                    return std::nullopt;
+                }
+                included_files.push_back(std::move(included_file));
+            }
+            reader.ReadBytes(GetPaddingSize(reader.CurrentOffset));
+            if (reader.Failed)
+            {
+                return std::nullopt;
+            }
+
+            // READ THE FRONT-END RESULTS.
+            std::string_view front_end_data = reader.Data.substr(reader.CurrentOffset);
+            std::optional<FrontEndReader> front_end_reader = FrontEndReader::Open(front_end_data);
+            if (!front_end_reader)
+            {
+                return std::nullopt;
+            }
+            std::optional<Program> program = front_end_reader->ToProgram();
+            if (!program)
+            {
+                return std::nullopt;
+            }
+
+            CachedTranslationUnit cached_translation_unit =
+            {
+                .Tokens = front_end_reader->ToTokenStream(),
+                .ParsedProgram = std::move(*program),
+                .IncludedFiles = std::move(included_files),
+            };
+            return cached_translation_unit;
+        }
+
+        /// Stores a translation unit in the cache.
+        /// @param[in] key - The key of the cache entry.
+        /// @param[in] source_code_size_in_bytes - The size of the source code.
+        /// @param[in] token_stream - The tokens from the source code.
+        /// @param[in] program - The program parsed from the tokens.
+        /// @param[in] included_files - The files included by the source code.
+        /// @return True if the entry was stored; false otherwise.
+        bool Store(
+            const std::uint64_t key,
+            const std::size_t source_code_size_in_bytes,
+            const TOKENIZATION::TokenStream& token_stream,
+            const Program& program,
+            const std::vector<PREPROCESSING::IncludedFile>& included_files) const
+        {
+            using namespace SERIALIZATION;
+
+            // SERIALIZE THE ENTRY.
+            BinaryWriter writer;
+            writer.WriteBytes(FILE_SIGNATURE);
+            writer.WriteUInt32(FILE_FORMAT_VERSION);
+            // Padding keeps the following fields and front-end records aligned.
+            writer.WriteUInt32(0);
+            writer.WriteUInt64(key);
+            writer.WriteUInt64(source_code_size_in_bytes);
+            writer.WriteUInt32(static_cast<std::uint32_t>(included_files.size()));
+            for (const PREPROCESSING::IncludedFile& included_file : included_files)
+            {
+                writer.WriteString(included_file.Filepath.string());
+                writer.WriteUInt64(included_file.ContentHash);
+            }
+            writer.Buffer.resize(writer.Buffer.size() + GetPaddingSize(writer.Buffer.size()), '\0');
+            writer.WriteBytes(FrontEndWriter::Write(token_stream, program));
+
+            // WRITE THE ENTRY.
+            std::error_code error;
+            std::filesystem::create_directories(Directory, error);
+            bool entry_stored = FILES::File::WriteBinaryAtomically(GetEntryFilepath(key), writer.Buffer);
+            return entry_stored;
+        }
+
+        /// The directory containing cache entries.
+        std::filesystem::path Directory = "";
+
+    private:
+        /// Gets the padding needed after the entry header so that front-end records remain aligned.
+        /// @param[in] offset - The offset of the end of the entry header.
+        /// @return The number of padding bytes.
+        static std::size_t GetPaddingSize(const std::size_t offset)
+        {
+            constexpr std::size_t ALIGNMENT_IN_BYTES = 8;
+            std::size_t padding_size_in_bytes = (ALIGNMENT_IN_BYTES - (offset % ALIGNMENT_IN_BYTES)) % ALIGNMENT_IN_BYTES;
+            return padding_size_in_bytes;
+        }
+    };
+}
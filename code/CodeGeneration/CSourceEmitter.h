@@ -0,0 +1,781 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Files/BufferedOutput.h"
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Tokenization/TokenStream.h"
+
+namespace CODE_GENERATION
+{
+    /// Options for how C source code is emitted.
+    struct CSourceEmitterOptions
+    {
+        /// The tokens the syntax tree was parsed from, which are needed to preserve comments or blank lines.
+        const TOKENIZATION::TokenStream* OriginalTokens = nullptr;
+        /// True to emit comments from the original tokens before the constructs they preceded.
+        bool PreserveComments = false;
+        /// True to keep blank lines between constructs where the original source had them.
+        bool PreserveBlankLines = false;
+        /// The number of spaces for each level of indentation.
+        std::size_t IndentationWidth = 4;
+    };
+
+    /// Writes syntax trees as formatted C source code, such as:
+    ///
+    ///     int square(int x)
+    ///     {
+    ///         return x * x;
+    ///     }
+    ///
+    /// Output is appended piece by piece directly to a buffered output rather than
+    /// being built from strings for each construct, so large programs can be written
+    /// without extra copying.  Expressions only get parentheses where needed to keep
+    /// their structure.  The output parses back to an equivalent syntax tree.
+    ///
+    /// Comments and blank lines aren't part of syntax trees, but they can be
+    /// recovered from the original tokens using constructs' line numbers.
+    /// Each comment is emitted before the first construct after it (or after a
+    /// statement on the same line), and runs of blank lines are kept as a single
+    /// blank line.
+    struct CSourceEmitter
+    {
+        /// Emits a program.
+        /// Functions are emitted in the order their names appeared in the original tokens when
+        /// those are available, so functions from included files stay where they were included.
+        /// Otherwise (or for functions not found in the tokens), they're ordered by their files and lines.
+        /// @param[in] program - The program to emit.
+        /// @param[in] options - How to emit the program.
+        /// @param[in,out] output - The output to append the source code to.
+        static void EmitProgram(const Program& program, const CSourceEmitterOptions& options, FILES::BufferedOutput& output)
+        {
+            // GATHER ALL TOP-LEVEL ITEMS.
+            std::vector<const FunctionHeader*> headers;
+            std::unordered_map<const FunctionHeader*, const FunctionDefinition*> definitions_by_header;
+            for (const auto& [name, function_declaration] : program.FunctionDeclarationsByName)
+            {
+                headers.push_back(&function_declaration);
+            }
+            for (const auto& [name, function_definition] : program.FunctionsByName)
+            {
+                headers.push_back(&function_definition.Header);
+                definitions_by_header.emplace(&function_definition.Header, &function_definition);
+            }
+
+            // FIND WHERE EACH ITEM'S NAME APPEARS IN THE ORIGINAL TOKENS.
+            // Each item is placed by its own position, since an included file's items belong
+            // where it was included, which may be after earlier items from the including file.
+            // The first matching name on the item's line is used, which is the item's own name
+            // unless an earlier item on the same line refers to it.
+            constexpr std::size_t UNKNOWN_POSITION = static_cast<std::size_t>(-1);
+            std::unordered_map<const FunctionHeader*, std::size_t> token_positions_by_header;
+            if (options.OriginalTokens)
+            {
+                std::unordered_map<std::string_view, std::vector<const FunctionHeader*>> headers_by_name;
+                for (const FunctionHeader* header : headers)
+                {
+                    headers_by_name[header->Name].push_back(header);
+                }
+
+                const std::vector<TOKENIZATION::Token>& tokens = options.OriginalTokens->Tokens;
+                for (std::size_t token_index = 0; token_index < tokens.size(); ++token_index)
+                {
+                    const TOKENIZATION::Token& token = tokens[token_index];
+                    if (TOKENIZATION::TokenType::IDENTIFIER != token.Type)
+                    {
+                        continue;
+                    }
+                    auto headers_with_name = headers_by_name.find(token.Value);
+                    if (headers_by_name.end() == headers_with_name)
+                    {
+                        continue;
+                    }
+                    for (const FunctionHeader* header : headers_with_name->second)
+                    {
+                        if (header->LineNumber == token.LineNumber && header->Filepath == token.Filepath)
+                        {
+                            token_positions_by_header.try_emplace(header, token_index);
+                        }
+                    }
+                }
+            }
+
+            // ORDER THEM AS IN THE ORIGINAL SOURCE.
+            auto get_token_position = [&](const FunctionHeader* header)
+            {
+                auto token_position = token_positions_by_header.find(header);
+                return (token_positions_by_header.end() == token_position) ? UNKNOWN_POSITION : token_position->second;
+            };
+            std::sort(headers.begin(), headers.end(), [&](const FunctionHeader* left, const FunctionHeader* right)
+            {
+                std::size_t left_position = get_token_position(left);
+                std::size_t right_position = get_token_position(right);
+                if (left_position != right_position)
+                {
+                    return left_position < right_position;
+                }
+                if (left->Filepath != right->Filepath)
+                {
+                    return left->Filepath < right->Filepath;
+                }
+                if (left->LineNumber != right->LineNumber)
+                {
+                    return left->LineNumber < right->LineNumber;
+                }
+                // Declarations come before definitions on the same line, which is only possible for generated code.
+                return definitions_by_header.contains(right) && !definitions_by_header.contains(left);
+            });
+
+            // EMIT EACH ITEM.
+            Emitter emitter(options, output);
+            for (const FunctionHeader* header : headers)
+            {
+                auto definition = definitions_by_header.find(header);
+                const FunctionDefinition* function_definition = (definitions_by_header.end() == definition) ? nullptr : definition->second;
+                emitter.EmitTopLevelItem(*header, function_definition);
+            }
+            emitter.FinishFile();
+        }
+
+        /// Emits a function definition.
+        /// @param[in] function_definition - The function to emit.
+        /// @param[in] options - How to emit the function.
+        /// @param[in,out] output - The output to append the source code to.
+        static void EmitFunction(const FunctionDefinition& function_definition, const CSourceEmitterOptions& options, FILES::BufferedOutput& output)
+        {
+            Emitter emitter(options, output);
+            emitter.EmitTopLevelItem(function_definition.Header, &function_definition);
+        }
+
+        /// Emits a statement, including any nested statements.
+        /// @param[in] statement - The statement to emit.
+        /// @param[in] indentation_level - The number of levels to indent the statement.
+        /// @param[in] options - How to emit the statement.  Any original tokens are
+        ///     only used for comments and blank lines from the first file in them.
+        /// @param[in,out] output - The output to append the source code to.
+        static void EmitStatement(const Statement& statement, const std::size_t indentation_level, const CSourceEmitterOptions& options, FILES::BufferedOutput& output)
+        {
+            Emitter emitter(options, output);
+            if (options.OriginalTokens && !options.OriginalTokens->Tokens.empty())
+            {
+                emitter.StartFile(options.OriginalTokens->Tokens.front().Filepath);
+            }
+            emitter.IndentationLevel = indentation_level;
+            emitter.EmitStatement(statement);
+        }
+
+        /// Emits an expression.
+        /// @param[in] expression - The expression to emit.
+        /// @param[in,out] output - The output to append the source code to.
+        static void EmitExpression(const Expression& expression, FILES::BufferedOutput& output)
+        {
+            Emitter emitter(CSourceEmitterOptions {}, output);
+            emitter.EmitExpression(expression, ASSIGNMENT_PRECEDENCE);
+        }
+
+    private:
+        // Precedences of expressions other than binary operators, relative to those
+        // from Expression::GetBinaryOperatorPrecedence() (higher binds tighter).
+        /// The precedence of assignments.
+        static constexpr int ASSIGNMENT_PRECEDENCE = -2;
+        /// The precedence of conditional (?:) expressions.
+        static constexpr int CONDITIONAL_PRECEDENCE = -1;
+        /// The precedence of prefix unary operators.
+        static constexpr int UNARY_PRECEDENCE = 11;
+        /// The precedence of postfix operators, calls, and subscripts.
+        static constexpr int POSTFIX_PRECEDENCE = 12;
+        /// The precedence of constants, names, and anything else that never needs parentheses.
+        static constexpr int PRIMARY_PRECEDENCE = 13;
+
+        /// Gets the precedence of an expression.
+        /// @param[in] expression - The expression.
+        /// @return The precedence of the expression's outermost operator.
+        static int GetPrecedence(const Expression& expression)
+        {
+            switch (expression.Kind)
+            {
+                case ExpressionKind::ASSIGNMENT:
+                    return ASSIGNMENT_PRECEDENCE;
+                case ExpressionKind::CONDITIONAL:
+                    return CONDITIONAL_PRECEDENCE;
+                case ExpressionKind::BINARY:
+                    return Expression::GetBinaryOperatorPrecedence(expression.Text);
+                case ExpressionKind::UNARY:
+                    return UNARY_PRECEDENCE;
+                case ExpressionKind::POSTFIX:
+                case ExpressionKind::CALL:
+                case ExpressionKind::INDEX:
+                    return POSTFIX_PRECEDENCE;
+                default:
+                    return PRIMARY_PRECEDENCE;
+            }
+        }
+
+        /// Where comments and blank lines were in one original file.
+        struct FileLayout
+        {
+            /// The comments in the file, in order.
+            std::vector<const TOKENIZATION::Token*> Comments = {};
+            /// Whether each line (indexed by line number) had any tokens.
+            std::vector<bool> OccupiedLines = {};
+            /// The index of the next comment to emit.
+            std::size_t NextCommentIndex = 0;
+        };
+
+        /// Emits constructs while tracking indentation and the original layout.
+        class Emitter
+        {
+        public:
+            /// Creates an emitter, recording the layout of the original tokens if it needs to be preserved.
+            /// @param[in] options - How to emit source code.
+            /// @param[in,out] output - The output to append source code to.
+            explicit Emitter(const CSourceEmitterOptions& options, FILES::BufferedOutput& output) :
+                Options(options),
+                Output(output)
+            {
+                bool layout_needed = (Options.OriginalTokens && (Options.PreserveComments || Options.PreserveBlankLines));
+                if (!layout_needed)
+                {
+                    return;
+                }
+
+                for (const TOKENIZATION::Token& token : Options.OriginalTokens->Tokens)
+                {
+                    FileLayout& layout = LayoutsByFilepath[token.Filepath];
+                    if (TOKENIZATION::TokenType::COMMENT == token.Type)
+                    {
+                        layout.Comments.push_back(&token);
+                    }
+
+                    // Tokens like multiline comments can span several lines.
+                    std::size_t last_line_number = token.LineNumber + static_cast<std::size_t>(std::count(token.Value.begin(), token.Value.end(), '\n'));
+                    if (layout.OccupiedLines.size() <= last_line_number)
+                    {
+                        layout.OccupiedLines.resize(last_line_number + 1, false);
+                    }
+                    std::fill(layout.OccupiedLines.begin() + static_cast<std::ptrdiff_t>(token.LineNumber), layout.OccupiedLines.begin() + static_cast<std::ptrdiff_t>(last_line_number) + 1, true);
+                }
+
+                // Tokens from macro expansions may be out of order, so comments are sorted by position.
+                for (auto& [filepath, layout] : LayoutsByFilepath)
+                {
+                    std::stable_sort(layout.Comments.begin(), layout.Comments.end(), [](const TOKENIZATION::Token* left, const TOKENIZATION::Token* right)
+                    {
+                        return (left->LineNumber != right->LineNumber) ? (left->LineNumber < right->LineNumber) : (left->ColumnNumber < right->ColumnNumber);
+                    });
+                }
+            }
+
+            /// Emits a function declaration or definition at the top level.
+            /// @param[in] header - The function's header.
+            /// @param[in] function_definition - The function's definition, if it's defined; null for declarations.
+            void EmitTopLevelItem(const FunctionHeader& header, const FunctionDefinition* const function_definition)
+            {
+                // SEPARATE ITEMS FROM DIFFERENT FILES.
+                bool file_changed = (!AnythingEmitted || header.Filepath != CurrentFilepath);
+                if (file_changed)
+                {
+                    FinishFile();
+                    StartFile(header.Filepath);
+                    AtScopeStart = !AnythingEmitted;
+                }
+
+                // SEPARATE DEFINITIONS FROM NEIGHBORING ITEMS.
+                // Blank lines are only emitted where the original source had them when preserving them.
+                bool is_definition = (nullptr != function_definition);
+                bool blank_line_needed = (!AtScopeStart && (file_changed || (!PreservingBlankLines() && (is_definition || PreviousItemWasDefinition))));
+                if (blank_line_needed)
+                {
+                    Output.Write('\n');
+                    AtScopeStart = true;
+                }
+                PreviousItemWasDefinition = is_definition;
+
+                // EMIT THE HEADER.
+                BeginLine(header.LineNumber);
+                Output.Write(header.Specifiers.ToString());
+                Output.Write(header.ReturnType);
+                Output.Write(' ');
+                Output.Write(header.Name);
+                Output.Write('(');
+                for (std::size_t parameter_index = 0; parameter_index < header.Parameters.size(); ++parameter_index)
+                {
+                    if (parameter_index > 0)
+                    {
+                        Output.Write(", ");
+                    }
+                    EmitVariable(header.Parameters[parameter_index]);
+                }
+                if (header.IsVariadic)
+                {
+                    Output.Write(header.Parameters.empty() ? "..." : ", ...");
+                }
+                else if (header.Parameters.empty())
+                {
+                    Output.Write("void");
+                }
+                Output.Write(')');
+                if (!function_definition)
+                {
+                    Output.Write(";\n");
+                    return;
+                }
+
+                // EMIT THE BODY.
+                Output.Write('\n');
+                Indent();
+                EmitBlock(function_definition->Body.Statements);
+            }
+
+            /// Starts emitting items from a file, using its original layout if available.
+            /// @param[in] filepath - The path of the file.
+            void StartFile(const std::string& filepath)
+            {
+                CurrentFilepath = filepath;
+                auto layout = LayoutsByFilepath.find(filepath);
+                CurrentLayout = (LayoutsByFilepath.end() == layout) ? nullptr : &layout->second;
+                LastLineNumber = 0;
+            }
+
+            /// Emits any comments after the last item from the current file.
+            void FinishFile()
+            {
+                if (!CurrentLayout || !Options.PreserveComments)
+                {
+                    return;
+                }
+                EmitCommentsBefore(static_cast<std::size_t>(-1));
+            }
+
+            /// Emits a statement on its own lines at the current indentation.
+            /// @param[in] statement - The statement to emit.
+            void EmitStatement(const Statement& statement)
+            {
+                BeginLine(statement.LineNumber);
+                switch (statement.Kind)
+                {
+                    case StatementKind::BLOCK:
+                    {
+                        EmitBlock(statement.Body);
+                        return;
+                    }
+                    case StatementKind::IF:
+                    {
+                        // EMIT THE STATEMENT IF THE CONDITION IS TRUE.
+                        // Without braces, an else would belong to any if statement ending the true branch.
+                        Output.Write("if (");
+                        EmitExpression(*statement.Condition, ASSIGNMENT_PRECEDENCE);
+                        Output.Write(")\n");
+                        bool has_else = (statement.Body.size() > 1);
+                        bool braces_needed = (has_else && EndsWithIfWithoutElse(statement.Body[0]));
+                        if (braces_needed)
+                        {
+                            Indent();
+                            EmitBlock({ &statement.Body[0], 1 });
+                        }
+                        else
+                        {
+                            EmitNestedStatement(statement.Body[0]);
+                        }
+
+                        // EMIT ANY STATEMENT IF THE CONDITION IS FALSE.
+                        if (has_else)
+                        {
+                            Indent();
+                            Output.Write("else\n");
+                            EmitNestedStatement(statement.Body[1]);
+                        }
+                        return;
+                    }
+                    case StatementKind::WHILE:
+                    {
+                        Output.Write("while (");
+                        EmitExpression(*statement.Condition, ASSIGNMENT_PRECEDENCE);
+                        Output.Write(")\n");
+                        EmitNestedStatement(statement.Body[0]);
+                        return;
+                    }
+                    case StatementKind::DO_WHILE:
+                    {
+                        Output.Write("do\n");
+                        EmitNestedStatement(statement.Body[0]);
+                        Indent();
+                        Output.Write("while (");
+                        EmitExpression(*statement.Condition, ASSIGNMENT_PRECEDENCE);
+                        Output.Write(");\n");
+                        return;
+                    }
+                    case StatementKind::FOR:
+                    {
+                        Output.Write("for (");
+                        const Statement& initializer = statement.Body[0];
+                        if (StatementKind::DECLARATION == initializer.Kind)
+                        {
+                            EmitDeclaration(initializer);
+                        }
+                        else if (StatementKind::EXPRESSION == initializer.Kind)
+                        {
+                            EmitExpression(*initializer.Value, ASSIGNMENT_PRECEDENCE);
+                        }
+                        Output.Write(';');
+                        if (statement.Condition)
+                        {
+                            Output.Write(' ');
+                            EmitExpression(*statement.Condition, ASSIGNMENT_PRECEDENCE);
+                        }
+                        Output.Write(';');
+                        if (statement.Step)
+                        {
+                            Output.Write(' ');
+                            EmitExpression(*statement.Step, ASSIGNMENT_PRECEDENCE);
+                        }
+                        Output.Write(")\n");
+                        EmitNestedStatement(statement.Body[1]);
+                        return;
+                    }
+                    case StatementKind::EXPRESSION:
+                    {
+                        EmitExpression(*statement.Value, ASSIGNMENT_PRECEDENCE);
+                        break;
+                    }
+                    case StatementKind::DECLARATION:
+                    {
+                        EmitDeclaration(statement);
+                        break;
+                    }
+                    case StatementKind::RETURN:
+                    {
+                        Output.Write("return");
+                        if (statement.Value)
+                        {
+                            Output.Write(' ');
+                            EmitExpression(*statement.Value, ASSIGNMENT_PRECEDENCE);
+                        }
+                        break;
+                    }
+                    case StatementKind::BREAK:
+                    {
+                        Output.Write("break");
+                        break;
+                    }
+                    case StatementKind::CONTINUE:
+                    {
+                        Output.Write("continue");
+                        break;
+                    }
+                    default:
+                    {
+                        // Empty and invalid statements do nothing.
+                        break;
+                    }
+                }
+
+                // END THE SIMPLE STATEMENT.
+                // Comments that followed it on the same line stay on that line.
+                Output.Write(';');
+                if (CurrentLayout && Options.PreserveComments)
+                {
+                    while (CurrentLayout->NextCommentIndex < CurrentLayout->Comments.size())
+                    {
+                        const TOKENIZATION::Token& comment = *CurrentLayout->Comments[CurrentLayout->NextCommentIndex];
+                        if (comment.LineNumber != statement.LineNumber)
+                        {
+                            break;
+                        }
+                        Output.Write(' ');
+                        Output.Write(comment.Value);
+                        ++CurrentLayout->NextCommentIndex;
+                    }
+                }
+                Output.Write('\n');
+            }
+
+            /// Emits an expression, parenthesizing it if it binds more loosely than its context requires.
+            /// @param[in] expression - The expression to emit.
+            /// @param[in] minimum_precedence - The lowest precedence that doesn't need parentheses.
+            void EmitExpression(const Expression& expression, const int minimum_precedence)
+            {
+                bool parentheses_needed = (GetPrecedence(expression) < minimum_precedence);
+                if (parentheses_needed)
+                {
+                    Output.Write('(');
+                }
+
+                switch (expression.Kind)
+                {
+                    case ExpressionKind::ASSIGNMENT:
+                    {
+                        // Assignment is right-associative.
+                        EmitExpression(expression.Operands[0], UNARY_PRECEDENCE);
+                        Output.Write(' ');
+                        Output.Write(expression.Text);
+                        Output.Write(' ');
+                        EmitExpression(expression.Operands[1], ASSIGNMENT_PRECEDENCE);
+                        break;
+                    }
+                    case ExpressionKind::CONDITIONAL:
+                    {
+                        EmitExpression(expression.Operands[0], CONDITIONAL_PRECEDENCE + 1);
+                        Output.Write(" ? ");
+                        EmitExpression(expression.Operands[1], ASSIGNMENT_PRECEDENCE);
+                        Output.Write(" : ");
+                        EmitExpression(expression.Operands[2], CONDITIONAL_PRECEDENCE);
+                        break;
+                    }
+                    case ExpressionKind::BINARY:
+                    {
+                        // Binary operators are left-associative, so only the right operand needs
+                        // parentheses for operators of the same precedence.
+                        int precedence = Expression::GetBinaryOperatorPrecedence(expression.Text);
+                        EmitExpression(expression.Operands[0], precedence);
+                        Output.Write(' ');
+                        Output.Write(expression.Text);
+                        Output.Write(' ');
+                        EmitExpression(expression.Operands[1], precedence + 1);
+                        break;
+                    }
+                    case ExpressionKind::UNARY:
+                    {
+                        // Operators like - and -- would merge into a different operator without a space.
+                        const Expression& operand = expression.Operands[0];
+                        Output.Write(expression.Text);
+                        char last_operator_character = expression.Text.back();
+                        bool operators_would_merge = (
+                            ExpressionKind::UNARY == operand.Kind &&
+                            ('-' == last_operator_character || '+' == last_operator_character || '&' == last_operator_character) &&
+                            operand.Text.front() == last_operator_character);
+                        if (operators_would_merge)
+                        {
+                            Output.Write(' ');
+                        }
+                        EmitExpression(operand, UNARY_PRECEDENCE);
+                        break;
+                    }
+                    case ExpressionKind::POSTFIX:
+                    {
+                        EmitExpression(expression.Operands[0], POSTFIX_PRECEDENCE);
+                        Output.Write(expression.Text);
+                        break;
+                    }
+                    case ExpressionKind::CALL:
+                    {
+                        Output.Write(expression.Text);
+                        Output.Write('(');
+                        for (std::size_t argument_index = 0; argument_index < expression.Operands.size(); ++argument_index)
+                        {
+                            if (argument_index > 0)
+                            {
+                                Output.Write(", ");
+                            }
+                            EmitExpression(expression.Operands[argument_index], ASSIGNMENT_PRECEDENCE);
+                        }
+                        Output.Write(')');
+                        break;
+                    }
+                    case ExpressionKind::INDEX:
+                    {
+                        EmitExpression(expression.Operands[0], POSTFIX_PRECEDENCE);
+                        Output.Write('[');
+                        EmitExpression(expression.Operands[1], ASSIGNMENT_PRECEDENCE);
+                        Output.Write(']');
+                        break;
+                    }
+                    default:
+                    {
+                        // Constants, string literals, and names are emitted as written.
+                        Output.Write(expression.Text);
+                        break;
+                    }
+                }
+
+                if (parentheses_needed)
+                {
+                    Output.Write(')');
+                }
+            }
+
+            /// The current number of levels of indentation.
+            std::size_t IndentationLevel = 0;
+
+        private:
+            /// Emits statements in curly braces at the current indentation, with the statements indented further.
+            /// The opening brace's line must already be indented.
+            /// @param[in] statements - The statements in the block.
+            void EmitBlock(const std::span<const Statement> statements)
+            {
+                Output.Write("{\n");
+                ++IndentationLevel;
+                AtScopeStart = true;
+                for (const Statement& statement : statements)
+                {
+                    EmitStatement(statement);
+                }
+                --IndentationLevel;
+                Indent();
+                Output.Write("}\n");
+                AtScopeStart = false;
+            }
+
+            /// Emits the body of a control flow statement, indenting it unless it's a block.
+            /// @param[in] statement - The statement to emit.
+            void EmitNestedStatement(const Statement& statement)
+            {
+                if (StatementKind::BLOCK == statement.Kind)
+                {
+                    EmitStatement(statement);
+                    return;
+                }
+
+                ++IndentationLevel;
+                AtScopeStart = true;
+                EmitStatement(statement);
+                --IndentationLevel;
+            }
+
+            /// Determines if a statement ends with an if statement that has no else, which would take any following else.
+            /// @param[in] statement - The statement to check.
+            /// @return True if the statement ends with an if statement without an else; false otherwise.
+            static bool EndsWithIfWithoutElse(const Statement& statement)
+            {
+                switch (statement.Kind)
+                {
+                    case StatementKind::IF:
+                        return (statement.Body.size() < 2) || EndsWithIfWithoutElse(statement.Body[1]);
+                    case StatementKind::WHILE:
+                    case StatementKind::FOR:
+                        return EndsWithIfWithoutElse(statement.Body.back());
+                    default:
+                        return false;
+                }
+            }
+
+            /// Emits a variable declaration without any terminating semicolon.
+            /// @param[in] statement - The declaration statement.
+            void EmitDeclaration(const Statement& statement)
+            {
+                EmitVariable(statement.Declaration);
+                if (statement.Value)
+                {
+                    Output.Write(" = ");
+                    EmitExpression(*statement.Value, ASSIGNMENT_PRECEDENCE);
+                }
+            }
+
+            /// Emits a variable's type and any name.
+            /// @param[in] variable - The variable.
+            void EmitVariable(const VariableDeclaration& variable)
+            {
+                // Array sizes are part of the type but are written after the name.
+                Output.Write(variable.Specifiers.ToString());
+                std::string_view data_type = variable.DataType;
+                std::size_t array_size_start = data_type.find('[');
+                Output.Write(data_type.substr(0, array_size_start));
+                if (!variable.Name.empty())
+                {
+                    Output.Write(' ');
+                    Output.Write(variable.Name);
+                }
+                if (std::string_view::npos != array_size_start)
+                {
+                    Output.Write(data_type.substr(array_size_start));
+                }
+            }
+
+            /// Prepares to emit a construct starting on a new line, emitting preceding comments and blank lines.
+            /// @param[in] line_number - The original line of the construct.
+            void BeginLine(const std::size_t line_number)
+            {
+                if (CurrentLayout && Options.PreserveComments)
+                {
+                    EmitCommentsBefore(line_number);
+                }
+                if (IsBlankLineBefore(line_number))
+                {
+                    Output.Write('\n');
+                }
+                Indent();
+                LastLineNumber = std::max(LastLineNumber, line_number);
+                AtScopeStart = false;
+                AnythingEmitted = true;
+            }
+
+            /// Emits comments from the current file before a line, each on its own lines.
+            /// @param[in] line_number - The line to emit comments before.
+            void EmitCommentsBefore(const std::size_t line_number)
+            {
+                while (CurrentLayout->NextCommentIndex < CurrentLayout->Comments.size())
+                {
+                    const TOKENIZATION::Token& comment = *CurrentLayout->Comments[CurrentLayout->NextCommentIndex];
+                    if (comment.LineNumber >= line_number)
+                    {
+                        break;
+                    }
+
+                    if (IsBlankLineBefore(comment.LineNumber))
+                    {
+                        Output.Write('\n');
+                    }
+                    Indent();
+                    Output.Write(comment.Value);
+                    Output.Write('\n');
+                    std::size_t last_line_number = comment.LineNumber + static_cast<std::size_t>(std::count(comment.Value.begin(), comment.Value.end(), '\n'));
+                    LastLineNumber = std::max(LastLineNumber, last_line_number);
+                    AtScopeStart = false;
+                    AnythingEmitted = true;
+                    ++CurrentLayout->NextCommentIndex;
+                }
+            }
+
+            /// Determines if a blank line should be emitted before a line.
+            /// @param[in] line_number - The original line about to be emitted.
+            /// @return True if the original source had a blank line right before the line; false otherwise.
+            bool IsBlankLineBefore(const std::size_t line_number) const
+            {
+                if (!PreservingBlankLines() || AtScopeStart || line_number <= LastLineNumber + 1)
+                {
+                    return false;
+                }
+                std::size_t previous_line_number = line_number - 1;
+                bool previous_line_blank = (previous_line_number >= CurrentLayout->OccupiedLines.size() || !CurrentLayout->OccupiedLines[previous_line_number]);
+                return previous_line_blank;
+            }
+
+            /// Determines if blank lines from the original source are being preserved.
+            /// @return True if blank lines are preserved for the current file; false otherwise.
+            bool PreservingBlankLines() const
+            {
+                return CurrentLayout && Options.PreserveBlankLines;
+            }
+
+            /// Emits indentation for the current level.
+            void Indent()
+            {
+                Output.WriteRepeated(' ', IndentationLevel * Options.IndentationWidth);
+            }
+
+            /// How to emit source code.
+            const CSourceEmitterOptions Options;
+            /// The output to append source code to.
+            FILES::BufferedOutput& Output;
+            /// The original layout of each file, if it's being preserved.
+            std::unordered_map<std::string, FileLayout> LayoutsByFilepath = {};
+            /// The file of the constructs being emitted.
+            std::string CurrentFilepath = "";
+            /// The original layout of the file of the constructs being emitted, if known.
+            FileLayout* CurrentLayout = nullptr;
+            /// The last original line emitted from the current file.
+            std::size_t LastLineNumber = 0;
+            /// True if nothing has been emitted in the current block yet, so blank lines aren't needed.
+            bool AtScopeStart = true;
+            /// True if anything has been emitted.
+            bool AnythingEmitted = false;
+            /// True if the previous top-level item was a function definition.
+            bool PreviousItemWasDefinition = false;
+        };
+    };
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CodeGeneration/ObjectFile.h"
+#include "Serialization/BinaryWriter.h"
+
+namespace CODE_GENERATION
+{
+    /// Writes relocatable ELF object files for x86-64 System V systems,
+    /// which the system linker can combine into executables.
+    ///
+    /// Object files contain a fixed set of sections: code, read-only data,
+    /// relocations for the code, a symbol table with its string table, section
+    /// names, and an empty note marking the stack as non-executable.  Defined
+    /// functions are global unless local to the object file (as for static
+    /// functions), and functions only called become undefined symbols
+    /// resolved by the linker.
+    struct ElfObjectWriter
+    {
+        /// Writes an object file in ELF format.
+        /// @param[in] object_file - The object file to write.
+        /// @return The contents of the ELF file.
+        static std::string Write(const ObjectFile& object_file)
+        {
+            using namespace SERIALIZATION;
+
+            // BUILD THE SYMBOL TABLE.
+            // Local symbols (the sections and any static functions) must come first, and the section symbols let data be referenced by offset.
+            StringTable symbol_names;
+            BinaryWriter symbols;
+            WriteSymbol(symbols, 0, 0, 0, 0, 0);
+            WriteSymbol(symbols, 0, SYMBOL_TYPE_SECTION, TEXT_SECTION_INDEX, 0, 0);
+            WriteSymbol(symbols, 0, SYMBOL_TYPE_SECTION, READ_ONLY_DATA_SECTION_INDEX, 0, 0);
+            std::uint32_t next_symbol_index = 3;
+            std::unordered_map<std::string, std::uint32_t> symbol_indices_by_name;
+            auto write_defined_functions = [&](const bool local)
+            {
+                std::uint8_t binding = local ? SYMBOL_BINDING_LOCAL : SYMBOL_BINDING_GLOBAL;
+                for (const DefinedFunction& function : object_file.Functions)
+                {
+                    if (local == function.IsLocal)
+                    {
+                        std::uint8_t info = (binding << 4) | SYMBOL_TYPE_FUNCTION;
+                        WriteSymbol(symbols, symbol_names.Add(function.Name), info, TEXT_SECTION_INDEX, function.Offset, function.Size);
+                        symbol_indices_by_name.emplace(function.Name, next_symbol_index++);
+                    }
+                }
+            };
+            write_defined_functions(true);
+            std::uint32_t first_global_symbol_index = next_symbol_index;
+            write_defined_functions(false);
+            for (const Relocation& relocation : object_file.Relocations)
+            {
+                bool is_undefined_function = (
+                    RelocationKind::FUNCTION_CALL == relocation.Kind &&
+                    !symbol_indices_by_name.contains(relocation.FunctionName));
+                if (is_undefined_function)
+                {
+                    std::uint8_t info = (SYMBOL_BINDING_GLOBAL << 4) | SYMBOL_TYPE_NONE;
+                    WriteSymbol(symbols, symbol_names.Add(relocation.FunctionName), info, 0, 0, 0);
+                    symbol_indices_by_name.emplace(relocation.FunctionName, next_symbol_index++);
+                }
+            }
+
+            // BUILD THE RELOCATIONS.
+            // Displacements are relative to the end of the 4 bytes being filled in, hence the -4 addends.
+            BinaryWriter relocations;
+            for (const Relocation& relocation : object_file.Relocations)
+            {
+                std::uint64_t symbol_index = READ_ONLY_DATA_SYMBOL_INDEX;
+                std::uint64_t type = RELOCATION_PC32;
+                std::int64_t addend = static_cast<std::int64_t>(relocation.DataOffset) - 4;
+                if (RelocationKind::FUNCTION_CALL == relocation.Kind)
+                {
+                    symbol_index = symbol_indices_by_name.at(relocation.FunctionName);
+                    type = RELOCATION_PLT32;
+                    addend = -4;
+                }
+                relocations.WriteUInt64(relocation.Offset);
+                relocations.WriteUInt64((symbol_index << 32) | type);
+                relocations.WriteUInt64(static_cast<std::uint64_t>(addend));
+            }
+
+            // BUILD THE SECTION NAMES.
+            StringTable section_names;
+            std::uint32_t text_name = section_names.Add(".text");
+            std::uint32_t read_only_data_name = section_names.Add(".rodata");
+            std::uint32_t relocations_name = section_names.Add(".rela.text");
+            std::uint32_t symbols_name = section_names.Add(".symtab");
+            std::uint32_t symbol_names_name = section_names.Add(".strtab");
+            std::uint32_t section_names_name = section_names.Add(".shstrtab");
+            std::uint32_t stack_note_name = section_names.Add(".note.GNU-stack");
+
+            // WRITE THE HEADER.
+            // The section header table's offset is filled in once the sections are written.
+            BinaryWriter output;
+            output.WriteBytes(std::string_view("\x7F" "ELF", 4));
+            output.WriteUInt8(2);
+            output.WriteUInt8(1);
+            output.WriteUInt8(1);
+            output.WriteUInt8(0);
+            output.WriteBytes(std::string(8, '\0'));
+            output.WriteUInt16(ELF_TYPE_RELOCATABLE);
+            output.WriteUInt16(MACHINE_X86_64);
+            output.WriteUInt32(1);
+            output.WriteUInt64(0);
+            output.WriteUInt64(0);
+            std::size_t section_headers_offset_position = output.Buffer.size();
+            output.WriteUInt64(0);
+            output.WriteUInt32(0);
+            output.WriteUInt16(ELF_HEADER_SIZE);
+            output.WriteUInt16(0);
+            output.WriteUInt16(0);
+            output.WriteUInt16(SECTION_HEADER_SIZE);
+            output.WriteUInt16(SECTION_COUNT);
+            output.WriteUInt16(SECTION_NAMES_SECTION_INDEX);
+
+            // WRITE THE SECTION CONTENTS.
+            auto write_section = [&](const std::string_view contents, const std::size_t alignment)
+            {
+                output.Buffer.resize((output.Buffer.size() + alignment - 1) / alignment * alignment, '\0');
+                std::size_t offset = output.Buffer.size();
+                output.WriteBytes(contents);
+                return offset;
+            };
+            std::string_view code(reinterpret_cast<const char*>(object_file.Code.data()), object_file.Code.size());
+            std::string_view read_only_data(reinterpret_cast<const char*>(object_file.ReadOnlyData.data()), object_file.ReadOnlyData.size());
+            std::size_t text_offset = write_section(code, 16);
+            std::size_t read_only_data_offset = write_section(read_only_data, 16);
+            std::size_t relocations_offset = write_section(relocations.Buffer, 8);
+            std::size_t symbols_offset = write_section(symbols.Buffer, 8);
+            std::size_t symbol_names_offset = write_section(symbol_names.Contents, 1);
+            std::size_t section_names_offset = write_section(section_names.Contents, 1);
+
+            // WRITE THE SECTION HEADERS.
+            output.Buffer.resize((output.Buffer.size() + 7) / 8 * 8, '\0');
+            std::uint64_t section_headers_offset = output.Buffer.size();
+            for (std::size_t byte_index = 0; byte_index < 8; ++byte_index)
+            {
+                output.Buffer[section_headers_offset_position + byte_index] = static_cast<char>(section_headers_offset >> (8 * byte_index));
+            }
+            WriteSectionHeader(output, SectionHeader {});
+            WriteSectionHeader(output, SectionHeader
+            {
+                .Name = text_name,
+                .Type = SECTION_TYPE_PROGRAM_DATA,
+                .Flags = SECTION_FLAG_ALLOCATE | SECTION_FLAG_EXECUTABLE,
+                .Offset = text_offset,
+                .Size = code.size(),
+                .Alignment = 16,
+            });
+            WriteSectionHeader(output, SectionHeader
+            {
+                .Name = read_only_data_name,
+                .Type = SECTION_TYPE_PROGRAM_DATA,
+                .Flags = SECTION_FLAG_ALLOCATE,
+                .Offset = read_only_data_offset,
+                .Size = read_only_data.size(),
+                .Alignment = 16,
+            });
+            WriteSectionHeader(output, SectionHeader
+            {
+                .Name = relocations_name,
+                .Type = SECTION_TYPE_RELOCATIONS_WITH_ADDENDS,
+                .Flags = SECTION_FLAG_INFO_LINK,
+                .Offset = relocations_offset,
+                .Size = relocations.Buffer.size(),
+                .Link = SYMBOLS_SECTION_INDEX,
+                .Info = TEXT_SECTION_INDEX,
+                .Alignment = 8,
+                .EntrySize = RELOCATION_SIZE,
+            });
+            WriteSectionHeader(output, SectionHeader
+            {
+                .Name = symbols_name,
+                .Type = SECTION_TYPE_SYMBOLS,
+                .Offset = symbols_offset,
+                .Size = symbols.Buffer.size(),
+                .Link = SYMBOL_NAMES_SECTION_INDEX,
+                .Info = first_global_symbol_index,
+                .Alignment = 8,
+                .EntrySize = SYMBOL_SIZE,
+            });
+            WriteSectionHeader(output, SectionHeader
+            {
+                .Name = symbol_names_name,
+                .Type = SECTION_TYPE_STRINGS,
+                .Offset = symbol_names_offset,
+                .Size = symbol_names.Contents.size(),
+                .Alignment = 1,
+            });
+            WriteSectionHeader(output, SectionHeader
+            {
+                .Name = section_names_name,
+                .Type = SECTION_TYPE_STRINGS,
+                .Offset = section_names_offset,
+                .Size = section_names.Contents.size(),
+                .Alignment = 1,
+            });
+            WriteSectionHeader(output, SectionHeader
+            {
+                .Name = stack_note_name,
+                .Type = SECTION_TYPE_PROGRAM_DATA,
+                .Offset = section_names_offset,
+                .Alignment = 1,
+            });
+            return std::move(output.Buffer);
+        }
+
+    private:
+        // FILE LAYOUT.
+        static constexpr std::uint16_t ELF_HEADER_SIZE = 64;
+        static constexpr std::uint16_t SECTION_HEADER_SIZE = 64;
+        static constexpr std::uint64_t SYMBOL_SIZE = 24;
+        static constexpr std::uint64_t RELOCATION_SIZE = 24;
+        static constexpr std::uint16_t ELF_TYPE_RELOCATABLE = 1;
+        static constexpr std::uint16_t MACHINE_X86_64 = 62;
+
+        // SECTIONS, IN THE ORDER WRITTEN.
+        static constexpr std::uint16_t TEXT_SECTION_INDEX = 1;
+        static constexpr std::uint16_t READ_ONLY_DATA_SECTION_INDEX = 2;
+        static constexpr std::uint32_t SYMBOLS_SECTION_INDEX = 4;
+        static constexpr std::uint32_t SYMBOL_NAMES_SECTION_INDEX = 5;
+        static constexpr std::uint16_t SECTION_NAMES_SECTION_INDEX = 6;
+        static constexpr std::uint16_t SECTION_COUNT = 8;
+
+        // SECTION TYPES AND FLAGS.
+        static constexpr std::uint32_t SECTION_TYPE_PROGRAM_DATA = 1;
+        static constexpr std::uint32_t SECTION_TYPE_SYMBOLS = 2;
+        static constexpr std::uint32_t SECTION_TYPE_STRINGS = 3;
+        static constexpr std::uint32_t SECTION_TYPE_RELOCATIONS_WITH_ADDENDS = 4;
+        static constexpr std::uint64_t SECTION_FLAG_ALLOCATE = 0x2;
+        static constexpr std::uint64_t SECTION_FLAG_EXECUTABLE = 0x4;
+        static constexpr std::uint64_t SECTION_FLAG_INFO_LINK = 0x40;
+
+        // SYMBOLS.
+        static constexpr std::uint64_t READ_ONLY_DATA_SYMBOL_INDEX = 2;
+        static constexpr std::uint8_t SYMBOL_BINDING_LOCAL = 0;
+        static constexpr std::uint8_t SYMBOL_BINDING_GLOBAL = 1;
+        static constexpr std::uint8_t SYMBOL_TYPE_NONE = 0;
+        static constexpr std::uint8_t SYMBOL_TYPE_FUNCTION = 2;
+        static constexpr std::uint8_t SYMBOL_TYPE_SECTION = 3;
+
+        // RELOCATION TYPES.
+        static constexpr std::uint64_t RELOCATION_PC32 = 2;
+        static constexpr std::uint64_t RELOCATION_PLT32 = 4;
+
+        /// A string table section, where strings are referenced by offset.
+        struct StringTable
+        {
+            /// Adds a string to the table.
+            /// @param[in] text - The string.
+            /// @return The offset of the string.
+            std::uint32_t Add(const std::string_view text)
+            {
+                std::uint32_t offset = static_cast<std::uint32_t>(Contents.size());
+                Contents.append(text);
+                Contents.push_back('\0');
+                return offset;
+            }
+
+            /// The strings, each null-terminated.  The table starts with an empty string.
+            std::string Contents = std::string(1, '\0');
+        };
+
+        /// The fields of a section header.
+        struct SectionHeader
+        {
+            std::uint32_t Name = 0;
+            std::uint32_t Type = 0;
+            std::uint64_t Flags = 0;
+            std::uint64_t Offset = 0;
+            std::uint64_t Size = 0;
+            std::uint32_t Link = 0;
+            std::uint32_t Info = 0;
+            std::uint64_t Alignment = 0;
+            std::uint64_t EntrySize = 0;
+        };
+
+        /// Writes a symbol table entry.
+        /// @param[in,out] output - The symbol table to write to.
+        /// @param[in] name - The offset of the symbol's name.
+        /// @param[in] info - The symbol's binding and type.
+        /// @param[in] section_index - The index of the section defining the symbol, or 0 if undefined.
+        /// @param[in] value - The offset of the symbol in its section.
+        /// @param[in] size - The size of the symbol.
+        static void WriteSymbol(
+            SERIALIZATION::BinaryWriter& output,
+            const std::uint32_t name,
+            const std::uint8_t info,
+            const std::uint16_t section_index,
+            const std::uint64_t value,
+            const std::uint64_t size)
+        {
+            output.WriteUInt32(name);
+            output.WriteUInt8(info);
+            output.WriteUInt8(0);
+            output.WriteUInt16(section_index);
+            output.WriteUInt64(value);
+            output.WriteUInt64(size);
+        }
+
+        /// Writes a section header.
+        /// @param[in,out] output - The file to write to.
+        /// @param[in] header - The header.
+        static void WriteSectionHeader(SERIALIZATION::BinaryWriter& output, const SectionHeader& header)
+        {
+            output.WriteUInt32(header.Name);
+            output.WriteUInt32(header.Type);
+            output.WriteUInt64(header.Flags);
+            output.WriteUInt64(0);
+            output.WriteUInt64(header.Offset);
+            output.WriteUInt64(header.Size);
+            output.WriteUInt32(header.Link);
+            output.WriteUInt32(header.Info);
+            output.WriteUInt64(header.Alignment);
+            output.WriteUInt64(header.EntrySize);
+        }
+    };
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CodeGeneration/ObjectFile.h"
+
+#if __linux__ && __x86_64__
+    #include <dlfcn.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace CODE_GENERATION
+{
+    /// Generated code loaded into executable memory in this process, so functions
+    /// can be called right after being compiled without writing an object file or linking.
+    ///
+    /// Code and read-only data are copied into a single mapping, which is only ever
+    /// writable before it becomes executable.  Calls to functions in the code are
+    /// resolved directly, while calls to other functions (such as those in the C
+    /// library) are resolved from symbols already loaded into the process and go
+    /// through stubs, since those functions may be too far away for a 32-bit displacement.
+    struct JitModule
+    {
+        /// Loads generated code into executable memory.
+        /// @param[in] object_file - The code to load.
+        /// @param[out] error_message - Why the code couldn't be loaded, if it couldn't.
+        /// @return The loaded code, if successful; null otherwise.
+        static std::optional<JitModule> Load(const ObjectFile& object_file, std::string& error_message)
+        {
+        #if __linux__ && __x86_64__
+            JitModule jit_module;
+            for (const DefinedFunction& function : object_file.Functions)
+            {
+                jit_module.FunctionOffsets.emplace(function.Name, function.Offset);
+            }
+
+            // RESOLVE FUNCTIONS DEFINED OUTSIDE THE CODE.
+            std::vector<const void*> external_addresses;
+            std::unordered_map<std::string, std::size_t> external_indices_by_name;
+            for (const Relocation& relocation : object_file.Relocations)
+            {
+                bool is_external_call = (RelocationKind::FUNCTION_CALL == relocation.Kind && !jit_module.FunctionOffsets.contains(relocation.FunctionName));
+                if (!is_external_call || external_indices_by_name.contains(relocation.FunctionName))
+                {
+                    continue;
+                }
+
+                const void* external_address = dlsym(RTLD_DEFAULT, relocation.FunctionName.c_str());
+                if (!external_address)
+                {
+                    error_message = "Undefined function " + relocation.FunctionName;
+                    return std::nullopt;
+                }
+                external_indices_by_name.emplace(relocation.FunctionName, external_addresses.size());
+                external_addresses.push_back(external_address);
+            }
+
+            // LAY OUT THE MEMORY.
+            // Executable and read-only parts are on separate pages so they can be protected differently.
+            std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            std::size_t stubs_offset = AlignUp(object_file.Code.size(), STUB_SIZE);
+            jit_module.ExecutableSize = AlignUp(stubs_offset + STUB_SIZE * external_addresses.size(), page_size);
+            std::size_t read_only_data_offset = jit_module.ExecutableSize;
+            std::size_t address_table_offset = AlignUp(read_only_data_offset + object_file.ReadOnlyData.size(), sizeof(void*));
+            jit_module.SizeInBytes = AlignUp(address_table_offset + sizeof(void*) * external_addresses.size(), page_size);
+            if (0 == jit_module.SizeInBytes)
+            {
+                // Empty mappings aren't allowed.
+                jit_module.SizeInBytes = page_size;
+            }
+
+            void* mapped_memory = mmap(nullptr, jit_module.SizeInBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (MAP_FAILED == mapped_memory)
+            {
+                error_message = "Failed to allocate memory for code";
+                jit_module.SizeInBytes = 0;
+                return std::nullopt;
+            }
+            jit_module.Memory = static_cast<std::uint8_t*>(mapped_memory);
+
+            // COPY THE CODE AND DATA.
+            // Unused space is filled with breakpoints in case anything jumps there.
+            std::memset(jit_module.Memory, 0xCC, jit_module.ExecutableSize);
+            std::copy(object_file.Code.begin(), object_file.Code.end(), jit_module.Memory);
+            std::copy(object_file.ReadOnlyData.begin(), object_file.ReadOnlyData.end(), jit_module.Memory + read_only_data_offset);
+            std::copy(external_addresses.begin(), external_addresses.end(), reinterpret_cast<const void**>(jit_module.Memory + address_table_offset));
+
+            // WRITE STUBS FOR EXTERNAL FUNCTIONS.
+            // Each is an indirect jump through the function's entry in the address table.
+            for (std::size_t external_index = 0; external_index < external_addresses.size(); ++external_index)
+            {
+                std::size_t stub_offset = stubs_offset + STUB_SIZE * external_index;
+                jit_module.Memory[stub_offset] = 0xFF;
+                jit_module.Memory[stub_offset + 1] = 0x25;
+                jit_module.WriteDisplacement(jit_module.Memory + stub_offset + 2, address_table_offset + sizeof(void*) * external_index);
+            }
+
+            // FILL IN REFERENCES FROM THE CODE.
+            // Displacements are relative to the end of the 4 bytes being filled in.
+            for (const Relocation& relocation : object_file.Relocations)
+            {
+                std::size_t target_offset = 0;
+                if (RelocationKind::READ_ONLY_DATA_ADDRESS == relocation.Kind)
+                {
+                    target_offset = read_only_data_offset + relocation.DataOffset;
+                }
+                else if (auto function_offset = jit_module.FunctionOffsets.find(relocation.FunctionName); jit_module.FunctionOffsets.end() != function_offset)
+                {
+                    target_offset = function_offset->second;
+                }
+                else
+                {
+                    target_offset = stubs_offset + STUB_SIZE * external_indices_by_name[relocation.FunctionName];
+                }
+                jit_module.WriteDisplacement(jit_module.Memory + relocation.Offset, target_offset);
+            }
+
+            // MAKE THE CODE EXECUTABLE.
+            // Nothing is writable once it's executable, so the code can't be modified afterwards.
+            bool code_protected = (0 == mprotect(jit_module.Memory, jit_module.ExecutableSize, PROT_READ | PROT_EXEC));
+            std::size_t read_only_size = jit_module.SizeInBytes - jit_module.ExecutableSize;
+            bool data_protected = (0 == read_only_size || 0 == mprotect(jit_module.Memory + jit_module.ExecutableSize, read_only_size, PROT_READ));
+            if (!code_protected || !data_protected)
+            {
+                error_message = "Failed to make code executable";
+                return std::nullopt;
+            }
+            return jit_module;
+        #else
+            (void)object_file;
+            error_message = "Running code in-process is only supported on x86-64 Linux";
+            return std::nullopt;
+        #endif
+        }
+
+        /// Creates an empty module.
+        JitModule() = default;
+
+        /// Unmaps the code.
+        ~JitModule()
+        {
+            Close();
+        }
+
+        /// Takes ownership of other code.
+        /// @param[in,out] other - The module to take ownership of.  Will be left empty.
+        JitModule(JitModule&& other) noexcept :
+            Memory(std::exchange(other.Memory, nullptr)),
+            SizeInBytes(std::exchange(other.SizeInBytes, 0)),
+            ExecutableSize(std::exchange(other.ExecutableSize, 0)),
+            FunctionOffsets(std::move(other.FunctionOffsets))
+        {}
+
+        /// Takes ownership of other code, unmapping any current code.
+        /// @param[in,out] other - The module to take ownership of.  Will be left empty.
+        /// @return This module.
+        JitModule& operator=(JitModule&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                Memory = std::exchange(other.Memory, nullptr);
+                SizeInBytes = std::exchange(other.SizeInBytes, 0);
+                ExecutableSize = std::exchange(other.ExecutableSize, 0);
+                FunctionOffsets = std::move(other.FunctionOffsets);
+            }
+            return *this;
+        }
+
+        JitModule(const JitModule&) = delete;
+        JitModule& operator=(const JitModule&) = delete;
+
+        /// Gets a function in the code.
+        /// The function is only valid while the module exists.
+        /// @tparam FunctionType - The C++ type of the function, such as std::int64_t(std::int64_t).
+        ///     Code is generated for the System V ABI, which must match this type.
+        /// @param[in] name - The name of the function.
+        /// @return The function, if defined; null otherwise.
+        template <typename FunctionType>
+        FunctionType* GetFunction(const std::string_view name) const
+        {
+            auto function_offset = FunctionOffsets.find(std::string(name));
+            if (FunctionOffsets.end() == function_offset)
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<FunctionType*>(Memory + function_offset->second);
+        }
+
+    private:
+        /// The size of a stub for calling an external function, including padding.
+        static constexpr std::size_t STUB_SIZE = 8;
+
+        /// Rounds a size up to a multiple of an alignment.
+        /// @param[in] size - The size.
+        /// @param[in] alignment - The alignment.
+        /// @return The aligned size.
+        static std::size_t AlignUp(const std::size_t size, const std::size_t alignment)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        /// Writes a 32-bit displacement to a location in the mapping.
+        /// @param[in,out] displacement - Where to write the displacement.
+        /// @param[in] target_offset - The offset in the mapping being referenced.
+        void WriteDisplacement(std::uint8_t* const displacement, const std::size_t target_offset) const
+        {
+            // Everything is in one mapping far smaller than 2 GB, so displacements always fit.
+            std::int32_t displacement_value = static_cast<std::int32_t>(
+                static_cast<std::int64_t>(target_offset) - static_cast<std::int64_t>(displacement + 4 - Memory));
+            std::memcpy(displacement, &displacement_value, sizeof(displacement_value));
+        }
+
+        /// Unmaps any code.
+        void Close()
+        {
+        #if __linux__ && __x86_64__
+            if (Memory)
+            {
+                munmap(Memory, SizeInBytes);
+            }
+        #endif
+            Memory = nullptr;
+            SizeInBytes = 0;
+            ExecutableSize = 0;
+        }
+
+        /// The start of the mapping holding the code and data.
+        std::uint8_t* Memory = nullptr;
+        /// The size of the mapping.
+        std::size_t SizeInBytes = 0;
+        /// The size of the executable part at the start of the mapping.
+        std::size_t ExecutableSize = 0;
+        /// The offset of each function defined in the code.
+        std::unordered_map<std::string, std::uint64_t> FunctionOffsets = {};
+    };
+}
@@ -0,0 +1,592 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "CodeGeneration/LiveIntervals.h"
+#include "CodeGeneration/X64Assembler.h"
+#include "IntermediateRepresentation/Function.h"
+
+namespace CODE_GENERATION
+{
+    /// The different places a value can be kept.
+    enum class LocationKind
+    {
+        /// The value isn't kept anywhere, since it's never read.
+        NONE,
+        /// The value is in a register.
+        REGISTER,
+        /// The value is in an 8-byte slot in the stack frame.
+        SPILL_SLOT,
+    };
+
+    /// Where a value is kept over part of its lifetime.
+    struct Location
+    {
+        /// Checks if two locations are the same.
+        /// @param[in] other - The other location.
+        /// @return True if the locations are the same.
+        bool operator==(const Location& other) const
+        {
+            if (Kind != other.Kind)
+            {
+                return false;
+            }
+            switch (Kind)
+            {
+                case LocationKind::REGISTER:
+                    return RegisterId == other.RegisterId;
+                case LocationKind::SPILL_SLOT:
+                    return SpillSlotIndex == other.SpillSlotIndex;
+                default:
+                    return true;
+            }
+        }
+
+        /// The kind of location.
+        LocationKind Kind = LocationKind::NONE;
+        /// For registers, the register.
+        Register RegisterId = Register::RAX;
+        /// For spill slots, the index of the slot.
+        std::uint32_t SpillSlotIndex = 0;
+    };
+
+    /// A value's location from some position until the next location starts.
+    struct LocationStart
+    {
+        /// The first position with this location.
+        std::uint32_t Position = 0;
+        /// The location.
+        Location ValueLocation = {};
+    };
+
+    /// A move of a value to a new location in the middle of a block, where its interval was split.
+    struct SplitMove
+    {
+        /// The position before which the move happens.
+        std::uint32_t Position = 0;
+        /// The location the value is moved from.
+        Location Source = {};
+        /// The location the value is moved to.
+        Location Destination = {};
+    };
+
+    /// The locations assigned to a function's values.
+    struct RegisterAllocation
+    {
+        /// Gets where a value is at a position.
+        /// @param[in] value - The value.
+        /// @param[in] position - A position where the value is live.
+        /// @return The location, which is none for values that are never read.
+        Location GetLocation(const INTERMEDIATE_REPRESENTATION::ValueId value, const std::uint32_t position) const
+        {
+            const std::vector<LocationStart>& locations = LocationsByValue[value];
+            auto next_location = std::upper_bound(
+                locations.begin(),
+                locations.end(),
+                position,
+                [](const std::uint32_t searched_position, const LocationStart& location) { return searched_position < location.Position; });
+            if (next_location == locations.begin())
+            {
+                return locations.empty() ? Location {} : locations.front().ValueLocation;
+            }
+            return (next_location - 1)->ValueLocation;
+        }
+
+        /// The numbering of instructions and the values live into each block.
+        LiveIntervals Liveness = {};
+        /// The locations of each value over its lifetime, in order, by ID.
+        std::vector<std::vector<LocationStart>> LocationsByValue = {};
+        /// The moves within blocks between split intervals, in order of position.
+        /// Moves between blocks are found from the locations at each edge.
+        std::vector<SplitMove> SplitMoves = {};
+        /// The number of spill slots needed.
+        std::uint32_t SpillSlotCount = 0;
+        /// The callee-saved registers assigned to some value, which must be preserved.
+        std::vector<Register> UsedCalleeSavedRegisters = {};
+    };
+
+    /// Assigns registers to values with linear scan over live intervals, after Wimmer
+    /// and Franz's "Linear Scan Register Allocation on SSA Form".
+    ///
+    /// Intervals are visited in order of their start.  Each gets the register that
+    /// stays free longest, and if that register is needed before the interval ends,
+    /// the interval is split there and the rest is allocated separately.  If no
+    /// register is free, whichever of the interval and the registers' holders is
+    /// next read furthest away is spilled until just before that read.  Calls clobber
+    /// the caller-saved registers, which splits intervals that are live across them
+    /// into callee-saved registers or spill slots.
+    ///
+    /// Instructions only read operands into scratch registers (RAX, RCX, RDX, and R11
+    /// for moves), so operands never need to be in a register and spilling always succeeds.
+    /// A spill slot is shared by values whose lifetimes don't overlap.
+    struct LinearScanRegisterAllocator
+    {
+        /// The registers available for values, with caller-saved ones first so they're
+        /// preferred when nothing else distinguishes registers.
+        static constexpr std::array<Register, 10> ALLOCATABLE_REGISTERS =
+        {
+            Register::RSI, Register::RDI, Register::R8, Register::R9, Register::R10,
+            Register::RBX, Register::R12, Register::R13, Register::R14, Register::R15,
+        };
+        /// The number of allocatable registers that calls may clobber.
+        static constexpr std::size_t CALLER_SAVED_REGISTER_COUNT = 5;
+
+        /// Assigns locations to the values of a function.
+        /// @param[in] function - The function.
+        /// @return The locations for each value.
+        static RegisterAllocation Allocate(const INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            Allocator allocator(function);
+            return allocator.Run();
+        }
+
+    private:
+        /// The state of allocating registers for a single function.
+        class Allocator
+        {
+        public:
+            /// Prepares to allocate registers for a function.
+            /// @param[in] function - The function.
+            explicit Allocator(const INTERMEDIATE_REPRESENTATION::Function& function) :
+                Source(function)
+            {}
+
+            /// Allocates registers.
+            /// @return The locations for each value.
+            RegisterAllocation Run()
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                // BUILD THE INTERVALS.
+                Result.Liveness = LiveIntervals::Build(Source);
+                Intervals = std::move(Result.Liveness.Intervals);
+                Result.Liveness.Intervals.clear();
+                IntervalLocations.assign(Intervals.size(), Location {});
+                ValueStarts.assign(Source.Values.size(), 0);
+                ValueEnds.assign(Source.Values.size(), 0);
+                SpillSlotsByValue.assign(Source.Values.size(), NO_SPILL_SLOT);
+                for (std::uint32_t interval_index = 0; interval_index < Intervals.size(); ++interval_index)
+                {
+                    const LiveInterval& interval = Intervals[interval_index];
+                    ValueStarts[interval.Value] = interval.GetStart();
+                    ValueEnds[interval.Value] = interval.GetEnd();
+                    Unhandled.emplace(interval.GetStart(), interval_index);
+                }
+
+                // ALLOCATE EACH INTERVAL IN ORDER OF START.
+                while (!Unhandled.empty())
+                {
+                    std::uint32_t current = Unhandled.top().second;
+                    Unhandled.pop();
+                    std::uint32_t position = Intervals[current].GetStart();
+
+                    // UPDATE WHICH INTERVALS ARE LIVE HERE.
+                    // Intervals in a lifetime hole keep their register, but it can be used until they resume.
+                    std::vector<std::uint32_t> still_active;
+                    for (const std::uint32_t interval_index : Active)
+                    {
+                        if (Intervals[interval_index].GetEnd() <= position)
+                        {
+                            continue;
+                        }
+                        (Intervals[interval_index].Covers(position) ? still_active : Inactive).push_back(interval_index);
+                    }
+                    std::vector<std::uint32_t> still_inactive;
+                    for (const std::uint32_t interval_index : Inactive)
+                    {
+                        if (Intervals[interval_index].GetEnd() <= position)
+                        {
+                            continue;
+                        }
+                        (Intervals[interval_index].Covers(position) ? still_active : still_inactive).push_back(interval_index);
+                    }
+                    Active = std::move(still_active);
+                    Inactive = std::move(still_inactive);
+
+                    // ASSIGN A LOCATION.
+                    bool register_free = TryAllocateFreeRegister(current);
+                    if (!register_free)
+                    {
+                        AllocateBlockedRegister(current);
+                    }
+                    if (LocationKind::REGISTER == IntervalLocations[current].Kind)
+                    {
+                        Active.push_back(current);
+                    }
+                }
+
+                // RECORD EACH VALUE'S LOCATIONS.
+                std::vector<std::uint32_t> interval_order(Intervals.size());
+                for (std::uint32_t interval_index = 0; interval_index < Intervals.size(); ++interval_index)
+                {
+                    interval_order[interval_index] = interval_index;
+                }
+                std::sort(
+                    interval_order.begin(),
+                    interval_order.end(),
+                    [&](const std::uint32_t left, const std::uint32_t right)
+                    {
+                        const LiveInterval& left_interval = Intervals[left];
+                        const LiveInterval& right_interval = Intervals[right];
+                        if (left_interval.Value != right_interval.Value)
+                        {
+                            return left_interval.Value < right_interval.Value;
+                        }
+                        return left_interval.GetStart() < right_interval.GetStart();
+                    });
+                std::vector<bool> block_start_positions(Result.Liveness.PositionCount + 1, false);
+                for (const std::uint32_t block_start : Result.Liveness.BlockStarts)
+                {
+                    block_start_positions[block_start] = true;
+                }
+                Result.LocationsByValue.resize(Source.Values.size());
+                std::array<bool, static_cast<std::size_t>(Register::COUNT)> registers_used = {};
+                for (std::size_t order_index = 0; order_index < interval_order.size(); ++order_index)
+                {
+                    std::uint32_t interval_index = interval_order[order_index];
+                    const LiveInterval& interval = Intervals[interval_index];
+                    const Location& location = IntervalLocations[interval_index];
+                    if (LocationKind::REGISTER == location.Kind)
+                    {
+                        registers_used[static_cast<std::size_t>(location.RegisterId)] = true;
+                    }
+
+                    // Moves at the start of a block are made on each incoming edge instead.
+                    std::vector<LocationStart>& value_locations = Result.LocationsByValue[interval.Value];
+                    if (order_index > 0)
+                    {
+                        std::uint32_t previous_interval_index = interval_order[order_index - 1];
+                        const LiveInterval& previous_interval = Intervals[previous_interval_index];
+                        bool move_needed =
+                            previous_interval.Value == interval.Value &&
+                            previous_interval.GetEnd() == interval.GetStart() &&
+                            !block_start_positions[interval.GetStart()] &&
+                            !(IntervalLocations[previous_interval_index] == location);
+                        if (move_needed)
+                        {
+                            Result.SplitMoves.push_back(SplitMove
+                            {
+                                .Position = interval.GetStart(),
+                                .Source = IntervalLocations[previous_interval_index],
+                                .Destination = location,
+                            });
+                        }
+                    }
+                    value_locations.push_back(LocationStart { .Position = interval.GetStart(), .ValueLocation = location });
+                }
+                std::stable_sort(
+                    Result.SplitMoves.begin(),
+                    Result.SplitMoves.end(),
+                    [](const SplitMove& left, const SplitMove& right) { return left.Position < right.Position; });
+                for (std::size_t register_index = CALLER_SAVED_REGISTER_COUNT; register_index < ALLOCATABLE_REGISTERS.size(); ++register_index)
+                {
+                    Register register_id = ALLOCATABLE_REGISTERS[register_index];
+                    if (registers_used[static_cast<std::size_t>(register_id)])
+                    {
+                        Result.UsedCalleeSavedRegisters.push_back(register_id);
+                    }
+                }
+                Result.SpillSlotCount = SpillSlotCount;
+                return std::move(Result);
+            }
+
+        private:
+            /// Indicates a value without a spill slot.
+            static constexpr std::uint32_t NO_SPILL_SLOT = LiveInterval::NO_POSITION;
+
+            /// Tries to assign a register that's free for at least the start of an interval.
+            /// @param[in] current - The index of the interval.
+            /// @return True if a register was assigned; false if none are free.
+            bool TryAllocateFreeRegister(const std::uint32_t current)
+            {
+                // FIND HOW LONG EACH REGISTER STAYS FREE.
+                std::array<std::uint32_t, ALLOCATABLE_REGISTERS.size()> free_until_positions;
+                free_until_positions.fill(LiveInterval::NO_POSITION);
+                for (const std::uint32_t interval_index : Active)
+                {
+                    free_until_positions[GetRegisterIndex(interval_index)] = 0;
+                }
+                for (const std::uint32_t interval_index : Inactive)
+                {
+                    std::uint32_t intersection = Intervals[interval_index].GetFirstIntersection(Intervals[current]);
+                    std::size_t register_index = GetRegisterIndex(interval_index);
+                    free_until_positions[register_index] = std::min(free_until_positions[register_index], intersection);
+                }
+                std::uint32_t clobber_position = GetFirstClobber(Intervals[current]);
+                for (std::size_t register_index = 0; register_index < CALLER_SAVED_REGISTER_COUNT; ++register_index)
+                {
+                    free_until_positions[register_index] = std::min(free_until_positions[register_index], clobber_position);
+                }
+
+                // ASSIGN THE REGISTER FREE LONGEST.
+                // If it's needed before the interval ends, the rest of the interval is allocated later.
+                std::size_t best_register_index = static_cast<std::size_t>(
+                    std::max_element(free_until_positions.begin(), free_until_positions.end()) - free_until_positions.begin());
+                std::uint32_t free_until_position = free_until_positions[best_register_index];
+                if (free_until_position < Intervals[current].GetEnd())
+                {
+                    std::uint32_t split_position = GetMovePosition(free_until_position);
+                    if (split_position <= Intervals[current].GetStart())
+                    {
+                        return false;
+                    }
+                    SplitAndQueue(current, split_position);
+                }
+                AssignRegister(current, best_register_index);
+                return true;
+            }
+
+            /// Assigns a location to an interval when all registers are in use at its start,
+            /// either spilling it or taking a register from the intervals holding it.
+            /// @param[in] current - The index of the interval.
+            void AllocateBlockedRegister(const std::uint32_t current)
+            {
+                // FIND WHEN EACH REGISTER IS NEXT READ.
+                // A register blocked by a call can only be used until just before it.
+                std::uint32_t position = Intervals[current].GetStart();
+                std::array<std::uint32_t, ALLOCATABLE_REGISTERS.size()> next_use_positions;
+                next_use_positions.fill(LiveInterval::NO_POSITION);
+                std::array<std::uint32_t, ALLOCATABLE_REGISTERS.size()> blocked_positions;
+                blocked_positions.fill(LiveInterval::NO_POSITION);
+                for (const std::uint32_t interval_index : Active)
+                {
+                    std::size_t register_index = GetRegisterIndex(interval_index);
+                    next_use_positions[register_index] = std::min(next_use_positions[register_index], Intervals[interval_index].GetNextUse(position));
+                }
+                for (const std::uint32_t interval_index : Inactive)
+                {
+                    if (LiveInterval::NO_POSITION == Intervals[interval_index].GetFirstIntersection(Intervals[current]))
+                    {
+                        continue;
+                    }
+                    std::size_t register_index = GetRegisterIndex(interval_index);
+                    next_use_positions[register_index] = std::min(next_use_positions[register_index], Intervals[interval_index].GetNextUse(position));
+                }
+                std::uint32_t clobber_position = GetFirstClobber(Intervals[current]);
+                if (LiveInterval::NO_POSITION != clobber_position)
+                {
+                    for (std::size_t register_index = 0; register_index < CALLER_SAVED_REGISTER_COUNT; ++register_index)
+                    {
+                        blocked_positions[register_index] = GetMovePosition(clobber_position);
+                        next_use_positions[register_index] = std::min(next_use_positions[register_index], blocked_positions[register_index]);
+                    }
+                }
+
+                // SPILL THE INTERVAL IF IT'S READ LATER THAN ANY REGISTER'S HOLDERS.
+                std::size_t best_register_index = static_cast<std::size_t>(
+                    std::max_element(next_use_positions.begin(), next_use_positions.end()) - next_use_positions.begin());
+                std::uint32_t first_use_position = Intervals[current].GetNextUse(position);
+                bool spill_current =
+                    LiveInterval::NO_POSITION == first_use_position ||
+                    next_use_positions[best_register_index] < first_use_position ||
+                    blocked_positions[best_register_index] <= position;
+                if (spill_current)
+                {
+                    SpillUntilNextUse(current, position);
+                    return;
+                }
+
+                // TAKE THE REGISTER FROM ITS HOLDERS.
+                // Holders live here are spilled until their next read after this position.
+                // Holders in a lifetime hole are allocated again from where they resume.
+                Register register_id = ALLOCATABLE_REGISTERS[best_register_index];
+                std::vector<std::uint32_t> remaining_active;
+                for (const std::uint32_t interval_index : Active)
+                {
+                    if (register_id != IntervalLocations[interval_index].RegisterId)
+                    {
+                        remaining_active.push_back(interval_index);
+                        continue;
+                    }
+                    Evict(interval_index, GetMovePosition(position), position);
+                }
+                Active = std::move(remaining_active);
+                std::vector<std::uint32_t> remaining_inactive;
+                for (const std::uint32_t interval_index : Inactive)
+                {
+                    std::uint32_t intersection = Intervals[interval_index].GetFirstIntersection(Intervals[current]);
+                    if (register_id != IntervalLocations[interval_index].RegisterId || LiveInterval::NO_POSITION == intersection)
+                    {
+                        remaining_inactive.push_back(interval_index);
+                        continue;
+                    }
+                    std::uint32_t resume_position = Intervals[interval_index].GetEnd();
+                    for (const LiveRange& range : Intervals[interval_index].Ranges)
+                    {
+                        if (range.Start > position)
+                        {
+                            resume_position = range.Start;
+                            break;
+                        }
+                    }
+                    SplitAndQueue(interval_index, GetMovePosition(resume_position));
+                }
+                Inactive = std::move(remaining_inactive);
+
+                // SPLIT THE INTERVAL IF A CALL CLOBBERS THE REGISTER.
+                if (blocked_positions[best_register_index] < Intervals[current].GetEnd())
+                {
+                    SplitAndQueue(current, blocked_positions[best_register_index]);
+                }
+                AssignRegister(current, best_register_index);
+            }
+
+            /// Spills part of an interval that holds a register needed by another.
+            /// @param[in] interval_index - The interval holding the register.
+            /// @param[in] split_position - Where the interval stops holding the register.
+            /// @param[in] position - The position being allocated.  The interval stays spilled
+            ///     until it's read after this, so it won't be allocated again here.
+            void Evict(const std::uint32_t interval_index, const std::uint32_t split_position, const std::uint32_t position)
+            {
+                std::uint32_t evicted_interval_index = interval_index;
+                if (split_position > Intervals[interval_index].GetStart())
+                {
+                    LiveInterval later_part = Intervals[interval_index].SplitAt(split_position);
+                    if (later_part.Ranges.empty())
+                    {
+                        return;
+                    }
+                    evicted_interval_index = AddInterval(std::move(later_part));
+                }
+                SpillUntilNextUse(evicted_interval_index, position);
+            }
+
+            /// Spills an interval until it's next read, queueing the rest for allocation.
+            /// @param[in] interval_index - The interval.
+            /// @param[in] position - The position being allocated.  Reads at or before it are
+            ///     made from the spill slot.
+            void SpillUntilNextUse(const std::uint32_t interval_index, const std::uint32_t position)
+            {
+                std::uint32_t next_use_position = Intervals[interval_index].GetNextUse(position + 1);
+                if (LiveInterval::NO_POSITION != next_use_position && next_use_position > Intervals[interval_index].GetStart())
+                {
+                    SplitAndQueue(interval_index, next_use_position);
+                }
+
+                // ASSIGN THE VALUE'S SPILL SLOT.
+                // Every spilled part of a value shares a slot, so moving between them is free.
+                // Slots are reused once all values in them have ended.
+                INTERMEDIATE_REPRESENTATION::ValueId value = Intervals[interval_index].Value;
+                if (NO_SPILL_SLOT == SpillSlotsByValue[value])
+                {
+                    std::uint32_t spill_slot_index = SpillSlotCount;
+                    if (!FreeSpillSlots.empty() && FreeSpillSlots.top().first <= ValueStarts[value])
+                    {
+                        spill_slot_index = FreeSpillSlots.top().second;
+                        FreeSpillSlots.pop();
+                    }
+                    else
+                    {
+                        ++SpillSlotCount;
+                    }
+                    SpillSlotsByValue[value] = spill_slot_index;
+                    FreeSpillSlots.emplace(ValueEnds[value], spill_slot_index);
+                }
+                IntervalLocations[interval_index] = Location { .Kind = LocationKind::SPILL_SLOT, .SpillSlotIndex = SpillSlotsByValue[value] };
+            }
+
+            /// Splits an interval and queues the later part for allocation.
+            /// @param[in] interval_index - The interval.
+            /// @param[in] split_position - Where to split.  Must be after the interval's start.
+            void SplitAndQueue(const std::uint32_t interval_index, const std::uint32_t split_position)
+            {
+                LiveInterval later_part = Intervals[interval_index].SplitAt(split_position);
+                if (later_part.Ranges.empty())
+                {
+                    return;
+                }
+                std::uint32_t later_start = later_part.GetStart();
+                std::uint32_t later_interval_index = AddInterval(std::move(later_part));
+                Unhandled.emplace(later_start, later_interval_index);
+            }
+
+            /// Adds an interval split from another.
+            /// @param[in] interval - The interval.
+            /// @return The index of the interval.
+            std::uint32_t AddInterval(LiveInterval&& interval)
+            {
+                Intervals.push_back(std::move(interval));
+                IntervalLocations.push_back(Location {});
+                return static_cast<std::uint32_t>(Intervals.size() - 1);
+            }
+
+            /// Assigns a register to an interval.
+            /// @param[in] interval_index - The interval.
+            /// @param[in] register_index - The index of the register among the allocatable ones.
+            void AssignRegister(const std::uint32_t interval_index, const std::size_t register_index)
+            {
+                IntervalLocations[interval_index] = Location { .Kind = LocationKind::REGISTER, .RegisterId = ALLOCATABLE_REGISTERS[register_index] };
+            }
+
+            /// Gets the index among allocatable registers of an interval's register.
+            /// @param[in] interval_index - An interval assigned a register.
+            /// @return The index of the register.
+            std::size_t GetRegisterIndex(const std::uint32_t interval_index) const
+            {
+                Register register_id = IntervalLocations[interval_index].RegisterId;
+                return static_cast<std::size_t>(std::find(ALLOCATABLE_REGISTERS.begin(), ALLOCATABLE_REGISTERS.end(), register_id) - ALLOCATABLE_REGISTERS.begin());
+            }
+
+            /// Finds the first call that clobbers caller-saved registers while an interval is live.
+            /// A call's own result starts after the clobber, so it doesn't count.
+            /// @param[in] interval - The interval.
+            /// @return The position of the clobber, or NO_POSITION if none.
+            std::uint32_t GetFirstClobber(const LiveInterval& interval) const
+            {
+                const std::vector<std::uint32_t>& call_positions = Result.Liveness.CallPositions;
+                for (const LiveRange& range : interval.Ranges)
+                {
+                    auto call_position = std::lower_bound(call_positions.begin(), call_positions.end(), range.Start);
+                    for (; call_position != call_positions.end() && *call_position < range.End; ++call_position)
+                    {
+                        if (*call_position != interval.GetStart())
+                        {
+                            return *call_position;
+                        }
+                    }
+                }
+                return LiveInterval::NO_POSITION;
+            }
+
+            /// Gets the position to move a value at so that it's in its new location by another position.
+            /// Moves happen before instructions read their operands, at even positions.
+            /// @param[in] position - The position the value must be moved by.
+            /// @return The position of the move.
+            static std::uint32_t GetMovePosition(const std::uint32_t position)
+            {
+                return (LiveInterval::NO_POSITION == position) ? position : (position & ~1u);
+            }
+
+            /// The function being allocated.
+            const INTERMEDIATE_REPRESENTATION::Function& Source;
+            /// The allocation being built.
+            RegisterAllocation Result = {};
+            /// All intervals, including those split off from others.
+            std::vector<LiveInterval> Intervals = {};
+            /// The location of each interval.
+            std::vector<Location> IntervalLocations = {};
+            /// The first position where each value is live.
+            std::vector<std::uint32_t> ValueStarts = {};
+            /// The position after each value's last range.
+            std::vector<std::uint32_t> ValueEnds = {};
+            /// The spill slot of each value, if it's been spilled.
+            std::vector<std::uint32_t> SpillSlotsByValue = {};
+            /// The number of spill slots used.
+            std::uint32_t SpillSlotCount = 0;
+            /// Spill slots by the position after which they're free, earliest first.
+            std::priority_queue<std::pair<std::uint32_t, std::uint32_t>, std::vector<std::pair<std::uint32_t, std::uint32_t>>, std::greater<>> FreeSpillSlots = {};
+            /// Intervals yet to be allocated by start, earliest first.
+            std::priority_queue<std::pair<std::uint32_t, std::uint32_t>, std::vector<std::pair<std::uint32_t, std::uint32_t>>, std::greater<>> Unhandled = {};
+            /// Intervals holding registers that are live at the current position.
+            std::vector<std::uint32_t> Active = {};
+            /// Intervals holding registers that are in a lifetime hole at the current position.
+            std::vector<std::uint32_t> Inactive = {};
+        };
+    };
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+
+namespace CODE_GENERATION
+{
+    /// A half-open range of positions where a value is live.
+    struct LiveRange
+    {
+        /// The first position in the range.
+        std::uint32_t Start = 0;
+        /// The position just after the range.
+        std::uint32_t End = 0;
+    };
+
+    /// The positions where a value (or part of one, after splitting) is live.
+    ///
+    /// Instructions are numbered in block order.  Instruction n reads its operands at
+    /// position 2n and writes its result at position 2n + 1, so a value last read by an
+    /// instruction may share a register with that instruction's result.  Ranges may have
+    /// holes where a value isn't live, such as blocks on paths that don't use it.
+    struct LiveInterval
+    {
+        /// A position after all others.
+        static constexpr std::uint32_t NO_POSITION = std::numeric_limits<std::uint32_t>::max();
+
+        /// Gets the first position where the interval is live.
+        /// @return The start of the first range.
+        std::uint32_t GetStart() const
+        {
+            return Ranges.front().Start;
+        }
+
+        /// Gets the position after the last where the interval is live.
+        /// @return The end of the last range.
+        std::uint32_t GetEnd() const
+        {
+            return Ranges.back().End;
+        }
+
+        /// Checks if the interval is live at a position.
+        /// @param[in] position - The position.
+        /// @return True if some range contains the position.
+        bool Covers(const std::uint32_t position) const
+        {
+            auto range = std::upper_bound(
+                Ranges.begin(),
+                Ranges.end(),
+                position,
+                [](const std::uint32_t searched_position, const LiveRange& live_range) { return searched_position < live_range.Start; });
+            return range != Ranges.begin() && position < (range - 1)->End;
+        }
+
+        /// Finds the first position where this interval and another are both live.
+        /// @param[in] other - The other interval.
+        /// @return The first shared position, or NO_POSITION if they don't intersect.
+        std::uint32_t GetFirstIntersection(const LiveInterval& other) const
+        {
+            std::size_t range_index = 0;
+            std::size_t other_range_index = 0;
+            while (range_index < Ranges.size() && other_range_index < other.Ranges.size())
+            {
+                const LiveRange& range = Ranges[range_index];
+                const LiveRange& other_range = other.Ranges[other_range_index];
+                std::uint32_t start = std::max(range.Start, other_range.Start);
+                if (start < std::min(range.End, other_range.End))
+                {
+                    return start;
+                }
+
+                if (range.End <= other_range.End)
+                {
+                    ++range_index;
+                }
+                else
+                {
+                    ++other_range_index;
+                }
+            }
+            return NO_POSITION;
+        }
+
+        /// Finds the first use at or after a position.
+        /// @param[in] position - The position.
+        /// @return The position of the use, or NO_POSITION if there are none.
+        std::uint32_t GetNextUse(const std::uint32_t position) const
+        {
+            auto use = std::lower_bound(UsePositions.begin(), UsePositions.end(), position);
+            return (use != UsePositions.end()) ? *use : NO_POSITION;
+        }
+
+        /// Moves the part of the interval from a position onward to a new interval.
+        /// @param[in] position - The position to split at.  Must be after the start.
+        /// @return The part from the position onward, which may be empty if the
+        ///     interval ends first.
+        LiveInterval SplitAt(const std::uint32_t position)
+        {
+            LiveInterval later_part;
+            later_part.Value = Value;
+
+            // SPLIT THE RANGES.
+            // A range containing the position is cut in two.
+            auto first_later_range = std::find_if(Ranges.begin(), Ranges.end(), [position](const LiveRange& range) { return range.End > position; });
+            if (first_later_range != Ranges.end() && first_later_range->Start < position)
+            {
+                later_part.Ranges.push_back(LiveRange { .Start = position, .End = first_later_range->End });
+                first_later_range->End = position;
+                ++first_later_range;
+            }
+            later_part.Ranges.insert(later_part.Ranges.end(), first_later_range, Ranges.end());
+            Ranges.erase(first_later_range, Ranges.end());
+
+            // SPLIT THE USES.
+            auto first_later_use = std::lower_bound(UsePositions.begin(), UsePositions.end(), position);
+            later_part.UsePositions.assign(first_later_use, UsePositions.end());
+            UsePositions.erase(first_later_use, UsePositions.end());
+            return later_part;
+        }
+
+        /// The value the interval is for.
+        INTERMEDIATE_REPRESENTATION::ValueId Value = INTERMEDIATE_REPRESENTATION::INVALID_ID;
+        /// The sorted, non-overlapping ranges where the value is live.
+        std::vector<LiveRange> Ranges = {};
+        /// The sorted positions where the value is read.
+        std::vector<std::uint32_t> UsePositions = {};
+    };
+
+    /// The numbering of a function's instructions and the live intervals of its values.
+    ///
+    /// Liveness is found per value by walking backward from each use to the definition,
+    /// marking blocks the value is live into along the way and stopping at blocks already
+    /// marked.  This costs time proportional to the size of the resulting intervals rather
+    /// than the blocks times values of iterative data-flow, which matters for very large
+    /// generated functions.  Blocks are laid out in index order, which is also the order
+    /// code is generated in.
+    struct LiveIntervals
+    {
+        /// Builds live intervals for a function.
+        /// @param[in] function - The function.
+        /// @return The intervals for values that are read, along with the numbering.
+        static LiveIntervals Build(const INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            LiveIntervals live_intervals;
+
+            // NUMBER THE INSTRUCTIONS.
+            // Calls clobber caller-saved registers at the position their result is written.
+            live_intervals.InstructionNumbers.assign(function.Values.size(), 0);
+            live_intervals.BlockStarts.assign(function.Blocks.size(), 0);
+            live_intervals.BlockEnds.assign(function.Blocks.size(), 0);
+            std::uint32_t instruction_number = 0;
+            for (BlockId block_id = 0; block_id < function.Blocks.size(); ++block_id)
+            {
+                live_intervals.BlockStarts[block_id] = 2 * instruction_number;
+                for (const ValueId instruction_id : function.Blocks[block_id].Instructions)
+                {
+                    live_intervals.InstructionNumbers[instruction_id] = instruction_number;
+                    if (InstructionKind::CALL == function.Values[instruction_id].Kind)
+                    {
+                        live_intervals.CallPositions.push_back(2 * instruction_number + 1);
+                    }
+                    ++instruction_number;
+                }
+                live_intervals.BlockEnds[block_id] = 2 * instruction_number;
+            }
+            live_intervals.PositionCount = 2 * instruction_number;
+
+            // FIND WHERE EACH VALUE IS READ.
+            // Phi operands are read at the end of the corresponding predecessor, where
+            // they're moved into place for the phi, so they count as uses by its terminator.
+            struct ValueRead
+            {
+                ValueId Value = INVALID_ID;
+                BlockId Block = INVALID_ID;
+                std::uint32_t Position = 0;
+                bool AtBlockEnd = false;
+            };
+            std::vector<ValueRead> reads;
+            for (BlockId block_id = 0; block_id < function.Blocks.size(); ++block_id)
+            {
+                const BasicBlock& block = function.Blocks[block_id];
+                for (const ValueId instruction_id : block.Instructions)
+                {
+                    bool is_phi = (InstructionKind::PHI == function.Values[instruction_id].Kind);
+                    std::span<const ValueId> operands = function.GetOperands(instruction_id);
+                    for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+                    {
+                        ValueId operand = operands[operand_index];
+                        if (!HasInterval(function, operand))
+                        {
+                            continue;
+                        }
+
+                        if (is_phi)
+                        {
+                            BlockId predecessor = block.Predecessors[operand_index];
+                            reads.push_back(ValueRead { .Value = operand, .Block = predecessor, .Position = live_intervals.BlockEnds[predecessor] - 2, .AtBlockEnd = true });
+                        }
+                        else
+                        {
+                            reads.push_back(ValueRead { .Value = operand, .Block = block_id, .Position = 2 * live_intervals.InstructionNumbers[instruction_id], .AtBlockEnd = false });
+                        }
+                    }
+                }
+            }
+            std::stable_sort(reads.begin(), reads.end(), [](const ValueRead& left, const ValueRead& right) { return left.Value < right.Value; });
+
+            // BUILD EACH READ VALUE'S INTERVAL.
+            live_intervals.LiveInValues.resize(function.Blocks.size());
+            std::vector<ValueId> marked_values_by_block(function.Blocks.size(), INVALID_ID);
+            std::vector<BlockId> block_worklist;
+            for (std::size_t read_index = 0; read_index < reads.size();)
+            {
+                ValueId value = reads[read_index].Value;
+                const Instruction& definition = function.Values[value];
+                BlockId definition_block = definition.Block;
+                std::uint32_t definition_position = live_intervals.GetDefinitionPosition(function, value);
+
+                LiveInterval interval;
+                interval.Value = value;
+                for (; read_index < reads.size() && reads[read_index].Value == value; ++read_index)
+                {
+                    // ADD THE RANGE WITHIN THE READING BLOCK.
+                    const ValueRead& read = reads[read_index];
+                    interval.UsePositions.push_back(read.Position);
+                    std::uint32_t read_end = read.AtBlockEnd ? live_intervals.BlockEnds[read.Block] : read.Position + 1;
+                    if (definition_block == read.Block)
+                    {
+                        interval.Ranges.push_back(LiveRange { .Start = definition_position, .End = read_end });
+                        continue;
+                    }
+                    interval.Ranges.push_back(LiveRange { .Start = live_intervals.BlockStarts[read.Block], .End = read_end });
+                    if (marked_values_by_block[read.Block] == value)
+                    {
+                        continue;
+                    }
+
+                    // WALK BACK TO THE DEFINITION.
+                    // Each block reached is live throughout, except the defining block,
+                    // where the value is live from its definition to the end.
+                    marked_values_by_block[read.Block] = value;
+                    live_intervals.LiveInValues[read.Block].push_back(value);
+                    block_worklist.push_back(read.Block);
+                    while (!block_worklist.empty())
+                    {
+                        BlockId block_id = block_worklist.back();
+                        block_worklist.pop_back();
+                        for (const BlockId predecessor : function.Blocks[block_id].Predecessors)
+                        {
+                            if (definition_block == predecessor)
+                            {
+                                interval.Ranges.push_back(LiveRange { .Start = definition_position, .End = live_intervals.BlockEnds[predecessor] });
+                                continue;
+                            }
+                            // A block reached earlier from a read within it may only have
+                            // a range up to that read, so the whole block is added again.
+                            interval.Ranges.push_back(LiveRange { .Start = live_intervals.BlockStarts[predecessor], .End = live_intervals.BlockEnds[predecessor] });
+                            if (marked_values_by_block[predecessor] == value)
+                            {
+                                continue;
+                            }
+                            marked_values_by_block[predecessor] = value;
+                            live_intervals.LiveInValues[predecessor].push_back(value);
+                            block_worklist.push_back(predecessor);
+                        }
+                    }
+                }
+
+                // MERGE OVERLAPPING AND ADJACENT RANGES.
+                std::sort(interval.Ranges.begin(), interval.Ranges.end(), [](const LiveRange& left, const LiveRange& right) { return left.Start < right.Start; });
+                std::size_t merged_range_count = 0;
+                for (const LiveRange& range : interval.Ranges)
+                {
+                    if (merged_range_count > 0 && range.Start <= interval.Ranges[merged_range_count - 1].End)
+                    {
+                        interval.Ranges[merged_range_count - 1].End = std::max(interval.Ranges[merged_range_count - 1].End, range.End);
+                    }
+                    else
+                    {
+                        interval.Ranges[merged_range_count++] = range;
+                    }
+                }
+                interval.Ranges.resize(merged_range_count);
+                std::sort(interval.UsePositions.begin(), interval.UsePositions.end());
+                live_intervals.Intervals.push_back(std::move(interval));
+            }
+            return live_intervals;
+        }
+
+        /// Checks if a value needs a location, rather than being a constant or an address computed when used.
+        /// @param[in] function - The function containing the value.
+        /// @param[in] value - The value.
+        /// @return True if the value is the result of an instruction that must be kept somewhere.
+        static bool HasInterval(const INTERMEDIATE_REPRESENTATION::Function& function, const INTERMEDIATE_REPRESENTATION::ValueId value)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            const Instruction& instruction = function.Values[value];
+            return INVALID_ID != instruction.Block &&
+                ValueType::VOID != instruction.Type &&
+                InstructionKind::STACK_SLOT != instruction.Kind;
+        }
+
+        /// Gets the position where a value is written.
+        /// Parameters are all written on entry, before any instruction, and phis at the start of their block.
+        /// @param[in] function - The function containing the value.
+        /// @param[in] value - The value.
+        /// @return The position.
+        std::uint32_t GetDefinitionPosition(const INTERMEDIATE_REPRESENTATION::Function& function, const INTERMEDIATE_REPRESENTATION::ValueId value) const
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            const Instruction& instruction = function.Values[value];
+            switch (instruction.Kind)
+            {
+                case InstructionKind::PARAMETER:
+                    return 0;
+                case InstructionKind::PHI:
+                    return BlockStarts[instruction.Block];
+                default:
+                    return 2 * InstructionNumbers[value] + 1;
+            }
+        }
+
+        /// The number of each instruction in layout order, by ID.
+        std::vector<std::uint32_t> InstructionNumbers = {};
+        /// The first position in each block.
+        std::vector<std::uint32_t> BlockStarts = {};
+        /// The position just after each block.
+        std::vector<std::uint32_t> BlockEnds = {};
+        /// The total number of positions.
+        std::uint32_t PositionCount = 0;
+        /// The positions where calls clobber caller-saved registers, in order.
+        std::vector<std::uint32_t> CallPositions = {};
+        /// The values live on entry to each block, excluding the block's phis.
+        std::vector<std::vector<INTERMEDIATE_REPRESENTATION::ValueId>> LiveInValues = {};
+        /// The intervals of all values that are read, in order of value ID.
+        std::vector<LiveInterval> Intervals = {};
+    };
+}
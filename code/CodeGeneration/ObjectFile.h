@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CODE_GENERATION
+{
+    /// A function defined in an object file's code.
+    struct DefinedFunction
+    {
+        /// The name of the function.
+        std::string Name = "";
+        /// The offset of the function's first instruction in the code.
+        std::uint64_t Offset = 0;
+        /// The size of the function's code in bytes.
+        std::uint64_t Size = 0;
+        /// True if the function is only visible within the object file (as for static functions).
+        bool IsLocal = false;
+    };
+
+    /// The different kinds of references to fill in when the object is linked.
+    enum class RelocationKind
+    {
+        /// A 32-bit displacement to a function, which may be defined elsewhere.
+        FUNCTION_CALL,
+        /// A 32-bit displacement to an offset within the read-only data.
+        READ_ONLY_DATA_ADDRESS,
+    };
+
+    /// A reference from code that the linker fills in.
+    struct Relocation
+    {
+        /// The kind of reference.
+        RelocationKind Kind = RelocationKind::FUNCTION_CALL;
+        /// The offset of the 32-bit displacement in the code.
+        std::uint64_t Offset = 0;
+        /// For function calls, the name of the function called.
+        std::string FunctionName = "";
+        /// For read-only data, the offset of the data referenced.
+        std::uint64_t DataOffset = 0;
+    };
+
+    /// Machine code and data for a translation unit, independent of any object file format.
+    struct ObjectFile
+    {
+        /// The machine code for all functions.
+        std::vector<std::uint8_t> Code = {};
+        /// Read-only data, such as string literals.
+        std::vector<std::uint8_t> ReadOnlyData = {};
+        /// The functions defined in the code, in order.
+        std::vector<DefinedFunction> Functions = {};
+        /// The references in the code to fill in when linking.
+        std::vector<Relocation> Relocations = {};
+    };
+
+    /// Machine code for a single function, generated independently of other functions
+    /// so that functions can be generated in parallel and combined afterward.
+    struct FunctionCode
+    {
+        /// The name of the function.
+        std::string Name = "";
+        /// True if the function is only visible within the object file.
+        bool IsLocal = false;
+        /// The function's code, read-only data, and relocations, as if it were alone in an object file.
+        ObjectFile Object = {};
+        /// The null-terminated strings making up the read-only data, in order.
+        std::vector<std::string> StringLiterals = {};
+    };
+}
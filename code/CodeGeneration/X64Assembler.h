@@ -0,0 +1,527 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace CODE_GENERATION
+{
+    /// The x86-64 general-purpose registers, numbered as in instruction encodings.
+    enum class Register : std::uint8_t
+    {
+        RAX = 0,
+        RCX,
+        RDX,
+        RBX,
+        RSP,
+        RBP,
+        RSI,
+        RDI,
+        R8,
+        R9,
+        R10,
+        R11,
+        R12,
+        R13,
+        R14,
+        R15,
+        /// The number of registers.  Must remain last.
+        COUNT
+    };
+
+    /// Conditions for conditional jumps and sets, numbered as in instruction encodings.
+    enum class ConditionCode : std::uint8_t
+    {
+        BELOW = 0x2,
+        ABOVE_OR_EQUAL = 0x3,
+        EQUAL = 0x4,
+        NOT_EQUAL = 0x5,
+        BELOW_OR_EQUAL = 0x6,
+        ABOVE = 0x7,
+        LESS = 0xC,
+        GREATER_OR_EQUAL = 0xD,
+        LESS_OR_EQUAL = 0xE,
+        GREATER = 0xF,
+    };
+
+    /// Arithmetic and logic operations sharing the same register-to-register encoding.
+    enum class ArithmeticOperation : std::uint8_t
+    {
+        ADD = 0x01,
+        OR = 0x09,
+        AND = 0x21,
+        SUBTRACT = 0x29,
+        XOR = 0x31,
+        COMPARE = 0x39,
+    };
+
+    /// Operations using the F7 group encoding on a single register.
+    enum class UnaryOperation : std::uint8_t
+    {
+        NOT = 2,
+        NEGATE = 3,
+        UNSIGNED_DIVIDE = 6,
+        SIGNED_DIVIDE = 7,
+    };
+
+    /// Shifts by the CL register, using the D3 group encoding.
+    enum class ShiftOperation : std::uint8_t
+    {
+        SHIFT_LEFT = 4,
+        LOGICAL_SHIFT_RIGHT = 5,
+        ARITHMETIC_SHIFT_RIGHT = 7,
+    };
+
+    /// Encodes x86-64 instructions into machine code.
+    ///
+    /// Only the instructions the code generator needs are supported, each in a
+    /// single fixed form, so the encodings are simple to check against the
+    /// manuals: 64-bit operations with a REX.W prefix, memory operands as a base
+    /// register plus displacement, and 32-bit relative branch displacements.
+    /// Instructions referring to locations not yet known return the offset of
+    /// their displacement to be patched or relocated later.
+    struct X64Assembler
+    {
+        /// Copies one register to another.
+        /// @param[in] destination - The register to write.
+        /// @param[in] source - The register to read.
+        void Move(const Register destination, const Register source)
+        {
+            EmitRex(true, source, destination);
+            EmitByte(0x89);
+            EmitRegisterOperands(source, destination);
+        }
+
+        /// Loads a constant into a register, using the shortest encoding for its value.
+        /// @param[in] destination - The register to write.
+        /// @param[in] value - The constant.
+        void MoveImmediate(const Register destination, const std::int64_t value)
+        {
+            if (0 == value)
+            {
+                // A 32-bit XOR clears the whole register in the fewest bytes.
+                EmitRex(false, destination, destination);
+                EmitByte(0x31);
+                EmitRegisterOperands(destination, destination);
+            }
+            else if (INT32_MIN <= value && value <= INT32_MAX)
+            {
+                EmitRex(true, Register::RAX, destination);
+                EmitByte(0xC7);
+                EmitRegisterOperands(Register::RAX, destination);
+                EmitUInt32(static_cast<std::uint32_t>(value));
+            }
+            else
+            {
+                EmitRex(true, Register::RAX, destination);
+                EmitByte(0xB8 + GetLowBits(destination));
+                EmitUInt64(static_cast<std::uint64_t>(value));
+            }
+        }
+
+        /// Loads a value from memory, sign-extending it to 64 bits.
+        /// @param[in] destination - The register to write.
+        /// @param[in] base - The register holding the base address.
+        /// @param[in] displacement - The offset from the base address.
+        /// @param[in] size_in_bytes - The size of the value in memory (1, 2, 4, or 8).
+        void LoadSignExtended(const Register destination, const Register base, const std::int32_t displacement, const std::size_t size_in_bytes)
+        {
+            EmitRex(true, destination, base);
+            switch (size_in_bytes)
+            {
+                case 1:
+                    EmitBytes({ 0x0F, 0xBE });
+                    break;
+                case 2:
+                    EmitBytes({ 0x0F, 0xBF });
+                    break;
+                case 4:
+                    EmitByte(0x63);
+                    break;
+                default:
+                    EmitByte(0x8B);
+                    break;
+            }
+            EmitMemoryOperand(destination, base, displacement);
+        }
+
+        /// Stores the low bytes of a register to memory.
+        /// @param[in] base - The register holding the base address.
+        /// @param[in] displacement - The offset from the base address.
+        /// @param[in] source - The register to store.
+        /// @param[in] size_in_bytes - The number of bytes to store (1, 2, 4, or 8).
+        void Store(const Register base, const std::int32_t displacement, const Register source, const std::size_t size_in_bytes)
+        {
+            if (2 == size_in_bytes)
+            {
+                EmitByte(0x66);
+            }
+            // Without a REX prefix, byte registers 4-7 would be AH through BH rather than SPL through DIL.
+            bool needs_rex = (8 == size_in_bytes || NeedsRexExtension(source) || NeedsRexExtension(base) || (1 == size_in_bytes && source >= Register::RSP));
+            if (needs_rex)
+            {
+                EmitRex(8 == size_in_bytes, source, base, true);
+            }
+            EmitByte((1 == size_in_bytes) ? 0x88 : 0x89);
+            EmitMemoryOperand(source, base, displacement);
+        }
+
+        /// Computes an address without accessing memory.
+        /// @param[in] destination - The register to write.
+        /// @param[in] base - The register holding the base address.
+        /// @param[in] displacement - The offset from the base address.
+        void LoadEffectiveAddress(const Register destination, const Register base, const std::int32_t displacement)
+        {
+            EmitRex(true, destination, base);
+            EmitByte(0x8D);
+            EmitMemoryOperand(destination, base, displacement);
+        }
+
+        /// Computes an address relative to the next instruction.
+        /// @param[in] destination - The register to write.
+        /// @return The offset of the 32-bit displacement to relocate.
+        std::size_t LoadRipRelativeAddress(const Register destination)
+        {
+            EmitRex(true, destination, Register::RAX);
+            EmitByte(0x8D);
+            EmitByte(static_cast<std::uint8_t>((GetLowBits(destination) << 3) | 0b101));
+            std::size_t displacement_offset = Code.size();
+            EmitUInt32(0);
+            return displacement_offset;
+        }
+
+        /// Performs an arithmetic or logic operation on two registers.
+        /// @param[in] operation - The operation.
+        /// @param[in] destination - The first operand, which receives the result (except for comparisons).
+        /// @param[in] source - The second operand.
+        void Arithmetic(const ArithmeticOperation operation, const Register destination, const Register source)
+        {
+            EmitRex(true, source, destination);
+            EmitByte(static_cast<std::uint8_t>(operation));
+            EmitRegisterOperands(source, destination);
+        }
+
+        /// Performs an arithmetic operation with a constant.
+        /// @param[in] operation - The operation (add, subtract, or compare).
+        /// @param[in] destination - The first operand, which receives the result (except for comparisons).
+        /// @param[in] value - The constant second operand.
+        void ArithmeticImmediate(const ArithmeticOperation operation, const Register destination, const std::int32_t value)
+        {
+            // The 81 group's operation numbers are the register-form opcodes divided by 8.
+            std::uint8_t operation_number = static_cast<std::uint8_t>(operation) >> 3;
+            EmitRex(true, Register::RAX, destination);
+            if (INT8_MIN <= value && value <= INT8_MAX)
+            {
+                EmitByte(0x83);
+                EmitByte(static_cast<std::uint8_t>(0xC0 | (operation_number << 3) | GetLowBits(destination)));
+                EmitByte(static_cast<std::uint8_t>(value));
+            }
+            else
+            {
+                EmitByte(0x81);
+                EmitByte(static_cast<std::uint8_t>(0xC0 | (operation_number << 3) | GetLowBits(destination)));
+                EmitUInt32(static_cast<std::uint32_t>(value));
+            }
+        }
+
+        /// Multiplies two registers, keeping the low 64 bits.
+        /// @param[in] destination - The first operand, which receives the result.
+        /// @param[in] source - The second operand.
+        void Multiply(const Register destination, const Register source)
+        {
+            EmitRex(true, destination, source);
+            EmitBytes({ 0x0F, 0xAF });
+            EmitRegisterOperands(destination, source);
+        }
+
+        /// Performs a single-operand operation, including division of RDX:RAX.
+        /// @param[in] operation - The operation.
+        /// @param[in] operand - The operand (the divisor for division).
+        void Unary(const UnaryOperation operation, const Register operand)
+        {
+            EmitRex(true, Register::RAX, operand);
+            EmitByte(0xF7);
+            EmitByte(static_cast<std::uint8_t>(0xC0 | (static_cast<std::uint8_t>(operation) << 3) | GetLowBits(operand)));
+        }
+
+        /// Sign-extends RAX into RDX:RAX before signed division (CQO).
+        void SignExtendAccumulator()
+        {
+            EmitBytes({ 0x48, 0x99 });
+        }
+
+        /// Shifts a register by the count in CL.
+        /// @param[in] operation - The shift.
+        /// @param[in] operand - The register to shift.
+        void Shift(const ShiftOperation operation, const Register operand)
+        {
+            EmitRex(true, Register::RAX, operand);
+            EmitByte(0xD3);
+            EmitByte(static_cast<std::uint8_t>(0xC0 | (static_cast<std::uint8_t>(operation) << 3) | GetLowBits(operand)));
+        }
+
+        /// Sign-extends the low bytes of a register to 64 bits.
+        /// @param[in] destination - The register to write.
+        /// @param[in] source - The register to read.
+        /// @param[in] size_in_bytes - The number of low bytes to extend (1, 2, or 4).
+        void SignExtend(const Register destination, const Register source, const std::size_t size_in_bytes)
+        {
+            EmitRex(true, destination, source);
+            switch (size_in_bytes)
+            {
+                case 1:
+                    EmitBytes({ 0x0F, 0xBE });
+                    break;
+                case 2:
+                    EmitBytes({ 0x0F, 0xBF });
+                    break;
+                default:
+                    EmitByte(0x63);
+                    break;
+            }
+            EmitRegisterOperands(destination, source);
+        }
+
+        /// Zero-extends the low bytes of a register to 64 bits.
+        /// @param[in] destination - The register to write.
+        /// @param[in] source - The register to read.
+        /// @param[in] size_in_bytes - The number of low bytes to extend (1, 2, or 4).
+        void ZeroExtend(const Register destination, const Register source, const std::size_t size_in_bytes)
+        {
+            // 32-bit operations clear the upper half of their destination, so no REX.W is needed.
+            bool needs_rex = (NeedsRexExtension(destination) || NeedsRexExtension(source) || (1 == size_in_bytes && source >= Register::RSP));
+            if (needs_rex)
+            {
+                EmitRex(false, (4 == size_in_bytes) ? source : destination, (4 == size_in_bytes) ? destination : source, true);
+            }
+            switch (size_in_bytes)
+            {
+                case 1:
+                    EmitBytes({ 0x0F, 0xB6 });
+                    EmitRegisterOperands(destination, source);
+                    break;
+                case 2:
+                    EmitBytes({ 0x0F, 0xB7 });
+                    EmitRegisterOperands(destination, source);
+                    break;
+                default:
+                    EmitByte(0x89);
+                    EmitRegisterOperands(source, destination);
+                    break;
+            }
+        }
+
+        /// Sets the low byte of a register to 1 if a condition holds and 0 otherwise,
+        /// then zero-extends it to the whole register.
+        /// @param[in] condition - The condition.
+        /// @param[in] destination - The register to write.
+        void SetIf(const ConditionCode condition, const Register destination)
+        {
+            bool needs_rex = (destination >= Register::RSP);
+            if (needs_rex)
+            {
+                EmitRex(false, Register::RAX, destination, true);
+            }
+            EmitBytes({ 0x0F, static_cast<std::uint8_t>(0x90 | static_cast<std::uint8_t>(condition)) });
+            EmitRegisterOperands(Register::RAX, destination);
+            ZeroExtend(destination, destination, 1);
+        }
+
+        /// Sets flags from the bitwise AND of two registers.
+        /// @param[in] first - The first register.
+        /// @param[in] second - The second register.
+        void Test(const Register first, const Register second)
+        {
+            EmitRex(true, second, first);
+            EmitByte(0x85);
+            EmitRegisterOperands(second, first);
+        }
+
+        /// Pushes a register onto the stack.
+        /// @param[in] source - The register.
+        void Push(const Register source)
+        {
+            if (NeedsRexExtension(source))
+            {
+                EmitByte(0x41);
+            }
+            EmitByte(0x50 + GetLowBits(source));
+        }
+
+        /// Pops the top of the stack into a register.
+        /// @param[in] destination - The register.
+        void Pop(const Register destination)
+        {
+            if (NeedsRexExtension(destination))
+            {
+                EmitByte(0x41);
+            }
+            EmitByte(0x58 + GetLowBits(destination));
+        }
+
+        /// Calls a function at a 32-bit displacement from the next instruction.
+        /// @return The offset of the displacement to relocate.
+        std::size_t Call()
+        {
+            EmitByte(0xE8);
+            std::size_t displacement_offset = Code.size();
+            EmitUInt32(0);
+            return displacement_offset;
+        }
+
+        /// Jumps to a 32-bit displacement from the next instruction.
+        /// @return The offset of the displacement to patch.
+        std::size_t Jump()
+        {
+            EmitByte(0xE9);
+            std::size_t displacement_offset = Code.size();
+            EmitUInt32(0);
+            return displacement_offset;
+        }
+
+        /// Jumps to a 32-bit displacement from the next instruction if a condition holds.
+        /// @param[in] condition - The condition.
+        /// @return The offset of the displacement to patch.
+        std::size_t JumpIf(const ConditionCode condition)
+        {
+            EmitBytes({ 0x0F, static_cast<std::uint8_t>(0x80 | static_cast<std::uint8_t>(condition)) });
+            std::size_t displacement_offset = Code.size();
+            EmitUInt32(0);
+            return displacement_offset;
+        }
+
+        /// Restores the caller's stack and frame pointers (LEAVE).
+        void Leave()
+        {
+            EmitByte(0xC9);
+        }
+
+        /// Returns to the caller (RET).
+        void Return()
+        {
+            EmitByte(0xC3);
+        }
+
+        /// Sets a previously emitted 32-bit displacement to reach a target in the same code.
+        /// @param[in] displacement_offset - The offset of the displacement.
+        /// @param[in] target_offset - The offset of the target.
+        void PatchDisplacement(const std::size_t displacement_offset, const std::size_t target_offset)
+        {
+            std::int64_t displacement = static_cast<std::int64_t>(target_offset) - static_cast<std::int64_t>(displacement_offset + 4);
+            std::uint32_t encoded_displacement = static_cast<std::uint32_t>(displacement);
+            for (std::size_t byte_index = 0; byte_index < 4; ++byte_index)
+            {
+                Code[displacement_offset + byte_index] = static_cast<std::uint8_t>(encoded_displacement >> (8 * byte_index));
+            }
+        }
+
+        /// The machine code emitted so far.
+        std::vector<std::uint8_t> Code = {};
+
+    private:
+        /// Determines if a register needs a REX prefix bit to be encoded.
+        /// @param[in] register_id - The register.
+        /// @return True for R8 through R15; false otherwise.
+        static bool NeedsRexExtension(const Register register_id)
+        {
+            return register_id >= Register::R8;
+        }
+
+        /// Gets the 3 bits of a register's number that fit in a ModRM field.
+        /// @param[in] register_id - The register.
+        /// @return The low 3 bits.
+        static std::uint8_t GetLowBits(const Register register_id)
+        {
+            return static_cast<std::uint8_t>(register_id) & 0b111;
+        }
+
+        /// Emits a REX prefix if needed.
+        /// @param[in] is_64_bit - True if the operation is 64-bit (REX.W).
+        /// @param[in] reg - The register in the ModRM reg field.
+        /// @param[in] rm - The register in the ModRM rm field (or the base of a memory operand).
+        /// @param[in] always - True to emit a prefix even if no bits are set.
+        void EmitRex(const bool is_64_bit, const Register reg, const Register rm, const bool always = false)
+        {
+            std::uint8_t rex = 0x40;
+            if (is_64_bit) rex |= 0x08;
+            if (NeedsRexExtension(reg)) rex |= 0x04;
+            if (NeedsRexExtension(rm)) rex |= 0x01;
+            if (0x40 != rex || always)
+            {
+                EmitByte(rex);
+            }
+        }
+
+        /// Emits a ModRM byte for two register operands.
+        /// @param[in] reg - The register for the reg field.
+        /// @param[in] rm - The register for the rm field.
+        void EmitRegisterOperands(const Register reg, const Register rm)
+        {
+            EmitByte(static_cast<std::uint8_t>(0xC0 | (GetLowBits(reg) << 3) | GetLowBits(rm)));
+        }
+
+        /// Emits a ModRM byte (and any SIB byte and displacement) for a register and a memory operand.
+        /// @param[in] reg - The register for the reg field.
+        /// @param[in] base - The base register of the memory operand.
+        /// @param[in] displacement - The offset from the base register.
+        void EmitMemoryOperand(const Register reg, const Register base, const std::int32_t displacement)
+        {
+            // RBP and R13 can't be used as a base without a displacement, since that
+            // encoding means RIP-relative, so they always get at least an 8-bit one.
+            bool is_8_bit_displacement = (INT8_MIN <= displacement && displacement <= INT8_MAX);
+            bool needs_displacement = (0 != displacement || Register::RBP == base || Register::R13 == base);
+            std::uint8_t mode = !needs_displacement ? 0b00 : (is_8_bit_displacement ? 0b01 : 0b10);
+            EmitByte(static_cast<std::uint8_t>((mode << 6) | (GetLowBits(reg) << 3) | GetLowBits(base)));
+
+            // RSP and R12 as a base need a SIB byte, since their rm encoding means a SIB byte follows.
+            if (0b100 == GetLowBits(base))
+            {
+                EmitByte(0x24);
+            }
+
+            if (0b01 == mode)
+            {
+                EmitByte(static_cast<std::uint8_t>(displacement));
+            }
+            else if (0b10 == mode)
+            {
+                EmitUInt32(static_cast<std::uint32_t>(displacement));
+            }
+        }
+
+        /// Emits a single byte.
+        /// @param[in] value - The byte.
+        void EmitByte(const std::uint8_t value)
+        {
+            Code.push_back(value);
+        }
+
+        /// Emits several bytes.
+        /// @param[in] values - The bytes.
+        void EmitBytes(const std::initializer_list<std::uint8_t> values)
+        {
+            Code.insert(Code.end(), values.begin(), values.end());
+        }
+
+        /// Emits a little-endian 32-bit value.
+        /// @param[in] value - The value.
+        void EmitUInt32(const std::uint32_t value)
+        {
+            for (std::size_t byte_index = 0; byte_index < 4; ++byte_index)
+            {
+                EmitByte(static_cast<std::uint8_t>(value >> (8 * byte_index)));
+            }
+        }
+
+        /// Emits a little-endian 64-bit value.
+        /// @param[in] value - The value.
+        void EmitUInt64(const std::uint64_t value)
+        {
+            for (std::size_t byte_index = 0; byte_index < 8; ++byte_index)
+            {
+                EmitByte(static_cast<std::uint8_t>(value >> (8 * byte_index)));
+            }
+        }
+    };
+}
@@ -0,0 +1,966 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CodeGeneration/LinearScanRegisterAllocator.h"
+#include "CodeGeneration/ObjectFile.h"
+#include "CodeGeneration/X64Assembler.h"
+#include "IntermediateRepresentation/Function.h"
+
+namespace CODE_GENERATION
+{
+    /// Generates x86-64 machine code for the System V ABI from the intermediate representation.
+    ///
+    /// Values live in the registers or spill slots chosen by the register allocator.
+    /// Each instruction reads its operands into scratch registers (or directly from
+    /// their registers where the instruction allows), computes its result in RAX, and
+    /// writes the result to its location.  Values are kept sign-extended to 64 bits
+    /// from their type's width, matching how the IR normalizes constants, so most
+    /// operations can use 64-bit instructions and re-extend the result.  Unsigned
+    /// comparisons work on the sign-extended form too, since sign extension preserves
+    /// unsigned order; only unsigned division and logical right shifts need
+    /// zero-extended operands.
+    ///
+    /// Values that change location between blocks and phi operands are moved on each
+    /// edge as one parallel move, so values that swap locations (as when swapping values
+    /// in a loop) all see values from before the move.  Edges from branches that need
+    /// moves jump to a stub after the function that makes the moves.
+    struct X64CodeGenerator
+    {
+        /// Generates code for all functions in a module.
+        /// @param[in] module - The module.
+        /// @return The code, data, and relocations for an object file.
+        static ObjectFile Generate(const INTERMEDIATE_REPRESENTATION::Module& module)
+        {
+            std::vector<FunctionCode> function_codes;
+            function_codes.reserve(module.Functions.size());
+            for (const INTERMEDIATE_REPRESENTATION::Function& function : module.Functions)
+            {
+                function_codes.push_back(GenerateFunction(function));
+            }
+            return Combine(function_codes);
+        }
+
+        /// Generates code for a single function.  Functions are generated independently,
+        /// so different functions can be generated on different threads at once.
+        /// @param[in] function - The function.
+        /// @return The function's code, starting at offset 0.
+        static FunctionCode GenerateFunction(const INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            FunctionCode function_code = { .Name = function.Name, .IsLocal = function.IsStatic };
+            X64Assembler assembler;
+            std::unordered_map<std::string, std::uint64_t> string_offsets;
+            FunctionGenerator generator(function, assembler, function_code.Object, string_offsets);
+            generator.Generate();
+            function_code.Object.Code = std::move(assembler.Code);
+
+            // RECORD THE STRINGS IN THE ORDER THEY'RE STORED.
+            function_code.StringLiterals.resize(string_offsets.size());
+            std::vector<std::pair<std::uint64_t, std::string>> strings_by_offset;
+            for (auto& [string_literal, string_offset] : string_offsets)
+            {
+                strings_by_offset.emplace_back(string_offset, string_literal);
+            }
+            std::sort(strings_by_offset.begin(), strings_by_offset.end());
+            for (std::size_t string_index = 0; string_index < strings_by_offset.size(); ++string_index)
+            {
+                function_code.StringLiterals[string_index] = std::move(strings_by_offset[string_index].second);
+            }
+            return function_code;
+        }
+
+        /// Combines code generated for separate functions into code for an object file.
+        /// Output only depends on the order of the functions, not how they were generated,
+        /// and matches generating all functions together.
+        /// @param[in] function_codes - The code for each function, in the order to lay them out.
+        /// @return The code, data, and relocations for an object file.
+        static ObjectFile Combine(const std::vector<FunctionCode>& function_codes)
+        {
+            // ALLOCATE SPACE FOR ALL CODE.
+            // Functions start at 16-byte boundaries, padded with breakpoints that are never executed.
+            constexpr std::size_t FUNCTION_ALIGNMENT_IN_BYTES = 16;
+            auto align = [](const std::size_t offset) { return (offset + FUNCTION_ALIGNMENT_IN_BYTES - 1) & ~(FUNCTION_ALIGNMENT_IN_BYTES - 1); };
+            std::size_t code_size_in_bytes = 0;
+            for (const FunctionCode& function_code : function_codes)
+            {
+                code_size_in_bytes = align(code_size_in_bytes) + function_code.Object.Code.size();
+            }
+            ObjectFile object_file;
+            object_file.Code.reserve(code_size_in_bytes);
+
+            std::unordered_map<std::string, std::uint64_t> string_offsets;
+            for (const FunctionCode& function_code : function_codes)
+            {
+                // ADD THE FUNCTION'S CODE.
+                object_file.Code.resize(align(object_file.Code.size()), 0xCC);
+                std::uint64_t function_offset = object_file.Code.size();
+                object_file.Code.insert(object_file.Code.end(), function_code.Object.Code.begin(), function_code.Object.Code.end());
+                object_file.Functions.push_back(DefinedFunction
+                {
+                    .Name = function_code.Name,
+                    .Offset = function_offset,
+                    .Size = function_code.Object.Code.size(),
+                    .IsLocal = function_code.IsLocal,
+                });
+
+                // ADD ANY NEW STRINGS.
+                // Strings already used by earlier functions are shared, as when generating functions together.
+                std::unordered_map<std::uint64_t, std::uint64_t> data_offsets_by_function_data_offset;
+                std::uint64_t function_data_offset = 0;
+                for (const std::string& string_literal : function_code.StringLiterals)
+                {
+                    auto [string_offset, string_added] = string_offsets.try_emplace(string_literal, object_file.ReadOnlyData.size());
+                    if (string_added)
+                    {
+                        object_file.ReadOnlyData.insert(object_file.ReadOnlyData.end(), string_literal.begin(), string_literal.end());
+                        object_file.ReadOnlyData.push_back(0);
+                    }
+                    data_offsets_by_function_data_offset[function_data_offset] = string_offset->second;
+                    function_data_offset += string_literal.size() + 1;
+                }
+
+                // MOVE THE FUNCTION'S RELOCATIONS TO WHERE ITS CODE AND DATA ENDED UP.
+                for (const Relocation& function_relocation : function_code.Object.Relocations)
+                {
+                    Relocation& relocation = object_file.Relocations.emplace_back(function_relocation);
+                    relocation.Offset += function_offset;
+                    if (RelocationKind::READ_ONLY_DATA_ADDRESS == relocation.Kind)
+                    {
+                        relocation.DataOffset = data_offsets_by_function_data_offset[relocation.DataOffset];
+                    }
+                }
+            }
+            return object_file;
+        }
+
+    private:
+        /// The registers for the first integer arguments, in order.
+        static constexpr std::array<Register, 6> ARGUMENT_REGISTERS = { Register::RDI, Register::RSI, Register::RDX, Register::RCX, Register::R8, Register::R9 };
+        /// The register for breaking cycles in parallel moves.  Never allocated to values.
+        static constexpr Register MOVE_CYCLE_REGISTER = Register::R11;
+
+        /// A move that's part of a parallel move.
+        struct PendingMove
+        {
+            /// Where the value is moved to.
+            Location Destination = {};
+            /// Where the value is moved from, or none for values computed when used, like constants.
+            Location Source = {};
+            /// The value moved, for values without a location.
+            INTERMEDIATE_REPRESENTATION::ValueId Value = INTERMEDIATE_REPRESENTATION::INVALID_ID;
+        };
+
+        /// Moves for an edge from a branch, made in a stub after the function.
+        struct EdgeStub
+        {
+            /// The offset of the branch displacement to point at the stub.
+            std::size_t DisplacementOffset = 0;
+            /// The moves to make.
+            std::vector<PendingMove> Moves = {};
+            /// The block to continue to.
+            INTERMEDIATE_REPRESENTATION::BlockId TargetBlockId = INTERMEDIATE_REPRESENTATION::INVALID_ID;
+        };
+
+        /// Generates code for a single function.
+        class FunctionGenerator
+        {
+        public:
+            /// Prepares to generate code for a function.
+            /// @param[in] function - The function.
+            /// @param[in,out] assembler - The assembler to add code to.
+            /// @param[in,out] object_file - The object file to add data and relocations to.
+            /// @param[in,out] string_offsets - Offsets of string literals already in the read-only data.
+            explicit FunctionGenerator(
+                const INTERMEDIATE_REPRESENTATION::Function& function,
+                X64Assembler& assembler,
+                ObjectFile& object_file,
+                std::unordered_map<std::string, std::uint64_t>& string_offsets) :
+                Source(function),
+                Assembler(assembler),
+                Output(object_file),
+                StringOffsets(string_offsets)
+            {}
+
+            /// Generates the function's code.
+            void Generate()
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                Allocation = LinearScanRegisterAllocator::Allocate(Source);
+                LayOutFrame();
+
+                // SET UP THE FRAME.
+                Assembler.Push(Register::RBP);
+                Assembler.Move(Register::RBP, Register::RSP);
+                if (FrameSize > 0)
+                {
+                    Assembler.ArithmeticImmediate(ArithmeticOperation::SUBTRACT, Register::RSP, FrameSize);
+                }
+                for (std::size_t register_index = 0; register_index < Allocation.UsedCalleeSavedRegisters.size(); ++register_index)
+                {
+                    Assembler.Store(Register::RBP, CalleeSavedRegisterOffsets[register_index], Allocation.UsedCalleeSavedRegisters[register_index], 8);
+                }
+
+                // MOVE THE PARAMETERS TO THEIR LOCATIONS.
+                // Callers may leave garbage above the width of narrow arguments, so they're re-extended.
+                // Register arguments are moved together since a parameter's location may be
+                // another's argument register.  Arguments past the sixth are on the stack above
+                // the return address and saved frame pointer.
+                std::vector<PendingMove> parameter_moves;
+                std::vector<ValueId> stack_parameters;
+                for (const ValueId instruction_id : Source.Blocks[Function::ENTRY_BLOCK_ID].Instructions)
+                {
+                    const Instruction& instruction = Source.Values[instruction_id];
+                    if (InstructionKind::PARAMETER != instruction.Kind)
+                    {
+                        continue;
+                    }
+                    Location location = Allocation.GetLocation(instruction_id, 0);
+                    if (LocationKind::NONE == location.Kind)
+                    {
+                        continue;
+                    }
+
+                    std::size_t parameter_index = static_cast<std::size_t>(instruction.Immediate);
+                    if (parameter_index < ARGUMENT_REGISTERS.size())
+                    {
+                        Normalize(ARGUMENT_REGISTERS[parameter_index], instruction.Type);
+                        parameter_moves.push_back(PendingMove
+                        {
+                            .Destination = location,
+                            .Source = Location { .Kind = LocationKind::REGISTER, .RegisterId = ARGUMENT_REGISTERS[parameter_index] },
+                        });
+                    }
+                    else
+                    {
+                        stack_parameters.push_back(instruction_id);
+                    }
+                }
+                EmitParallelMove(std::move(parameter_moves));
+                for (const ValueId parameter : stack_parameters)
+                {
+                    const Instruction& instruction = Source.Values[parameter];
+                    std::size_t parameter_index = static_cast<std::size_t>(instruction.Immediate);
+                    std::int32_t stack_offset = static_cast<std::int32_t>(16 + 8 * (parameter_index - ARGUMENT_REGISTERS.size()));
+                    Assembler.LoadSignExtended(Register::RAX, Register::RBP, stack_offset, GetValueTypeSizeInBytes(instruction.Type));
+                    WriteLocation(Allocation.GetLocation(parameter, 0), Register::RAX);
+                }
+
+                // GENERATE EACH BLOCK.
+                // Jumps are patched once every block's location is known.
+                BlockOffsets.assign(Source.Blocks.size(), 0);
+                for (BlockId block_id = 0; block_id < Source.Blocks.size(); ++block_id)
+                {
+                    BlockOffsets[block_id] = Assembler.Code.size();
+                    GenerateBlock(block_id);
+                }
+
+                // GENERATE STUBS FOR BRANCH EDGES WITH MOVES.
+                for (EdgeStub& edge_stub : EdgeStubs)
+                {
+                    Assembler.PatchDisplacement(edge_stub.DisplacementOffset, Assembler.Code.size());
+                    EmitParallelMove(std::move(edge_stub.Moves));
+                    JumpFixups.emplace_back(Assembler.Jump(), edge_stub.TargetBlockId);
+                }
+                for (const auto& [displacement_offset, target_block_id] : JumpFixups)
+                {
+                    Assembler.PatchDisplacement(displacement_offset, BlockOffsets[target_block_id]);
+                }
+            }
+
+        private:
+            /// Assigns stack frame locations to spill slots, saved registers, and stack slots.
+            void LayOutFrame()
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                // PLACE SPILL SLOTS AND SAVED REGISTERS.
+                std::int32_t frame_size = static_cast<std::int32_t>(8 * Allocation.SpillSlotCount);
+                for (std::size_t register_index = 0; register_index < Allocation.UsedCalleeSavedRegisters.size(); ++register_index)
+                {
+                    frame_size += 8;
+                    CalleeSavedRegisterOffsets.push_back(-frame_size);
+                }
+
+                // ASSIGN MEMORY TO STACK SLOTS.
+                // Larger slots are 16-byte aligned, as arrays would be by other compilers.
+                StackSlotOffsets.assign(Source.Values.size(), 0);
+                for (const ValueId instruction_id : Source.Blocks[Function::ENTRY_BLOCK_ID].Instructions)
+                {
+                    const Instruction& instruction = Source.Values[instruction_id];
+                    if (InstructionKind::STACK_SLOT != instruction.Kind)
+                    {
+                        continue;
+                    }
+                    std::int32_t alignment = (instruction.Immediate >= 16) ? 16 : 8;
+                    frame_size += static_cast<std::int32_t>(instruction.Immediate);
+                    frame_size = (frame_size + alignment - 1) / alignment * alignment;
+                    StackSlotOffsets[instruction_id] = -frame_size;
+                }
+
+                // The return address and saved frame pointer leave the stack 16-byte aligned,
+                // as calls require, so the frame keeps that alignment.
+                FrameSize = (frame_size + 15) / 16 * 16;
+            }
+
+            /// Generates code for a block.
+            /// @param[in] block_id - The block.
+            void GenerateBlock(const INTERMEDIATE_REPRESENTATION::BlockId block_id)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                for (const ValueId instruction_id : Source.Blocks[block_id].Instructions)
+                {
+                    // MOVE VALUES WHOSE INTERVALS WERE SPLIT HERE.
+                    CurrentPosition = 2 * Allocation.Liveness.InstructionNumbers[instruction_id];
+                    std::vector<PendingMove> split_moves;
+                    for (; NextSplitMoveIndex < Allocation.SplitMoves.size() && Allocation.SplitMoves[NextSplitMoveIndex].Position <= CurrentPosition; ++NextSplitMoveIndex)
+                    {
+                        const SplitMove& split_move = Allocation.SplitMoves[NextSplitMoveIndex];
+                        split_moves.push_back(PendingMove { .Destination = split_move.Destination, .Source = split_move.Source });
+                    }
+                    EmitParallelMove(std::move(split_moves));
+
+                    const Instruction& instruction = Source.Values[instruction_id];
+                    ValueType type = instruction.Type;
+                    switch (instruction.Kind)
+                    {
+                        case InstructionKind::PARAMETER:
+                        case InstructionKind::STACK_SLOT:
+                            // These are handled when setting up the frame.
+                            break;
+                        case InstructionKind::PHI:
+                            // Phis are written by moves on incoming edges.
+                            break;
+                        case InstructionKind::STRING_ADDRESS:
+                        {
+                            std::size_t displacement_offset = Assembler.LoadRipRelativeAddress(Register::RAX);
+                            Output.Relocations.push_back(Relocation
+                            {
+                                .Kind = RelocationKind::READ_ONLY_DATA_ADDRESS,
+                                .Offset = displacement_offset,
+                                .DataOffset = GetStringOffset(Source.StringLiterals[static_cast<std::size_t>(instruction.Immediate)]),
+                            });
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::ADD:
+                        case InstructionKind::SUBTRACT:
+                        case InstructionKind::AND:
+                        case InstructionKind::OR:
+                        case InstructionKind::XOR:
+                        {
+                            LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            Register right_operand = GetOperandRegister(Source.GetOperand(instruction_id, 1), Register::RCX);
+                            Assembler.Arithmetic(GetArithmeticOperation(instruction.Kind), Register::RAX, right_operand);
+                            Normalize(Register::RAX, type);
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::MULTIPLY:
+                        {
+                            LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            Register right_operand = GetOperandRegister(Source.GetOperand(instruction_id, 1), Register::RCX);
+                            Assembler.Multiply(Register::RAX, right_operand);
+                            Normalize(Register::RAX, type);
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::SIGNED_DIVIDE:
+                        case InstructionKind::SIGNED_REMAINDER:
+                        {
+                            LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            Register divisor = GetOperandRegister(Source.GetOperand(instruction_id, 1), Register::RCX);
+                            Assembler.SignExtendAccumulator();
+                            Assembler.Unary(UnaryOperation::SIGNED_DIVIDE, divisor);
+                            Register result = (InstructionKind::SIGNED_DIVIDE == instruction.Kind) ? Register::RAX : Register::RDX;
+                            Normalize(result, type);
+                            StoreValue(instruction_id, result);
+                            break;
+                        }
+                        case InstructionKind::UNSIGNED_DIVIDE:
+                        case InstructionKind::UNSIGNED_REMAINDER:
+                        {
+                            LoadOperands(instruction_id);
+                            ZeroExtendFromType(Register::RAX, type);
+                            ZeroExtendFromType(Register::RCX, type);
+                            Assembler.MoveImmediate(Register::RDX, 0);
+                            Assembler.Unary(UnaryOperation::UNSIGNED_DIVIDE, Register::RCX);
+                            Register result = (InstructionKind::UNSIGNED_DIVIDE == instruction.Kind) ? Register::RAX : Register::RDX;
+                            Normalize(result, type);
+                            StoreValue(instruction_id, result);
+                            break;
+                        }
+                        case InstructionKind::SHIFT_LEFT:
+                        case InstructionKind::ARITHMETIC_SHIFT_RIGHT:
+                        case InstructionKind::LOGICAL_SHIFT_RIGHT:
+                        {
+                            LoadOperands(instruction_id);
+                            ShiftOperation operation = ShiftOperation::SHIFT_LEFT;
+                            if (InstructionKind::ARITHMETIC_SHIFT_RIGHT == instruction.Kind)
+                            {
+                                operation = ShiftOperation::ARITHMETIC_SHIFT_RIGHT;
+                            }
+                            else if (InstructionKind::LOGICAL_SHIFT_RIGHT == instruction.Kind)
+                            {
+                                // Zeros must shift in from the type's width, not from bit 63.
+                                operation = ShiftOperation::LOGICAL_SHIFT_RIGHT;
+                                ZeroExtendFromType(Register::RAX, type);
+                            }
+                            Assembler.Shift(operation, Register::RAX);
+                            Normalize(Register::RAX, type);
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::NEGATE:
+                        case InstructionKind::NOT:
+                        {
+                            LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            Assembler.Unary((InstructionKind::NEGATE == instruction.Kind) ? UnaryOperation::NEGATE : UnaryOperation::NOT, Register::RAX);
+                            Normalize(Register::RAX, type);
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::EQUAL:
+                        case InstructionKind::NOT_EQUAL:
+                        case InstructionKind::SIGNED_LESS:
+                        case InstructionKind::SIGNED_LESS_EQUAL:
+                        case InstructionKind::SIGNED_GREATER:
+                        case InstructionKind::SIGNED_GREATER_EQUAL:
+                        case InstructionKind::UNSIGNED_LESS:
+                        case InstructionKind::UNSIGNED_LESS_EQUAL:
+                        case InstructionKind::UNSIGNED_GREATER:
+                        case InstructionKind::UNSIGNED_GREATER_EQUAL:
+                        {
+                            LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            Register right_operand = GetOperandRegister(Source.GetOperand(instruction_id, 1), Register::RCX);
+                            Assembler.Arithmetic(ArithmeticOperation::COMPARE, Register::RAX, right_operand);
+                            Assembler.SetIf(GetConditionCode(instruction.Kind), Register::RAX);
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::SIGN_EXTEND:
+                            // Values are already sign-extended to 64 bits.
+                            LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        case InstructionKind::ZERO_EXTEND:
+                        {
+                            ValueId operand = Source.GetOperand(instruction_id, 0);
+                            LoadValue(Register::RAX, operand);
+                            ZeroExtendFromType(Register::RAX, Source.Values[operand].Type);
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::TRUNCATE:
+                            LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            Normalize(Register::RAX, type);
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        case InstructionKind::LOAD:
+                        {
+                            Register address = GetOperandRegister(Source.GetOperand(instruction_id, 0), Register::RCX);
+                            Assembler.LoadSignExtended(Register::RAX, address, 0, GetValueTypeSizeInBytes(type));
+                            StoreValue(instruction_id, Register::RAX);
+                            break;
+                        }
+                        case InstructionKind::STORE:
+                        {
+                            ValueId stored_value = Source.GetOperand(instruction_id, 1);
+                            Register address = GetOperandRegister(Source.GetOperand(instruction_id, 0), Register::RCX);
+                            Register stored_register = GetOperandRegister(stored_value, Register::RAX);
+                            Assembler.Store(address, 0, stored_register, GetValueTypeSizeInBytes(Source.Values[stored_value].Type));
+                            break;
+                        }
+                        case InstructionKind::CALL:
+                            GenerateCall(instruction_id);
+                            break;
+                        case InstructionKind::JUMP:
+                        {
+                            BlockId successor = Source.Blocks[block_id].Successors.front();
+                            EmitParallelMove(GetEdgeMoves(block_id, successor));
+                            JumpUnlessNext(block_id, successor);
+                            break;
+                        }
+                        case InstructionKind::BRANCH:
+                        {
+                            BlockId true_successor = Source.Blocks[block_id].Successors[0];
+                            BlockId false_successor = Source.Blocks[block_id].Successors[1];
+                            std::vector<PendingMove> true_moves = GetEdgeMoves(block_id, true_successor);
+                            std::vector<PendingMove> false_moves = GetEdgeMoves(block_id, false_successor);
+                            Register condition = GetOperandRegister(Source.GetOperand(instruction_id, 0), Register::RAX);
+                            Assembler.Test(condition, condition);
+                            if (true_moves.empty() && false_moves.empty() && block_id + 1 == true_successor)
+                            {
+                                JumpFixups.emplace_back(Assembler.JumpIf(ConditionCode::EQUAL), false_successor);
+                                break;
+                            }
+
+                            // The false edge's moves follow the branch, and the true edge's are in a stub.
+                            if (true_moves.empty())
+                            {
+                                JumpFixups.emplace_back(Assembler.JumpIf(ConditionCode::NOT_EQUAL), true_successor);
+                            }
+                            else
+                            {
+                                EdgeStubs.push_back(EdgeStub
+                                {
+                                    .DisplacementOffset = Assembler.JumpIf(ConditionCode::NOT_EQUAL),
+                                    .Moves = std::move(true_moves),
+                                    .TargetBlockId = true_successor,
+                                });
+                            }
+                            EmitParallelMove(std::move(false_moves));
+                            JumpUnlessNext(block_id, false_successor);
+                            break;
+                        }
+                        case InstructionKind::RETURN:
+                            if (instruction.OperandCount > 0)
+                            {
+                                LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                            }
+                            for (std::size_t register_index = 0; register_index < Allocation.UsedCalleeSavedRegisters.size(); ++register_index)
+                            {
+                                Assembler.LoadSignExtended(Allocation.UsedCalleeSavedRegisters[register_index], Register::RBP, CalleeSavedRegisterOffsets[register_index], 8);
+                            }
+                            Assembler.Leave();
+                            Assembler.Return();
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+
+            /// Generates code for a call.
+            /// @param[in] call - The call instruction.
+            void GenerateCall(const INTERMEDIATE_REPRESENTATION::ValueId call)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                // PUSH ARGUMENTS PAST THE SIXTH IN REVERSE ORDER.
+                // Padding keeps the stack 16-byte aligned at the call.
+                std::span<const ValueId> arguments = Source.GetOperands(call);
+                std::size_t stack_argument_count = (arguments.size() > ARGUMENT_REGISTERS.size()) ? arguments.size() - ARGUMENT_REGISTERS.size() : 0;
+                std::int32_t stack_padding = (stack_argument_count % 2 != 0) ? 8 : 0;
+                if (stack_padding > 0)
+                {
+                    Assembler.ArithmeticImmediate(ArithmeticOperation::SUBTRACT, Register::RSP, stack_padding);
+                }
+                for (std::size_t argument_index = arguments.size(); argument_index > ARGUMENT_REGISTERS.size(); --argument_index)
+                {
+                    LoadValue(Register::RAX, arguments[argument_index - 1]);
+                    Assembler.Push(Register::RAX);
+                }
+
+                // MOVE THE REGISTER ARGUMENTS INTO PLACE.
+                // Arguments may already be in each other's argument registers, so they're moved together.
+                std::vector<PendingMove> argument_moves;
+                for (std::size_t argument_index = 0; argument_index < arguments.size() && argument_index < ARGUMENT_REGISTERS.size(); ++argument_index)
+                {
+                    argument_moves.push_back(PendingMove
+                    {
+                        .Destination = Location { .Kind = LocationKind::REGISTER, .RegisterId = ARGUMENT_REGISTERS[argument_index] },
+                        .Source = GetSourceLocation(arguments[argument_index], CurrentPosition),
+                        .Value = arguments[argument_index],
+                    });
+                }
+                EmitParallelMove(std::move(argument_moves));
+
+                // CALL THE FUNCTION.
+                // Variadic functions take the number of vector registers used in AL, which is always 0 here.
+                const Instruction& instruction = Source.Values[call];
+                if (instruction.Flags & INSTRUCTION_CALLS_VARIADIC_FUNCTION)
+                {
+                    Assembler.MoveImmediate(Register::RAX, 0);
+                }
+                std::size_t displacement_offset = Assembler.Call();
+                Output.Relocations.push_back(Relocation
+                {
+                    .Kind = RelocationKind::FUNCTION_CALL,
+                    .Offset = displacement_offset,
+                    .FunctionName = Source.CalleeNames[static_cast<std::size_t>(instruction.Immediate)],
+                });
+                std::int32_t stack_argument_size = static_cast<std::int32_t>(8 * stack_argument_count) + stack_padding;
+                if (stack_argument_size > 0)
+                {
+                    Assembler.ArithmeticImmediate(ArithmeticOperation::ADD, Register::RSP, stack_argument_size);
+                }
+
+                // STORE THE RESULT.
+                // Bits above the width of narrow results are unspecified.
+                if (ValueType::VOID != instruction.Type)
+                {
+                    Normalize(Register::RAX, instruction.Type);
+                    StoreValue(call, Register::RAX);
+                }
+            }
+
+            /// Gets the moves needed on an edge: values whose location differs between the
+            /// end of one block and the start of the next, and the operands of the next block's phis.
+            /// @param[in] block_id - The block being left.
+            /// @param[in] successor - The block being entered.
+            /// @return The moves to make together on the edge.
+            std::vector<PendingMove> GetEdgeMoves(const INTERMEDIATE_REPRESENTATION::BlockId block_id, const INTERMEDIATE_REPRESENTATION::BlockId successor) const
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                std::vector<PendingMove> moves;
+                std::uint32_t exit_position = Allocation.Liveness.BlockEnds[block_id] - 1;
+                std::uint32_t entry_position = Allocation.Liveness.BlockStarts[successor];
+                for (const ValueId value : Allocation.Liveness.LiveInValues[successor])
+                {
+                    moves.push_back(PendingMove
+                    {
+                        .Destination = Allocation.GetLocation(value, entry_position),
+                        .Source = Allocation.GetLocation(value, exit_position),
+                    });
+                }
+
+                // A block listed twice as a predecessor has the same phi operands for both edges.
+                const BasicBlock& successor_block = Source.Blocks[successor];
+                std::size_t predecessor_index = static_cast<std::size_t>(
+                    std::find(successor_block.Predecessors.begin(), successor_block.Predecessors.end(), block_id) - successor_block.Predecessors.begin());
+                for (const ValueId phi : successor_block.Instructions)
+                {
+                    if (InstructionKind::PHI != Source.Values[phi].Kind)
+                    {
+                        break;
+                    }
+                    ValueId operand = Source.GetOperand(phi, predecessor_index);
+                    moves.push_back(PendingMove
+                    {
+                        .Destination = Allocation.GetLocation(phi, entry_position),
+                        .Source = GetSourceLocation(operand, exit_position),
+                        .Value = operand,
+                    });
+                }
+
+                // Phis that are never read have nowhere to move to.
+                moves.erase(
+                    std::remove_if(moves.begin(), moves.end(), [](const PendingMove& move) { return LocationKind::NONE == move.Destination.Kind || move.Source == move.Destination; }),
+                    moves.end());
+                return moves;
+            }
+
+            /// Makes moves as if they all happened at once, so that no move overwrites
+            /// a location before the moves reading it.
+            /// @param[in] moves - The moves.  Each destination must be written by only one move.
+            void EmitParallelMove(std::vector<PendingMove> moves)
+            {
+                auto is_read = [&](const Location& location)
+                {
+                    return std::any_of(moves.begin(), moves.end(), [&](const PendingMove& move) { return move.Source == location; });
+                };
+                while (!moves.empty())
+                {
+                    // MAKE A MOVE WHOSE DESTINATION ISN'T READ BY ANOTHER.
+                    auto ready_move = std::find_if(moves.begin(), moves.end(), [&](const PendingMove& move) { return !is_read(move.Destination); });
+                    if (ready_move != moves.end())
+                    {
+                        EmitMove(*ready_move);
+                        moves.erase(ready_move);
+                        continue;
+                    }
+
+                    // BREAK A CYCLE.
+                    // Every remaining destination is read by another move, so some moves form a cycle.
+                    // Copying one of their sources to a free register lets its location be overwritten.
+                    auto cycle_move = std::find_if(moves.begin(), moves.end(), [](const PendingMove& move) { return LocationKind::NONE != move.Source.Kind; });
+                    Location cycle_source = cycle_move->Source;
+                    Location cycle_location = { .Kind = LocationKind::REGISTER, .RegisterId = MOVE_CYCLE_REGISTER };
+                    EmitMove(PendingMove { .Destination = cycle_location, .Source = cycle_source });
+                    for (PendingMove& move : moves)
+                    {
+                        if (move.Source == cycle_source)
+                        {
+                            move.Source = cycle_location;
+                        }
+                    }
+                }
+            }
+
+            /// Makes a single move.
+            /// @param[in] move - The move.
+            void EmitMove(const PendingMove& move)
+            {
+                // Spill slots can't be copied to each other directly, so values go through RAX.
+                Register destination = (LocationKind::REGISTER == move.Destination.Kind) ? move.Destination.RegisterId : Register::RAX;
+                switch (move.Source.Kind)
+                {
+                    case LocationKind::REGISTER:
+                        if (LocationKind::REGISTER == move.Destination.Kind)
+                        {
+                            Assembler.Move(destination, move.Source.RegisterId);
+                        }
+                        else
+                        {
+                            destination = move.Source.RegisterId;
+                        }
+                        break;
+                    case LocationKind::SPILL_SLOT:
+                        Assembler.LoadSignExtended(destination, Register::RBP, GetSpillSlotOffset(move.Source.SpillSlotIndex), 8);
+                        break;
+                    default:
+                        LoadValue(destination, move.Value);
+                        break;
+                }
+                if (LocationKind::SPILL_SLOT == move.Destination.Kind)
+                {
+                    Assembler.Store(Register::RBP, GetSpillSlotOffset(move.Destination.SpillSlotIndex), destination, 8);
+                }
+            }
+
+            /// Jumps to a block unless it immediately follows another.
+            /// @param[in] block_id - The block being left.
+            /// @param[in] target_block_id - The block to continue to.
+            void JumpUnlessNext(const INTERMEDIATE_REPRESENTATION::BlockId block_id, const INTERMEDIATE_REPRESENTATION::BlockId target_block_id)
+            {
+                if (block_id + 1 != target_block_id)
+                {
+                    JumpFixups.emplace_back(Assembler.Jump(), target_block_id);
+                }
+            }
+
+            /// Loads both operands of a binary operation into RAX and RCX.
+            /// @param[in] instruction_id - The instruction.
+            void LoadOperands(const INTERMEDIATE_REPRESENTATION::ValueId instruction_id)
+            {
+                LoadValue(Register::RAX, Source.GetOperand(instruction_id, 0));
+                LoadValue(Register::RCX, Source.GetOperand(instruction_id, 1));
+            }
+
+            /// Gets a register holding an operand of the current instruction, loading it if needed.
+            /// The register must not be modified, since it may be the operand's own.
+            /// @param[in] value - The operand.
+            /// @param[in] scratch - The register to load the operand into if it's not in one.
+            /// @return The register holding the operand.
+            Register GetOperandRegister(const INTERMEDIATE_REPRESENTATION::ValueId value, const Register scratch)
+            {
+                Location location = GetSourceLocation(value, CurrentPosition);
+                if (LocationKind::REGISTER == location.Kind)
+                {
+                    return location.RegisterId;
+                }
+                LoadValue(scratch, value);
+                return scratch;
+            }
+
+            /// Loads an operand of the current instruction into a register.
+            /// @param[in] destination - The register.
+            /// @param[in] value - The operand.
+            void LoadValue(const Register destination, const INTERMEDIATE_REPRESENTATION::ValueId value)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                Location location = GetSourceLocation(value, CurrentPosition);
+                switch (location.Kind)
+                {
+                    case LocationKind::REGISTER:
+                        if (destination != location.RegisterId)
+                        {
+                            Assembler.Move(destination, location.RegisterId);
+                        }
+                        return;
+                    case LocationKind::SPILL_SLOT:
+                        Assembler.LoadSignExtended(destination, Register::RBP, GetSpillSlotOffset(location.SpillSlotIndex), 8);
+                        return;
+                    default:
+                        break;
+                }
+
+                // COMPUTE VALUES WITHOUT A LOCATION.
+                const Instruction& instruction = Source.Values[value];
+                switch (instruction.Kind)
+                {
+                    case InstructionKind::CONSTANT:
+                        Assembler.MoveImmediate(destination, instruction.Immediate);
+                        break;
+                    case InstructionKind::STACK_SLOT:
+                        Assembler.LoadEffectiveAddress(destination, Register::RBP, StackSlotOffsets[value]);
+                        break;
+                    default:
+                        // Undefined values may be anything.
+                        Assembler.MoveImmediate(destination, 0);
+                        break;
+                }
+            }
+
+            /// Gets where a value is at a position.
+            /// @param[in] value - The value.
+            /// @param[in] position - The position.
+            /// @return The location, or none for values computed when used.
+            Location GetSourceLocation(const INTERMEDIATE_REPRESENTATION::ValueId value, const std::uint32_t position) const
+            {
+                if (!LiveIntervals::HasInterval(Source, value))
+                {
+                    return Location {};
+                }
+                return Allocation.GetLocation(value, position);
+            }
+
+            /// Stores a register to the location of the value the current instruction writes.
+            /// @param[in] value - The value.
+            /// @param[in] source - The register.
+            void StoreValue(const INTERMEDIATE_REPRESENTATION::ValueId value, const Register source)
+            {
+                WriteLocation(Allocation.GetLocation(value, CurrentPosition + 1), source);
+            }
+
+            /// Writes a register to a location.
+            /// @param[in] location - The location.  Nothing is written for values that are never read.
+            /// @param[in] source - The register.
+            void WriteLocation(const Location& location, const Register source)
+            {
+                switch (location.Kind)
+                {
+                    case LocationKind::REGISTER:
+                        if (source != location.RegisterId)
+                        {
+                            Assembler.Move(location.RegisterId, source);
+                        }
+                        break;
+                    case LocationKind::SPILL_SLOT:
+                        Assembler.Store(Register::RBP, GetSpillSlotOffset(location.SpillSlotIndex), source, 8);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            /// Sign-extends a register from the width of a type.
+            /// @param[in] register_id - The register.
+            /// @param[in] type - The type.
+            void Normalize(const Register register_id, const INTERMEDIATE_REPRESENTATION::ValueType type)
+            {
+                std::size_t size_in_bytes = INTERMEDIATE_REPRESENTATION::GetValueTypeSizeInBytes(type);
+                if (size_in_bytes < 8)
+                {
+                    Assembler.SignExtend(register_id, register_id, size_in_bytes);
+                }
+            }
+
+            /// Zero-extends a register from the width of a type.
+            /// @param[in] register_id - The register.
+            /// @param[in] type - The type.
+            void ZeroExtendFromType(const Register register_id, const INTERMEDIATE_REPRESENTATION::ValueType type)
+            {
+                std::size_t size_in_bytes = INTERMEDIATE_REPRESENTATION::GetValueTypeSizeInBytes(type);
+                if (size_in_bytes < 8)
+                {
+                    Assembler.ZeroExtend(register_id, register_id, size_in_bytes);
+                }
+            }
+
+            /// Gets the offset of a string literal in the read-only data, adding it if needed.
+            /// @param[in] string_literal - The contents of the literal, without a terminator.
+            /// @return The offset of the null-terminated string.
+            std::uint64_t GetStringOffset(const std::string& string_literal)
+            {
+                auto [string_offset, string_added] = StringOffsets.try_emplace(string_literal, Output.ReadOnlyData.size());
+                if (string_added)
+                {
+                    Output.ReadOnlyData.insert(Output.ReadOnlyData.end(), string_literal.begin(), string_literal.end());
+                    Output.ReadOnlyData.push_back(0);
+                }
+                return string_offset->second;
+            }
+
+            /// Gets the offset of a spill slot from the frame pointer.
+            /// @param[in] spill_slot_index - The index of the slot.
+            /// @return The offset.
+            static std::int32_t GetSpillSlotOffset(const std::uint32_t spill_slot_index)
+            {
+                return -8 * static_cast<std::int32_t>(spill_slot_index + 1);
+            }
+
+            /// Gets the register-to-register operation for an instruction.
+            /// @param[in] kind - The kind of instruction.
+            /// @return The operation.
+            static ArithmeticOperation GetArithmeticOperation(const INTERMEDIATE_REPRESENTATION::InstructionKind kind)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                switch (kind)
+                {
+                    case InstructionKind::SUBTRACT:
+                        return ArithmeticOperation::SUBTRACT;
+                    case InstructionKind::AND:
+                        return ArithmeticOperation::AND;
+                    case InstructionKind::OR:
+                        return ArithmeticOperation::OR;
+                    case InstructionKind::XOR:
+                        return ArithmeticOperation::XOR;
+                    default:
+                        return ArithmeticOperation::ADD;
+                }
+            }
+
+            /// Gets the condition for a comparison.
+            /// @param[in] kind - The kind of comparison.
+            /// @return The condition under which the comparison is true.
+            static ConditionCode GetConditionCode(const INTERMEDIATE_REPRESENTATION::InstructionKind kind)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                switch (kind)
+                {
+                    case InstructionKind::NOT_EQUAL:
+                        return ConditionCode::NOT_EQUAL;
+                    case InstructionKind::SIGNED_LESS:
+                        return ConditionCode::LESS;
+                    case InstructionKind::SIGNED_LESS_EQUAL:
+                        return ConditionCode::LESS_OR_EQUAL;
+                    case InstructionKind::SIGNED_GREATER:
+                        return ConditionCode::GREATER;
+                    case InstructionKind::SIGNED_GREATER_EQUAL:
+                        return ConditionCode::GREATER_OR_EQUAL;
+                    case InstructionKind::UNSIGNED_LESS:
+                        return ConditionCode::BELOW;
+                    case InstructionKind::UNSIGNED_LESS_EQUAL:
+                        return ConditionCode::BELOW_OR_EQUAL;
+                    case InstructionKind::UNSIGNED_GREATER:
+                        return ConditionCode::ABOVE;
+                    case InstructionKind::UNSIGNED_GREATER_EQUAL:
+                        return ConditionCode::ABOVE_OR_EQUAL;
+                    default:
+                        return ConditionCode::EQUAL;
+                }
+            }
+
+            /// The function to generate code for.
+            const INTERMEDIATE_REPRESENTATION::Function& Source;
+            /// The assembler to add code to.
+            X64Assembler& Assembler;
+            /// The object file to add data and relocations to.
+            ObjectFile& Output;
+            /// Offsets of string literals already in the read-only data.
+            std::unordered_map<std::string, std::uint64_t>& StringOffsets;
+            /// Where each value is kept.
+            RegisterAllocation Allocation = {};
+            /// The position where the current instruction reads its operands.
+            std::uint32_t CurrentPosition = 0;
+            /// The index of the next split move to make.
+            std::size_t NextSplitMoveIndex = 0;
+            /// The offset of each stack slot's memory from the frame pointer.
+            std::vector<std::int32_t> StackSlotOffsets = {};
+            /// The offsets from the frame pointer where used callee-saved registers are saved.
+            std::vector<std::int32_t> CalleeSavedRegisterOffsets = {};
+            /// The size of the frame below the saved frame pointer.
+            std::int32_t FrameSize = 0;
+            /// The offset of each block's code.
+            std::vector<std::size_t> BlockOffsets = {};
+            /// Jump displacements to patch, with the blocks they target.
+            std::vector<std::pair<std::size_t, INTERMEDIATE_REPRESENTATION::BlockId>> JumpFixups = {};
+            /// Moves for branch edges, generated after the function's blocks.
+            std::vector<EdgeStub> EdgeStubs = {};
+        };
+    };
+}
@@ -0,0 +1,471 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Compilation/ThreadPool.h"
+#include "Metaprogramming/ProgramQuery.h"
+#include "Optimization/InliningCostModel.h"
+
+namespace COMPILATION
+{
+    /// Options for a run of the compiler parsed from the command line.
+    struct CommandLineArguments
+    {
+        /// Prints usage information for the compiler.
+        static void PrintUsage()
+        {
+            std::printf(
+                "Usage: Compiler [options] <file or directory>...\n"
+                "Directories are searched recursively for source files (.c, .cish).\n"
+                "If no inputs are specified, built-in sample source code is compiled.\n"
+                "Options:\n"
+                "    -j, --jobs <count>    Number of translation units to compile in parallel.\n"
+                "    -I <directory>        Search this directory for included files.  May be repeated.\n"
+                "    -D <name>[=<value>]   Define a macro (as 1 if no value is given).  May be repeated.\n"
+                "    --prefix-header <file>\n"
+                "                          Precompile this header once for all files that start by including it.\n"
+                "    --cache-directory <directory>\n"
+                "                          Reuse tokens and parsed programs for unchanged files from this directory.\n"
+                "    --emit-front-end <directory>\n"
+                "                          Write tokens and parsed programs in binary form (.cfe files) to this directory.\n"
+                "    --emit-ir <directory>\n"
+                "                          Write the SSA intermediate representation (.ir files) to this directory.\n"
+                "    --emit-c <directory>  Write the parsed program as formatted C source code (.c files) to this directory.\n"
+                "    --preserve-layout     Keep original comments and blank lines in C source code written by --emit-c.\n"
+                "    --emit-object <directory>\n"
+                "                          Write x86-64 ELF object files (.o files) to this directory.\n"
+                "    --evaluate <function> Evaluate this function (which must take no parameters) at compile time\n"
+                "                          with the bytecode interpreter.  Results of pure functions are reused\n"
+                "                          across translation units and, with a cache directory, across runs.\n"
+                "    --jit <function>      Load each translation unit's code into memory and call this function\n"
+                "                          (which must take no parameters) without writing object files.\n"
+                "    --query <kind>:<name> Report what a program index finds in each translation unit, where kind\n"
+                "                          is returning, parameter, calls, references, or declarations (such as\n"
+                "                          calls:printf or declarations:int*).  May be repeated.\n"
+                "    -O, --optimize        Optimize the intermediate representation.\n"
+                "    --inline-threshold <cost>\n"
+                "                          Inline calls estimated to add at most this many instructions (default 25).\n"
+                "    --verify-serialization\n"
+                "                          Check that front-end output round-trips through the binary format.\n"
+                "    --serve <socket>      Run as a persistent compile server listening on this Unix domain socket.\n"
+                "    --connect <socket>    Send this compile request to the server listening on this socket.\n"
+                "    --stop-server         With --connect, stop the server instead of compiling.\n"
+                "    --language-server     Run as a language server for editors, speaking the Language Server\n"
+                "                          Protocol over standard input and output.\n"
+                "    -h, --help            Print this message.\n");
+        }
+
+        /// Parses command line arguments.
+        /// @param[in] argument_count - The number of arguments (including the program name).
+        /// @param[in] arguments - The arguments (including the program name).
+        /// @return The parsed arguments, if valid; null otherwise.
+        static std::optional<CommandLineArguments> Parse(const int argument_count, const char* arguments[])
+        {
+            CommandLineArguments parsed_arguments;
+
+            // PARSE EACH ARGUMENT.
+            // The first argument is the name of the program, so it is skipped.
+            for (int argument_index = 1; argument_index < argument_count; ++argument_index)
+            {
+                std::string_view argument = arguments[argument_index];
+
+                bool is_help = ("-h" == argument || "--help" == argument);
+                if (is_help)
+                {
+                    parsed_arguments.HelpRequested = true;
+                    continue;
+                }
+
+                bool is_job_count = ("-j" == argument || "--jobs" == argument);
+                if (is_job_count)
+                {
+                    // READ THE JOB COUNT FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool job_count_exists = (argument_index < argument_count);
+                    if (!job_count_exists)
+                    {
+                        std::fprintf(stderr, "Missing count for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    char* job_count_end = nullptr;
+                    long job_count = std::strtol(arguments[argument_index], &job_count_end, 10);
+                    bool job_count_valid = (job_count_end != arguments[argument_index] && '\0' == *job_count_end && job_count > 0);
+                    if (!job_count_valid)
+                    {
+                        std::fprintf(stderr, "Invalid job count: %s\n", arguments[argument_index]);
+                        return std::nullopt;
+                    }
+                    parsed_arguments.JobCount = static_cast<std::size_t>(job_count);
+                    continue;
+                }
+
+                bool is_include_directory = argument.starts_with("-I");
+                if (is_include_directory)
+                {
+                    // READ THE DIRECTORY.
+                    // It may be attached to the option or in the next argument.
+                    std::string_view include_directory = argument.substr(2);
+                    if (include_directory.empty())
+                    {
+                        ++argument_index;
+                        bool directory_exists = (argument_index < argument_count);
+                        if (!directory_exists)
+                        {
+                            std::fprintf(stderr, "Missing directory for %s.\n", arguments[argument_index - 1]);
+                            return std::nullopt;
+                        }
+                        include_directory = arguments[argument_index];
+                    }
+
+                    parsed_arguments.IncludeDirectories.emplace_back(include_directory);
+                    continue;
+                }
+
+                bool is_macro_definition = argument.starts_with("-D");
+                if (is_macro_definition)
+                {
+                    // READ THE DEFINITION.
+                    // It may be attached to the option or in the next argument.
+                    std::string_view macro_definition = argument.substr(2);
+                    if (macro_definition.empty())
+                    {
+                        ++argument_index;
+                        bool definition_exists = (argument_index < argument_count);
+                        if (!definition_exists)
+                        {
+                            std::fprintf(stderr, "Missing macro for %s.\n", arguments[argument_index - 1]);
+                            return std::nullopt;
+                        }
+                        macro_definition = arguments[argument_index];
+                    }
+
+                    parsed_arguments.MacroDefinitions.emplace_back(macro_definition);
+                    continue;
+                }
+
+                bool is_prefix_header = ("--prefix-header" == argument);
+                if (is_prefix_header)
+                {
+                    // READ THE HEADER FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool header_exists = (argument_index < argument_count);
+                    if (!header_exists)
+                    {
+                        std::fprintf(stderr, "Missing file for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.PrefixHeaderFilepath = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_cache_directory = ("--cache-directory" == argument);
+                if (is_cache_directory)
+                {
+                    // READ THE DIRECTORY FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool directory_exists = (argument_index < argument_count);
+                    if (!directory_exists)
+                    {
+                        std::fprintf(stderr, "Missing directory for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.CacheDirectory = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_emit_front_end = ("--emit-front-end" == argument);
+                if (is_emit_front_end)
+                {
+                    // READ THE DIRECTORY FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool directory_exists = (argument_index < argument_count);
+                    if (!directory_exists)
+                    {
+                        std::fprintf(stderr, "Missing directory for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.FrontEndOutputDirectory = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_emit_ir = ("--emit-ir" == argument);
+                if (is_emit_ir)
+                {
+                    // READ THE DIRECTORY FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool directory_exists = (argument_index < argument_count);
+                    if (!directory_exists)
+                    {
+                        std::fprintf(stderr, "Missing directory for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.IrOutputDirectory = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_emit_c = ("--emit-c" == argument);
+                if (is_emit_c)
+                {
+                    // READ THE DIRECTORY FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool directory_exists = (argument_index < argument_count);
+                    if (!directory_exists)
+                    {
+                        std::fprintf(stderr, "Missing directory for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.SourceOutputDirectory = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_preserve_layout = ("--preserve-layout" == argument);
+                if (is_preserve_layout)
+                {
+                    parsed_arguments.PreserveSourceLayout = true;
+                    continue;
+                }
+
+                bool is_emit_object = ("--emit-object" == argument);
+                if (is_emit_object)
+                {
+                    // READ THE DIRECTORY FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool directory_exists = (argument_index < argument_count);
+                    if (!directory_exists)
+                    {
+                        std::fprintf(stderr, "Missing directory for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.ObjectOutputDirectory = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_evaluate = ("--evaluate" == argument);
+                if (is_evaluate)
+                {
+                    // READ THE FUNCTION NAME FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool function_name_exists = (argument_index < argument_count);
+                    if (!function_name_exists)
+                    {
+                        std::fprintf(stderr, "Missing function for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.EvaluatedFunctionName = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_jit = ("--jit" == argument);
+                if (is_jit)
+                {
+                    // READ THE FUNCTION NAME FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool function_name_exists = (argument_index < argument_count);
+                    if (!function_name_exists)
+                    {
+                        std::fprintf(stderr, "Missing function for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.JitFunctionName = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_query = ("--query" == argument);
+                if (is_query)
+                {
+                    // READ THE QUERY FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool query_exists = (argument_index < argument_count);
+                    if (!query_exists)
+                    {
+                        std::fprintf(stderr, "Missing query for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    std::optional<METAPROGRAMMING::ProgramQuery> query = METAPROGRAMMING::ProgramQuery::Parse(arguments[argument_index]);
+                    if (!query)
+                    {
+                        std::fprintf(stderr, "Invalid query: %s\n", arguments[argument_index]);
+                        return std::nullopt;
+                    }
+                    parsed_arguments.Queries.push_back(std::move(*query));
+                    continue;
+                }
+
+                bool is_optimize = ("-O" == argument || "--optimize" == argument);
+                if (is_optimize)
+                {
+                    parsed_arguments.Optimize = true;
+                    continue;
+                }
+
+                bool is_inline_threshold = ("--inline-threshold" == argument);
+                if (is_inline_threshold)
+                {
+                    // READ THE THRESHOLD FROM THE NEXT ARGUMENT.
+                    // Negative thresholds are allowed, to only inline calls that shrink the caller.
+                    ++argument_index;
+                    bool threshold_exists = (argument_index < argument_count);
+                    if (!threshold_exists)
+                    {
+                        std::fprintf(stderr, "Missing cost for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    char* threshold_end = nullptr;
+                    long long threshold = std::strtoll(arguments[argument_index], &threshold_end, 10);
+                    bool threshold_valid = (threshold_end != arguments[argument_index] && '\0' == *threshold_end);
+                    if (!threshold_valid)
+                    {
+                        std::fprintf(stderr, "Invalid inlining threshold: %s\n", arguments[argument_index]);
+                        return std::nullopt;
+                    }
+                    parsed_arguments.InliningCostModel.Threshold = threshold;
+                    continue;
+                }
+
+                bool is_verify_serialization = ("--verify-serialization" == argument);
+                if (is_verify_serialization)
+                {
+                    parsed_arguments.VerifySerialization = true;
+                    continue;
+                }
+
+                bool is_serve = ("--serve" == argument);
+                if (is_serve)
+                {
+                    // READ THE SOCKET PATH FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool socket_path_exists = (argument_index < argument_count);
+                    if (!socket_path_exists)
+                    {
+                        std::fprintf(stderr, "Missing socket for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.ServerSocketPath = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_connect = ("--connect" == argument);
+                if (is_connect)
+                {
+                    // READ THE SOCKET PATH FROM THE NEXT ARGUMENT.
+                    ++argument_index;
+                    bool socket_path_exists = (argument_index < argument_count);
+                    if (!socket_path_exists)
+                    {
+                        std::fprintf(stderr, "Missing socket for %s.\n", arguments[argument_index - 1]);
+                        return std::nullopt;
+                    }
+
+                    parsed_arguments.ClientSocketPath = arguments[argument_index];
+                    continue;
+                }
+
+                bool is_stop_server = ("--stop-server" == argument);
+                if (is_stop_server)
+                {
+                    parsed_arguments.StopServerRequested = true;
+                    continue;
+                }
+
+                bool is_language_server = ("--language-server" == argument);
+                if (is_language_server)
+                {
+                    parsed_arguments.LanguageServerRequested = true;
+                    continue;
+                }
+
+                bool is_unknown_option = (argument.size() > 1 && '-' == argument[0]);
+                if (is_unknown_option)
+                {
+                    std::fprintf(stderr, "Unknown option: %s\n", arguments[argument_index]);
+                    return std::nullopt;
+                }
+
+                // Any other argument is an input path.
+                parsed_arguments.InputPaths.emplace_back(argument);
+            }
+
+            // VERIFY OPTIONS ARE CONSISTENT.
+            if (parsed_arguments.ServerSocketPath && parsed_arguments.ClientSocketPath)
+            {
+                std::fprintf(stderr, "--serve and --connect can't be used together.\n");
+                return std::nullopt;
+            }
+            if (parsed_arguments.StopServerRequested && !parsed_arguments.ClientSocketPath)
+            {
+                std::fprintf(stderr, "--stop-server requires --connect.\n");
+                return std::nullopt;
+            }
+            bool language_server_conflicts = (parsed_arguments.ServerSocketPath || parsed_arguments.ClientSocketPath || !parsed_arguments.InputPaths.empty());
+            if (parsed_arguments.LanguageServerRequested && language_server_conflicts)
+            {
+                std::fprintf(stderr, "--language-server can't be used with --serve, --connect, or input files.\n");
+                return std::nullopt;
+            }
+
+            return parsed_arguments;
+        }
+
+        /// True if usage information was requested.
+        bool HelpRequested = false;
+        /// The number of translation units to compile in parallel.
+        std::size_t JobCount = ThreadPool::DefaultThreadCount();
+        /// Directories searched for included files, in order.
+        std::vector<std::filesystem::path> IncludeDirectories = {};
+        /// Macros to define before each translation unit, in the form NAME or NAME=VALUE.
+        std::vector<std::string> MacroDefinitions = {};
+        /// The header to precompile for files that start by including it, if any.
+        std::optional<std::filesystem::path> PrefixHeaderFilepath = std::nullopt;
+        /// The directory for caching front-end results between runs, if caching is enabled.
+        std::optional<std::filesystem::path> CacheDirectory = std::nullopt;
+        /// The directory for writing binary front-end output, if requested.
+        std::optional<std::filesystem::path> FrontEndOutputDirectory = std::nullopt;
+        /// The directory for writing the intermediate representation as text, if requested.
+        std::optional<std::filesystem::path> IrOutputDirectory = std::nullopt;
+        /// The directory for writing parsed programs as C source code, if requested.
+        std::optional<std::filesystem::path> SourceOutputDirectory = std::nullopt;
+        /// True if C source code should keep the original comments and blank lines.
+        bool PreserveSourceLayout = false;
+        /// The directory for writing object files, if requested.
+        std::optional<std::filesystem::path> ObjectOutputDirectory = std::nullopt;
+        /// The function to evaluate at compile time in each translation unit, if requested.
+        std::optional<std::string> EvaluatedFunctionName = std::nullopt;
+        /// The function to call in-process after compiling each translation unit, if requested.
+        std::optional<std::string> JitFunctionName = std::nullopt;
+        /// Queries to answer from an index of each translation unit's program.
+        std::vector<METAPROGRAMMING::ProgramQuery> Queries = {};
+        /// True if the intermediate representation should be optimized.
+        bool Optimize = false;
+        /// Decides which calls are inlined when optimizing.
+        OPTIMIZATION::InliningCostModel InliningCostModel = {};
+        /// True if front-end output should be checked for round-tripping through the binary format.
+        bool VerifySerialization = false;
+        /// The socket to listen on when running as a compile server, if requested.
+        std::optional<std::filesystem::path> ServerSocketPath = std::nullopt;
+        /// The socket of a compile server to send the request to, if requested.
+        std::optional<std::filesystem::path> ClientSocketPath = std::nullopt;
+        /// True if the compile server at the client socket should be stopped.
+        bool StopServerRequested = false;
+        /// True if running as a language server over standard input and output.
+        bool LanguageServerRequested = false;
+        /// The files and directories specified as inputs, in command line order.
+        std::vector<std::filesystem::path> InputPaths = {};
+    };
+}
@@ -0,0 +1,990 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "Caching/EvaluationCache.h"
+#include "Caching/ParsedFileCache.h"
+#include "Caching/PrecompiledHeaderCache.h"
+#include "Caching/TranslationUnitCache.h"
+#include "CodeGeneration/CSourceEmitter.h"
+#include "CodeGeneration/ElfObjectWriter.h"
+#include "CodeGeneration/JitModule.h"
+#include "CodeGeneration/X64CodeGenerator.h"
+#include "Compilation/CommandLineArguments.h"
+#include "Compilation/DeclarationSummary.h"
+#include "Compilation/DependencyGraph.h"
+#include "Compilation/PrecompiledHeader.h"
+#include "Compilation/ThreadPool.h"
+#include "Compilation/TranslationUnit.h"
+#include "Debugging/AllocationTracker.h"
+#include "Debugging/IdentifierInternerChecker.h"
+#include "Debugging/InternalChecks.h"
+#include "Debugging/ProgramIndexChecker.h"
+#include "Evaluation/BytecodeCompiler.h"
+#include "Evaluation/BytecodeInterpreter.h"
+#include "Evaluation/CompileTimeEvaluator.h"
+#include "Files/BufferedOutput.h"
+#include "Files/File.h"
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "IntermediateRepresentation/IrBuilder.h"
+#include "IntermediateRepresentation/IrPrinter.h"
+#include "IntermediateRepresentation/IrVerifier.h"
+#include "Metaprogramming/ProgramIndex.h"
+#include "Metaprogramming/ProgramQuery.h"
+#include "Optimization/Optimizer.h"
+#include "Preprocessing/HeaderCache.h"
+#include "Preprocessing/MacroTable.h"
+#include "Preprocessing/Preprocessor.h"
+#include "Preprocessing/SourceFile.h"
+#include "SemanticAnalysis/SemanticAnalyzer.h"
+#include "Serialization/FrontEndRoundTripChecker.h"
+#include "Serialization/FrontEndWriter.h"
+
+namespace COMPILATION
+{
+    /// Drives compilation of multiple source files.
+    /// Translation units are independent of each other, so they are compiled
+    /// concurrently, but results are always reported in input order.
+    struct Compiler
+    {
+        /// Determines if a file should be compiled based on its extension.
+        /// @param[in] filepath - The path of the file to check.
+        /// @return True if the file is a source file; false if not.
+        static bool IsSourceFile(const std::filesystem::path& filepath)
+        {
+            std::filesystem::path extension = filepath.extension();
+            bool is_source_file = (".c" == extension || ".cish" == extension);
+            return is_source_file;
+        }
+
+        /// Expands input paths into the list of source files to compile.
+        /// @param[in] input_paths - Files and directories specified as inputs.
+        ///     Explicitly listed files are always included, while directories
+        ///     are searched recursively for source files.
+        /// @param[out] source_filepaths - The source files to compile, in input order.
+        ///     Files within a directory are sorted so that ordering is deterministic.
+        /// @param[out] error_messages - Messages for any inputs that couldn't be found.
+        /// @return True if all inputs could be found; false otherwise.
+        static bool GatherSourceFiles(
+            const std::vector<std::filesystem::path>& input_paths,
+            std::vector<std::filesystem::path>& source_filepaths,
+            std::string& error_messages)
+        {
+            bool all_inputs_found = true;
+            for (const std::filesystem::path& input_path : input_paths)
+            {
+                std::error_code error;
+                bool is_directory = std::filesystem::is_directory(input_path, error);
+                if (is_directory)
+                {
+                    // FIND ALL SOURCE FILES IN THE DIRECTORY.
+                    std::vector<std::filesystem::path> directory_source_filepaths;
+                    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(input_path, error))
+                    {
+                        bool is_source_file = entry.is_regular_file() && IsSourceFile(entry.path());
+                        if (is_source_file)
+                        {
+                            directory_source_filepaths.push_back(entry.path());
+                        }
+                    }
+
+                    std::sort(directory_source_filepaths.begin(), directory_source_filepaths.end());
+                    source_filepaths.insert(source_filepaths.end(), directory_source_filepaths.begin(), directory_source_filepaths.end());
+                }
+                else if (std::filesystem::exists(input_path, error))
+                {
+                    source_filepaths.push_back(input_path);
+                }
+                else
+                {
+                    error_messages += "Input not found: " + input_path.string() + "\n";
+                    all_inputs_found = false;
+                }
+            }
+
+            return all_inputs_found;
+        }
+
+        /// Compiles a single translation unit from source code already in memory.
+        /// This method is safe to call from multiple threads at once.
+        /// @param[in,out] translation_unit - The translation unit to compile.
+        ///     Its filepath should already be set.
+        /// @param[in] source_code - The source code of the translation unit.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @param[in] predefined_macros - The macros defined before the translation unit starts.
+        /// @param[in] precompiled_header - The precompiled prefix header, if any.
+        /// @param[in] collect_referenced_names - True to collect the names referenced by the
+        ///     source code for recording dependencies; false otherwise.
+        static void CompileSourceCode(
+            TranslationUnit& translation_unit,
+            const std::string& source_code,
+            PREPROCESSING::HeaderCache& header_cache,
+            const PREPROCESSING::MacroTable& predefined_macros,
+            const PrecompiledHeader* const precompiled_header,
+            const bool collect_referenced_names)
+        {
+            using namespace DEBUGGING;
+            using namespace PREPROCESSING;
+
+            // TOKENIZE THE SOURCE CODE.
+            SourceFile source_file;
+            {
+                ScopedCompilerPhase tokenization_phase(CompilerPhase::TOKENIZATION);
+                source_file = SourceFile::Lex(translation_unit.Filepath, source_code);
+            }
+            if (collect_referenced_names)
+            {
+                translation_unit.ReferencedNames = DeclarationSummary::CollectReferencedNames(source_file);
+            }
+
+            // PREPROCESS THE TOKENS.
+            std::size_t prefix_token_count = 0;
+            {
+                ScopedCompilerPhase preprocessing_phase(CompilerPhase::PREPROCESSING);
+                PreprocessedTranslationUnit preprocessed_translation_unit = Preprocessor::Preprocess(
+                    source_file,
+                    header_cache,
+                    predefined_macros,
+                    precompiled_header ? &precompiled_header->Preprocessed : nullptr);
+                prefix_token_count = preprocessed_translation_unit.PrefixTokenCount;
+                translation_unit.Tokens = std::move(preprocessed_translation_unit.Tokens);
+                translation_unit.IncludedFiles = std::move(preprocessed_translation_unit.IncludedFiles);
+                translation_unit.Diagnostics = std::move(preprocessed_translation_unit.Messages);
+                if (!preprocessed_translation_unit.Succeeded)
+                {
+                    return;
+                }
+            }
+
+            // PARSE THE TOKENS.
+            {
+                ScopedCompilerPhase parsing_phase(CompilerPhase::PARSING);
+                bool continues_from_precompiled_header = (precompiled_header && prefix_token_count > 0);
+                if (continues_from_precompiled_header)
+                {
+                    translation_unit.ParsedProgram = precompiled_header->ContinueParsing(translation_unit.Tokens, prefix_token_count);
+                }
+                else
+                {
+                    translation_unit.ParsedProgram = Parse(translation_unit.Tokens);
+                }
+            }
+            if (!translation_unit.ParsedProgram.ErrorMessages.empty())
+            {
+                translation_unit.Diagnostics += translation_unit.ParsedProgram.ErrorMessages;
+                return;
+            }
+
+            // ANALYZE THE PROGRAM.
+            {
+                ScopedCompilerPhase semantic_analysis_phase(CompilerPhase::SEMANTIC_ANALYSIS);
+                bool program_valid = SEMANTIC_ANALYSIS::SemanticAnalyzer::Analyze(translation_unit.ParsedProgram, translation_unit.Diagnostics);
+                if (!program_valid)
+                {
+                    return;
+                }
+            }
+
+            translation_unit.Succeeded = true;
+        }
+
+        /// Describes the results of compiling a translation unit in its report.
+        /// @param[in,out] translation_unit - The compiled translation unit.
+        static void DescribeResults(TranslationUnit& translation_unit)
+        {
+            // Functions are reported in name order for consistent output.
+            std::vector<const FunctionDefinition*> functions;
+            for (const auto& [function_name, function_definition] : translation_unit.ParsedProgram.FunctionsByName)
+            {
+                functions.push_back(&function_definition);
+            }
+            std::sort(
+                functions.begin(),
+                functions.end(),
+                [](const FunctionDefinition* left, const FunctionDefinition* right) { return left->Header.Name < right->Header.Name; });
+
+            translation_unit.Report = translation_unit.Filepath.string() + ": " + std::to_string(translation_unit.Tokens.Tokens.size()) + " tokens\n";
+            translation_unit.Report += translation_unit.Diagnostics;
+            for (const FunctionDefinition* function : functions)
+            {
+                translation_unit.Report += "    Function " + function->Header.Name + " returning " + function->Header.ReturnType + "\n";
+            }
+        }
+
+        /// Compiles a single translation unit from a file.
+        /// This method is safe to call from multiple threads at once.
+        /// @param[in] filepath - The path of the source file to compile.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @param[in] predefined_macros - The macros defined before each translation unit starts.
+        /// @param[in] macro_definitions - The command line definitions of the predefined macros.
+        /// @param[in] precompiled_header - The precompiled prefix header, if any.
+        /// @param[in] cache - The on-disk cache of front-end results, if caching is enabled.
+        /// @param[in] dependency_graph - The dependencies recorded by previous runs, if caching is enabled.
+        ///     The translation unit's current dependencies are recorded in it for updating the graph.
+        /// @param[in,out] resident_cache - The in-memory cache of front-end results, if
+        ///     the compiler is running persistently.
+        /// @return The compiled translation unit.
+        static TranslationUnit CompileFile(
+            const std::filesystem::path& filepath,
+            PREPROCESSING::HeaderCache& header_cache,
+            const PREPROCESSING::MacroTable& predefined_macros,
+            const std::vector<std::string>& macro_definitions,
+            const PrecompiledHeader* const precompiled_header,
+            const CACHING::TranslationUnitCache* const cache,
+            const DependencyGraph* const dependency_graph,
+            CACHING::ParsedFileCache* const resident_cache)
+        {
+            TranslationUnit translation_unit = { .Filepath = filepath };
+
+            // CHECK FOR RESULTS ALREADY IN MEMORY.
+            // Entries in memory are kept up-to-date as files change, so the file doesn't even need to be read.
+            CACHING::ParsedFileCache::LookupResult resident_lookup_result;
+            if (resident_cache)
+            {
+                resident_lookup_result = resident_cache->Find(std::filesystem::absolute(filepath));
+                if (resident_lookup_result.Results)
+                {
+                    translation_unit.Tokens = resident_lookup_result.Results->Tokens;
+                    translation_unit.ParsedProgram = resident_lookup_result.Results->ParsedProgram;
+                    translation_unit.IncludedFiles = resident_lookup_result.Results->IncludedFiles;
+                    translation_unit.LoadedFromCache = true;
+                    translation_unit.Succeeded = true;
+                    DescribeResults(translation_unit);
+                    return translation_unit;
+                }
+            }
+
+            // READ THE SOURCE CODE.
+            std::optional<std::string> source_code = FILES::File::ReadText(filepath);
+            if (!source_code)
+            {
+                translation_unit.Report = "Failed to read " + filepath.string() + "\n";
+                return translation_unit;
+            }
+
+            // CHECK FOR CACHED RESULTS.
+            std::uint64_t cache_key = 0;
+            if (cache)
+            {
+                std::error_code error;
+                std::filesystem::path canonical_filepath = std::filesystem::weakly_canonical(filepath, error);
+                cache_key = CACHING::TranslationUnitCache::ComputeKey(
+                    error ? std::filesystem::absolute(filepath) : canonical_filepath,
+                    *source_code,
+                    header_cache.IncludeDirectories,
+                    macro_definitions);
+
+                // Results can be reused even if included files changed, as long as nothing the translation unit uses did.
+                const DependencyRecord* dependency_record = dependency_graph ? dependency_graph->Find(std::filesystem::absolute(filepath)) : nullptr;
+                std::optional<DependencyRecord> updated_dependency_record;
+                if (dependency_record)
+                {
+                    updated_dependency_record = dependency_graph->CheckUpToDate(*dependency_record, cache_key, header_cache);
+                }
+
+                bool verify_included_files = !updated_dependency_record;
+                std::optional<CACHING::CachedTranslationUnit> cached_translation_unit = cache->Load(cache_key, source_code->size(), header_cache, verify_included_files);
+                if (cached_translation_unit)
+                {
+                    translation_unit.Tokens = std::move(cached_translation_unit->Tokens);
+                    translation_unit.ParsedProgram = std::move(cached_translation_unit->ParsedProgram);
+                    translation_unit.IncludedFiles = std::move(cached_translation_unit->IncludedFiles);
+                    translation_unit.LoadedFromCache = true;
+                    translation_unit.Succeeded = true;
+                }
+                if (cached_translation_unit && updated_dependency_record)
+                {
+                    // The included files' current contents are what the results now correspond to.
+                    translation_unit.IncludedFiles.clear();
+                    for (std::size_t file_index = 0; file_index < updated_dependency_record->Files.size(); ++file_index)
+                    {
+                        const PREPROCESSING::IncludedFile& current_file = updated_dependency_record->Files[file_index].File;
+                        const PREPROCESSING::IncludedFile& previous_file = dependency_record->Files[file_index].File;
+                        if (current_file.ContentHash != previous_file.ContentHash)
+                        {
+                            translation_unit.UnaffectedByChanges = true;
+                        }
+                        translation_unit.IncludedFiles.push_back(current_file);
+                    }
+                    translation_unit.Dependencies = std::move(updated_dependency_record);
+
+                    // Updating the entry lets it be verified directly against the included files' current contents.
+                    if (translation_unit.UnaffectedByChanges)
+                    {
+                        cache->Store(cache_key, source_code->size(), translation_unit.Tokens, translation_unit.ParsedProgram, translation_unit.IncludedFiles);
+                    }
+                }
+            }
+
+            // COMPILE THE SOURCE CODE IF IT WASN'T CACHED.
+            if (!translation_unit.LoadedFromCache)
+            {
+                CompileSourceCode(translation_unit, *source_code, header_cache, predefined_macros, precompiled_header, nullptr != dependency_graph);
+
+                // CACHE THE RESULTS FOR FUTURE RUNS.
+                // Failing to write to the cache only affects later performance, so it isn't an error.
+                if (cache && translation_unit.Succeeded)
+                {
+                    cache->Store(cache_key, source_code->size(), translation_unit.Tokens, translation_unit.ParsedProgram, translation_unit.IncludedFiles);
+                }
+            }
+
+            // RECORD WHAT THE TRANSLATION UNIT DEPENDS ON.
+            if (dependency_graph && translation_unit.Succeeded && !translation_unit.Dependencies)
+            {
+                // Results loaded from the cache don't include the names referenced by the source file.
+                if (translation_unit.LoadedFromCache)
+                {
+                    PREPROCESSING::SourceFile source_file = PREPROCESSING::SourceFile::Lex(filepath, *source_code);
+                    translation_unit.ReferencedNames = DeclarationSummary::CollectReferencedNames(source_file);
+                }
+                translation_unit.Dependencies = dependency_graph->CreateRecord(cache_key, translation_unit.ReferencedNames, translation_unit.IncludedFiles, header_cache);
+            }
+
+            // KEEP THE RESULTS IN MEMORY FOR FUTURE REQUESTS.
+            if (resident_cache && translation_unit.Succeeded)
+            {
+                auto resident_results = std::make_shared<CACHING::CachedTranslationUnit>(CACHING::CachedTranslationUnit
+                {
+                    .Tokens = translation_unit.Tokens,
+                    .ParsedProgram = translation_unit.ParsedProgram,
+                    .IncludedFiles = translation_unit.IncludedFiles,
+                });
+                std::filesystem::path absolute_filepath = std::filesystem::absolute(filepath);
+                resident_cache->Store(absolute_filepath, std::move(resident_results), resident_lookup_result.Generation);
+
+                // Included files are only watched once results are stored, so any changes before then must be checked for explicitly.
+                for (const PREPROCESSING::IncludedFile& included_file : translation_unit.IncludedFiles)
+                {
+                    if (!included_file.IsUnchanged(header_cache))
+                    {
+                        resident_cache->Invalidate(absolute_filepath);
+                        break;
+                    }
+                }
+            }
+
+            DescribeResults(translation_unit);
+            return translation_unit;
+        }
+
+        /// Gets the precompiled prefix header, loading it from the cache if possible.
+        /// @param[in] arguments - The command line arguments, which must specify a prefix header.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @param[in] predefined_macros - The macros defined before each translation unit starts.
+        /// @param[out] error_messages - Any errors or warnings from the header, one per line.
+        /// @return The precompiled header, if successful; null otherwise.
+        static std::optional<PrecompiledHeader> GetPrecompiledHeader(
+            const CommandLineArguments& arguments,
+            PREPROCESSING::HeaderCache& header_cache,
+            const PREPROCESSING::MacroTable& predefined_macros,
+            std::string& error_messages)
+        {
+            // CHECK FOR A PREVIOUSLY PRECOMPILED HEADER.
+            std::optional<CACHING::PrecompiledHeaderCache> cache;
+            std::uint64_t cache_key = 0;
+            if (arguments.CacheDirectory)
+            {
+                cache = CACHING::PrecompiledHeaderCache { .Directory = *arguments.CacheDirectory };
+                std::error_code error;
+                std::filesystem::path canonical_header_filepath = std::filesystem::weakly_canonical(*arguments.PrefixHeaderFilepath, error);
+                cache_key = CACHING::PrecompiledHeaderCache::ComputeKey(canonical_header_filepath, arguments.IncludeDirectories, arguments.MacroDefinitions);
+                std::optional<PrecompiledHeader> cached_precompiled_header = cache->Load(cache_key, header_cache);
+                if (cached_precompiled_header)
+                {
+                    return cached_precompiled_header;
+                }
+            }
+
+            // PRECOMPILE THE HEADER.
+            std::optional<PrecompiledHeader> precompiled_header = PrecompiledHeader::Create(
+                *arguments.PrefixHeaderFilepath,
+                header_cache,
+                predefined_macros,
+                error_messages);
+            if (cache && precompiled_header)
+            {
+                cache->Store(cache_key, *precompiled_header);
+            }
+            return precompiled_header;
+        }
+
+        /// Gets the path for an output file for a source file.
+        /// The source file's path is mirrored under the output directory so
+        /// that files with the same name in different directories don't collide.
+        /// @param[in] output_directory - The directory for the kind of output.
+        /// @param[in] source_filepath - The path of the source file.
+        /// @param[in] extension - The extension for the kind of output, appended to the source filename.
+        /// @return The path for the output file.
+        static std::filesystem::path GetOutputFilepath(const std::filesystem::path& output_directory, const std::filesystem::path& source_filepath, const std::string_view extension)
+        {
+            std::filesystem::path output_filepath = output_directory / source_filepath.relative_path();
+            output_filepath += extension;
+            return output_filepath;
+        }
+
+        /// Writes any requested outputs for a compiled translation unit.
+        /// @param[in] arguments - The command line arguments.
+        /// @param[in,out] translation_unit - The compiled translation unit.
+        ///     Will be marked as failed if any output couldn't be produced.
+        /// @param[in,out] evaluation_cache - Results of functions evaluated at compile time.
+        /// @param[in,out] thread_pool - The threads to spread work on individual functions across.
+        static void WriteOutputs(
+            const CommandLineArguments& arguments,
+            TranslationUnit& translation_unit,
+            CACHING::EvaluationCache& evaluation_cache,
+            ThreadPool& thread_pool)
+        {
+            using namespace SERIALIZATION;
+
+            // VERIFY SERIALIZATION IF REQUESTED.
+            if (arguments.VerifySerialization)
+            {
+                std::optional<std::string> round_trip_error = FrontEndRoundTripChecker::Check(translation_unit.Tokens, translation_unit.ParsedProgram);
+                if (round_trip_error)
+                {
+                    translation_unit.Report += "    Serialization round-trip failed: " + *round_trip_error + "\n";
+                    translation_unit.Succeeded = false;
+                }
+            }
+
+#if INTERNAL_CHECKS
+            // VERIFY THE PROGRAM INDEX.
+            std::optional<std::string> index_error = DEBUGGING::ProgramIndexChecker::Check(translation_unit.ParsedProgram);
+            if (index_error)
+            {
+                translation_unit.Report += "    Program index check failed: " + *index_error + "\n";
+                translation_unit.Succeeded = false;
+            }
+
+            // VERIFY IDENTIFIER INTERNING.
+            std::optional<std::string> interning_error = DEBUGGING::IdentifierInternerChecker::Check(translation_unit.Tokens);
+            if (interning_error)
+            {
+                translation_unit.Report += "    Identifier interning check failed: " + *interning_error + "\n";
+                translation_unit.Succeeded = false;
+            }
+#endif
+
+            // ANSWER ANY QUERIES.
+            // The index is built once so that each query only looks up its results.
+            if (!arguments.Queries.empty())
+            {
+                METAPROGRAMMING::ProgramIndex index = METAPROGRAMMING::ProgramIndex::Build(translation_unit.ParsedProgram);
+                for (const METAPROGRAMMING::ProgramQuery& query : arguments.Queries)
+                {
+                    translation_unit.Report += query.Run(index);
+                }
+            }
+
+            // WRITE BINARY FRONT-END OUTPUT IF REQUESTED.
+            if (arguments.FrontEndOutputDirectory)
+            {
+                std::filesystem::path output_filepath = GetOutputFilepath(*arguments.FrontEndOutputDirectory, translation_unit.Filepath, ".cfe");
+                std::error_code error;
+                std::filesystem::create_directories(output_filepath.parent_path(), error);
+
+                std::string front_end_data = FrontEndWriter::Write(translation_unit.Tokens, translation_unit.ParsedProgram);
+                bool output_written = FILES::File::WriteBinaryAtomically(output_filepath, front_end_data);
+                if (!output_written)
+                {
+                    translation_unit.Report += "    Failed to write " + output_filepath.string() + "\n";
+                    translation_unit.Succeeded = false;
+                }
+            }
+
+            // WRITE C SOURCE CODE IF REQUESTED.
+            if (arguments.SourceOutputDirectory)
+            {
+                std::filesystem::path output_filepath = GetOutputFilepath(*arguments.SourceOutputDirectory, translation_unit.Filepath, ".c");
+                std::error_code error;
+                std::filesystem::create_directories(output_filepath.parent_path(), error);
+
+                bool output_written = false;
+                std::optional<FILES::BufferedOutput> output = FILES::BufferedOutput::OpenFile(output_filepath);
+                if (output)
+                {
+                    CODE_GENERATION::CSourceEmitterOptions options =
+                    {
+                        .OriginalTokens = &translation_unit.Tokens,
+                        .PreserveComments = arguments.PreserveSourceLayout,
+                        .PreserveBlankLines = arguments.PreserveSourceLayout,
+                    };
+                    CODE_GENERATION::CSourceEmitter::EmitProgram(translation_unit.ParsedProgram, options, *output);
+                    output_written = output->Finish();
+                }
+                if (!output_written)
+                {
+                    translation_unit.Report += "    Failed to write " + output_filepath.string() + "\n";
+                    translation_unit.Succeeded = false;
+                }
+            }
+
+            // LOWER TO THE INTERMEDIATE REPRESENTATION IF ANY LATER OUTPUT IS REQUESTED.
+            bool lowering_needed = (arguments.IrOutputDirectory || arguments.EvaluatedFunctionName || arguments.ObjectOutputDirectory || arguments.JitFunctionName);
+            if (!lowering_needed)
+            {
+                return;
+            }
+            std::optional<INTERMEDIATE_REPRESENTATION::Module> module = Lower(translation_unit, arguments, thread_pool);
+            if (!module)
+            {
+                translation_unit.Succeeded = false;
+                return;
+            }
+
+            // WRITE THE INTERMEDIATE REPRESENTATION IF REQUESTED.
+            if (arguments.IrOutputDirectory)
+            {
+                std::filesystem::path output_filepath = GetOutputFilepath(*arguments.IrOutputDirectory, translation_unit.Filepath, ".ir");
+                std::error_code error;
+                std::filesystem::create_directories(output_filepath.parent_path(), error);
+
+                std::string ir_text = INTERMEDIATE_REPRESENTATION::IrPrinter::Print(*module);
+                bool output_written = FILES::File::WriteBinaryAtomically(output_filepath, ir_text);
+                if (!output_written)
+                {
+                    translation_unit.Report += "    Failed to write " + output_filepath.string() + "\n";
+                    translation_unit.Succeeded = false;
+                }
+            }
+
+            // EVALUATE A FUNCTION AT COMPILE TIME IF REQUESTED.
+            if (arguments.EvaluatedFunctionName)
+            {
+                DEBUGGING::ScopedCompilerPhase evaluation_phase(DEBUGGING::CompilerPhase::EVALUATION);
+                std::string error_message;
+                std::optional<EVALUATION::EvaluationResult> result;
+                std::optional<EVALUATION::BytecodeModule> bytecode_module = EVALUATION::BytecodeCompiler::Compile(*module, error_message);
+                if (bytecode_module)
+                {
+                    result = EVALUATION::CompileTimeEvaluator::Evaluate(
+                        *bytecode_module,
+                        *arguments.EvaluatedFunctionName,
+                        {},
+                        EVALUATION::EvaluationBudget {},
+                        &evaluation_cache,
+                        error_message);
+                }
+
+                if (result)
+                {
+                    translation_unit.Report +=
+                        "    " + *arguments.EvaluatedFunctionName + " evaluated to " + std::to_string(result->Value) +
+                        (result->FromCache ? " (cached)" : "") + "\n";
+                }
+                else
+                {
+                    translation_unit.Report += "    " + error_message + "\n";
+                    translation_unit.Succeeded = false;
+                }
+            }
+
+            // GENERATE MACHINE CODE IF ANY LATER OUTPUT IS REQUESTED.
+            bool code_generation_needed = (arguments.ObjectOutputDirectory || arguments.JitFunctionName);
+            if (!code_generation_needed)
+            {
+                return;
+            }
+            // Functions are generated in parallel into separate buffers and then combined in order,
+            // so the output is the same regardless of the number of threads.
+            CODE_GENERATION::ObjectFile object_file;
+            {
+                DEBUGGING::ScopedCompilerPhase code_generation_phase(DEBUGGING::CompilerPhase::CODE_GENERATION);
+                std::vector<CODE_GENERATION::FunctionCode> function_codes(module->Functions.size());
+                thread_pool.ParallelFor(module->Functions.size(), [&](const std::size_t function_index)
+                {
+                    DEBUGGING::ScopedCompilerPhase function_code_generation_phase(DEBUGGING::CompilerPhase::CODE_GENERATION);
+                    function_codes[function_index] = CODE_GENERATION::X64CodeGenerator::GenerateFunction(module->Functions[function_index]);
+                });
+                object_file = CODE_GENERATION::X64CodeGenerator::Combine(function_codes);
+            }
+
+            // WRITE AN OBJECT FILE IF REQUESTED.
+            if (arguments.ObjectOutputDirectory)
+            {
+                std::filesystem::path output_filepath = GetOutputFilepath(*arguments.ObjectOutputDirectory, translation_unit.Filepath, ".o");
+                std::error_code error;
+                std::filesystem::create_directories(output_filepath.parent_path(), error);
+
+                std::string object_data;
+                {
+                    DEBUGGING::ScopedCompilerPhase code_generation_phase(DEBUGGING::CompilerPhase::CODE_GENERATION);
+                    object_data = CODE_GENERATION::ElfObjectWriter::Write(object_file);
+                }
+                bool output_written = FILES::File::WriteBinaryAtomically(output_filepath, object_data);
+                if (!output_written)
+                {
+                    translation_unit.Report += "    Failed to write " + output_filepath.string() + "\n";
+                    translation_unit.Succeeded = false;
+                }
+            }
+
+            // KEEP THE CODE FOR RUNNING IN-PROCESS IF REQUESTED.
+            // It's only run once the translation unit is reported, so that output from running it is in input order.
+            if (arguments.JitFunctionName)
+            {
+                auto jit_function = std::find_if(
+                    module->Functions.begin(),
+                    module->Functions.end(),
+                    [&](const INTERMEDIATE_REPRESENTATION::Function& function) { return function.Name == *arguments.JitFunctionName; });
+                if (module->Functions.end() == jit_function)
+                {
+                    translation_unit.Report += "    Can't run undefined function " + *arguments.JitFunctionName + "\n";
+                    translation_unit.Succeeded = false;
+                    return;
+                }
+                if (!jit_function->ParameterTypes.empty())
+                {
+                    translation_unit.Report += "    Can't run " + *arguments.JitFunctionName + " since it takes parameters\n";
+                    translation_unit.Succeeded = false;
+                    return;
+                }
+                translation_unit.JitFunctionReturnsValue = (INTERMEDIATE_REPRESENTATION::ValueType::VOID != jit_function->ReturnType);
+                translation_unit.JitCode = std::move(object_file);
+            }
+        }
+
+        /// Loads a translation unit's code into memory and runs the function requested on the command line.
+        /// @param[in] arguments - The command line arguments, which must specify a function to run.
+        /// @param[in] translation_unit - The compiled translation unit, which must have code to run.
+        /// @param[in] write_output - Called to write the result.
+        /// @return True if the function was run; false if its code couldn't be loaded.
+        static bool RunJitFunction(
+            const CommandLineArguments& arguments,
+            const TranslationUnit& translation_unit,
+            const std::function<void(std::string_view)>& write_output)
+        {
+            // LOAD THE CODE.
+            std::string error_message;
+            std::optional<CODE_GENERATION::JitModule> jit_module = CODE_GENERATION::JitModule::Load(*translation_unit.JitCode, error_message);
+            if (!jit_module)
+            {
+                write_output("    Failed to load code for " + translation_unit.Filepath.string() + ": " + error_message + "\n");
+                return false;
+            }
+
+            // RUN THE FUNCTION.
+            // Values are returned sign-extended to 64 bits, so any return type can be read as a 64-bit integer.
+            // Output so far is flushed first so it isn't lost if the function crashes.
+            std::fflush(stdout);
+            auto* jit_function = jit_module->GetFunction<std::int64_t()>(*arguments.JitFunctionName);
+            std::int64_t return_value = jit_function();
+            std::fflush(stdout);
+            if (translation_unit.JitFunctionReturnsValue)
+            {
+                write_output("    " + *arguments.JitFunctionName + " returned " + std::to_string(return_value) + "\n");
+            }
+            return true;
+        }
+
+        /// Lowers a compiled translation unit to the intermediate representation.
+        /// @param[in,out] translation_unit - The compiled translation unit.  Semantic analysis
+        ///     is re-run if its program was loaded from a cache, and any errors are added to its report.
+        /// @param[in] arguments - The command line arguments, which determine how to optimize.
+        /// @param[in,out] thread_pool - The threads to lower and optimize functions on.
+        /// @return The lowered and verified functions, if successful; null otherwise.
+        static std::optional<INTERMEDIATE_REPRESENTATION::Module> Lower(
+            TranslationUnit& translation_unit,
+            const CommandLineArguments& arguments,
+            ThreadPool& thread_pool)
+        {
+            using namespace DEBUGGING;
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // ANALYZE ANY CACHED PROGRAM.
+            // Cached programs were analyzed when first compiled, but their types aren't cached.
+            if (!translation_unit.ParsedProgram.Types)
+            {
+                ScopedCompilerPhase semantic_analysis_phase(CompilerPhase::SEMANTIC_ANALYSIS);
+                std::string semantic_error_messages;
+                bool analyzed = SEMANTIC_ANALYSIS::SemanticAnalyzer::Analyze(translation_unit.ParsedProgram, semantic_error_messages);
+                if (!analyzed)
+                {
+                    translation_unit.Report += semantic_error_messages;
+                    return std::nullopt;
+                }
+            }
+
+            // LOWER AND VERIFY EACH FUNCTION.
+            // Functions are lowered in parallel, but kept (along with any errors) in the usual order.
+            ScopedCompilerPhase lowering_phase(CompilerPhase::LOWERING);
+            std::vector<const FunctionDefinition*> function_definitions = IrBuilder::GetFunctionsInOrder(translation_unit.ParsedProgram);
+            std::vector<Function> functions(function_definitions.size());
+            std::vector<std::string> lowering_error_messages(function_definitions.size());
+            thread_pool.ParallelFor(function_definitions.size(), [&](const std::size_t function_index)
+            {
+                ScopedCompilerPhase function_lowering_phase(CompilerPhase::LOWERING);
+                IrBuilder::LowerFunction(
+                    translation_unit.ParsedProgram,
+                    *function_definitions[function_index],
+                    functions[function_index],
+                    lowering_error_messages[function_index]);
+            });
+            Module module;
+            bool lowered = true;
+            for (std::size_t function_index = 0; function_index < functions.size(); ++function_index)
+            {
+                if (!lowering_error_messages[function_index].empty())
+                {
+                    translation_unit.Report += lowering_error_messages[function_index];
+                    lowered = false;
+                    continue;
+                }
+                module.Functions.push_back(std::move(functions[function_index]));
+            }
+            if (!lowered)
+            {
+                return std::nullopt;
+            }
+            if (!Verify(module, translation_unit))
+            {
+                return std::nullopt;
+            }
+
+            // OPTIMIZE IF REQUESTED.
+            // Optimized functions are verified again so that any bug is attributed to the optimizer.
+            // Functions that don't call each other are optimized in parallel, a wave at a time.
+            if (arguments.Optimize)
+            {
+                ScopedCompilerPhase optimization_phase(CompilerPhase::OPTIMIZATION);
+                OPTIMIZATION::CallGraph call_graph = OPTIMIZATION::CallGraph::Build(module);
+                for (const std::vector<std::size_t>& wave : OPTIMIZATION::Optimizer::GetOptimizationWaves(call_graph))
+                {
+                    std::vector<OPTIMIZATION::PassStatistics> statistics_by_function(wave.size());
+                    thread_pool.ParallelFor(wave.size(), [&](const std::size_t wave_function_index)
+                    {
+                        ScopedCompilerPhase function_optimization_phase(CompilerPhase::OPTIMIZATION);
+                        OPTIMIZATION::Optimizer::OptimizeWithInlining(
+                            module,
+                            call_graph,
+                            wave[wave_function_index],
+                            arguments.InliningCostModel,
+                            statistics_by_function[wave_function_index]);
+                    });
+                    for (const OPTIMIZATION::PassStatistics& function_statistics : statistics_by_function)
+                    {
+                        translation_unit.OptimizationStatistics.Add(function_statistics);
+                    }
+                }
+                if (!Verify(module, translation_unit))
+                {
+                    return std::nullopt;
+                }
+            }
+            return module;
+        }
+
+        /// Verifies all functions in a module.
+        /// @param[in] module - The module to verify.
+        /// @param[in,out] translation_unit - The translation unit to report any problem in.
+        /// @return True if all functions are valid; false otherwise.
+        static bool Verify(const INTERMEDIATE_REPRESENTATION::Module& module, TranslationUnit& translation_unit)
+        {
+            for (const INTERMEDIATE_REPRESENTATION::Function& function : module.Functions)
+            {
+                std::optional<std::string> verification_error = INTERMEDIATE_REPRESENTATION::IrVerifier::Verify(function);
+                if (verification_error)
+                {
+                    translation_unit.Report += "    IR verification failed: " + *verification_error + "\n";
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Compiles all source files specified by command line arguments,
+        /// writing results to standard output.
+        /// @param[in] arguments - The command line arguments.
+        /// @return The exit code for the compiler (0 on success).
+        static int CompileFiles(const CommandLineArguments& arguments)
+        {
+            ThreadPool thread_pool(arguments.JobCount);
+            int exit_code = CompileFiles(
+                arguments,
+                thread_pool,
+                nullptr,
+                [](const std::string_view output) { std::fwrite(output.data(), 1, output.size(), stdout); });
+            return exit_code;
+        }
+
+        /// Compiles all source files specified by command line arguments.
+        /// @param[in] arguments - The command line arguments.
+        /// @param[in,out] thread_pool - The threads to compile translation units on.
+        /// @param[in,out] resident_cache - The in-memory cache of front-end results, if
+        ///     the compiler is running persistently.
+        /// @param[in] write_output - Called to write output as it becomes available.
+        /// @return The exit code for the compiler (0 on success).
+        static int CompileFiles(
+            const CommandLineArguments& arguments,
+            ThreadPool& thread_pool,
+            CACHING::ParsedFileCache* const resident_cache,
+            const std::function<void(std::string_view)>& write_output)
+        {
+            // DETERMINE THE FILES TO COMPILE.
+            std::vector<std::filesystem::path> source_filepaths;
+            std::string error_messages;
+            bool all_inputs_found = GatherSourceFiles(arguments.InputPaths, source_filepaths, error_messages);
+            write_output(error_messages);
+
+            // SET UP ANY CACHE.
+            std::optional<CACHING::TranslationUnitCache> cache;
+            if (arguments.CacheDirectory)
+            {
+                cache = CACHING::TranslationUnitCache { .Directory = *arguments.CacheDirectory };
+            }
+            const CACHING::TranslationUnitCache* const cache_pointer = cache ? &*cache : nullptr;
+
+            // LOAD DEPENDENCIES FROM PREVIOUS RUNS.
+            // They're only useful along with cached results, so they're stored in the same directory.
+            DependencyGraph dependency_graph;
+            if (arguments.CacheDirectory)
+            {
+                dependency_graph.Load(*arguments.CacheDirectory / DependencyGraph::FILENAME);
+            }
+            const DependencyGraph* const dependency_graph_pointer = arguments.CacheDirectory ? &dependency_graph : nullptr;
+
+            // LOAD RESULTS OF COMPILE-TIME EVALUATION FROM PREVIOUS RUNS.
+            // Results are always shared between translation units within a run, even without a cache directory.
+            CACHING::EvaluationCache evaluation_cache;
+            if (arguments.CacheDirectory && arguments.EvaluatedFunctionName)
+            {
+                evaluation_cache.Load(*arguments.CacheDirectory / CACHING::EvaluationCache::FILENAME);
+            }
+
+            // SET UP PREPROCESSING.
+            // Included files are shared by all translation units, so they only need to be lexed once.
+            PREPROCESSING::HeaderCache header_cache(arguments.IncludeDirectories);
+            std::string macro_error_messages;
+            const PREPROCESSING::MacroTable predefined_macros = PREPROCESSING::Preprocessor::CreatePredefinedMacros(arguments.MacroDefinitions, macro_error_messages);
+            if (!macro_error_messages.empty())
+            {
+                write_output(macro_error_messages);
+                return EXIT_FAILURE;
+            }
+
+            // PRECOMPILE ANY PREFIX HEADER.
+            std::optional<PrecompiledHeader> precompiled_header;
+            if (arguments.PrefixHeaderFilepath)
+            {
+                std::string precompilation_error_messages;
+                precompiled_header = GetPrecompiledHeader(arguments, header_cache, predefined_macros, precompilation_error_messages);
+                if (!precompiled_header)
+                {
+                    write_output(precompilation_error_messages);
+                    return EXIT_FAILURE;
+                }
+            }
+            const PrecompiledHeader* const precompiled_header_pointer = precompiled_header ? &*precompiled_header : nullptr;
+
+            // START COMPILING ALL FILES.
+            // Files are submitted in input order, so the pool generally completes
+            // them in roughly the same order they will be reported.
+            std::vector<std::future<TranslationUnit>> compiled_translation_units;
+            compiled_translation_units.reserve(source_filepaths.size());
+            for (const std::filesystem::path& source_filepath : source_filepaths)
+            {
+                compiled_translation_units.push_back(thread_pool.Submit([&arguments, source_filepath, &header_cache, &predefined_macros, precompiled_header_pointer, cache_pointer, dependency_graph_pointer, resident_cache, &evaluation_cache, &thread_pool]()
+                {
+                    TranslationUnit translation_unit = CompileFile(
+                        source_filepath,
+                        header_cache,
+                        predefined_macros,
+                        arguments.MacroDefinitions,
+                        precompiled_header_pointer,
+                        cache_pointer,
+                        dependency_graph_pointer,
+                        resident_cache);
+                    if (translation_unit.Succeeded)
+                    {
+                        WriteOutputs(arguments, translation_unit, evaluation_cache, thread_pool);
+                    }
+                    return translation_unit;
+                }));
+            }
+
+            // REPORT RESULTS IN INPUT ORDER.
+            // Each result is released right after being reported to bound memory usage.
+            std::size_t failed_translation_unit_count = 0;
+            std::size_t cached_translation_unit_count = 0;
+            std::size_t unaffected_translation_unit_count = 0;
+            OPTIMIZATION::PassStatistics optimization_statistics;
+            // Dependencies are only added to the graph once all translation units have finished using it.
+            std::unordered_map<std::string, DependencyRecord> dependency_records_by_source_filepath;
+            for (std::future<TranslationUnit>& compiled_translation_unit : compiled_translation_units)
+            {
+                TranslationUnit translation_unit = compiled_translation_unit.get();
+                if (translation_unit.Dependencies)
+                {
+                    std::string absolute_filepath = std::filesystem::absolute(translation_unit.Filepath).string();
+                    dependency_records_by_source_filepath[absolute_filepath] = std::move(*translation_unit.Dependencies);
+                }
+                write_output(translation_unit.Report);
+                if (translation_unit.JitCode)
+                {
+                    bool function_run = RunJitFunction(arguments, translation_unit, write_output);
+                    if (!function_run)
+                    {
+                        translation_unit.Succeeded = false;
+                    }
+                }
+                if (!translation_unit.Succeeded)
+                {
+                    ++failed_translation_unit_count;
+                }
+                if (translation_unit.LoadedFromCache)
+                {
+                    ++cached_translation_unit_count;
+                }
+                if (translation_unit.UnaffectedByChanges)
+                {
+                    ++unaffected_translation_unit_count;
+                }
+                optimization_statistics.Add(translation_unit.OptimizationStatistics);
+            }
+
+            // SAVE DEPENDENCIES FOR FUTURE RUNS.
+            // Records for files not compiled in this run are kept, since they may be compiled again later.
+            // Failing to save them only affects later performance, so it isn't an error.
+            if (arguments.CacheDirectory)
+            {
+                for (auto& [source_filepath, dependency_record] : dependency_records_by_source_filepath)
+                {
+                    dependency_graph.RecordsBySourceFilepath[source_filepath] = std::move(dependency_record);
+                }
+                dependency_graph.Save(*arguments.CacheDirectory / DependencyGraph::FILENAME);
+                if (arguments.EvaluatedFunctionName)
+                {
+                    evaluation_cache.Save(*arguments.CacheDirectory / CACHING::EvaluationCache::FILENAME);
+                }
+            }
+
+            std::string summary =
+                "Compiled " + std::to_string(source_filepaths.size() - failed_translation_unit_count) +
+                " of " + std::to_string(source_filepaths.size()) +
+                " translation units (" + std::to_string(cached_translation_unit_count) +
+                " from cache" +
+                (unaffected_translation_unit_count > 0 ? ", " + std::to_string(unaffected_translation_unit_count) + " unaffected by header changes" : "") +
+                ") using " + std::to_string(thread_pool.ThreadCount()) + " threads.\n";
+            write_output(summary);
+            if (!optimization_statistics.Empty())
+            {
+                write_output(optimization_statistics.Format());
+            }
+
+            bool succeeded = all_inputs_found && (0 == failed_translation_unit_count);
+            return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    };
+}
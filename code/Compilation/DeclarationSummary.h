@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Caching/ContentHash.h"
+#include "CustomString.h"
+#include "Preprocessing/Directive.h"
+#include "Preprocessing/SourceFile.h"
+#include "Tokenization/Token.h"
+
+namespace COMPILATION
+{
+    /// A declaration provided by a file, such as a macro definition.
+    struct Declaration
+    {
+        /// The hash of the declaration's tokens.  Changes whenever the declaration does.
+        std::uint64_t Hash = 0;
+        /// The names referenced by the declaration, which code using it also depends on.
+        std::vector<std::string> ReferencedNames = {};
+    };
+
+    /// Summarizes what a file declares and references, so that changes to it
+    /// can be compared at the level of individual declarations.
+    ///
+    /// Macro definitions are tracked individually.  Everything else (other
+    /// directives and any code or comments, including function definitions
+    /// that end up in every translation unit including the file) is combined
+    /// into a single structure hash, since it affects every includer
+    /// regardless of which names the includer uses.
+    struct DeclarationSummary
+    {
+        /// Summarizes a lexed file.
+        /// @param[in] source_file - The file to summarize.
+        /// @return The summary of the file.
+        static DeclarationSummary Summarize(const PREPROCESSING::SourceFile& source_file)
+        {
+            using namespace TOKENIZATION;
+
+            DeclarationSummary summary;
+            const std::vector<Token>& tokens = source_file.Tokens.Tokens;
+            std::size_t directive_index = 0;
+            for (std::size_t token_index = 0; token_index < tokens.size(); ++token_index)
+            {
+                const Token& token = tokens[token_index];
+
+                // SUMMARIZE DIRECTIVES.
+                if (TokenType::PREPROCESSOR_DIRECTIVE == token.Type)
+                {
+                    const PREPROCESSING::Directive& directive = source_file.Directives[directive_index];
+                    ++directive_index;
+                    summary.AddDirective(directive);
+                    continue;
+                }
+
+                // SUMMARIZE ANY OTHER CODE.
+                // Comments are included since cached tokens keep them for
+                // output that preserves the original layout.
+                summary.AddStructureToken(token);
+            }
+
+            return summary;
+        }
+
+        /// Collects the names referenced anywhere in a file.
+        /// @param[in] source_file - The file.
+        /// @return The distinct names referenced by the file.
+        static std::vector<std::string> CollectReferencedNames(const PREPROCESSING::SourceFile& source_file)
+        {
+            std::unordered_set<std::string> referenced_names;
+            for (const TOKENIZATION::Token& token : source_file.Tokens.Tokens)
+            {
+                if (IsName(token))
+                {
+                    referenced_names.insert(token.Value);
+                }
+            }
+            for (const PREPROCESSING::Directive& directive : source_file.Directives)
+            {
+                referenced_names.insert(directive.Name);
+                for (const TOKENIZATION::Token& argument_token : directive.ArgumentTokens)
+                {
+                    if (IsName(argument_token))
+                    {
+                        referenced_names.insert(argument_token.Value);
+                    }
+                }
+            }
+            return std::vector<std::string>(referenced_names.begin(), referenced_names.end());
+        }
+
+        /// Determines if a token could be the name of a declaration.
+        /// @param[in] token - The token to check.
+        /// @return True if the token is a name; false otherwise.
+        static bool IsName(const TOKENIZATION::Token& token)
+        {
+            bool is_name = (
+                !token.Value.empty() &&
+                String::IsIdentifierCharacter(token.Value.front()) &&
+                TOKENIZATION::TokenType::CONSTANT != token.Type);
+            return is_name;
+        }
+
+        /// The hash of everything in the file other than individually tracked declarations.
+        std::uint64_t StructureHash = 0;
+        /// The names referenced by the file's structure, which every includer depends on.
+        std::vector<std::string> StructureReferencedNames = {};
+        /// The declarations in the file by name.  Multiple declarations with the
+        /// same name (such as in different conditional branches) are combined.
+        std::unordered_map<std::string, Declaration> DeclarationsByName = {};
+
+    private:
+        /// Adds a directive to the summary.
+        /// @param[in] directive - The directive.
+        void AddDirective(const PREPROCESSING::Directive& directive)
+        {
+            if (PREPROCESSING::DirectiveKind::DEFINE == directive.Kind)
+            {
+                Declaration& declaration = DeclarationsByName[directive.Name];
+                declaration.Hash = CACHING::ContentHash::Compute(directive.Name, declaration.Hash);
+                for (const TOKENIZATION::Token& argument_token : directive.ArgumentTokens)
+                {
+                    AddToken(argument_token, declaration);
+                }
+                return;
+            }
+
+            StructureHash = CACHING::ContentHash::Compute(directive.Name, StructureHash + static_cast<std::uint64_t>(directive.Kind));
+            for (const TOKENIZATION::Token& argument_token : directive.ArgumentTokens)
+            {
+                AddStructureToken(argument_token);
+            }
+        }
+
+        /// Adds a token outside of any tracked declaration to the summary.
+        /// @param[in] token - The token.
+        void AddStructureToken(const TOKENIZATION::Token& token)
+        {
+            // Positions are included so that cached tokens from the file stay accurate.
+            StructureHash = CACHING::ContentHash::Compute(token.Value, StructureHash + token.LineNumber);
+            if (IsName(token))
+            {
+                StructureReferencedNames.push_back(token.Value);
+            }
+        }
+
+        /// Adds a token to a declaration.
+        /// @param[in] token - The token.
+        /// @param[in,out] declaration - The declaration containing the token.
+        static void AddToken(const TOKENIZATION::Token& token, Declaration& declaration)
+        {
+            declaration.Hash = CACHING::ContentHash::Compute(token.Value, declaration.Hash);
+            if (IsName(token))
+            {
+                declaration.ReferencedNames.push_back(token.Value);
+            }
+        }
+    };
+}
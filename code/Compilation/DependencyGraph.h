@@ -0,0 +1,417 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Compilation/DeclarationSummary.h"
+#include "Files/File.h"
+#include "Files/MemoryMappedFile.h"
+#include "Preprocessing/HeaderCache.h"
+#include "Preprocessing/IncludedFile.h"
+#include "Preprocessing/SourceFile.h"
+#include "Serialization/BinaryReader.h"
+#include "Serialization/BinaryWriter.h"
+
+namespace COMPILATION
+{
+    /// A file included by a translation unit, as recorded in the dependency graph.
+    struct FileDependency
+    {
+        /// The file and its contents' hash when the translation unit was compiled.
+        PREPROCESSING::IncludedFile File = {};
+        /// The structure hash of the file (see DeclarationSummary).
+        std::uint64_t StructureHash = 0;
+    };
+
+    /// A declaration from an included file used by a translation unit.
+    struct DeclarationDependency
+    {
+        /// The index of the file providing the declaration.
+        std::uint32_t FileIndex = 0;
+        /// The index of the declaration's name in the used names.
+        std::uint32_t NameIndex = 0;
+        /// The hash of the declaration.
+        std::uint64_t Hash = 0;
+    };
+
+    /// Everything a translation unit depended on when it was last compiled.
+    struct DependencyRecord
+    {
+        /// The key of the translation unit's cache entry, which covers its source code and configuration.
+        std::uint64_t CacheKey = 0;
+        /// The files included by the translation unit.
+        std::vector<FileDependency> Files = {};
+        /// All names used by the translation unit, directly or through used declarations.
+        std::vector<std::string> UsedNames = {};
+        /// The declarations from included files that provided any used names.
+        std::vector<DeclarationDependency> Declarations = {};
+    };
+
+    /// Records which files and declarations each translation unit depends on, so that
+    /// a later run only needs to recompile translation units affected by changes.
+    ///
+    /// Changing an included file only affects a translation unit if the file's
+    /// structure changed, or if a declaration the translation unit uses changed
+    /// (including a name it uses becoming or ceasing to be declared by the file).
+    /// Other edits, such as to macros the translation unit never uses, leave dependent
+    /// translation units up-to-date.
+    ///
+    /// The graph is loaded before compiling and saved afterwards.  Checking
+    /// records is safe to do from multiple threads at once.
+    struct DependencyGraph
+    {
+        /// Identifies dependency graph files.
+        static constexpr std::string_view FILE_SIGNATURE = "CISHDG\r\n";
+        /// The version of the dependency graph file layout.
+        static constexpr std::uint32_t FILE_FORMAT_VERSION = 1;
+        /// The name of the dependency graph file within the cache directory.
+        static constexpr std::string_view FILENAME = "dependencies.graph";
+
+        /// Loads records from a file, replacing any current records.
+        /// If the file doesn't exist or is invalid, the graph is left empty.
+        /// @param[in] filepath - The path of the graph file.
+        void Load(const std::filesystem::path& filepath)
+        {
+            using namespace SERIALIZATION;
+
+            RecordsBySourceFilepath.clear();
+            std::optional<FILES::MemoryMappedFile> graph_file = FILES::MemoryMappedFile::Open(filepath);
+            if (!graph_file)
+            {
+                return;
+            }
+
+            // VERIFY THE FILE FORMAT.
+            BinaryReader reader = { .Data = graph_file->Contents() };
+            std::optional<std::string_view> signature = reader.ReadBytes(FILE_SIGNATURE.size());
+            std::optional<std::uint32_t> file_format_version = reader.ReadUInt32();
+            bool format_matches = (!reader.Failed && FILE_SIGNATURE == *signature && FILE_FORMAT_VERSION == *file_format_version);
+            if (!format_matches)
+            {
+                return;
+            }
+
+            // READ EACH RECORD.
+            std::optional<std::uint32_t> record_count = reader.ReadUInt32();
+            for (std::uint32_t record_index = 0; record_count && record_index < *record_count; ++record_index)
+            {
+                std::optional<std::string_view> source_filepath = reader.ReadString();
+                std::optional<std::uint64_t> cache_key = reader.ReadUInt64();
+                if (reader.Failed)
+                {
+                    RecordsBySourceFilepath.clear();
+                    return;
+                }
+                DependencyRecord record = { .CacheKey = *cache_key };
+
+                std::optional<std::uint32_t> file_count = reader.ReadUInt32();
+                for (std::uint32_t file_index = 0; file_count && file_index < *file_count; ++file_index)
+                {
+                    std::optional<std::string_view> filepath = reader.ReadString();
+                    std::optional<std::uint64_t> content_hash = reader.ReadUInt64();
+                    std::optional<std::uint64_t> structure_hash = reader.ReadUInt64();
+                    if (reader.Failed)
+                    {
+                        RecordsBySourceFilepath.clear();
+                        return;
+                    }
+                    record.Files.push_back(FileDependency
+                    {
+                        .File = { .Filepath = *filepath, .ContentHash = *content_hash },
+                        .StructureHash = *structure_hash,
+                    });
+                }
+
+                std::optional<std::uint32_t> used_name_count = reader.ReadUInt32();
+                for (std::uint32_t name_index = 0; used_name_count && name_index < *used_name_count; ++name_index)
+                {
+                    std::optional<std::string_view> used_name = reader.ReadString();
+                    if (!used_name)
+                    {
+                        RecordsBySourceFilepath.clear();
+                        return;
+                    }
+                    record.UsedNames.emplace_back(*used_name);
+                }
+
+                std::optional<std::uint32_t> declaration_count = reader.ReadUInt32();
+                for (std::uint32_t declaration_index = 0; declaration_count && declaration_index < *declaration_count; ++declaration_index)
+                {
+                    std::optional<std::uint32_t> file_index = reader.ReadUInt32();
+                    std::optional<std::uint32_t> name_index = reader.ReadUInt32();
+                    std::optional<std::uint64_t> hash = reader.ReadUInt64();
+                    bool valid = (!reader.Failed && *file_index < record.Files.size() && *name_index < record.UsedNames.size());
+                    if (!valid)
+                    {
+                        RecordsBySourceFilepath.clear();
+                        return;
+                    }
+                    record.Declarations.push_back(DeclarationDependency
+                    {
+                        .FileIndex = *file_index,
+                        .NameIndex = *name_index,
+                        .Hash = *hash,
+                    });
+                }
+
+                RecordsBySourceFilepath.emplace(std::string(*source_filepath), std::move(record));
+            }
+        }
+
+        /// Saves the graph.
+        /// @param[in] filepath - The path of the graph file.
+        /// @return True if the graph was saved; false otherwise.
+        bool Save(const std::filesystem::path& filepath) const
+        {
+            SERIALIZATION::BinaryWriter writer;
+            writer.WriteBytes(FILE_SIGNATURE);
+            writer.WriteUInt32(FILE_FORMAT_VERSION);
+            writer.WriteUInt32(static_cast<std::uint32_t>(RecordsBySourceFilepath.size()));
+            for (const auto& [source_filepath, record] : RecordsBySourceFilepath)
+            {
+                writer.WriteString(source_filepath);
+                writer.WriteUInt64(record.CacheKey);
+                writer.WriteUInt32(static_cast<std::uint32_t>(record.Files.size()));
+                for (const FileDependency& file : record.Files)
+                {
+                    writer.WriteString(file.File.Filepath.string());
+                    writer.WriteUInt64(file.File.ContentHash);
+                    writer.WriteUInt64(file.StructureHash);
+                }
+                writer.WriteUInt32(static_cast<std::uint32_t>(record.UsedNames.size()));
+                for (const std::string& used_name : record.UsedNames)
+                {
+                    writer.WriteString(used_name);
+                }
+                writer.WriteUInt32(static_cast<std::uint32_t>(record.Declarations.size()));
+                for (const DeclarationDependency& declaration : record.Declarations)
+                {
+                    writer.WriteUInt32(declaration.FileIndex);
+                    writer.WriteUInt32(declaration.NameIndex);
+                    writer.WriteUInt64(declaration.Hash);
+                }
+            }
+
+            std::error_code error;
+            std::filesystem::create_directories(filepath.parent_path(), error);
+            bool graph_saved = FILES::File::WriteBinaryAtomically(filepath, writer.Buffer);
+            return graph_saved;
+        }
+
+        /// Creates the record for a compiled translation unit.
+        /// @param[in] cache_key - The key of the translation unit's cache entry.
+        /// @param[in] main_file_names - The names referenced by the translation unit's own source file.
+        /// @param[in] included_files - The files included by the translation unit.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @return The record, if all included files could be read; null otherwise.
+        std::optional<DependencyRecord> CreateRecord(
+            const std::uint64_t cache_key,
+            const std::vector<std::string>& main_file_names,
+            const std::vector<PREPROCESSING::IncludedFile>& included_files,
+            PREPROCESSING::HeaderCache& header_cache) const
+        {
+            DependencyRecord record = { .CacheKey = cache_key };
+
+            // SUMMARIZE THE INCLUDED FILES.
+            std::vector<std::shared_ptr<const DeclarationSummary>> summaries;
+            for (const PREPROCESSING::IncludedFile& included_file : included_files)
+            {
+                std::shared_ptr<const DeclarationSummary> summary = GetSummary(included_file, header_cache);
+                if (!summary)
+                {
+                    return std::nullopt;
+                }
+                summaries.push_back(summary);
+                record.Files.push_back(FileDependency { .File = included_file, .StructureHash = summary->StructureHash });
+            }
+
+            // FIND ALL USED DECLARATIONS.
+            // Names referenced by the structure of included files are used by every includer,
+            // and names used by declarations the translation unit uses are also used,
+            // such as macros referenced by other macros.
+            std::unordered_set<std::string> used_names(main_file_names.begin(), main_file_names.end());
+            for (const std::shared_ptr<const DeclarationSummary>& summary : summaries)
+            {
+                used_names.insert(summary->StructureReferencedNames.begin(), summary->StructureReferencedNames.end());
+            }
+            std::vector<std::string> unprocessed_names(used_names.begin(), used_names.end());
+            while (!unprocessed_names.empty())
+            {
+                std::string name = std::move(unprocessed_names.back());
+                unprocessed_names.pop_back();
+                std::uint32_t name_index = static_cast<std::uint32_t>(record.UsedNames.size());
+                record.UsedNames.push_back(name);
+
+                for (std::uint32_t file_index = 0; file_index < summaries.size(); ++file_index)
+                {
+                    auto declaration = summaries[file_index]->DeclarationsByName.find(name);
+                    if (summaries[file_index]->DeclarationsByName.end() == declaration)
+                    {
+                        continue;
+                    }
+
+                    record.Declarations.push_back(DeclarationDependency
+                    {
+                        .FileIndex = file_index,
+                        .NameIndex = name_index,
+                        .Hash = declaration->second.Hash,
+                    });
+                    for (const std::string& referenced_name : declaration->second.ReferencedNames)
+                    {
+                        bool newly_used = used_names.insert(referenced_name).second;
+                        if (newly_used)
+                        {
+                            unprocessed_names.push_back(referenced_name);
+                        }
+                    }
+                }
+            }
+
+            return record;
+        }
+
+        /// Finds the record for a translation unit.
+        /// @param[in] source_filepath - The absolute path of the translation unit's source file.
+        /// @return The record, if one exists; null otherwise.
+        const DependencyRecord* Find(const std::filesystem::path& source_filepath) const
+        {
+            auto record = RecordsBySourceFilepath.find(source_filepath.string());
+            if (RecordsBySourceFilepath.end() == record)
+            {
+                return nullptr;
+            }
+            return &record->second;
+        }
+
+        /// Checks if a translation unit is unaffected by any changes since its record was created.
+        /// @param[in] record - The record of the translation unit.
+        /// @param[in] cache_key - The current key of the translation unit's cache entry.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @return The updated record (with current file contents) if the translation unit is up-to-date; null otherwise.
+        std::optional<DependencyRecord> CheckUpToDate(const DependencyRecord& record, const std::uint64_t cache_key, PREPROCESSING::HeaderCache& header_cache) const
+        {
+            // CHECK THE TRANSLATION UNIT'S OWN SOURCE CODE AND CONFIGURATION.
+            if (cache_key != record.CacheKey)
+            {
+                return std::nullopt;
+            }
+
+            // CHECK EACH INCLUDED FILE.
+            DependencyRecord updated_record = record;
+            for (std::uint32_t file_index = 0; file_index < record.Files.size(); ++file_index)
+            {
+                // SKIP UNCHANGED FILES.
+                // Each file is only read once per run, however many translation units include it.
+                FileDependency& file = updated_record.Files[file_index];
+                std::optional<std::uint64_t> current_content_hash = header_cache.GetContentHash(file.File.Filepath);
+                if (!current_content_hash)
+                {
+                    return std::nullopt;
+                }
+                if (*current_content_hash == file.File.ContentHash)
+                {
+                    continue;
+                }
+
+                // CHECK THE CHANGES TO THE FILE.
+                PREPROCESSING::IncludedFile current_file = { .Filepath = file.File.Filepath, .ContentHash = *current_content_hash };
+                std::shared_ptr<const DeclarationSummary> summary = GetSummary(current_file, header_cache);
+                if (!summary || summary->StructureHash != file.StructureHash)
+                {
+                    return std::nullopt;
+                }
+                bool declarations_unchanged = UsedDeclarationsMatch(record, file_index, *summary);
+                if (!declarations_unchanged)
+                {
+                    return std::nullopt;
+                }
+
+                file.File.ContentHash = *current_content_hash;
+            }
+
+            return updated_record;
+        }
+
+        /// The records of translation units by the absolute paths of their source files.
+        std::unordered_map<std::string, DependencyRecord> RecordsBySourceFilepath = {};
+
+    private:
+        /// Checks that the declarations a translation unit used from a file are unchanged.
+        /// @param[in] record - The record of the translation unit.
+        /// @param[in] file_index - The index of the file in the record.
+        /// @param[in] summary - The summary of the file's current contents.
+        /// @return True if every used name has the same declaration (or lack of one); false otherwise.
+        static bool UsedDeclarationsMatch(const DependencyRecord& record, const std::uint32_t file_index, const DeclarationSummary& summary)
+        {
+            // FIND THE PREVIOUS DECLARATIONS FROM THE FILE.
+            std::unordered_map<std::uint32_t, std::uint64_t> previous_hashes_by_name_index;
+            for (const DeclarationDependency& declaration : record.Declarations)
+            {
+                if (file_index == declaration.FileIndex)
+                {
+                    previous_hashes_by_name_index.emplace(declaration.NameIndex, declaration.Hash);
+                }
+            }
+
+            // COMPARE THEM TO THE CURRENT DECLARATIONS.
+            for (std::uint32_t name_index = 0; name_index < record.UsedNames.size(); ++name_index)
+            {
+                auto current_declaration = summary.DeclarationsByName.find(record.UsedNames[name_index]);
+                auto previous_hash = previous_hashes_by_name_index.find(name_index);
+                bool currently_declared = (summary.DeclarationsByName.end() != current_declaration);
+                bool previously_declared = (previous_hashes_by_name_index.end() != previous_hash);
+                if (currently_declared != previously_declared)
+                {
+                    return false;
+                }
+                if (currently_declared && current_declaration->second.Hash != previous_hash->second)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Gets the summary of an included file, summarizing it only once per run.
+        /// @param[in] included_file - The file, with the hash of the contents to summarize.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @return The summary, if the file's contents match; null otherwise.
+        std::shared_ptr<const DeclarationSummary> GetSummary(const PREPROCESSING::IncludedFile& included_file, PREPROCESSING::HeaderCache& header_cache) const
+        {
+            std::string key = included_file.Filepath.string();
+            {
+                std::lock_guard<std::mutex> lock(SummariesMutex);
+                auto summary = SummariesByFilepath.find(key);
+                if (SummariesByFilepath.end() != summary)
+                {
+                    return summary->second;
+                }
+            }
+
+            // A file that changed again since it was included can't be summarized consistently.
+            std::shared_ptr<const PREPROCESSING::SourceFile> source_file = header_cache.GetFile(included_file.Filepath);
+            if (!source_file || source_file->ContentHash != included_file.ContentHash)
+            {
+                return nullptr;
+            }
+            auto summary = std::make_shared<const DeclarationSummary>(DeclarationSummary::Summarize(*source_file));
+
+            std::lock_guard<std::mutex> lock(SummariesMutex);
+            SummariesByFilepath.emplace(key, summary);
+            return summary;
+        }
+
+        /// Protects access to summaries.
+        mutable std::mutex SummariesMutex = {};
+        /// Summaries of included files by path, for the file contents seen during this run.
+        mutable std::unordered_map<std::string, std::shared_ptr<const DeclarationSummary>> SummariesByFilepath = {};
+    };
+}
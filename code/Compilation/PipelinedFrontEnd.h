@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Compilation/SpscRingBuffer.h"
+#include "Compilation/TopLevelItemTracker.h"
+#include "Debugging/AllocationTracker.h"
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Tokenization/Tokenizer.cpp"
+
+namespace COMPILATION
+{
+    /// Tokenizes and parses source code concurrently, so the time taken approaches
+    /// that of the slower phase rather than the sum of both.
+    ///
+    /// The tokenizer runs on its own thread, publishing tokens in batches through
+    /// a ring buffer.  The parser backtracks and looks ahead within top-level
+    /// items, so it only starts an item once all of its tokens have arrived.
+    /// Items are therefore parsed from exactly the same tokens as when parsing
+    /// sequentially, so results match.
+    struct PipelinedFrontEnd
+    {
+        /// The minimum number of tokens handed off at once, to amortize synchronization.
+        static constexpr std::size_t TOKEN_BATCH_SIZE = 2048;
+        /// The number of batches that can be waiting for the parser before the tokenizer waits.
+        static constexpr std::size_t BATCH_CAPACITY = 64;
+
+        /// Tokenizes and parses source code.
+        /// @param[in] source_code - The source code to compile.
+        /// @param[out] token_stream - The tokens of the source code.
+        /// @return The program parsed from the tokens.
+        static Program TokenizeAndParse(const std::string& source_code, TOKENIZATION::TokenStream& token_stream)
+        {
+            using namespace DEBUGGING;
+            using namespace TOKENIZATION;
+
+            // RUN THE PHASES SEQUENTIALLY IF THEY CAN'T OVERLAP.
+            // Handing off tokens between threads sharing a single core would only add overhead.
+            bool phases_can_overlap = (std::thread::hardware_concurrency() > 1);
+            if (!phases_can_overlap)
+            {
+                {
+                    ScopedCompilerPhase tokenization_phase(CompilerPhase::TOKENIZATION);
+                    token_stream = Tokenizer::Tokenize(source_code);
+                }
+                ScopedCompilerPhase parsing_phase(CompilerPhase::PARSING);
+                return Parse(token_stream);
+            }
+
+            // TOKENIZE THE SOURCE CODE ON ANOTHER THREAD.
+            // Only non-empty batches are published so that an empty batch can mark the end of the tokens.
+            SpscRingBuffer<std::vector<Token>> token_batches(BATCH_CAPACITY);
+            std::thread tokenizer_thread([&source_code, &token_batches]()
+            {
+                ScopedCompilerPhase tokenization_phase(CompilerPhase::TOKENIZATION);
+                Tokenizer::Tokenize(source_code, TOKEN_BATCH_SIZE, [&token_batches](std::vector<Token>&& batch)
+                {
+                    if (!batch.empty())
+                    {
+                        token_batches.Push(std::move(batch));
+                    }
+                });
+                token_batches.Push({});
+            });
+
+            // PARSE TOP-LEVEL ITEMS AS SOON AS ALL OF THEIR TOKENS HAVE ARRIVED.
+            ScopedCompilerPhase parsing_phase(CompilerPhase::PARSING);
+            Program program;
+            token_stream = {};
+            TopLevelItemTracker item_tracker;
+            std::size_t complete_token_count = 0;
+            bool all_tokens_received = false;
+            while (!all_tokens_received)
+            {
+                std::vector<Token> batch = token_batches.Pop();
+                all_tokens_received = batch.empty();
+                std::size_t first_new_token_index = token_stream.Tokens.size();
+                token_stream.Tokens.insert(token_stream.Tokens.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+
+                // FIND THE END OF THE LAST COMPLETE ITEM.
+                for (std::size_t token_index = first_new_token_index; token_index < token_stream.Tokens.size(); ++token_index)
+                {
+                    if (item_tracker.EndsItem(token_stream.Tokens[token_index]))
+                    {
+                        complete_token_count = token_index + 1;
+                    }
+                }
+                if (all_tokens_received)
+                {
+                    complete_token_count = token_stream.Tokens.size();
+                }
+
+                while (token_stream.CurrentIndex < complete_token_count)
+                {
+                    ParseTopLevelItem(token_stream, program);
+                }
+            }
+
+            tokenizer_thread.join();
+            return program;
+        }
+
+    };
+}
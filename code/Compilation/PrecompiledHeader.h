@@ -0,0 +1,85 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include "Debugging/AllocationTracker.h"
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Preprocessing/HeaderCache.h"
+#include "Preprocessing/MacroTable.h"
+#include "Preprocessing/Preprocessor.h"
+#include "Tokenization/TokenStream.h"
+
+namespace COMPILATION
+{
+    /// The full front-end state after a prefix header that many translation
+    /// units start by including.  It's built once, and each translation unit
+    /// that starts with an #include of the header continues from this state
+    /// rather than preprocessing and parsing the header again.
+    struct PrecompiledHeader
+    {
+        /// Precompiles a prefix header.
+        /// @param[in] header_filepath - The path of the header.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @param[in] predefined_macros - The macros defined before each translation unit starts.
+        /// @param[out] error_messages - Any errors or warnings, one per line.
+        /// @return The precompiled header, if the header had no errors; null otherwise.
+        static std::optional<PrecompiledHeader> Create(
+            const std::filesystem::path& header_filepath,
+            PREPROCESSING::HeaderCache& header_cache,
+            const PREPROCESSING::MacroTable& predefined_macros,
+            std::string& error_messages)
+        {
+            using namespace DEBUGGING;
+
+            // PREPROCESS THE HEADER.
+            std::optional<PREPROCESSING::PreprocessorSnapshot> preprocessor_snapshot;
+            {
+                ScopedCompilerPhase preprocessing_phase(CompilerPhase::PREPROCESSING);
+                preprocessor_snapshot = PREPROCESSING::Preprocessor::PreprocessPrefixHeader(header_filepath, header_cache, predefined_macros, error_messages);
+                if (!preprocessor_snapshot)
+                {
+                    return std::nullopt;
+                }
+            }
+
+            // PARSE THE HEADER.
+            PrecompiledHeader precompiled_header = { .Preprocessed = std::move(*preprocessor_snapshot) };
+            {
+                ScopedCompilerPhase parsing_phase(CompilerPhase::PARSING);
+                TOKENIZATION::TokenStream header_tokens = precompiled_header.Preprocessed.Tokens;
+                precompiled_header.ParsedProgram = Parse(header_tokens);
+                if (!precompiled_header.ParsedProgram.ErrorMessages.empty())
+                {
+                    error_messages += precompiled_header.ParsedProgram.ErrorMessages;
+                    return std::nullopt;
+                }
+            }
+            return precompiled_header;
+        }
+
+        /// Parses the rest of a translation unit that continued from the header.
+        /// @param[in,out] token_stream - All tokens of the translation unit, starting with
+        ///     those restored from the header.
+        /// @param[in] prefix_token_count - The number of leading tokens restored from the header.
+        /// @return The program for the whole translation unit.
+        Program ContinueParsing(TOKENIZATION::TokenStream& token_stream, const std::size_t prefix_token_count) const
+        {
+            // PARSE THE TOKENS AFTER THE HEADER.
+            // Parsing continues from the header's program so that redefinitions of the header's
+            // functions are reported just as if everything was parsed at once.
+            Program program = ParsedProgram;
+            token_stream.CurrentIndex = prefix_token_count;
+            while (token_stream.MoreTokens())
+            {
+                ParseTopLevelItem(token_stream, program);
+            }
+            return program;
+        }
+
+        /// The preprocessor state after the header.
+        PREPROCESSING::PreprocessorSnapshot Preprocessed = {};
+        /// The declarations parsed from the header.
+        Program ParsedProgram = {};
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace COMPILATION
+{
+    /// A fixed-capacity queue for passing values from exactly one producer thread
+    /// to exactly one consumer thread without locks.
+    ///
+    /// Each thread only ever writes its own index, so pushing and popping are a
+    /// single release store each.  The indices are kept on separate cache lines,
+    /// and each thread caches the other's index so that it only needs to reload it
+    /// when the queue appears full or empty.  Blocking operations wait on the
+    /// other thread's index rather than spinning, so a stalled stage doesn't
+    /// consume a core.
+    ///
+    /// @tparam Value - The type of values passed between threads.
+    template <typename Value>
+    struct SpscRingBuffer
+    {
+        /// Creates an empty ring buffer.
+        /// @param[in] minimum_capacity - The minimum number of values that can be queued at once.
+        ///     Rounded up to a power of 2 so that indices wrap with a mask.
+        explicit SpscRingBuffer(const std::size_t minimum_capacity) :
+            Capacity(std::bit_ceil(std::max<std::size_t>(minimum_capacity, 2))),
+            Slots(std::make_unique<std::optional<Value>[]>(Capacity))
+        {}
+
+        SpscRingBuffer(const SpscRingBuffer&) = delete;
+        SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+        /// Adds a value if there's room.  Must only be called from the producer thread.
+        /// @param[in,out] value - The value to add.  Moved from only if added.
+        /// @return True if the value was added; false if the ring buffer was full.
+        bool TryPush(Value& value)
+        {
+            std::size_t tail = Tail.load(std::memory_order_relaxed);
+            if (tail - CachedHead == Capacity)
+            {
+                CachedHead = Head.load(std::memory_order_acquire);
+                if (tail - CachedHead == Capacity)
+                {
+                    return false;
+                }
+            }
+
+            Slots[tail & (Capacity - 1)].emplace(std::move(value));
+            Tail.store(tail + 1, std::memory_order_release);
+            Tail.notify_one();
+            return true;
+        }
+
+        /// Adds a value, waiting for room if the ring buffer is full.  Must only be called from the producer thread.
+        /// @param[in] value - The value to add.
+        void Push(Value value)
+        {
+            while (!TryPush(value))
+            {
+                Head.wait(CachedHead, std::memory_order_acquire);
+            }
+        }
+
+        /// Removes the oldest value if there is one.  Must only be called from the consumer thread.
+        /// @return The oldest value, if any; null if the ring buffer was empty.
+        std::optional<Value> TryPop()
+        {
+            std::size_t head = Head.load(std::memory_order_relaxed);
+            if (head == CachedTail)
+            {
+                CachedTail = Tail.load(std::memory_order_acquire);
+                if (head == CachedTail)
+                {
+                    return std::nullopt;
+                }
+            }
+
+            std::optional<Value>& slot = Slots[head & (Capacity - 1)];
+            std::optional<Value> value = std::move(slot);
+            slot.reset();
+            Head.store(head + 1, std::memory_order_release);
+            Head.notify_one();
+            return value;
+        }
+
+        /// Removes the oldest value, waiting for one if the ring buffer is empty.  Must only be called from the consumer thread.
+        /// @return The oldest value.
+        Value Pop()
+        {
+            for (;;)
+            {
+                std::optional<Value> value = TryPop();
+                if (value)
+                {
+                    return std::move(*value);
+                }
+                Tail.wait(CachedTail, std::memory_order_acquire);
+            }
+        }
+
+    private:
+        /// The size of a cache line, to keep each thread's index from sharing one with the other's.
+        static constexpr std::size_t CACHE_LINE_SIZE_IN_BYTES = 64;
+
+        /// The number of slots, which is a power of 2.
+        const std::size_t Capacity;
+        /// The slots holding queued values.
+        const std::unique_ptr<std::optional<Value>[]> Slots;
+
+        /// The number of values ever popped.  Only written by the consumer.
+        alignas(CACHE_LINE_SIZE_IN_BYTES) std::atomic<std::size_t> Head = 0;
+        /// The producer's last observed value of Head.
+        std::size_t CachedHead = 0;
+
+        /// The number of values ever pushed.  Only written by the producer.
+        alignas(CACHE_LINE_SIZE_IN_BYTES) std::atomic<std::size_t> Tail = 0;
+        /// The consumer's last observed value of Tail.
+        std::size_t CachedTail = 0;
+    };
+}
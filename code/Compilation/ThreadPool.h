@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace COMPILATION
+{
+    /// A fixed-size pool of worker threads that execute queued tasks.
+    /// The number of threads is bounded so that compiling many files
+    /// doesn't oversubscribe the machine.
+    struct ThreadPool
+    {
+        /// Gets a default number of threads to use for the current machine.
+        /// @return The number of hardware threads, or 1 if that can't be determined.
+        static std::size_t DefaultThreadCount()
+        {
+            std::size_t hardware_thread_count = std::thread::hardware_concurrency();
+            return std::max<std::size_t>(hardware_thread_count, 1);
+        }
+
+        /// Starts the worker threads.
+        /// @param[in] thread_count - The number of worker threads.  At least 1 thread is always started.
+        explicit ThreadPool(const std::size_t thread_count)
+        {
+            std::size_t worker_thread_count = std::max<std::size_t>(thread_count, 1);
+            WorkerThreads.reserve(worker_thread_count);
+            for (std::size_t thread_index = 0; thread_index < worker_thread_count; ++thread_index)
+            {
+                WorkerThreads.emplace_back([this]() { RunWorker(); });
+            }
+        }
+
+        /// Finishes any remaining tasks and stops the worker threads.
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(TasksMutex);
+                StopRequested = true;
+            }
+            TaskAvailable.notify_all();
+
+            for (std::thread& worker_thread : WorkerThreads)
+            {
+                worker_thread.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Gets the number of worker threads.
+        /// @return The number of worker threads.
+        std::size_t ThreadCount() const
+        {
+            return WorkerThreads.size();
+        }
+
+        /// Queues a task to be executed on a worker thread.
+        /// @param[in] task - The task to execute.
+        /// @return A future for the result of the task.
+        template <typename TaskFunction>
+        std::future<std::invoke_result_t<TaskFunction>> Submit(TaskFunction&& task)
+        {
+            // WRAP THE TASK SO ITS RESULT CAN BE RETRIEVED.
+            // A shared pointer is used since std::function requires copyable callables.
+            using ResultType = std::invoke_result_t<TaskFunction>;
+            auto packaged_task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<TaskFunction>(task));
+            std::future<ResultType> result = packaged_task->get_future();
+
+            // QUEUE THE TASK.
+            Enqueue([packaged_task]() { (*packaged_task)(); });
+            return result;
+        }
+
+        /// Calls a function for each index in a range, spreading calls across the calling
+        /// thread and any idle worker threads, and returns once all calls are done.
+        ///
+        /// Indices are claimed one at a time in order, so threads that finish early
+        /// take on more work and uneven calls still balance.  The calling thread
+        /// always takes part and only waits for calls already in progress, so this
+        /// can safely be used from within a task on the same pool, even if all
+        /// workers are busy.
+        ///
+        /// @param[in] index_count - The number of indices, starting from 0.
+        /// @param[in] call - The function to call with each index.  Called from multiple threads at once.
+        void ParallelFor(const std::size_t index_count, const std::function<void(std::size_t)>& call)
+        {
+            // SHARE THE RANGE WITH ANY IDLE WORKERS.
+            // Helpers may only start after all indices are claimed, so the loop state outlives this call.
+            struct ParallelLoop
+            {
+                std::atomic<std::size_t> NextIndex = 0;
+                std::atomic<std::size_t> CompletedCount = 0;
+                std::size_t IndexCount = 0;
+                const std::function<void(std::size_t)>* Call = nullptr;
+            };
+            auto loop = std::make_shared<ParallelLoop>();
+            loop->IndexCount = index_count;
+            loop->Call = &call;
+            auto run_calls = [loop]()
+            {
+                for (std::size_t index = loop->NextIndex.fetch_add(1, std::memory_order_relaxed);
+                    index < loop->IndexCount;
+                    index = loop->NextIndex.fetch_add(1, std::memory_order_relaxed))
+                {
+                    (*loop->Call)(index);
+                    bool last_call_completed = (loop->CompletedCount.fetch_add(1, std::memory_order_acq_rel) + 1 == loop->IndexCount);
+                    if (last_call_completed)
+                    {
+                        loop->CompletedCount.notify_all();
+                    }
+                }
+            };
+            std::size_t helper_count = std::min(WorkerThreads.size(), index_count) - ((index_count > 0) ? 1 : 0);
+            for (std::size_t helper_index = 0; helper_index < helper_count; ++helper_index)
+            {
+                Enqueue(run_calls);
+            }
+
+            // MAKE CALLS ON THIS THREAD TOO.
+            run_calls();
+
+            // WAIT FOR CALLS ON OTHER THREADS TO FINISH.
+            for (std::size_t completed_count = loop->CompletedCount.load(std::memory_order_acquire);
+                completed_count < index_count;
+                completed_count = loop->CompletedCount.load(std::memory_order_acquire))
+            {
+                loop->CompletedCount.wait(completed_count, std::memory_order_acquire);
+            }
+        }
+
+    private:
+        /// Queues a task to be executed on a worker thread.
+        /// @param[in] task - The task to execute.
+        void Enqueue(std::function<void()> task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(TasksMutex);
+                Tasks.emplace_back(std::move(task));
+            }
+            TaskAvailable.notify_one();
+        }
+
+        /// Executes tasks on the current thread until the pool is stopped
+        /// and no tasks remain.
+        void RunWorker()
+        {
+            while (true)
+            {
+                // WAIT FOR A TASK.
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(TasksMutex);
+                    TaskAvailable.wait(lock, [this]() { return StopRequested || !Tasks.empty(); });
+
+                    bool no_more_work = (StopRequested && Tasks.empty());
+                    if (no_more_work)
+                    {
+                        return;
+                    }
+
+                    task = std::move(Tasks.front());
+                    Tasks.pop_front();
+                }
+
+                // EXECUTE THE TASK.
+                task();
+            }
+        }
+
+        /// The threads executing tasks.
+        std::vector<std::thread> WorkerThreads = {};
+        /// Guards access to the queued tasks and stop flag.
+        std::mutex TasksMutex = {};
+        /// Signaled when a task is queued or the pool is stopping.
+        std::condition_variable TaskAvailable = {};
+        /// Tasks waiting to be executed, in the order they were submitted.
+        std::deque<std::function<void()>> Tasks = {};
+        /// True once the pool has been asked to stop.
+        bool StopRequested = false;
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include "Tokenization/Token.h"
+#include "Tokenization/TokenType.h"
+
+namespace COMPILATION
+{
+    /// Finds where top-level items (like function definitions) end in a stream of
+    /// tokens without parsing them, so that they can be handled separately.
+    ///
+    /// An item ends with a ';' or '}' once all braces, brackets, and parentheses
+    /// are balanced.  The parser never backtracks or looks ahead past such a token
+    /// at the top level, so parsing items separately gives the same results as
+    /// parsing all tokens together.  Unbalanced closing tokens are ignored rather
+    /// than letting depths go negative.
+    struct TopLevelItemTracker
+    {
+        /// Scans the next token.
+        /// @param[in] token - The next token.
+        /// @return True if the token ends a top-level item; false otherwise.
+        bool EndsItem(const TOKENIZATION::Token& token)
+        {
+            using namespace TOKENIZATION;
+
+            bool item_may_end = false;
+            switch (token.Type)
+            {
+                case TokenType::OPENING_CURLY_BRACE:
+                    ++BraceDepth;
+                    break;
+                case TokenType::CLOSING_CURLY_BRACE:
+                    BraceDepth -= (BraceDepth > 0) ? 1 : 0;
+                    item_may_end = true;
+                    break;
+                case TokenType::OPENING_PARENTHESIS:
+                    ++GroupingDepth;
+                    break;
+                case TokenType::CLOSING_PARENTHESIS:
+                    GroupingDepth -= (GroupingDepth > 0) ? 1 : 0;
+                    break;
+                case TokenType::PUNCTUATOR:
+                    // Square brackets are punctuators rather than having their own token types.
+                    if ("[" == token.Value)
+                    {
+                        ++GroupingDepth;
+                    }
+                    else if ("]" == token.Value)
+                    {
+                        GroupingDepth -= (GroupingDepth > 0) ? 1 : 0;
+                    }
+                    item_may_end = (";" == token.Value);
+                    break;
+                default:
+                    break;
+            }
+
+            bool item_ended = (item_may_end && 0 == BraceDepth && 0 == GroupingDepth);
+            return item_ended;
+        }
+
+    private:
+        /// The number of unclosed curly braces.
+        std::size_t BraceDepth = 0;
+        /// The number of unclosed parentheses and square brackets.
+        std::size_t GroupingDepth = 0;
+    };
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include "CodeGeneration/ObjectFile.h"
+#include "Compilation/DependencyGraph.h"
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Optimization/PassStatistics.h"
+#include "Preprocessing/IncludedFile.h"
+#include "Tokenization/TokenStream.h"
+
+namespace COMPILATION
+{
+    /// A single source file being compiled, along with the results of compiling it.
+    struct TranslationUnit
+    {
+        /// The path of the source file.
+        std::filesystem::path Filepath = "";
+        /// True if the translation unit compiled successfully; false if not.
+        bool Succeeded = false;
+        /// True if front-end results were loaded from the cache rather than recomputed.
+        bool LoadedFromCache = false;
+        /// True if included files changed, but not in any way that affects this translation unit.
+        bool UnaffectedByChanges = false;
+        /// Preprocessed tokens from the source file and any included files.
+        TOKENIZATION::TokenStream Tokens = {};
+        /// The files included by the source file.
+        std::vector<PREPROCESSING::IncludedFile> IncludedFiles = {};
+        /// The program parsed from the tokens.
+        Program ParsedProgram = {};
+        /// The names referenced by the source file itself (not including any included files).
+        std::vector<std::string> ReferencedNames = {};
+        /// What the translation unit depends on, if dependencies are being recorded.
+        std::optional<DependencyRecord> Dependencies = std::nullopt;
+        /// Any errors or warnings from compilation.
+        std::string Diagnostics = "";
+        /// Text describing the results of compilation (including any errors)
+        /// to report once all earlier translation units have been reported.
+        std::string Report = "";
+        /// Work done by each optimization pass on the translation unit.
+        OPTIMIZATION::PassStatistics OptimizationStatistics = {};
+        /// Code to load and run in-process once the translation unit is reported, if requested.
+        std::optional<CODE_GENERATION::ObjectFile> JitCode = std::nullopt;
+        /// True if the function run in-process returns a value.
+        bool JitFunctionReturnsValue = false;
+    };
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string_view>
+
+namespace COMPILATION
+{
+    /// The version of the compiler.  Anything persisted between runs
+    /// (like cached translation units) is tied to this version, so it
+    /// should be updated whenever compiler output changes.
+    constexpr std::string_view COMPILER_VERSION = "0.1.0";
+}
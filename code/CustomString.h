@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cctype>
 #include <optional>
 #include <string>
 
@@ -50,4 +51,26 @@ struct String
         // If a character didn't, then we would have returned false earlier.
         return true;
     }
+    
+    static bool IsIdentifierCharacter(const char character)
+    {
+        bool is_identifier_character = std::isalnum(static_cast<unsigned char>(character)) || '_' == character;
+        return is_identifier_character;
+    }
+    
+    static bool WordMatches(const std::string& string, const std::size_t start_index, const std::string& word)
+    {
+        // MAKE SURE THE CHARACTERS MATCH.
+        bool characters_match = CharactersMatch(string, start_index, word);
+        if (!characters_match)
+        {
+            return false;
+        }
+        
+        // MAKE SURE THE WORD ISN'T JUST THE START OF A LONGER WORD.
+        // For example, "format" shouldn't match the "for" keyword.
+        std::optional<char> next_character = GetCharacterIfExists(string, start_index + word.length());
+        bool word_continues = next_character && IsIdentifierCharacter(*next_character);
+        return !word_continues;
+    }
 };
@@ -0,0 +1,655 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if _WIN32
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <execinfo.h>
+#endif
+
+/// Allocation tracking is compiled in only when requested (for example,
+/// via /DALLOCATION_TRACKING=1) since replacing the global allocator adds
+/// overhead to every allocation in the program.
+#ifndef ALLOCATION_TRACKING
+    #define ALLOCATION_TRACKING 0
+#endif
+
+/// Keeps a function out of callers so that it has its own stack frame, and gets the
+/// address a function will return to, for finding where allocations were requested.
+#if _WIN32
+    #include <intrin.h>
+    #define ALLOCATION_TRACKER_NOINLINE __declspec(noinline)
+    #define ALLOCATION_TRACKER_RETURN_ADDRESS() _ReturnAddress()
+#else
+    #define ALLOCATION_TRACKER_NOINLINE __attribute__((noinline))
+    #define ALLOCATION_TRACKER_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+namespace DEBUGGING
+{
+    /// The different phases of the compiler to which allocations may be attributed.
+    enum class CompilerPhase : std::uint32_t
+    {
+        UNKNOWN = 0,
+        TOKENIZATION,
+        PREPROCESSING,
+        PARSING,
+        SEMANTIC_ANALYSIS,
+        LOWERING,
+        OPTIMIZATION,
+        CODE_GENERATION,
+        EVALUATION,
+        REPORTING,
+        /// The total number of phases.  Must remain last.
+        COUNT
+    };
+
+    /// Gets a human-readable name for a compiler phase.
+    /// @param[in] phase - The phase for which to get a name.
+    /// @return The name of the phase.
+    inline const char* GetCompilerPhaseName(const CompilerPhase phase)
+    {
+        switch (phase)
+        {
+            case CompilerPhase::TOKENIZATION:
+                return "Tokenization";
+            case CompilerPhase::PREPROCESSING:
+                return "Preprocessing";
+            case CompilerPhase::PARSING:
+                return "Parsing";
+            case CompilerPhase::SEMANTIC_ANALYSIS:
+                return "Semantic analysis";
+            case CompilerPhase::LOWERING:
+                return "Lowering";
+            case CompilerPhase::OPTIMIZATION:
+                return "Optimization";
+            case CompilerPhase::CODE_GENERATION:
+                return "Code generation";
+            case CompilerPhase::EVALUATION:
+                return "Compile-time evaluation";
+            case CompilerPhase::REPORTING:
+                return "Reporting";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /// Counts of allocations and deallocations.
+    /// Counters are atomic since allocations may happen on any thread.
+    struct AllocationCounts
+    {
+        /// The number of allocations.
+        std::atomic<std::uint64_t> AllocationCount = 0;
+        /// The total bytes allocated.
+        std::atomic<std::uint64_t> AllocatedByteCount = 0;
+        /// The number of deallocations.
+        std::atomic<std::uint64_t> DeallocationCount = 0;
+        /// The total bytes deallocated.
+        std::atomic<std::uint64_t> DeallocatedByteCount = 0;
+    };
+
+    /// A copy of allocation counts at a point in time.
+    /// Useful for checking that a piece of code stays within an allocation budget.
+    struct AllocationCountsSnapshot
+    {
+        /// The number of allocations.
+        std::uint64_t AllocationCount = 0;
+        /// The total bytes allocated.
+        std::uint64_t AllocatedByteCount = 0;
+        /// The number of deallocations.
+        std::uint64_t DeallocationCount = 0;
+        /// The total bytes deallocated.
+        std::uint64_t DeallocatedByteCount = 0;
+    };
+
+    /// A unique call stack from which allocations were made.
+    struct AllocationCallSite
+    {
+        /// The maximum number of stack frames captured for a call site.
+        static constexpr std::size_t MAX_FRAME_COUNT = 8;
+
+        /// A hash identifying the call stack.  Zero if the call site is unused.
+        std::atomic<std::uint64_t> Hash = 0;
+        /// The number of valid frames in the call stack.
+        std::uint32_t FrameCount = 0;
+        /// Return addresses for the frames of the call stack.
+        void* Frames[MAX_FRAME_COUNT] = {};
+        /// Counts of allocations made from the call site.
+        AllocationCounts Counts = {};
+    };
+
+    /// Tracks memory allocations made through the global allocator.
+    /// All storage is statically sized so that tracking never itself
+    /// allocates through the allocator being tracked.
+    struct AllocationTracker
+    {
+        /// The maximum number of unique call sites that can be tracked.
+        /// Additional call sites are counted only in the overflow counts.
+        static constexpr std::size_t MAX_CALL_SITE_COUNT = 4096;
+        /// Index indicating an allocation wasn't attributed to any call site.
+        static constexpr std::uint32_t NO_CALL_SITE_INDEX = UINT32_MAX;
+
+        /// Gets the phase allocations on the current thread are attributed to.
+        /// @return The current compiler phase for this thread.
+        static CompilerPhase& CurrentPhase()
+        {
+            thread_local CompilerPhase current_phase = CompilerPhase::UNKNOWN;
+            return current_phase;
+        }
+
+        /// Records an allocation.
+        /// @param[in] byte_count - The number of bytes allocated.
+        /// @param[in] caller_address - The return address into the code that called the allocation function.
+        /// @return The index of the call site the allocation was attributed to.
+        ALLOCATION_TRACKER_NOINLINE static std::uint32_t RecordAllocation(const std::size_t byte_count, const void* const caller_address)
+        {
+            // UPDATE THE PHASE COUNTS.
+            CompilerPhase phase = CurrentPhase();
+            AllocationCounts& phase_counts = PhaseCounts[static_cast<std::size_t>(phase)];
+            phase_counts.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+            phase_counts.AllocatedByteCount.fetch_add(byte_count, std::memory_order_relaxed);
+            UpdatePeakLiveByteCount(LiveByteCount.fetch_add(byte_count, std::memory_order_relaxed) + byte_count);
+
+            // ATTRIBUTE THE ALLOCATION TO ITS CALL SITE.
+            // Capturing a call stack may itself allocate (for example, when a
+            // platform lazily loads unwinding support), so nested allocations
+            // are only counted per phase to avoid infinite recursion.
+            thread_local bool capturing_call_site = false;
+            if (capturing_call_site)
+            {
+                return NO_CALL_SITE_INDEX;
+            }
+            capturing_call_site = true;
+            std::uint32_t call_site_index = FindOrAddCallSite(caller_address);
+            capturing_call_site = false;
+
+            AllocationCounts& call_site_counts = (NO_CALL_SITE_INDEX == call_site_index) ? OverflowCallSiteCounts : CallSites[call_site_index].Counts;
+            call_site_counts.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+            call_site_counts.AllocatedByteCount.fetch_add(byte_count, std::memory_order_relaxed);
+            return call_site_index;
+        }
+
+        /// Records a deallocation.
+        /// @param[in] byte_count - The number of bytes deallocated.
+        /// @param[in] phase - The phase during which the memory was originally allocated.
+        /// @param[in] call_site_index - The call site from which the memory was originally allocated.
+        static void RecordDeallocation(const std::size_t byte_count, const CompilerPhase phase, const std::uint32_t call_site_index)
+        {
+            AllocationCounts& phase_counts = PhaseCounts[static_cast<std::size_t>(phase)];
+            phase_counts.DeallocationCount.fetch_add(1, std::memory_order_relaxed);
+            phase_counts.DeallocatedByteCount.fetch_add(byte_count, std::memory_order_relaxed);
+            LiveByteCount.fetch_sub(byte_count, std::memory_order_relaxed);
+
+            bool call_site_exists = (call_site_index < MAX_CALL_SITE_COUNT);
+            AllocationCounts& call_site_counts = call_site_exists ? CallSites[call_site_index].Counts : OverflowCallSiteCounts;
+            call_site_counts.DeallocationCount.fetch_add(1, std::memory_order_relaxed);
+            call_site_counts.DeallocatedByteCount.fetch_add(byte_count, std::memory_order_relaxed);
+        }
+
+        /// Gets a snapshot of the allocation counts for a phase.
+        /// @param[in] phase - The phase for which to get counts.
+        /// @return The current counts for the phase.
+        static AllocationCountsSnapshot GetPhaseCounts(const CompilerPhase phase)
+        {
+            const AllocationCounts& counts = PhaseCounts[static_cast<std::size_t>(phase)];
+            AllocationCountsSnapshot snapshot =
+            {
+                .AllocationCount = counts.AllocationCount.load(std::memory_order_relaxed),
+                .AllocatedByteCount = counts.AllocatedByteCount.load(std::memory_order_relaxed),
+                .DeallocationCount = counts.DeallocationCount.load(std::memory_order_relaxed),
+                .DeallocatedByteCount = counts.DeallocatedByteCount.load(std::memory_order_relaxed),
+            };
+            return snapshot;
+        }
+
+        /// Writes a report of allocations by phase and the top call sites by bytes allocated.
+        /// @param[in,out] file - The file to write the report to.
+        /// @param[in] top_call_site_count - The maximum number of call sites to include.
+        static void WriteReport(std::FILE* file, const std::size_t top_call_site_count)
+        {
+            // WRITE THE COUNTS FOR EACH PHASE.
+            // The phase column is as wide as the longest phase name so that the columns line up.
+            int phase_column_width = static_cast<int>(std::strlen("Phase"));
+            for (std::size_t phase_index = 0; phase_index < static_cast<std::size_t>(CompilerPhase::COUNT); ++phase_index)
+            {
+                int phase_name_length = static_cast<int>(std::strlen(GetCompilerPhaseName(static_cast<CompilerPhase>(phase_index))));
+                phase_column_width = std::max(phase_column_width, phase_name_length);
+            }
+            std::fprintf(file, "\nAllocations by phase:\n");
+            std::fprintf(file, "%-*s %12s %14s %12s %14s\n", phase_column_width, "Phase", "Allocations", "Bytes", "Frees", "Bytes Freed");
+            for (std::size_t phase_index = 0; phase_index < static_cast<std::size_t>(CompilerPhase::COUNT); ++phase_index)
+            {
+                CompilerPhase phase = static_cast<CompilerPhase>(phase_index);
+                AllocationCountsSnapshot counts = GetPhaseCounts(phase);
+                std::fprintf(
+                    file,
+                    "%-*s %12llu %14llu %12llu %14llu\n",
+                    phase_column_width,
+                    GetCompilerPhaseName(phase),
+                    static_cast<unsigned long long>(counts.AllocationCount),
+                    static_cast<unsigned long long>(counts.AllocatedByteCount),
+                    static_cast<unsigned long long>(counts.DeallocationCount),
+                    static_cast<unsigned long long>(counts.DeallocatedByteCount));
+            }
+            std::fprintf(
+                file,
+                "Live bytes: %llu, peak live bytes: %llu\n",
+                static_cast<unsigned long long>(LiveByteCount.load(std::memory_order_relaxed)),
+                static_cast<unsigned long long>(PeakLiveByteCount.load(std::memory_order_relaxed)));
+
+            // SORT THE CALL SITES BY BYTES ALLOCATED.
+            // A static array is used to avoid allocating while reporting on allocations.
+            static std::array<std::uint32_t, MAX_CALL_SITE_COUNT> sorted_call_site_indices;
+            std::size_t used_call_site_count = 0;
+            for (std::uint32_t call_site_index = 0; call_site_index < MAX_CALL_SITE_COUNT; ++call_site_index)
+            {
+                bool call_site_used = (0 != CallSites[call_site_index].Hash.load(std::memory_order_acquire));
+                if (call_site_used)
+                {
+                    sorted_call_site_indices[used_call_site_count] = call_site_index;
+                    ++used_call_site_count;
+                }
+            }
+            std::sort(
+                sorted_call_site_indices.begin(),
+                sorted_call_site_indices.begin() + used_call_site_count,
+                [](const std::uint32_t left_index, const std::uint32_t right_index)
+                {
+                    return CallSites[left_index].Counts.AllocatedByteCount.load() > CallSites[right_index].Counts.AllocatedByteCount.load();
+                });
+
+            // WRITE THE TOP CALL SITES.
+            std::size_t reported_call_site_count = std::min(top_call_site_count, used_call_site_count);
+            std::fprintf(file, "\nTop %zu of %zu allocation call sites by bytes:\n", reported_call_site_count, used_call_site_count);
+            for (std::size_t rank = 0; rank < reported_call_site_count; ++rank)
+            {
+                AllocationCallSite& call_site = CallSites[sorted_call_site_indices[rank]];
+                std::fprintf(
+                    file,
+                    "#%zu: %llu allocations, %llu bytes, %llu bytes still live\n",
+                    rank + 1,
+                    static_cast<unsigned long long>(call_site.Counts.AllocationCount.load()),
+                    static_cast<unsigned long long>(call_site.Counts.AllocatedByteCount.load()),
+                    static_cast<unsigned long long>(call_site.Counts.AllocatedByteCount.load() - call_site.Counts.DeallocatedByteCount.load()));
+                WriteCallStack(file, call_site);
+            }
+
+            // WRITE ANY ALLOCATIONS THAT COULDN'T BE ATTRIBUTED TO A CALL SITE.
+            std::uint64_t unattributed_allocation_count = OverflowCallSiteCounts.AllocationCount.load();
+            if (unattributed_allocation_count > 0)
+            {
+                std::fprintf(
+                    file,
+                    "Unattributed: %llu allocations, %llu bytes\n",
+                    static_cast<unsigned long long>(unattributed_allocation_count),
+                    static_cast<unsigned long long>(OverflowCallSiteCounts.AllocatedByteCount.load()));
+            }
+        }
+
+    private:
+        /// Finds the call site for the current call stack, adding it if it doesn't exist.
+        /// @param[in] caller_address - The return address into the code that called the allocation function.
+        /// @return The index of the call site; NO_CALL_SITE_INDEX if no more call sites can be tracked.
+        ALLOCATION_TRACKER_NOINLINE static std::uint32_t FindOrAddCallSite(const void* const caller_address)
+        {
+            // CAPTURE THE CURRENT CALL STACK.
+            // The first frames are within the tracker and allocation functions, which would be the same
+            // for every allocation, so the call site starts at the frame returning to the allocation's caller.
+            // The number of tracker frames is normally fixed (capturing, finding the call site, recording,
+            // allocating, and the allocation function), but the compiler may still turn the last call into
+            // a jump, so the frame is searched for.
+            constexpr unsigned long TRACKER_FRAME_COUNT = 5;
+            constexpr unsigned long CAPTURED_FRAME_COUNT = AllocationCallSite::MAX_FRAME_COUNT + TRACKER_FRAME_COUNT;
+            void* frames[CAPTURED_FRAME_COUNT] = {};
+            std::uint32_t captured_frame_count = CaptureCallStack(frames, CAPTURED_FRAME_COUNT);
+            std::uint32_t tracker_frame_count = std::min<std::uint32_t>(captured_frame_count, TRACKER_FRAME_COUNT);
+            for (std::uint32_t frame_index = 0; frame_index < captured_frame_count; ++frame_index)
+            {
+                if (caller_address == frames[frame_index])
+                {
+                    tracker_frame_count = frame_index;
+                    break;
+                }
+            }
+            void** call_site_frames = frames + tracker_frame_count;
+            std::uint32_t call_site_frame_count = std::min<std::uint32_t>(
+                captured_frame_count - tracker_frame_count,
+                static_cast<std::uint32_t>(AllocationCallSite::MAX_FRAME_COUNT));
+
+            // HASH THE CALL STACK.
+            // FNV-1a is used over the frame addresses.  Zero is reserved to mark unused call sites.
+            std::uint64_t hash = 14695981039346656037ull;
+            for (std::uint32_t frame_index = 0; frame_index < call_site_frame_count; ++frame_index)
+            {
+                hash ^= reinterpret_cast<std::uintptr_t>(call_site_frames[frame_index]);
+                hash *= 1099511628211ull;
+            }
+            if (0 == hash)
+            {
+                hash = 1;
+            }
+
+            // FIND OR CLAIM A SLOT FOR THE CALL SITE.
+            // Linear probing is used so that slots can be claimed with a single
+            // atomic compare-and-swap.  Frames are written by whichever thread
+            // claimed the slot; another thread racing on the same call site may
+            // briefly see incomplete frames, which only affects reporting.
+            std::size_t start_index = static_cast<std::size_t>(hash % MAX_CALL_SITE_COUNT);
+            for (std::size_t probe_count = 0; probe_count < MAX_CALL_SITE_COUNT; ++probe_count)
+            {
+                std::size_t call_site_index = (start_index + probe_count) % MAX_CALL_SITE_COUNT;
+                AllocationCallSite& call_site = CallSites[call_site_index];
+
+                std::uint64_t existing_hash = call_site.Hash.load(std::memory_order_acquire);
+                if (hash == existing_hash)
+                {
+                    return static_cast<std::uint32_t>(call_site_index);
+                }
+
+                bool slot_free = (0 == existing_hash);
+                if (slot_free)
+                {
+                    bool slot_claimed = call_site.Hash.compare_exchange_strong(existing_hash, hash, std::memory_order_acq_rel);
+                    if (slot_claimed)
+                    {
+                        call_site.FrameCount = call_site_frame_count;
+                        std::copy(call_site_frames, call_site_frames + call_site_frame_count, call_site.Frames);
+                        return static_cast<std::uint32_t>(call_site_index);
+                    }
+                    else if (hash == existing_hash)
+                    {
+                        // Another thread claimed the slot for this same call site.
+                        return static_cast<std::uint32_t>(call_site_index);
+                    }
+                }
+            }
+
+            return NO_CALL_SITE_INDEX;
+        }
+
+        /// Captures return addresses for the current call stack.
+        /// @param[out] frames - The frames to fill in.
+        /// @param[in] max_frame_count - The maximum number of frames to capture.
+        /// @return The number of frames captured.
+        ALLOCATION_TRACKER_NOINLINE static std::uint32_t CaptureCallStack(void** frames, const unsigned long max_frame_count)
+        {
+        #if _WIN32
+            return RtlCaptureStackBackTrace(0, max_frame_count, frames, nullptr);
+        #else
+            int captured_frame_count = backtrace(frames, static_cast<int>(max_frame_count));
+            return static_cast<std::uint32_t>(std::max(captured_frame_count, 0));
+        #endif
+        }
+
+        /// Writes the call stack for a call site.
+        /// @param[in,out] file - The file to write to.
+        /// @param[in] call_site - The call site whose frames to write.
+        static void WriteCallStack(std::FILE* file, const AllocationCallSite& call_site)
+        {
+        #if _WIN32
+            for (std::uint32_t frame_index = 0; frame_index < call_site.FrameCount; ++frame_index)
+            {
+                std::fprintf(file, "    %p\n", call_site.Frames[frame_index]);
+            }
+        #else
+            // backtrace_symbols_fd() is used since it writes symbol names without allocating.
+            // Function names are only available if the program is linked with -rdynamic.
+            std::fflush(file);
+            backtrace_symbols_fd(call_site.Frames, static_cast<int>(call_site.FrameCount), fileno(file));
+        #endif
+        }
+
+        /// Updates the peak number of live bytes if a new peak has been reached.
+        /// @param[in] live_byte_count - The current number of live bytes.
+        static void UpdatePeakLiveByteCount(const std::uint64_t live_byte_count)
+        {
+            std::uint64_t peak_live_byte_count = PeakLiveByteCount.load(std::memory_order_relaxed);
+            while (live_byte_count > peak_live_byte_count)
+            {
+                bool peak_updated = PeakLiveByteCount.compare_exchange_weak(peak_live_byte_count, live_byte_count, std::memory_order_relaxed);
+                if (peak_updated)
+                {
+                    break;
+                }
+            }
+        }
+
+        /// Counts of allocations for each compiler phase.
+        static inline std::array<AllocationCounts, static_cast<std::size_t>(CompilerPhase::COUNT)> PhaseCounts = {};
+        /// Call sites from which allocations have been made.
+        static inline std::array<AllocationCallSite, MAX_CALL_SITE_COUNT> CallSites = {};
+        /// Counts for allocations that couldn't be attributed to a tracked call site.
+        static inline AllocationCounts OverflowCallSiteCounts = {};
+        /// The number of bytes currently allocated.
+        static inline std::atomic<std::uint64_t> LiveByteCount = 0;
+        /// The maximum number of bytes that have been allocated at once.
+        static inline std::atomic<std::uint64_t> PeakLiveByteCount = 0;
+    };
+
+    /// Attributes allocations on the current thread to a compiler phase for
+    /// the lifetime of this object, restoring the previous phase afterwards.
+    struct ScopedCompilerPhase
+    {
+        /// Begins attributing allocations to the specified phase.
+        /// @param[in] phase - The phase to attribute allocations to.
+        explicit ScopedCompilerPhase(const CompilerPhase phase) :
+            PreviousPhase(AllocationTracker::CurrentPhase())
+        {
+            AllocationTracker::CurrentPhase() = phase;
+        }
+
+        /// Restores the previous phase.
+        ~ScopedCompilerPhase()
+        {
+            AllocationTracker::CurrentPhase() = PreviousPhase;
+        }
+
+        ScopedCompilerPhase(const ScopedCompilerPhase&) = delete;
+        ScopedCompilerPhase& operator=(const ScopedCompilerPhase&) = delete;
+
+        /// The phase that was active before this object was created.
+        CompilerPhase PreviousPhase;
+    };
+
+    /// Information stored immediately before each tracked allocation.
+    /// The size keeps returned memory aligned for any fundamental type.
+    struct alignas(alignof(std::max_align_t)) TrackedAllocationHeader
+    {
+        /// The start of the underlying block from the system allocator.
+        void* BlockStart = nullptr;
+        /// The number of bytes requested.
+        std::uint64_t ByteCount = 0;
+        /// The call site the allocation was attributed to.
+        std::uint32_t CallSiteIndex = AllocationTracker::NO_CALL_SITE_INDEX;
+        /// The phase the allocation was attributed to.
+        CompilerPhase Phase = CompilerPhase::UNKNOWN;
+    };
+
+    /// Allocates memory and records the allocation.
+    /// @param[in] byte_count - The number of bytes to allocate.
+    /// @param[in] alignment - The required alignment of the memory.
+    /// @param[in] caller_address - The return address into the code that called the allocation function.
+    /// @return The allocated memory; null if allocation failed.
+    ALLOCATION_TRACKER_NOINLINE inline void* AllocateTracked(const std::size_t byte_count, const std::size_t alignment, const void* const caller_address)
+    {
+        // ALLOCATE ENOUGH SPACE FOR THE HEADER AND ANY ALIGNMENT PADDING.
+        std::size_t header_byte_count = sizeof(TrackedAllocationHeader);
+        std::size_t padding_byte_count = (alignment > alignof(std::max_align_t)) ? alignment : 0;
+        void* block_start = std::malloc(header_byte_count + padding_byte_count + byte_count);
+        if (!block_start)
+        {
+            return nullptr;
+        }
+
+        // DETERMINE WHERE THE MEMORY FOR THE CALLER STARTS.
+        std::uintptr_t user_memory_address = reinterpret_cast<std::uintptr_t>(block_start) + header_byte_count;
+        if (padding_byte_count > 0)
+        {
+            user_memory_address = (user_memory_address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        }
+        void* user_memory = reinterpret_cast<void*>(user_memory_address);
+
+        // RECORD THE ALLOCATION.
+        TrackedAllocationHeader* header = reinterpret_cast<TrackedAllocationHeader*>(user_memory) - 1;
+        header->BlockStart = block_start;
+        header->ByteCount = byte_count;
+        header->Phase = AllocationTracker::CurrentPhase();
+        header->CallSiteIndex = AllocationTracker::RecordAllocation(byte_count, caller_address);
+        return user_memory;
+    }
+
+    /// Frees memory allocated by AllocateTracked() and records the deallocation.
+    /// @param[in] memory - The memory to free.  May be null.
+    inline void FreeTracked(void* memory)
+    {
+        if (!memory)
+        {
+            return;
+        }
+
+        TrackedAllocationHeader* header = reinterpret_cast<TrackedAllocationHeader*>(memory) - 1;
+        AllocationTracker::RecordDeallocation(static_cast<std::size_t>(header->ByteCount), header->Phase, header->CallSiteIndex);
+        std::free(header->BlockStart);
+    }
+}
+
+#if ALLOCATION_TRACKING
+
+// REPLACEMENTS FOR THE GLOBAL ALLOCATION FUNCTIONS.
+// These must only be defined in a single translation unit, which the unity
+// build guarantees by including this file once from main.cpp.
+
+// Each allocation function calls AllocateTracked() directly (rather than through
+// another allocation function) so that call stacks have the same shape for all of them.
+
+ALLOCATION_TRACKER_NOINLINE void* operator new(std::size_t byte_count)
+{
+    void* memory = DEBUGGING::AllocateTracked(byte_count, alignof(std::max_align_t), ALLOCATION_TRACKER_RETURN_ADDRESS());
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+ALLOCATION_TRACKER_NOINLINE void* operator new[](std::size_t byte_count)
+{
+    void* memory = DEBUGGING::AllocateTracked(byte_count, alignof(std::max_align_t), ALLOCATION_TRACKER_RETURN_ADDRESS());
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+ALLOCATION_TRACKER_NOINLINE void* operator new(std::size_t byte_count, const std::nothrow_t&) noexcept
+{
+    return DEBUGGING::AllocateTracked(byte_count, alignof(std::max_align_t), ALLOCATION_TRACKER_RETURN_ADDRESS());
+}
+
+ALLOCATION_TRACKER_NOINLINE void* operator new[](std::size_t byte_count, const std::nothrow_t&) noexcept
+{
+    return DEBUGGING::AllocateTracked(byte_count, alignof(std::max_align_t), ALLOCATION_TRACKER_RETURN_ADDRESS());
+}
+
+ALLOCATION_TRACKER_NOINLINE void* operator new(std::size_t byte_count, std::align_val_t alignment)
+{
+    void* memory = DEBUGGING::AllocateTracked(byte_count, static_cast<std::size_t>(alignment), ALLOCATION_TRACKER_RETURN_ADDRESS());
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+ALLOCATION_TRACKER_NOINLINE void* operator new[](std::size_t byte_count, std::align_val_t alignment)
+{
+    void* memory = DEBUGGING::AllocateTracked(byte_count, static_cast<std::size_t>(alignment), ALLOCATION_TRACKER_RETURN_ADDRESS());
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+ALLOCATION_TRACKER_NOINLINE void* operator new(std::size_t byte_count, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return DEBUGGING::AllocateTracked(byte_count, static_cast<std::size_t>(alignment), ALLOCATION_TRACKER_RETURN_ADDRESS());
+}
+
+ALLOCATION_TRACKER_NOINLINE void* operator new[](std::size_t byte_count, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return DEBUGGING::AllocateTracked(byte_count, static_cast<std::size_t>(alignment), ALLOCATION_TRACKER_RETURN_ADDRESS());
+}
+
+void operator delete(void* memory) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    DEBUGGING::FreeTracked(memory);
+}
+
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Tokenization/IdentifierInterner.h"
+#include "Tokenization/TokenStream.h"
+
+namespace DEBUGGING
+{
+    /// Verifies that interning identifiers from many threads at once gives every
+    /// thread the same identifiers, and that IDs don't depend on thread scheduling.
+    /// Only used by builds with internal checks (see INTERNAL_CHECKS).
+    struct IdentifierInternerChecker
+    {
+        /// The number of threads interning at once, regardless of how many jobs the compiler runs.
+        static constexpr std::size_t THREAD_COUNT = 8;
+
+        /// Checks interning the identifiers in some tokens.
+        /// Several threads intern every identifier into one interner at once, each starting at
+        /// a different identifier so that they race to add the same ones.  The results are then
+        /// compared across threads and against interning the identifiers on a single thread.
+        /// @param[in] token_stream - The tokens whose identifiers are interned.
+        /// @return A description of the first problem found; null if interning is consistent.
+        static std::optional<std::string> Check(const TOKENIZATION::TokenStream& token_stream)
+        {
+            using namespace TOKENIZATION;
+
+            // FIND THE IDENTIFIERS.
+            std::vector<std::string_view> identifier_texts;
+            for (const Token& token : token_stream.Tokens)
+            {
+                if (TokenType::IDENTIFIER == token.Type)
+                {
+                    identifier_texts.push_back(token.Value);
+                }
+            }
+
+            // INTERN THEM FROM SEVERAL THREADS AT ONCE.
+            IdentifierInterner interner;
+            std::vector<std::vector<const InternedIdentifier*>> identifiers_by_thread(
+                THREAD_COUNT,
+                std::vector<const InternedIdentifier*>(identifier_texts.size(), nullptr));
+            std::vector<std::thread> threads;
+            for (std::size_t thread_index = 0; thread_index < THREAD_COUNT; ++thread_index)
+            {
+                threads.emplace_back([&, thread_index]()
+                {
+                    std::size_t identifier_count = identifier_texts.size();
+                    std::size_t start_index = identifier_count * thread_index / THREAD_COUNT;
+                    for (std::size_t offset = 0; offset < identifier_count; ++offset)
+                    {
+                        std::size_t identifier_index = (start_index + offset) % identifier_count;
+                        identifiers_by_thread[thread_index][identifier_index] = interner.Intern(identifier_texts[identifier_index]);
+                    }
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            // CHECK THAT EVERY THREAD GOT THE SAME IDENTIFIERS.
+            std::unordered_map<std::string_view, const InternedIdentifier*> identifiers_by_text;
+            for (std::size_t identifier_index = 0; identifier_index < identifier_texts.size(); ++identifier_index)
+            {
+                std::string_view identifier_text = identifier_texts[identifier_index];
+                const InternedIdentifier* identifier = identifiers_by_thread.front()[identifier_index];
+                if (!identifier || identifier_text != identifier->Text)
+                {
+                    return "Identifier " + std::string(identifier_text) + " was interned with the wrong text.";
+                }
+                for (const std::vector<const InternedIdentifier*>& thread_identifiers : identifiers_by_thread)
+                {
+                    if (identifier != thread_identifiers[identifier_index])
+                    {
+                        return "Threads got different copies of identifier " + std::string(identifier_text) + ".";
+                    }
+                }
+                auto [existing_identifier, identifier_added] = identifiers_by_text.emplace(identifier->Text, identifier);
+                if (identifier != existing_identifier->second)
+                {
+                    return "Identifier " + std::string(identifier_text) + " was interned more than once.";
+                }
+            }
+
+            // CHECK THAT IDS MATCH INTERNING ON ONE THREAD.
+            // Identifiers are interned in reverse order here to confirm the order doesn't matter.
+            std::size_t identifier_count = interner.AssignIds();
+            IdentifierInterner single_thread_interner;
+            for (auto identifier_text = identifier_texts.rbegin(); identifier_text != identifier_texts.rend(); ++identifier_text)
+            {
+                single_thread_interner.Intern(*identifier_text);
+            }
+            std::size_t single_thread_identifier_count = single_thread_interner.AssignIds();
+            if (identifier_count != identifiers_by_text.size() || single_thread_identifier_count != identifier_count)
+            {
+                return "Interned " + std::to_string(identifier_count) + " identifiers from several threads and " +
+                    std::to_string(single_thread_identifier_count) + " from one, but there are " +
+                    std::to_string(identifiers_by_text.size()) + " distinct identifiers.";
+            }
+            for (const auto& [identifier_text, identifier] : identifiers_by_text)
+            {
+                const InternedIdentifier* single_thread_identifier = single_thread_interner.Intern(identifier_text);
+                if (identifier->Id != single_thread_identifier->Id || identifier != interner.GetIdentifier(identifier->Id))
+                {
+                    return "Identifier " + std::string(identifier_text) + " got a different ID when interned from several threads.";
+                }
+            }
+            return std::nullopt;
+        }
+    };
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/// Checks of the compiler's own data structures are compiled in only when requested
+/// (for example, via -DINTERNAL_CHECKS=1), since they're slow and only meant for testing
+/// the compiler itself.  Builds with them run every check on each translation unit.
+#ifndef INTERNAL_CHECKS
+    #define INTERNAL_CHECKS 0
+#endif
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Metaprogramming/ProgramIndex.h"
+
+namespace DEBUGGING
+{
+    /// Verifies that a program index answers queries the same way as walking
+    /// the whole program, both when first built and after incremental updates.
+    /// Only used by builds with internal checks (see INTERNAL_CHECKS).
+    struct ProgramIndexChecker
+    {
+        /// Checks the index for a program.
+        /// An index is built and compared against a walk of the program.  Then every
+        /// function is removed from a copy of the program through its index, which must
+        /// leave nothing behind, and the definitions are added back one at a time, after
+        /// which the index must again match a walk of the copy.
+        /// @param[in] program - The program to check.
+        /// @return A description of the first difference found; null if the index is correct.
+        static std::optional<std::string> Check(const Program& program)
+        {
+            using namespace METAPROGRAMMING;
+
+            // CHECK A NEWLY BUILT INDEX.
+            ProgramIndex index = ProgramIndex::Build(program);
+            ExpectedResults expected_results = ExpectedResults::Collect(program);
+            std::optional<std::string> difference = expected_results.Compare(index);
+            if (difference)
+            {
+                return "Built index: " + *difference;
+            }
+
+            // CHECK THAT REMOVING EVERY FUNCTION LEAVES NOTHING IN THE INDEX.
+            Program edited_program = program;
+            ProgramIndex edited_index = ProgramIndex::Build(edited_program);
+            std::set<std::string> function_names;
+            for (const auto& [function_name, function_declaration] : edited_program.FunctionDeclarationsByName)
+            {
+                function_names.insert(function_name);
+            }
+            std::vector<FunctionDefinition> function_definitions;
+            for (const auto& [function_name, function_definition] : edited_program.FunctionsByName)
+            {
+                function_names.insert(function_name);
+                function_definitions.push_back(function_definition);
+            }
+            for (const std::string& function_name : function_names)
+            {
+                edited_index.RemoveFunction(edited_program, function_name);
+            }
+            difference = ExpectedResults().CompareKeys(edited_index, expected_results);
+            if (difference)
+            {
+                return "Index after removing all functions: " + *difference;
+            }
+
+            // CHECK THAT ADDING DEFINITIONS BACK MATCHES THE EDITED PROGRAM.
+            for (FunctionDefinition& function_definition : function_definitions)
+            {
+                edited_index.SetFunction(edited_program, std::move(function_definition));
+            }
+            difference = ExpectedResults::Collect(edited_program).Compare(edited_index);
+            if (difference)
+            {
+                return "Index after adding functions back: " + *difference;
+            }
+            return std::nullopt;
+        }
+
+    private:
+        /// The results every query should return, found by walking a program.
+        /// Expressions and declarations found for a function are compared
+        /// regardless of their order.
+        struct ExpectedResults
+        {
+            /// Walks a program to find what each query should return.
+            /// @param[in] program - The program.
+            /// @return The expected results.
+            static ExpectedResults Collect(const Program& program)
+            {
+                ExpectedResults expected_results;
+                for (const auto& [function_name, function_declaration] : program.FunctionDeclarationsByName)
+                {
+                    expected_results.AddHeader(function_declaration);
+                }
+                for (const auto& [function_name, function_definition] : program.FunctionsByName)
+                {
+                    expected_results.AddHeader(function_definition.Header);
+                    for (const VariableDeclaration& parameter : function_definition.Header.Parameters)
+                    {
+                        expected_results.DeclarationsByType[parameter.DataType][function_name].push_back(&parameter);
+                    }
+                    for (const Statement& statement : function_definition.Body.Statements)
+                    {
+                        expected_results.AddStatement(function_name, statement);
+                    }
+                }
+                return expected_results;
+            }
+
+            /// Compares an index against the expected results for every query.
+            /// @param[in] index - The index.
+            /// @return A description of the first difference found; null if the index matches.
+            std::optional<std::string> Compare(const METAPROGRAMMING::ProgramIndex& index) const
+            {
+                return CompareKeys(index, *this);
+            }
+
+            /// Compares an index against these results for queries about every key in some results.
+            /// @param[in] index - The index.
+            /// @param[in] keys - The results whose keys are queried.
+            /// @return A description of the first difference found; null if the index matches.
+            std::optional<std::string> CompareKeys(const METAPROGRAMMING::ProgramIndex& index, const ExpectedResults& keys) const
+            {
+                for (const auto& [return_type, function_names] : keys.FunctionNamesByReturnType)
+                {
+                    if (index.FindFunctionsReturning(return_type) != FindOrEmpty(FunctionNamesByReturnType, return_type))
+                    {
+                        return "Functions returning " + return_type + " differ.";
+                    }
+                }
+                for (const auto& [parameter_type, function_names] : keys.FunctionNamesByParameterType)
+                {
+                    if (index.FindFunctionsWithParameterType(parameter_type) != FindOrEmpty(FunctionNamesByParameterType, parameter_type))
+                    {
+                        return "Functions with parameter type " + parameter_type + " differ.";
+                    }
+                }
+                for (const auto& [callee_name, calls] : keys.CallsByCalleeName)
+                {
+                    if (!SameContents(index.FindCallsTo(callee_name), FindOrEmpty(CallsByCalleeName, callee_name)))
+                    {
+                        return "Calls to " + callee_name + " differ.";
+                    }
+                }
+                for (const auto& [name, references] : keys.ReferencesByName)
+                {
+                    if (!SameContents(index.FindReferencesTo(name), FindOrEmpty(ReferencesByName, name)))
+                    {
+                        return "References to " + name + " differ.";
+                    }
+                }
+                for (const auto& [data_type, declarations] : keys.DeclarationsByType)
+                {
+                    if (!SameContents(index.FindDeclarationsOfType(data_type), FindOrEmpty(DeclarationsByType, data_type)))
+                    {
+                        return "Declarations of type " + data_type + " differ.";
+                    }
+                }
+                return std::nullopt;
+            }
+
+            /// The names of functions by return type.
+            std::map<std::string, std::set<std::string>> FunctionNamesByReturnType = {};
+            /// The names of functions by the types of their parameters.
+            std::map<std::string, std::set<std::string>> FunctionNamesByParameterType = {};
+            /// Call expressions by the name of the function called.
+            std::map<std::string, METAPROGRAMMING::ExpressionsByFunction> CallsByCalleeName = {};
+            /// Identifier expressions by name.
+            std::map<std::string, METAPROGRAMMING::ExpressionsByFunction> ReferencesByName = {};
+            /// Parameter and local variable declarations by type.
+            std::map<std::string, METAPROGRAMMING::DeclarationsByFunction> DeclarationsByType = {};
+
+        private:
+            /// Finds an entry in the expected results.
+            /// @param[in] results - The results to search.
+            /// @param[in] key - The key to find.
+            /// @return The entry, if found; an empty entry otherwise.
+            template <typename Entry>
+            static const Entry& FindOrEmpty(const std::map<std::string, Entry>& results, const std::string& key)
+            {
+                static const Entry EMPTY_ENTRY = {};
+                auto entry = results.find(key);
+                return (results.end() == entry) ? EMPTY_ENTRY : entry->second;
+            }
+
+            /// Determines if two results have the same nodes for each function, in any order.
+            /// @param[in] left_results - One set of results.
+            /// @param[in] right_results - The other set of results.
+            /// @return True if the results contain the same nodes; false otherwise.
+            template <typename Node>
+            static bool SameContents(
+                const std::map<std::string, std::vector<const Node*>>& left_results,
+                const std::map<std::string, std::vector<const Node*>>& right_results)
+            {
+                if (left_results.size() != right_results.size())
+                {
+                    return false;
+                }
+                for (const auto& [function_name, left_nodes] : left_results)
+                {
+                    auto right_nodes = right_results.find(function_name);
+                    if (right_results.end() == right_nodes)
+                    {
+                        return false;
+                    }
+                    std::vector<const Node*> sorted_left_nodes = left_nodes;
+                    std::vector<const Node*> sorted_right_nodes = right_nodes->second;
+                    std::sort(sorted_left_nodes.begin(), sorted_left_nodes.end());
+                    std::sort(sorted_right_nodes.begin(), sorted_right_nodes.end());
+                    if (sorted_left_nodes != sorted_right_nodes)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            /// Adds a function's header to the expected results.
+            /// @param[in] header - The header of the function's declaration or definition.
+            void AddHeader(const FunctionHeader& header)
+            {
+                FunctionNamesByReturnType[header.ReturnType].insert(header.Name);
+                for (const VariableDeclaration& parameter : header.Parameters)
+                {
+                    FunctionNamesByParameterType[parameter.DataType].insert(header.Name);
+                }
+            }
+
+            /// Adds a statement and everything in it to the expected results.
+            /// @param[in] function_name - The name of the function containing the statement.
+            /// @param[in] statement - The statement.
+            void AddStatement(const std::string& function_name, const Statement& statement)
+            {
+                if (StatementKind::DECLARATION == statement.Kind)
+                {
+                    DeclarationsByType[statement.Declaration.DataType][function_name].push_back(&statement.Declaration);
+                }
+                for (const std::optional<Expression>* expression : { &statement.Value, &statement.Condition, &statement.Step })
+                {
+                    if (*expression)
+                    {
+                        AddExpression(function_name, **expression);
+                    }
+                }
+                for (const Statement& nested_statement : statement.Body)
+                {
+                    AddStatement(function_name, nested_statement);
+                }
+            }
+
+            /// Adds an expression and its operands to the expected results.
+            /// @param[in] function_name - The name of the function containing the expression.
+            /// @param[in] expression - The expression.
+            void AddExpression(const std::string& function_name, const Expression& expression)
+            {
+                if (ExpressionKind::CALL == expression.Kind)
+                {
+                    CallsByCalleeName[expression.Text][function_name].push_back(&expression);
+                }
+                else if (ExpressionKind::IDENTIFIER == expression.Kind)
+                {
+                    ReferencesByName[expression.Text][function_name].push_back(&expression);
+                }
+                for (const Expression& operand : expression.Operands)
+                {
+                    AddExpression(function_name, operand);
+                }
+            }
+        };
+    };
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace EVALUATION
+{
+    /// Identifies a register within a bytecode function's frame.
+    using RegisterIndex = std::uint16_t;
+
+    /// The register index used when an instruction has no result or operand.
+    constexpr RegisterIndex NO_REGISTER = std::numeric_limits<RegisterIndex>::max();
+    /// The maximum number of registers or instructions in a function, so indices fit in instructions.
+    constexpr std::size_t MAXIMUM_FUNCTION_SIZE = NO_REGISTER;
+
+    /// The operations of the bytecode.
+    ///
+    /// Registers hold 64-bit values, which are kept sign-extended from the width of
+    /// their type as in the IR.  Operations whose result depends on that width use
+    /// the instruction's shift, which is 64 minus the width in bits.
+    enum class Opcode : std::uint8_t
+    {
+        /// Destination = Left.
+        MOVE = 0,
+
+        // BINARY OPERATIONS.
+        // Destination = Left op Right, normalized for the width.
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        SIGNED_DIVIDE,
+        UNSIGNED_DIVIDE,
+        SIGNED_REMAINDER,
+        UNSIGNED_REMAINDER,
+        AND,
+        OR,
+        XOR,
+        SHIFT_LEFT,
+        ARITHMETIC_SHIFT_RIGHT,
+        LOGICAL_SHIFT_RIGHT,
+
+        // UNARY OPERATIONS.
+        // Destination = op Left, normalized for the width.
+        NEGATE,
+        NOT,
+        /// Zero-extends Left from the width.
+        ZERO_EXTEND,
+        /// Sign-extends Left from the width, discarding higher bits.
+        TRUNCATE,
+
+        // COMPARISONS.
+        // Destination = 1 if Left op Right; 0 otherwise.  Greater-than comparisons swap their operands.
+        EQUAL,
+        NOT_EQUAL,
+        SIGNED_LESS,
+        SIGNED_LESS_EQUAL,
+        UNSIGNED_LESS,
+        UNSIGNED_LESS_EQUAL,
+
+        // MEMORY.
+        /// Loads a value of the width from the address in Left, sign-extending it.
+        LOAD,
+        /// Stores the low bytes of Right for the width to the address in Left.
+        STORE,
+
+        /// Calls the function for the call site numbered Left, putting any result in Destination.
+        CALL,
+
+        // CONTROL FLOW.
+        /// Continues at the instruction numbered Left.
+        JUMP,
+        /// Continues at the instruction numbered Right if Left is zero.
+        JUMP_IF_ZERO,
+        /// Returns Left, or nothing for NO_REGISTER.
+        RETURN,
+
+        /// The number of opcodes.  Must remain last.
+        COUNT
+    };
+
+    /// A single bytecode instruction.
+    /// Kept to 8 bytes so that code stays compact in the cache while being interpreted.
+    struct BytecodeInstruction
+    {
+        /// The operation to perform.
+        Opcode Operation = Opcode::MOVE;
+        /// 64 minus the width of the operation's values in bits (0 for 64-bit values).
+        std::uint8_t Shift = 0;
+        /// The register written, if any.
+        RegisterIndex Destination = NO_REGISTER;
+        /// The first operand.
+        RegisterIndex Left = NO_REGISTER;
+        /// The second operand.
+        RegisterIndex Right = NO_REGISTER;
+    };
+    static_assert(sizeof(BytecodeInstruction) == 8);
+
+    /// A call from one bytecode function to another.
+    struct CallSite
+    {
+        /// The name of the function called.
+        std::string CalleeName = "";
+        /// The index of the function called in the module, or NO_FUNCTION if it isn't defined there.
+        std::uint32_t CalleeIndex = 0;
+        /// The registers holding the arguments, in order.
+        std::vector<RegisterIndex> ArgumentRegisters = {};
+    };
+
+    /// A stack slot's memory, allocated each time a function is called.
+    struct StackSlotAddress
+    {
+        /// The register to hold the address of the slot's memory.
+        RegisterIndex Register = NO_REGISTER;
+        /// The offset of the slot's memory in the function's frame.
+        std::uint32_t FrameOffset = 0;
+    };
+
+    /// A string literal's memory, shared by all calls.
+    struct StringLiteralAddress
+    {
+        /// The register holding the address of the literal's memory.
+        RegisterIndex Register = NO_REGISTER;
+        /// The size of the literal's memory, including its null terminator.
+        std::uint32_t SizeInBytes = 0;
+    };
+
+    /// A function compiled to bytecode.
+    struct BytecodeFunction
+    {
+        /// The name of the function.
+        std::string Name = "";
+        /// The number of parameters, which are passed in the first registers.
+        std::size_t ParameterCount = 0;
+        /// True if the function returns a value.
+        bool ReturnsValue = false;
+        /// The instructions, starting with the first to run.
+        std::vector<BytecodeInstruction> Code = {};
+        /// The values of registers when the function is called, which hold constants
+        /// and string literal addresses.  Its size is the number of registers.
+        std::vector<std::int64_t> InitialRegisters = {};
+        /// The string literals whose addresses are in registers, which depend on the module's layout.
+        std::vector<StringLiteralAddress> StringLiterals = {};
+        /// The stack slots to allocate when the function is called.
+        std::vector<StackSlotAddress> StackSlots = {};
+        /// The size of the memory for stack slots.
+        std::uint32_t FrameSize = 0;
+        /// The functions called, numbered by CALL instructions.
+        std::vector<CallSite> CallSites = {};
+    };
+
+    /// Functions compiled to bytecode, along with memory they share.
+    struct BytecodeModule
+    {
+        /// The index used for functions called but not defined in the module.
+        static constexpr std::uint32_t NO_FUNCTION = std::numeric_limits<std::uint32_t>::max();
+        /// The lowest valid address, so that null pointers are never valid.
+        static constexpr std::int64_t FIRST_ADDRESS = 16;
+
+        /// The functions.
+        std::vector<BytecodeFunction> Functions = {};
+        /// The index of each function by name.
+        std::unordered_map<std::string, std::uint32_t> FunctionIndicesByName = {};
+        /// Memory holding string literals, starting at address 0.  It can be read but not
+        /// written, and stack memory for calls starts after it.
+        std::vector<std::uint8_t> ReadOnlyData = {};
+    };
+}
@@ -0,0 +1,546 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Evaluation/Bytecode.h"
+#include "IntermediateRepresentation/Function.h"
+
+namespace EVALUATION
+{
+    /// Compiles functions to register-based bytecode for evaluation at compile time.
+    ///
+    /// Functions are compiled from their IR, which is lowered from the parsed
+    /// FunctionDefinitions, so evaluation has exactly the semantics of compiled code
+    /// and benefits from any optimization.  Every SSA value gets its own register,
+    /// with constants in registers initialized when the function is called, so
+    /// instructions only ever refer to registers.  Phis become moves on incoming edges.
+    struct BytecodeCompiler
+    {
+        /// Compiles all functions in a module.
+        /// @param[in] module - The module.
+        /// @param[out] error_message - Why the module couldn't be compiled, if it couldn't.
+        /// @return The compiled functions, if successful; null otherwise.
+        static std::optional<BytecodeModule> Compile(const INTERMEDIATE_REPRESENTATION::Module& module, std::string& error_message)
+        {
+            BytecodeModule bytecode_module;
+            bytecode_module.ReadOnlyData.assign(BytecodeModule::FIRST_ADDRESS, 0);
+
+            // COMPILE EACH FUNCTION.
+            std::unordered_map<std::string, std::int64_t> string_addresses;
+            for (const INTERMEDIATE_REPRESENTATION::Function& function : module.Functions)
+            {
+                FunctionCompiler function_compiler(function, bytecode_module, string_addresses);
+                std::optional<BytecodeFunction> bytecode_function = function_compiler.Compile(error_message);
+                if (!bytecode_function)
+                {
+                    return std::nullopt;
+                }
+                bytecode_module.FunctionIndicesByName.emplace(function.Name, static_cast<std::uint32_t>(bytecode_module.Functions.size()));
+                bytecode_module.Functions.push_back(std::move(*bytecode_function));
+            }
+
+            // RESOLVE CALLS.
+            // Calls to functions defined elsewhere only fail if they're actually made.
+            for (BytecodeFunction& bytecode_function : bytecode_module.Functions)
+            {
+                for (CallSite& call_site : bytecode_function.CallSites)
+                {
+                    auto callee_index = bytecode_module.FunctionIndicesByName.find(call_site.CalleeName);
+                    call_site.CalleeIndex = (bytecode_module.FunctionIndicesByName.end() != callee_index) ? callee_index->second : BytecodeModule::NO_FUNCTION;
+                }
+            }
+            return bytecode_module;
+        }
+
+    private:
+        /// Compiles a single function.
+        class FunctionCompiler
+        {
+        public:
+            /// Prepares to compile a function.
+            /// @param[in] function - The function.
+            /// @param[in,out] bytecode_module - The module to add string literals to.
+            /// @param[in,out] string_addresses - Addresses of string literals already in the module.
+            explicit FunctionCompiler(
+                const INTERMEDIATE_REPRESENTATION::Function& function,
+                BytecodeModule& bytecode_module,
+                std::unordered_map<std::string, std::int64_t>& string_addresses) :
+                Source(function),
+                Module(bytecode_module),
+                StringAddresses(string_addresses)
+            {}
+
+            /// Compiles the function.
+            /// @param[out] error_message - Why the function couldn't be compiled, if it couldn't.
+            /// @return The compiled function, if successful; null otherwise.
+            std::optional<BytecodeFunction> Compile(std::string& error_message)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                Output.Name = Source.Name;
+                Output.ParameterCount = Source.ParameterTypes.size();
+                Output.ReturnsValue = (ValueType::VOID != Source.ReturnType);
+
+                // ASSIGN REGISTERS TO PARAMETERS.
+                // Arguments are copied into the first registers.
+                Registers.assign(Source.Values.size(), NO_REGISTER);
+                Output.InitialRegisters.assign(Output.ParameterCount, 0);
+                for (const ValueId instruction_id : Source.Blocks[Function::ENTRY_BLOCK_ID].Instructions)
+                {
+                    const Instruction& instruction = Source.Values[instruction_id];
+                    if (InstructionKind::PARAMETER == instruction.Kind)
+                    {
+                        Registers[instruction_id] = static_cast<RegisterIndex>(instruction.Immediate);
+                    }
+                }
+
+                // GENERATE EACH BLOCK.
+                // Jumps are patched once every block's location is known.
+                BlockStarts.assign(Source.Blocks.size(), 0);
+                for (BlockId block_id = 0; block_id < Source.Blocks.size(); ++block_id)
+                {
+                    BlockStarts[block_id] = Output.Code.size();
+                    CompileBlock(block_id);
+                }
+                for (const auto& [instruction_index, target_block_id] : JumpFixups)
+                {
+                    BytecodeInstruction& jump = Output.Code[instruction_index];
+                    RegisterIndex target = static_cast<RegisterIndex>(BlockStarts[target_block_id]);
+                    if (Opcode::JUMP == jump.Operation)
+                    {
+                        jump.Left = target;
+                    }
+                    else
+                    {
+                        jump.Right = target;
+                    }
+                }
+
+                // VERIFY THE FUNCTION FITS IN THE BYTECODE.
+                bool too_large =
+                    Output.InitialRegisters.size() >= MAXIMUM_FUNCTION_SIZE ||
+                    Output.Code.size() >= MAXIMUM_FUNCTION_SIZE ||
+                    Output.CallSites.size() >= MAXIMUM_FUNCTION_SIZE;
+                if (too_large)
+                {
+                    error_message = "Function " + Source.Name + " is too large to evaluate at compile time";
+                    return std::nullopt;
+                }
+
+                // The frame is kept 16-byte aligned for any nested calls.
+                Output.FrameSize = (FrameSize + 15) / 16 * 16;
+                return std::move(Output);
+            }
+
+        private:
+            /// Compiles the instructions in a block.
+            /// @param[in] block_id - The block.
+            void CompileBlock(const INTERMEDIATE_REPRESENTATION::BlockId block_id)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                for (const ValueId instruction_id : Source.Blocks[block_id].Instructions)
+                {
+                    const Instruction& instruction = Source.Values[instruction_id];
+                    std::uint8_t shift = GetShift(instruction.Type);
+                    switch (instruction.Kind)
+                    {
+                        case InstructionKind::PARAMETER:
+                        case InstructionKind::PHI:
+                            // Parameters are passed in their registers, and phis are written on incoming edges.
+                            break;
+                        case InstructionKind::STACK_SLOT:
+                        {
+                            // Memory is allocated when the function is called, so its address is set then.
+                            std::uint32_t alignment = (instruction.Immediate >= 16) ? 16 : 8;
+                            FrameSize = (FrameSize + alignment - 1) / alignment * alignment;
+                            Output.StackSlots.push_back(StackSlotAddress { .Register = GetRegister(instruction_id), .FrameOffset = FrameSize });
+                            FrameSize += static_cast<std::uint32_t>(instruction.Immediate);
+                            break;
+                        }
+                        case InstructionKind::STRING_ADDRESS:
+                        {
+                            // String literals are at fixed addresses, so they're constants.
+                            RegisterIndex register_index = GetRegister(instruction_id);
+                            const std::string& string_literal = Source.StringLiterals[static_cast<std::size_t>(instruction.Immediate)];
+                            Output.InitialRegisters[register_index] = GetStringAddress(string_literal);
+                            Output.StringLiterals.push_back(StringLiteralAddress
+                            {
+                                .Register = register_index,
+                                .SizeInBytes = static_cast<std::uint32_t>(string_literal.size() + 1),
+                            });
+                            break;
+                        }
+                        case InstructionKind::ADD:
+                        case InstructionKind::SUBTRACT:
+                        case InstructionKind::MULTIPLY:
+                        case InstructionKind::SIGNED_DIVIDE:
+                        case InstructionKind::UNSIGNED_DIVIDE:
+                        case InstructionKind::SIGNED_REMAINDER:
+                        case InstructionKind::UNSIGNED_REMAINDER:
+                        case InstructionKind::AND:
+                        case InstructionKind::OR:
+                        case InstructionKind::XOR:
+                        case InstructionKind::SHIFT_LEFT:
+                        case InstructionKind::ARITHMETIC_SHIFT_RIGHT:
+                        case InstructionKind::LOGICAL_SHIFT_RIGHT:
+                            Emit(GetBinaryOpcode(instruction.Kind), shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 0), GetOperandRegister(instruction_id, 1));
+                            break;
+                        case InstructionKind::NEGATE:
+                            Emit(Opcode::NEGATE, shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 0));
+                            break;
+                        case InstructionKind::NOT:
+                            Emit(Opcode::NOT, shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 0));
+                            break;
+                        case InstructionKind::EQUAL:
+                        case InstructionKind::NOT_EQUAL:
+                        case InstructionKind::SIGNED_LESS:
+                        case InstructionKind::SIGNED_LESS_EQUAL:
+                        case InstructionKind::UNSIGNED_LESS:
+                        case InstructionKind::UNSIGNED_LESS_EQUAL:
+                            Emit(GetComparisonOpcode(instruction.Kind), shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 0), GetOperandRegister(instruction_id, 1));
+                            break;
+                        case InstructionKind::SIGNED_GREATER:
+                        case InstructionKind::SIGNED_GREATER_EQUAL:
+                        case InstructionKind::UNSIGNED_GREATER:
+                        case InstructionKind::UNSIGNED_GREATER_EQUAL:
+                            Emit(GetComparisonOpcode(instruction.Kind), shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 1), GetOperandRegister(instruction_id, 0));
+                            break;
+                        case InstructionKind::SIGN_EXTEND:
+                            // Values are already sign-extended to 64 bits.
+                            Emit(Opcode::MOVE, shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 0));
+                            break;
+                        case InstructionKind::ZERO_EXTEND:
+                        {
+                            ValueId operand = Source.GetOperand(instruction_id, 0);
+                            Emit(Opcode::ZERO_EXTEND, GetShift(Source.Values[operand].Type), GetRegister(instruction_id), GetRegister(operand));
+                            break;
+                        }
+                        case InstructionKind::TRUNCATE:
+                            Emit(Opcode::TRUNCATE, shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 0));
+                            break;
+                        case InstructionKind::LOAD:
+                            Emit(Opcode::LOAD, shift, GetRegister(instruction_id), GetOperandRegister(instruction_id, 0));
+                            break;
+                        case InstructionKind::STORE:
+                        {
+                            ValueId stored_value = Source.GetOperand(instruction_id, 1);
+                            Emit(Opcode::STORE, GetShift(Source.Values[stored_value].Type), NO_REGISTER, GetOperandRegister(instruction_id, 0), GetRegister(stored_value));
+                            break;
+                        }
+                        case InstructionKind::CALL:
+                        {
+                            CallSite call_site = { .CalleeName = Source.CalleeNames[static_cast<std::size_t>(instruction.Immediate)] };
+                            for (const ValueId argument : Source.GetOperands(instruction_id))
+                            {
+                                call_site.ArgumentRegisters.push_back(GetRegister(argument));
+                            }
+                            RegisterIndex result = (ValueType::VOID != instruction.Type) ? GetRegister(instruction_id) : NO_REGISTER;
+                            Emit(Opcode::CALL, shift, result, static_cast<RegisterIndex>(Output.CallSites.size()));
+                            Output.CallSites.push_back(std::move(call_site));
+                            break;
+                        }
+                        case InstructionKind::JUMP:
+                        {
+                            BlockId successor = Source.Blocks[block_id].Successors.front();
+                            EmitEdgeMoves(block_id, successor);
+                            JumpUnlessNext(block_id, successor);
+                            break;
+                        }
+                        case InstructionKind::BRANCH:
+                        {
+                            // The true edge's moves follow the test, with the false edge's after them.
+                            BlockId true_successor = Source.Blocks[block_id].Successors[0];
+                            BlockId false_successor = Source.Blocks[block_id].Successors[1];
+                            RegisterIndex condition = GetOperandRegister(instruction_id, 0);
+                            if (!HasEdgeMoves(block_id, false_successor))
+                            {
+                                JumpFixups.emplace_back(Emit(Opcode::JUMP_IF_ZERO, 0, NO_REGISTER, condition), false_successor);
+                                EmitEdgeMoves(block_id, true_successor);
+                                JumpUnlessNext(block_id, true_successor);
+                                break;
+                            }
+
+                            std::size_t false_jump_index = Emit(Opcode::JUMP_IF_ZERO, 0, NO_REGISTER, condition);
+                            EmitEdgeMoves(block_id, true_successor);
+                            JumpFixups.emplace_back(Emit(Opcode::JUMP, 0), true_successor);
+                            Output.Code[false_jump_index].Right = static_cast<RegisterIndex>(Output.Code.size());
+                            EmitEdgeMoves(block_id, false_successor);
+                            JumpUnlessNext(block_id, false_successor);
+                            break;
+                        }
+                        case InstructionKind::RETURN:
+                        {
+                            RegisterIndex result = (instruction.OperandCount > 0) ? GetOperandRegister(instruction_id, 0) : NO_REGISTER;
+                            Emit(Opcode::RETURN, 0, NO_REGISTER, result);
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+            }
+
+            /// Checks if an edge needs any moves for phis.
+            /// @param[in] block_id - The block being left.
+            /// @param[in] successor - The block being entered.
+            /// @return True if any phi in the successor needs a move; false otherwise.
+            bool HasEdgeMoves(const INTERMEDIATE_REPRESENTATION::BlockId block_id, const INTERMEDIATE_REPRESENTATION::BlockId successor)
+            {
+                return !GetEdgeMoves(block_id, successor).empty();
+            }
+
+            /// Gets the moves for the phis of a block entered along an edge.
+            /// @param[in] block_id - The block being left.
+            /// @param[in] successor - The block being entered.
+            /// @return Pairs of destination and source registers, to be moved together.
+            std::vector<std::pair<RegisterIndex, RegisterIndex>> GetEdgeMoves(const INTERMEDIATE_REPRESENTATION::BlockId block_id, const INTERMEDIATE_REPRESENTATION::BlockId successor)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                // A block listed twice as a predecessor has the same phi operands for both edges.
+                const BasicBlock& successor_block = Source.Blocks[successor];
+                std::size_t predecessor_index = static_cast<std::size_t>(
+                    std::find(successor_block.Predecessors.begin(), successor_block.Predecessors.end(), block_id) - successor_block.Predecessors.begin());
+                std::vector<std::pair<RegisterIndex, RegisterIndex>> moves;
+                for (const ValueId phi : successor_block.Instructions)
+                {
+                    if (InstructionKind::PHI != Source.Values[phi].Kind)
+                    {
+                        break;
+                    }
+                    RegisterIndex destination = GetRegister(phi);
+                    RegisterIndex source = GetOperandRegister(phi, predecessor_index);
+                    if (destination != source)
+                    {
+                        moves.emplace_back(destination, source);
+                    }
+                }
+                return moves;
+            }
+
+            /// Emits the moves for the phis of a block entered along an edge.
+            /// They're made as if all at once, so no move overwrites a register before the moves reading it.
+            /// @param[in] block_id - The block being left.
+            /// @param[in] successor - The block being entered.
+            void EmitEdgeMoves(const INTERMEDIATE_REPRESENTATION::BlockId block_id, const INTERMEDIATE_REPRESENTATION::BlockId successor)
+            {
+                std::vector<std::pair<RegisterIndex, RegisterIndex>> moves = GetEdgeMoves(block_id, successor);
+                auto is_read = [&](const RegisterIndex register_index)
+                {
+                    return std::any_of(moves.begin(), moves.end(), [&](const auto& move) { return move.second == register_index; });
+                };
+                while (!moves.empty())
+                {
+                    // MAKE A MOVE WHOSE DESTINATION ISN'T READ BY ANOTHER.
+                    auto ready_move = std::find_if(moves.begin(), moves.end(), [&](const auto& move) { return !is_read(move.first); });
+                    if (ready_move != moves.end())
+                    {
+                        Emit(Opcode::MOVE, 0, ready_move->first, ready_move->second);
+                        moves.erase(ready_move);
+                        continue;
+                    }
+
+                    // BREAK A CYCLE.
+                    // Every remaining destination is read by another move, so some moves form a cycle.
+                    // Copying one of their sources to a spare register lets it be overwritten.
+                    if (NO_REGISTER == MoveCycleRegister)
+                    {
+                        MoveCycleRegister = AddRegister(0);
+                    }
+                    RegisterIndex cycle_source = moves.front().second;
+                    Emit(Opcode::MOVE, 0, MoveCycleRegister, cycle_source);
+                    for (auto& move : moves)
+                    {
+                        if (move.second == cycle_source)
+                        {
+                            move.second = MoveCycleRegister;
+                        }
+                    }
+                }
+            }
+
+            /// Jumps to a block unless it immediately follows another.
+            /// @param[in] block_id - The block being left.
+            /// @param[in] target_block_id - The block to continue to.
+            void JumpUnlessNext(const INTERMEDIATE_REPRESENTATION::BlockId block_id, const INTERMEDIATE_REPRESENTATION::BlockId target_block_id)
+            {
+                if (block_id + 1 != target_block_id)
+                {
+                    JumpFixups.emplace_back(Emit(Opcode::JUMP, 0), target_block_id);
+                }
+            }
+
+            /// Adds an instruction.
+            /// @param[in] operation - The operation.
+            /// @param[in] shift - 64 minus the width of the operation's values in bits.
+            /// @param[in] destination - The register written, if any.
+            /// @param[in] left - The first operand, if any.
+            /// @param[in] right - The second operand, if any.
+            /// @return The index of the instruction.
+            std::size_t Emit(
+                const Opcode operation,
+                const std::uint8_t shift,
+                const RegisterIndex destination = NO_REGISTER,
+                const RegisterIndex left = NO_REGISTER,
+                const RegisterIndex right = NO_REGISTER)
+            {
+                Output.Code.push_back(BytecodeInstruction { .Operation = operation, .Shift = shift, .Destination = destination, .Left = left, .Right = right });
+                return Output.Code.size() - 1;
+            }
+
+            /// Gets the register for an operand of an instruction.
+            /// @param[in] instruction_id - The instruction.
+            /// @param[in] operand_index - The index of the operand.
+            /// @return The register.
+            RegisterIndex GetOperandRegister(const INTERMEDIATE_REPRESENTATION::ValueId instruction_id, const std::size_t operand_index)
+            {
+                return GetRegister(Source.GetOperand(instruction_id, operand_index));
+            }
+
+            /// Gets the register for a value, assigning one if needed.
+            /// Constants are assigned registers initialized to their values.
+            /// @param[in] value - The value.
+            /// @return The register.
+            RegisterIndex GetRegister(const INTERMEDIATE_REPRESENTATION::ValueId value)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                if (NO_REGISTER == Registers[value])
+                {
+                    // Undefined values may be anything, so they're 0.
+                    const Instruction& instruction = Source.Values[value];
+                    std::int64_t initial_value = (InstructionKind::CONSTANT == instruction.Kind) ? instruction.Immediate : 0;
+                    Registers[value] = AddRegister(initial_value);
+                }
+                return Registers[value];
+            }
+
+            /// Adds a register to the function.
+            /// Any registers past the maximum are reported once the function is compiled.
+            /// @param[in] initial_value - The value of the register when the function is called.
+            /// @return The register.
+            RegisterIndex AddRegister(const std::int64_t initial_value)
+            {
+                RegisterIndex register_index = static_cast<RegisterIndex>(std::min(Output.InitialRegisters.size(), MAXIMUM_FUNCTION_SIZE - 1));
+                Output.InitialRegisters.push_back(initial_value);
+                return register_index;
+            }
+
+            /// Gets the address of a string literal, adding it to the module if needed.
+            /// @param[in] string_literal - The contents of the literal, without a terminator.
+            /// @return The address of the null-terminated string.
+            std::int64_t GetStringAddress(const std::string& string_literal)
+            {
+                auto [string_address, string_added] = StringAddresses.try_emplace(string_literal, static_cast<std::int64_t>(Module.ReadOnlyData.size()));
+                if (string_added)
+                {
+                    Module.ReadOnlyData.insert(Module.ReadOnlyData.end(), string_literal.begin(), string_literal.end());
+                    Module.ReadOnlyData.push_back(0);
+                }
+                return string_address->second;
+            }
+
+            /// Gets the shift for the width of a type.
+            /// @param[in] type - The type.
+            /// @return 64 minus the width of the type in bits, or 0 for types without values.
+            static std::uint8_t GetShift(const INTERMEDIATE_REPRESENTATION::ValueType type)
+            {
+                std::size_t size_in_bytes = INTERMEDIATE_REPRESENTATION::GetValueTypeSizeInBytes(type);
+                return (0 == size_in_bytes) ? 0 : static_cast<std::uint8_t>(64 - 8 * size_in_bytes);
+            }
+
+            /// Gets the opcode for a binary operation.
+            /// @param[in] kind - The kind of instruction.
+            /// @return The opcode.
+            static Opcode GetBinaryOpcode(const INTERMEDIATE_REPRESENTATION::InstructionKind kind)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                switch (kind)
+                {
+                    case InstructionKind::SUBTRACT:
+                        return Opcode::SUBTRACT;
+                    case InstructionKind::MULTIPLY:
+                        return Opcode::MULTIPLY;
+                    case InstructionKind::SIGNED_DIVIDE:
+                        return Opcode::SIGNED_DIVIDE;
+                    case InstructionKind::UNSIGNED_DIVIDE:
+                        return Opcode::UNSIGNED_DIVIDE;
+                    case InstructionKind::SIGNED_REMAINDER:
+                        return Opcode::SIGNED_REMAINDER;
+                    case InstructionKind::UNSIGNED_REMAINDER:
+                        return Opcode::UNSIGNED_REMAINDER;
+                    case InstructionKind::AND:
+                        return Opcode::AND;
+                    case InstructionKind::OR:
+                        return Opcode::OR;
+                    case InstructionKind::XOR:
+                        return Opcode::XOR;
+                    case InstructionKind::SHIFT_LEFT:
+                        return Opcode::SHIFT_LEFT;
+                    case InstructionKind::ARITHMETIC_SHIFT_RIGHT:
+                        return Opcode::ARITHMETIC_SHIFT_RIGHT;
+                    case InstructionKind::LOGICAL_SHIFT_RIGHT:
+                        return Opcode::LOGICAL_SHIFT_RIGHT;
+                    default:
+                        return Opcode::ADD;
+                }
+            }
+
+            /// Gets the opcode for a comparison.  Greater-than comparisons use
+            /// the opcode for the opposite less-than comparison with swapped operands.
+            /// @param[in] kind - The kind of comparison.
+            /// @return The opcode.
+            static Opcode GetComparisonOpcode(const INTERMEDIATE_REPRESENTATION::InstructionKind kind)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                switch (kind)
+                {
+                    case InstructionKind::NOT_EQUAL:
+                        return Opcode::NOT_EQUAL;
+                    case InstructionKind::SIGNED_LESS:
+                    case InstructionKind::SIGNED_GREATER:
+                        return Opcode::SIGNED_LESS;
+                    case InstructionKind::SIGNED_LESS_EQUAL:
+                    case InstructionKind::SIGNED_GREATER_EQUAL:
+                        return Opcode::SIGNED_LESS_EQUAL;
+                    case InstructionKind::UNSIGNED_LESS:
+                    case InstructionKind::UNSIGNED_GREATER:
+                        return Opcode::UNSIGNED_LESS;
+                    case InstructionKind::UNSIGNED_LESS_EQUAL:
+                    case InstructionKind::UNSIGNED_GREATER_EQUAL:
+                        return Opcode::UNSIGNED_LESS_EQUAL;
+                    default:
+                        return Opcode::EQUAL;
+                }
+            }
+
+            /// The function being compiled.
+            const INTERMEDIATE_REPRESENTATION::Function& Source;
+            /// The module to add string literals to.
+            BytecodeModule& Module;
+            /// Addresses of string literals already in the module.
+            std::unordered_map<std::string, std::int64_t>& StringAddresses;
+            /// The compiled function.
+            BytecodeFunction Output = {};
+            /// The register for each value, or NO_REGISTER if not yet assigned.
+            std::vector<RegisterIndex> Registers = {};
+            /// The register for breaking cycles of moves, or NO_REGISTER if none is needed yet.
+            RegisterIndex MoveCycleRegister = NO_REGISTER;
+            /// The size of the memory for stack slots so far.
+            std::uint32_t FrameSize = 0;
+            /// The index of each block's first instruction.
+            std::vector<std::size_t> BlockStarts = {};
+            /// Jumps to patch, with the blocks they target.
+            std::vector<std::pair<std::size_t, INTERMEDIATE_REPRESENTATION::BlockId>> JumpFixups = {};
+        };
+    };
+}
@@ -0,0 +1,520 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Evaluation/Bytecode.h"
+
+/// Instructions are dispatched with computed gotos where the compiler supports
+/// them (as GCC and Clang do), since jumping directly from each operation to the
+/// next predicts better than returning to a switch.  Defining this as 0 (for example,
+/// via -DCOMPUTED_GOTO_DISPATCH=0) uses the portable switch instead.
+#ifndef COMPUTED_GOTO_DISPATCH
+    #if __GNUC__
+        #define COMPUTED_GOTO_DISPATCH 1
+    #else
+        #define COMPUTED_GOTO_DISPATCH 0
+    #endif
+#endif
+
+namespace EVALUATION
+{
+    /// Limits on the work done evaluating a call, so that code that doesn't
+    /// terminate or allocates without bound fails rather than hanging the compiler.
+    struct EvaluationBudget
+    {
+        /// The maximum number of instructions executed.
+        std::uint64_t MaximumStepCount = 1'000'000'000;
+        /// The maximum memory for registers, stack slots, and string literals.
+        std::size_t MaximumMemorySizeInBytes = 64 * 1024 * 1024;
+    };
+
+    /// Runs bytecode functions.
+    ///
+    /// Pointers are addresses in memory private to each call, so evaluated code can't
+    /// affect the compiler.  Anything that would be undefined behavior at runtime
+    /// (division by zero, out-of-range shifts, and accesses outside of string
+    /// literals and live stack slots) stops evaluation with an error, as do calls
+    /// to functions without bytecode.  Calls don't recurse in the interpreter itself,
+    /// so deep recursion in evaluated code is only limited by the memory budget.
+    struct BytecodeInterpreter
+    {
+        /// Calls a function.
+        /// @param[in] module - The module containing the function.
+        /// @param[in] function_name - The name of the function.
+        /// @param[in] arguments - The arguments, normalized for the parameters' types.
+        /// @param[in] budget - Limits on the work done.
+        /// @param[out] error_message - Why evaluation failed, if it did.
+        /// @return The returned value (0 for functions without a result), if successful; null otherwise.
+        static std::optional<std::int64_t> Call(
+            const BytecodeModule& module,
+            const std::string_view function_name,
+            const std::span<const std::int64_t> arguments,
+            const EvaluationBudget& budget,
+            std::string& error_message)
+        {
+            // FIND THE FUNCTION.
+            auto function_index = module.FunctionIndicesByName.find(std::string(function_name));
+            if (module.FunctionIndicesByName.end() == function_index)
+            {
+                error_message = "Function " + std::string(function_name) + " isn't defined";
+                return std::nullopt;
+            }
+            const BytecodeFunction& entry_function = module.Functions[function_index->second];
+            if (arguments.size() != entry_function.ParameterCount)
+            {
+                error_message = "Function " + entry_function.Name + " takes " + std::to_string(entry_function.ParameterCount) + " arguments";
+                return std::nullopt;
+            }
+
+            Interpreter interpreter(module, budget);
+            return interpreter.Run(entry_function, arguments, error_message);
+        }
+
+    private:
+        /// A call being evaluated.
+        struct Frame
+        {
+            /// The function called.
+            const BytecodeFunction* Function = nullptr;
+            /// The index of the function's first register in the register stack.
+            std::size_t RegisterBase = 0;
+            /// The address of the function's stack slot memory, which is freed on return.
+            std::size_t MemoryBase = 0;
+            /// The index of the caller's instruction to continue at on return.
+            std::size_t ReturnInstructionIndex = 0;
+            /// The caller's register for the result, if any.
+            RegisterIndex ResultRegister = NO_REGISTER;
+        };
+
+        /// Evaluates calls within a module.
+        class Interpreter
+        {
+        public:
+            /// Prepares to evaluate a call.
+            /// @param[in] module - The module containing the functions.
+            /// @param[in] budget - Limits on the work done.
+            explicit Interpreter(const BytecodeModule& module, const EvaluationBudget& budget) :
+                Module(module),
+                Budget(budget),
+                Memory(module.ReadOnlyData),
+                WritableMemoryStart(AlignUp(module.ReadOnlyData.size())),
+                MemoryTop(WritableMemoryStart)
+            {}
+
+            /// Evaluates a call.
+            /// @param[in] function - The function to call.
+            /// @param[in] arguments - The arguments, which must match the function's parameters.
+            /// @param[out] error_message - Why evaluation failed, if it did.
+            /// @return The returned value, if successful; null otherwise.
+            std::optional<std::int64_t> Run(const BytecodeFunction& function, const std::span<const std::int64_t> arguments, std::string& error_message)
+            {
+                if (!EnterFunction(function, 0, NO_REGISTER))
+                {
+                    error_message = "Evaluating " + function.Name + " exceeded the memory budget of " + std::to_string(Budget.MaximumMemorySizeInBytes) + " bytes";
+                    return std::nullopt;
+                }
+                std::copy(arguments.begin(), arguments.end(), RegisterStack.begin());
+
+                // SET UP THE INTERPRETER'S STATE.
+                // The current function's state is kept in locals so the compiler can keep them in registers.
+                const BytecodeFunction* current_function = &function;
+                const BytecodeInstruction* code = current_function->Code.data();
+                const BytecodeInstruction* next_instruction = code;
+                const BytecodeInstruction* instruction = nullptr;
+                std::int64_t* registers = RegisterStack.data();
+                std::uint8_t* memory = Memory.data();
+                std::uint64_t remaining_step_count = Budget.MaximumStepCount;
+                const char* failure = nullptr;
+                const std::string* failed_callee_name = nullptr;
+
+                // DEFINE HOW INSTRUCTIONS ARE DISPATCHED.
+            #if COMPUTED_GOTO_DISPATCH
+                // The addresses must be in the same order as the opcodes.
+                static const void* const OPERATION_ADDRESSES[] =
+                {
+                    &&MOVE_OPERATION,
+                    &&ADD_OPERATION,
+                    &&SUBTRACT_OPERATION,
+                    &&MULTIPLY_OPERATION,
+                    &&SIGNED_DIVIDE_OPERATION,
+                    &&UNSIGNED_DIVIDE_OPERATION,
+                    &&SIGNED_REMAINDER_OPERATION,
+                    &&UNSIGNED_REMAINDER_OPERATION,
+                    &&AND_OPERATION,
+                    &&OR_OPERATION,
+                    &&XOR_OPERATION,
+                    &&SHIFT_LEFT_OPERATION,
+                    &&ARITHMETIC_SHIFT_RIGHT_OPERATION,
+                    &&LOGICAL_SHIFT_RIGHT_OPERATION,
+                    &&NEGATE_OPERATION,
+                    &&NOT_OPERATION,
+                    &&ZERO_EXTEND_OPERATION,
+                    &&TRUNCATE_OPERATION,
+                    &&EQUAL_OPERATION,
+                    &&NOT_EQUAL_OPERATION,
+                    &&SIGNED_LESS_OPERATION,
+                    &&SIGNED_LESS_EQUAL_OPERATION,
+                    &&UNSIGNED_LESS_OPERATION,
+                    &&UNSIGNED_LESS_EQUAL_OPERATION,
+                    &&LOAD_OPERATION,
+                    &&STORE_OPERATION,
+                    &&CALL_OPERATION,
+                    &&JUMP_OPERATION,
+                    &&JUMP_IF_ZERO_OPERATION,
+                    &&RETURN_OPERATION,
+                };
+                static_assert(std::size(OPERATION_ADDRESSES) == static_cast<std::size_t>(Opcode::COUNT));
+                #define OPERATION(name) name##_OPERATION
+                #define DISPATCH() \
+                    if (0 == remaining_step_count--) goto step_budget_exceeded; \
+                    instruction = next_instruction++; \
+                    goto *OPERATION_ADDRESSES[static_cast<std::size_t>(instruction->Operation)]
+            #else
+                #define OPERATION(name) case Opcode::name
+                #define DISPATCH() goto dispatch
+            #endif
+                #define FAIL(message) failure = message; goto evaluation_failed
+
+                // RUN INSTRUCTIONS UNTIL THE FIRST CALL RETURNS.
+            #if COMPUTED_GOTO_DISPATCH
+                DISPATCH();
+            #else
+            dispatch:
+                if (0 == remaining_step_count--) goto step_budget_exceeded;
+                instruction = next_instruction++;
+                switch (instruction->Operation)
+            #endif
+                {
+                    OPERATION(MOVE):
+                        registers[instruction->Destination] = registers[instruction->Left];
+                        DISPATCH();
+                    OPERATION(ADD):
+                        registers[instruction->Destination] = Normalize(Unsigned(registers[instruction->Left]) + Unsigned(registers[instruction->Right]), instruction->Shift);
+                        DISPATCH();
+                    OPERATION(SUBTRACT):
+                        registers[instruction->Destination] = Normalize(Unsigned(registers[instruction->Left]) - Unsigned(registers[instruction->Right]), instruction->Shift);
+                        DISPATCH();
+                    OPERATION(MULTIPLY):
+                        registers[instruction->Destination] = Normalize(Unsigned(registers[instruction->Left]) * Unsigned(registers[instruction->Right]), instruction->Shift);
+                        DISPATCH();
+                    OPERATION(SIGNED_DIVIDE):
+                    OPERATION(SIGNED_REMAINDER):
+                    {
+                        // The most negative value for the width is the only one whose negation overflows.
+                        std::int64_t dividend = registers[instruction->Left];
+                        std::int64_t divisor = registers[instruction->Right];
+                        if (0 == divisor)
+                        {
+                            FAIL("division by zero");
+                        }
+                        if (-1 == divisor && (std::numeric_limits<std::int64_t>::min() >> instruction->Shift) == dividend)
+                        {
+                            FAIL("signed division overflow");
+                        }
+                        std::int64_t result = (Opcode::SIGNED_DIVIDE == instruction->Operation) ? dividend / divisor : dividend % divisor;
+                        registers[instruction->Destination] = Normalize(Unsigned(result), instruction->Shift);
+                        DISPATCH();
+                    }
+                    OPERATION(UNSIGNED_DIVIDE):
+                    OPERATION(UNSIGNED_REMAINDER):
+                    {
+                        std::uint64_t dividend = ZeroExtend(registers[instruction->Left], instruction->Shift);
+                        std::uint64_t divisor = ZeroExtend(registers[instruction->Right], instruction->Shift);
+                        if (0 == divisor)
+                        {
+                            FAIL("division by zero");
+                        }
+                        std::uint64_t result = (Opcode::UNSIGNED_DIVIDE == instruction->Operation) ? dividend / divisor : dividend % divisor;
+                        registers[instruction->Destination] = Normalize(result, instruction->Shift);
+                        DISPATCH();
+                    }
+                    OPERATION(AND):
+                        registers[instruction->Destination] = registers[instruction->Left] & registers[instruction->Right];
+                        DISPATCH();
+                    OPERATION(OR):
+                        registers[instruction->Destination] = registers[instruction->Left] | registers[instruction->Right];
+                        DISPATCH();
+                    OPERATION(XOR):
+                        registers[instruction->Destination] = registers[instruction->Left] ^ registers[instruction->Right];
+                        DISPATCH();
+                    OPERATION(SHIFT_LEFT):
+                    OPERATION(ARITHMETIC_SHIFT_RIGHT):
+                    OPERATION(LOGICAL_SHIFT_RIGHT):
+                    {
+                        std::int64_t shift_amount = registers[instruction->Right];
+                        if (shift_amount < 0 || shift_amount >= 64 - instruction->Shift)
+                        {
+                            FAIL("shift by an out-of-range amount");
+                        }
+                        std::int64_t value = registers[instruction->Left];
+                        std::uint64_t result = 0;
+                        switch (instruction->Operation)
+                        {
+                            case Opcode::SHIFT_LEFT:
+                                result = Unsigned(value) << shift_amount;
+                                break;
+                            case Opcode::ARITHMETIC_SHIFT_RIGHT:
+                                result = Unsigned(value >> shift_amount);
+                                break;
+                            default:
+                                result = ZeroExtend(value, instruction->Shift) >> shift_amount;
+                                break;
+                        }
+                        registers[instruction->Destination] = Normalize(result, instruction->Shift);
+                        DISPATCH();
+                    }
+                    OPERATION(NEGATE):
+                        registers[instruction->Destination] = Normalize(0 - Unsigned(registers[instruction->Left]), instruction->Shift);
+                        DISPATCH();
+                    OPERATION(NOT):
+                        registers[instruction->Destination] = ~registers[instruction->Left];
+                        DISPATCH();
+                    OPERATION(ZERO_EXTEND):
+                        registers[instruction->Destination] = static_cast<std::int64_t>(ZeroExtend(registers[instruction->Left], instruction->Shift));
+                        DISPATCH();
+                    OPERATION(TRUNCATE):
+                        registers[instruction->Destination] = Normalize(Unsigned(registers[instruction->Left]), instruction->Shift);
+                        DISPATCH();
+                    OPERATION(EQUAL):
+                        registers[instruction->Destination] = (registers[instruction->Left] == registers[instruction->Right]);
+                        DISPATCH();
+                    OPERATION(NOT_EQUAL):
+                        registers[instruction->Destination] = (registers[instruction->Left] != registers[instruction->Right]);
+                        DISPATCH();
+                    OPERATION(SIGNED_LESS):
+                        registers[instruction->Destination] = (registers[instruction->Left] < registers[instruction->Right]);
+                        DISPATCH();
+                    OPERATION(SIGNED_LESS_EQUAL):
+                        registers[instruction->Destination] = (registers[instruction->Left] <= registers[instruction->Right]);
+                        DISPATCH();
+                    OPERATION(UNSIGNED_LESS):
+                        registers[instruction->Destination] = (Unsigned(registers[instruction->Left]) < Unsigned(registers[instruction->Right]));
+                        DISPATCH();
+                    OPERATION(UNSIGNED_LESS_EQUAL):
+                        registers[instruction->Destination] = (Unsigned(registers[instruction->Left]) <= Unsigned(registers[instruction->Right]));
+                        DISPATCH();
+                    OPERATION(LOAD):
+                    {
+                        // Values are read as little-endian, as on the target.
+                        std::uint64_t address = Unsigned(registers[instruction->Left]);
+                        std::size_t size_in_bytes = (64 - instruction->Shift) / 8;
+                        if (address < BytecodeModule::FIRST_ADDRESS || address > MemoryTop - size_in_bytes)
+                        {
+                            FAIL("read outside of valid memory");
+                        }
+                        std::uint64_t value = 0;
+                        std::memcpy(&value, memory + address, size_in_bytes);
+                        registers[instruction->Destination] = Normalize(value, instruction->Shift);
+                        DISPATCH();
+                    }
+                    OPERATION(STORE):
+                    {
+                        std::uint64_t address = Unsigned(registers[instruction->Left]);
+                        std::size_t size_in_bytes = (64 - instruction->Shift) / 8;
+                        if (address < WritableMemoryStart || address > MemoryTop - size_in_bytes)
+                        {
+                            FAIL("write outside of stack memory");
+                        }
+                        std::uint64_t value = Unsigned(registers[instruction->Right]);
+                        std::memcpy(memory + address, &value, size_in_bytes);
+                        DISPATCH();
+                    }
+                    OPERATION(CALL):
+                    {
+                        // FIND THE FUNCTION CALLED.
+                        const CallSite& call_site = current_function->CallSites[instruction->Left];
+                        if (BytecodeModule::NO_FUNCTION == call_site.CalleeIndex)
+                        {
+                            failed_callee_name = &call_site.CalleeName;
+                            FAIL("call to a function that can't be evaluated: ");
+                        }
+                        const BytecodeFunction& callee = Module.Functions[call_site.CalleeIndex];
+                        if (call_site.ArgumentRegisters.size() != callee.ParameterCount)
+                        {
+                            failed_callee_name = &call_site.CalleeName;
+                            FAIL("call with the wrong number of arguments to ");
+                        }
+
+                        // ENTER THE FUNCTION.
+                        // Registers and memory may move when they grow, so pointers to them are updated.
+                        std::size_t caller_register_base = Frames.back().RegisterBase;
+                        std::size_t return_instruction_index = static_cast<std::size_t>(next_instruction - code);
+                        if (!EnterFunction(callee, return_instruction_index, instruction->Destination))
+                        {
+                            goto memory_budget_exceeded;
+                        }
+                        registers = RegisterStack.data() + Frames.back().RegisterBase;
+                        memory = Memory.data();
+                        const std::int64_t* caller_registers = RegisterStack.data() + caller_register_base;
+                        for (std::size_t argument_index = 0; argument_index < call_site.ArgumentRegisters.size(); ++argument_index)
+                        {
+                            registers[argument_index] = caller_registers[call_site.ArgumentRegisters[argument_index]];
+                        }
+                        current_function = &callee;
+                        code = callee.Code.data();
+                        next_instruction = code;
+                        DISPATCH();
+                    }
+                    OPERATION(JUMP):
+                        next_instruction = code + instruction->Left;
+                        DISPATCH();
+                    OPERATION(JUMP_IF_ZERO):
+                        if (0 == registers[instruction->Left])
+                        {
+                            next_instruction = code + instruction->Right;
+                        }
+                        DISPATCH();
+                    OPERATION(RETURN):
+                    {
+                        // LEAVE THE FUNCTION.
+                        std::int64_t result = (NO_REGISTER == instruction->Left) ? 0 : registers[instruction->Left];
+                        Frame returning_frame = Frames.back();
+                        Frames.pop_back();
+                        RegisterStack.resize(returning_frame.RegisterBase);
+                        MemoryTop = returning_frame.MemoryBase;
+                        if (Frames.empty())
+                        {
+                            return result;
+                        }
+
+                        // CONTINUE IN THE CALLER.
+                        current_function = Frames.back().Function;
+                        code = current_function->Code.data();
+                        next_instruction = code + returning_frame.ReturnInstructionIndex;
+                        registers = RegisterStack.data() + Frames.back().RegisterBase;
+                        if (NO_REGISTER != returning_frame.ResultRegister)
+                        {
+                            registers[returning_frame.ResultRegister] = result;
+                        }
+                        DISPATCH();
+                    }
+            #if !COMPUTED_GOTO_DISPATCH
+                    default:
+                        FAIL("invalid instruction");
+            #endif
+                }
+
+                #undef FAIL
+                #undef DISPATCH
+                #undef OPERATION
+
+                // REPORT WHY EVALUATION STOPPED.
+            evaluation_failed:
+                error_message = "Evaluating " + current_function->Name + " failed: " + failure;
+                if (failed_callee_name)
+                {
+                    error_message += *failed_callee_name;
+                }
+                return std::nullopt;
+            step_budget_exceeded:
+                error_message = "Evaluating " + function.Name + " exceeded the budget of " + std::to_string(Budget.MaximumStepCount) + " steps";
+                return std::nullopt;
+            memory_budget_exceeded:
+                error_message = "Evaluating " + function.Name + " exceeded the memory budget of " + std::to_string(Budget.MaximumMemorySizeInBytes) + " bytes";
+                return std::nullopt;
+            }
+
+        private:
+            /// Allocates a frame for a call.
+            /// @param[in] function - The function called.
+            /// @param[in] return_instruction_index - The index of the caller's instruction to continue at on return.
+            /// @param[in] result_register - The caller's register for the result, if any.
+            /// @return True if the frame was allocated; false if it would exceed the memory budget.
+            bool EnterFunction(const BytecodeFunction& function, const std::size_t return_instruction_index, const RegisterIndex result_register)
+            {
+                // CHECK THE MEMORY BUDGET.
+                std::size_t register_base = RegisterStack.size();
+                std::size_t memory_base = MemoryTop;
+                std::size_t memory_size = memory_base + function.FrameSize;
+                std::size_t register_size = sizeof(std::int64_t) * (register_base + function.InitialRegisters.size());
+                std::size_t frame_size = sizeof(Frame) * (Frames.size() + 1);
+                if (memory_size + register_size + frame_size > Budget.MaximumMemorySizeInBytes)
+                {
+                    return false;
+                }
+
+                // ALLOCATE REGISTERS AND MEMORY.
+                // Memory is cleared so that evaluation is deterministic even if code reads uninitialized memory.
+                RegisterStack.insert(RegisterStack.end(), function.InitialRegisters.begin(), function.InitialRegisters.end());
+                if (Memory.size() < memory_size)
+                {
+                    Memory.resize(std::max(memory_size, 2 * Memory.size()));
+                }
+                std::fill(Memory.begin() + static_cast<std::ptrdiff_t>(memory_base), Memory.begin() + static_cast<std::ptrdiff_t>(memory_size), std::uint8_t(0));
+                MemoryTop = memory_size;
+                for (const StackSlotAddress& stack_slot : function.StackSlots)
+                {
+                    RegisterStack[register_base + stack_slot.Register] = static_cast<std::int64_t>(memory_base + stack_slot.FrameOffset);
+                }
+
+                Frames.push_back(Frame
+                {
+                    .Function = &function,
+                    .RegisterBase = register_base,
+                    .MemoryBase = memory_base,
+                    .ReturnInstructionIndex = return_instruction_index,
+                    .ResultRegister = result_register,
+                });
+                return true;
+            }
+
+            /// Rounds an address up to keep stack memory 16-byte aligned.
+            /// @param[in] address - The address.
+            /// @return The aligned address.
+            static std::size_t AlignUp(const std::size_t address)
+            {
+                return (address + 15) / 16 * 16;
+            }
+
+            /// Reinterprets a value as unsigned for wrapping arithmetic.
+            /// @param[in] value - The value.
+            /// @return The value as unsigned.
+            static std::uint64_t Unsigned(const std::int64_t value)
+            {
+                return static_cast<std::uint64_t>(value);
+            }
+
+            /// Sign-extends a value from a width.
+            /// @param[in] value - The value.
+            /// @param[in] shift - 64 minus the width in bits.
+            /// @return The normalized value.
+            static std::int64_t Normalize(const std::uint64_t value, const std::uint8_t shift)
+            {
+                return static_cast<std::int64_t>(value << shift) >> shift;
+            }
+
+            /// Zero-extends a value from a width.
+            /// @param[in] value - The value.
+            /// @param[in] shift - 64 minus the width in bits.
+            /// @return The zero-extended value.
+            static std::uint64_t ZeroExtend(const std::int64_t value, const std::uint8_t shift)
+            {
+                return (static_cast<std::uint64_t>(value) << shift) >> shift;
+            }
+
+            /// The module containing the functions.
+            const BytecodeModule& Module;
+            /// Limits on the work done.
+            const EvaluationBudget& Budget;
+            /// Calls being evaluated, with the current call last.
+            std::vector<Frame> Frames = {};
+            /// The registers for all calls being evaluated.
+            std::vector<std::int64_t> RegisterStack = {};
+            /// String literals followed by stack slot memory for all calls being evaluated.
+            std::vector<std::uint8_t> Memory = {};
+            /// The first address that can be written.
+            std::size_t WritableMemoryStart = 0;
+            /// The end of the memory used by calls being evaluated.
+            std::size_t MemoryTop = 0;
+        };
+    };
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Caching/ContentHash.h"
+#include "Caching/EvaluationCache.h"
+#include "Evaluation/Bytecode.h"
+#include "Evaluation/BytecodeInterpreter.h"
+#include "Serialization/BinaryWriter.h"
+
+namespace EVALUATION
+{
+    /// The result of evaluating a function at compile time.
+    struct EvaluationResult
+    {
+        /// The returned value (0 for functions without a result).
+        std::int64_t Value = 0;
+        /// True if the value was found in the cache rather than evaluated.
+        bool FromCache = false;
+    };
+
+    /// Evaluates functions at compile time, reusing results of earlier calls
+    /// with the same arguments from an evaluation cache.
+    ///
+    /// Functions are only evaluated if they're pure, meaning their result depends
+    /// only on their arguments.  Bytecode has no global state, so a function is
+    /// pure if it and every function it can call are defined in the module.
+    /// Calls to other functions (such as those in the C library) may have side
+    /// effects, so functions that can make them are rejected without being run.
+    ///
+    /// Functions are identified by a hash of their bytecode and that of every
+    /// function they can call, not by their names.  The same function compiled
+    /// in different translation units therefore shares cached results, while
+    /// changing a function (or anything it calls) invalidates them.
+    struct CompileTimeEvaluator
+    {
+        /// Evaluates a call of a function.
+        /// @param[in] module - The module containing the function.
+        /// @param[in] function_name - The name of the function.
+        /// @param[in] arguments - The arguments, normalized for the parameters' types.
+        /// @param[in] budget - Limits on the work done if the function must be evaluated.
+        /// @param[in,out] cache - The cache of earlier results, if any.  Successful results are added to it.
+        /// @param[out] error_message - Why evaluation failed, if it did.
+        /// @return The result, if successful; null otherwise.
+        static std::optional<EvaluationResult> Evaluate(
+            const BytecodeModule& module,
+            const std::string_view function_name,
+            const std::span<const std::int64_t> arguments,
+            const EvaluationBudget& budget,
+            CACHING::EvaluationCache* const cache,
+            std::string& error_message)
+        {
+            // FIND THE FUNCTION.
+            auto function_index = module.FunctionIndicesByName.find(std::string(function_name));
+            if (module.FunctionIndicesByName.end() == function_index)
+            {
+                error_message = "Function " + std::string(function_name) + " isn't defined";
+                return std::nullopt;
+            }
+
+            // MAKE SURE THE FUNCTION IS PURE.
+            std::optional<std::uint64_t> function_hash = ComputeFunctionHash(module, function_index->second, error_message);
+            if (!function_hash)
+            {
+                return std::nullopt;
+            }
+
+            // REUSE ANY EARLIER RESULT.
+            CACHING::EvaluationKey key = { .FunctionHash = *function_hash, .Arguments = std::vector<std::int64_t>(arguments.begin(), arguments.end()) };
+            if (cache)
+            {
+                std::optional<std::int64_t> cached_value = cache->Find(key);
+                if (cached_value)
+                {
+                    return EvaluationResult { .Value = *cached_value, .FromCache = true };
+                }
+            }
+
+            // EVALUATE THE FUNCTION.
+            std::optional<std::int64_t> value = BytecodeInterpreter::Call(module, function_name, arguments, budget, error_message);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            if (cache)
+            {
+                cache->Store(std::move(key), *value);
+            }
+            return EvaluationResult { .Value = *value, .FromCache = false };
+        }
+
+        /// Computes the hash identifying a function's behavior, independent of its
+        /// module, the names of functions, and where string literals are placed.
+        /// @param[in] module - The module containing the function.
+        /// @param[in] function_index - The index of the function in the module.
+        /// @param[out] error_message - Why the function isn't pure, if it isn't.
+        /// @return The hash, if the function is pure; null otherwise.
+        static std::optional<std::uint64_t> ComputeFunctionHash(const BytecodeModule& module, const std::uint32_t function_index, std::string& error_message)
+        {
+            // NUMBER ALL FUNCTIONS THAT CAN BE CALLED.
+            // They're numbered in the order they're first reached, which only depends on the code.
+            const std::string& function_name = module.Functions[function_index].Name;
+            std::vector<std::uint32_t> reachable_function_indices = { function_index };
+            std::unordered_map<std::uint32_t, std::uint32_t> local_indices_by_function_index = { { function_index, 0 } };
+            for (std::size_t reachable_index = 0; reachable_index < reachable_function_indices.size(); ++reachable_index)
+            {
+                const BytecodeFunction& function = module.Functions[reachable_function_indices[reachable_index]];
+                for (const CallSite& call_site : function.CallSites)
+                {
+                    if (BytecodeModule::NO_FUNCTION == call_site.CalleeIndex)
+                    {
+                        error_message = function_name + " can't be evaluated at compile time since it can call " + call_site.CalleeName + ", which may have side effects";
+                        return std::nullopt;
+                    }
+
+                    auto [local_index, function_added] = local_indices_by_function_index.try_emplace(
+                        call_site.CalleeIndex,
+                        static_cast<std::uint32_t>(reachable_function_indices.size()));
+                    if (function_added)
+                    {
+                        reachable_function_indices.push_back(call_site.CalleeIndex);
+                    }
+                }
+            }
+
+            // SERIALIZE THE FUNCTIONS.
+            // Calls refer to functions by their local numbers and string literals are
+            // written out by value, so only the behavior of the functions is captured.
+            SERIALIZATION::BinaryWriter writer;
+            writer.WriteUInt32(static_cast<std::uint32_t>(reachable_function_indices.size()));
+            for (std::uint32_t reachable_function_index : reachable_function_indices)
+            {
+                const BytecodeFunction& function = module.Functions[reachable_function_index];
+                writer.WriteUInt32(static_cast<std::uint32_t>(function.ParameterCount));
+                writer.WriteUInt8(function.ReturnsValue ? 1 : 0);
+                writer.WriteUInt32(function.FrameSize);
+
+                writer.WriteUInt32(static_cast<std::uint32_t>(function.Code.size()));
+                for (const BytecodeInstruction& instruction : function.Code)
+                {
+                    writer.WriteUInt8(static_cast<std::uint8_t>(instruction.Operation));
+                    writer.WriteUInt8(instruction.Shift);
+                    writer.WriteUInt16(instruction.Destination);
+                    writer.WriteUInt16(instruction.Left);
+                    writer.WriteUInt16(instruction.Right);
+                }
+
+                // String literal addresses vary between modules, so they're replaced by the literals' contents.
+                std::vector<std::int64_t> initial_registers = function.InitialRegisters;
+                writer.WriteUInt32(static_cast<std::uint32_t>(function.StringLiterals.size()));
+                for (const StringLiteralAddress& string_literal : function.StringLiterals)
+                {
+                    std::int64_t address = initial_registers[string_literal.Register];
+                    std::string_view contents(reinterpret_cast<const char*>(module.ReadOnlyData.data() + address), string_literal.SizeInBytes);
+                    writer.WriteUInt16(string_literal.Register);
+                    writer.WriteString(contents);
+                    initial_registers[string_literal.Register] = 0;
+                }
+                writer.WriteUInt32(static_cast<std::uint32_t>(initial_registers.size()));
+                for (std::int64_t initial_register : initial_registers)
+                {
+                    writer.WriteUInt64(static_cast<std::uint64_t>(initial_register));
+                }
+
+                writer.WriteUInt32(static_cast<std::uint32_t>(function.StackSlots.size()));
+                for (const StackSlotAddress& stack_slot : function.StackSlots)
+                {
+                    writer.WriteUInt16(stack_slot.Register);
+                    writer.WriteUInt32(stack_slot.FrameOffset);
+                }
+
+                writer.WriteUInt32(static_cast<std::uint32_t>(function.CallSites.size()));
+                for (const CallSite& call_site : function.CallSites)
+                {
+                    writer.WriteUInt32(local_indices_by_function_index[call_site.CalleeIndex]);
+                    writer.WriteUInt32(static_cast<std::uint32_t>(call_site.ArgumentRegisters.size()));
+                    for (RegisterIndex argument_register : call_site.ArgumentRegisters)
+                    {
+                        writer.WriteUInt16(argument_register);
+                    }
+                }
+            }
+
+            std::uint64_t function_hash = CACHING::ContentHash::Compute(writer.Buffer);
+            return function_hash;
+        }
+    };
+}
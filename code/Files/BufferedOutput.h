@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include "Files/File.h"
+
+namespace FILES
+{
+    /// Append-only output that collects text in a large buffer.
+    ///
+    /// Output written to a file is flushed in large chunks whenever the buffer
+    /// fills, so arbitrarily large output only needs a fixed amount of memory and
+    /// writers can append many small pieces without building intermediate strings.
+    /// The file replaces any existing file only once all output is written, so
+    /// other processes never observe partial output.
+    ///
+    /// Output not written to a file (such as from the default constructor)
+    /// is simply kept in the buffer.
+    struct BufferedOutput
+    {
+        /// The default number of bytes buffered before being written to a file.
+        static constexpr std::size_t DEFAULT_BUFFER_SIZE_IN_BYTES = 4 * 1024 * 1024;
+
+        /// Opens output to a file.
+        /// @param[in] filepath - The path of the file to write.  Replaced by Finish().
+        /// @param[in] buffer_size_in_bytes - The number of bytes to buffer before writing them.
+        /// @return The output, if the file could be created; null otherwise.
+        static std::optional<BufferedOutput> OpenFile(const std::filesystem::path& filepath, const std::size_t buffer_size_in_bytes = DEFAULT_BUFFER_SIZE_IN_BYTES)
+        {
+            BufferedOutput output;
+            output.Filepath = filepath;
+            output.TemporaryFilepath = File::GetTemporaryFilepath(filepath);
+            output.OutputFile.open(output.TemporaryFilepath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!output.OutputFile)
+            {
+                return std::nullopt;
+            }
+            output.BufferSizeInBytes = buffer_size_in_bytes;
+            output.Buffer.reserve(buffer_size_in_bytes);
+            return output;
+        }
+
+        /// Creates output kept in memory.
+        BufferedOutput() = default;
+
+        /// Removes any unfinished file.
+        ~BufferedOutput()
+        {
+            Discard();
+        }
+
+        /// Takes ownership of other output.
+        /// @param[in,out] other - The output to take ownership of.  Will be left empty.
+        BufferedOutput(BufferedOutput&& other) noexcept :
+            Buffer(std::move(other.Buffer)),
+            Filepath(std::move(other.Filepath)),
+            TemporaryFilepath(std::exchange(other.TemporaryFilepath, {})),
+            OutputFile(std::move(other.OutputFile)),
+            BufferSizeInBytes(other.BufferSizeInBytes),
+            Failed(other.Failed)
+        {}
+
+        BufferedOutput(const BufferedOutput&) = delete;
+        BufferedOutput& operator=(const BufferedOutput&) = delete;
+        BufferedOutput& operator=(BufferedOutput&&) = delete;
+
+        /// Appends text.
+        /// @param[in] text - The text to append.
+        void Write(const std::string_view text)
+        {
+            Buffer.append(text);
+            FlushIfFull();
+        }
+
+        /// Appends a character.
+        /// @param[in] character - The character to append.
+        void Write(const char character)
+        {
+            Buffer.push_back(character);
+            FlushIfFull();
+        }
+
+        /// Appends a character repeatedly, such as for indentation.
+        /// @param[in] character - The character to append.
+        /// @param[in] count - The number of times to append it.
+        void WriteRepeated(const char character, const std::size_t count)
+        {
+            Buffer.append(count, character);
+            FlushIfFull();
+        }
+
+        /// Finishes writing output.
+        /// For files, all buffered output is written and the file replaces any existing file.
+        /// @return True if all output was written; false otherwise.
+        bool Finish()
+        {
+            if (TemporaryFilepath.empty())
+            {
+                return !Failed;
+            }
+
+            // WRITE THE REST OF THE OUTPUT.
+            Flush();
+            OutputFile.close();
+            if (Failed || OutputFile.fail())
+            {
+                Discard();
+                return false;
+            }
+
+            // REPLACE THE FINAL FILE.
+            std::error_code error;
+            std::filesystem::rename(TemporaryFilepath, Filepath, error);
+            if (error)
+            {
+                Discard();
+                return false;
+            }
+            TemporaryFilepath.clear();
+            return true;
+        }
+
+        /// Output not yet written to any file (or all output when kept in memory).
+        std::string Buffer = "";
+
+    private:
+        /// Writes the buffer to the file once it's full.
+        void FlushIfFull()
+        {
+            if (Buffer.size() >= BufferSizeInBytes && OutputFile.is_open())
+            {
+                Flush();
+            }
+        }
+
+        /// Writes the buffer to any file.
+        void Flush()
+        {
+            OutputFile.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size()));
+            Failed = Failed || !OutputFile;
+            Buffer.clear();
+        }
+
+        /// Closes and removes any unfinished file.
+        void Discard()
+        {
+            if (TemporaryFilepath.empty())
+            {
+                return;
+            }
+            OutputFile.close();
+            std::error_code error;
+            std::filesystem::remove(TemporaryFilepath, error);
+            TemporaryFilepath.clear();
+        }
+
+        /// The path of the file to replace once finished, if writing to a file.
+        std::filesystem::path Filepath = "";
+        /// The path of the file being written until finished, if writing to a file.
+        std::filesystem::path TemporaryFilepath = "";
+        /// The file being written, if any.
+        std::ofstream OutputFile = {};
+        /// The number of bytes to buffer before writing them to the file.
+        std::size_t BufferSizeInBytes = DEFAULT_BUFFER_SIZE_IN_BYTES;
+        /// True if writing to the file failed.
+        bool Failed = false;
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace FILES
+{
+    /// Provides basic access to files on disk.
+    struct File
+    {
+        /// Reads the entire contents of a file as text.
+        /// @param[in] filepath - The path of the file to read.
+        /// @return The contents of the file, if it could be read; null otherwise.
+        static std::optional<std::string> ReadText(const std::filesystem::path& filepath)
+        {
+            // OPEN THE FILE.
+            std::ifstream file(filepath, std::ios::in | std::ios::binary);
+            if (!file)
+            {
+                return std::nullopt;
+            }
+
+            // READ THE ENTIRE FILE IN A SINGLE OPERATION.
+            // Sizing the string up front avoids repeated reallocations for large files.
+            file.seekg(0, std::ios::end);
+            std::streamoff file_size_in_bytes = file.tellg();
+            if (file_size_in_bytes < 0)
+            {
+                return std::nullopt;
+            }
+            file.seekg(0, std::ios::beg);
+
+            std::string text(static_cast<std::size_t>(file_size_in_bytes), '\0');
+            file.read(text.data(), file_size_in_bytes);
+            if (!file)
+            {
+                return std::nullopt;
+            }
+
+            return text;
+        }
+
+        /// Writes binary data to a file, replacing it only once all data is written.
+        /// Data is first written to a temporary file that is then renamed, so other
+        /// processes never observe a partially written file.
+        /// @param[in] filepath - The path of the file to write.
+        /// @param[in] data - The data to write.
+        /// @return True if the file was written; false otherwise.
+        static bool WriteBinaryAtomically(const std::filesystem::path& filepath, const std::string_view data)
+        {
+            // WRITE THE DATA TO A TEMPORARY FILE.
+            std::filesystem::path temporary_filepath = GetTemporaryFilepath(filepath);
+            {
+                std::ofstream file(temporary_filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!file)
+                {
+                    return false;
+                }
+
+                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+                if (!file)
+                {
+                    return false;
+                }
+            }
+
+            // REPLACE THE FINAL FILE.
+            std::error_code error;
+            std::filesystem::rename(temporary_filepath, filepath, error);
+            if (error)
+            {
+                std::filesystem::remove(temporary_filepath, error);
+                return false;
+            }
+
+            return true;
+        }
+
+        /// Gets a path for temporarily writing a file before it replaces the final file.
+        /// The temporary name is made unique per thread and time so that
+        /// concurrent writers (even in different processes) don't collide.
+        /// @param[in] filepath - The path of the final file.
+        /// @return The path of the temporary file, in the same directory as the final file.
+        static std::filesystem::path GetTemporaryFilepath(const std::filesystem::path& filepath)
+        {
+            std::size_t thread_id_hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+            auto current_time = std::chrono::steady_clock::now().time_since_epoch().count();
+            std::filesystem::path temporary_filepath = filepath;
+            temporary_filepath += ".tmp" + std::to_string(thread_id_hash) + "_" + std::to_string(current_time);
+            return temporary_filepath;
+        }
+    };
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#if _WIN32
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace FILES
+{
+    /// A file mapped read-only into memory.
+    /// Mapping avoids copying file contents into separately allocated
+    /// memory, so data can be used directly from the operating system's
+    /// page cache.
+    struct MemoryMappedFile
+    {
+        /// Maps a file into memory.
+        /// @param[in] filepath - The path of the file to map.
+        /// @return The mapped file, if successful; null otherwise.
+        static std::optional<MemoryMappedFile> Open(const std::filesystem::path& filepath)
+        {
+            MemoryMappedFile mapped_file;
+
+        #if _WIN32
+            // OPEN THE FILE.
+            HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (INVALID_HANDLE_VALUE == file)
+            {
+                return std::nullopt;
+            }
+
+            LARGE_INTEGER file_size_in_bytes = {};
+            bool file_size_retrieved = GetFileSizeEx(file, &file_size_in_bytes);
+            if (!file_size_retrieved)
+            {
+                CloseHandle(file);
+                return std::nullopt;
+            }
+
+            // MAP THE FILE.
+            // Empty files can't be mapped, but they're still valid.
+            bool file_empty = (0 == file_size_in_bytes.QuadPart);
+            if (!file_empty)
+            {
+                HANDLE file_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!file_mapping)
+                {
+                    CloseHandle(file);
+                    return std::nullopt;
+                }
+
+                mapped_file.Data = static_cast<const char*>(MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(file_mapping);
+                if (!mapped_file.Data)
+                {
+                    CloseHandle(file);
+                    return std::nullopt;
+                }
+            }
+
+            CloseHandle(file);
+            mapped_file.SizeInBytes = static_cast<std::size_t>(file_size_in_bytes.QuadPart);
+        #else
+            // OPEN THE FILE.
+            int file_descriptor = open(filepath.c_str(), O_RDONLY);
+            if (file_descriptor < 0)
+            {
+                return std::nullopt;
+            }
+
+            struct stat file_status = {};
+            bool file_status_retrieved = (0 == fstat(file_descriptor, &file_status));
+            if (!file_status_retrieved)
+            {
+                close(file_descriptor);
+                return std::nullopt;
+            }
+
+            // MAP THE FILE.
+            // Empty files can't be mapped, but they're still valid.
+            bool file_empty = (0 == file_status.st_size);
+            if (!file_empty)
+            {
+                void* mapped_memory = mmap(nullptr, static_cast<std::size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+                if (MAP_FAILED == mapped_memory)
+                {
+                    close(file_descriptor);
+                    return std::nullopt;
+                }
+                mapped_file.Data = static_cast<const char*>(mapped_memory);
+            }
+
+            // The mapping remains valid after the file is closed.
+            close(file_descriptor);
+            mapped_file.SizeInBytes = static_cast<std::size_t>(file_status.st_size);
+        #endif
+
+            return mapped_file;
+        }
+
+        /// Creates an empty mapping.
+        MemoryMappedFile() = default;
+
+        /// Unmaps the file.
+        ~MemoryMappedFile()
+        {
+            Close();
+        }
+
+        /// Takes ownership of another mapping.
+        /// @param[in,out] other - The mapping to take ownership of.  Will be left empty.
+        MemoryMappedFile(MemoryMappedFile&& other) noexcept :
+            Data(std::exchange(other.Data, nullptr)),
+            SizeInBytes(std::exchange(other.SizeInBytes, 0))
+        {}
+
+        /// Takes ownership of another mapping, unmapping any current file.
+        /// @param[in,out] other - The mapping to take ownership of.  Will be left empty.
+        /// @return This mapping.
+        MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                Data = std::exchange(other.Data, nullptr);
+                SizeInBytes = std::exchange(other.SizeInBytes, 0);
+            }
+            return *this;
+        }
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        /// Gets the contents of the file.
+        /// @return The contents of the file.
+        std::string_view Contents() const
+        {
+            return std::string_view(Data, SizeInBytes);
+        }
+
+        /// The start of the mapped contents.  Null for empty files.
+        const char* Data = nullptr;
+        /// The size of the mapped contents.
+        std::size_t SizeInBytes = 0;
+
+    private:
+        /// Unmaps any mapped file.
+        void Close()
+        {
+            if (!Data)
+            {
+                return;
+            }
+
+        #if _WIN32
+            UnmapViewOfFile(Data);
+        #else
+            munmap(const_cast<char*>(Data), SizeInBytes);
+        #endif
+            Data = nullptr;
+            SizeInBytes = 0;
+        }
+    };
+}
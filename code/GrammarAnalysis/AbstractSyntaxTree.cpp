@@ -1,142 +1,1187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include "Tokenization/TokenStream.h"
 
-struct VariableDeclaration
+namespace SEMANTIC_ANALYSIS
+{
+    struct Type;
+    struct TypeTable;
+}
+
+/// Adds a parsing error at the current position in a token stream.
+/// @param[in] token_stream - The tokens being parsed.
+/// @param[in] message - The error message.
+/// @param[in,out] error_messages - The error messages to add to, one per line.
+void AddParseError(const TOKENIZATION::TokenStream& token_stream, const std::string& message, std::string& error_messages)
+{
+    // The last token is used for errors at the end of the stream.
+    const TOKENIZATION::Token* token = token_stream.PeekNonCommentToken();
+    if (!token && !token_stream.Tokens.empty())
+    {
+        token = &token_stream.Tokens.back();
+    }
+
+    if (token)
+    {
+        error_messages += token->Filepath + ":" + std::to_string(token->LineNumber) + ": error: " + message + "\n";
+    }
+    else
+    {
+        error_messages += "error: " + message + "\n";
+    }
+}
+
+/// Consumes the next token if it's a specific operator or punctuator.
+/// @param[in,out] token_stream - The tokens being parsed.
+/// @param[in] value - The value of the token to look for.
+/// @return True if the token was consumed; false otherwise.
+bool ConsumeNextTokenIfValue(TOKENIZATION::TokenStream& token_stream, const std::string_view value)
+{
+    const TOKENIZATION::Token* next_token = token_stream.PeekNonCommentToken();
+    bool matches = (next_token && value == next_token->Value && TOKENIZATION::TokenType::STRING_LITERAL != next_token->Type);
+    if (matches)
+    {
+        token_stream.SkipComments();
+        ++token_stream.CurrentIndex;
+    }
+    return matches;
+}
+
+/// Consumes the next token if it's a specific operator or punctuator, adding an error otherwise.
+/// @param[in,out] token_stream - The tokens being parsed.
+/// @param[in] value - The value of the expected token.
+/// @param[in] context - Describes where the token was expected, for any error.
+/// @param[in,out] error_messages - The error messages to add to, one per line.
+/// @return True if the token was consumed; false otherwise.
+bool ExpectToken(TOKENIZATION::TokenStream& token_stream, const std::string_view value, const std::string_view context, std::string& error_messages)
+{
+    bool consumed = ConsumeNextTokenIfValue(token_stream, value);
+    if (!consumed)
+    {
+        AddParseError(token_stream, "Expected '" + std::string(value) + "' " + std::string(context) + ".", error_messages);
+    }
+    return consumed;
+}
+
+/// The storage classes that can be written in a declaration.
+enum class StorageClass
 {
-    std::string DataType;
-    std::string Name;
+    NONE = 0,
+    STATIC,
+    EXTERN,
+    REGISTER,
+    AUTO,
 };
 
-struct FunctionHeader
+/// The storage class and type qualifiers written along with the type of a declaration.
+/// They're kept apart from the spelling of the type, which only has the type specifiers
+/// and pointer declarators, since they don't change which type a declaration has.
+struct DeclarationSpecifiers
 {
-    std::string Name;
-    std::vector<VariableDeclaration> Parameters;
-    std::string ReturnType;
+    /// The storage class, if one was written.
+    StorageClass Storage = StorageClass::NONE;
+    /// True if the type before any pointer declarators is const (as in "const char* text").
+    bool IsConst = false;
+    /// True if the type before any pointer declarators is volatile.
+    bool IsVolatile = false;
+
+    /// Parses a storage class or type qualifier keyword.
+    /// @param[in] token - The token to parse.
+    /// @return True if the token is a storage class or qualifier (and was recorded); false otherwise.
+    bool Parse(const TOKENIZATION::Token& token)
+    {
+        if (!IsSpecifier(token))
+        {
+            return false;
+        }
+
+        if ("const" == token.Value) IsConst = true;
+        else if ("volatile" == token.Value) IsVolatile = true;
+        else if ("static" == token.Value) Storage = StorageClass::STATIC;
+        else if ("extern" == token.Value) Storage = StorageClass::EXTERN;
+        else if ("register" == token.Value) Storage = StorageClass::REGISTER;
+        else if ("auto" == token.Value) Storage = StorageClass::AUTO;
+        return true;
+    }
+
+    /// Gets the specifiers as written before a type, such as "static const ".
+    /// @return The specifiers, each followed by a space; empty if there are none.
+    std::string ToString() const
+    {
+        static constexpr const char* STORAGE_CLASS_KEYWORDS[] = { "", "static ", "extern ", "register ", "auto " };
+        std::string specifiers = STORAGE_CLASS_KEYWORDS[static_cast<std::size_t>(Storage)];
+        specifiers += IsConst ? "const " : "";
+        specifiers += IsVolatile ? "volatile " : "";
+        return specifiers;
+    }
+
+    /// Determines if a token is a storage class or type qualifier keyword.
+    /// @param[in] token - The token to check.
+    /// @return True if the token is a storage class or qualifier; false otherwise.
+    static bool IsSpecifier(const TOKENIZATION::Token& token)
+    {
+        bool is_specifier = (
+            TOKENIZATION::TokenType::KEYWORD == token.Type &&
+            ("const" == token.Value || "volatile" == token.Value || "static" == token.Value || "register" == token.Value || "auto" == token.Value || "extern" == token.Value));
+        return is_specifier;
+    }
+
+    /// Compares specifiers for equality.
+    bool operator==(const DeclarationSpecifiers& other) const = default;
 };
 
-struct Statement
+struct VariableDeclaration
 {
+    std::string DataType = "";
+    std::string Name = "";
+    /// The storage class and qualifiers of the declaration.
+    DeclarationSpecifiers Specifiers = {};
+
+    /// Parses the type specifiers and any pointer declarators of a type, such as "unsigned int*".
+    /// Storage classes and qualifiers don't affect the type, so they're recorded separately.
+    /// @param[in,out] token_stream - The tokens being parsed.
+    /// @param[out] specifiers - The storage class and qualifiers written with the type.
+    /// @return The spelling of the type, if one was found; null otherwise.
+    static std::optional<std::string> ParseDataType(TOKENIZATION::TokenStream& token_stream, DeclarationSpecifiers& specifiers)
+    {
+        using namespace TOKENIZATION;
+
+        std::string data_type;
+        while (const Token* next_token = token_stream.PeekNonCommentToken())
+        {
+            if (TokenType::DATA_TYPE == next_token->Type)
+            {
+                data_type += (data_type.empty() ? "" : " ") + next_token->Value;
+            }
+            else if (!specifiers.Parse(*next_token))
+            {
+                break;
+            }
+            token_stream.SkipComments();
+            ++token_stream.CurrentIndex;
+        }
+        if (data_type.empty())
+        {
+            return std::nullopt;
+        }
+
+        while (ConsumeNextTokenIfValue(token_stream, "*"))
+        {
+            data_type += "*";
+        }
+        return data_type;
+    }
 };
 
-struct Block
+struct FunctionHeader
 {
-    static std::optional<Block> Parse(TOKENIZATION::TokenStream& token_stream)
+    std::string Name = "";
+    std::vector<VariableDeclaration> Parameters = {};
+    std::string ReturnType = "";
+    /// True if the function takes a variable number of arguments after its parameters.
+    bool IsVariadic = false;
+    /// The path of the file containing the function.
+    std::string Filepath = "";
+    /// The line of the function's name.
+    std::size_t LineNumber = 0;
+    /// The storage class of the function and the qualifiers of its return type.
+    DeclarationSpecifiers Specifiers = {};
+
+    /// Parses a parameter list, starting after the opening parenthesis.
+    /// @param[in,out] token_stream - The tokens being parsed.
+    /// @param[in,out] header - The header to add the parameters to.
+    /// @return True if the parameter list was parsed through the closing parenthesis; false otherwise.
+    static bool ParseParameters(TOKENIZATION::TokenStream& token_stream, FunctionHeader& header)
     {
         using namespace TOKENIZATION;
-        
-        std::optional<Block> block;
-        
-        while (token_stream.MoreTokens())
+
+        // CHECK FOR AN EMPTY PARAMETER LIST.
+        if (ConsumeNextTokenIfValue(token_stream, ")"))
         {
-            Token current_token = token_stream.ConsumeNextToken();
-            std::printf("Block token %s\n", current_token.Value.c_str());
-            if (!block)
+            return true;
+        }
+        const Token* void_token = token_stream.PeekNonCommentToken();
+        const Token* after_void_token = token_stream.PeekNonCommentToken(1);
+        bool is_void_parameter_list = (void_token && "void" == void_token->Value && after_void_token && ")" == after_void_token->Value);
+        if (is_void_parameter_list)
+        {
+            ConsumeNextTokenIfValue(token_stream, "void");
+            ConsumeNextTokenIfValue(token_stream, ")");
+            return true;
+        }
+
+        // PARSE EACH PARAMETER.
+        do
+        {
+            if (ConsumeNextTokenIfValue(token_stream, "..."))
+            {
+                header.IsVariadic = true;
+                break;
+            }
+
+            DeclarationSpecifiers specifiers;
+            std::optional<std::string> data_type = VariableDeclaration::ParseDataType(token_stream, specifiers);
+            if (!data_type)
+            {
+                return false;
+            }
+
+            // Names are optional in declarations.
+            VariableDeclaration parameter = { .DataType = *data_type, .Specifiers = specifiers };
+            token_stream.SkipComments();
+            std::optional<Token> name = token_stream.ConsumeNextTokenIfMatch(TokenType::IDENTIFIER);
+            if (name)
             {
-                bool is_opening_current_block = (TokenType::OPENING_CURLY_BRACE == current_token.Type);
-                if (is_opening_current_block)
+                parameter.Name = name->Value;
+            }
+
+            // Array parameters are pointers.
+            if (ConsumeNextTokenIfValue(token_stream, "["))
+            {
+                token_stream.SkipComments();
+                token_stream.ConsumeNextTokenIfMatch(TokenType::CONSTANT);
+                if (!ConsumeNextTokenIfValue(token_stream, "]"))
                 {
-                    block = Block();
-                    continue;
+                    return false;
                 }
-                else
+                parameter.DataType += "*";
+            }
+
+            header.Parameters.push_back(std::move(parameter));
+        } while (ConsumeNextTokenIfValue(token_stream, ","));
+
+        bool parameter_list_ended = ConsumeNextTokenIfValue(token_stream, ")");
+        return parameter_list_ended;
+    }
+};
+
+/// The kinds of expressions.
+enum class ExpressionKind
+{
+    INVALID = 0,
+    /// A numeric or character constant.  Text is the constant as written.
+    CONSTANT,
+    /// A string literal.  Text is the literal as written, including quotes.
+    STRING_LITERAL,
+    /// A reference to a variable or function.  Text is its name.
+    IDENTIFIER,
+    /// A prefix operator.  Text is the operator, applied to the single operand.
+    UNARY,
+    /// A postfix increment or decrement.  Text is the operator, applied to the single operand.
+    POSTFIX,
+    /// A binary operator.  Text is the operator, applied to the two operands.
+    BINARY,
+    /// An assignment.  Text is the operator (= or a compound assignment like +=),
+    /// and operands are the target and the value.
+    ASSIGNMENT,
+    /// A conditional (?:) expression.  Operands are the condition and the two alternatives.
+    CONDITIONAL,
+    /// A function call.  Text is the function's name, and operands are the arguments.
+    CALL,
+    /// An array subscript.  Operands are the array (or pointer) and the index.
+    INDEX,
+};
+
+struct Expression
+{
+    ExpressionKind Kind = ExpressionKind::INVALID;
+    /// The text of the expression, which depends on its kind.
+    std::string Text = "";
+    std::vector<Expression> Operands = {};
+    /// The line on which the expression starts.
+    std::size_t LineNumber = 0;
+    /// The type of the expression, once resolved by semantic analysis.
+    const SEMANTIC_ANALYSIS::Type* ResolvedType = nullptr;
+
+    /// Parses an expression.
+    /// @param[in,out] token_stream - The tokens being parsed.
+    /// @param[in,out] error_messages - The error messages to add to, one per line.
+    /// @return The expression, if it could be parsed; null otherwise.
+    static std::optional<Expression> Parse(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+    {
+        return ParseAssignment(token_stream, error_messages);
+    }
+
+    /// Gets the precedence of a binary operator.
+    /// @param[in] operator_text - The operator.
+    /// @return The precedence (higher binds tighter), if the text is a binary operator; 0 otherwise.
+    static int GetBinaryOperatorPrecedence(const std::string_view operator_text)
+    {
+        if ("*" == operator_text || "/" == operator_text || "%" == operator_text) return 10;
+        if ("+" == operator_text || "-" == operator_text) return 9;
+        if ("<<" == operator_text || ">>" == operator_text) return 8;
+        if ("<" == operator_text || "<=" == operator_text || ">" == operator_text || ">=" == operator_text) return 7;
+        if ("==" == operator_text || "!=" == operator_text) return 6;
+        if ("&" == operator_text) return 5;
+        if ("^" == operator_text) return 4;
+        if ("|" == operator_text) return 3;
+        if ("&&" == operator_text) return 2;
+        if ("||" == operator_text) return 1;
+        return 0;
+    }
+
+    /// Determines if an operator is an assignment operator.
+    /// @param[in] operator_text - The operator.
+    /// @return True for simple (=) and compound (+=, <<=, etc.) assignment; false otherwise.
+    static bool IsAssignmentOperator(const std::string_view operator_text)
+    {
+        bool is_assignment = (
+            "=" == operator_text ||
+            "+=" == operator_text || "-=" == operator_text || "*=" == operator_text || "/=" == operator_text || "%=" == operator_text ||
+            "<<=" == operator_text || ">>=" == operator_text || "&=" == operator_text || "|=" == operator_text || "^=" == operator_text);
+        return is_assignment;
+    }
+
+    /// Gets the binary operator applied by a compound assignment.
+    /// @param[in] operator_text - The assignment operator, such as += or =.
+    /// @return The binary operator, such as +, or empty for simple assignment.
+    static std::string_view GetCompoundAssignmentOperator(const std::string_view operator_text)
+    {
+        return operator_text.substr(0, operator_text.length() - 1);
+    }
+
+private:
+    /// Parses an assignment or any higher-precedence expression.
+    static std::optional<Expression> ParseAssignment(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+    {
+        std::optional<Expression> target = ParseConditional(token_stream, error_messages);
+        if (!target)
+        {
+            return std::nullopt;
+        }
+
+        // Assignment is right-associative.
+        const TOKENIZATION::Token* next_token = token_stream.PeekNonCommentToken();
+        bool is_assignment = (next_token && TOKENIZATION::TokenType::OPERATOR == next_token->Type && IsAssignmentOperator(next_token->Value));
+        if (!is_assignment)
+        {
+            return target;
+        }
+        std::string operator_text = next_token->Value;
+        ConsumeNextTokenIfValue(token_stream, operator_text);
+        std::optional<Expression> value = ParseAssignment(token_stream, error_messages);
+        if (!value)
+        {
+            return std::nullopt;
+        }
+
+        std::size_t line_number = target->LineNumber;
+        Expression assignment =
+        {
+            .Kind = ExpressionKind::ASSIGNMENT,
+            .Text = std::move(operator_text),
+            .Operands = { std::move(*target), std::move(*value) },
+            .LineNumber = line_number,
+        };
+        return assignment;
+    }
+
+    /// Parses a conditional expression or any higher-precedence expression.
+    static std::optional<Expression> ParseConditional(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+    {
+        std::optional<Expression> condition = ParseBinary(token_stream, 1, error_messages);
+        if (!condition || !ConsumeNextTokenIfValue(token_stream, "?"))
+        {
+            return condition;
+        }
+
+        std::optional<Expression> true_value = Parse(token_stream, error_messages);
+        if (!true_value || !ExpectToken(token_stream, ":", "in conditional expression", error_messages))
+        {
+            return std::nullopt;
+        }
+        std::optional<Expression> false_value = ParseConditional(token_stream, error_messages);
+        if (!false_value)
+        {
+            return std::nullopt;
+        }
+
+        std::size_t line_number = condition->LineNumber;
+        Expression conditional =
+        {
+            .Kind = ExpressionKind::CONDITIONAL,
+            .Text = "?:",
+            .Operands = { std::move(*condition), std::move(*true_value), std::move(*false_value) },
+            .LineNumber = line_number,
+        };
+        return conditional;
+    }
+
+    /// Parses binary operators with at least a minimum precedence using precedence climbing.
+    static std::optional<Expression> ParseBinary(TOKENIZATION::TokenStream& token_stream, const int minimum_precedence, std::string& error_messages)
+    {
+        std::optional<Expression> left_operand = ParseUnary(token_stream, error_messages);
+        while (left_operand)
+        {
+            // CHECK FOR A BINARY OPERATOR THAT BINDS TIGHTLY ENOUGH.
+            const TOKENIZATION::Token* operator_token = token_stream.PeekNonCommentToken();
+            if (!operator_token || TOKENIZATION::TokenType::OPERATOR != operator_token->Type)
+            {
+                break;
+            }
+            int precedence = GetBinaryOperatorPrecedence(operator_token->Value);
+            if (precedence < minimum_precedence || 0 == precedence)
+            {
+                break;
+            }
+            std::string operator_text = operator_token->Value;
+            ConsumeNextTokenIfValue(token_stream, operator_text);
+
+            // PARSE THE RIGHT OPERAND.
+            // Binary operators are left-associative, so the right operand only includes tighter operators.
+            std::optional<Expression> right_operand = ParseBinary(token_stream, precedence + 1, error_messages);
+            if (!right_operand)
+            {
+                return std::nullopt;
+            }
+
+            std::size_t line_number = left_operand->LineNumber;
+            left_operand = Expression
+            {
+                .Kind = ExpressionKind::BINARY,
+                .Text = std::move(operator_text),
+                .Operands = { std::move(*left_operand), std::move(*right_operand) },
+                .LineNumber = line_number,
+            };
+        }
+        return left_operand;
+    }
+
+    /// Parses a prefix unary operator or any higher-precedence expression.
+    static std::optional<Expression> ParseUnary(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+    {
+        const TOKENIZATION::Token* operator_token = token_stream.PeekNonCommentToken();
+        bool is_unary_operator = (
+            operator_token &&
+            TOKENIZATION::TokenType::OPERATOR == operator_token->Type &&
+            ("-" == operator_token->Value || "+" == operator_token->Value || "!" == operator_token->Value || "~" == operator_token->Value ||
+             "*" == operator_token->Value || "&" == operator_token->Value || "++" == operator_token->Value || "--" == operator_token->Value));
+        if (!is_unary_operator)
+        {
+            return ParsePostfix(token_stream, error_messages);
+        }
+
+        std::string operator_text = operator_token->Value;
+        std::size_t line_number = operator_token->LineNumber;
+        ConsumeNextTokenIfValue(token_stream, operator_text);
+        std::optional<Expression> operand = ParseUnary(token_stream, error_messages);
+        if (!operand)
+        {
+            return std::nullopt;
+        }
+
+        Expression unary =
+        {
+            .Kind = ExpressionKind::UNARY,
+            .Text = std::move(operator_text),
+            .Operands = { std::move(*operand) },
+            .LineNumber = line_number,
+        };
+        return unary;
+    }
+
+    /// Parses postfix subscripts, increments, and decrements.
+    static std::optional<Expression> ParsePostfix(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+    {
+        std::optional<Expression> operand = ParsePrimary(token_stream, error_messages);
+        while (operand)
+        {
+            std::size_t line_number = operand->LineNumber;
+            if (ConsumeNextTokenIfValue(token_stream, "["))
+            {
+                std::optional<Expression> index = Parse(token_stream, error_messages);
+                if (!index || !ExpectToken(token_stream, "]", "after array index", error_messages))
                 {
                     return std::nullopt;
                 }
+                operand = Expression
+                {
+                    .Kind = ExpressionKind::INDEX,
+                    .Text = "[]",
+                    .Operands = { std::move(*operand), std::move(*index) },
+                    .LineNumber = line_number,
+                };
+            }
+            else if (ConsumeNextTokenIfValue(token_stream, "++") || ConsumeNextTokenIfValue(token_stream, "--"))
+            {
+                std::string operator_text = token_stream.Tokens[token_stream.CurrentIndex - 1].Value;
+                operand = Expression
+                {
+                    .Kind = ExpressionKind::POSTFIX,
+                    .Text = std::move(operator_text),
+                    .Operands = { std::move(*operand) },
+                    .LineNumber = line_number,
+                };
             }
             else
             {
-                /// @todo Parse statements!
-                bool is_opening_new_block = (TokenType::OPENING_CURLY_BRACE == current_token.Type);
-                if (is_opening_new_block)
+                break;
+            }
+        }
+        return operand;
+    }
+
+    /// Parses constants, names, calls, and parenthesized expressions.
+    static std::optional<Expression> ParsePrimary(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+    {
+        using namespace TOKENIZATION;
+
+        const Token* token = token_stream.PeekNonCommentToken();
+        if (!token)
+        {
+            AddParseError(token_stream, "Expected an expression.", error_messages);
+            return std::nullopt;
+        }
+
+        // PARSE A PARENTHESIZED EXPRESSION.
+        if (TokenType::OPENING_PARENTHESIS == token->Type)
+        {
+            ConsumeNextTokenIfValue(token_stream, "(");
+            std::optional<Expression> expression = Parse(token_stream, error_messages);
+            if (!expression || !ExpectToken(token_stream, ")", "after parenthesized expression", error_messages))
+            {
+                return std::nullopt;
+            }
+            return expression;
+        }
+
+        // PARSE A CONSTANT OR STRING LITERAL.
+        Expression expression = { .Text = token->Value, .LineNumber = token->LineNumber };
+        if (TokenType::CONSTANT == token->Type || TokenType::STRING_LITERAL == token->Type)
+        {
+            expression.Kind = (TokenType::CONSTANT == token->Type) ? ExpressionKind::CONSTANT : ExpressionKind::STRING_LITERAL;
+            token_stream.SkipComments();
+            ++token_stream.CurrentIndex;
+            return expression;
+        }
+
+        // PARSE A NAME OR FUNCTION CALL.
+        if (TokenType::IDENTIFIER != token->Type)
+        {
+            AddParseError(token_stream, "Expected an expression but found '" + token->Value + "'.", error_messages);
+            return std::nullopt;
+        }
+        token_stream.SkipComments();
+        ++token_stream.CurrentIndex;
+
+        bool is_call = ConsumeNextTokenIfValue(token_stream, "(");
+        if (!is_call)
+        {
+            expression.Kind = ExpressionKind::IDENTIFIER;
+            return expression;
+        }
+
+        expression.Kind = ExpressionKind::CALL;
+        if (ConsumeNextTokenIfValue(token_stream, ")"))
+        {
+            return expression;
+        }
+        do
+        {
+            std::optional<Expression> argument = Parse(token_stream, error_messages);
+            if (!argument)
+            {
+                return std::nullopt;
+            }
+            expression.Operands.push_back(std::move(*argument));
+        } while (ConsumeNextTokenIfValue(token_stream, ","));
+        if (!ExpectToken(token_stream, ")", "after function arguments", error_messages))
+        {
+            return std::nullopt;
+        }
+        return expression;
+    }
+};
+
+/// The kinds of statements.
+enum class StatementKind
+{
+    INVALID = 0,
+    /// A statement that does nothing (just a semicolon).
+    EMPTY,
+    /// An expression evaluated for its side effects (the value).
+    EXPRESSION,
+    /// A local variable declaration, with an optional initializer (the value).
+    DECLARATION,
+    /// A return, with an optional value.
+    RETURN,
+    /// An if statement.  The body is the statement if the condition is true,
+    /// optionally followed by the statement if it's false.
+    IF,
+    /// A while loop with a single statement as its body.
+    WHILE,
+    /// A do-while loop with a single statement as its body.
+    DO_WHILE,
+    /// A for loop with an optional condition and step.  The body is the
+    /// initializer statement (possibly empty) followed by the loop's statement.
+    FOR,
+    /// A break out of the innermost loop.
+    BREAK,
+    /// A continue of the innermost loop.
+    CONTINUE,
+    /// A block, whose body is the statements in the block.
+    BLOCK,
+};
+
+struct Statement
+{
+    StatementKind Kind = StatementKind::INVALID;
+    /// The declared variable, for declarations.
+    VariableDeclaration Declaration = {};
+    /// The expression, return value, or initializer, if any.
+    std::optional<Expression> Value = std::nullopt;
+    /// The condition of an if statement or loop, if any.
+    std::optional<Expression> Condition = std::nullopt;
+    /// The step of a for loop, if any.
+    std::optional<Expression> Step = std::nullopt;
+    /// Nested statements, which depend on the kind of statement.
+    std::vector<Statement> Body = {};
+    /// The line on which the statement starts.
+    std::size_t LineNumber = 0;
+
+    /// Parses a statement.  Declarations of multiple variables produce a statement for each one.
+    /// @param[in,out] token_stream - The tokens being parsed.
+    /// @param[out] statements - The statements to add to.
+    /// @param[in,out] error_messages - The error messages to add to, one per line.
+    /// @return True if the statement could be parsed; false otherwise.
+    static bool Parse(TOKENIZATION::TokenStream& token_stream, std::vector<Statement>& statements, std::string& error_messages);
+
+    /// Skips the rest of a statement that couldn't be parsed, so parsing can continue after it.
+    /// @param[in,out] token_stream - The tokens being parsed.
+    static void SkipToEnd(TOKENIZATION::TokenStream& token_stream)
+    {
+        using namespace TOKENIZATION;
+
+        std::size_t brace_depth = 0;
+        while (token_stream.MoreTokens())
+        {
+            const Token& token = token_stream.Tokens[token_stream.CurrentIndex];
+            if (TokenType::CLOSING_CURLY_BRACE == token.Type)
+            {
+                if (0 == brace_depth)
                 {
-                    /// @todo Need to not consume token for parsing block...
-                    std::optional<Block> child_block = Block::Parse(token_stream);
+                    return;
                 }
-                else if (TokenType::CLOSING_CURLY_BRACE == current_token.Type)
+                --brace_depth;
+            }
+            else if (TokenType::OPENING_CURLY_BRACE == token.Type)
+            {
+                ++brace_depth;
+            }
+
+            ++token_stream.CurrentIndex;
+            if (0 == brace_depth && ";" == token.Value && TokenType::PUNCTUATOR == token.Type)
+            {
+                return;
+            }
+        }
+    }
+
+private:
+    /// Parses a statement that must be a single statement, such as the body of a loop.
+    static std::optional<Statement> ParseSingle(TOKENIZATION::TokenStream& token_stream, std::string& error_messages);
+
+    /// Parses declarations of one or more variables of the same base type.
+    static bool ParseDeclarations(TOKENIZATION::TokenStream& token_stream, std::vector<Statement>& statements, std::string& error_messages);
+
+    /// Parses an expression in parentheses, such as the condition of an if statement.
+    static std::optional<Expression> ParseParenthesizedCondition(TOKENIZATION::TokenStream& token_stream, const std::string& context, std::string& error_messages)
+    {
+        if (!ExpectToken(token_stream, "(", "after " + context, error_messages))
+        {
+            return std::nullopt;
+        }
+        std::optional<Expression> condition = Expression::Parse(token_stream, error_messages);
+        if (!condition || !ExpectToken(token_stream, ")", "after " + context + " condition", error_messages))
+        {
+            return std::nullopt;
+        }
+        return condition;
+    }
+};
+
+struct Block
+{
+    std::vector<Statement> Statements = {};
+
+    /// Parses a block, including its curly braces.
+    /// Statements that can't be parsed are reported and skipped so that later errors are also found.
+    /// @param[in,out] token_stream - The tokens being parsed.
+    /// @param[in,out] error_messages - The error messages to add to, one per line.
+    /// @return The block, if it could be parsed; null otherwise.
+    static std::optional<Block> Parse(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+    {
+        using namespace TOKENIZATION;
+
+        if (!ConsumeNextTokenIfValue(token_stream, "{"))
+        {
+            return std::nullopt;
+        }
+
+        Block block;
+        bool all_statements_parsed = true;
+        while (token_stream.PeekNonCommentToken())
+        {
+            if (ConsumeNextTokenIfValue(token_stream, "}"))
+            {
+                if (!all_statements_parsed)
                 {
-                    /// @todo Success!  Ending current block.
-                    return block;
+                    return std::nullopt;
                 }
+                return block;
+            }
+
+            bool statement_parsed = Statement::Parse(token_stream, block.Statements, error_messages);
+            if (!statement_parsed)
+            {
+                all_statements_parsed = false;
+                Statement::SkipToEnd(token_stream);
             }
         }
-        
-        return block;
+
+        AddParseError(token_stream, "Expected '}' at end of block.", error_messages);
+        return std::nullopt;
     }
 };
 
+bool Statement::Parse(TOKENIZATION::TokenStream& token_stream, std::vector<Statement>& statements, std::string& error_messages)
+{
+    using namespace TOKENIZATION;
+
+    const Token* token = token_stream.PeekNonCommentToken();
+    if (!token)
+    {
+        AddParseError(token_stream, "Expected a statement.", error_messages);
+        return false;
+    }
+    Statement statement = { .LineNumber = token->LineNumber };
+
+    // PARSE BLOCKS AND EMPTY STATEMENTS.
+    if (TokenType::OPENING_CURLY_BRACE == token->Type)
+    {
+        std::optional<Block> block = Block::Parse(token_stream, error_messages);
+        if (!block)
+        {
+            return false;
+        }
+        statement.Kind = StatementKind::BLOCK;
+        statement.Body = std::move(block->Statements);
+        statements.push_back(std::move(statement));
+        return true;
+    }
+    if (ConsumeNextTokenIfValue(token_stream, ";"))
+    {
+        statement.Kind = StatementKind::EMPTY;
+        statements.push_back(std::move(statement));
+        return true;
+    }
+
+    // PARSE DECLARATIONS.
+    bool is_declaration = (TokenType::DATA_TYPE == token->Type || DeclarationSpecifiers::IsSpecifier(*token));
+    if (is_declaration)
+    {
+        return ParseDeclarations(token_stream, statements, error_messages);
+    }
+
+    // PARSE EXPRESSION STATEMENTS.
+    if (TokenType::KEYWORD != token->Type)
+    {
+        statement.Kind = StatementKind::EXPRESSION;
+        statement.Value = Expression::Parse(token_stream, error_messages);
+        if (!statement.Value || !ExpectToken(token_stream, ";", "after expression", error_messages))
+        {
+            return false;
+        }
+        statements.push_back(std::move(statement));
+        return true;
+    }
+
+    // PARSE STATEMENTS STARTING WITH KEYWORDS.
+    std::string keyword = token->Value;
+    token_stream.SkipComments();
+    ++token_stream.CurrentIndex;
+    if ("return" == keyword)
+    {
+        statement.Kind = StatementKind::RETURN;
+        if (!ConsumeNextTokenIfValue(token_stream, ";"))
+        {
+            statement.Value = Expression::Parse(token_stream, error_messages);
+            if (!statement.Value || !ExpectToken(token_stream, ";", "after return value", error_messages))
+            {
+                return false;
+            }
+        }
+    }
+    else if ("break" == keyword || "continue" == keyword)
+    {
+        statement.Kind = ("break" == keyword) ? StatementKind::BREAK : StatementKind::CONTINUE;
+        if (!ExpectToken(token_stream, ";", "after " + keyword, error_messages))
+        {
+            return false;
+        }
+    }
+    else if ("if" == keyword)
+    {
+        statement.Kind = StatementKind::IF;
+        statement.Condition = ParseParenthesizedCondition(token_stream, "if", error_messages);
+        if (!statement.Condition)
+        {
+            return false;
+        }
+        std::optional<Statement> true_statement = ParseSingle(token_stream, error_messages);
+        if (!true_statement)
+        {
+            return false;
+        }
+        statement.Body.push_back(std::move(*true_statement));
+
+        const Token* else_token = token_stream.PeekNonCommentToken();
+        bool has_else = (else_token && TokenType::KEYWORD == else_token->Type && "else" == else_token->Value);
+        if (has_else)
+        {
+            ConsumeNextTokenIfValue(token_stream, "else");
+            std::optional<Statement> false_statement = ParseSingle(token_stream, error_messages);
+            if (!false_statement)
+            {
+                return false;
+            }
+            statement.Body.push_back(std::move(*false_statement));
+        }
+    }
+    else if ("while" == keyword)
+    {
+        statement.Kind = StatementKind::WHILE;
+        statement.Condition = ParseParenthesizedCondition(token_stream, "while", error_messages);
+        if (!statement.Condition)
+        {
+            return false;
+        }
+        std::optional<Statement> loop_statement = ParseSingle(token_stream, error_messages);
+        if (!loop_statement)
+        {
+            return false;
+        }
+        statement.Body.push_back(std::move(*loop_statement));
+    }
+    else if ("do" == keyword)
+    {
+        statement.Kind = StatementKind::DO_WHILE;
+        std::optional<Statement> loop_statement = ParseSingle(token_stream, error_messages);
+        if (!loop_statement)
+        {
+            return false;
+        }
+        statement.Body.push_back(std::move(*loop_statement));
+
+        const Token* while_token = token_stream.PeekNonCommentToken();
+        bool has_while = (while_token && TokenType::KEYWORD == while_token->Type && "while" == while_token->Value);
+        if (!has_while)
+        {
+            AddParseError(token_stream, "Expected 'while' after do loop body.", error_messages);
+            return false;
+        }
+        ConsumeNextTokenIfValue(token_stream, "while");
+        statement.Condition = ParseParenthesizedCondition(token_stream, "do-while", error_messages);
+        if (!statement.Condition || !ExpectToken(token_stream, ";", "after do-while condition", error_messages))
+        {
+            return false;
+        }
+    }
+    else if ("for" == keyword)
+    {
+        // PARSE THE INITIALIZER.
+        statement.Kind = StatementKind::FOR;
+        if (!ExpectToken(token_stream, "(", "after for", error_messages))
+        {
+            return false;
+        }
+        std::optional<Statement> initializer = ParseSingle(token_stream, error_messages);
+        if (!initializer)
+        {
+            return false;
+        }
+        bool initializer_valid = (StatementKind::EMPTY == initializer->Kind || StatementKind::EXPRESSION == initializer->Kind || StatementKind::DECLARATION == initializer->Kind);
+        if (!initializer_valid)
+        {
+            AddParseError(token_stream, "Expected an expression or single declaration in for loop initializer.", error_messages);
+            return false;
+        }
+        statement.Body.push_back(std::move(*initializer));
+
+        // PARSE THE CONDITION AND STEP.
+        if (!ConsumeNextTokenIfValue(token_stream, ";"))
+        {
+            statement.Condition = Expression::Parse(token_stream, error_messages);
+            if (!statement.Condition || !ExpectToken(token_stream, ";", "after for loop condition", error_messages))
+            {
+                return false;
+            }
+        }
+        if (!ConsumeNextTokenIfValue(token_stream, ")"))
+        {
+            statement.Step = Expression::Parse(token_stream, error_messages);
+            if (!statement.Step || !ExpectToken(token_stream, ")", "after for loop step", error_messages))
+            {
+                return false;
+            }
+        }
+
+        // PARSE THE LOOP'S STATEMENT.
+        std::optional<Statement> loop_statement = ParseSingle(token_stream, error_messages);
+        if (!loop_statement)
+        {
+            return false;
+        }
+        statement.Body.push_back(std::move(*loop_statement));
+    }
+    else
+    {
+        --token_stream.CurrentIndex;
+        AddParseError(token_stream, "Unsupported statement starting with '" + keyword + "'.", error_messages);
+        ++token_stream.CurrentIndex;
+        return false;
+    }
+
+    statements.push_back(std::move(statement));
+    return true;
+}
+
+std::optional<Statement> Statement::ParseSingle(TOKENIZATION::TokenStream& token_stream, std::string& error_messages)
+{
+    std::vector<Statement> statements;
+    bool parsed = Parse(token_stream, statements, error_messages);
+    if (!parsed)
+    {
+        return std::nullopt;
+    }
+    if (statements.size() != 1)
+    {
+        AddParseError(token_stream, "Expected a single statement.", error_messages);
+        return std::nullopt;
+    }
+    return std::move(statements.front());
+}
+
+bool Statement::ParseDeclarations(TOKENIZATION::TokenStream& token_stream, std::vector<Statement>& statements, std::string& error_messages)
+{
+    using namespace TOKENIZATION;
+
+    // PARSE THE BASE TYPE.
+    std::size_t line_number = token_stream.PeekNonCommentToken()->LineNumber;
+    DeclarationSpecifiers specifiers;
+    std::optional<std::string> base_data_type = VariableDeclaration::ParseDataType(token_stream, specifiers);
+    if (!base_data_type)
+    {
+        AddParseError(token_stream, "Expected a type in declaration.", error_messages);
+        return false;
+    }
+
+    // PARSE EACH DECLARED VARIABLE.
+    // Pointer declarators apply to individual variables, while any from the base type were already consumed.
+    std::string data_type = *base_data_type;
+    do
+    {
+        while (ConsumeNextTokenIfValue(token_stream, "*"))
+        {
+            data_type += "*";
+        }
+
+        token_stream.SkipComments();
+        std::optional<Token> name = token_stream.ConsumeNextTokenIfMatch(TokenType::IDENTIFIER);
+        if (!name)
+        {
+            AddParseError(token_stream, "Expected a variable name in declaration.", error_messages);
+            return false;
+        }
+
+        if (ConsumeNextTokenIfValue(token_stream, "["))
+        {
+            token_stream.SkipComments();
+            std::optional<Token> element_count = token_stream.ConsumeNextTokenIfMatch(TokenType::CONSTANT);
+            if (!element_count || !ExpectToken(token_stream, "]", "after array size", error_messages))
+            {
+                AddParseError(token_stream, "Expected a constant array size.", error_messages);
+                return false;
+            }
+            data_type += "[" + element_count->Value + "]";
+        }
+
+        Statement statement =
+        {
+            .Kind = StatementKind::DECLARATION,
+            .Declaration = VariableDeclaration { .DataType = data_type, .Name = name->Value, .Specifiers = specifiers },
+            .LineNumber = line_number,
+        };
+        if (ConsumeNextTokenIfValue(token_stream, "="))
+        {
+            statement.Value = Expression::Parse(token_stream, error_messages);
+            if (!statement.Value)
+            {
+                return false;
+            }
+        }
+        statements.push_back(std::move(statement));
+
+        data_type = *base_data_type;
+    } while (ConsumeNextTokenIfValue(token_stream, ","));
+
+    bool declaration_ended = ExpectToken(token_stream, ";", "after declaration", error_messages);
+    return declaration_ended;
+}
+
 struct FunctionDefinition
 {
-    FunctionHeader Header;
-    //std::vector<Statement> Body;
-    Block Body;
+    FunctionHeader Header = {};
+    Block Body = {};
 };
 
 struct Program
 {
     //std::shared_ptr<FunctionDefinition> EntryPoint;
-    
+
     std::unordered_map<std::string, FunctionDefinition> FunctionsByName;
+    /// Functions declared without being defined (such as library functions), by name.
+    std::unordered_map<std::string, FunctionHeader> FunctionDeclarationsByName;
+    /// Any errors from parsing, one per line.  Programs with errors are incomplete.
+    std::string ErrorMessages = "";
+    /// The types resolved by semantic analysis, if it has run.  Kept alive
+    /// with the program since resolved expression types point into it.
+    std::shared_ptr<const SEMANTIC_ANALYSIS::TypeTable> Types = nullptr;
+
+    /// Adds a function definition, unless the function is already defined.
+    /// @param[in] function_definition - The definition to add.
+    /// @return True if the definition was added; false if the function was already defined,
+    ///     in which case an error is added and the earlier definition is kept.
+    bool AddFunction(FunctionDefinition&& function_definition)
+    {
+        const FunctionHeader& header = function_definition.Header;
+        auto existing_function = FunctionsByName.find(header.Name);
+        if (FunctionsByName.end() != existing_function)
+        {
+            const FunctionHeader& existing_header = existing_function->second.Header;
+            std::string existing_location = (header.Filepath == existing_header.Filepath) ?
+                "on line " + std::to_string(existing_header.LineNumber) :
+                "at " + existing_header.Filepath + ":" + std::to_string(existing_header.LineNumber);
+            ErrorMessages += header.Filepath + ":" + std::to_string(header.LineNumber) + ": error: Redefinition of function " + header.Name +
+                " (previously defined " + existing_location + ").\n";
+            return false;
+        }
+
+        std::string function_name = header.Name;
+        FunctionsByName.emplace(std::move(function_name), std::move(function_definition));
+        return true;
+    }
 };
 
 
-Program Parse(TOKENIZATION::TokenStream& token_stream)
+/// Parses the top-level item starting at the current position in a token stream,
+/// leaving the stream positioned after it.  Assumes there is another token.
+/// @param[in,out] token_stream - The tokens being parsed.
+/// @param[in,out] program - The program to add the item to.
+void ParseTopLevelItem(TOKENIZATION::TokenStream& token_stream, Program& program)
 {
     using namespace TOKENIZATION;
-    
-    Program program;
-    
-    while (token_stream.MoreTokens())
+
+    Token current_token = token_stream.ConsumeNextToken();
+
+    // PARSE ITEMS STARTING WITH THE CURRENT TOKEN.
+    switch (current_token.Type)
     {
-        Token current_token = token_stream.ConsumeNextToken();
-        std::printf("Current token: %s\n", current_token.Value.c_str());
-        
-        // PARSE ITEMS STARTING WITH THE CURRENT TOKEN.
-        switch (current_token.Type)
+        case TokenType::KEYWORD:
+            // Functions can start with a storage class or qualifier, but other keywords can't start an item yet.
+            if (!DeclarationSpecifiers::IsSpecifier(current_token))
+            {
+                return;
+            }
+            [[fallthrough]];
+        case TokenType::DATA_TYPE:
         {
-            case TokenType::DATA_TYPE:
+            // CHECK IF THE NEXT TOKENS ARE FOR THE START OF A FUNCTION SIGNATURE.
+            // Anything else at the top level isn't parsed yet, so it's skipped.
+            std::size_t start_index = token_stream.CurrentIndex - 1;
+            token_stream.CurrentIndex = start_index;
+            DeclarationSpecifiers specifiers;
+            std::optional<std::string> return_type = VariableDeclaration::ParseDataType(token_stream, specifiers);
+            token_stream.SkipComments();
+            std::vector<Token> function_signature_start_tokens = token_stream.ConsumeNextTokensIfMatch({ TokenType::IDENTIFIER, TokenType::OPENING_PARENTHESIS });
+            bool is_start_of_function_signature = (return_type && !function_signature_start_tokens.empty());
+            if (!is_start_of_function_signature)
+            {
+                token_stream.CurrentIndex = start_index + 1;
+                return;
+            }
+
+            constexpr std::size_t FUNCTION_NAME_INDEX = 0;
+            const Token& function_name_token = function_signature_start_tokens[FUNCTION_NAME_INDEX];
+            FunctionHeader function_header =
             {
-                // CHECK IF THE NEXT TOKENS ARE FOR THE START OF A FUNCTION SIGNATURE.
-                std::vector<Token> function_signature_start_tokens = token_stream.ConsumeNextTokensIfMatch({ TokenType::IDENTIFIER, TokenType::OPENING_PARENTHESIS });
-                bool is_start_of_function_signature = !function_signature_start_tokens.empty();
-                if (is_start_of_function_signature)
+                .Name = function_name_token.Value,
+                .ReturnType = *return_type,
+                .Filepath = function_name_token.Filepath,
+                .LineNumber = function_name_token.LineNumber,
+                .Specifiers = specifiers,
+            };
+            bool parameters_parsed = FunctionHeader::ParseParameters(token_stream, function_header);
+            if (!parameters_parsed)
+            {
+                token_stream.CurrentIndex = start_index + 1;
+                return;
+            }
+
+            // PARSE ANY DECLARATION WITHOUT A DEFINITION.
+            if (ConsumeNextTokenIfValue(token_stream, ";"))
+            {
+                program.FunctionDeclarationsByName[function_header.Name] = std::move(function_header);
+                return;
+            }
+
+            // PARSE THE FUNCTION BODY.
+            const Token* body_start_token = token_stream.PeekNonCommentToken();
+            if (!body_start_token || TokenType::OPENING_CURLY_BRACE != body_start_token->Type)
+            {
+                token_stream.CurrentIndex = start_index + 1;
+                return;
+            }
+            std::optional<Block> function_body = Block::Parse(token_stream, program.ErrorMessages);
+            if (function_body)
+            {
+                FunctionDefinition function_definition =
                 {
-                    std::printf("Is start of function signature\n");
-                    /// @todo Handle parameter lists!
-                    std::optional<Token> function_signature_end_token = token_stream.ConsumeNextTokenIfMatch(TokenType::CLOSING_PARENTHESIS);
-                    if (function_signature_end_token)
-                    {
-                        std::printf("Trying to parse block.\n");
-                        /// @todo Handle statement ending
-                        std::optional<Block> function_body = Block::Parse(token_stream);
-                        if (function_body)
-                        {
-                            std::printf("Function body\n");
-                            FunctionDefinition function_definition;
-                            function_definition.Header.ReturnType = current_token.Value;
-                            constexpr std::size_t FUNCTION_NAME_INDEX = 0;
-                            function_definition.Header.Name = function_signature_start_tokens[FUNCTION_NAME_INDEX].Value;
-                            
-                            /// @todo What if function already declared?
-                            program.FunctionsByName[function_definition.Header.Name] = function_definition;
-                        }
-                    }
-                    else
-                    {
-                        /// @todo Error?
-                    }
-                }
-                
-                /*
-                function-definition:
-                    declaration-specifiers-opt declarator declaration-list-opt compound-statement
-                */
-                
-                break;
+                    .Header = std::move(function_header),
+                    .Body = std::move(*function_body),
+                };
+
+                program.AddFunction(std::move(function_definition));
             }
+
+            /*
+            function-definition:
+                declaration-specifiers-opt declarator declaration-list-opt compound-statement
+            */
+
+            return;
         }
+        default:
+            return;
+    }
+}
+
+Program Parse(TOKENIZATION::TokenStream& token_stream)
+{
+    Program program;
+
+    while (token_stream.MoreTokens())
+    {
+        ParseTopLevelItem(token_stream, program);
     }
-    
+
     return program;
 }
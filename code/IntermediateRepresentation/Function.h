@@ -0,0 +1,532 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IntermediateRepresentation/Instruction.h"
+
+namespace INTERMEDIATE_REPRESENTATION
+{
+    /// A straight-line sequence of instructions ending in a terminator.
+    struct BasicBlock
+    {
+        /// The instructions in order, with any phis first and the terminator last.
+        std::vector<ValueId> Instructions = {};
+        /// The blocks that can continue to this one.  The order matches phi operands.
+        std::vector<BlockId> Predecessors = {};
+        /// The blocks this one can continue to, in the order of its terminator's targets.
+        std::vector<BlockId> Successors = {};
+    };
+
+    /// A function in SSA form.
+    ///
+    /// All instructions, operands, and uses live in dense arrays indexed by
+    /// 32-bit IDs rather than in separately allocated nodes.  Removing an
+    /// instruction marks it deleted rather than reusing its ID, so IDs stay
+    /// valid as keys for side tables throughout optimization.
+    struct Function
+    {
+        /// The ID of the block where execution starts.
+        static constexpr BlockId ENTRY_BLOCK_ID = 0;
+
+        /// Creates a new empty block.
+        /// @return The ID of the block.
+        BlockId CreateBlock()
+        {
+            BlockId block_id = static_cast<BlockId>(Blocks.size());
+            Blocks.emplace_back();
+            return block_id;
+        }
+
+        /// Gets a constant, creating it if it doesn't already exist.
+        /// Constants are shared, so equal constants always have the same ID.
+        /// @param[in] type - The type of the constant.
+        /// @param[in] value - The value of the constant, which is truncated to the type.
+        /// @return The ID of the constant.
+        ValueId GetConstant(const ValueType type, const std::int64_t value)
+        {
+            std::int64_t normalized_value = NormalizeConstant(type, value);
+            ConstantKey key = { .Value = normalized_value, .Type = type };
+            auto existing_constant = ConstantsByValue.find(key);
+            if (ConstantsByValue.end() != existing_constant)
+            {
+                return existing_constant->second;
+            }
+
+            ValueId constant = CreateValue(InstructionKind::CONSTANT, type, normalized_value);
+            ConstantsByValue.emplace(key, constant);
+            return constant;
+        }
+
+        /// Gets the undefined value of a type, creating it if it doesn't already exist.
+        /// @param[in] type - The type of the value.
+        /// @return The ID of the undefined value.
+        ValueId GetUndefined(const ValueType type)
+        {
+            ConstantKey key = { .Value = 0, .Type = type, .IsUndefined = true };
+            auto existing_value = ConstantsByValue.find(key);
+            if (ConstantsByValue.end() != existing_value)
+            {
+                return existing_value->second;
+            }
+
+            ValueId undefined_value = CreateValue(InstructionKind::UNDEFINED, type, 0);
+            ConstantsByValue.emplace(key, undefined_value);
+            return undefined_value;
+        }
+
+        /// Adds an instruction to the end of a block.
+        /// @param[in] block_id - The block.
+        /// @param[in] kind - The kind of instruction.
+        /// @param[in] type - The type of value produced.
+        /// @param[in] operands - The operands.
+        /// @param[in] immediate - Any constant specific to the kind of instruction.
+        /// @return The ID of the instruction.
+        ValueId AppendInstruction(
+            const BlockId block_id,
+            const InstructionKind kind,
+            const ValueType type,
+            const std::span<const ValueId> operands,
+            const std::int64_t immediate = 0)
+        {
+            ValueId instruction_id = CreateInstruction(block_id, kind, type, operands, immediate);
+            Blocks[block_id].Instructions.push_back(instruction_id);
+            return instruction_id;
+        }
+
+        /// Adds an instruction to the end of a block.
+        /// @param[in] block_id - The block.
+        /// @param[in] kind - The kind of instruction.
+        /// @param[in] type - The type of value produced.
+        /// @param[in] operands - The operands.
+        /// @param[in] immediate - Any constant specific to the kind of instruction.
+        /// @return The ID of the instruction.
+        ValueId AppendInstruction(
+            const BlockId block_id,
+            const InstructionKind kind,
+            const ValueType type,
+            const std::initializer_list<ValueId> operands,
+            const std::int64_t immediate = 0)
+        {
+            return AppendInstruction(block_id, kind, type, std::span<const ValueId>(operands.begin(), operands.size()), immediate);
+        }
+
+        /// Inserts an instruction at a position within a block.
+        /// @param[in] block_id - The block.
+        /// @param[in] position - The index within the block's instructions to insert at.
+        /// @param[in] kind - The kind of instruction.
+        /// @param[in] type - The type of value produced.
+        /// @param[in] operands - The operands.
+        /// @param[in] immediate - Any constant specific to the kind of instruction.
+        /// @return The ID of the instruction.
+        ValueId InsertInstruction(
+            const BlockId block_id,
+            const std::size_t position,
+            const InstructionKind kind,
+            const ValueType type,
+            const std::initializer_list<ValueId> operands,
+            const std::int64_t immediate = 0)
+        {
+            ValueId instruction_id = CreateInstruction(block_id, kind, type, std::span<const ValueId>(operands.begin(), operands.size()), immediate);
+            std::vector<ValueId>& block_instructions = Blocks[block_id].Instructions;
+            block_instructions.insert(block_instructions.begin() + static_cast<std::ptrdiff_t>(position), instruction_id);
+            return instruction_id;
+        }
+
+        /// Adds a phi without operands after any existing phis at the start of a block.
+        /// @param[in] block_id - The block.
+        /// @param[in] type - The type of the phi.
+        /// @return The ID of the phi.
+        ValueId AddPhi(const BlockId block_id, const ValueType type)
+        {
+            const std::vector<ValueId>& block_instructions = Blocks[block_id].Instructions;
+            std::size_t position = 0;
+            while (position < block_instructions.size() && InstructionKind::PHI == Values[block_instructions[position]].Kind)
+            {
+                ++position;
+            }
+            return InsertInstruction(block_id, position, InstructionKind::PHI, type, {});
+        }
+
+        /// Gets the operands of an instruction.
+        /// @param[in] instruction_id - The instruction.
+        /// @return The operands, valid until operands are next added anywhere in the function.
+        std::span<const ValueId> GetOperands(const ValueId instruction_id) const
+        {
+            const Instruction& instruction = Values[instruction_id];
+            return std::span<const ValueId>(Operands.data() + instruction.FirstOperandIndex, instruction.OperandCount);
+        }
+
+        /// Gets an operand of an instruction.
+        /// @param[in] instruction_id - The instruction.
+        /// @param[in] operand_index - The index of the operand.
+        /// @return The operand.
+        ValueId GetOperand(const ValueId instruction_id, const std::size_t operand_index) const
+        {
+            return Operands[Values[instruction_id].FirstOperandIndex + operand_index];
+        }
+
+        /// Adds an operand to the end of an instruction's operands.
+        /// @param[in] instruction_id - The instruction.
+        /// @param[in] value - The operand to add.
+        void AddOperand(const ValueId instruction_id, const ValueId value)
+        {
+            // MOVE THE OPERANDS TO THE END OF THE ARRAY IF THEY DON'T FIT.
+            // Doubling the capacity keeps adding operands one at a time (as for phis) amortized constant.
+            Instruction& instruction = Values[instruction_id];
+            if (instruction.OperandCount == instruction.OperandCapacity)
+            {
+                std::uint32_t new_capacity = std::max<std::uint32_t>(2, instruction.OperandCapacity * 2);
+                std::uint32_t new_first_operand_index = static_cast<std::uint32_t>(Operands.size());
+                Operands.resize(Operands.size() + new_capacity, INVALID_ID);
+                OperandUses.resize(OperandUses.size() + new_capacity, INVALID_ID);
+                std::copy_n(Operands.begin() + instruction.FirstOperandIndex, instruction.OperandCount, Operands.begin() + new_first_operand_index);
+                std::copy_n(OperandUses.begin() + instruction.FirstOperandIndex, instruction.OperandCount, OperandUses.begin() + new_first_operand_index);
+                instruction.FirstOperandIndex = new_first_operand_index;
+                instruction.OperandCapacity = new_capacity;
+            }
+
+            // ADD THE OPERAND.
+            std::uint32_t operand_index = instruction.OperandCount;
+            ++instruction.OperandCount;
+            std::uint32_t operand_slot = instruction.FirstOperandIndex + operand_index;
+            Operands[operand_slot] = value;
+            OperandUses[operand_slot] = AddUse(value, instruction_id, operand_index);
+        }
+
+        /// Changes an operand of an instruction.
+        /// @param[in] instruction_id - The instruction.
+        /// @param[in] operand_index - The index of the operand to change.
+        /// @param[in] value - The new operand.
+        void SetOperand(const ValueId instruction_id, const std::uint32_t operand_index, const ValueId value)
+        {
+            std::uint32_t operand_slot = Values[instruction_id].FirstOperandIndex + operand_index;
+            RemoveUse(Operands[operand_slot], OperandUses[operand_slot]);
+            Operands[operand_slot] = value;
+            OperandUses[operand_slot] = AddUse(value, instruction_id, operand_index);
+        }
+
+        /// Removes an operand from an instruction, shifting later operands down.
+        /// @param[in] instruction_id - The instruction.
+        /// @param[in] operand_index - The index of the operand to remove.
+        void RemoveOperand(const ValueId instruction_id, const std::uint32_t operand_index)
+        {
+            Instruction& instruction = Values[instruction_id];
+            std::uint32_t operand_slot = instruction.FirstOperandIndex + operand_index;
+            RemoveUse(Operands[operand_slot], OperandUses[operand_slot]);
+            for (std::uint32_t later_operand_index = operand_index + 1; later_operand_index < instruction.OperandCount; ++later_operand_index)
+            {
+                std::uint32_t later_operand_slot = instruction.FirstOperandIndex + later_operand_index;
+                Operands[later_operand_slot - 1] = Operands[later_operand_slot];
+                OperandUses[later_operand_slot - 1] = OperandUses[later_operand_slot];
+                Uses[OperandUses[later_operand_slot - 1]].OperandIndex = later_operand_index - 1;
+            }
+            --instruction.OperandCount;
+        }
+
+        /// Replaces all uses of a value with another value.
+        /// @param[in] old_value - The value to replace.
+        /// @param[in] new_value - The value to use instead.
+        void ReplaceAllUsesWith(const ValueId old_value, const ValueId new_value)
+        {
+            while (INVALID_ID != Values[old_value].FirstUse)
+            {
+                const Use& use = Uses[Values[old_value].FirstUse];
+                SetOperand(use.User, use.OperandIndex, new_value);
+            }
+        }
+
+        /// Gets the instructions using a value.
+        /// @param[in] value - The value.
+        /// @return The users, once per use (so instructions using the value twice appear twice).
+        std::vector<ValueId> GetUsers(const ValueId value) const
+        {
+            std::vector<ValueId> users;
+            for (UseId use_id = Values[value].FirstUse; INVALID_ID != use_id; use_id = Uses[use_id].NextUse)
+            {
+                users.push_back(Uses[use_id].User);
+            }
+            return users;
+        }
+
+        /// Determines if a value is used by any instruction.
+        /// @param[in] value - The value.
+        /// @return True if the value has uses; false otherwise.
+        bool HasUses(const ValueId value) const
+        {
+            return INVALID_ID != Values[value].FirstUse;
+        }
+
+        /// Removes an instruction from its block and releases its operands.
+        /// The instruction's value must no longer be used.
+        /// @param[in] instruction_id - The instruction.
+        void RemoveInstruction(const ValueId instruction_id)
+        {
+            Instruction& instruction = Values[instruction_id];
+            if (INVALID_ID != instruction.Block)
+            {
+                std::vector<ValueId>& block_instructions = Blocks[instruction.Block].Instructions;
+                block_instructions.erase(std::find(block_instructions.begin(), block_instructions.end(), instruction_id));
+            }
+            DeleteInstruction(instruction_id);
+        }
+
+        /// Marks an instruction deleted and releases its operands without removing it from its block.
+        /// Useful when many instructions are removed from a block at once, with the block compacted afterward.
+        /// @param[in] instruction_id - The instruction.
+        void DeleteInstruction(const ValueId instruction_id)
+        {
+            Instruction& instruction = Values[instruction_id];
+            for (std::uint32_t operand_index = 0; operand_index < instruction.OperandCount; ++operand_index)
+            {
+                std::uint32_t operand_slot = instruction.FirstOperandIndex + operand_index;
+                RemoveUse(Operands[operand_slot], OperandUses[operand_slot]);
+            }
+            instruction.OperandCount = 0;
+            instruction.Kind = InstructionKind::DELETED;
+            instruction.Block = INVALID_ID;
+        }
+
+        /// Gets the terminator of a block.
+        /// @param[in] block_id - The block.
+        /// @return The terminator, if the block has one; invalid otherwise.
+        ValueId GetTerminator(const BlockId block_id) const
+        {
+            const std::vector<ValueId>& block_instructions = Blocks[block_id].Instructions;
+            if (block_instructions.empty() || !IsTerminator(Values[block_instructions.back()].Kind))
+            {
+                return INVALID_ID;
+            }
+            return block_instructions.back();
+        }
+
+        /// Adds a control flow edge between blocks.  Phis in the target get no operand
+        /// for the new predecessor, so one must be added to each of them.
+        /// @param[in] from_block_id - The block control flows from.
+        /// @param[in] to_block_id - The block control flows to.
+        void AddEdge(const BlockId from_block_id, const BlockId to_block_id)
+        {
+            Blocks[from_block_id].Successors.push_back(to_block_id);
+            Blocks[to_block_id].Predecessors.push_back(from_block_id);
+        }
+
+        /// Removes a control flow edge between blocks, along with the corresponding phi operands.
+        /// The source block's terminator must be updated to match separately.
+        /// @param[in] from_block_id - The block control flows from.
+        /// @param[in] to_block_id - The block control flows to.
+        void RemoveEdge(const BlockId from_block_id, const BlockId to_block_id)
+        {
+            std::vector<BlockId>& successors = Blocks[from_block_id].Successors;
+            successors.erase(std::find(successors.begin(), successors.end(), to_block_id));
+
+            std::vector<BlockId>& predecessors = Blocks[to_block_id].Predecessors;
+            auto predecessor = std::find(predecessors.begin(), predecessors.end(), from_block_id);
+            std::uint32_t predecessor_index = static_cast<std::uint32_t>(predecessor - predecessors.begin());
+            predecessors.erase(predecessor);
+            for (const ValueId instruction_id : Blocks[to_block_id].Instructions)
+            {
+                if (InstructionKind::PHI != Values[instruction_id].Kind)
+                {
+                    break;
+                }
+                RemoveOperand(instruction_id, predecessor_index);
+            }
+        }
+
+        /// Determines if a value is a constant.
+        /// @param[in] value - The value.
+        /// @return True if the value is a constant; false otherwise.
+        bool IsConstant(const ValueId value) const
+        {
+            return InstructionKind::CONSTANT == Values[value].Kind;
+        }
+
+        /// Truncates a value to the width of a type, sign-extending it back to 64 bits
+        /// so that each constant has a single representation.
+        /// @param[in] type - The type.
+        /// @param[in] value - The value.
+        /// @return The normalized value.
+        static std::int64_t NormalizeConstant(const ValueType type, const std::int64_t value)
+        {
+            switch (type)
+            {
+                case ValueType::I8:
+                    return static_cast<std::int8_t>(value);
+                case ValueType::I16:
+                    return static_cast<std::int16_t>(value);
+                case ValueType::I32:
+                    return static_cast<std::int32_t>(value);
+                default:
+                    return value;
+            }
+        }
+
+        /// The name of the function.
+        std::string Name = "";
+        /// The type of value returned.
+        ValueType ReturnType = ValueType::VOID;
+        /// The types of the parameters.
+        std::vector<ValueType> ParameterTypes = {};
+        /// True if the function is variadic.
+        bool IsVariadic = false;
+        /// True if the function is static, so it's only visible within its translation unit.
+        bool IsStatic = false;
+        /// All instructions (including constants) by value ID.
+        std::vector<Instruction> Values = {};
+        /// The operands of all instructions, in slices referenced by each instruction.
+        std::vector<ValueId> Operands = {};
+        /// The use corresponding to each operand, parallel to the operands.
+        std::vector<UseId> OperandUses = {};
+        /// All uses of values by ID.
+        std::vector<Use> Uses = {};
+        /// All blocks by ID, starting with the entry block.
+        std::vector<BasicBlock> Blocks = {};
+        /// The names of called functions, referenced by call immediates.
+        std::vector<std::string> CalleeNames = {};
+        /// The contents of string literals (without terminators), referenced by string address immediates.
+        std::vector<std::string> StringLiterals = {};
+
+    private:
+        /// Identifies a constant or undefined value for sharing.
+        struct ConstantKey
+        {
+            /// The normalized value.
+            std::int64_t Value = 0;
+            /// The type.
+            ValueType Type = ValueType::VOID;
+            /// True for undefined values rather than constants.
+            bool IsUndefined = false;
+
+            bool operator==(const ConstantKey&) const = default;
+        };
+
+        /// Hashes constant keys.
+        struct ConstantKeyHash
+        {
+            std::size_t operator()(const ConstantKey& key) const
+            {
+                std::uint64_t hash = static_cast<std::uint64_t>(key.Value) * 0x9E3779B97F4A7C15ull;
+                hash ^= (static_cast<std::uint64_t>(key.Type) << 1) | static_cast<std::uint64_t>(key.IsUndefined);
+                return static_cast<std::size_t>(hash);
+            }
+        };
+
+        /// Creates a value outside of any block.
+        /// @param[in] kind - The kind of value.
+        /// @param[in] type - The type of value.
+        /// @param[in] immediate - Any constant specific to the kind of value.
+        /// @return The ID of the value.
+        ValueId CreateValue(const InstructionKind kind, const ValueType type, const std::int64_t immediate)
+        {
+            ValueId value_id = static_cast<ValueId>(Values.size());
+            Values.push_back(Instruction
+            {
+                .Kind = kind,
+                .Type = type,
+                .FirstOperandIndex = static_cast<std::uint32_t>(Operands.size()),
+                .Immediate = immediate,
+            });
+            return value_id;
+        }
+
+        /// Creates an instruction in a block without placing it in the block's instruction order.
+        /// @param[in] block_id - The block.
+        /// @param[in] kind - The kind of instruction.
+        /// @param[in] type - The type of value produced.
+        /// @param[in] operands - The operands.
+        /// @param[in] immediate - Any constant specific to the kind of instruction.
+        /// @return The ID of the instruction.
+        ValueId CreateInstruction(
+            const BlockId block_id,
+            const InstructionKind kind,
+            const ValueType type,
+            const std::span<const ValueId> operands,
+            const std::int64_t immediate)
+        {
+            ValueId instruction_id = CreateValue(kind, type, immediate);
+            Instruction& instruction = Values[instruction_id];
+            instruction.Block = block_id;
+            instruction.OperandCapacity = static_cast<std::uint32_t>(operands.size());
+            Operands.resize(Operands.size() + operands.size(), INVALID_ID);
+            OperandUses.resize(OperandUses.size() + operands.size(), INVALID_ID);
+            for (const ValueId operand : operands)
+            {
+                std::uint32_t operand_index = instruction.OperandCount;
+                ++instruction.OperandCount;
+                Operands[instruction.FirstOperandIndex + operand_index] = operand;
+                OperandUses[instruction.FirstOperandIndex + operand_index] = AddUse(operand, instruction_id, operand_index);
+            }
+            return instruction_id;
+        }
+
+        /// Adds a use of a value to the front of its use list.
+        /// @param[in] value - The value used.
+        /// @param[in] user - The instruction using the value.
+        /// @param[in] operand_index - The index of the operand within the user.
+        /// @return The ID of the use.
+        UseId AddUse(const ValueId value, const ValueId user, const std::uint32_t operand_index)
+        {
+            // REUSE A FREED USE IF POSSIBLE.
+            UseId use_id = FirstFreeUse;
+            if (INVALID_ID != use_id)
+            {
+                FirstFreeUse = Uses[use_id].NextUse;
+            }
+            else
+            {
+                use_id = static_cast<UseId>(Uses.size());
+                Uses.emplace_back();
+            }
+
+            // LINK THE USE INTO THE VALUE'S LIST.
+            UseId next_use_id = Values[value].FirstUse;
+            Uses[use_id] = Use { .User = user, .OperandIndex = operand_index, .NextUse = next_use_id, .PreviousUse = INVALID_ID };
+            if (INVALID_ID != next_use_id)
+            {
+                Uses[next_use_id].PreviousUse = use_id;
+            }
+            Values[value].FirstUse = use_id;
+            return use_id;
+        }
+
+        /// Removes a use from a value's use list.
+        /// @param[in] value - The value used.
+        /// @param[in] use_id - The use to remove.
+        void RemoveUse(const ValueId value, const UseId use_id)
+        {
+            Use& use = Uses[use_id];
+            if (INVALID_ID != use.PreviousUse)
+            {
+                Uses[use.PreviousUse].NextUse = use.NextUse;
+            }
+            else
+            {
+                Values[value].FirstUse = use.NextUse;
+            }
+            if (INVALID_ID != use.NextUse)
+            {
+                Uses[use.NextUse].PreviousUse = use.PreviousUse;
+            }
+
+            use = Use { .User = INVALID_ID, .NextUse = FirstFreeUse };
+            FirstFreeUse = use_id;
+        }
+
+        /// Constants and undefined values by their values, for sharing.
+        std::unordered_map<ConstantKey, ValueId, ConstantKeyHash> ConstantsByValue = {};
+        /// The first use in the list of freed uses.
+        UseId FirstFreeUse = INVALID_ID;
+    };
+
+    /// All functions from a translation unit.
+    struct Module
+    {
+        /// The functions, in name order.
+        std::vector<Function> Functions = {};
+    };
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace INTERMEDIATE_REPRESENTATION
+{
+    /// Identifies a value (the result of an instruction) within a function.
+    using ValueId = std::uint32_t;
+    /// Identifies a basic block within a function.
+    using BlockId = std::uint32_t;
+    /// Identifies a use of a value within a function.
+    using UseId = std::uint32_t;
+
+    /// The ID used when there is no value, block, or use.
+    constexpr std::uint32_t INVALID_ID = std::numeric_limits<std::uint32_t>::max();
+
+    /// The types of values in the IR.  Signedness isn't part of a type;
+    /// operations that depend on it (like division) have separate kinds.
+    enum class ValueType : std::uint8_t
+    {
+        /// The type of instructions that don't produce a value.
+        VOID = 0,
+        I8,
+        I16,
+        I32,
+        I64,
+        PTR,
+    };
+
+    /// Gets the name of a value type as it appears in IR dumps.
+    /// @param[in] type - The type.
+    /// @return The name of the type.
+    inline const char* GetValueTypeName(const ValueType type)
+    {
+        switch (type)
+        {
+            case ValueType::VOID:
+                return "void";
+            case ValueType::I8:
+                return "i8";
+            case ValueType::I16:
+                return "i16";
+            case ValueType::I32:
+                return "i32";
+            case ValueType::I64:
+                return "i64";
+            case ValueType::PTR:
+                return "ptr";
+            default:
+                return "?";
+        }
+    }
+
+    /// Gets the size of a value type.
+    /// @param[in] type - The type.
+    /// @return The size of values of the type in bytes (0 for void).
+    inline std::size_t GetValueTypeSizeInBytes(const ValueType type)
+    {
+        switch (type)
+        {
+            case ValueType::I8:
+                return 1;
+            case ValueType::I16:
+                return 2;
+            case ValueType::I32:
+                return 4;
+            case ValueType::I64:
+            case ValueType::PTR:
+                return 8;
+            default:
+                return 0;
+        }
+    }
+
+    /// The different kinds of instructions.
+    enum class InstructionKind : std::uint8_t
+    {
+        /// An instruction removed from its function.  Its ID isn't reused.
+        DELETED = 0,
+
+        // VALUES OUTSIDE OF ANY BLOCK.
+        /// A constant with the instruction's immediate as its value.
+        CONSTANT,
+        /// A value that may be anything, such as an uninitialized variable.
+        UNDEFINED,
+
+        // VALUES DEFINED AT THE START OF BLOCKS.
+        /// A function parameter, with its index as the immediate.  Only in the entry block.
+        PARAMETER,
+        /// Selects the operand for the predecessor control came from.  Operand i
+        /// corresponds to predecessor i of the block.  Only at the start of blocks.
+        PHI,
+        /// The address of stack memory, with its size in bytes as the immediate.  Only in the entry block.
+        STACK_SLOT,
+        /// The address of a string literal, with its index in the function as the immediate.
+        STRING_ADDRESS,
+
+        // BINARY OPERATIONS.
+        // Operands have the same type as the result, except pointer offsets
+        // (ptr + i64 and ptr - i64) and pointer differences (ptr - ptr = i64).
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        SIGNED_DIVIDE,
+        UNSIGNED_DIVIDE,
+        SIGNED_REMAINDER,
+        UNSIGNED_REMAINDER,
+        AND,
+        OR,
+        XOR,
+        SHIFT_LEFT,
+        ARITHMETIC_SHIFT_RIGHT,
+        LOGICAL_SHIFT_RIGHT,
+
+        // UNARY OPERATIONS.
+        NEGATE,
+        NOT,
+
+        // COMPARISONS.
+        // Operands have the same type, and the result is an i32 of 0 or 1.
+        EQUAL,
+        NOT_EQUAL,
+        SIGNED_LESS,
+        SIGNED_LESS_EQUAL,
+        SIGNED_GREATER,
+        SIGNED_GREATER_EQUAL,
+        UNSIGNED_LESS,
+        UNSIGNED_LESS_EQUAL,
+        UNSIGNED_GREATER,
+        UNSIGNED_GREATER_EQUAL,
+
+        // CONVERSIONS.
+        SIGN_EXTEND,
+        ZERO_EXTEND,
+        TRUNCATE,
+
+        // MEMORY.
+        /// Loads a value of the instruction's type from the address operand.
+        LOAD,
+        /// Stores the value operand (the second) to the address operand (the first).
+        STORE,
+
+        /// Calls the function named by the immediate (an index into the function's
+        /// callee names) with the operands as arguments.
+        CALL,
+
+        // TERMINATORS.
+        // Each block ends with exactly one, and its targets are the block's successors.
+        /// Continues to the only successor.
+        JUMP,
+        /// Continues to the first successor if the operand is non-zero and the second otherwise.
+        BRANCH,
+        /// Returns from the function with any operand as the result.
+        RETURN,
+
+        /// The number of kinds.  Must remain last.
+        COUNT
+    };
+
+    /// Gets the name of an instruction kind as it appears in IR dumps.
+    /// @param[in] kind - The kind.
+    /// @return The name of the kind.
+    inline const char* GetInstructionKindName(const InstructionKind kind)
+    {
+        switch (kind)
+        {
+            case InstructionKind::DELETED:
+                return "deleted";
+            case InstructionKind::CONSTANT:
+                return "constant";
+            case InstructionKind::UNDEFINED:
+                return "undef";
+            case InstructionKind::PARAMETER:
+                return "parameter";
+            case InstructionKind::PHI:
+                return "phi";
+            case InstructionKind::STACK_SLOT:
+                return "stack_slot";
+            case InstructionKind::STRING_ADDRESS:
+                return "string_address";
+            case InstructionKind::ADD:
+                return "add";
+            case InstructionKind::SUBTRACT:
+                return "sub";
+            case InstructionKind::MULTIPLY:
+                return "mul";
+            case InstructionKind::SIGNED_DIVIDE:
+                return "sdiv";
+            case InstructionKind::UNSIGNED_DIVIDE:
+                return "udiv";
+            case InstructionKind::SIGNED_REMAINDER:
+                return "srem";
+            case InstructionKind::UNSIGNED_REMAINDER:
+                return "urem";
+            case InstructionKind::AND:
+                return "and";
+            case InstructionKind::OR:
+                return "or";
+            case InstructionKind::XOR:
+                return "xor";
+            case InstructionKind::SHIFT_LEFT:
+                return "shl";
+            case InstructionKind::ARITHMETIC_SHIFT_RIGHT:
+                return "ashr";
+            case InstructionKind::LOGICAL_SHIFT_RIGHT:
+                return "lshr";
+            case InstructionKind::NEGATE:
+                return "neg";
+            case InstructionKind::NOT:
+                return "not";
+            case InstructionKind::EQUAL:
+                return "eq";
+            case InstructionKind::NOT_EQUAL:
+                return "ne";
+            case InstructionKind::SIGNED_LESS:
+                return "slt";
+            case InstructionKind::SIGNED_LESS_EQUAL:
+                return "sle";
+            case InstructionKind::SIGNED_GREATER:
+                return "sgt";
+            case InstructionKind::SIGNED_GREATER_EQUAL:
+                return "sge";
+            case InstructionKind::UNSIGNED_LESS:
+                return "ult";
+            case InstructionKind::UNSIGNED_LESS_EQUAL:
+                return "ule";
+            case InstructionKind::UNSIGNED_GREATER:
+                return "ugt";
+            case InstructionKind::UNSIGNED_GREATER_EQUAL:
+                return "uge";
+            case InstructionKind::SIGN_EXTEND:
+                return "sext";
+            case InstructionKind::ZERO_EXTEND:
+                return "zext";
+            case InstructionKind::TRUNCATE:
+                return "trunc";
+            case InstructionKind::LOAD:
+                return "load";
+            case InstructionKind::STORE:
+                return "store";
+            case InstructionKind::CALL:
+                return "call";
+            case InstructionKind::JUMP:
+                return "jump";
+            case InstructionKind::BRANCH:
+                return "branch";
+            case InstructionKind::RETURN:
+                return "return";
+            default:
+                return "?";
+        }
+    }
+
+    /// Determines if an instruction kind ends a block.
+    /// @param[in] kind - The kind.
+    /// @return True if the kind is a terminator; false otherwise.
+    inline bool IsTerminator(const InstructionKind kind)
+    {
+        return InstructionKind::JUMP == kind || InstructionKind::BRANCH == kind || InstructionKind::RETURN == kind;
+    }
+
+    /// Determines if an instruction kind is a binary operation.
+    /// @param[in] kind - The kind.
+    /// @return True if the kind is a binary operation; false otherwise.
+    inline bool IsBinaryOperation(const InstructionKind kind)
+    {
+        return InstructionKind::ADD <= kind && kind <= InstructionKind::LOGICAL_SHIFT_RIGHT;
+    }
+
+    /// Determines if an instruction kind is a comparison.
+    /// @param[in] kind - The kind.
+    /// @return True if the kind is a comparison; false otherwise.
+    inline bool IsComparison(const InstructionKind kind)
+    {
+        return InstructionKind::EQUAL <= kind && kind <= InstructionKind::UNSIGNED_GREATER_EQUAL;
+    }
+
+    /// Determines if an instruction kind is a conversion between integer sizes.
+    /// @param[in] kind - The kind.
+    /// @return True if the kind is a conversion; false otherwise.
+    inline bool IsConversion(const InstructionKind kind)
+    {
+        return InstructionKind::SIGN_EXTEND <= kind && kind <= InstructionKind::TRUNCATE;
+    }
+
+    /// Determines if instructions of a kind have effects beyond producing a value,
+    /// so that they must be kept even if their value isn't used.
+    /// @param[in] kind - The kind.
+    /// @return True if the kind has side effects; false otherwise.
+    inline bool HasSideEffects(const InstructionKind kind)
+    {
+        return InstructionKind::STORE == kind || InstructionKind::CALL == kind || IsTerminator(kind);
+    }
+
+    /// Flags for instructions.
+    enum InstructionFlags : std::uint8_t
+    {
+        /// For calls, the callee is variadic.
+        INSTRUCTION_CALLS_VARIADIC_FUNCTION = 1 << 0,
+    };
+
+    /// A single instruction, which is also the value it produces.
+    ///
+    /// Instructions are stored by ID in a dense array in their function, and
+    /// their operands are slices of a single array of value IDs shared by the
+    /// whole function, so walking instructions and operands touches contiguous
+    /// memory rather than chasing pointers between separate allocations.
+    struct Instruction
+    {
+        /// The kind of instruction.
+        InstructionKind Kind = InstructionKind::DELETED;
+        /// The type of the value produced (void if none).
+        ValueType Type = ValueType::VOID;
+        /// Any flags for the instruction.
+        std::uint8_t Flags = 0;
+        /// The block containing the instruction, or invalid for constants and undefined values.
+        BlockId Block = INVALID_ID;
+        /// The index of the first operand in the function's operands.
+        std::uint32_t FirstOperandIndex = 0;
+        /// The number of operands.
+        std::uint32_t OperandCount = 0;
+        /// The number of operands that fit in the slice without moving it.
+        std::uint32_t OperandCapacity = 0;
+        /// The first use of this value, or invalid if unused.
+        UseId FirstUse = INVALID_ID;
+        /// A constant specific to the kind of instruction (such as a constant's value).
+        std::int64_t Immediate = 0;
+    };
+
+    /// A use of a value as an operand of an instruction.
+    /// Uses of each value form a doubly-linked list through the function's uses.
+    struct Use
+    {
+        /// The instruction using the value.
+        ValueId User = INVALID_ID;
+        /// The index of the operand within the user's operands.
+        std::uint32_t OperandIndex = 0;
+        /// The next use of the same value.
+        UseId NextUse = INVALID_ID;
+        /// The previous use of the same value.
+        UseId PreviousUse = INVALID_ID;
+    };
+}
@@ -0,0 +1,1354 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "IntermediateRepresentation/Function.h"
+#include "SemanticAnalysis/SymbolTable.h"
+#include "SemanticAnalysis/Type.h"
+
+namespace INTERMEDIATE_REPRESENTATION
+{
+    /// Lowers analyzed function definitions into SSA form.
+    ///
+    /// SSA is constructed directly while lowering rather than by first
+    /// storing every variable to memory and promoting it afterward.  Each
+    /// local variable's current value is tracked per block, and phis are
+    /// only created where a variable is read in a block with several
+    /// predecessors.  Blocks whose predecessors aren't all known yet (like
+    /// loop headers) get placeholder phis that are completed once the block
+    /// is sealed, and phis that turn out to merge a single value are
+    /// removed immediately through their use lists.
+    ///
+    /// Only variables whose addresses are taken (and arrays) live in memory.
+    struct IrBuilder
+    {
+        /// Lowers all function definitions in a program.
+        /// @param[in] program - The program, which must have passed semantic analysis.
+        /// @param[out] module - The lowered functions.
+        /// @param[out] error_messages - Any errors for unsupported code, one per line.
+        /// @return True if all functions were lowered; false otherwise.
+        static bool Lower(const Program& program, Module& module, std::string& error_messages)
+        {
+            bool all_functions_lowered = true;
+            for (const FunctionDefinition* function_definition : GetFunctionsInOrder(program))
+            {
+                Function function;
+                bool function_lowered = LowerFunction(program, *function_definition, function, error_messages);
+                if (!function_lowered)
+                {
+                    all_functions_lowered = false;
+                    continue;
+                }
+                module.Functions.push_back(std::move(function));
+            }
+            return all_functions_lowered;
+        }
+
+        /// Gets the function definitions in a program in the order they're lowered into a module.
+        /// Functions are lowered in name order so output is consistent.
+        /// @param[in] program - The program.
+        /// @return The function definitions, in order.
+        static std::vector<const FunctionDefinition*> GetFunctionsInOrder(const Program& program)
+        {
+            std::vector<const FunctionDefinition*> function_definitions;
+            for (const auto& [function_name, function_definition] : program.FunctionsByName)
+            {
+                function_definitions.push_back(&function_definition);
+            }
+            std::sort(
+                function_definitions.begin(),
+                function_definitions.end(),
+                [](const FunctionDefinition* left, const FunctionDefinition* right) { return left->Header.Name < right->Header.Name; });
+            return function_definitions;
+        }
+
+        /// Lowers a single function definition.  Functions only read the program,
+        /// so different functions can be lowered on different threads at once.
+        /// @param[in] program - The program, which must have passed semantic analysis.
+        /// @param[in] function_definition - The function to lower.
+        /// @param[out] function - The lowered function.
+        /// @param[out] error_messages - Any errors for unsupported code, one per line.
+        /// @return True if the function was lowered; false otherwise.
+        static bool LowerFunction(const Program& program, const FunctionDefinition& function_definition, Function& function, std::string& error_messages)
+        {
+            IrBuilder builder(program, function_definition, function);
+            builder.LowerFunction();
+            error_messages += builder.ErrorMessages;
+            return builder.ErrorMessages.empty();
+        }
+
+        /// Decodes the characters in a quoted string or character literal.
+        /// @param[in] quoted_text - The literal, including its quotes.
+        /// @return The characters represented by the literal.
+        static std::string DecodeLiteral(const std::string_view quoted_text)
+        {
+            std::string characters;
+            std::string_view text = (quoted_text.size() >= 2) ? quoted_text.substr(1, quoted_text.size() - 2) : quoted_text;
+            for (std::size_t character_index = 0; character_index < text.size(); ++character_index)
+            {
+                char character = text[character_index];
+                bool is_escape = ('\\' == character && character_index + 1 < text.size());
+                if (!is_escape)
+                {
+                    characters += character;
+                    continue;
+                }
+
+                ++character_index;
+                char escaped_character = text[character_index];
+                switch (escaped_character)
+                {
+                    case 'n':
+                        characters += '\n';
+                        break;
+                    case 't':
+                        characters += '\t';
+                        break;
+                    case 'r':
+                        characters += '\r';
+                        break;
+                    case '0':
+                        characters += '\0';
+                        break;
+                    case 'a':
+                        characters += '\a';
+                        break;
+                    case 'b':
+                        characters += '\b';
+                        break;
+                    case 'f':
+                        characters += '\f';
+                        break;
+                    case 'v':
+                        characters += '\v';
+                        break;
+                    default:
+                        // Quotes, backslashes, and question marks represent themselves.
+                        characters += escaped_character;
+                        break;
+                }
+            }
+            return characters;
+        }
+
+    private:
+        /// A local variable or parameter.
+        struct Variable
+        {
+            /// The type of the variable.
+            const SEMANTIC_ANALYSIS::Type* DataType = nullptr;
+            /// The address of the variable, if it lives in memory; invalid if it's an SSA value.
+            ValueId Address = INVALID_ID;
+        };
+
+        /// Something that can be assigned to.
+        struct LValue
+        {
+            /// The type of the object.
+            const SEMANTIC_ANALYSIS::Type* DataType = nullptr;
+            /// The variable, if the object is a variable kept as an SSA value; invalid otherwise.
+            std::uint32_t VariableIndex = INVALID_ID;
+            /// The address of the object, if it's in memory; invalid otherwise.
+            ValueId Address = INVALID_ID;
+        };
+
+        /// The blocks that break and continue statements go to in a loop.
+        struct LoopTargets
+        {
+            /// The block continue statements go to.
+            BlockId ContinueBlock = INVALID_ID;
+            /// The block break statements go to.
+            BlockId BreakBlock = INVALID_ID;
+        };
+
+        /// Creates a builder for a function.
+        /// @param[in] program - The program containing the function.
+        /// @param[in] source - The function to lower.
+        /// @param[out] output - The function to lower into.
+        explicit IrBuilder(const Program& program, const FunctionDefinition& source, Function& output) :
+            SourceProgram(program),
+            Types(*program.Types),
+            Source(source),
+            Output(output)
+        {}
+
+        /// Lowers the function.
+        void LowerFunction()
+        {
+            // SET UP THE FUNCTION'S SIGNATURE.
+            Output.Name = Source.Header.Name;
+            const SEMANTIC_ANALYSIS::Type* return_type = Types.FindTypeForSpelling(Source.Header.ReturnType);
+            Output.ReturnType = GetValueType(return_type, Source.Header.LineNumber);
+            Output.IsVariadic = Source.Header.IsVariadic;
+            Output.IsStatic = (StorageClass::STATIC == Source.Header.Specifiers.Storage);
+            FindAddressTakenNames(Source.Body.Statements);
+
+            // DEFINE THE PARAMETERS.
+            CurrentBlock = CreateBlock();
+            SealBlock(CurrentBlock);
+            Symbols.EnterScope();
+            for (std::size_t parameter_index = 0; parameter_index < Source.Header.Parameters.size(); ++parameter_index)
+            {
+                const VariableDeclaration& parameter = Source.Header.Parameters[parameter_index];
+                const SEMANTIC_ANALYSIS::Type* parameter_type = Types.FindTypeForSpelling(parameter.DataType);
+                ValueType parameter_value_type = GetValueType(parameter_type, Source.Header.LineNumber);
+                Output.ParameterTypes.push_back(parameter_value_type);
+                ValueId parameter_value = Output.AppendInstruction(CurrentBlock, InstructionKind::PARAMETER, parameter_value_type, {}, static_cast<std::int64_t>(parameter_index));
+                ++EntryInsertPosition;
+                if (parameter.Name.empty())
+                {
+                    continue;
+                }
+
+                // Array parameters are really pointers.
+                if (SEMANTIC_ANALYSIS::TypeKind::ARRAY == parameter_type->Kind)
+                {
+                    parameter_type = Types.FindPointerType(parameter_type->ElementType);
+                }
+                std::uint32_t variable_index = DeclareVariable(parameter.Name, parameter_type);
+                StoreLValue(GetVariableLValue(variable_index), parameter_value);
+            }
+
+            // LOWER THE BODY.
+            for (const Statement& statement : Source.Body.Statements)
+            {
+                LowerStatement(statement);
+            }
+            Symbols.ExitScope();
+
+            // RETURN AT THE END OF THE BODY.
+            // Falling off the end of main returns 0, as in C.
+            if (INVALID_ID != CurrentBlock)
+            {
+                if (ValueType::VOID == Output.ReturnType)
+                {
+                    Terminate(InstructionKind::RETURN, {}, {});
+                }
+                else
+                {
+                    ValueId return_value = ("main" == Output.Name) ? Output.GetConstant(Output.ReturnType, 0) : Output.GetUndefined(Output.ReturnType);
+                    Terminate(InstructionKind::RETURN, { return_value }, {});
+                }
+            }
+        }
+
+        /// Finds the names of variables whose addresses are taken, so that they can be kept in memory.
+        /// Names are used rather than individual variables, so shadowed variables are treated the same.
+        /// @param[in] statements - The statements to search.
+        void FindAddressTakenNames(const std::vector<Statement>& statements)
+        {
+            for (const Statement& statement : statements)
+            {
+                for (const std::optional<Expression>* expression : { &statement.Value, &statement.Condition, &statement.Step })
+                {
+                    if (*expression)
+                    {
+                        FindAddressTakenNames(**expression);
+                    }
+                }
+                FindAddressTakenNames(statement.Body);
+            }
+        }
+
+        /// Finds the names of variables whose addresses are taken within an expression.
+        /// @param[in] expression - The expression to search.
+        void FindAddressTakenNames(const Expression& expression)
+        {
+            bool takes_address_of_variable = (
+                ExpressionKind::UNARY == expression.Kind &&
+                "&" == expression.Text &&
+                ExpressionKind::IDENTIFIER == expression.Operands.front().Kind);
+            if (takes_address_of_variable)
+            {
+                AddressTakenNames.insert(expression.Operands.front().Text);
+            }
+            for (const Expression& operand : expression.Operands)
+            {
+                FindAddressTakenNames(operand);
+            }
+        }
+
+        /// Declares a variable in the current scope.
+        /// @param[in] name - The name of the variable.
+        /// @param[in] type - The type of the variable.
+        /// @return The index of the variable.
+        std::uint32_t DeclareVariable(const std::string& name, const SEMANTIC_ANALYSIS::Type* const type)
+        {
+            std::uint32_t variable_index = static_cast<std::uint32_t>(Variables.size());
+            Variable variable = { .DataType = type };
+            bool in_memory = (SEMANTIC_ANALYSIS::TypeKind::ARRAY == type->Kind || AddressTakenNames.contains(name));
+            if (in_memory)
+            {
+                // Stack slots are all in the entry block so that they're allocated once per call.
+                variable.Address = Output.InsertInstruction(
+                    Function::ENTRY_BLOCK_ID,
+                    EntryInsertPosition,
+                    InstructionKind::STACK_SLOT,
+                    ValueType::PTR,
+                    {},
+                    static_cast<std::int64_t>(type->SizeInBytes));
+                ++EntryInsertPosition;
+            }
+            Variables.push_back(variable);
+
+            Symbols.Declare(SEMANTIC_ANALYSIS::Symbol
+            {
+                .Kind = SEMANTIC_ANALYSIS::SymbolKind::LOCAL_VARIABLE,
+                .Name = name,
+                .DataType = type,
+                .Id = variable_index,
+            });
+            return variable_index;
+        }
+
+        /// Creates an unnamed variable for merging values from different paths.
+        /// @param[in] type - The type of the variable.
+        /// @return The index of the variable.
+        std::uint32_t CreateTemporaryVariable(const SEMANTIC_ANALYSIS::Type* const type)
+        {
+            std::uint32_t variable_index = static_cast<std::uint32_t>(Variables.size());
+            Variables.push_back(Variable { .DataType = type });
+            return variable_index;
+        }
+
+        /// Lowers a statement in its own scope.
+        /// @param[in] statement - The statement.
+        void LowerScopedStatement(const Statement& statement)
+        {
+            Symbols.EnterScope();
+            LowerStatement(statement);
+            Symbols.ExitScope();
+        }
+
+        /// Lowers a statement.
+        /// @param[in] statement - The statement.
+        void LowerStatement(const Statement& statement)
+        {
+            switch (statement.Kind)
+            {
+                case StatementKind::EXPRESSION:
+                {
+                    LowerExpression(*statement.Value);
+                    break;
+                }
+                case StatementKind::DECLARATION:
+                {
+                    // The variable is in scope within its own initializer, as in C.
+                    const SEMANTIC_ANALYSIS::Type* variable_type = Types.FindTypeForSpelling(statement.Declaration.DataType);
+                    GetValueType(variable_type, statement.LineNumber);
+                    std::uint32_t variable_index = DeclareVariable(statement.Declaration.Name, variable_type);
+                    if (statement.Value)
+                    {
+                        ValueId initial_value = LowerExpression(*statement.Value);
+                        initial_value = Convert(initial_value, statement.Value->ResolvedType, variable_type, statement.LineNumber);
+                        StoreLValue(GetVariableLValue(variable_index), initial_value);
+                    }
+                    break;
+                }
+                case StatementKind::RETURN:
+                {
+                    if (statement.Value)
+                    {
+                        ValueId return_value = LowerExpression(*statement.Value);
+                        const SEMANTIC_ANALYSIS::Type* return_type = Types.FindTypeForSpelling(Source.Header.ReturnType);
+                        return_value = Convert(return_value, statement.Value->ResolvedType, return_type, statement.LineNumber);
+                        Terminate(InstructionKind::RETURN, { return_value }, {});
+                    }
+                    else
+                    {
+                        EnsureCurrentBlock();
+                        Terminate(InstructionKind::RETURN, {}, {});
+                    }
+                    break;
+                }
+                case StatementKind::IF:
+                {
+                    ValueId condition = LowerExpression(*statement.Condition);
+                    bool has_else = (statement.Body.size() > 1);
+                    BlockId then_block = CreateBlock();
+                    BlockId else_block = has_else ? CreateBlock() : INVALID_ID;
+                    BlockId merge_block = CreateBlock();
+                    Terminate(InstructionKind::BRANCH, { condition }, { then_block, has_else ? else_block : merge_block });
+                    SealBlock(then_block);
+
+                    CurrentBlock = then_block;
+                    LowerScopedStatement(statement.Body.front());
+                    Jump(merge_block);
+
+                    if (has_else)
+                    {
+                        SealBlock(else_block);
+                        CurrentBlock = else_block;
+                        LowerScopedStatement(statement.Body.back());
+                        Jump(merge_block);
+                    }
+
+                    SealBlock(merge_block);
+                    CurrentBlock = merge_block;
+                    break;
+                }
+                case StatementKind::WHILE:
+                {
+                    // The header isn't sealed until the end of the body jumps back to it.
+                    BlockId header_block = CreateBlock();
+                    BlockId body_block = CreateBlock();
+                    BlockId exit_block = CreateBlock();
+                    Jump(header_block);
+
+                    CurrentBlock = header_block;
+                    ValueId condition = LowerExpression(*statement.Condition);
+                    Terminate(InstructionKind::BRANCH, { condition }, { body_block, exit_block });
+                    SealBlock(body_block);
+
+                    LowerLoopBody(statement.Body.front(), body_block, header_block, exit_block);
+                    Jump(header_block);
+                    SealBlock(header_block);
+
+                    SealBlock(exit_block);
+                    CurrentBlock = exit_block;
+                    break;
+                }
+                case StatementKind::DO_WHILE:
+                {
+                    BlockId body_block = CreateBlock();
+                    BlockId condition_block = CreateBlock();
+                    BlockId exit_block = CreateBlock();
+                    Jump(body_block);
+
+                    LowerLoopBody(statement.Body.front(), body_block, condition_block, exit_block);
+                    Jump(condition_block);
+                    SealBlock(condition_block);
+
+                    CurrentBlock = condition_block;
+                    ValueId condition = LowerExpression(*statement.Condition);
+                    Terminate(InstructionKind::BRANCH, { condition }, { body_block, exit_block });
+                    SealBlock(body_block);
+
+                    SealBlock(exit_block);
+                    CurrentBlock = exit_block;
+                    break;
+                }
+                case StatementKind::FOR:
+                {
+                    // Any variable declared by the initializer is only visible within the loop.
+                    Symbols.EnterScope();
+                    LowerStatement(statement.Body.front());
+
+                    BlockId header_block = CreateBlock();
+                    BlockId body_block = CreateBlock();
+                    BlockId step_block = CreateBlock();
+                    BlockId exit_block = CreateBlock();
+                    Jump(header_block);
+
+                    CurrentBlock = header_block;
+                    if (statement.Condition)
+                    {
+                        ValueId condition = LowerExpression(*statement.Condition);
+                        Terminate(InstructionKind::BRANCH, { condition }, { body_block, exit_block });
+                    }
+                    else
+                    {
+                        Jump(body_block);
+                    }
+                    SealBlock(body_block);
+
+                    LowerLoopBody(statement.Body.back(), body_block, step_block, exit_block);
+                    Jump(step_block);
+                    SealBlock(step_block);
+
+                    CurrentBlock = step_block;
+                    if (statement.Step)
+                    {
+                        LowerExpression(*statement.Step);
+                    }
+                    Jump(header_block);
+                    SealBlock(header_block);
+
+                    SealBlock(exit_block);
+                    CurrentBlock = exit_block;
+                    Symbols.ExitScope();
+                    break;
+                }
+                case StatementKind::BREAK:
+                {
+                    Jump(Loops.back().BreakBlock);
+                    break;
+                }
+                case StatementKind::CONTINUE:
+                {
+                    Jump(Loops.back().ContinueBlock);
+                    break;
+                }
+                case StatementKind::BLOCK:
+                {
+                    Symbols.EnterScope();
+                    for (const Statement& child_statement : statement.Body)
+                    {
+                        LowerStatement(child_statement);
+                    }
+                    Symbols.ExitScope();
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        /// Lowers the body of a loop.
+        /// @param[in] body - The body statement.
+        /// @param[in] body_block - The block starting the body.
+        /// @param[in] continue_block - The block continue statements go to.
+        /// @param[in] break_block - The block break statements go to.
+        void LowerLoopBody(const Statement& body, const BlockId body_block, const BlockId continue_block, const BlockId break_block)
+        {
+            Loops.push_back(LoopTargets { .ContinueBlock = continue_block, .BreakBlock = break_block });
+            CurrentBlock = body_block;
+            LowerScopedStatement(body);
+            Loops.pop_back();
+        }
+
+        /// Lowers an expression.
+        /// @param[in] expression - The analyzed expression.
+        /// @return The value of the expression (with arrays decayed to their addresses),
+        ///     or invalid for calls to void functions.
+        ValueId LowerExpression(const Expression& expression)
+        {
+            EnsureCurrentBlock();
+            switch (expression.Kind)
+            {
+                case ExpressionKind::CONSTANT:
+                {
+                    ValueType type = GetValueType(expression.ResolvedType, expression.LineNumber);
+                    bool is_character = ('\'' == expression.Text.front());
+                    if (is_character)
+                    {
+                        // Plain chars are signed, so characters above 127 are negative.
+                        std::string characters = DecodeLiteral(expression.Text);
+                        std::int64_t character = characters.empty() ? 0 : static_cast<signed char>(characters.front());
+                        return Output.GetConstant(type, character);
+                    }
+
+                    std::uint64_t value = 0;
+                    for (const char digit : expression.Text)
+                    {
+                        value = value * 10 + static_cast<std::uint64_t>(digit - '0');
+                    }
+                    return Output.GetConstant(type, static_cast<std::int64_t>(value));
+                }
+                case ExpressionKind::STRING_LITERAL:
+                {
+                    std::int64_t string_index = static_cast<std::int64_t>(Output.StringLiterals.size());
+                    Output.StringLiterals.push_back(DecodeLiteral(expression.Text));
+                    return Emit(InstructionKind::STRING_ADDRESS, ValueType::PTR, {}, string_index);
+                }
+                case ExpressionKind::IDENTIFIER:
+                case ExpressionKind::INDEX:
+                {
+                    LValue lvalue = LowerLValue(expression);
+                    return LoadLValue(lvalue, expression.LineNumber);
+                }
+                case ExpressionKind::CALL:
+                    return LowerCall(expression);
+                case ExpressionKind::UNARY:
+                case ExpressionKind::POSTFIX:
+                    return LowerUnary(expression);
+                case ExpressionKind::BINARY:
+                    return LowerBinary(expression);
+                case ExpressionKind::ASSIGNMENT:
+                    return LowerAssignment(expression);
+                case ExpressionKind::CONDITIONAL:
+                    return LowerConditional(expression);
+                default:
+                    AddError(expression.LineNumber, "Expression can't be lowered.");
+                    return Output.GetUndefined(ValueType::I32);
+            }
+        }
+
+        /// Lowers an expression designating an object.
+        /// @param[in] expression - The analyzed expression.
+        /// @return The object.
+        LValue LowerLValue(const Expression& expression)
+        {
+            switch (expression.Kind)
+            {
+                case ExpressionKind::IDENTIFIER:
+                {
+                    const SEMANTIC_ANALYSIS::Symbol* symbol = Symbols.Find(expression.Text);
+                    if (!symbol)
+                    {
+                        AddError(expression.LineNumber, "Functions can't be used as values in the IR yet.");
+                        return LValue { .DataType = expression.ResolvedType, .Address = Output.GetUndefined(ValueType::PTR) };
+                    }
+                    return GetVariableLValue(symbol->Id);
+                }
+                case ExpressionKind::UNARY:
+                {
+                    ValueId address = LowerExpression(expression.Operands.front());
+                    return LValue { .DataType = expression.ResolvedType, .Address = address };
+                }
+                case ExpressionKind::INDEX:
+                {
+                    // Either operand may be the pointer, as in C.
+                    const Expression* base = &expression.Operands[0];
+                    const Expression* index = &expression.Operands[1];
+                    if (!IsPointerLike(base->ResolvedType))
+                    {
+                        std::swap(base, index);
+                    }
+                    ValueId base_address = LowerExpression(*base);
+                    ValueId index_value = LowerExpression(*index);
+                    ValueId address = OffsetPointer(InstructionKind::ADD, base_address, base->ResolvedType, index_value, index->ResolvedType, expression.LineNumber);
+                    return LValue { .DataType = expression.ResolvedType, .Address = address };
+                }
+                default:
+                    AddError(expression.LineNumber, "Expression can't be assigned to.");
+                    return LValue { .DataType = expression.ResolvedType, .Address = Output.GetUndefined(ValueType::PTR) };
+            }
+        }
+
+        /// Gets an object for a variable.
+        /// @param[in] variable_index - The variable.
+        /// @return The object for the variable.
+        LValue GetVariableLValue(const std::uint32_t variable_index) const
+        {
+            const Variable& variable = Variables[variable_index];
+            if (INVALID_ID != variable.Address)
+            {
+                return LValue { .DataType = variable.DataType, .Address = variable.Address };
+            }
+            return LValue { .DataType = variable.DataType, .VariableIndex = variable_index };
+        }
+
+        /// Gets the value of an object.
+        /// @param[in] lvalue - The object.
+        /// @param[in] line_number - The line the value is read on.
+        /// @return The value, or the address for arrays (which decay to pointers).
+        ValueId LoadLValue(const LValue& lvalue, const std::size_t line_number)
+        {
+            EnsureCurrentBlock();
+            if (SEMANTIC_ANALYSIS::TypeKind::ARRAY == lvalue.DataType->Kind)
+            {
+                return lvalue.Address;
+            }
+            if (INVALID_ID != lvalue.VariableIndex)
+            {
+                return ReadVariable(lvalue.VariableIndex, CurrentBlock);
+            }
+            return Emit(InstructionKind::LOAD, GetValueType(lvalue.DataType, line_number), { lvalue.Address });
+        }
+
+        /// Sets the value of an object.
+        /// @param[in] lvalue - The object.
+        /// @param[in] value - The value, already converted to the object's type.
+        void StoreLValue(const LValue& lvalue, const ValueId value)
+        {
+            EnsureCurrentBlock();
+            if (INVALID_ID != lvalue.VariableIndex)
+            {
+                WriteVariable(lvalue.VariableIndex, CurrentBlock, value);
+                return;
+            }
+            Emit(InstructionKind::STORE, ValueType::VOID, { lvalue.Address, value });
+        }
+
+        /// Lowers a function call.
+        /// @param[in] expression - The call.
+        /// @return The result of the call, or invalid if the function returns void.
+        ValueId LowerCall(const Expression& expression)
+        {
+            // FIND THE CALLEE'S PARAMETERS.
+            const FunctionHeader* callee_header = nullptr;
+            auto callee_definition = SourceProgram.FunctionsByName.find(expression.Text);
+            if (SourceProgram.FunctionsByName.end() != callee_definition)
+            {
+                callee_header = &callee_definition->second.Header;
+            }
+            else
+            {
+                callee_header = &SourceProgram.FunctionDeclarationsByName.at(expression.Text);
+            }
+
+            // CONVERT THE ARGUMENTS TO THE PARAMETER TYPES.
+            // Any variadic arguments get the default promotions.
+            std::vector<ValueId> arguments;
+            for (std::size_t argument_index = 0; argument_index < expression.Operands.size(); ++argument_index)
+            {
+                const Expression& argument = expression.Operands[argument_index];
+                ValueId argument_value = LowerExpression(argument);
+                const SEMANTIC_ANALYSIS::Type* parameter_type = (argument_index < callee_header->Parameters.size()) ?
+                    Types.FindTypeForSpelling(callee_header->Parameters[argument_index].DataType) :
+                    Types.PromoteInteger(argument.ResolvedType);
+                arguments.push_back(Convert(argument_value, argument.ResolvedType, parameter_type, expression.LineNumber));
+            }
+
+            // CALL THE FUNCTION.
+            auto [callee_index, callee_added] = CalleeIndicesByName.try_emplace(expression.Text, static_cast<std::uint32_t>(Output.CalleeNames.size()));
+            if (callee_added)
+            {
+                Output.CalleeNames.push_back(expression.Text);
+            }
+            ValueType return_type = GetValueType(expression.ResolvedType, expression.LineNumber);
+            ValueId call = Output.AppendInstruction(CurrentBlock, InstructionKind::CALL, return_type, arguments, callee_index->second);
+            if (callee_header->IsVariadic)
+            {
+                Output.Values[call].Flags |= INSTRUCTION_CALLS_VARIADIC_FUNCTION;
+            }
+            return (ValueType::VOID == return_type) ? INVALID_ID : call;
+        }
+
+        /// Lowers a prefix or postfix unary operator.
+        /// @param[in] expression - The operator.
+        /// @return The result.
+        ValueId LowerUnary(const Expression& expression)
+        {
+            const std::string& operator_text = expression.Text;
+            const Expression& operand = expression.Operands.front();
+            const SEMANTIC_ANALYSIS::Type* result_type = expression.ResolvedType;
+
+            // LOWER OPERATORS ON OBJECTS.
+            if ("&" == operator_text)
+            {
+                LValue lvalue = LowerLValue(operand);
+                return lvalue.Address;
+            }
+            if ("*" == operator_text)
+            {
+                LValue lvalue = LowerLValue(expression);
+                return LoadLValue(lvalue, expression.LineNumber);
+            }
+            if ("++" == operator_text || "--" == operator_text)
+            {
+                LValue lvalue = LowerLValue(operand);
+                ValueId old_value = LoadLValue(lvalue, expression.LineNumber);
+                InstructionKind kind = ("++" == operator_text) ? InstructionKind::ADD : InstructionKind::SUBTRACT;
+                ValueId new_value = INVALID_ID;
+                if (IsPointerLike(lvalue.DataType))
+                {
+                    ValueId one = Output.GetConstant(ValueType::I32, 1);
+                    new_value = OffsetPointer(kind, old_value, lvalue.DataType, one, Types.Int, expression.LineNumber);
+                }
+                else
+                {
+                    ValueType type = GetValueType(lvalue.DataType, expression.LineNumber);
+                    new_value = Emit(kind, type, { old_value, Output.GetConstant(type, 1) });
+                }
+                StoreLValue(lvalue, new_value);
+                bool is_postfix = (ExpressionKind::POSTFIX == expression.Kind);
+                return is_postfix ? old_value : new_value;
+            }
+
+            // LOWER OPERATORS ON VALUES.
+            ValueId value = LowerExpression(operand);
+            if ("!" == operator_text)
+            {
+                ValueType operand_type = GetValueType(operand.ResolvedType, expression.LineNumber);
+                return Emit(InstructionKind::EQUAL, ValueType::I32, { value, Output.GetConstant(operand_type, 0) });
+            }
+
+            ValueType type = GetValueType(result_type, expression.LineNumber);
+            value = Convert(value, operand.ResolvedType, result_type, expression.LineNumber);
+            if ("-" == operator_text)
+            {
+                return Emit(InstructionKind::NEGATE, type, { value });
+            }
+            if ("~" == operator_text)
+            {
+                return Emit(InstructionKind::NOT, type, { value });
+            }
+            return value;
+        }
+
+        /// Lowers a simple or compound assignment.
+        /// @param[in] expression - The assignment.
+        /// @return The value stored.
+        ValueId LowerAssignment(const Expression& expression)
+        {
+            const Expression& target = expression.Operands[0];
+            const Expression& value = expression.Operands[1];
+            LValue target_lvalue = LowerLValue(target);
+            std::string_view operator_text = Expression::GetCompoundAssignmentOperator(expression.Text);
+            if (operator_text.empty())
+            {
+                ValueId new_value = LowerExpression(value);
+                new_value = Convert(new_value, value.ResolvedType, target.ResolvedType, expression.LineNumber);
+                StoreLValue(target_lvalue, new_value);
+                return new_value;
+            }
+
+            // The target is only evaluated once, so any side effects in it happen once.
+            ValueId old_value = LoadLValue(target_lvalue, expression.LineNumber);
+            ValueId right_value = LowerExpression(value);
+            const SEMANTIC_ANALYSIS::Type* result_type = target.ResolvedType;
+            if (!IsPointerLike(target.ResolvedType))
+            {
+                bool is_shift = ("<<" == operator_text || ">>" == operator_text);
+                result_type = is_shift ? Types.PromoteInteger(target.ResolvedType) : Types.GetCommonArithmeticType(target.ResolvedType, value.ResolvedType);
+            }
+            ValueId new_value = LowerBinaryOperator(
+                operator_text, old_value, target.ResolvedType, right_value, value.ResolvedType, result_type, expression.LineNumber);
+            new_value = Convert(new_value, result_type, target.ResolvedType, expression.LineNumber);
+            StoreLValue(target_lvalue, new_value);
+            return new_value;
+        }
+
+        /// Lowers a binary operator.
+        /// @param[in] expression - The operator.
+        /// @return The result.
+        ValueId LowerBinary(const Expression& expression)
+        {
+            const std::string& operator_text = expression.Text;
+            if ("&&" == operator_text || "||" == operator_text)
+            {
+                return LowerLogicalOperator(expression);
+            }
+
+            const Expression& left = expression.Operands[0];
+            const Expression& right = expression.Operands[1];
+            ValueId left_value = LowerExpression(left);
+            ValueId right_value = LowerExpression(right);
+            return LowerBinaryOperator(
+                operator_text, left_value, left.ResolvedType, right_value, right.ResolvedType, expression.ResolvedType, expression.LineNumber);
+        }
+
+        /// Lowers a binary operator other than the logical operators on lowered operands.
+        /// @param[in] operator_text - The operator.
+        /// @param[in] left_value - The left operand.
+        /// @param[in] left_type - The type of the left operand.
+        /// @param[in] right_value - The right operand.
+        /// @param[in] right_type - The type of the right operand.
+        /// @param[in] result_type - The type of the result.
+        /// @param[in] line_number - The line of the operator.
+        /// @return The result.
+        ValueId LowerBinaryOperator(
+            const std::string_view operator_text,
+            ValueId left_value,
+            const SEMANTIC_ANALYSIS::Type* const left_type,
+            ValueId right_value,
+            const SEMANTIC_ANALYSIS::Type* const right_type,
+            const SEMANTIC_ANALYSIS::Type* const result_type,
+            const std::size_t line_number)
+        {
+            bool left_is_pointer = IsPointerLike(left_type);
+            bool right_is_pointer = IsPointerLike(right_type);
+
+            // LOWER COMPARISONS.
+            bool is_comparison = ("==" == operator_text || "!=" == operator_text || "<" == operator_text || "<=" == operator_text || ">" == operator_text || ">=" == operator_text);
+            if (is_comparison)
+            {
+                // Pointers are compared as unsigned addresses.
+                bool is_signed = false;
+                if (left_is_pointer || right_is_pointer)
+                {
+                    const SEMANTIC_ANALYSIS::Type* pointer_type = left_is_pointer ? left_type : right_type;
+                    left_value = Convert(left_value, left_type, pointer_type, line_number);
+                    right_value = Convert(right_value, right_type, pointer_type, line_number);
+                }
+                else
+                {
+                    const SEMANTIC_ANALYSIS::Type* common_type = Types.GetCommonArithmeticType(left_type, right_type);
+                    left_value = Convert(left_value, left_type, common_type, line_number);
+                    right_value = Convert(right_value, right_type, common_type, line_number);
+                    is_signed = common_type->IsSigned;
+                }
+
+                InstructionKind kind = InstructionKind::EQUAL;
+                if ("!=" == operator_text) kind = InstructionKind::NOT_EQUAL;
+                else if ("<" == operator_text) kind = is_signed ? InstructionKind::SIGNED_LESS : InstructionKind::UNSIGNED_LESS;
+                else if ("<=" == operator_text) kind = is_signed ? InstructionKind::SIGNED_LESS_EQUAL : InstructionKind::UNSIGNED_LESS_EQUAL;
+                else if (">" == operator_text) kind = is_signed ? InstructionKind::SIGNED_GREATER : InstructionKind::UNSIGNED_GREATER;
+                else if (">=" == operator_text) kind = is_signed ? InstructionKind::SIGNED_GREATER_EQUAL : InstructionKind::UNSIGNED_GREATER_EQUAL;
+                return Emit(kind, ValueType::I32, { left_value, right_value });
+            }
+
+            // LOWER POINTER ARITHMETIC.
+            if (left_is_pointer && right_is_pointer)
+            {
+                // The difference is in elements, not bytes.
+                ValueId byte_difference = Emit(InstructionKind::SUBTRACT, ValueType::I64, { left_value, right_value });
+                std::size_t element_size = left_type->ElementType->SizeInBytes;
+                if (1 == element_size)
+                {
+                    return byte_difference;
+                }
+                ValueId element_size_value = Output.GetConstant(ValueType::I64, static_cast<std::int64_t>(element_size));
+                return Emit(InstructionKind::SIGNED_DIVIDE, ValueType::I64, { byte_difference, element_size_value });
+            }
+            if (left_is_pointer || right_is_pointer)
+            {
+                InstructionKind kind = ("-" == operator_text) ? InstructionKind::SUBTRACT : InstructionKind::ADD;
+                if (left_is_pointer)
+                {
+                    return OffsetPointer(kind, left_value, left_type, right_value, right_type, line_number);
+                }
+                return OffsetPointer(kind, right_value, right_type, left_value, left_type, line_number);
+            }
+
+            // LOWER ARITHMETIC.
+            // Both operands are converted to the result type (for shifts, the promoted left operand's type).
+            ValueType type = GetValueType(result_type, line_number);
+            left_value = Convert(left_value, left_type, result_type, line_number);
+            right_value = Convert(right_value, right_type, result_type, line_number);
+            bool is_signed = result_type->IsSigned;
+            InstructionKind kind = InstructionKind::ADD;
+            if ("-" == operator_text) kind = InstructionKind::SUBTRACT;
+            else if ("*" == operator_text) kind = InstructionKind::MULTIPLY;
+            else if ("/" == operator_text) kind = is_signed ? InstructionKind::SIGNED_DIVIDE : InstructionKind::UNSIGNED_DIVIDE;
+            else if ("%" == operator_text) kind = is_signed ? InstructionKind::SIGNED_REMAINDER : InstructionKind::UNSIGNED_REMAINDER;
+            else if ("&" == operator_text) kind = InstructionKind::AND;
+            else if ("|" == operator_text) kind = InstructionKind::OR;
+            else if ("^" == operator_text) kind = InstructionKind::XOR;
+            else if ("<<" == operator_text) kind = InstructionKind::SHIFT_LEFT;
+            else if (">>" == operator_text) kind = is_signed ? InstructionKind::ARITHMETIC_SHIFT_RIGHT : InstructionKind::LOGICAL_SHIFT_RIGHT;
+            return Emit(kind, type, { left_value, right_value });
+        }
+
+        /// Lowers a short-circuiting logical operator.
+        /// @param[in] expression - The operator.
+        /// @return The result (0 or 1).
+        ValueId LowerLogicalOperator(const Expression& expression)
+        {
+            // The result is merged through a temporary variable, which creates any needed phi.
+            bool is_and = ("&&" == expression.Text);
+            std::uint32_t result_variable = CreateTemporaryVariable(Types.Int);
+            ValueId left_value = LowerExpression(expression.Operands[0]);
+            WriteVariable(result_variable, CurrentBlock, Output.GetConstant(ValueType::I32, is_and ? 0 : 1));
+
+            // EVALUATE THE RIGHT OPERAND ONLY IF NEEDED.
+            BlockId right_block = CreateBlock();
+            BlockId merge_block = CreateBlock();
+            if (is_and)
+            {
+                Terminate(InstructionKind::BRANCH, { left_value }, { right_block, merge_block });
+            }
+            else
+            {
+                Terminate(InstructionKind::BRANCH, { left_value }, { merge_block, right_block });
+            }
+            SealBlock(right_block);
+
+            CurrentBlock = right_block;
+            const Expression& right = expression.Operands[1];
+            ValueId right_value = LowerExpression(right);
+            ValueType right_type = GetValueType(right.ResolvedType, expression.LineNumber);
+            ValueId right_result = Emit(InstructionKind::NOT_EQUAL, ValueType::I32, { right_value, Output.GetConstant(right_type, 0) });
+            WriteVariable(result_variable, CurrentBlock, right_result);
+            Jump(merge_block);
+
+            SealBlock(merge_block);
+            CurrentBlock = merge_block;
+            return ReadVariable(result_variable, CurrentBlock);
+        }
+
+        /// Lowers a conditional expression.
+        /// @param[in] expression - The conditional expression.
+        /// @return The result, or invalid if the result is void.
+        ValueId LowerConditional(const Expression& expression)
+        {
+            const SEMANTIC_ANALYSIS::Type* result_type = expression.ResolvedType;
+            bool has_result = (SEMANTIC_ANALYSIS::TypeKind::VOID != result_type->Kind);
+            std::uint32_t result_variable = has_result ? CreateTemporaryVariable(result_type) : INVALID_ID;
+
+            ValueId condition = LowerExpression(expression.Operands[0]);
+            BlockId true_block = CreateBlock();
+            BlockId false_block = CreateBlock();
+            BlockId merge_block = CreateBlock();
+            Terminate(InstructionKind::BRANCH, { condition }, { true_block, false_block });
+            SealBlock(true_block);
+            SealBlock(false_block);
+
+            // EVALUATE EACH ALTERNATIVE ON ITS OWN PATH.
+            for (const auto& [operand_index, block] : { std::pair<std::size_t, BlockId>(1, true_block), std::pair<std::size_t, BlockId>(2, false_block) })
+            {
+                CurrentBlock = block;
+                const Expression& operand = expression.Operands[operand_index];
+                ValueId value = LowerExpression(operand);
+                if (has_result)
+                {
+                    value = Convert(value, operand.ResolvedType, result_type, expression.LineNumber);
+                    WriteVariable(result_variable, CurrentBlock, value);
+                }
+                Jump(merge_block);
+            }
+
+            SealBlock(merge_block);
+            CurrentBlock = merge_block;
+            return has_result ? ReadVariable(result_variable, CurrentBlock) : INVALID_ID;
+        }
+
+        /// Offsets a pointer by a number of elements.
+        /// @param[in] kind - Add or subtract.
+        /// @param[in] pointer - The pointer.
+        /// @param[in] pointer_type - The type of the pointer (or array).
+        /// @param[in] offset - The number of elements.
+        /// @param[in] offset_type - The integer type of the number of elements.
+        /// @param[in] line_number - The line of the operation.
+        /// @return The offset pointer.
+        ValueId OffsetPointer(
+            const InstructionKind kind,
+            const ValueId pointer,
+            const SEMANTIC_ANALYSIS::Type* const pointer_type,
+            const ValueId offset,
+            const SEMANTIC_ANALYSIS::Type* const offset_type,
+            const std::size_t line_number)
+        {
+            ValueId byte_offset = Convert(offset, offset_type, Types.Long, line_number);
+            std::size_t element_size = pointer_type->ElementType->SizeInBytes;
+            if (element_size != 1)
+            {
+                byte_offset = Emit(InstructionKind::MULTIPLY, ValueType::I64, { byte_offset, Output.GetConstant(ValueType::I64, static_cast<std::int64_t>(element_size)) });
+            }
+            return Emit(kind, ValueType::PTR, { pointer, byte_offset });
+        }
+
+        /// Converts a value between types.
+        /// @param[in] value - The value to convert.
+        /// @param[in] from_type - The type of the value.
+        /// @param[in] to_type - The type to convert to.
+        /// @param[in] line_number - The line of the conversion.
+        /// @return The converted value.
+        ValueId Convert(const ValueId value, const SEMANTIC_ANALYSIS::Type* const from_type, const SEMANTIC_ANALYSIS::Type* const to_type, const std::size_t line_number)
+        {
+            ValueType from_value_type = GetValueType(from_type, line_number);
+            ValueType to_value_type = GetValueType(to_type, line_number);
+            if (from_value_type == to_value_type || ValueType::VOID == to_value_type)
+            {
+                return value;
+            }
+
+            // CONVERT CONSTANTS DIRECTLY.
+            if (Output.IsConstant(value))
+            {
+                std::int64_t constant_value = Output.Values[value].Immediate;
+                bool zero_extends = (!from_type->IsSigned && SEMANTIC_ANALYSIS::TypeKind::INTEGER == from_type->Kind && GetValueTypeSizeInBytes(from_value_type) < sizeof(std::int64_t));
+                if (zero_extends)
+                {
+                    std::uint64_t mask = (std::uint64_t(1) << (8 * GetValueTypeSizeInBytes(from_value_type))) - 1;
+                    constant_value = static_cast<std::int64_t>(static_cast<std::uint64_t>(constant_value) & mask);
+                }
+                return Output.GetConstant(to_value_type, constant_value);
+            }
+
+            // CONVERT BETWEEN INTEGER SIZES.
+            // Pointers only convert to and from null pointer constants, which were handled above.
+            if (ValueType::PTR == from_value_type || ValueType::PTR == to_value_type)
+            {
+                AddError(line_number, "Conversions between pointers and integers can't be lowered yet.");
+                return Output.GetUndefined(to_value_type);
+            }
+            std::size_t from_size = GetValueTypeSizeInBytes(from_value_type);
+            std::size_t to_size = GetValueTypeSizeInBytes(to_value_type);
+            if (to_size < from_size)
+            {
+                return Emit(InstructionKind::TRUNCATE, to_value_type, { value });
+            }
+            InstructionKind kind = from_type->IsSigned ? InstructionKind::SIGN_EXTEND : InstructionKind::ZERO_EXTEND;
+            return Emit(kind, to_value_type, { value });
+        }
+
+        /// Determines if a type is a pointer or an array (which decays to a pointer).
+        /// @param[in] type - The type.
+        /// @return True if the type is used as a pointer; false otherwise.
+        static bool IsPointerLike(const SEMANTIC_ANALYSIS::Type* const type)
+        {
+            return SEMANTIC_ANALYSIS::TypeKind::POINTER == type->Kind || SEMANTIC_ANALYSIS::TypeKind::ARRAY == type->Kind;
+        }
+
+        /// Gets the IR type for values of a type, adding an error for unsupported types.
+        /// @param[in] type - The type.
+        /// @param[in] line_number - The line the type is used on.
+        /// @return The IR type.
+        ValueType GetValueType(const SEMANTIC_ANALYSIS::Type* const type, const std::size_t line_number)
+        {
+            switch (type->Kind)
+            {
+                case SEMANTIC_ANALYSIS::TypeKind::VOID:
+                    return ValueType::VOID;
+                case SEMANTIC_ANALYSIS::TypeKind::INTEGER:
+                {
+                    switch (type->SizeInBytes)
+                    {
+                        case 1:
+                            return ValueType::I8;
+                        case 2:
+                            return ValueType::I16;
+                        case 4:
+                            return ValueType::I32;
+                        default:
+                            return ValueType::I64;
+                    }
+                }
+                case SEMANTIC_ANALYSIS::TypeKind::FLOATING_POINT:
+                {
+                    // This is only reported once per function to avoid repeating it for every use.
+                    if (!FloatingPointReported)
+                    {
+                        AddError(line_number, "Floating-point values can't be lowered yet.");
+                        FloatingPointReported = true;
+                    }
+                    return ValueType::I64;
+                }
+                default:
+                    return ValueType::PTR;
+            }
+        }
+
+        /// Creates a block.
+        /// @return The ID of the block.
+        BlockId CreateBlock()
+        {
+            BlockId block_id = Output.CreateBlock();
+            SealedBlocks.push_back(false);
+            IncompletePhis.emplace_back();
+            return block_id;
+        }
+
+        /// Makes sure there's a block to add instructions to.  Code after a
+        /// jump or return is unreachable but still lowered, into a new block.
+        void EnsureCurrentBlock()
+        {
+            if (INVALID_ID == CurrentBlock)
+            {
+                CurrentBlock = CreateBlock();
+                SealBlock(CurrentBlock);
+            }
+        }
+
+        /// Adds an instruction to the end of the current block.
+        /// @param[in] kind - The kind of instruction.
+        /// @param[in] type - The type of value produced.
+        /// @param[in] operands - The operands.
+        /// @param[in] immediate - Any constant specific to the kind of instruction.
+        /// @return The ID of the instruction.
+        ValueId Emit(const InstructionKind kind, const ValueType type, const std::initializer_list<ValueId> operands, const std::int64_t immediate = 0)
+        {
+            EnsureCurrentBlock();
+            return Output.AppendInstruction(CurrentBlock, kind, type, operands, immediate);
+        }
+
+        /// Ends the current block.
+        /// @param[in] kind - The kind of terminator.
+        /// @param[in] operands - The terminator's operands.
+        /// @param[in] successors - The blocks the terminator continues to.
+        void Terminate(const InstructionKind kind, const std::initializer_list<ValueId> operands, const std::initializer_list<BlockId> successors)
+        {
+            Emit(kind, ValueType::VOID, operands);
+            for (const BlockId successor : successors)
+            {
+                Output.AddEdge(CurrentBlock, successor);
+            }
+            CurrentBlock = INVALID_ID;
+        }
+
+        /// Ends any current block by jumping to another block.
+        /// @param[in] target_block - The block to jump to.
+        void Jump(const BlockId target_block)
+        {
+            if (INVALID_ID != CurrentBlock)
+            {
+                Terminate(InstructionKind::JUMP, {}, { target_block });
+            }
+        }
+
+        /// Records the value of a variable at the end of a block.
+        /// @param[in] variable_index - The variable.
+        /// @param[in] block_id - The block.
+        /// @param[in] value - The variable's value.
+        void WriteVariable(const std::uint32_t variable_index, const BlockId block_id, const ValueId value)
+        {
+            CurrentDefinitions[GetDefinitionKey(variable_index, block_id)] = value;
+        }
+
+        /// Reads the value of a variable in a block, creating phis as needed.
+        /// @param[in] variable_index - The variable.
+        /// @param[in] block_id - The block.
+        /// @return The variable's value.
+        ValueId ReadVariable(const std::uint32_t variable_index, const BlockId block_id)
+        {
+            auto definition = CurrentDefinitions.find(GetDefinitionKey(variable_index, block_id));
+            if (CurrentDefinitions.end() != definition)
+            {
+                // Definitions may refer to phis removed since they were recorded.
+                return ResolveReplacedPhi(definition->second);
+            }
+            return ReadVariableFromPredecessors(variable_index, block_id);
+        }
+
+        /// Reads the value of a variable not defined in a block from the block's predecessors.
+        /// @param[in] variable_index - The variable.
+        /// @param[in] block_id - The block.
+        /// @return The variable's value.
+        ValueId ReadVariableFromPredecessors(const std::uint32_t variable_index, const BlockId block_id)
+        {
+            ValueType type = GetValueType(Variables[variable_index].DataType, Source.Header.LineNumber);
+            const std::vector<BlockId>& predecessors = Output.Blocks[block_id].Predecessors;
+            ValueId value = INVALID_ID;
+            if (!SealedBlocks[block_id])
+            {
+                // More predecessors may be added, so a phi is needed to be completed later.
+                value = Output.AddPhi(block_id, type);
+                IncompletePhis[block_id].emplace_back(variable_index, value);
+            }
+            else if (predecessors.empty())
+            {
+                value = Output.GetUndefined(type);
+            }
+            else if (1 == predecessors.size())
+            {
+                value = ReadVariable(variable_index, predecessors.front());
+            }
+            else
+            {
+                // The phi is recorded first to break cycles through loops.
+                ValueId phi = Output.AddPhi(block_id, type);
+                WriteVariable(variable_index, block_id, phi);
+                value = AddPhiOperands(variable_index, phi);
+            }
+            WriteVariable(variable_index, block_id, value);
+            return value;
+        }
+
+        /// Adds operands to a phi for a variable from each predecessor of its block.
+        /// @param[in] variable_index - The variable.
+        /// @param[in] phi - The phi.
+        /// @return The phi, or the value replacing it if it was trivial.
+        ValueId AddPhiOperands(const std::uint32_t variable_index, const ValueId phi)
+        {
+            BlockId block_id = Output.Values[phi].Block;
+            std::vector<BlockId> predecessors = Output.Blocks[block_id].Predecessors;
+            for (const BlockId predecessor : predecessors)
+            {
+                Output.AddOperand(phi, ReadVariable(variable_index, predecessor));
+            }
+            return RemoveTrivialPhi(phi);
+        }
+
+        /// Removes a phi if it only merges a single value (besides itself).
+        /// @param[in] phi - The phi.
+        /// @return The phi, or the value replacing it if it was trivial.
+        ValueId RemoveTrivialPhi(const ValueId phi)
+        {
+            // CHECK IF THE PHI MERGES MORE THAN ONE VALUE.
+            ValueId same_value = INVALID_ID;
+            for (const ValueId operand : Output.GetOperands(phi))
+            {
+                if (operand == same_value || operand == phi)
+                {
+                    continue;
+                }
+                if (INVALID_ID != same_value)
+                {
+                    return phi;
+                }
+                same_value = operand;
+            }
+            if (INVALID_ID == same_value)
+            {
+                // The phi is unreachable or only references itself.
+                same_value = Output.GetUndefined(Output.Values[phi].Type);
+            }
+
+            // REPLACE THE PHI.
+            std::vector<ValueId> users = Output.GetUsers(phi);
+            Output.ReplaceAllUsesWith(phi, same_value);
+            Output.RemoveInstruction(phi);
+            ReplacedPhis[phi] = same_value;
+
+            // Phis using this one may have become trivial too.
+            for (const ValueId user : users)
+            {
+                if (user != phi && InstructionKind::PHI == Output.Values[user].Kind)
+                {
+                    RemoveTrivialPhi(user);
+                }
+            }
+            return ResolveReplacedPhi(same_value);
+        }
+
+        /// Follows replacements of removed phis.
+        /// @param[in] value - A value that may be a removed phi.
+        /// @return The value currently standing in for the given value.
+        ValueId ResolveReplacedPhi(ValueId value) const
+        {
+            for (auto replacement = ReplacedPhis.find(value); ReplacedPhis.end() != replacement; replacement = ReplacedPhis.find(value))
+            {
+                value = replacement->second;
+            }
+            return value;
+        }
+
+        /// Marks a block as having all of its predecessors, completing any phis in it.
+        /// @param[in] block_id - The block.
+        void SealBlock(const BlockId block_id)
+        {
+            std::vector<std::pair<std::uint32_t, ValueId>> incomplete_phis = std::move(IncompletePhis[block_id]);
+            IncompletePhis[block_id].clear();
+            for (const auto& [variable_index, phi] : incomplete_phis)
+            {
+                AddPhiOperands(variable_index, phi);
+            }
+            SealedBlocks[block_id] = true;
+        }
+
+        /// Gets the key for a variable's definition in a block.
+        /// @param[in] variable_index - The variable.
+        /// @param[in] block_id - The block.
+        /// @return The key.
+        static std::uint64_t GetDefinitionKey(const std::uint32_t variable_index, const BlockId block_id)
+        {
+            return (static_cast<std::uint64_t>(block_id) << 32) | variable_index;
+        }
+
+        /// Adds an error for code that can't be lowered.
+        /// @param[in] line_number - The line of the code.
+        /// @param[in] message - The error message.
+        void AddError(const std::size_t line_number, const std::string& message)
+        {
+            ErrorMessages += Source.Header.Filepath + ":" + std::to_string(line_number) + ": error: " + message + "\n";
+        }
+
+        /// The program containing the function being lowered.
+        const Program& SourceProgram;
+        /// The types from semantic analysis of the program.
+        const SEMANTIC_ANALYSIS::TypeTable& Types;
+        /// The function being lowered.
+        const FunctionDefinition& Source;
+        /// The function being lowered into.
+        Function& Output;
+        /// The block instructions are being added to, or invalid after a terminator.
+        BlockId CurrentBlock = INVALID_ID;
+        /// The position in the entry block to insert stack slots at (after parameters and earlier slots).
+        std::size_t EntryInsertPosition = 0;
+        /// All variables by index.
+        std::vector<Variable> Variables = {};
+        /// The variables currently in scope, with their indices as symbol IDs.
+        SEMANTIC_ANALYSIS::SymbolTable Symbols = {};
+        /// The names of variables whose addresses are taken somewhere in the function.
+        std::unordered_set<std::string> AddressTakenNames = {};
+        /// The value of each variable at the end of each block where it's known, keyed by block and variable.
+        std::unordered_map<std::uint64_t, ValueId> CurrentDefinitions = {};
+        /// Whether each block has all of its predecessors.
+        std::vector<bool> SealedBlocks = {};
+        /// Phis awaiting operands in each unsealed block, along with their variables.
+        std::vector<std::vector<std::pair<std::uint32_t, ValueId>>> IncompletePhis = {};
+        /// The values that removed phis were replaced with.
+        std::unordered_map<ValueId, ValueId> ReplacedPhis = {};
+        /// The indices of called functions in the output's callee names.
+        std::unordered_map<std::string, std::uint32_t> CalleeIndicesByName = {};
+        /// The loops enclosing the code being lowered, innermost last.
+        std::vector<LoopTargets> Loops = {};
+        /// True if floating-point values have been reported as unsupported in the function.
+        bool FloatingPointReported = false;
+        /// Any errors for code that can't be lowered.
+        std::string ErrorMessages = "";
+    };
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <span>
+#include <string>
+#include "IntermediateRepresentation/Function.h"
+
+namespace INTERMEDIATE_REPRESENTATION
+{
+    /// Prints functions as text for debugging, such as:
+    ///
+    ///     function i32 main(i32, ptr)
+    ///       block0:
+    ///         %3 = add i32 %1, 5
+    ///         branch %4, block1, block2
+    ///       block1: ; preds block0
+    ///         %7 = phi i32 [%3, block0], [%6, block3]
+    ///
+    /// Constants are printed inline rather than by ID.
+    struct IrPrinter
+    {
+        /// Prints all functions in a module.
+        /// @param[in] module - The module to print.
+        /// @return The text for the module.
+        static std::string Print(const Module& module)
+        {
+            std::string text;
+            for (const Function& function : module.Functions)
+            {
+                if (!text.empty())
+                {
+                    text += "\n";
+                }
+                text += Print(function);
+            }
+            return text;
+        }
+
+        /// Prints a function.
+        /// @param[in] function - The function to print.
+        /// @return The text for the function.
+        static std::string Print(const Function& function)
+        {
+            // PRINT THE SIGNATURE.
+            std::string text = std::string(function.IsStatic ? "static " : "") + "function " + std::string(GetValueTypeName(function.ReturnType)) + " " + function.Name + "(";
+            for (std::size_t parameter_index = 0; parameter_index < function.ParameterTypes.size(); ++parameter_index)
+            {
+                text += (parameter_index > 0 ? ", " : "");
+                text += GetValueTypeName(function.ParameterTypes[parameter_index]);
+            }
+            if (function.IsVariadic)
+            {
+                text += function.ParameterTypes.empty() ? "..." : ", ...";
+            }
+            text += ")\n";
+
+            // PRINT EACH BLOCK.
+            for (BlockId block_id = 0; block_id < function.Blocks.size(); ++block_id)
+            {
+                const BasicBlock& block = function.Blocks[block_id];
+                text += "  block" + std::to_string(block_id) + ":";
+                for (std::size_t predecessor_index = 0; predecessor_index < block.Predecessors.size(); ++predecessor_index)
+                {
+                    text += (0 == predecessor_index) ? " ; preds " : ", ";
+                    text += "block" + std::to_string(block.Predecessors[predecessor_index]);
+                }
+                text += "\n";
+
+                for (const ValueId instruction_id : block.Instructions)
+                {
+                    text += "    " + PrintInstruction(function, instruction_id) + "\n";
+                }
+            }
+            return text;
+        }
+
+        /// Prints a single instruction.
+        /// @param[in] function - The function containing the instruction.
+        /// @param[in] instruction_id - The instruction.
+        /// @return The text for the instruction, without a newline.
+        static std::string PrintInstruction(const Function& function, const ValueId instruction_id)
+        {
+            const Instruction& instruction = function.Values[instruction_id];
+            std::span<const ValueId> operands = function.GetOperands(instruction_id);
+            const BasicBlock& block = function.Blocks[instruction.Block];
+
+            // PRINT THE RESULT.
+            std::string text;
+            if (ValueType::VOID != instruction.Type)
+            {
+                text += "%" + std::to_string(instruction_id) + " = ";
+            }
+            text += GetInstructionKindName(instruction.Kind);
+            if (ValueType::VOID != instruction.Type)
+            {
+                text += " " + std::string(GetValueTypeName(instruction.Type));
+            }
+
+            // PRINT THE OPERANDS.
+            switch (instruction.Kind)
+            {
+                case InstructionKind::PARAMETER:
+                case InstructionKind::STACK_SLOT:
+                    text += " " + std::to_string(instruction.Immediate);
+                    break;
+                case InstructionKind::STRING_ADDRESS:
+                    text += " " + PrintStringLiteral(function.StringLiterals[static_cast<std::size_t>(instruction.Immediate)]);
+                    break;
+                case InstructionKind::PHI:
+                {
+                    for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+                    {
+                        text += (operand_index > 0) ? ", [" : " [";
+                        text += PrintValue(function, operands[operand_index]);
+                        if (operand_index < block.Predecessors.size())
+                        {
+                            text += ", block" + std::to_string(block.Predecessors[operand_index]);
+                        }
+                        text += "]";
+                    }
+                    break;
+                }
+                case InstructionKind::CALL:
+                {
+                    text += " " + function.CalleeNames[static_cast<std::size_t>(instruction.Immediate)] + "(";
+                    for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+                    {
+                        text += (operand_index > 0) ? ", " : "";
+                        text += PrintValue(function, operands[operand_index]);
+                    }
+                    text += ")";
+                    break;
+                }
+                default:
+                {
+                    for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+                    {
+                        text += (operand_index > 0) ? ", " : " ";
+                        text += PrintValue(function, operands[operand_index]);
+                    }
+                    for (std::size_t successor_index = 0; successor_index < block.Successors.size() && IsTerminator(instruction.Kind); ++successor_index)
+                    {
+                        text += (operands.empty() && 0 == successor_index) ? " " : ", ";
+                        text += "block" + std::to_string(block.Successors[successor_index]);
+                    }
+                    break;
+                }
+            }
+            return text;
+        }
+
+        /// Prints a reference to a value.
+        /// @param[in] function - The function containing the value.
+        /// @param[in] value - The value.
+        /// @return The value's ID, or the value itself for constants.
+        static std::string PrintValue(const Function& function, const ValueId value)
+        {
+            const Instruction& instruction = function.Values[value];
+            switch (instruction.Kind)
+            {
+                case InstructionKind::CONSTANT:
+                    return std::to_string(instruction.Immediate);
+                case InstructionKind::UNDEFINED:
+                    return "undef";
+                default:
+                    return "%" + std::to_string(value);
+            }
+        }
+
+        /// Prints a string literal with quotes and escapes.
+        /// @param[in] characters - The characters in the string.
+        /// @return The quoted string.
+        static std::string PrintStringLiteral(const std::string& characters)
+        {
+            std::string text = "\"";
+            for (const char character : characters)
+            {
+                unsigned char byte = static_cast<unsigned char>(character);
+                if ('"' == character || '\\' == character)
+                {
+                    text += '\\';
+                    text += character;
+                }
+                else if (byte < 0x20 || byte >= 0x7F)
+                {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\x%02X", byte);
+                    text += escape;
+                }
+                else
+                {
+                    text += character;
+                }
+            }
+            text += "\"";
+            return text;
+        }
+    };
+}
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+
+namespace INTERMEDIATE_REPRESENTATION
+{
+    /// Checks the structural invariants of functions, so that bugs in lowering
+    /// or optimization are caught where they happen rather than in later passes.
+    struct IrVerifier
+    {
+        /// Verifies a function.
+        /// @param[in] function - The function to verify.
+        /// @return A description of the first problem found, if any; null if the function is valid.
+        static std::optional<std::string> Verify(const Function& function)
+        {
+            IrVerifier verifier(function);
+            verifier.VerifyBlocks();
+            if (!verifier.Error)
+            {
+                verifier.VerifyUses();
+            }
+            return verifier.Error;
+        }
+
+    private:
+        /// Creates a verifier for a function.
+        /// @param[in] function - The function to verify.
+        explicit IrVerifier(const Function& function) :
+            Source(function)
+        {}
+
+        /// Verifies the contents of each block and the edges between them.
+        void VerifyBlocks()
+        {
+            if (Source.Blocks.empty())
+            {
+                AddError(INVALID_ID, "has no blocks");
+                return;
+            }
+
+            // The position of each instruction in its block, for checking that definitions come before uses.
+            std::vector<std::size_t> instruction_positions(Source.Values.size(), 0);
+            for (BlockId block_id = 0; block_id < Source.Blocks.size() && !Error; ++block_id)
+            {
+                const BasicBlock& block = Source.Blocks[block_id];
+                for (std::size_t position = 0; position < block.Instructions.size(); ++position)
+                {
+                    instruction_positions[block.Instructions[position]] = position;
+                }
+
+                // CHECK THE EDGES.
+                for (const BlockId successor : block.Successors)
+                {
+                    const std::vector<BlockId>& successor_predecessors = Source.Blocks[successor].Predecessors;
+                    if (std::count(block.Successors.begin(), block.Successors.end(), successor) != std::count(successor_predecessors.begin(), successor_predecessors.end(), block_id))
+                    {
+                        AddError(block_id, "successor block" + std::to_string(successor) + " doesn't list it as a predecessor");
+                        return;
+                    }
+                }
+                for (const BlockId predecessor : block.Predecessors)
+                {
+                    const std::vector<BlockId>& predecessor_successors = Source.Blocks[predecessor].Successors;
+                    if (std::count(predecessor_successors.begin(), predecessor_successors.end(), block_id) == 0)
+                    {
+                        AddError(block_id, "predecessor block" + std::to_string(predecessor) + " doesn't list it as a successor");
+                        return;
+                    }
+                }
+                if (Function::ENTRY_BLOCK_ID == block_id && !block.Predecessors.empty())
+                {
+                    AddError(block_id, "entry block has predecessors");
+                    return;
+                }
+
+                // CHECK THE INSTRUCTIONS.
+                if (block.Instructions.empty())
+                {
+                    AddError(block_id, "is empty");
+                    return;
+                }
+                bool phis_allowed = true;
+                for (std::size_t position = 0; position < block.Instructions.size() && !Error; ++position)
+                {
+                    ValueId instruction_id = block.Instructions[position];
+                    const Instruction& instruction = Source.Values[instruction_id];
+                    if (instruction.Block != block_id)
+                    {
+                        AddError(block_id, "%" + std::to_string(instruction_id) + " records a different block");
+                        return;
+                    }
+
+                    bool is_last = (position + 1 == block.Instructions.size());
+                    if (IsTerminator(instruction.Kind) != is_last)
+                    {
+                        AddError(block_id, is_last ? "doesn't end with a terminator" : "has a terminator before its end");
+                        return;
+                    }
+
+                    if (InstructionKind::PHI == instruction.Kind && !phis_allowed)
+                    {
+                        AddError(block_id, "phi %" + std::to_string(instruction_id) + " follows other instructions");
+                        return;
+                    }
+                    phis_allowed = (InstructionKind::PHI == instruction.Kind);
+
+                    bool entry_only = (InstructionKind::PARAMETER == instruction.Kind || InstructionKind::STACK_SLOT == instruction.Kind);
+                    if (entry_only && Function::ENTRY_BLOCK_ID != block_id)
+                    {
+                        AddError(block_id, "%" + std::to_string(instruction_id) + " is only allowed in the entry block");
+                        return;
+                    }
+
+                    // Values defined in the same block must be defined earlier, except for phis,
+                    // whose operands come from the ends of predecessors.
+                    for (const ValueId operand : Source.GetOperands(instruction_id))
+                    {
+                        if (operand >= Source.Values.size() || InstructionKind::DELETED == Source.Values[operand].Kind)
+                        {
+                            AddError(block_id, "%" + std::to_string(instruction_id) + " uses a deleted or invalid value");
+                            return;
+                        }
+                        bool defined_later = (
+                            InstructionKind::PHI != instruction.Kind &&
+                            Source.Values[operand].Block == block_id &&
+                            instruction_positions[operand] >= position);
+                        if (defined_later)
+                        {
+                            AddError(block_id, "%" + std::to_string(instruction_id) + " uses %" + std::to_string(operand) + " before its definition");
+                            return;
+                        }
+                    }
+
+                    VerifyInstruction(instruction_id);
+                }
+            }
+        }
+
+        /// Verifies the operands and type of an instruction.
+        /// @param[in] instruction_id - The instruction.
+        void VerifyInstruction(const ValueId instruction_id)
+        {
+            const Instruction& instruction = Source.Values[instruction_id];
+            std::span<const ValueId> operands = Source.GetOperands(instruction_id);
+            const BasicBlock& block = Source.Blocks[instruction.Block];
+            auto operand_type = [&](const std::size_t operand_index) { return Source.Values[operands[operand_index]].Type; };
+            auto expect = [&](const bool condition, const std::string& message)
+            {
+                if (!condition && !Error)
+                {
+                    AddError(instruction.Block, "%" + std::to_string(instruction_id) + " (" + GetInstructionKindName(instruction.Kind) + ") " + message);
+                }
+            };
+
+            InstructionKind kind = instruction.Kind;
+            if (IsBinaryOperation(kind))
+            {
+                expect(2 == operands.size(), "needs 2 operands");
+                if (Error) return;
+                bool is_pointer_offset = ((InstructionKind::ADD == kind || InstructionKind::SUBTRACT == kind) && ValueType::PTR == instruction.Type);
+                bool is_pointer_difference = (InstructionKind::SUBTRACT == kind && ValueType::PTR == operand_type(0) && ValueType::PTR == operand_type(1));
+                if (is_pointer_offset)
+                {
+                    expect(ValueType::PTR == operand_type(0) && ValueType::I64 == operand_type(1), "must offset a ptr by an i64");
+                }
+                else if (is_pointer_difference)
+                {
+                    expect(ValueType::I64 == instruction.Type, "must produce an i64 pointer difference");
+                }
+                else
+                {
+                    expect(ValueType::VOID != instruction.Type && ValueType::PTR != instruction.Type, "must produce an integer");
+                    expect(operand_type(0) == instruction.Type && operand_type(1) == instruction.Type, "operands must match the result type");
+                }
+            }
+            else if (IsComparison(kind))
+            {
+                expect(2 == operands.size(), "needs 2 operands");
+                if (Error) return;
+                expect(ValueType::I32 == instruction.Type, "must produce an i32");
+                expect(operand_type(0) == operand_type(1) && ValueType::VOID != operand_type(0), "operands must have the same type");
+            }
+            else if (IsConversion(kind))
+            {
+                expect(1 == operands.size(), "needs 1 operand");
+                if (Error) return;
+                std::size_t from_size = GetValueTypeSizeInBytes(operand_type(0));
+                std::size_t to_size = GetValueTypeSizeInBytes(instruction.Type);
+                bool integers = (ValueType::PTR != operand_type(0) && ValueType::PTR != instruction.Type && from_size > 0 && to_size > 0);
+                bool sizes_valid = (InstructionKind::TRUNCATE == kind) ? (to_size < from_size) : (to_size > from_size);
+                expect(integers && sizes_valid, "converts between invalid types");
+            }
+            else
+            {
+                switch (kind)
+                {
+                    case InstructionKind::NEGATE:
+                    case InstructionKind::NOT:
+                        expect(1 == operands.size() && operand_type(0) == instruction.Type && ValueType::PTR != instruction.Type, "needs 1 integer operand of the result type");
+                        break;
+                    case InstructionKind::PHI:
+                    {
+                        expect(operands.size() == block.Predecessors.size(), "needs an operand for each predecessor");
+                        for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+                        {
+                            expect(operand_type(operand_index) == instruction.Type, "operands must match the result type");
+                        }
+                        break;
+                    }
+                    case InstructionKind::PARAMETER:
+                    {
+                        bool index_valid = (instruction.Immediate >= 0 && static_cast<std::size_t>(instruction.Immediate) < Source.ParameterTypes.size());
+                        expect(index_valid && operands.empty(), "has an invalid index");
+                        if (index_valid)
+                        {
+                            expect(Source.ParameterTypes[static_cast<std::size_t>(instruction.Immediate)] == instruction.Type, "doesn't match the parameter's type");
+                        }
+                        break;
+                    }
+                    case InstructionKind::STACK_SLOT:
+                        expect(ValueType::PTR == instruction.Type && instruction.Immediate > 0 && operands.empty(), "must be a ptr to a positive size");
+                        break;
+                    case InstructionKind::STRING_ADDRESS:
+                    {
+                        bool index_valid = (instruction.Immediate >= 0 && static_cast<std::size_t>(instruction.Immediate) < Source.StringLiterals.size());
+                        expect(ValueType::PTR == instruction.Type && index_valid, "must be a ptr to a valid string");
+                        break;
+                    }
+                    case InstructionKind::LOAD:
+                        expect(1 == operands.size() && ValueType::PTR == operand_type(0) && ValueType::VOID != instruction.Type, "must load a value from a ptr");
+                        break;
+                    case InstructionKind::STORE:
+                        expect(2 == operands.size() && ValueType::PTR == operand_type(0) && ValueType::VOID == instruction.Type, "must store a value to a ptr");
+                        if (!Error) expect(ValueType::VOID != operand_type(1), "must store a value");
+                        break;
+                    case InstructionKind::CALL:
+                    {
+                        bool index_valid = (instruction.Immediate >= 0 && static_cast<std::size_t>(instruction.Immediate) < Source.CalleeNames.size());
+                        expect(index_valid, "calls an invalid function");
+                        break;
+                    }
+                    case InstructionKind::JUMP:
+                        expect(operands.empty() && 1 == block.Successors.size(), "needs 1 successor");
+                        break;
+                    case InstructionKind::BRANCH:
+                        expect(1 == operands.size() && 2 == block.Successors.size(), "needs a condition and 2 successors");
+                        if (!Error) expect(ValueType::VOID != operand_type(0), "needs a non-void condition");
+                        break;
+                    case InstructionKind::RETURN:
+                    {
+                        expect(block.Successors.empty(), "can't have successors");
+                        bool returns_value = (ValueType::VOID != Source.ReturnType);
+                        expect(operands.size() == (returns_value ? 1u : 0u), "doesn't match the function's return type");
+                        if (!Error && returns_value) expect(operand_type(0) == Source.ReturnType, "doesn't match the function's return type");
+                        break;
+                    }
+                    default:
+                        expect(false, "isn't allowed in a block");
+                        break;
+                }
+            }
+        }
+
+        /// Verifies that use lists exactly match operands.
+        void VerifyUses()
+        {
+            // EVERY OPERAND MUST HAVE A USE IN ITS VALUE'S LIST.
+            std::size_t operand_count = 0;
+            for (ValueId instruction_id = 0; instruction_id < Source.Values.size() && !Error; ++instruction_id)
+            {
+                const Instruction& instruction = Source.Values[instruction_id];
+                if (InstructionKind::DELETED == instruction.Kind)
+                {
+                    continue;
+                }
+                for (std::uint32_t operand_index = 0; operand_index < instruction.OperandCount; ++operand_index)
+                {
+                    std::uint32_t operand_slot = instruction.FirstOperandIndex + operand_index;
+                    UseId use_id = Source.OperandUses[operand_slot];
+                    bool use_valid = (
+                        use_id < Source.Uses.size() &&
+                        Source.Uses[use_id].User == instruction_id &&
+                        Source.Uses[use_id].OperandIndex == operand_index);
+                    if (!use_valid)
+                    {
+                        AddError(instruction.Block, "%" + std::to_string(instruction_id) + " operand " + std::to_string(operand_index) + " has an inconsistent use");
+                        return;
+                    }
+                    ++operand_count;
+                }
+            }
+
+            // EVERY USE MUST BE AN OPERAND REFERRING TO ITS VALUE.
+            std::size_t use_count = 0;
+            for (ValueId value = 0; value < Source.Values.size() && !Error; ++value)
+            {
+                UseId previous_use_id = INVALID_ID;
+                for (UseId use_id = Source.Values[value].FirstUse; INVALID_ID != use_id; use_id = Source.Uses[use_id].NextUse)
+                {
+                    const Use& use = Source.Uses[use_id];
+                    bool use_valid = (
+                        use.PreviousUse == previous_use_id &&
+                        InstructionKind::DELETED != Source.Values[use.User].Kind &&
+                        use.OperandIndex < Source.Values[use.User].OperandCount &&
+                        Source.GetOperand(use.User, use.OperandIndex) == value);
+                    if (!use_valid || use_count > operand_count)
+                    {
+                        AddError(Source.Values[value].Block, "%" + std::to_string(value) + " has an inconsistent use list");
+                        return;
+                    }
+                    previous_use_id = use_id;
+                    ++use_count;
+                }
+            }
+            if (!Error && use_count != operand_count)
+            {
+                AddError(INVALID_ID, "has " + std::to_string(use_count) + " uses for " + std::to_string(operand_count) + " operands");
+            }
+        }
+
+        /// Records an error if none has been found yet.
+        /// @param[in] block_id - The block with the problem, or invalid if it isn't specific to a block.
+        /// @param[in] message - A description of the problem.
+        void AddError(const BlockId block_id, const std::string& message)
+        {
+            if (Error)
+            {
+                return;
+            }
+            std::string location = "function '" + Source.Name + "'";
+            if (INVALID_ID != block_id)
+            {
+                location += ": block" + std::to_string(block_id);
+            }
+            Error = location + ": " + message;
+        }
+
+        /// The function being verified.
+        const Function& Source;
+        /// The first problem found, if any.
+        std::optional<std::string> Error = std::nullopt;
+    };
+}
@@ -91,7 +91,7 @@ struct MultilineComment
             // it must end at some point for the program to be valid.
             // If we reach the end of the above loop without finding
             // the end of the comment, that's an error.
-            std::printf("Unterminated multiline comment found.");
+            std::fprintf(stderr, "Unterminated multiline comment found.\n");
             return std::nullopt;
         }
     }
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include "CustomString.h"
+#include "Tokenization/Token.h"
+
+struct PreprocessorDirective
+{
+    static bool IsAtStartOfLine(const std::string& source_code, const std::size_t start_index)
+    {
+        // CHECK IF ONLY WHITESPACE PRECEDES THE CHARACTER ON ITS LINE.
+        for (std::size_t previous_character_count = start_index; previous_character_count > 0; --previous_character_count)
+        {
+            char previous_character = source_code[previous_character_count - 1];
+            bool line_start_reached = ('\n' == previous_character || '\r' == previous_character);
+            if (line_start_reached)
+            {
+                return true;
+            }
+            
+            bool is_whitespace = (' ' == previous_character || '\t' == previous_character);
+            if (!is_whitespace)
+            {
+                return false;
+            }
+        }
+        
+        // The start of the source code also starts a line.
+        return true;
+    }
+    
+    static std::optional<TOKENIZATION::Token> Parse(const std::string& source_code, const std::size_t start_index)
+    {
+        using namespace TOKENIZATION;
+        
+        // MAKE SURE THE DIRECTIVE STARTS A LINE.
+        // A '#' anywhere else is an operator (such as in macro definitions).
+        std::optional<char> first_character = String::GetCharacterIfExists(source_code, start_index);
+        bool is_start_of_directive = ('#' == first_character) && IsAtStartOfLine(source_code, start_index);
+        if (!is_start_of_directive)
+        {
+            return std::nullopt;
+        }
+        
+        // READ THE REST OF THE LINE.
+        // A backslash right before the end of a line continues the directive
+        // onto the next line, so the raw characters are kept for both.
+        Token directive = { .Type = TokenType::PREPROCESSOR_DIRECTIVE };
+        std::size_t source_code_character_count = source_code.length();
+        for (std::size_t character_index = start_index; character_index < source_code_character_count; ++character_index)
+        {
+            char character = source_code[character_index];
+            bool line_end_reached = ('\r' == character || '\n' == character);
+            if (line_end_reached)
+            {
+                bool line_continued = (!directive.Value.empty() && '\\' == directive.Value.back());
+                if (!line_continued)
+                {
+                    break;
+                }
+            }
+            
+            directive.Value += character;
+        }
+        
+        return directive;
+    }
+};
+
@@ -13,6 +13,10 @@ struct StringLiteral
         Token string_literal = { .Type = TokenType::STRING_LITERAL };
         
         // ADD ALL APPROPRIATE CHARACTERS TO THE STRING.
+        // The opening quote is always included, so searching for the closing quote starts after it.
+        // The same parsing works for character constants, which just use a different quote.
+        char quote = source_code[start_index];
+        bool escape_sequence_started = false;
         std::size_t source_code_character_count = source_code.length();
         for (std::size_t character_index = start_index; character_index < source_code_character_count; ++character_index)
         {
@@ -21,11 +25,15 @@ struct StringLiteral
             string_literal.Value += character;
             
             // CHECK IF THE END OF THE STRING WAS FOUND.
-            bool end_of_string = '"' == character;
+            // Quotes preceded by a backslash are part of the string.
+            bool is_opening_quote = (start_index == character_index);
+            bool end_of_string = !is_opening_quote && !escape_sequence_started && quote == character;
             if (end_of_string)
             {
-                
+                break;
             }
+            
+            escape_sequence_started = !escape_sequence_started && '\\' == character;
         }
         
         return string_literal;
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+
+namespace METAPROGRAMMING
+{
+    /// Expressions found by a query, grouped by the function containing them.
+    using ExpressionsByFunction = std::map<std::string, std::vector<const Expression*>>;
+    /// Variable declarations found by a query, grouped by the function containing them.
+    using DeclarationsByFunction = std::map<std::string, std::vector<const VariableDeclaration*>>;
+
+    /// Secondary indices over a program's syntax tree, so metaprogramming passes can
+    /// answer queries like "all calls to f" without walking every function.
+    ///
+    /// Indices are built in a single pass over the program.  Functions are the
+    /// unit of update: editing the program through the index (or reindexing a
+    /// function after editing it in place) only walks the affected function.
+    ///
+    /// Query results refer directly to nodes in the program and are ordered by
+    /// function name, so results are deterministic.  Results for a function remain
+    /// valid until that function is edited or removed.  Types are matched by their
+    /// spelling in the syntax tree (such as "unsigned int*").
+    struct ProgramIndex
+    {
+        /// Builds indices for a program.
+        /// @param[in] program - The program to index.  Must outlive the index.
+        /// @return The indices for the program.
+        static ProgramIndex Build(const Program& program)
+        {
+            ProgramIndex index;
+            for (const auto& [function_name, function_declaration] : program.FunctionDeclarationsByName)
+            {
+                index.Reindex(program, function_name);
+            }
+            for (const auto& [function_name, function_definition] : program.FunctionsByName)
+            {
+                // Functions that were also declared were already indexed.
+                if (!program.FunctionDeclarationsByName.contains(function_name))
+                {
+                    index.Reindex(program, function_name);
+                }
+            }
+            return index;
+        }
+
+        /// Finds functions declared or defined with a return type.
+        /// @param[in] return_type - The return type.
+        /// @return The names of the functions.
+        const std::set<std::string>& FindFunctionsReturning(const std::string& return_type) const
+        {
+            return FindOrEmpty(FunctionNamesByReturnType, return_type);
+        }
+
+        /// Finds functions declared or defined with any parameter of a type.
+        /// @param[in] parameter_type - The parameter type.
+        /// @return The names of the functions.
+        const std::set<std::string>& FindFunctionsWithParameterType(const std::string& parameter_type) const
+        {
+            return FindOrEmpty(FunctionNamesByParameterType, parameter_type);
+        }
+
+        /// Finds calls to a function.
+        /// @param[in] callee_name - The name of the called function.
+        /// @return The call expressions, in the order they appear within each function.
+        const ExpressionsByFunction& FindCallsTo(const std::string& callee_name) const
+        {
+            return FindOrEmpty(CallsByCalleeName, callee_name);
+        }
+
+        /// Finds uses of a name in expressions other than calls, such as variables being read or assigned.
+        /// @param[in] name - The name.
+        /// @return The identifier expressions, in the order they appear within each function.
+        const ExpressionsByFunction& FindReferencesTo(const std::string& name) const
+        {
+            return FindOrEmpty(ReferencesByName, name);
+        }
+
+        /// Finds declarations of parameters and local variables of a type.
+        /// Arrays are matched by their full type (such as "int[10]").
+        /// @param[in] data_type - The type.
+        /// @return The declarations, in the order they appear within each function.
+        const DeclarationsByFunction& FindDeclarationsOfType(const std::string& data_type) const
+        {
+            return FindOrEmpty(DeclarationsByType, data_type);
+        }
+
+        /// Adds or replaces a function definition in a program, updating the indices.
+        /// @param[in,out] program - The indexed program.
+        /// @param[in] function_definition - The function to add.
+        void SetFunction(Program& program, FunctionDefinition function_definition)
+        {
+            std::string function_name = function_definition.Header.Name;
+            program.FunctionsByName[function_name] = std::move(function_definition);
+            Reindex(program, function_name);
+        }
+
+        /// Removes a function's declaration and definition from a program, updating the indices.
+        /// @param[in,out] program - The indexed program.
+        /// @param[in] function_name - The name of the function to remove.
+        void RemoveFunction(Program& program, const std::string& function_name)
+        {
+            program.FunctionsByName.erase(function_name);
+            program.FunctionDeclarationsByName.erase(function_name);
+            Reindex(program, function_name);
+        }
+
+        /// Updates the indices for a function after it was added, edited in place, or removed.
+        /// @param[in] program - The indexed program.
+        /// @param[in] function_name - The name of the function that changed.
+        void Reindex(const Program& program, const std::string& function_name)
+        {
+            RemoveFromIndices(function_name);
+
+            // INDEX ANY DECLARATION.
+            IndexedFunction indexed_function;
+            auto function_declaration = program.FunctionDeclarationsByName.find(function_name);
+            if (program.FunctionDeclarationsByName.end() != function_declaration)
+            {
+                AddHeader(function_declaration->second, indexed_function);
+            }
+
+            // INDEX ANY DEFINITION.
+            auto function_definition = program.FunctionsByName.find(function_name);
+            if (program.FunctionsByName.end() != function_definition)
+            {
+                AddHeader(function_definition->second.Header, indexed_function);
+                for (const VariableDeclaration& parameter : function_definition->second.Header.Parameters)
+                {
+                    AddDeclaration(function_name, parameter, indexed_function);
+                }
+                for (const Statement& statement : function_definition->second.Body.Statements)
+                {
+                    AddStatement(function_name, statement, indexed_function);
+                }
+            }
+
+            bool function_exists = (program.FunctionDeclarationsByName.end() != function_declaration || program.FunctionsByName.end() != function_definition);
+            if (function_exists)
+            {
+                IndexedFunctionsByName.emplace(function_name, std::move(indexed_function));
+            }
+        }
+
+    private:
+        /// The keys a function was added under in each index, so it can be removed later.
+        struct IndexedFunction
+        {
+            /// The return types of the function's declaration and definition.
+            std::set<std::string> ReturnTypes = {};
+            /// The types of the function's parameters.
+            std::set<std::string> ParameterTypes = {};
+            /// The names of functions called.
+            std::set<std::string> CalleeNames = {};
+            /// The names referenced.
+            std::set<std::string> ReferencedNames = {};
+            /// The types of parameters and local variables declared.
+            std::set<std::string> DeclarationTypes = {};
+        };
+
+        /// Finds an entry in an index.
+        /// @param[in] index - The index to search.
+        /// @param[in] key - The key to find.
+        /// @return The entry, if found; an empty entry otherwise.
+        template <typename Entry>
+        static const Entry& FindOrEmpty(const std::unordered_map<std::string, Entry>& index, const std::string& key)
+        {
+            static const Entry EMPTY_ENTRY = {};
+            auto entry = index.find(key);
+            return (index.end() == entry) ? EMPTY_ENTRY : entry->second;
+        }
+
+        /// Removes a function from all indices.
+        /// @param[in] function_name - The name of the function.
+        void RemoveFromIndices(const std::string& function_name)
+        {
+            auto indexed_function = IndexedFunctionsByName.find(function_name);
+            if (IndexedFunctionsByName.end() == indexed_function)
+            {
+                return;
+            }
+
+            // Entries with nothing left are removed so that indices don't grow as functions are edited.
+            auto remove = [&function_name](auto& index, const std::set<std::string>& keys)
+            {
+                for (const std::string& key : keys)
+                {
+                    auto entry = index.find(key);
+                    entry->second.erase(function_name);
+                    if (entry->second.empty())
+                    {
+                        index.erase(entry);
+                    }
+                }
+            };
+            remove(FunctionNamesByReturnType, indexed_function->second.ReturnTypes);
+            remove(FunctionNamesByParameterType, indexed_function->second.ParameterTypes);
+            remove(CallsByCalleeName, indexed_function->second.CalleeNames);
+            remove(ReferencesByName, indexed_function->second.ReferencedNames);
+            remove(DeclarationsByType, indexed_function->second.DeclarationTypes);
+            IndexedFunctionsByName.erase(indexed_function);
+        }
+
+        /// Adds a function's header to the indices.
+        /// @param[in] header - The header of the function's declaration or definition.
+        /// @param[in,out] indexed_function - The keys the function was added under.
+        void AddHeader(const FunctionHeader& header, IndexedFunction& indexed_function)
+        {
+            FunctionNamesByReturnType[header.ReturnType].insert(header.Name);
+            indexed_function.ReturnTypes.insert(header.ReturnType);
+            for (const VariableDeclaration& parameter : header.Parameters)
+            {
+                FunctionNamesByParameterType[parameter.DataType].insert(header.Name);
+                indexed_function.ParameterTypes.insert(parameter.DataType);
+            }
+        }
+
+        /// Adds a variable declaration to the indices.
+        /// @param[in] function_name - The name of the function containing the declaration.
+        /// @param[in] declaration - The declaration.
+        /// @param[in,out] indexed_function - The keys the function was added under.
+        void AddDeclaration(const std::string& function_name, const VariableDeclaration& declaration, IndexedFunction& indexed_function)
+        {
+            DeclarationsByType[declaration.DataType][function_name].push_back(&declaration);
+            indexed_function.DeclarationTypes.insert(declaration.DataType);
+        }
+
+        /// Adds a statement and everything in it to the indices.
+        /// @param[in] function_name - The name of the function containing the statement.
+        /// @param[in] statement - The statement.
+        /// @param[in,out] indexed_function - The keys the function was added under.
+        void AddStatement(const std::string& function_name, const Statement& statement, IndexedFunction& indexed_function)
+        {
+            // Parts of statements are indexed in the order they appear in source code.
+            if (StatementKind::DECLARATION == statement.Kind)
+            {
+                AddDeclaration(function_name, statement.Declaration, indexed_function);
+            }
+            // A for loop's initializer comes before its condition.  Syntax trees edited
+            // through the index may not have one, so its absence is tolerated.
+            bool condition_after_body = (StatementKind::DO_WHILE == statement.Kind);
+            bool has_initializer = (StatementKind::FOR == statement.Kind && !statement.Body.empty());
+            if (statement.Value)
+            {
+                AddExpression(function_name, *statement.Value, indexed_function);
+            }
+            if (has_initializer)
+            {
+                AddStatement(function_name, statement.Body.front(), indexed_function);
+            }
+            if (statement.Condition && !condition_after_body)
+            {
+                AddExpression(function_name, *statement.Condition, indexed_function);
+            }
+            if (statement.Step)
+            {
+                AddExpression(function_name, *statement.Step, indexed_function);
+            }
+            for (std::size_t body_index = (has_initializer ? 1 : 0); body_index < statement.Body.size(); ++body_index)
+            {
+                AddStatement(function_name, statement.Body[body_index], indexed_function);
+            }
+            if (statement.Condition && condition_after_body)
+            {
+                AddExpression(function_name, *statement.Condition, indexed_function);
+            }
+        }
+
+        /// Adds an expression and its operands to the indices.
+        /// @param[in] function_name - The name of the function containing the expression.
+        /// @param[in] expression - The expression.
+        /// @param[in,out] indexed_function - The keys the function was added under.
+        void AddExpression(const std::string& function_name, const Expression& expression, IndexedFunction& indexed_function)
+        {
+            if (ExpressionKind::CALL == expression.Kind)
+            {
+                CallsByCalleeName[expression.Text][function_name].push_back(&expression);
+                indexed_function.CalleeNames.insert(expression.Text);
+            }
+            else if (ExpressionKind::IDENTIFIER == expression.Kind)
+            {
+                ReferencesByName[expression.Text][function_name].push_back(&expression);
+                indexed_function.ReferencedNames.insert(expression.Text);
+            }
+
+            for (const Expression& operand : expression.Operands)
+            {
+                AddExpression(function_name, operand, indexed_function);
+            }
+        }
+
+        /// The names of functions by return type.
+        std::unordered_map<std::string, std::set<std::string>> FunctionNamesByReturnType = {};
+        /// The names of functions by the types of their parameters.
+        std::unordered_map<std::string, std::set<std::string>> FunctionNamesByParameterType = {};
+        /// Call expressions by the name of the function called.
+        std::unordered_map<std::string, ExpressionsByFunction> CallsByCalleeName = {};
+        /// Identifier expressions by name.
+        std::unordered_map<std::string, ExpressionsByFunction> ReferencesByName = {};
+        /// Parameter and local variable declarations by type.
+        std::unordered_map<std::string, DeclarationsByFunction> DeclarationsByType = {};
+        /// The keys each indexed function was added under, by function name.
+        std::unordered_map<std::string, IndexedFunction> IndexedFunctionsByName = {};
+    };
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Metaprogramming/ProgramIndex.h"
+
+namespace METAPROGRAMMING
+{
+    /// The kinds of queries that can be answered from a program index.
+    enum class ProgramQueryKind
+    {
+        INVALID = 0,
+        /// Functions declared or defined with a return type.
+        FUNCTIONS_RETURNING,
+        /// Functions declared or defined with any parameter of a type.
+        FUNCTIONS_WITH_PARAMETER_TYPE,
+        /// Calls to a function.
+        CALLS,
+        /// Uses of a name other than calls.
+        REFERENCES,
+        /// Parameter and local variable declarations of a type.
+        DECLARATIONS,
+    };
+
+    /// A query about a program, written as <kind>:<name> (such as "calls:printf"),
+    /// answered from a program index.
+    struct ProgramQuery
+    {
+        /// Parses a query.
+        /// @param[in] query_text - The text of the query.  The kind is one of returning,
+        ///     parameter, calls, references, or declarations.
+        /// @return The query, if valid; null otherwise.
+        static std::optional<ProgramQuery> Parse(const std::string_view query_text)
+        {
+            std::size_t separator_index = query_text.find(':');
+            if (std::string_view::npos == separator_index || separator_index + 1 == query_text.length())
+            {
+                return std::nullopt;
+            }
+
+            std::string_view kind_text = query_text.substr(0, separator_index);
+            ProgramQueryKind kind = ProgramQueryKind::INVALID;
+            if ("returning" == kind_text) kind = ProgramQueryKind::FUNCTIONS_RETURNING;
+            else if ("parameter" == kind_text) kind = ProgramQueryKind::FUNCTIONS_WITH_PARAMETER_TYPE;
+            else if ("calls" == kind_text) kind = ProgramQueryKind::CALLS;
+            else if ("references" == kind_text) kind = ProgramQueryKind::REFERENCES;
+            else if ("declarations" == kind_text) kind = ProgramQueryKind::DECLARATIONS;
+            else return std::nullopt;
+
+            ProgramQuery query =
+            {
+                .Kind = kind,
+                .Name = std::string(query_text.substr(separator_index + 1)),
+            };
+            return query;
+        }
+
+        /// Answers the query.
+        /// @param[in] index - The index of the program to query.
+        /// @return Text describing the results, indented for a translation unit's report.
+        std::string Run(const ProgramIndex& index) const
+        {
+            std::string results;
+            switch (Kind)
+            {
+                case ProgramQueryKind::FUNCTIONS_RETURNING:
+                    results = "    Functions returning " + Name + ":\n";
+                    WriteFunctionNames(index.FindFunctionsReturning(Name), results);
+                    break;
+                case ProgramQueryKind::FUNCTIONS_WITH_PARAMETER_TYPE:
+                    results = "    Functions with a parameter of type " + Name + ":\n";
+                    WriteFunctionNames(index.FindFunctionsWithParameterType(Name), results);
+                    break;
+                case ProgramQueryKind::CALLS:
+                    results = "    Calls to " + Name + ":\n";
+                    WriteExpressions(index.FindCallsTo(Name), results);
+                    break;
+                case ProgramQueryKind::REFERENCES:
+                    results = "    References to " + Name + ":\n";
+                    WriteExpressions(index.FindReferencesTo(Name), results);
+                    break;
+                case ProgramQueryKind::DECLARATIONS:
+                {
+                    results = "    Declarations of type " + Name + ":\n";
+                    const DeclarationsByFunction& declarations_by_function = index.FindDeclarationsOfType(Name);
+                    for (const auto& [function_name, declarations] : declarations_by_function)
+                    {
+                        for (const VariableDeclaration* declaration : declarations)
+                        {
+                            results += "        " + declaration->Name + " in " + function_name + "\n";
+                        }
+                    }
+                    if (declarations_by_function.empty())
+                    {
+                        results += "        (none)\n";
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            return results;
+        }
+
+        /// The kind of query.
+        ProgramQueryKind Kind = ProgramQueryKind::INVALID;
+        /// The type or name being queried for.
+        std::string Name = "";
+
+    private:
+        /// Writes the names of functions found by a query.
+        /// @param[in] function_names - The names of the functions.
+        /// @param[in,out] results - The results to add to.
+        static void WriteFunctionNames(const std::set<std::string>& function_names, std::string& results)
+        {
+            for (const std::string& function_name : function_names)
+            {
+                results += "        " + function_name + "\n";
+            }
+            if (function_names.empty())
+            {
+                results += "        (none)\n";
+            }
+        }
+
+        /// Writes the locations of expressions found by a query.
+        /// @param[in] expressions_by_function - The expressions.
+        /// @param[in,out] results - The results to add to.
+        static void WriteExpressions(const ExpressionsByFunction& expressions_by_function, std::string& results)
+        {
+            for (const auto& [function_name, expressions] : expressions_by_function)
+            {
+                for (const Expression* expression : expressions)
+                {
+                    results += "        " + function_name + " (line " + std::to_string(expression->LineNumber) + ")\n";
+                }
+            }
+            if (expressions_by_function.empty())
+            {
+                results += "        (none)\n";
+            }
+        }
+    };
+}
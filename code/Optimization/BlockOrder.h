@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+
+namespace OPTIMIZATION
+{
+    /// Orders for visiting a function's blocks.
+    struct BlockOrder
+    {
+        /// Gets the blocks reachable from the entry block in reverse postorder,
+        /// where each block comes before its successors except along loop back edges.
+        /// This puts every block after the blocks that dominate it, so visiting blocks
+        /// in this order sees each value's definition before any use outside a phi.
+        /// @param[in] function - The function.
+        /// @return The reachable blocks in reverse postorder, starting with the entry block.
+        static std::vector<INTERMEDIATE_REPRESENTATION::BlockId> GetReversePostorder(const INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // SEARCH DEPTH-FIRST FROM THE ENTRY BLOCK.
+            // Each stack entry is a block and the index of its next successor to visit.
+            std::vector<BlockId> postorder;
+            postorder.reserve(function.Blocks.size());
+            std::vector<bool> visited_blocks(function.Blocks.size(), false);
+            std::vector<std::pair<BlockId, std::size_t>> search_stack = { { Function::ENTRY_BLOCK_ID, 0 } };
+            visited_blocks[Function::ENTRY_BLOCK_ID] = true;
+            while (!search_stack.empty())
+            {
+                auto& [block_id, next_successor_index] = search_stack.back();
+                const std::vector<BlockId>& successors = function.Blocks[block_id].Successors;
+                if (next_successor_index < successors.size())
+                {
+                    BlockId successor = successors[next_successor_index];
+                    ++next_successor_index;
+                    if (!visited_blocks[successor])
+                    {
+                        visited_blocks[successor] = true;
+                        search_stack.emplace_back(successor, 0);
+                    }
+                    continue;
+                }
+
+                postorder.push_back(block_id);
+                search_stack.pop_back();
+            }
+
+            return std::vector<BlockId>(postorder.rbegin(), postorder.rend());
+        }
+    };
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+
+namespace OPTIMIZATION
+{
+    /// Which functions in a module call which others.
+    ///
+    /// Module functions are those defined in the program's FunctionsByName,
+    /// so calls to functions only declared (like library functions) have no
+    /// node here.  Functions are identified by their index in the module.
+    struct CallGraph
+    {
+        /// Builds the call graph for a module.
+        /// @param[in] module - The module.
+        /// @return The call graph.
+        static CallGraph Build(const INTERMEDIATE_REPRESENTATION::Module& module)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            CallGraph call_graph;
+            for (std::size_t function_index = 0; function_index < module.Functions.size(); ++function_index)
+            {
+                call_graph.FunctionIndicesByName.emplace(module.Functions[function_index].Name, function_index);
+            }
+
+            // FIND THE FUNCTIONS CALLED BY EACH FUNCTION.
+            // Callee names are unique within a function, so each callee is listed once.
+            call_graph.CalleesByFunction.resize(module.Functions.size());
+            for (std::size_t function_index = 0; function_index < module.Functions.size(); ++function_index)
+            {
+                for (const std::string& callee_name : module.Functions[function_index].CalleeNames)
+                {
+                    auto callee = call_graph.FunctionIndicesByName.find(callee_name);
+                    if (call_graph.FunctionIndicesByName.end() != callee)
+                    {
+                        call_graph.CalleesByFunction[function_index].push_back(callee->second);
+                    }
+                }
+            }
+
+            call_graph.FindStronglyConnectedComponents();
+            return call_graph;
+        }
+
+        /// Determines if a call from one function to another may be part of recursion.
+        /// @param[in] caller_index - The index of the calling function.
+        /// @param[in] callee_index - The index of the called function.
+        /// @return True if the callee can (directly or indirectly) call the caller; false otherwise.
+        bool IsRecursive(const std::size_t caller_index, const std::size_t callee_index) const
+        {
+            return ComponentIndicesByFunction[caller_index] == ComponentIndicesByFunction[callee_index];
+        }
+
+        /// Function indices by name.
+        std::unordered_map<std::string, std::size_t> FunctionIndicesByName = {};
+        /// The indices of functions called by each function.
+        std::vector<std::vector<std::size_t>> CalleesByFunction = {};
+        /// Groups of mutually recursive functions (each function alone if it isn't recursive),
+        /// ordered bottom-up so that each group comes after every group it calls into.
+        std::vector<std::vector<std::size_t>> StronglyConnectedComponents = {};
+        /// The index of each function's group in the strongly connected components.
+        std::vector<std::size_t> ComponentIndicesByFunction = {};
+
+    private:
+        /// Marks functions not yet visited by the component search.
+        static constexpr std::uint32_t UNVISITED = UINT32_MAX;
+
+        /// Search state for a function in Tarjan's algorithm.
+        struct SearchNode
+        {
+            /// The order in which the function was first visited.
+            std::uint32_t VisitIndex = UNVISITED;
+            /// The lowest visit index reachable through functions still on the stack.
+            std::uint32_t LowestReachableIndex = UNVISITED;
+            /// True while the function is on the stack of functions without a component.
+            bool OnStack = false;
+            /// The next of the function's callees to visit.
+            std::size_t NextCalleeIndex = 0;
+        };
+
+        /// Finds strongly connected components with Tarjan's algorithm, which completes
+        /// components in reverse topological order, which is already bottom-up.
+        /// An explicit stack is used so that long call chains can't overflow the native stack.
+        void FindStronglyConnectedComponents()
+        {
+            std::size_t function_count = CalleesByFunction.size();
+            std::vector<SearchNode> nodes(function_count);
+            std::vector<std::size_t> component_stack;
+            std::vector<std::size_t> search_path;
+            std::uint32_t next_visit_index = 0;
+            ComponentIndicesByFunction.assign(function_count, 0);
+
+            for (std::size_t root_index = 0; root_index < function_count; ++root_index)
+            {
+                if (UNVISITED != nodes[root_index].VisitIndex)
+                {
+                    continue;
+                }
+
+                // VISIT THE ROOT.
+                auto visit = [&](const std::size_t function_index)
+                {
+                    nodes[function_index].VisitIndex = next_visit_index;
+                    nodes[function_index].LowestReachableIndex = next_visit_index;
+                    nodes[function_index].OnStack = true;
+                    ++next_visit_index;
+                    component_stack.push_back(function_index);
+                    search_path.push_back(function_index);
+                };
+                visit(root_index);
+
+                while (!search_path.empty())
+                {
+                    // CONTINUE WITH THE NEXT CALLEE OF THE CURRENT FUNCTION.
+                    std::size_t function_index = search_path.back();
+                    SearchNode& node = nodes[function_index];
+                    const std::vector<std::size_t>& callees = CalleesByFunction[function_index];
+                    if (node.NextCalleeIndex < callees.size())
+                    {
+                        std::size_t callee_index = callees[node.NextCalleeIndex];
+                        ++node.NextCalleeIndex;
+                        if (UNVISITED == nodes[callee_index].VisitIndex)
+                        {
+                            visit(callee_index);
+                        }
+                        else if (nodes[callee_index].OnStack)
+                        {
+                            node.LowestReachableIndex = std::min(node.LowestReachableIndex, nodes[callee_index].VisitIndex);
+                        }
+                        continue;
+                    }
+
+                    // FINISH THE FUNCTION.
+                    search_path.pop_back();
+                    if (!search_path.empty())
+                    {
+                        SearchNode& caller_node = nodes[search_path.back()];
+                        caller_node.LowestReachableIndex = std::min(caller_node.LowestReachableIndex, node.LowestReachableIndex);
+                    }
+
+                    // FORM A COMPONENT IF THE FUNCTION IS ITS ROOT.
+                    bool is_component_root = (node.LowestReachableIndex == node.VisitIndex);
+                    if (is_component_root)
+                    {
+                        std::size_t component_index = StronglyConnectedComponents.size();
+                        std::vector<std::size_t>& component = StronglyConnectedComponents.emplace_back();
+                        std::size_t member_index = 0;
+                        do
+                        {
+                            member_index = component_stack.back();
+                            component_stack.pop_back();
+                            nodes[member_index].OnStack = false;
+                            ComponentIndicesByFunction[member_index] = component_index;
+                            component.push_back(member_index);
+                        } while (member_index != function_index);
+
+                        // Members are kept in module order so results don't depend on the search.
+                        std::sort(component.begin(), component.end());
+                    }
+                }
+            }
+        }
+    };
+}
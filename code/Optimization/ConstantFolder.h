@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include "IntermediateRepresentation/Function.h"
+
+namespace OPTIMIZATION
+{
+    /// Evaluates instructions whose operands are all constants.
+    ///
+    /// This covers the IR for every arithmetic, bitwise, shift, and comparison
+    /// operator the tokenizer recognizes, along with the conversions between
+    /// integer sizes that lowering inserts around them.  Logical operators
+    /// become branches, so they're folded by constant propagation instead.
+    ///
+    /// Operations with undefined behavior in C (division by zero, signed
+    /// division overflow, and out-of-range shifts) are left unfolded so
+    /// the program behaves the same with or without optimization.
+    struct ConstantFolder
+    {
+        /// Folds an instruction with constant operands.
+        /// @param[in] kind - The kind of instruction.
+        /// @param[in] result_type - The type of the instruction's value.
+        /// @param[in] operand_type - The type of the first operand.
+        /// @param[in] operands - The values of the operands, normalized for their types.
+        /// @return The normalized value of the instruction, if it could be folded; null otherwise.
+        static std::optional<std::int64_t> Fold(
+            const INTERMEDIATE_REPRESENTATION::InstructionKind kind,
+            const INTERMEDIATE_REPRESENTATION::ValueType result_type,
+            const INTERMEDIATE_REPRESENTATION::ValueType operand_type,
+            const std::span<const std::int64_t> operands)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // Pointer values other than null aren't known until code is generated.
+            bool is_pointer_arithmetic = (ValueType::PTR == result_type && !IsComparison(kind));
+            if (is_pointer_arithmetic)
+            {
+                return std::nullopt;
+            }
+
+            // FOLD UNARY OPERATIONS.
+            std::int64_t left = operands.empty() ? 0 : operands[0];
+            std::uint64_t unsigned_left = ZeroExtend(left, operand_type);
+            switch (kind)
+            {
+                case InstructionKind::NEGATE:
+                    return Function::NormalizeConstant(result_type, static_cast<std::int64_t>(0 - unsigned_left));
+                case InstructionKind::NOT:
+                    return Function::NormalizeConstant(result_type, ~left);
+                case InstructionKind::SIGN_EXTEND:
+                    return left;
+                case InstructionKind::ZERO_EXTEND:
+                    return Function::NormalizeConstant(result_type, static_cast<std::int64_t>(unsigned_left));
+                case InstructionKind::TRUNCATE:
+                    return Function::NormalizeConstant(result_type, left);
+                default:
+                    break;
+            }
+            if (operands.size() < 2)
+            {
+                return std::nullopt;
+            }
+
+            // FOLD BINARY OPERATIONS.
+            // Wrapping arithmetic is done on unsigned values to avoid signed overflow in the compiler itself.
+            std::int64_t right = operands[1];
+            std::uint64_t unsigned_right = ZeroExtend(right, operand_type);
+            std::int64_t bit_count = static_cast<std::int64_t>(8 * GetValueTypeSizeInBytes(operand_type));
+            std::int64_t minimum_signed_value = (64 == bit_count) ? INT64_MIN : -(std::int64_t(1) << (bit_count - 1));
+            bool divides_by_zero = (0 == right);
+            bool signed_division_overflows = (minimum_signed_value == left && -1 == right);
+            bool shift_out_of_range = (right < 0 || right >= bit_count);
+            std::uint64_t result = 0;
+            switch (kind)
+            {
+                case InstructionKind::ADD:
+                    result = static_cast<std::uint64_t>(left) + static_cast<std::uint64_t>(right);
+                    break;
+                case InstructionKind::SUBTRACT:
+                    result = static_cast<std::uint64_t>(left) - static_cast<std::uint64_t>(right);
+                    break;
+                case InstructionKind::MULTIPLY:
+                    result = static_cast<std::uint64_t>(left) * static_cast<std::uint64_t>(right);
+                    break;
+                case InstructionKind::SIGNED_DIVIDE:
+                    if (divides_by_zero || signed_division_overflows) return std::nullopt;
+                    result = static_cast<std::uint64_t>(left / right);
+                    break;
+                case InstructionKind::SIGNED_REMAINDER:
+                    if (divides_by_zero || signed_division_overflows) return std::nullopt;
+                    result = static_cast<std::uint64_t>(left % right);
+                    break;
+                case InstructionKind::UNSIGNED_DIVIDE:
+                    if (divides_by_zero) return std::nullopt;
+                    result = unsigned_left / unsigned_right;
+                    break;
+                case InstructionKind::UNSIGNED_REMAINDER:
+                    if (divides_by_zero) return std::nullopt;
+                    result = unsigned_left % unsigned_right;
+                    break;
+                case InstructionKind::AND:
+                    result = static_cast<std::uint64_t>(left & right);
+                    break;
+                case InstructionKind::OR:
+                    result = static_cast<std::uint64_t>(left | right);
+                    break;
+                case InstructionKind::XOR:
+                    result = static_cast<std::uint64_t>(left ^ right);
+                    break;
+                case InstructionKind::SHIFT_LEFT:
+                    if (shift_out_of_range) return std::nullopt;
+                    result = unsigned_left << right;
+                    break;
+                case InstructionKind::ARITHMETIC_SHIFT_RIGHT:
+                    if (shift_out_of_range) return std::nullopt;
+                    result = static_cast<std::uint64_t>(left >> right);
+                    break;
+                case InstructionKind::LOGICAL_SHIFT_RIGHT:
+                    if (shift_out_of_range) return std::nullopt;
+                    result = unsigned_left >> right;
+                    break;
+                case InstructionKind::EQUAL:
+                    return (left == right) ? 1 : 0;
+                case InstructionKind::NOT_EQUAL:
+                    return (left != right) ? 1 : 0;
+                case InstructionKind::SIGNED_LESS:
+                    return (left < right) ? 1 : 0;
+                case InstructionKind::SIGNED_LESS_EQUAL:
+                    return (left <= right) ? 1 : 0;
+                case InstructionKind::SIGNED_GREATER:
+                    return (left > right) ? 1 : 0;
+                case InstructionKind::SIGNED_GREATER_EQUAL:
+                    return (left >= right) ? 1 : 0;
+                case InstructionKind::UNSIGNED_LESS:
+                    return (unsigned_left < unsigned_right) ? 1 : 0;
+                case InstructionKind::UNSIGNED_LESS_EQUAL:
+                    return (unsigned_left <= unsigned_right) ? 1 : 0;
+                case InstructionKind::UNSIGNED_GREATER:
+                    return (unsigned_left > unsigned_right) ? 1 : 0;
+                case InstructionKind::UNSIGNED_GREATER_EQUAL:
+                    return (unsigned_left >= unsigned_right) ? 1 : 0;
+                default:
+                    return std::nullopt;
+            }
+            return Function::NormalizeConstant(result_type, static_cast<std::int64_t>(result));
+        }
+
+        /// Gets the unsigned interpretation of a normalized constant.
+        /// @param[in] value - The normalized value.
+        /// @param[in] type - The type of the value.
+        /// @return The value with bits above the type's width cleared.
+        static std::uint64_t ZeroExtend(const std::int64_t value, const INTERMEDIATE_REPRESENTATION::ValueType type)
+        {
+            std::size_t bit_count = 8 * INTERMEDIATE_REPRESENTATION::GetValueTypeSizeInBytes(type);
+            if (0 == bit_count || bit_count >= 64)
+            {
+                return static_cast<std::uint64_t>(value);
+            }
+            std::uint64_t mask = (std::uint64_t(1) << bit_count) - 1;
+            return static_cast<std::uint64_t>(value) & mask;
+        }
+    };
+}
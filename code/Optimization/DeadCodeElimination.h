@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+
+namespace OPTIMIZATION
+{
+    /// Removes instructions whose values can't affect the program's behavior.
+    ///
+    /// Rather than repeatedly deleting unused instructions, instructions are
+    /// assumed dead until reached from one with side effects (stores, calls,
+    /// and terminators) through a worklist of operands.  This also removes
+    /// cycles of values that only use each other, like a loop counter that's
+    /// incremented but never read, which use counts alone would keep alive.
+    struct DeadCodeElimination
+    {
+        /// Runs the pass on a function.
+        /// @param[in,out] function - The function to optimize.
+        /// @return The number of instructions removed.
+        static std::size_t Run(INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // MARK INSTRUCTIONS WITH SIDE EFFECTS AS LIVE.
+            std::vector<bool> live_values(function.Values.size(), false);
+            std::vector<ValueId> worklist;
+            for (const BasicBlock& block : function.Blocks)
+            {
+                for (const ValueId instruction_id : block.Instructions)
+                {
+                    if (HasSideEffects(function.Values[instruction_id].Kind))
+                    {
+                        live_values[instruction_id] = true;
+                        worklist.push_back(instruction_id);
+                    }
+                }
+            }
+
+            // MARK EVERYTHING THEY DEPEND ON AS LIVE.
+            while (!worklist.empty())
+            {
+                ValueId instruction_id = worklist.back();
+                worklist.pop_back();
+                for (const ValueId operand : function.GetOperands(instruction_id))
+                {
+                    if (!live_values[operand])
+                    {
+                        live_values[operand] = true;
+                        worklist.push_back(operand);
+                    }
+                }
+            }
+
+            // REMOVE EVERYTHING ELSE.
+            std::size_t removed_instruction_count = 0;
+            for (BasicBlock& block : function.Blocks)
+            {
+                for (const ValueId instruction_id : block.Instructions)
+                {
+                    if (!live_values[instruction_id])
+                    {
+                        function.DeleteInstruction(instruction_id);
+                        ++removed_instruction_count;
+                    }
+                }
+                std::erase_if(block.Instructions, [&](const ValueId instruction_id) { return !live_values[instruction_id]; });
+            }
+            return removed_instruction_count;
+        }
+    };
+}
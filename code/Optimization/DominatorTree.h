@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+#include "Optimization/BlockOrder.h"
+
+namespace OPTIMIZATION
+{
+    /// Which blocks dominate which others: block A dominates block B if every
+    /// path from the entry block to B passes through A.
+    ///
+    /// Immediate dominators are found with the iterative algorithm from
+    /// Cooper, Harvey, and Kennedy's "A Simple, Fast Dominance Algorithm",
+    /// which converges in a couple of passes over reverse postorder for the
+    /// reducible control flow that structured code produces.  The tree is
+    /// then numbered so that dominance queries take constant time.
+    struct DominatorTree
+    {
+        /// Builds the dominator tree for a function.
+        /// @param[in] function - The function.
+        /// @return The dominator tree.
+        static DominatorTree Build(const INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            DominatorTree tree;
+            tree.ReversePostorder = BlockOrder::GetReversePostorder(function);
+            std::size_t block_count = function.Blocks.size();
+            std::vector<std::uint32_t> postorder_indices(block_count, UNREACHABLE);
+            for (std::size_t order_index = 0; order_index < tree.ReversePostorder.size(); ++order_index)
+            {
+                postorder_indices[tree.ReversePostorder[order_index]] = static_cast<std::uint32_t>(tree.ReversePostorder.size() - 1 - order_index);
+            }
+
+            // FIND IMMEDIATE DOMINATORS.
+            // Two dominators are intersected by walking up from whichever is lower in the tree
+            // (earlier in postorder) until both paths meet.
+            tree.ImmediateDominators.assign(block_count, INVALID_ID);
+            tree.ImmediateDominators[Function::ENTRY_BLOCK_ID] = Function::ENTRY_BLOCK_ID;
+            auto intersect = [&](BlockId first_block_id, BlockId second_block_id)
+            {
+                while (first_block_id != second_block_id)
+                {
+                    while (postorder_indices[first_block_id] < postorder_indices[second_block_id])
+                    {
+                        first_block_id = tree.ImmediateDominators[first_block_id];
+                    }
+                    while (postorder_indices[second_block_id] < postorder_indices[first_block_id])
+                    {
+                        second_block_id = tree.ImmediateDominators[second_block_id];
+                    }
+                }
+                return first_block_id;
+            };
+            bool changed = true;
+            while (changed)
+            {
+                changed = false;
+                for (const BlockId block_id : tree.ReversePostorder)
+                {
+                    if (Function::ENTRY_BLOCK_ID == block_id)
+                    {
+                        continue;
+                    }
+
+                    // Only predecessors already processed contribute, which excludes unreachable ones.
+                    BlockId new_immediate_dominator = INVALID_ID;
+                    for (const BlockId predecessor : function.Blocks[block_id].Predecessors)
+                    {
+                        if (INVALID_ID == tree.ImmediateDominators[predecessor])
+                        {
+                            continue;
+                        }
+                        new_immediate_dominator = (INVALID_ID == new_immediate_dominator) ?
+                            predecessor :
+                            intersect(predecessor, new_immediate_dominator);
+                    }
+                    if (tree.ImmediateDominators[block_id] != new_immediate_dominator)
+                    {
+                        tree.ImmediateDominators[block_id] = new_immediate_dominator;
+                        changed = true;
+                    }
+                }
+            }
+            tree.ImmediateDominators[Function::ENTRY_BLOCK_ID] = INVALID_ID;
+
+            // NUMBER THE TREE.
+            // A block dominates exactly the blocks numbered within its subtree's range in preorder.
+            tree.ChildrenByBlock.resize(block_count);
+            for (const BlockId block_id : tree.ReversePostorder)
+            {
+                BlockId immediate_dominator = tree.ImmediateDominators[block_id];
+                if (INVALID_ID != immediate_dominator)
+                {
+                    tree.ChildrenByBlock[immediate_dominator].push_back(block_id);
+                }
+            }
+            tree.PreorderIndices.assign(block_count, UNREACHABLE);
+            tree.SubtreeEndIndices.assign(block_count, UNREACHABLE);
+            std::uint32_t next_preorder_index = 0;
+            std::vector<std::pair<BlockId, std::size_t>> search_stack = { { Function::ENTRY_BLOCK_ID, 0 } };
+            tree.PreorderIndices[Function::ENTRY_BLOCK_ID] = next_preorder_index++;
+            while (!search_stack.empty())
+            {
+                auto& [block_id, next_child_index] = search_stack.back();
+                const std::vector<BlockId>& children = tree.ChildrenByBlock[block_id];
+                if (next_child_index < children.size())
+                {
+                    BlockId child = children[next_child_index];
+                    ++next_child_index;
+                    tree.PreorderIndices[child] = next_preorder_index++;
+                    search_stack.emplace_back(child, 0);
+                    continue;
+                }
+
+                tree.SubtreeEndIndices[block_id] = next_preorder_index;
+                search_stack.pop_back();
+            }
+
+            return tree;
+        }
+
+        /// Determines if a block is reachable from the entry block.
+        /// @param[in] block_id - The block.
+        /// @return True if the block is reachable; false otherwise.
+        bool IsReachable(const INTERMEDIATE_REPRESENTATION::BlockId block_id) const
+        {
+            return UNREACHABLE != PreorderIndices[block_id];
+        }
+
+        /// Determines if one block dominates another.  Blocks dominate themselves.
+        /// @param[in] dominator - The possibly dominating block.
+        /// @param[in] block_id - The possibly dominated block.
+        /// @return True if both blocks are reachable and the first dominates the second; false otherwise.
+        bool Dominates(const INTERMEDIATE_REPRESENTATION::BlockId dominator, const INTERMEDIATE_REPRESENTATION::BlockId block_id) const
+        {
+            if (!IsReachable(dominator) || !IsReachable(block_id))
+            {
+                return false;
+            }
+            return PreorderIndices[dominator] <= PreorderIndices[block_id] && PreorderIndices[block_id] < SubtreeEndIndices[dominator];
+        }
+
+        /// The reachable blocks in reverse postorder, where each block follows its dominators.
+        std::vector<INTERMEDIATE_REPRESENTATION::BlockId> ReversePostorder = {};
+        /// The immediate dominator of each block, or invalid for the entry block and unreachable blocks.
+        std::vector<INTERMEDIATE_REPRESENTATION::BlockId> ImmediateDominators = {};
+        /// The blocks immediately dominated by each block.
+        std::vector<std::vector<INTERMEDIATE_REPRESENTATION::BlockId>> ChildrenByBlock = {};
+
+    private:
+        /// Marks blocks not reachable from the entry block.
+        static constexpr std::uint32_t UNREACHABLE = UINT32_MAX;
+
+        /// The index of each block in a preorder walk of the tree.
+        std::vector<std::uint32_t> PreorderIndices = {};
+        /// The preorder index just past each block's subtree.
+        std::vector<std::uint32_t> SubtreeEndIndices = {};
+    };
+}
@@ -0,0 +1,424 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+#include "Optimization/ConstantFolder.h"
+#include "Optimization/DominatorTree.h"
+#include "Optimization/LoopForest.h"
+
+namespace OPTIMIZATION
+{
+    /// Replaces multiplications of induction variables with additions carried across iterations.
+    ///
+    /// A basic induction variable is a header phi that's incremented by a loop-invariant
+    /// step on each iteration, like the index of a for loop.  Values computed from one
+    /// by adding invariants, multiplying by invariants, shifting by constants, or sign
+    /// extension form recurrences with their own start and step, so rather than computing
+    /// them from the index each iteration, they become phis incremented by their step.
+    /// For array indexing, the element address becomes a pointer advanced by the stride,
+    /// replacing the extension, multiplication, and addition of each iteration.
+    ///
+    /// Sign extensions assume the narrower value doesn't overflow, which C leaves undefined
+    /// for the signed integers they're used for.  Loops need a preheader for the starting
+    /// values and a single latch for the increments, which loop-invariant code motion provides.
+    struct InductionVariableStrengthReduction
+    {
+        /// Runs the pass on a function.
+        /// @param[in,out] function - The function to optimize.
+        /// @return The number of instructions replaced.
+        static std::size_t Run(INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            DominatorTree dominator_tree = DominatorTree::Build(function);
+            LoopForest loop_forest = LoopForest::Find(function, dominator_tree);
+            std::size_t reduced_instruction_count = 0;
+            for (std::size_t loop_index = 0; loop_index < loop_forest.Loops.size(); ++loop_index)
+            {
+                const Loop& loop = loop_forest.Loops[loop_index];
+                bool is_simple_loop = (INVALID_ID != loop.Preheader && 1 == loop.Latches.size());
+                if (!is_simple_loop)
+                {
+                    continue;
+                }
+
+                // FIND CANDIDATES IN THE LOOP'S OWN BLOCKS.
+                // Instructions in nested loops vary with those loops' induction variables instead.
+                // Addresses are reduced before multiplications, since reducing an address often
+                // leaves the multiplication computing its offset unused, needing no phi of its own.
+                std::vector<ValueId> address_candidates;
+                std::vector<ValueId> multiplication_candidates;
+                for (const BlockId block_id : loop.Blocks)
+                {
+                    if (loop_index != loop_forest.InnermostLoopIndicesByBlock[block_id])
+                    {
+                        continue;
+                    }
+                    for (const ValueId instruction_id : function.Blocks[block_id].Instructions)
+                    {
+                        const Instruction& instruction = function.Values[instruction_id];
+                        if (InstructionKind::ADD == instruction.Kind && ValueType::PTR == instruction.Type)
+                        {
+                            address_candidates.push_back(instruction_id);
+                        }
+                        else if (InstructionKind::MULTIPLY == instruction.Kind || InstructionKind::SHIFT_LEFT == instruction.Kind)
+                        {
+                            multiplication_candidates.push_back(instruction_id);
+                        }
+                    }
+                }
+
+                // REPLACE EACH CANDIDATE THAT'S A RECURRENCE.
+                // Replaced values may feed later candidates, which then see the new phi as a basic induction variable.
+                LoopReducer reducer(function, loop);
+                for (const ValueId candidate : address_candidates)
+                {
+                    // Offsetting a pointer by a phi already takes a single addition per iteration.
+                    bool offset_is_phi = (
+                        InstructionKind::PHI == function.Values[function.GetOperand(candidate, 0)].Kind ||
+                        InstructionKind::PHI == function.Values[function.GetOperand(candidate, 1)].Kind);
+                    if (!offset_is_phi && reducer.Reduce(candidate))
+                    {
+                        ++reduced_instruction_count;
+                    }
+                }
+                for (const ValueId candidate : multiplication_candidates)
+                {
+                    bool is_used = (InstructionKind::DELETED != function.Values[candidate].Kind && function.HasUses(candidate));
+                    if (is_used && reducer.Reduce(candidate))
+                    {
+                        ++reduced_instruction_count;
+                    }
+                }
+            }
+            return reduced_instruction_count;
+        }
+
+    private:
+        /// A value that changes by a fixed step on each iteration of a loop.
+        struct Recurrence
+        {
+            /// The value on the first iteration, available in the preheader.
+            INTERMEDIATE_REPRESENTATION::ValueId Start = INTERMEDIATE_REPRESENTATION::INVALID_ID;
+            /// The amount added on each iteration, available in the preheader.  It's an i64 for pointers.
+            INTERMEDIATE_REPRESENTATION::ValueId Step = INTERMEDIATE_REPRESENTATION::INVALID_ID;
+        };
+
+        /// Strength reduces values within a single loop.
+        class LoopReducer
+        {
+        public:
+            /// Prepares to reduce values in a loop.
+            /// @param[in,out] function - The function containing the loop.
+            /// @param[in] loop - The loop, which must have a preheader and a single latch.
+            explicit LoopReducer(INTERMEDIATE_REPRESENTATION::Function& function, const Loop& loop) :
+                Output(function),
+                CurrentLoop(loop)
+            {}
+
+            /// Replaces a value with a phi if it's a recurrence.
+            /// @param[in] value - The value in the loop.
+            /// @return True if the value was replaced; false otherwise.
+            bool Reduce(const INTERMEDIATE_REPRESENTATION::ValueId value)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                std::optional<Recurrence> recurrence = FindRecurrence(value);
+                if (!recurrence)
+                {
+                    return false;
+                }
+
+                // CREATE THE PHI AND ITS INCREMENT.
+                // The increment goes at the end of the latch, which the header dominates.
+                ValueType type = Output.Values[value].Type;
+                BlockId latch = CurrentLoop.Latches.front();
+                ValueId phi = Output.AddPhi(CurrentLoop.Header, type);
+                std::vector<ValueId>& latch_instructions = Output.Blocks[latch].Instructions;
+                ValueId increment = Output.InsertInstruction(
+                    latch,
+                    latch_instructions.size() - 1,
+                    InstructionKind::ADD,
+                    type,
+                    { phi, recurrence->Step });
+                for (const BlockId predecessor : Output.Blocks[CurrentLoop.Header].Predecessors)
+                {
+                    Output.AddOperand(phi, (CurrentLoop.Preheader == predecessor) ? recurrence->Start : increment);
+                }
+
+                // REPLACE THE ORIGINAL VALUE.
+                Output.ReplaceAllUsesWith(value, phi);
+                Output.RemoveInstruction(value);
+                return true;
+            }
+
+        private:
+            /// Finds the recurrence a value follows in the loop, if any.
+            /// @param[in] value - The value.
+            /// @return The value's start and step, if it's a recurrence; null otherwise.
+            std::optional<Recurrence> FindRecurrence(const INTERMEDIATE_REPRESENTATION::ValueId value)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                auto existing_recurrence = RecurrencesByValue.find(value);
+                if (RecurrencesByValue.end() != existing_recurrence)
+                {
+                    return existing_recurrence->second;
+                }
+                std::optional<Recurrence> recurrence = CalculateRecurrence(value);
+                RecurrencesByValue.emplace(value, recurrence);
+                return recurrence;
+            }
+
+            /// Calculates the recurrence a value follows in the loop, if any.
+            /// @param[in] value - The value.
+            /// @return The value's start and step, if it's a recurrence; null otherwise.
+            std::optional<Recurrence> CalculateRecurrence(const INTERMEDIATE_REPRESENTATION::ValueId value)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                const Instruction& instruction = Output.Values[value];
+                if (CurrentLoop.IsInvariant(Output, value))
+                {
+                    return std::nullopt;
+                }
+                ValueType type = instruction.Type;
+                switch (instruction.Kind)
+                {
+                    case InstructionKind::PHI:
+                        return FindBasicInductionVariable(value);
+                    case InstructionKind::ADD:
+                    {
+                        ValueId left = Output.GetOperand(value, 0);
+                        ValueId right = Output.GetOperand(value, 1);
+                        if (ValueType::PTR == type)
+                        {
+                            // Either the base pointer or the offset may vary, but not both.
+                            if (CurrentLoop.IsInvariant(Output, left))
+                            {
+                                std::optional<Recurrence> offset = FindRecurrence(right);
+                                if (!offset) return std::nullopt;
+                                return Recurrence { .Start = EmitInPreheader(InstructionKind::ADD, type, left, offset->Start), .Step = offset->Step };
+                            }
+                            if (CurrentLoop.IsInvariant(Output, right))
+                            {
+                                std::optional<Recurrence> base = FindRecurrence(left);
+                                if (!base) return std::nullopt;
+                                return Recurrence { .Start = EmitInPreheader(InstructionKind::ADD, type, base->Start, right), .Step = base->Step };
+                            }
+                            return std::nullopt;
+                        }
+                        return CombineWithInvariant(InstructionKind::ADD, type, left, right, true);
+                    }
+                    case InstructionKind::SUBTRACT:
+                    {
+                        // Only invariants subtracted from a recurrence keep its step.
+                        ValueId left = Output.GetOperand(value, 0);
+                        ValueId right = Output.GetOperand(value, 1);
+                        if (ValueType::PTR == type || ValueType::PTR == Output.Values[left].Type || !CurrentLoop.IsInvariant(Output, right))
+                        {
+                            return std::nullopt;
+                        }
+                        std::optional<Recurrence> minuend = FindRecurrence(left);
+                        if (!minuend) return std::nullopt;
+                        return Recurrence { .Start = EmitInPreheader(InstructionKind::SUBTRACT, type, minuend->Start, right), .Step = minuend->Step };
+                    }
+                    case InstructionKind::MULTIPLY:
+                        return CombineWithInvariant(InstructionKind::MULTIPLY, type, Output.GetOperand(value, 0), Output.GetOperand(value, 1), false);
+                    case InstructionKind::SHIFT_LEFT:
+                    {
+                        // Shifting by a variable amount isn't linear, but by a constant it's multiplication.
+                        ValueId shift = Output.GetOperand(value, 1);
+                        if (!Output.IsConstant(shift))
+                        {
+                            return std::nullopt;
+                        }
+                        std::optional<Recurrence> shifted = FindRecurrence(Output.GetOperand(value, 0));
+                        if (!shifted) return std::nullopt;
+                        return Recurrence
+                        {
+                            .Start = EmitInPreheader(InstructionKind::SHIFT_LEFT, type, shifted->Start, shift),
+                            .Step = EmitInPreheader(InstructionKind::SHIFT_LEFT, type, shifted->Step, shift),
+                        };
+                    }
+                    case InstructionKind::SIGN_EXTEND:
+                    {
+                        std::optional<Recurrence> extended = FindRecurrence(Output.GetOperand(value, 0));
+                        if (!extended) return std::nullopt;
+                        return Recurrence
+                        {
+                            .Start = EmitInPreheader(InstructionKind::SIGN_EXTEND, type, extended->Start),
+                            .Step = EmitInPreheader(InstructionKind::SIGN_EXTEND, type, extended->Step),
+                        };
+                    }
+                    default:
+                        return std::nullopt;
+                }
+            }
+
+            /// Finds the recurrence of a header phi incremented by an invariant step.
+            /// @param[in] phi - The phi.
+            /// @return The phi's start and step, if it's a basic induction variable; null otherwise.
+            std::optional<Recurrence> FindBasicInductionVariable(const INTERMEDIATE_REPRESENTATION::ValueId phi)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                // FIND THE VALUES FROM BEFORE THE LOOP AND FROM THE PREVIOUS ITERATION.
+                const BasicBlock& header = Output.Blocks[CurrentLoop.Header];
+                bool is_header_phi = (CurrentLoop.Header == Output.Values[phi].Block && 2 == header.Predecessors.size());
+                if (!is_header_phi)
+                {
+                    return std::nullopt;
+                }
+                std::size_t preheader_operand_index = (CurrentLoop.Preheader == header.Predecessors[0]) ? 0 : 1;
+                ValueId start = Output.GetOperand(phi, preheader_operand_index);
+                ValueId next = Output.GetOperand(phi, 1 - preheader_operand_index);
+                if (!CurrentLoop.IsInvariant(Output, start))
+                {
+                    return std::nullopt;
+                }
+
+                // CHECK THAT THE NEXT VALUE IS AN INVARIANT STEP FROM THE PHI.
+                const Instruction& next_instruction = Output.Values[next];
+                bool is_step = (
+                    (InstructionKind::ADD == next_instruction.Kind || InstructionKind::SUBTRACT == next_instruction.Kind) &&
+                    !CurrentLoop.IsInvariant(Output, next));
+                if (!is_step)
+                {
+                    return std::nullopt;
+                }
+                ValueId left = Output.GetOperand(next, 0);
+                ValueId right = Output.GetOperand(next, 1);
+                ValueType type = Output.Values[phi].Type;
+                if (InstructionKind::ADD == next_instruction.Kind)
+                {
+                    if (phi == left && CurrentLoop.IsInvariant(Output, right))
+                    {
+                        return Recurrence { .Start = start, .Step = right };
+                    }
+                    if (phi == right && CurrentLoop.IsInvariant(Output, left) && ValueType::PTR != type)
+                    {
+                        return Recurrence { .Start = start, .Step = left };
+                    }
+                    return std::nullopt;
+                }
+                bool is_decrement = (phi == left && Output.IsConstant(right) && ValueType::PTR != type);
+                if (!is_decrement)
+                {
+                    return std::nullopt;
+                }
+                return Recurrence { .Start = start, .Step = EmitInPreheader(InstructionKind::NEGATE, type, right) };
+            }
+
+            /// Combines a recurrence with an invariant operand.
+            /// @param[in] kind - The kind of operation (add or multiply).
+            /// @param[in] type - The type of the result.
+            /// @param[in] left - The left operand.
+            /// @param[in] right - The right operand.
+            /// @param[in] keeps_step - True if the operation leaves the step unchanged (addition);
+            ///     false if it applies to the step too (multiplication).
+            /// @return The result's recurrence, if one operand is a recurrence and the other invariant; null otherwise.
+            std::optional<Recurrence> CombineWithInvariant(
+                const INTERMEDIATE_REPRESENTATION::InstructionKind kind,
+                const INTERMEDIATE_REPRESENTATION::ValueType type,
+                INTERMEDIATE_REPRESENTATION::ValueId left,
+                INTERMEDIATE_REPRESENTATION::ValueId right,
+                const bool keeps_step)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                // Both operations are commutative, so the invariant is moved to the right.
+                if (CurrentLoop.IsInvariant(Output, left))
+                {
+                    std::swap(left, right);
+                }
+                if (!CurrentLoop.IsInvariant(Output, right))
+                {
+                    return std::nullopt;
+                }
+                std::optional<Recurrence> varying = FindRecurrence(left);
+                if (!varying)
+                {
+                    return std::nullopt;
+                }
+                return Recurrence
+                {
+                    .Start = EmitInPreheader(kind, type, varying->Start, right),
+                    .Step = keeps_step ? varying->Step : EmitInPreheader(kind, type, varying->Step, right),
+                };
+            }
+
+            /// Computes a value at the end of the preheader, folding it if its operands are constants.
+            /// @param[in] kind - The kind of instruction.
+            /// @param[in] type - The type of the result.
+            /// @param[in] left - The first operand.
+            /// @param[in] right - Any second operand.
+            /// @return The computed value.
+            INTERMEDIATE_REPRESENTATION::ValueId EmitInPreheader(
+                const INTERMEDIATE_REPRESENTATION::InstructionKind kind,
+                const INTERMEDIATE_REPRESENTATION::ValueType type,
+                const INTERMEDIATE_REPRESENTATION::ValueId left,
+                const INTERMEDIATE_REPRESENTATION::ValueId right = INTERMEDIATE_REPRESENTATION::INVALID_ID)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                // FOLD CONSTANT OPERANDS.
+                bool is_unary = (INVALID_ID == right);
+                bool operands_constant = Output.IsConstant(left) && (is_unary || Output.IsConstant(right));
+                if (operands_constant)
+                {
+                    std::array<std::int64_t, 2> operand_values = { Output.Values[left].Immediate, is_unary ? 0 : Output.Values[right].Immediate };
+                    std::span<const std::int64_t> operands(operand_values.data(), is_unary ? 1 : 2);
+                    std::optional<std::int64_t> folded_value = ConstantFolder::Fold(kind, type, Output.Values[left].Type, operands);
+                    if (folded_value)
+                    {
+                        return Output.GetConstant(type, *folded_value);
+                    }
+                }
+
+                // SIMPLIFY OPERATIONS WITH IDENTITIES.
+                // Starting values are often zero and steps one, which makes many of these trivial.
+                auto is_constant = [&](const ValueId value, const std::int64_t constant_value)
+                {
+                    return INVALID_ID != value && Output.IsConstant(value) && constant_value == Output.Values[value].Immediate;
+                };
+                bool is_commutative = (InstructionKind::ADD == kind || InstructionKind::MULTIPLY == kind);
+                if (is_commutative && (is_constant(left, 0) || is_constant(left, 1)) && ValueType::PTR != Output.Values[left].Type)
+                {
+                    return EmitInPreheader(kind, type, right, left);
+                }
+                bool is_identity = (
+                    ((InstructionKind::ADD == kind || InstructionKind::SUBTRACT == kind || InstructionKind::SHIFT_LEFT == kind) && is_constant(right, 0)) ||
+                    (InstructionKind::MULTIPLY == kind && is_constant(right, 1)));
+                if (is_identity)
+                {
+                    return left;
+                }
+                if (InstructionKind::MULTIPLY == kind && is_constant(right, 0))
+                {
+                    return right;
+                }
+
+                // ADD AN INSTRUCTION BEFORE THE PREHEADER'S TERMINATOR.
+                std::size_t position = Output.Blocks[CurrentLoop.Preheader].Instructions.size() - 1;
+                if (is_unary)
+                {
+                    return Output.InsertInstruction(CurrentLoop.Preheader, position, kind, type, { left });
+                }
+                return Output.InsertInstruction(CurrentLoop.Preheader, position, kind, type, { left, right });
+            }
+
+            /// The function being optimized.
+            INTERMEDIATE_REPRESENTATION::Function& Output;
+            /// The loop being optimized.
+            const Loop& CurrentLoop;
+            /// Recurrences already found (or not) for values in the loop.
+            std::unordered_map<INTERMEDIATE_REPRESENTATION::ValueId, std::optional<Recurrence>> RecurrencesByValue = {};
+        };
+    };
+}
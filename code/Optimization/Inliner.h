@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+#include "Optimization/BlockOrder.h"
+#include "Optimization/CallGraph.h"
+#include "Optimization/InliningCostModel.h"
+
+namespace OPTIMIZATION
+{
+    /// Replaces calls to functions in the same module with copies of their bodies.
+    ///
+    /// Functions should be inlined into bottom-up over the call graph's strongly
+    /// connected components, so each callee has already had its own calls inlined
+    /// and been optimized, making its size an accurate cost.  Calls within a
+    /// component may be recursive and are never inlined.
+    struct Inliner
+    {
+        /// Runs the pass on a function.
+        /// @param[in,out] module - The module containing the function and its callees.
+        /// @param[in] call_graph - The call graph of the module.
+        /// @param[in] function_index - The index of the function to inline calls into.
+        /// @param[in] cost_model - Decides which calls to inline.
+        /// @return The number of calls inlined.
+        static std::size_t Run(
+            INTERMEDIATE_REPRESENTATION::Module& module,
+            const CallGraph& call_graph,
+            const std::size_t function_index,
+            const InliningCostModel& cost_model)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // FIND CALLS TO OTHER FUNCTIONS IN THE MODULE.
+            // They're found up front since inlined code is added to the function as it's inlined.
+            Function& caller = module.Functions[function_index];
+            std::vector<std::pair<ValueId, std::size_t>> candidate_calls;
+            for (const BasicBlock& block : caller.Blocks)
+            {
+                for (const ValueId instruction_id : block.Instructions)
+                {
+                    const Instruction& instruction = caller.Values[instruction_id];
+                    if (InstructionKind::CALL != instruction.Kind)
+                    {
+                        continue;
+                    }
+                    const std::string& callee_name = caller.CalleeNames[static_cast<std::size_t>(instruction.Immediate)];
+                    auto callee = call_graph.FunctionIndicesByName.find(callee_name);
+                    bool is_candidate = (call_graph.FunctionIndicesByName.end() != callee && !call_graph.IsRecursive(function_index, callee->second));
+                    if (is_candidate)
+                    {
+                        candidate_calls.emplace_back(instruction_id, callee->second);
+                    }
+                }
+            }
+
+            // INLINE THE CALLS WORTH INLINING.
+            std::size_t caller_instruction_count = InliningCostModel::GetInstructionCount(caller);
+            std::size_t inlined_call_count = 0;
+            for (const auto& [call, callee_index] : candidate_calls)
+            {
+                const Function& callee = module.Functions[callee_index];
+                bool should_inline = CanInline(caller, call, callee) && cost_model.ShouldInline(caller, caller_instruction_count, call, callee);
+                if (!should_inline)
+                {
+                    continue;
+                }
+
+                InlineCall(caller, call, callee);
+                caller_instruction_count += InliningCostModel::GetInstructionCount(callee);
+                ++inlined_call_count;
+            }
+            return inlined_call_count;
+        }
+
+    private:
+        /// Determines if a call can be inlined at all.
+        /// @param[in] caller - The function containing the call.
+        /// @param[in] call - The call.
+        /// @param[in] callee - The function called.
+        /// @return True if the call matches the callee's signature and the callee has no variable arguments; false otherwise.
+        static bool CanInline(
+            const INTERMEDIATE_REPRESENTATION::Function& caller,
+            const INTERMEDIATE_REPRESENTATION::ValueId call,
+            const INTERMEDIATE_REPRESENTATION::Function& callee)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            if (callee.IsVariadic || callee.Blocks.empty())
+            {
+                return false;
+            }
+
+            const Instruction& call_instruction = caller.Values[call];
+            bool return_type_matches = (ValueType::VOID == call_instruction.Type || call_instruction.Type == callee.ReturnType);
+            if (!return_type_matches || call_instruction.OperandCount != callee.ParameterTypes.size())
+            {
+                return false;
+            }
+            for (std::size_t argument_index = 0; argument_index < callee.ParameterTypes.size(); ++argument_index)
+            {
+                ValueId argument = caller.GetOperand(call, argument_index);
+                if (caller.Values[argument].Type != callee.ParameterTypes[argument_index])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Replaces a call with a copy of the callee's body.
+        ///
+        /// The block containing the call is split after it.  The callee's entry block
+        /// is copied into the end of the first half, and its returns jump to the second
+        /// half, with a phi merging the returned values if there's more than one return.
+        /// With a single return, the second half is appended to the returning block instead.
+        /// @param[in,out] caller - The function containing the call.
+        /// @param[in] call - The call.
+        /// @param[in] callee - The function called.
+        static void InlineCall(
+            INTERMEDIATE_REPRESENTATION::Function& caller,
+            const INTERMEDIATE_REPRESENTATION::ValueId call,
+            const INTERMEDIATE_REPRESENTATION::Function& callee)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // SPLIT OFF THE CODE AFTER THE CALL.
+            BlockId call_block_id = caller.Values[call].Block;
+            std::vector<ValueId> following_instructions;
+            std::vector<BlockId> following_successors;
+            {
+                BasicBlock& call_block = caller.Blocks[call_block_id];
+                auto call_position = std::find(call_block.Instructions.begin(), call_block.Instructions.end(), call);
+                following_instructions.assign(call_position + 1, call_block.Instructions.end());
+                call_block.Instructions.erase(call_position + 1, call_block.Instructions.end());
+                following_successors = std::move(call_block.Successors);
+                call_block.Successors.clear();
+            }
+
+            // CREATE BLOCKS FOR THE CALLEE'S REACHABLE BLOCKS.
+            // The callee's entry block continues the block containing the call.
+            std::vector<BlockId> callee_block_order = BlockOrder::GetReversePostorder(callee);
+            std::vector<BlockId> block_mapping(callee.Blocks.size(), INVALID_ID);
+            block_mapping[Function::ENTRY_BLOCK_ID] = call_block_id;
+            for (const BlockId callee_block_id : callee_block_order)
+            {
+                if (Function::ENTRY_BLOCK_ID != callee_block_id)
+                {
+                    block_mapping[callee_block_id] = caller.CreateBlock();
+                }
+            }
+
+            // COPY THE CALLEE'S INSTRUCTIONS.
+            // Reverse postorder copies definitions before their uses, except for phi operands,
+            // which are added once all values have been copied.
+            ValueMapping value_mapping(caller, call, callee);
+            std::vector<std::pair<ValueId, ValueId>> copied_phis;
+            std::vector<std::pair<BlockId, ValueId>> return_sites;
+            std::size_t stack_slot_position = GetStackSlotPosition(caller);
+            std::vector<ValueId> copied_operands;
+            for (const BlockId callee_block_id : callee_block_order)
+            {
+                BlockId block_id = block_mapping[callee_block_id];
+                for (const ValueId callee_instruction_id : callee.Blocks[callee_block_id].Instructions)
+                {
+                    const Instruction& callee_instruction = callee.Values[callee_instruction_id];
+                    switch (callee_instruction.Kind)
+                    {
+                        case InstructionKind::PARAMETER:
+                            // Parameters are already mapped to arguments.
+                            break;
+                        case InstructionKind::STACK_SLOT:
+                        {
+                            ValueId stack_slot = caller.InsertInstruction(
+                                Function::ENTRY_BLOCK_ID,
+                                stack_slot_position,
+                                InstructionKind::STACK_SLOT,
+                                callee_instruction.Type,
+                                {},
+                                callee_instruction.Immediate);
+                            ++stack_slot_position;
+                            value_mapping.Add(callee_instruction_id, stack_slot);
+                            break;
+                        }
+                        case InstructionKind::PHI:
+                        {
+                            ValueId phi = caller.AppendInstruction(block_id, InstructionKind::PHI, callee_instruction.Type, {});
+                            value_mapping.Add(callee_instruction_id, phi);
+                            copied_phis.emplace_back(callee_instruction_id, phi);
+                            break;
+                        }
+                        case InstructionKind::RETURN:
+                        {
+                            // Jumps to the code after the call are added once it's known where that code goes.
+                            ValueId returned_value = (0 == callee_instruction.OperandCount) ?
+                                INVALID_ID :
+                                value_mapping.Get(callee.GetOperand(callee_instruction_id, 0));
+                            return_sites.emplace_back(block_id, returned_value);
+                            break;
+                        }
+                        default:
+                        {
+                            copied_operands.clear();
+                            for (const ValueId operand : callee.GetOperands(callee_instruction_id))
+                            {
+                                copied_operands.push_back(value_mapping.Get(operand));
+                            }
+
+                            std::int64_t immediate = callee_instruction.Immediate;
+                            if (InstructionKind::CALL == callee_instruction.Kind)
+                            {
+                                immediate = GetCalleeIndex(caller, callee.CalleeNames[static_cast<std::size_t>(immediate)]);
+                            }
+                            else if (InstructionKind::STRING_ADDRESS == callee_instruction.Kind)
+                            {
+                                immediate = GetStringLiteralIndex(caller, callee.StringLiterals[static_cast<std::size_t>(immediate)]);
+                            }
+
+                            ValueId instruction_id = caller.AppendInstruction(block_id, callee_instruction.Kind, callee_instruction.Type, copied_operands, immediate);
+                            caller.Values[instruction_id].Flags = callee_instruction.Flags;
+                            value_mapping.Add(callee_instruction_id, instruction_id);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // CONNECT THE COPIED BLOCKS.
+            // Predecessors from unreachable callee blocks are dropped along with their phi operands.
+            for (const BlockId callee_block_id : callee_block_order)
+            {
+                BasicBlock& block = caller.Blocks[block_mapping[callee_block_id]];
+                for (const BlockId successor : callee.Blocks[callee_block_id].Successors)
+                {
+                    block.Successors.push_back(block_mapping[successor]);
+                }
+                for (const BlockId predecessor : callee.Blocks[callee_block_id].Predecessors)
+                {
+                    if (INVALID_ID != block_mapping[predecessor])
+                    {
+                        block.Predecessors.push_back(block_mapping[predecessor]);
+                    }
+                }
+            }
+            for (const auto& [callee_phi, phi] : copied_phis)
+            {
+                const std::vector<BlockId>& callee_predecessors = callee.Blocks[callee.Values[callee_phi].Block].Predecessors;
+                std::span<const ValueId> callee_operands = callee.GetOperands(callee_phi);
+                for (std::size_t operand_index = 0; operand_index < callee_operands.size(); ++operand_index)
+                {
+                    if (INVALID_ID != block_mapping[callee_predecessors[operand_index]])
+                    {
+                        caller.AddOperand(phi, value_mapping.Get(callee_operands[operand_index]));
+                    }
+                }
+            }
+
+            // FIND WHERE THE CODE AFTER THE CALL GOES.
+            // A callee that never returns leaves that code in a block without predecessors,
+            // which is removed as unreachable.
+            BlockId following_block_id = INVALID_ID;
+            ValueId result = INVALID_ID;
+            if (1 == return_sites.size())
+            {
+                following_block_id = return_sites.front().first;
+                result = return_sites.front().second;
+            }
+            else
+            {
+                following_block_id = caller.CreateBlock();
+                for (const auto& [return_block_id, returned_value] : return_sites)
+                {
+                    caller.AppendInstruction(return_block_id, InstructionKind::JUMP, ValueType::VOID, {});
+                    caller.AddEdge(return_block_id, following_block_id);
+                }
+
+                bool result_needs_merging = (caller.HasUses(call) && !return_sites.empty());
+                if (result_needs_merging)
+                {
+                    result = caller.AddPhi(following_block_id, callee.ReturnType);
+                    for (const auto& [return_block_id, returned_value] : return_sites)
+                    {
+                        ValueId merged_value = (INVALID_ID == returned_value) ? caller.GetUndefined(callee.ReturnType) : returned_value;
+                        caller.AddOperand(result, merged_value);
+                    }
+                }
+            }
+
+            // REPLACE THE CALL WITH ITS RESULT.
+            if (caller.HasUses(call))
+            {
+                ValueId replacement = (INVALID_ID == result) ? caller.GetUndefined(callee.ReturnType) : result;
+                caller.ReplaceAllUsesWith(call, replacement);
+            }
+            caller.RemoveInstruction(call);
+
+            // MOVE THE CODE AFTER THE CALL.
+            BasicBlock& following_block = caller.Blocks[following_block_id];
+            for (const ValueId instruction_id : following_instructions)
+            {
+                caller.Values[instruction_id].Block = following_block_id;
+                following_block.Instructions.push_back(instruction_id);
+            }
+            following_block.Successors = std::move(following_successors);
+            for (const BlockId successor : following_block.Successors)
+            {
+                std::vector<BlockId>& successor_predecessors = caller.Blocks[successor].Predecessors;
+                std::replace(successor_predecessors.begin(), successor_predecessors.end(), call_block_id, following_block_id);
+            }
+        }
+
+        /// Maps values in a callee to the values copied into a caller.
+        class ValueMapping
+        {
+        public:
+            /// Creates a mapping with the callee's parameters mapped to the call's arguments.
+            /// @param[in,out] caller - The function containing the call.
+            /// @param[in] call - The call.
+            /// @param[in] callee - The function called.
+            explicit ValueMapping(
+                INTERMEDIATE_REPRESENTATION::Function& caller,
+                const INTERMEDIATE_REPRESENTATION::ValueId call,
+                const INTERMEDIATE_REPRESENTATION::Function& callee) :
+                Caller(caller),
+                Callee(callee),
+                CallerValuesByCalleeValue(callee.Values.size(), INTERMEDIATE_REPRESENTATION::INVALID_ID)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                for (const ValueId instruction_id : callee.Blocks[Function::ENTRY_BLOCK_ID].Instructions)
+                {
+                    const Instruction& instruction = callee.Values[instruction_id];
+                    if (InstructionKind::PARAMETER == instruction.Kind)
+                    {
+                        CallerValuesByCalleeValue[instruction_id] = caller.GetOperand(call, static_cast<std::size_t>(instruction.Immediate));
+                    }
+                }
+            }
+
+            /// Records the copy of a callee value.
+            /// @param[in] callee_value - The value in the callee.
+            /// @param[in] caller_value - The copy in the caller.
+            void Add(const INTERMEDIATE_REPRESENTATION::ValueId callee_value, const INTERMEDIATE_REPRESENTATION::ValueId caller_value)
+            {
+                CallerValuesByCalleeValue[callee_value] = caller_value;
+            }
+
+            /// Gets the copy of a callee value, sharing constants and undefined values with the caller's.
+            /// @param[in] callee_value - The value in the callee, which must already be copied unless it's a constant or undefined.
+            /// @return The copy in the caller.
+            INTERMEDIATE_REPRESENTATION::ValueId Get(const INTERMEDIATE_REPRESENTATION::ValueId callee_value)
+            {
+                using namespace INTERMEDIATE_REPRESENTATION;
+
+                ValueId& caller_value = CallerValuesByCalleeValue[callee_value];
+                if (INVALID_ID == caller_value)
+                {
+                    const Instruction& instruction = Callee.Values[callee_value];
+                    if (InstructionKind::CONSTANT == instruction.Kind)
+                    {
+                        caller_value = Caller.GetConstant(instruction.Type, instruction.Immediate);
+                    }
+                    else if (InstructionKind::UNDEFINED == instruction.Kind)
+                    {
+                        caller_value = Caller.GetUndefined(instruction.Type);
+                    }
+                }
+                return caller_value;
+            }
+
+        private:
+            /// The function values are copied into.
+            INTERMEDIATE_REPRESENTATION::Function& Caller;
+            /// The function values are copied from.
+            const INTERMEDIATE_REPRESENTATION::Function& Callee;
+            /// The caller's copy of each callee value, or invalid if not yet copied.
+            std::vector<INTERMEDIATE_REPRESENTATION::ValueId> CallerValuesByCalleeValue;
+        };
+
+        /// Gets the position in the entry block for new stack slots, after any parameters and existing stack slots.
+        /// @param[in] function - The function.
+        /// @return The position within the entry block's instructions.
+        static std::size_t GetStackSlotPosition(const INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            const std::vector<ValueId>& entry_instructions = function.Blocks[Function::ENTRY_BLOCK_ID].Instructions;
+            std::size_t position = 0;
+            while (position < entry_instructions.size())
+            {
+                InstructionKind kind = function.Values[entry_instructions[position]].Kind;
+                if (InstructionKind::PARAMETER != kind && InstructionKind::STACK_SLOT != kind)
+                {
+                    break;
+                }
+                ++position;
+            }
+            return position;
+        }
+
+        /// Gets the index of a callee name in a function, adding the name if it isn't already present.
+        /// @param[in,out] function - The function.
+        /// @param[in] callee_name - The name of the called function.
+        /// @return The index for call immediates.
+        static std::int64_t GetCalleeIndex(INTERMEDIATE_REPRESENTATION::Function& function, const std::string& callee_name)
+        {
+            auto existing_name = std::find(function.CalleeNames.begin(), function.CalleeNames.end(), callee_name);
+            if (function.CalleeNames.end() == existing_name)
+            {
+                function.CalleeNames.push_back(callee_name);
+                return static_cast<std::int64_t>(function.CalleeNames.size() - 1);
+            }
+            return existing_name - function.CalleeNames.begin();
+        }
+
+        /// Gets the index of a string literal in a function, adding the literal if it isn't already present.
+        /// @param[in,out] function - The function.
+        /// @param[in] string_literal - The contents of the literal.
+        /// @return The index for string address immediates.
+        static std::int64_t GetStringLiteralIndex(INTERMEDIATE_REPRESENTATION::Function& function, const std::string& string_literal)
+        {
+            auto existing_literal = std::find(function.StringLiterals.begin(), function.StringLiterals.end(), string_literal);
+            if (function.StringLiterals.end() == existing_literal)
+            {
+                function.StringLiterals.push_back(string_literal);
+                return static_cast<std::int64_t>(function.StringLiterals.size() - 1);
+            }
+            return existing_literal - function.StringLiterals.begin();
+        }
+    };
+}
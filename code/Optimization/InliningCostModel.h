@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "IntermediateRepresentation/Function.h"
+
+namespace OPTIMIZATION
+{
+    /// Decides which calls are worth inlining.
+    ///
+    /// Costs are measured in instructions: the callee's size, less what
+    /// inlining saves.  Every call saves the call and return themselves plus
+    /// passing each argument, and constant arguments save more since the
+    /// callee's uses of them can then be folded, especially when they decide
+    /// branches.  Calls are inlined when their cost is at most the threshold,
+    /// so tiny helpers are inlined everywhere while larger functions are only
+    /// inlined where constant arguments let much of them fold away.
+    struct InliningCostModel
+    {
+        /// Determines if a call should be inlined.
+        /// @param[in] caller - The function containing the call.
+        /// @param[in] caller_instruction_count - The current size of the caller, per GetInstructionCount().
+        /// @param[in] call - The call.
+        /// @param[in] callee - The function called.
+        /// @return True if the call should be inlined; false otherwise.
+        bool ShouldInline(
+            const INTERMEDIATE_REPRESENTATION::Function& caller,
+            const std::size_t caller_instruction_count,
+            const INTERMEDIATE_REPRESENTATION::ValueId call,
+            const INTERMEDIATE_REPRESENTATION::Function& callee) const
+        {
+            // Callers are capped so that many inlined calls can't make a function arbitrarily large.
+            std::size_t callee_instruction_count = GetInstructionCount(callee);
+            if (caller_instruction_count + callee_instruction_count > MaximumCallerInstructionCount)
+            {
+                return false;
+            }
+
+            std::int64_t cost = GetCost(caller, call, callee);
+            return cost <= Threshold;
+        }
+
+        /// Estimates the cost of inlining a call.
+        /// @param[in] caller - The function containing the call.
+        /// @param[in] call - The call.
+        /// @param[in] callee - The function called.
+        /// @return The estimated number of instructions added by inlining, which is negative if the caller shrinks.
+        std::int64_t GetCost(
+            const INTERMEDIATE_REPRESENTATION::Function& caller,
+            const INTERMEDIATE_REPRESENTATION::ValueId call,
+            const INTERMEDIATE_REPRESENTATION::Function& callee) const
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            std::int64_t cost = static_cast<std::int64_t>(GetInstructionCount(callee)) - CallSavings;
+
+            // SUBTRACT SAVINGS FOR EACH ARGUMENT.
+            for (const ValueId parameter : callee.Blocks[Function::ENTRY_BLOCK_ID].Instructions)
+            {
+                if (InstructionKind::PARAMETER != callee.Values[parameter].Kind)
+                {
+                    continue;
+                }
+                cost -= ArgumentSavings;
+
+                ValueId argument = caller.GetOperand(call, static_cast<std::size_t>(callee.Values[parameter].Immediate));
+                bool is_used_constant = caller.IsConstant(argument) && callee.HasUses(parameter);
+                if (!is_used_constant)
+                {
+                    continue;
+                }
+                cost -= ConstantArgumentSavings;
+
+                // Constants deciding branches let whole paths through the callee be removed.
+                for (const ValueId user : callee.GetUsers(parameter))
+                {
+                    InstructionKind user_kind = callee.Values[user].Kind;
+                    if (InstructionKind::BRANCH == user_kind || IsComparison(user_kind))
+                    {
+                        cost -= ConstantConditionSavings;
+                        break;
+                    }
+                }
+            }
+            return cost;
+        }
+
+        /// Gets the size of a function for inlining.
+        /// @param[in] function - The function.
+        /// @return The number of instructions in the function's blocks, excluding parameters.
+        static std::size_t GetInstructionCount(const INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            std::size_t instruction_count = 0;
+            for (const BasicBlock& block : function.Blocks)
+            {
+                for (const ValueId instruction_id : block.Instructions)
+                {
+                    if (InstructionKind::PARAMETER != function.Values[instruction_id].Kind)
+                    {
+                        ++instruction_count;
+                    }
+                }
+            }
+            return instruction_count;
+        }
+
+        /// The highest cost of calls that are inlined.
+        std::int64_t Threshold = 25;
+        /// The savings from removing the call and return themselves.
+        std::int64_t CallSavings = 4;
+        /// The savings from not passing each argument.
+        std::int64_t ArgumentSavings = 1;
+        /// The additional savings for each constant argument the callee uses.
+        std::int64_t ConstantArgumentSavings = 4;
+        /// The additional savings for each constant argument deciding a branch or comparison.
+        std::int64_t ConstantConditionSavings = 8;
+        /// The largest size callers may grow to by inlining.
+        std::size_t MaximumCallerInstructionCount = 4000;
+    };
+}
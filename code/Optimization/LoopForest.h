@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+#include "Optimization/DominatorTree.h"
+
+namespace OPTIMIZATION
+{
+    /// A natural loop: a header block that dominates a set of blocks with edges back to it.
+    struct Loop
+    {
+        /// Determines if a block is in the loop.
+        /// @param[in] block_id - The block.
+        /// @return True if the block is in the loop; false otherwise.
+        bool Contains(const INTERMEDIATE_REPRESENTATION::BlockId block_id) const
+        {
+            return ContainedBlocks[block_id];
+        }
+
+        /// Determines if a value is defined outside of the loop and so doesn't change while it runs.
+        /// @param[in] function - The function containing the loop.
+        /// @param[in] value - The value.
+        /// @return True if the value is loop-invariant; false otherwise.
+        bool IsInvariant(const INTERMEDIATE_REPRESENTATION::Function& function, const INTERMEDIATE_REPRESENTATION::ValueId value) const
+        {
+            INTERMEDIATE_REPRESENTATION::BlockId block_id = function.Values[value].Block;
+            return INTERMEDIATE_REPRESENTATION::INVALID_ID == block_id || !Contains(block_id);
+        }
+
+        /// The block where each iteration starts, which dominates the whole loop.
+        INTERMEDIATE_REPRESENTATION::BlockId Header = INTERMEDIATE_REPRESENTATION::INVALID_ID;
+        /// The only block entering the loop, if its only successor is the header; invalid otherwise.
+        INTERMEDIATE_REPRESENTATION::BlockId Preheader = INTERMEDIATE_REPRESENTATION::INVALID_ID;
+        /// The blocks in the loop with edges back to the header.
+        std::vector<INTERMEDIATE_REPRESENTATION::BlockId> Latches = {};
+        /// The blocks in the loop in reverse postorder, starting with the header.
+        std::vector<INTERMEDIATE_REPRESENTATION::BlockId> Blocks = {};
+        /// Whether each block in the function is in the loop.
+        std::vector<bool> ContainedBlocks = {};
+    };
+
+    /// The natural loops in a function.  Loops sharing a header are combined,
+    /// so any two loops are either disjoint or one is nested in the other.
+    struct LoopForest
+    {
+        /// Marks blocks that aren't in any loop.
+        static constexpr std::size_t NO_LOOP = SIZE_MAX;
+
+        /// Finds the loops in a function.
+        /// @param[in] function - The function.
+        /// @param[in] dominator_tree - The dominator tree of the function.
+        /// @return The loops.
+        static LoopForest Find(const INTERMEDIATE_REPRESENTATION::Function& function, const DominatorTree& dominator_tree)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // FIND THE LOOP HEADERS AND LATCHES.
+            // An edge to a block that dominates its source is a back edge, and its target a loop header.
+            LoopForest forest;
+            std::vector<std::size_t> loop_indices_by_header(function.Blocks.size(), NO_LOOP);
+            for (const BlockId block_id : dominator_tree.ReversePostorder)
+            {
+                for (const BlockId predecessor : function.Blocks[block_id].Predecessors)
+                {
+                    bool is_back_edge = dominator_tree.Dominates(block_id, predecessor);
+                    if (!is_back_edge)
+                    {
+                        continue;
+                    }
+                    if (NO_LOOP == loop_indices_by_header[block_id])
+                    {
+                        loop_indices_by_header[block_id] = forest.Loops.size();
+                        Loop& new_loop = forest.Loops.emplace_back();
+                        new_loop.Header = block_id;
+                    }
+                    std::vector<BlockId>& latches = forest.Loops[loop_indices_by_header[block_id]].Latches;
+                    if (latches.end() == std::find(latches.begin(), latches.end(), predecessor))
+                    {
+                        latches.push_back(predecessor);
+                    }
+                }
+            }
+
+            // FIND THE BLOCKS IN EACH LOOP.
+            // These are the blocks that can reach a latch without passing through the header.
+            for (Loop& loop : forest.Loops)
+            {
+                loop.ContainedBlocks.assign(function.Blocks.size(), false);
+                loop.ContainedBlocks[loop.Header] = true;
+                std::vector<BlockId> worklist;
+                for (const BlockId latch : loop.Latches)
+                {
+                    if (!loop.ContainedBlocks[latch])
+                    {
+                        loop.ContainedBlocks[latch] = true;
+                        worklist.push_back(latch);
+                    }
+                }
+                while (!worklist.empty())
+                {
+                    BlockId block_id = worklist.back();
+                    worklist.pop_back();
+                    for (const BlockId predecessor : function.Blocks[block_id].Predecessors)
+                    {
+                        if (!loop.ContainedBlocks[predecessor] && dominator_tree.IsReachable(predecessor))
+                        {
+                            loop.ContainedBlocks[predecessor] = true;
+                            worklist.push_back(predecessor);
+                        }
+                    }
+                }
+                for (const BlockId block_id : dominator_tree.ReversePostorder)
+                {
+                    if (loop.ContainedBlocks[block_id])
+                    {
+                        loop.Blocks.push_back(block_id);
+                    }
+                }
+
+                // FIND ANY PREHEADER.
+                const std::vector<BlockId>& header_predecessors = function.Blocks[loop.Header].Predecessors;
+                std::size_t entering_edge_count = 0;
+                for (const BlockId predecessor : header_predecessors)
+                {
+                    if (!loop.ContainedBlocks[predecessor])
+                    {
+                        loop.Preheader = predecessor;
+                        ++entering_edge_count;
+                    }
+                }
+                bool has_preheader = (1 == entering_edge_count && 1 == function.Blocks[loop.Preheader].Successors.size());
+                if (!has_preheader)
+                {
+                    loop.Preheader = INVALID_ID;
+                }
+            }
+
+            // ORDER LOOPS FROM INNERMOST TO OUTERMOST.
+            // Nested loops are strictly smaller than the loops containing them.
+            std::stable_sort(forest.Loops.begin(), forest.Loops.end(), [](const Loop& left, const Loop& right)
+            {
+                return left.Blocks.size() < right.Blocks.size();
+            });
+            forest.InnermostLoopIndicesByBlock.assign(function.Blocks.size(), NO_LOOP);
+            for (std::size_t loop_index = 0; loop_index < forest.Loops.size(); ++loop_index)
+            {
+                for (const BlockId block_id : forest.Loops[loop_index].Blocks)
+                {
+                    if (NO_LOOP == forest.InnermostLoopIndicesByBlock[block_id])
+                    {
+                        forest.InnermostLoopIndicesByBlock[block_id] = loop_index;
+                    }
+                }
+            }
+            return forest;
+        }
+
+        /// The loops, with inner loops before the loops containing them.
+        std::vector<Loop> Loops = {};
+        /// The index of the innermost loop containing each block, or NO_LOOP if none does.
+        std::vector<std::size_t> InnermostLoopIndicesByBlock = {};
+    };
+}
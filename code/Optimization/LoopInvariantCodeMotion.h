@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+#include "Optimization/DominatorTree.h"
+#include "Optimization/LoopForest.h"
+
+namespace OPTIMIZATION
+{
+    /// Moves computations whose operands don't change within a loop to before
+    /// the loop, so they're done once rather than on every iteration.
+    ///
+    /// Each loop is first given a preheader: a block that's the only way into
+    /// the loop and only continues to its header.  Invariant instructions are
+    /// moved to the end of the preheader, innermost loops first, so a value
+    /// invariant across several nested loops moves out one level at a time.
+    ///
+    /// Only instructions that can't fault or have side effects are moved, since
+    /// they may be moved out of a branch or a loop that runs zero times.  Loads
+    /// stay put, as a store or call in the loop may change the loaded memory.
+    struct LoopInvariantCodeMotion
+    {
+        /// Runs the pass on a function.
+        /// @param[in,out] function - The function to optimize.
+        /// @return The number of instructions moved.
+        static std::size_t Run(INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // GIVE EVERY LOOP A PREHEADER.
+            // Loops are found again afterward since new preheaders belong to any enclosing loops.
+            DominatorTree dominator_tree = DominatorTree::Build(function);
+            LoopForest loop_forest = LoopForest::Find(function, dominator_tree);
+            bool preheader_inserted = false;
+            for (const Loop& loop : loop_forest.Loops)
+            {
+                if (INVALID_ID == loop.Preheader)
+                {
+                    InsertPreheader(function, loop);
+                    preheader_inserted = true;
+                }
+            }
+            if (preheader_inserted)
+            {
+                dominator_tree = DominatorTree::Build(function);
+                loop_forest = LoopForest::Find(function, dominator_tree);
+            }
+
+            // MOVE INVARIANT INSTRUCTIONS TO EACH PREHEADER.
+            // Blocks are visited so that operands are seen before their users, which lets
+            // chains of invariant instructions move together in a single pass.
+            std::size_t moved_instruction_count = 0;
+            for (const Loop& loop : loop_forest.Loops)
+            {
+                std::vector<ValueId>& preheader_instructions = function.Blocks[loop.Preheader].Instructions;
+                for (const BlockId block_id : loop.Blocks)
+                {
+                    std::vector<ValueId>& block_instructions = function.Blocks[block_id].Instructions;
+                    std::erase_if(block_instructions, [&](const ValueId instruction_id)
+                    {
+                        if (!CanMove(function, loop, instruction_id))
+                        {
+                            return false;
+                        }
+                        preheader_instructions.insert(preheader_instructions.end() - 1, instruction_id);
+                        function.Values[instruction_id].Block = loop.Preheader;
+                        ++moved_instruction_count;
+                        return true;
+                    });
+                }
+            }
+            return moved_instruction_count;
+        }
+
+    private:
+        /// Determines if an instruction can be moved to a loop's preheader.
+        /// @param[in] function - The function containing the loop.
+        /// @param[in] loop - The loop.
+        /// @param[in] instruction_id - The instruction within the loop.
+        /// @return True if the instruction is loop-invariant and safe to execute unconditionally; false otherwise.
+        static bool CanMove(const INTERMEDIATE_REPRESENTATION::Function& function, const Loop& loop, const INTERMEDIATE_REPRESENTATION::ValueId instruction_id)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // CHECK IF THE INSTRUCTION CAN RUN ANYWHERE.
+            // Division only faults for some divisors, so it can move when the divisor is a constant that's safe.
+            const Instruction& instruction = function.Values[instruction_id];
+            bool is_division = (
+                InstructionKind::SIGNED_DIVIDE <= instruction.Kind &&
+                instruction.Kind <= InstructionKind::UNSIGNED_REMAINDER);
+            bool is_movable_kind = (
+                IsBinaryOperation(instruction.Kind) ||
+                IsComparison(instruction.Kind) ||
+                IsConversion(instruction.Kind) ||
+                InstructionKind::NEGATE == instruction.Kind ||
+                InstructionKind::NOT == instruction.Kind ||
+                InstructionKind::STRING_ADDRESS == instruction.Kind);
+            if (!is_movable_kind)
+            {
+                return false;
+            }
+            if (is_division)
+            {
+                ValueId divisor = function.GetOperand(instruction_id, 1);
+                if (!function.IsConstant(divisor))
+                {
+                    return false;
+                }
+                std::int64_t divisor_value = function.Values[divisor].Immediate;
+                bool is_signed = (InstructionKind::SIGNED_DIVIDE == instruction.Kind || InstructionKind::SIGNED_REMAINDER == instruction.Kind);
+                bool may_fault = (0 == divisor_value || (is_signed && -1 == divisor_value));
+                if (may_fault)
+                {
+                    return false;
+                }
+            }
+
+            // CHECK IF THE INSTRUCTION'S OPERANDS ARE INVARIANT.
+            for (const ValueId operand : function.GetOperands(instruction_id))
+            {
+                if (!loop.IsInvariant(function, operand))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Adds a block that all edges entering a loop go through.
+        /// Phis in the header get a single operand for the preheader, with a phi in the
+        /// preheader merging the values from each entering edge if there's more than one.
+        /// @param[in,out] function - The function containing the loop.
+        /// @param[in] loop - The loop.
+        static void InsertPreheader(INTERMEDIATE_REPRESENTATION::Function& function, const Loop& loop)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // CREATE THE PREHEADER.
+            BlockId preheader_id = function.CreateBlock();
+            function.AppendInstruction(preheader_id, InstructionKind::JUMP, ValueType::VOID, {});
+
+            // SPLIT THE HEADER'S PREDECESSORS INTO ENTERING EDGES AND BACK EDGES.
+            std::vector<BlockId> header_predecessors = function.Blocks[loop.Header].Predecessors;
+            std::vector<BlockId> entering_blocks;
+            std::vector<BlockId> latch_blocks;
+            for (const BlockId predecessor : header_predecessors)
+            {
+                (loop.Contains(predecessor) ? latch_blocks : entering_blocks).push_back(predecessor);
+            }
+
+            // SPLIT EACH HEADER PHI'S OPERANDS THE SAME WAY.
+            // The preheader becomes the header's first predecessor.
+            std::vector<ValueId> header_phis;
+            for (const ValueId instruction_id : function.Blocks[loop.Header].Instructions)
+            {
+                if (InstructionKind::PHI != function.Values[instruction_id].Kind)
+                {
+                    break;
+                }
+                header_phis.push_back(instruction_id);
+            }
+            for (const ValueId phi : header_phis)
+            {
+                std::vector<ValueId> entering_values;
+                std::vector<ValueId> latch_values;
+                std::span<const ValueId> operands = function.GetOperands(phi);
+                for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+                {
+                    (loop.Contains(header_predecessors[operand_index]) ? latch_values : entering_values).push_back(operands[operand_index]);
+                }
+
+                ValueId entering_value = entering_values.front();
+                bool entering_values_differ = std::any_of(entering_values.begin(), entering_values.end(), [&](const ValueId value)
+                {
+                    return value != entering_values.front();
+                });
+                if (entering_values_differ)
+                {
+                    entering_value = function.AddPhi(preheader_id, function.Values[phi].Type);
+                    for (const ValueId value : entering_values)
+                    {
+                        function.AddOperand(entering_value, value);
+                    }
+                }
+
+                while (function.Values[phi].OperandCount > 0)
+                {
+                    function.RemoveOperand(phi, function.Values[phi].OperandCount - 1);
+                }
+                function.AddOperand(phi, entering_value);
+                for (const ValueId value : latch_values)
+                {
+                    function.AddOperand(phi, value);
+                }
+            }
+
+            // REDIRECT THE ENTERING EDGES.
+            for (const BlockId entering_block : entering_blocks)
+            {
+                std::vector<BlockId>& successors = function.Blocks[entering_block].Successors;
+                std::replace(successors.begin(), successors.end(), loop.Header, preheader_id);
+            }
+            function.Blocks[preheader_id].Predecessors = std::move(entering_blocks);
+            function.Blocks[preheader_id].Successors = { loop.Header };
+            latch_blocks.insert(latch_blocks.begin(), preheader_id);
+            function.Blocks[loop.Header].Predecessors = std::move(latch_blocks);
+        }
+    };
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+#include "Optimization/CallGraph.h"
+#include "Optimization/DeadCodeElimination.h"
+#include "Optimization/InductionVariableStrengthReduction.h"
+#include "Optimization/Inliner.h"
+#include "Optimization/InliningCostModel.h"
+#include "Optimization/LoopInvariantCodeMotion.h"
+#include "Optimization/PassStatistics.h"
+#include "Optimization/SparseConditionalConstantPropagation.h"
+#include "Optimization/UnreachableBlockElimination.h"
+
+namespace OPTIMIZATION
+{
+    /// Runs the optimization passes over lowered functions.
+    struct Optimizer
+    {
+        /// Optimizes all functions in a module.
+        /// @param[in,out] module - The module to optimize.
+        /// @param[in] inlining_cost_model - Decides which calls to inline.
+        /// @param[in,out] statistics - The statistics to add each pass's work to.
+        static void Optimize(
+            INTERMEDIATE_REPRESENTATION::Module& module,
+            const InliningCostModel& inlining_cost_model,
+            PassStatistics& statistics)
+        {
+            // OPTIMIZE FUNCTIONS BOTTOM-UP OVER THE CALL GRAPH.
+            // Each function is fully optimized before its callers consider inlining it,
+            // so they see its size after its own calls are inlined and folded.
+            CallGraph call_graph = CallGraph::Build(module);
+            for (const std::vector<std::size_t>& component : call_graph.StronglyConnectedComponents)
+            {
+                for (const std::size_t function_index : component)
+                {
+                    OptimizeWithInlining(module, call_graph, function_index, inlining_cost_model, statistics);
+                }
+            }
+        }
+
+        /// Groups functions into waves that can each be optimized in parallel.
+        ///
+        /// Each wave only calls into earlier waves (or itself, through recursion).
+        /// Recursive calls are never inlined and functions only change themselves,
+        /// so functions in a wave don't affect each other, and optimizing waves in
+        /// order (with any order within a wave) gives the same result as Optimize().
+        /// @param[in] call_graph - The call graph of the module.
+        /// @return The indices of functions in each wave, in order.
+        static std::vector<std::vector<std::size_t>> GetOptimizationWaves(const CallGraph& call_graph)
+        {
+            // Components are ordered bottom-up, so the waves of all callees are known before their callers.
+            std::vector<std::size_t> wave_indices_by_component(call_graph.StronglyConnectedComponents.size(), 0);
+            std::vector<std::vector<std::size_t>> waves;
+            for (std::size_t component_index = 0; component_index < call_graph.StronglyConnectedComponents.size(); ++component_index)
+            {
+                std::size_t wave_index = 0;
+                for (const std::size_t function_index : call_graph.StronglyConnectedComponents[component_index])
+                {
+                    for (const std::size_t callee_index : call_graph.CalleesByFunction[function_index])
+                    {
+                        std::size_t callee_component_index = call_graph.ComponentIndicesByFunction[callee_index];
+                        if (component_index != callee_component_index)
+                        {
+                            wave_index = std::max(wave_index, wave_indices_by_component[callee_component_index] + 1);
+                        }
+                    }
+                }
+
+                wave_indices_by_component[component_index] = wave_index;
+                if (waves.size() <= wave_index)
+                {
+                    waves.resize(wave_index + 1);
+                }
+                waves[wave_index].insert(
+                    waves[wave_index].end(),
+                    call_graph.StronglyConnectedComponents[component_index].begin(),
+                    call_graph.StronglyConnectedComponents[component_index].end());
+            }
+            return waves;
+        }
+
+        /// Inlines calls in a function and then optimizes it.  Functions it calls
+        /// (other than recursively) must already be optimized.  Only the function
+        /// itself is changed, so functions that don't call each other can be
+        /// optimized on different threads at once.
+        /// @param[in,out] module - The module containing the function.
+        /// @param[in] call_graph - The call graph of the module.
+        /// @param[in] function_index - The index of the function to optimize.
+        /// @param[in] inlining_cost_model - Decides which calls to inline.
+        /// @param[in,out] statistics - The statistics to add each pass's work to.
+        static void OptimizeWithInlining(
+            INTERMEDIATE_REPRESENTATION::Module& module,
+            const CallGraph& call_graph,
+            const std::size_t function_index,
+            const InliningCostModel& inlining_cost_model,
+            PassStatistics& statistics)
+        {
+            RunPass(PassKind::INLINING, statistics, [&] { return Inliner::Run(module, call_graph, function_index, inlining_cost_model); });
+            Optimize(module.Functions[function_index], statistics);
+        }
+
+        /// Optimizes a function on its own, without inlining.
+        /// @param[in,out] function - The function to optimize.
+        /// @param[in,out] statistics - The statistics to add each pass's work to.
+        static void Optimize(INTERMEDIATE_REPRESENTATION::Function& function, PassStatistics& statistics)
+        {
+            // Constant propagation makes branches unconditional, which leaves blocks
+            // unreachable, and removing those leaves their values' inputs unused.
+            // Loop passes run on what remains, with invariant code moved out first so that
+            // strength reduction sees invariant operands and the preheaders it needs.
+            RunPass(PassKind::SPARSE_CONDITIONAL_CONSTANT_PROPAGATION, statistics, [&] { return SparseConditionalConstantPropagation::Run(function); });
+            RunPass(PassKind::UNREACHABLE_BLOCK_ELIMINATION, statistics, [&] { return UnreachableBlockElimination::Run(function); });
+            RunPass(PassKind::LOOP_INVARIANT_CODE_MOTION, statistics, [&] { return LoopInvariantCodeMotion::Run(function); });
+            RunPass(PassKind::INDUCTION_VARIABLE_STRENGTH_REDUCTION, statistics, [&] { return InductionVariableStrengthReduction::Run(function); });
+            RunPass(PassKind::DEAD_CODE_ELIMINATION, statistics, [&] { return DeadCodeElimination::Run(function); });
+        }
+
+    private:
+        /// Runs a single pass, recording its time and changes.
+        /// @tparam PassFunction - The type of the function running the pass.
+        /// @param[in] pass_kind - The kind of pass for statistics.
+        /// @param[in,out] statistics - The statistics to add the pass's work to.
+        /// @param[in] run_pass - Runs the pass, returning the number of changes made.
+        template <typename PassFunction>
+        static void RunPass(const PassKind pass_kind, PassStatistics& statistics, const PassFunction& run_pass)
+        {
+            std::size_t change_count = 0;
+            {
+                ScopedPassTimer timer(pass_kind, statistics);
+                change_count = run_pass();
+            }
+            statistics.CountsByPass[static_cast<std::size_t>(pass_kind)].ChangeCount += change_count;
+        }
+    };
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace OPTIMIZATION
+{
+    /// The different optimization passes.
+    enum class PassKind : std::uint32_t
+    {
+        INLINING = 0,
+        SPARSE_CONDITIONAL_CONSTANT_PROPAGATION,
+        UNREACHABLE_BLOCK_ELIMINATION,
+        LOOP_INVARIANT_CODE_MOTION,
+        INDUCTION_VARIABLE_STRENGTH_REDUCTION,
+        DEAD_CODE_ELIMINATION,
+        /// The total number of passes.  Must remain last.
+        COUNT
+    };
+
+    /// Gets a human-readable name for a pass.
+    /// @param[in] pass - The pass for which to get a name.
+    /// @return The name of the pass.
+    inline const char* GetPassName(const PassKind pass)
+    {
+        switch (pass)
+        {
+            case PassKind::INLINING:
+                return "Inlining";
+            case PassKind::SPARSE_CONDITIONAL_CONSTANT_PROPAGATION:
+                return "Constant propagation";
+            case PassKind::UNREACHABLE_BLOCK_ELIMINATION:
+                return "Unreachable blocks";
+            case PassKind::LOOP_INVARIANT_CODE_MOTION:
+                return "Loop-invariant code";
+            case PassKind::INDUCTION_VARIABLE_STRENGTH_REDUCTION:
+                return "Strength reduction";
+            case PassKind::DEAD_CODE_ELIMINATION:
+                return "Dead code";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /// Counts of work done by a single pass.
+    struct PassCounts
+    {
+        /// The number of times the pass ran (once per function).
+        std::uint64_t RunCount = 0;
+        /// The number of changes made, such as instructions folded or removed.
+        std::uint64_t ChangeCount = 0;
+        /// The total time spent in the pass.
+        std::chrono::nanoseconds Duration = std::chrono::nanoseconds::zero();
+    };
+
+    /// Work done by each optimization pass.  Statistics are gathered
+    /// separately for each translation unit so that parallel compilation
+    /// doesn't contend on shared counters, and are added together afterward.
+    struct PassStatistics
+    {
+        /// Adds statistics from another set.
+        /// @param[in] other - The statistics to add.
+        void Add(const PassStatistics& other)
+        {
+            for (std::size_t pass_index = 0; pass_index < CountsByPass.size(); ++pass_index)
+            {
+                CountsByPass[pass_index].RunCount += other.CountsByPass[pass_index].RunCount;
+                CountsByPass[pass_index].ChangeCount += other.CountsByPass[pass_index].ChangeCount;
+                CountsByPass[pass_index].Duration += other.CountsByPass[pass_index].Duration;
+            }
+        }
+
+        /// Determines if any pass has run.
+        /// @return True if any pass ran; false otherwise.
+        bool Empty() const
+        {
+            for (const PassCounts& counts : CountsByPass)
+            {
+                if (counts.RunCount > 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Formats a table of the statistics for each pass.
+        /// @return The table, ending with a newline.
+        std::string Format() const
+        {
+            std::string text = "Optimization passes:\n";
+            char line[128];
+            std::snprintf(line, sizeof(line), "%-22s %10s %10s %12s\n", "Pass", "Runs", "Changes", "Time (ms)");
+            text += line;
+            for (std::size_t pass_index = 0; pass_index < CountsByPass.size(); ++pass_index)
+            {
+                const PassCounts& counts = CountsByPass[pass_index];
+                std::snprintf(
+                    line,
+                    sizeof(line),
+                    "%-22s %10llu %10llu %12.3f\n",
+                    GetPassName(static_cast<PassKind>(pass_index)),
+                    static_cast<unsigned long long>(counts.RunCount),
+                    static_cast<unsigned long long>(counts.ChangeCount),
+                    std::chrono::duration<double, std::milli>(counts.Duration).count());
+                text += line;
+            }
+            return text;
+        }
+
+        /// Counts for each pass, indexed by pass kind.
+        std::array<PassCounts, static_cast<std::size_t>(PassKind::COUNT)> CountsByPass = {};
+    };
+
+    /// Times a run of a pass for the lifetime of this object, adding the time
+    /// and a run to the pass's statistics when destroyed.
+    struct ScopedPassTimer
+    {
+        /// Starts timing a pass.
+        /// @param[in] pass - The pass being run.
+        /// @param[in,out] statistics - The statistics to add the run to.
+        explicit ScopedPassTimer(const PassKind pass, PassStatistics& statistics) :
+            Counts(statistics.CountsByPass[static_cast<std::size_t>(pass)]),
+            StartTime(std::chrono::steady_clock::now())
+        {}
+
+        /// Stops timing the pass.
+        ~ScopedPassTimer()
+        {
+            ++Counts.RunCount;
+            Counts.Duration += std::chrono::steady_clock::now() - StartTime;
+        }
+
+        ScopedPassTimer(const ScopedPassTimer&) = delete;
+        ScopedPassTimer& operator=(const ScopedPassTimer&) = delete;
+
+    private:
+        /// The counts for the pass being timed.
+        PassCounts& Counts;
+        /// When the pass started.
+        std::chrono::steady_clock::time_point StartTime;
+    };
+}
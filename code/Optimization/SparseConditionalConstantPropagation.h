@@ -0,0 +1,417 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+#include "Optimization/ConstantFolder.h"
+
+namespace OPTIMIZATION
+{
+    /// Finds values that are constant on every path that can actually execute,
+    /// replacing them with constants and turning branches on constant conditions
+    /// into jumps.  Blocks found to be unreachable are left for unreachable
+    /// block elimination to remove.
+    ///
+    /// This is Wegman and Zadeck's algorithm.  Values start out assumed
+    /// constant and are only lowered when evidence says otherwise, and blocks
+    /// start out assumed unreachable, so it finds constants that folding and
+    /// unreachable code removal run separately would miss (such as a variable
+    /// assigned in a loop only under a condition that's never true).  Work is
+    /// driven by two worklists (newly executable edges and values whose
+    /// state changed), so each instruction is only revisited when one of
+    /// its inputs changes rather than in repeated sweeps over the function.
+    struct SparseConditionalConstantPropagation
+    {
+        /// Runs the pass on a function.
+        /// @param[in,out] function - The function to optimize.
+        /// @return The number of values replaced and branches simplified.
+        static std::size_t Run(INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            SparseConditionalConstantPropagation pass(function);
+            pass.Solve();
+            return pass.Rewrite();
+        }
+
+    private:
+        /// The states of values in the lattice, from most to least optimistic.
+        enum class LatticeState : std::uint8_t
+        {
+            /// No executed definition of the value has been seen yet.
+            UNKNOWN = 0,
+            /// The value is the same constant on every executed path.
+            CONSTANT,
+            /// The value may vary.
+            VARYING,
+        };
+
+        /// What's known about a value.
+        struct LatticeValue
+        {
+            /// How much is known.
+            LatticeState State = LatticeState::UNKNOWN;
+            /// The value, if constant.
+            std::int64_t Constant = 0;
+        };
+
+        /// Creates the pass for a function.
+        /// @param[in,out] function - The function to optimize.
+        explicit SparseConditionalConstantPropagation(INTERMEDIATE_REPRESENTATION::Function& function) :
+            Output(function),
+            Lattice(function.Values.size()),
+            ExecutableBlocks(function.Blocks.size(), false)
+        {}
+
+        /// Propagates constants and reachability until nothing changes.
+        void Solve()
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // INITIALIZE VALUES DEFINED OUTSIDE OF BLOCKS.
+            // Undefined values are treated as varying, except where phis can ignore them.
+            for (ValueId value = 0; value < Output.Values.size(); ++value)
+            {
+                const Instruction& instruction = Output.Values[value];
+                if (InstructionKind::CONSTANT == instruction.Kind)
+                {
+                    Lattice[value] = LatticeValue { .State = LatticeState::CONSTANT, .Constant = instruction.Immediate };
+                }
+                else if (InstructionKind::UNDEFINED == instruction.Kind)
+                {
+                    Lattice[value].State = LatticeState::VARYING;
+                }
+            }
+
+            // PROPAGATE FROM THE ENTRY BLOCK.
+            // Phis merging only undefined values are left unknown while propagating, since
+            // a later edge may give them a constant.  Any still unknown afterward must vary.
+            MarkBlockExecutable(Function::ENTRY_BLOCK_ID);
+            do
+            {
+                Propagate();
+            } while (ResolveUnknownPhis());
+        }
+
+        /// Processes the worklists until they're empty.
+        void Propagate()
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            while (!EdgeWorklist.empty() || !ValueWorklist.empty())
+            {
+                while (!EdgeWorklist.empty())
+                {
+                    auto [from_block_id, to_block_id] = EdgeWorklist.back();
+                    EdgeWorklist.pop_back();
+                    bool edge_added = ExecutableEdges.insert(GetEdgeKey(from_block_id, to_block_id)).second;
+                    if (!edge_added)
+                    {
+                        continue;
+                    }
+
+                    // A newly reached block has all of its instructions evaluated,
+                    // but a new edge into a reached block only affects its phis.
+                    if (!ExecutableBlocks[to_block_id])
+                    {
+                        MarkBlockExecutable(to_block_id);
+                        continue;
+                    }
+                    for (const ValueId instruction_id : Output.Blocks[to_block_id].Instructions)
+                    {
+                        if (InstructionKind::PHI != Output.Values[instruction_id].Kind)
+                        {
+                            break;
+                        }
+                        VisitInstruction(instruction_id);
+                    }
+                }
+
+                while (!ValueWorklist.empty())
+                {
+                    ValueId value = ValueWorklist.back();
+                    ValueWorklist.pop_back();
+                    for (UseId use_id = Output.Values[value].FirstUse; INVALID_ID != use_id; use_id = Output.Uses[use_id].NextUse)
+                    {
+                        ValueId user = Output.Uses[use_id].User;
+                        if (ExecutableBlocks[Output.Values[user].Block])
+                        {
+                            VisitInstruction(user);
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Marks phis in executable blocks that are still unknown as varying.
+        /// @return True if any phi was marked, requiring further propagation; false otherwise.
+        bool ResolveUnknownPhis()
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            bool any_phi_resolved = false;
+            for (BlockId block_id = 0; block_id < Output.Blocks.size(); ++block_id)
+            {
+                if (!ExecutableBlocks[block_id])
+                {
+                    continue;
+                }
+                for (const ValueId instruction_id : Output.Blocks[block_id].Instructions)
+                {
+                    if (InstructionKind::PHI != Output.Values[instruction_id].Kind)
+                    {
+                        break;
+                    }
+                    if (LatticeState::UNKNOWN == Lattice[instruction_id].State)
+                    {
+                        UpdateValue(instruction_id, LatticeValue { .State = LatticeState::VARYING });
+                        any_phi_resolved = true;
+                    }
+                }
+            }
+            return any_phi_resolved;
+        }
+
+        /// Marks a block as executable and evaluates its instructions.
+        /// @param[in] block_id - The block.
+        void MarkBlockExecutable(const INTERMEDIATE_REPRESENTATION::BlockId block_id)
+        {
+            ExecutableBlocks[block_id] = true;
+            for (const INTERMEDIATE_REPRESENTATION::ValueId instruction_id : Output.Blocks[block_id].Instructions)
+            {
+                VisitInstruction(instruction_id);
+            }
+        }
+
+        /// Evaluates an instruction given what's currently known about its operands.
+        /// @param[in] instruction_id - The instruction.
+        void VisitInstruction(const INTERMEDIATE_REPRESENTATION::ValueId instruction_id)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            const Instruction& instruction = Output.Values[instruction_id];
+            const BasicBlock& block = Output.Blocks[instruction.Block];
+            std::span<const ValueId> operands = Output.GetOperands(instruction_id);
+            switch (instruction.Kind)
+            {
+                case InstructionKind::PHI:
+                {
+                    // Only operands for edges that can execute contribute.
+                    LatticeValue merged_value;
+                    for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+                    {
+                        bool edge_executable = ExecutableEdges.contains(GetEdgeKey(block.Predecessors[operand_index], instruction.Block));
+                        if (!edge_executable)
+                        {
+                            continue;
+                        }
+
+                        // An undefined value may be assumed to equal whatever the phi's other operands are.
+                        ValueId operand = operands[operand_index];
+                        if (InstructionKind::UNDEFINED == Output.Values[operand].Kind)
+                        {
+                            continue;
+                        }
+                        merged_value = Meet(merged_value, Lattice[operand]);
+                    }
+                    UpdateValue(instruction_id, merged_value);
+                    break;
+                }
+                case InstructionKind::JUMP:
+                    EdgeWorklist.emplace_back(instruction.Block, block.Successors[0]);
+                    break;
+                case InstructionKind::BRANCH:
+                {
+                    const LatticeValue& condition = Lattice[operands[0]];
+                    if (LatticeState::CONSTANT == condition.State)
+                    {
+                        BlockId taken_block = (0 != condition.Constant) ? block.Successors[0] : block.Successors[1];
+                        EdgeWorklist.emplace_back(instruction.Block, taken_block);
+                    }
+                    else if (LatticeState::VARYING == condition.State)
+                    {
+                        EdgeWorklist.emplace_back(instruction.Block, block.Successors[0]);
+                        EdgeWorklist.emplace_back(instruction.Block, block.Successors[1]);
+                    }
+                    break;
+                }
+                case InstructionKind::RETURN:
+                case InstructionKind::STORE:
+                    break;
+                default:
+                {
+                    bool foldable = (IsBinaryOperation(instruction.Kind) || IsComparison(instruction.Kind) || IsConversion(instruction.Kind) ||
+                        InstructionKind::NEGATE == instruction.Kind || InstructionKind::NOT == instruction.Kind);
+                    if (!foldable)
+                    {
+                        // Parameters, memory, and calls can't be known at compile time.
+                        UpdateValue(instruction_id, LatticeValue { .State = LatticeState::VARYING });
+                        break;
+                    }
+                    UpdateValue(instruction_id, EvaluateOperation(instruction_id));
+                    break;
+                }
+            }
+        }
+
+        /// Evaluates an arithmetic, comparison, or conversion instruction.
+        /// @param[in] instruction_id - The instruction.
+        /// @return What's known about the instruction's value.
+        LatticeValue EvaluateOperation(const INTERMEDIATE_REPRESENTATION::ValueId instruction_id) const
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            const Instruction& instruction = Output.Values[instruction_id];
+            std::span<const ValueId> operands = Output.GetOperands(instruction_id);
+
+            // Multiplying or masking by zero gives zero even if the other operand varies.
+            bool absorbs_zero = ((InstructionKind::MULTIPLY == instruction.Kind || InstructionKind::AND == instruction.Kind) && ValueType::PTR != instruction.Type);
+            if (absorbs_zero)
+            {
+                for (const ValueId operand : operands)
+                {
+                    if (LatticeState::CONSTANT == Lattice[operand].State && 0 == Lattice[operand].Constant)
+                    {
+                        return LatticeValue { .State = LatticeState::CONSTANT, .Constant = 0 };
+                    }
+                }
+            }
+
+            // FOLD CONSTANT OPERANDS.
+            std::int64_t operand_values[2] = {};
+            for (std::size_t operand_index = 0; operand_index < operands.size(); ++operand_index)
+            {
+                const LatticeValue& operand_value = Lattice[operands[operand_index]];
+                if (LatticeState::CONSTANT != operand_value.State)
+                {
+                    return LatticeValue { .State = operand_value.State };
+                }
+                operand_values[operand_index] = operand_value.Constant;
+            }
+            std::optional<std::int64_t> folded_value = ConstantFolder::Fold(
+                instruction.Kind,
+                instruction.Type,
+                Output.Values[operands[0]].Type,
+                std::span<const std::int64_t>(operand_values, operands.size()));
+            if (!folded_value)
+            {
+                return LatticeValue { .State = LatticeState::VARYING };
+            }
+            return LatticeValue { .State = LatticeState::CONSTANT, .Constant = *folded_value };
+        }
+
+        /// Combines what's known about two values that may reach the same point.
+        /// @param[in] left - One value.
+        /// @param[in] right - The other value.
+        /// @return What's known about the combination.
+        static LatticeValue Meet(const LatticeValue& left, const LatticeValue& right)
+        {
+            if (LatticeState::UNKNOWN == left.State)
+            {
+                return right;
+            }
+            if (LatticeState::UNKNOWN == right.State)
+            {
+                return left;
+            }
+            bool same_constant = (LatticeState::CONSTANT == left.State && LatticeState::CONSTANT == right.State && left.Constant == right.Constant);
+            return same_constant ? left : LatticeValue { .State = LatticeState::VARYING };
+        }
+
+        /// Updates what's known about a value, queuing its users if it changed.
+        /// Values only ever move down the lattice, which bounds how often each is revisited.
+        /// @param[in] value - The value.
+        /// @param[in] new_value - What's now known about it.
+        void UpdateValue(const INTERMEDIATE_REPRESENTATION::ValueId value, const LatticeValue& new_value)
+        {
+            LatticeValue& old_value = Lattice[value];
+            bool changed = (old_value.State != new_value.State || old_value.Constant != new_value.Constant);
+            if (!changed || LatticeState::VARYING == old_value.State || LatticeState::UNKNOWN == new_value.State)
+            {
+                return;
+            }
+            old_value = (LatticeState::CONSTANT == old_value.State && LatticeState::CONSTANT == new_value.State) ?
+                LatticeValue { .State = LatticeState::VARYING } :
+                new_value;
+            ValueWorklist.push_back(value);
+        }
+
+        /// Replaces constant values and simplifies constant branches.
+        /// @return The number of changes made.
+        std::size_t Rewrite()
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            std::size_t change_count = 0;
+            for (BlockId block_id = 0; block_id < Output.Blocks.size(); ++block_id)
+            {
+                if (!ExecutableBlocks[block_id])
+                {
+                    continue;
+                }
+
+                // REPLACE CONSTANT VALUES.
+                // The block's instruction list is copied since replaced instructions are removed from it.
+                std::vector<ValueId> block_instructions = Output.Blocks[block_id].Instructions;
+                for (const ValueId instruction_id : block_instructions)
+                {
+                    const Instruction& instruction = Output.Values[instruction_id];
+                    bool replaceable = (LatticeState::CONSTANT == Lattice[instruction_id].State && !HasSideEffects(instruction.Kind));
+                    if (!replaceable)
+                    {
+                        continue;
+                    }
+                    ValueId constant = Output.GetConstant(instruction.Type, Lattice[instruction_id].Constant);
+                    Output.ReplaceAllUsesWith(instruction_id, constant);
+                    Output.RemoveInstruction(instruction_id);
+                    ++change_count;
+                }
+
+                // REPLACE BRANCHES THAT ONLY GO ONE WAY WITH JUMPS.
+                ValueId terminator = Output.GetTerminator(block_id);
+                if (InstructionKind::BRANCH != Output.Values[terminator].Kind)
+                {
+                    continue;
+                }
+                std::vector<BlockId> successors = Output.Blocks[block_id].Successors;
+                bool first_taken = ExecutableEdges.contains(GetEdgeKey(block_id, successors[0]));
+                bool second_taken = ExecutableEdges.contains(GetEdgeKey(block_id, successors[1]));
+                bool branch_needed = (first_taken && second_taken) || successors[0] == successors[1];
+                if (branch_needed)
+                {
+                    continue;
+                }
+                BlockId untaken_block = first_taken ? successors[1] : successors[0];
+                Output.RemoveInstruction(terminator);
+                Output.RemoveEdge(block_id, untaken_block);
+                Output.AppendInstruction(block_id, InstructionKind::JUMP, ValueType::VOID, {});
+                ++change_count;
+            }
+            return change_count;
+        }
+
+        /// Gets the key for an edge between blocks.
+        /// @param[in] from_block_id - The block the edge leaves.
+        /// @param[in] to_block_id - The block the edge enters.
+        /// @return The key.
+        static std::uint64_t GetEdgeKey(const INTERMEDIATE_REPRESENTATION::BlockId from_block_id, const INTERMEDIATE_REPRESENTATION::BlockId to_block_id)
+        {
+            return (static_cast<std::uint64_t>(from_block_id) << 32) | to_block_id;
+        }
+
+        /// The function being optimized.
+        INTERMEDIATE_REPRESENTATION::Function& Output;
+        /// What's known about each value, indexed by value ID.
+        std::vector<LatticeValue> Lattice = {};
+        /// Whether each block has been found to execute.
+        std::vector<bool> ExecutableBlocks = {};
+        /// The edges found to execute.
+        std::unordered_set<std::uint64_t> ExecutableEdges = {};
+        /// Edges found to execute but not yet processed.
+        std::vector<std::pair<INTERMEDIATE_REPRESENTATION::BlockId, INTERMEDIATE_REPRESENTATION::BlockId>> EdgeWorklist = {};
+        /// Values whose state changed but whose users haven't been revisited.
+        std::vector<INTERMEDIATE_REPRESENTATION::ValueId> ValueWorklist = {};
+    };
+}
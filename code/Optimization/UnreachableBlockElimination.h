@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "IntermediateRepresentation/Function.h"
+
+namespace OPTIMIZATION
+{
+    /// Removes blocks that can't be reached from the entry block, such as code
+    /// after a return or the untaken side of a branch on a constant.
+    ///
+    /// Remaining blocks are renumbered to keep block IDs dense, preserving
+    /// their order, so later passes can keep using arrays indexed by block.
+    struct UnreachableBlockElimination
+    {
+        /// Runs the pass on a function.
+        /// @param[in,out] function - The function to optimize.
+        /// @return The number of blocks removed.
+        static std::size_t Run(INTERMEDIATE_REPRESENTATION::Function& function)
+        {
+            using namespace INTERMEDIATE_REPRESENTATION;
+
+            // FIND THE REACHABLE BLOCKS.
+            std::vector<bool> reachable_blocks(function.Blocks.size(), false);
+            std::vector<BlockId> worklist = { Function::ENTRY_BLOCK_ID };
+            reachable_blocks[Function::ENTRY_BLOCK_ID] = true;
+            std::size_t reachable_block_count = 1;
+            while (!worklist.empty())
+            {
+                BlockId block_id = worklist.back();
+                worklist.pop_back();
+                for (const BlockId successor : function.Blocks[block_id].Successors)
+                {
+                    if (!reachable_blocks[successor])
+                    {
+                        reachable_blocks[successor] = true;
+                        ++reachable_block_count;
+                        worklist.push_back(successor);
+                    }
+                }
+            }
+            std::size_t removed_block_count = function.Blocks.size() - reachable_block_count;
+            if (0 == removed_block_count)
+            {
+                return 0;
+            }
+
+            // DISCONNECT THE UNREACHABLE BLOCKS.
+            // Removing their edges removes the corresponding phi operands in reachable blocks.
+            // Nothing reachable can use their other values, since those values don't dominate any reachable code.
+            std::vector<BlockId> blocks_with_removed_predecessors;
+            for (BlockId block_id = 0; block_id < function.Blocks.size(); ++block_id)
+            {
+                if (reachable_blocks[block_id])
+                {
+                    continue;
+                }
+                std::vector<BlockId> successors = function.Blocks[block_id].Successors;
+                for (const BlockId successor : successors)
+                {
+                    function.RemoveEdge(block_id, successor);
+                    if (reachable_blocks[successor])
+                    {
+                        blocks_with_removed_predecessors.push_back(successor);
+                    }
+                }
+                for (const ValueId instruction_id : function.Blocks[block_id].Instructions)
+                {
+                    function.DeleteInstruction(instruction_id);
+                }
+            }
+
+            // REMOVE PHIS LEFT WITH A SINGLE PREDECESSOR.
+            for (const BlockId block_id : blocks_with_removed_predecessors)
+            {
+                std::vector<ValueId>& block_instructions = function.Blocks[block_id].Instructions;
+                while (!block_instructions.empty() && 1 == function.Blocks[block_id].Predecessors.size())
+                {
+                    ValueId phi = block_instructions.front();
+                    if (InstructionKind::PHI != function.Values[phi].Kind)
+                    {
+                        break;
+                    }
+                    function.ReplaceAllUsesWith(phi, function.GetOperand(phi, 0));
+                    function.RemoveInstruction(phi);
+                }
+            }
+
+            // RENUMBER THE REMAINING BLOCKS.
+            std::vector<BlockId> new_block_ids(function.Blocks.size(), INVALID_ID);
+            std::vector<BasicBlock> remaining_blocks;
+            remaining_blocks.reserve(reachable_block_count);
+            for (BlockId block_id = 0; block_id < function.Blocks.size(); ++block_id)
+            {
+                if (reachable_blocks[block_id])
+                {
+                    new_block_ids[block_id] = static_cast<BlockId>(remaining_blocks.size());
+                    remaining_blocks.push_back(std::move(function.Blocks[block_id]));
+                }
+            }
+            for (BlockId block_id = 0; block_id < remaining_blocks.size(); ++block_id)
+            {
+                BasicBlock& block = remaining_blocks[block_id];
+                for (const ValueId instruction_id : block.Instructions)
+                {
+                    function.Values[instruction_id].Block = block_id;
+                }
+                for (BlockId& predecessor : block.Predecessors)
+                {
+                    predecessor = new_block_ids[predecessor];
+                }
+                for (BlockId& successor : block.Successors)
+                {
+                    successor = new_block_ids[successor];
+                }
+            }
+            function.Blocks = std::move(remaining_blocks);
+            return removed_block_count;
+        }
+    };
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+#include "CustomString.h"
+#include "Tokenization/Token.h"
+
+namespace PREPROCESSING
+{
+    /// Evaluates integer constant expressions for #if and #elif directives.
+    /// Any "defined" operators and macros must already have been replaced,
+    /// so any remaining identifiers evaluate to 0 as the C standard requires.
+    struct ConstantExpressionEvaluator
+    {
+        /// Evaluates an expression.
+        /// @param[in] tokens - The tokens of the expression.
+        /// @return The value of the expression, if valid; null otherwise.
+        static std::optional<std::int64_t> Evaluate(const std::vector<TOKENIZATION::Token>& tokens)
+        {
+            ConstantExpressionEvaluator evaluator = { .Tokens = tokens };
+            std::optional<std::int64_t> value = evaluator.EvaluateBinary(0);
+            bool all_tokens_used = (evaluator.CurrentIndex == tokens.size());
+            if (!value || !all_tokens_used)
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        /// The tokens of the expression.
+        const std::vector<TOKENIZATION::Token>& Tokens;
+        /// The index of the next token to evaluate.
+        std::size_t CurrentIndex = 0;
+
+    private:
+        /// The precedence of a binary operator.
+        /// @param[in] binary_operator - The operator.
+        /// @return The precedence (higher binds tighter), or 0 if the token isn't a binary operator.
+        static int GetPrecedence(const std::string& binary_operator)
+        {
+            if ("||" == binary_operator) return 1;
+            if ("&&" == binary_operator) return 2;
+            if ("|" == binary_operator) return 3;
+            if ("^" == binary_operator) return 4;
+            if ("&" == binary_operator) return 5;
+            if ("==" == binary_operator || "!=" == binary_operator) return 6;
+            if ("<" == binary_operator || ">" == binary_operator || "<=" == binary_operator || ">=" == binary_operator) return 7;
+            if ("<<" == binary_operator || ">>" == binary_operator) return 8;
+            if ("+" == binary_operator || "-" == binary_operator) return 9;
+            if ("*" == binary_operator || "/" == binary_operator || "%" == binary_operator) return 10;
+            return 0;
+        }
+
+        /// Evaluates binary operators at or above a precedence using precedence climbing.
+        /// @param[in] minimum_precedence - The lowest precedence of operators to consume.
+        /// @return The value, if valid; null otherwise.
+        std::optional<std::int64_t> EvaluateBinary(const int minimum_precedence)
+        {
+            std::optional<std::int64_t> left_value = EvaluateUnary();
+            while (left_value && CurrentIndex < Tokens.size())
+            {
+                // CHECK FOR ANOTHER OPERATOR THAT SHOULD BE APPLIED NOW.
+                const std::string& binary_operator = Tokens[CurrentIndex].Value;
+                int precedence = GetPrecedence(binary_operator);
+                bool operator_applies = (precedence > 0 && precedence > minimum_precedence);
+                if (!operator_applies)
+                {
+                    break;
+                }
+                ++CurrentIndex;
+
+                // EVALUATE THE RIGHT SIDE.
+                // All operators are left-associative, so the right side only includes tighter-binding operators.
+                std::optional<std::int64_t> right_value = EvaluateBinary(precedence);
+                if (!right_value)
+                {
+                    return std::nullopt;
+                }
+
+                left_value = Apply(binary_operator, *left_value, *right_value);
+            }
+
+            return left_value;
+        }
+
+        /// Applies a binary operator.
+        /// @param[in] binary_operator - The operator.
+        /// @param[in] left_value - The left operand.
+        /// @param[in] right_value - The right operand.
+        /// @return The result, if valid; null otherwise (such as for division by zero).
+        static std::optional<std::int64_t> Apply(const std::string& binary_operator, const std::int64_t left_value, const std::int64_t right_value)
+        {
+            if ("||" == binary_operator) return (left_value || right_value) ? 1 : 0;
+            if ("&&" == binary_operator) return (left_value && right_value) ? 1 : 0;
+            if ("|" == binary_operator) return left_value | right_value;
+            if ("^" == binary_operator) return left_value ^ right_value;
+            if ("&" == binary_operator) return left_value & right_value;
+            if ("==" == binary_operator) return (left_value == right_value) ? 1 : 0;
+            if ("!=" == binary_operator) return (left_value != right_value) ? 1 : 0;
+            if ("<" == binary_operator) return (left_value < right_value) ? 1 : 0;
+            if (">" == binary_operator) return (left_value > right_value) ? 1 : 0;
+            if ("<=" == binary_operator) return (left_value <= right_value) ? 1 : 0;
+            if (">=" == binary_operator) return (left_value >= right_value) ? 1 : 0;
+            if ("<<" == binary_operator) return static_cast<std::int64_t>(static_cast<std::uint64_t>(left_value) << (right_value & 63));
+            if (">>" == binary_operator) return left_value >> (right_value & 63);
+            if ("+" == binary_operator) return static_cast<std::int64_t>(static_cast<std::uint64_t>(left_value) + static_cast<std::uint64_t>(right_value));
+            if ("-" == binary_operator) return static_cast<std::int64_t>(static_cast<std::uint64_t>(left_value) - static_cast<std::uint64_t>(right_value));
+            if ("*" == binary_operator) return static_cast<std::int64_t>(static_cast<std::uint64_t>(left_value) * static_cast<std::uint64_t>(right_value));
+
+            bool division_valid = (0 != right_value && !(INT64_MIN == left_value && -1 == right_value));
+            if (!division_valid)
+            {
+                return std::nullopt;
+            }
+            if ("/" == binary_operator) return left_value / right_value;
+            if ("%" == binary_operator) return left_value % right_value;
+            return std::nullopt;
+        }
+
+        /// Evaluates a unary operator or primary expression.
+        /// @return The value, if valid; null otherwise.
+        std::optional<std::int64_t> EvaluateUnary()
+        {
+            using namespace TOKENIZATION;
+
+            if (CurrentIndex >= Tokens.size())
+            {
+                return std::nullopt;
+            }
+            const Token& token = Tokens[CurrentIndex];
+            ++CurrentIndex;
+
+            // EVALUATE UNARY OPERATORS.
+            bool is_unary_operator = ("!" == token.Value || "-" == token.Value || "+" == token.Value || "~" == token.Value);
+            if (is_unary_operator)
+            {
+                std::optional<std::int64_t> operand = EvaluateUnary();
+                if (!operand)
+                {
+                    return std::nullopt;
+                }
+                if ("!" == token.Value) return *operand ? 0 : 1;
+                if ("-" == token.Value) return static_cast<std::int64_t>(0 - static_cast<std::uint64_t>(*operand));
+                if ("~" == token.Value) return ~*operand;
+                return operand;
+            }
+
+            // EVALUATE PARENTHESIZED EXPRESSIONS.
+            if (TokenType::OPENING_PARENTHESIS == token.Type)
+            {
+                std::optional<std::int64_t> value = EvaluateBinary(0);
+                bool closed = (CurrentIndex < Tokens.size() && TokenType::CLOSING_PARENTHESIS == Tokens[CurrentIndex].Type);
+                if (!value || !closed)
+                {
+                    return std::nullopt;
+                }
+                ++CurrentIndex;
+                return value;
+            }
+
+            // EVALUATE CHARACTER CONSTANTS.
+            // Only simple characters and escapes are supported.
+            if (TokenType::CONSTANT == token.Type && token.Value.starts_with('\''))
+            {
+                if (token.Value.length() < 3)
+                {
+                    return std::nullopt;
+                }
+                bool is_escape = ('\\' == token.Value[1]);
+                if (!is_escape)
+                {
+                    return static_cast<unsigned char>(token.Value[1]);
+                }
+                switch (token.Value[2])
+                {
+                    case 'n': return '\n';
+                    case 't': return '\t';
+                    case 'r': return '\r';
+                    case '0': return 0;
+                    default: return static_cast<unsigned char>(token.Value[2]);
+                }
+            }
+
+            // EVALUATE NUMBERS.
+            if (TokenType::CONSTANT == token.Type)
+            {
+                return static_cast<std::int64_t>(std::strtoull(token.Value.c_str(), nullptr, 0));
+            }
+
+            // EVALUATE REMAINING IDENTIFIERS.
+            // Keywords are included since they're just identifiers to the preprocessor.
+            bool is_word = !token.Value.empty() && String::IsIdentifierCharacter(token.Value.front());
+            if (is_word)
+            {
+                return 0;
+            }
+
+            return std::nullopt;
+        }
+    };
+}
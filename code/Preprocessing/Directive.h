@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CustomString.h"
+#include "Tokenization/Token.h"
+#include "Tokenization/Tokenizer.cpp"
+
+namespace PREPROCESSING
+{
+    /// The different kinds of preprocessor directives.
+    enum class DirectiveKind
+    {
+        /// A directive that isn't recognized.
+        UNKNOWN = 0,
+        /// A "#" alone on a line, which has no effect.
+        EMPTY,
+        INCLUDE,
+        DEFINE,
+        UNDEF,
+        IF,
+        IFDEF,
+        IFNDEF,
+        ELIF,
+        ELSE,
+        ENDIF,
+        /// "#pragma once".
+        PRAGMA_ONCE,
+        /// Any other pragma, which is ignored.
+        PRAGMA,
+        ERROR,
+        WARNING,
+        LINE,
+    };
+
+    /// A preprocessor directive parsed from a PREPROCESSOR_DIRECTIVE token.
+    /// Directives are parsed once when a file is lexed so that files included
+    /// many times don't need their directives re-parsed.
+    struct Directive
+    {
+        /// Parses a directive.
+        /// @param[in] directive_token - The token for the entire directive line.
+        /// @param[in] token_index - The index of the token within its file.
+        /// @return The parsed directive.
+        static Directive Parse(const TOKENIZATION::Token& directive_token, const std::size_t token_index)
+        {
+            using namespace TOKENIZATION;
+
+            Directive directive = { .TokenIndex = token_index, .Source = directive_token };
+
+            // REMOVE LINE CONTINUATIONS.
+            // The leading '#' is also skipped so that it isn't mistaken for another directive.
+            std::string text;
+            const std::string& raw_text = directive_token.Value;
+            for (std::size_t character_index = 1; character_index < raw_text.length(); ++character_index)
+            {
+                bool is_line_continuation = ('\\' == raw_text[character_index] && character_index + 1 < raw_text.length() &&
+                    ('\n' == raw_text[character_index + 1] || '\r' == raw_text[character_index + 1]));
+                if (is_line_continuation)
+                {
+                    text += ' ';
+                    while (character_index + 1 < raw_text.length() && ('\n' == raw_text[character_index + 1] || '\r' == raw_text[character_index + 1]))
+                    {
+                        ++character_index;
+                    }
+                    continue;
+                }
+                text += raw_text[character_index];
+            }
+
+            // READ THE DIRECTIVE NAME.
+            std::size_t name_start_index = SkipWhitespace(text, 0);
+            std::size_t name_end_index = name_start_index;
+            while (name_end_index < text.length() && String::IsIdentifierCharacter(text[name_end_index]))
+            {
+                ++name_end_index;
+            }
+            std::string_view name = std::string_view(text).substr(name_start_index, name_end_index - name_start_index);
+            std::string arguments_text = text.substr(name_end_index);
+
+            // TOKENIZE ANY ARGUMENTS.
+            // Comments aren't meaningful within directives.
+            TokenStream argument_token_stream = Tokenizer::Tokenize(arguments_text);
+            for (Token& token : argument_token_stream.Tokens)
+            {
+                if (TokenType::COMMENT != token.Type)
+                {
+                    token.Filepath = directive_token.Filepath;
+                    token.LineNumber = directive_token.LineNumber;
+                    directive.ArgumentTokens.push_back(std::move(token));
+                }
+            }
+
+            // IDENTIFY THE KIND OF DIRECTIVE.
+            if (name.empty())
+            {
+                bool only_whitespace = (SkipWhitespace(arguments_text, 0) >= arguments_text.length() || directive.ArgumentTokens.empty());
+                directive.Kind = only_whitespace ? DirectiveKind::EMPTY : DirectiveKind::UNKNOWN;
+            }
+            else if ("include" == name)
+            {
+                directive.Kind = DirectiveKind::INCLUDE;
+                ParseIncludeTarget(arguments_text, directive);
+            }
+            else if ("define" == name)
+            {
+                directive.Kind = DirectiveKind::DEFINE;
+                directive.Name = FirstIdentifier(directive.ArgumentTokens);
+            }
+            else if ("undef" == name)
+            {
+                directive.Kind = DirectiveKind::UNDEF;
+                directive.Name = FirstIdentifier(directive.ArgumentTokens);
+            }
+            else if ("if" == name)
+            {
+                directive.Kind = DirectiveKind::IF;
+            }
+            else if ("ifdef" == name)
+            {
+                directive.Kind = DirectiveKind::IFDEF;
+                directive.Name = FirstIdentifier(directive.ArgumentTokens);
+            }
+            else if ("ifndef" == name)
+            {
+                directive.Kind = DirectiveKind::IFNDEF;
+                directive.Name = FirstIdentifier(directive.ArgumentTokens);
+            }
+            else if ("elif" == name)
+            {
+                directive.Kind = DirectiveKind::ELIF;
+            }
+            else if ("else" == name)
+            {
+                directive.Kind = DirectiveKind::ELSE;
+            }
+            else if ("endif" == name)
+            {
+                directive.Kind = DirectiveKind::ENDIF;
+            }
+            else if ("pragma" == name)
+            {
+                bool is_pragma_once = (1 == directive.ArgumentTokens.size() && "once" == directive.ArgumentTokens.front().Value);
+                directive.Kind = is_pragma_once ? DirectiveKind::PRAGMA_ONCE : DirectiveKind::PRAGMA;
+            }
+            else if ("error" == name)
+            {
+                directive.Kind = DirectiveKind::ERROR;
+                directive.Name = arguments_text.substr(SkipWhitespace(arguments_text, 0));
+            }
+            else if ("warning" == name)
+            {
+                directive.Kind = DirectiveKind::WARNING;
+                directive.Name = arguments_text.substr(SkipWhitespace(arguments_text, 0));
+            }
+            else if ("line" == name)
+            {
+                directive.Kind = DirectiveKind::LINE;
+            }
+            else
+            {
+                directive.Kind = DirectiveKind::UNKNOWN;
+                directive.Name = name;
+            }
+
+            return directive;
+        }
+
+        /// Determines if the directive begins a conditional section.
+        /// @return True if the directive is #if, #ifdef, or #ifndef; false otherwise.
+        bool StartsConditional() const
+        {
+            bool starts_conditional = (DirectiveKind::IF == Kind || DirectiveKind::IFDEF == Kind || DirectiveKind::IFNDEF == Kind);
+            return starts_conditional;
+        }
+
+        /// The kind of directive.
+        DirectiveKind Kind = DirectiveKind::UNKNOWN;
+        /// The primary operand of the directive:  the macro name for #define, #undef, #ifdef, and #ifndef,
+        /// the file for #include, the message for #error and #warning, or the name of an unknown directive.
+        std::string Name = "";
+        /// True if an included file was specified in angle brackets rather than quotes.
+        bool IsAngleBracketInclude = false;
+        /// Tokens following the directive name (such as the expression for #if).
+        std::vector<TOKENIZATION::Token> ArgumentTokens = {};
+        /// The index of the directive's token within its file.
+        std::size_t TokenIndex = 0;
+        /// The original directive token, for reporting errors.
+        TOKENIZATION::Token Source = {};
+
+    private:
+        /// Finds the next non-whitespace character.
+        /// @param[in] text - The text to search.
+        /// @param[in] start_index - The index to start searching from.
+        /// @return The index of the next non-whitespace character, or the length of the text if there is none.
+        static std::size_t SkipWhitespace(const std::string& text, std::size_t start_index)
+        {
+            while (start_index < text.length() && (' ' == text[start_index] || '\t' == text[start_index]))
+            {
+                ++start_index;
+            }
+            return start_index;
+        }
+
+        /// Gets the value of the first token if it's an identifier-like word.
+        /// @param[in] tokens - The tokens to check.
+        /// @return The first token's value if it's a word; empty otherwise.
+        static std::string FirstIdentifier(const std::vector<TOKENIZATION::Token>& tokens)
+        {
+            // Keywords are also accepted since any word may be used as a macro name.
+            bool first_token_is_word = !tokens.empty() && !tokens.front().Value.empty() && String::IsIdentifierCharacter(tokens.front().Value.front());
+            if (!first_token_is_word)
+            {
+                return "";
+            }
+            return tokens.front().Value;
+        }
+
+        /// Parses the file for an #include directive.
+        /// The raw text is used rather than tokens since file names in angle
+        /// brackets don't follow normal tokenization rules.
+        /// @param[in] arguments_text - The text following the directive name.
+        /// @param[in,out] directive - The directive to fill in.
+        static void ParseIncludeTarget(const std::string& arguments_text, Directive& directive)
+        {
+            std::size_t opening_delimiter_index = SkipWhitespace(arguments_text, 0);
+            if (opening_delimiter_index >= arguments_text.length())
+            {
+                return;
+            }
+
+            char opening_delimiter = arguments_text[opening_delimiter_index];
+            char closing_delimiter = ('<' == opening_delimiter) ? '>' : '"';
+            bool valid_opening_delimiter = ('<' == opening_delimiter || '"' == opening_delimiter);
+            std::size_t closing_delimiter_index = arguments_text.find(closing_delimiter, opening_delimiter_index + 1);
+            if (!valid_opening_delimiter || std::string::npos == closing_delimiter_index)
+            {
+                return;
+            }
+
+            directive.IsAngleBracketInclude = ('<' == opening_delimiter);
+            directive.Name = arguments_text.substr(opening_delimiter_index + 1, closing_delimiter_index - opening_delimiter_index - 1);
+        }
+    };
+}
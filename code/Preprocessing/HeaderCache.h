@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "Caching/ContentHash.h"
+#include "Files/File.h"
+#include "Preprocessing/Directive.h"
+#include "Preprocessing/SourceFile.h"
+
+namespace PREPROCESSING
+{
+    /// Caches lexed header files, include resolution, and the hashes of included
+    /// files' contents for a single run of the compiler, so that headers shared by
+    /// many translation units are read, lexed, and hashed only once.  All methods
+    /// are safe to call from multiple threads at once.
+    struct HeaderCache
+    {
+        /// Creates an empty cache.
+        /// @param[in] include_directories - Directories searched for included files, in order.
+        explicit HeaderCache(const std::vector<std::filesystem::path>& include_directories) :
+            IncludeDirectories(include_directories)
+        {}
+
+        /// Finds the file for an #include directive.
+        /// Quoted includes are first searched for relative to the including file,
+        /// then in the include directories.  Angle bracket includes are only
+        /// searched for in the include directories.
+        /// @param[in] directive - The #include directive.
+        /// @param[in] including_directory - The directory of the file containing the directive.
+        /// @return The canonical path of the included file, if found; null otherwise.
+        std::optional<std::filesystem::path> ResolveInclude(const Directive& directive, const std::filesystem::path& including_directory)
+        {
+            // CHECK FOR A PREVIOUS RESOLUTION.
+            // Angle bracket includes don't depend on the including directory.
+            std::string key = directive.IsAngleBracketInclude ? ("<" + directive.Name) : (including_directory.string() + "\"" + directive.Name);
+            {
+                std::lock_guard<std::mutex> lock(ResolvedIncludesMutex);
+                auto resolved_include = ResolvedIncludes.find(key);
+                if (ResolvedIncludes.end() != resolved_include)
+                {
+                    return resolved_include->second;
+                }
+            }
+
+            // SEARCH FOR THE FILE.
+            std::vector<std::filesystem::path> search_directories;
+            if (!directive.IsAngleBracketInclude)
+            {
+                search_directories.push_back(including_directory);
+            }
+            search_directories.insert(search_directories.end(), IncludeDirectories.begin(), IncludeDirectories.end());
+
+            std::optional<std::filesystem::path> included_filepath;
+            for (const std::filesystem::path& search_directory : search_directories)
+            {
+                std::error_code error;
+                std::filesystem::path candidate_filepath = search_directory / directive.Name;
+                if (std::filesystem::is_regular_file(candidate_filepath, error))
+                {
+                    // Canonical paths ensure the same file is always identified the same way.
+                    included_filepath = std::filesystem::weakly_canonical(candidate_filepath, error);
+                    break;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(ResolvedIncludesMutex);
+            ResolvedIncludes.emplace(key, included_filepath);
+            return included_filepath;
+        }
+
+        /// Gets a lexed file, reading and lexing it only if this is the first request for it.
+        /// If multiple threads request the same file at once, only one lexes it.
+        /// @param[in] filepath - The canonical path of the file.
+        /// @return The lexed file, if it could be read; null otherwise.
+        std::shared_ptr<const SourceFile> GetFile(const std::filesystem::path& filepath)
+        {
+            // CHECK IF THE FILE HAS ALREADY BEEN REQUESTED.
+            std::promise<std::shared_ptr<const SourceFile>> lexed_file_promise;
+            std::shared_future<std::shared_ptr<const SourceFile>> lexed_file;
+            bool file_newly_requested = false;
+            {
+                std::lock_guard<std::mutex> lock(FilesMutex);
+                auto [file, file_added] = FilesByPath.try_emplace(filepath.string());
+                if (file_added)
+                {
+                    file->second = lexed_file_promise.get_future().share();
+                    file_newly_requested = true;
+                }
+                lexed_file = file->second;
+            }
+
+            // LEX THE FILE IF NEEDED.
+            if (file_newly_requested)
+            {
+                std::shared_ptr<const SourceFile> source_file = nullptr;
+                std::optional<std::string> source_code = FILES::File::ReadText(filepath);
+                if (source_code)
+                {
+                    source_file = std::make_shared<const SourceFile>(SourceFile::Lex(filepath, *source_code));
+                }
+                lexed_file_promise.set_value(source_file);
+            }
+
+            return lexed_file.get();
+        }
+
+        /// Gets the hash of a file's current contents, reading the file only if this is the first request for it.
+        /// The file is read separately from lexing it, so that checking cached results against it
+        /// doesn't require lexing, and so that changes made after lexing are still noticed.
+        /// @param[in] filepath - The canonical path of the file.
+        /// @return The hash of the file's contents, if it could be read; null otherwise.
+        std::optional<std::uint64_t> GetContentHash(const std::filesystem::path& filepath)
+        {
+            // CHECK IF THE FILE HAS ALREADY BEEN HASHED.
+            std::promise<std::optional<std::uint64_t>> content_hash_promise;
+            std::shared_future<std::optional<std::uint64_t>> content_hash;
+            bool file_newly_requested = false;
+            {
+                std::lock_guard<std::mutex> lock(ContentHashesMutex);
+                auto [file_content_hash, file_added] = ContentHashesByPath.try_emplace(filepath.string());
+                if (file_added)
+                {
+                    file_content_hash->second = content_hash_promise.get_future().share();
+                    file_newly_requested = true;
+                }
+                content_hash = file_content_hash->second;
+            }
+
+            // HASH THE FILE IF NEEDED.
+            if (file_newly_requested)
+            {
+                std::optional<std::uint64_t> new_content_hash;
+                std::optional<std::string> contents = FILES::File::ReadText(filepath);
+                if (contents)
+                {
+                    new_content_hash = CACHING::ContentHash::Compute(*contents);
+                }
+                content_hash_promise.set_value(new_content_hash);
+            }
+
+            return content_hash.get();
+        }
+
+        /// Directories searched for included files, in order.
+        const std::vector<std::filesystem::path> IncludeDirectories;
+
+    private:
+        /// Guards access to resolved includes.
+        std::mutex ResolvedIncludesMutex = {};
+        /// Included files by directory and name, or null for files that couldn't be found.
+        std::unordered_map<std::string, std::optional<std::filesystem::path>> ResolvedIncludes = {};
+        /// Guards access to lexed files.
+        std::mutex FilesMutex = {};
+        /// Lexed files by path.  Futures allow threads to wait on a file another thread is lexing.
+        std::unordered_map<std::string, std::shared_future<std::shared_ptr<const SourceFile>>> FilesByPath = {};
+        /// Guards access to content hashes.
+        std::mutex ContentHashesMutex = {};
+        /// Hashes of files' contents by path, or null for files that couldn't be read.
+        std::unordered_map<std::string, std::shared_future<std::optional<std::uint64_t>>> ContentHashesByPath = {};
+    };
+}
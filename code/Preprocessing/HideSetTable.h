@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PREPROCESSING
+{
+    /// Identifies an interned hide set.  0 is always the empty set.
+    using HideSetId = std::uint32_t;
+
+    /// Interns the hide sets used during macro expansion.
+    ///
+    /// Each token produced by expanding a macro carries the set of macros
+    /// that must not be expanded again for that token (preventing infinite
+    /// recursion).  Rather than giving every token its own set of names,
+    /// each distinct set is stored once as a bitset over macro indices and
+    /// tokens only carry a 32-bit ID.  Since expansion repeatedly performs
+    /// the same few operations on the same few sets, results of operations
+    /// are memoized so that they typically cost a single hash lookup.
+    struct HideSetTable
+    {
+        /// The ID of the empty hide set.
+        static constexpr HideSetId EMPTY = 0;
+
+        /// Creates a table containing only the empty set.
+        HideSetTable()
+        {
+            Intern({});
+        }
+
+        /// Checks if a hide set contains a macro.
+        /// @param[in] hide_set - The hide set.
+        /// @param[in] macro_index - The index of the macro.
+        /// @return True if the macro is in the set; false otherwise.
+        bool Contains(const HideSetId hide_set, const std::uint32_t macro_index) const
+        {
+            const std::vector<std::uint64_t>& words = SetsById[hide_set];
+            std::size_t word_index = macro_index / BITS_PER_WORD;
+            if (word_index >= words.size())
+            {
+                return false;
+            }
+            bool contains = (words[word_index] >> (macro_index % BITS_PER_WORD)) & 1;
+            return contains;
+        }
+
+        /// Adds a macro to a hide set.
+        /// @param[in] hide_set - The hide set.
+        /// @param[in] macro_index - The index of the macro to add.
+        /// @return The hide set with the macro added.
+        HideSetId Add(const HideSetId hide_set, const std::uint32_t macro_index)
+        {
+            if (Contains(hide_set, macro_index))
+            {
+                return hide_set;
+            }
+
+            std::uint64_t operation_key = (static_cast<std::uint64_t>(hide_set) << 32) | macro_index;
+            auto existing_result = AddResults.find(operation_key);
+            if (AddResults.end() != existing_result)
+            {
+                return existing_result->second;
+            }
+
+            std::vector<std::uint64_t> words = SetsById[hide_set];
+            std::size_t word_index = macro_index / BITS_PER_WORD;
+            if (word_index >= words.size())
+            {
+                words.resize(word_index + 1, 0);
+            }
+            words[word_index] |= (std::uint64_t(1) << (macro_index % BITS_PER_WORD));
+
+            HideSetId result = Intern(std::move(words));
+            AddResults.emplace(operation_key, result);
+            return result;
+        }
+
+        /// Computes the union of two hide sets.
+        /// @param[in] left - One hide set.
+        /// @param[in] right - The other hide set.
+        /// @return The union.
+        HideSetId Union(const HideSetId left, const HideSetId right)
+        {
+            if (left == right || EMPTY == right)
+            {
+                return left;
+            }
+            if (EMPTY == left)
+            {
+                return right;
+            }
+
+            return Combine(UnionResults, left, right, [](const std::uint64_t left_word, const std::uint64_t right_word) { return left_word | right_word; });
+        }
+
+        /// Computes the intersection of two hide sets.
+        /// @param[in] left - One hide set.
+        /// @param[in] right - The other hide set.
+        /// @return The intersection.
+        HideSetId Intersection(const HideSetId left, const HideSetId right)
+        {
+            if (left == right)
+            {
+                return left;
+            }
+            if (EMPTY == left || EMPTY == right)
+            {
+                return EMPTY;
+            }
+
+            return Combine(IntersectionResults, left, right, [](const std::uint64_t left_word, const std::uint64_t right_word) { return left_word & right_word; });
+        }
+
+        /// Gets the number of distinct hide sets.
+        /// @return The number of hide sets.
+        std::size_t Count() const
+        {
+            return SetsById.size();
+        }
+
+    private:
+        /// The number of macros represented by each word of a bitset.
+        static constexpr std::uint32_t BITS_PER_WORD = 64;
+
+        /// Gets the ID for a set, adding it to the table if needed.
+        /// @param[in] words - The bitset words of the set.  Trailing zero words are removed
+        ///     so that each set has exactly one representation.
+        /// @return The ID of the set.
+        HideSetId Intern(std::vector<std::uint64_t> words)
+        {
+            while (!words.empty() && 0 == words.back())
+            {
+                words.pop_back();
+            }
+
+            std::string key(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint64_t));
+            auto [existing_set, set_added] = IdsBySet.try_emplace(std::move(key), static_cast<HideSetId>(SetsById.size()));
+            if (set_added)
+            {
+                SetsById.push_back(std::move(words));
+            }
+            return existing_set->second;
+        }
+
+        /// Combines two sets word-by-word, memoizing the result.
+        /// @param[in,out] results - Previous results of the same operation.
+        /// @param[in] left - One hide set.
+        /// @param[in] right - The other hide set.
+        /// @param[in] combine_words - Combines corresponding words of the sets.
+        /// @return The combined set.
+        template <typename CombineWordsFunction>
+        HideSetId Combine(
+            std::unordered_map<std::uint64_t, HideSetId>& results,
+            HideSetId left,
+            HideSetId right,
+            const CombineWordsFunction& combine_words)
+        {
+            // Both operations are commutative, so operands are ordered to improve memoization.
+            if (left > right)
+            {
+                std::swap(left, right);
+            }
+            std::uint64_t operation_key = (static_cast<std::uint64_t>(left) << 32) | right;
+            auto existing_result = results.find(operation_key);
+            if (results.end() != existing_result)
+            {
+                return existing_result->second;
+            }
+
+            const std::vector<std::uint64_t>& left_words = SetsById[left];
+            const std::vector<std::uint64_t>& right_words = SetsById[right];
+            std::vector<std::uint64_t> words(std::max(left_words.size(), right_words.size()), 0);
+            for (std::size_t word_index = 0; word_index < words.size(); ++word_index)
+            {
+                std::uint64_t left_word = (word_index < left_words.size()) ? left_words[word_index] : 0;
+                std::uint64_t right_word = (word_index < right_words.size()) ? right_words[word_index] : 0;
+                words[word_index] = combine_words(left_word, right_word);
+            }
+
+            HideSetId result = Intern(std::move(words));
+            results.emplace(operation_key, result);
+            return result;
+        }
+
+        /// The bitset words of each set, by ID.
+        std::vector<std::vector<std::uint64_t>> SetsById = {};
+        /// The IDs of sets by the bytes of their bitset words.
+        std::unordered_map<std::string, HideSetId> IdsBySet = {};
+        /// Memoized results of adding macros to sets.
+        std::unordered_map<std::uint64_t, HideSetId> AddResults = {};
+        /// Memoized results of unions.
+        std::unordered_map<std::uint64_t, HideSetId> UnionResults = {};
+        /// Memoized results of intersections.
+        std::unordered_map<std::uint64_t, HideSetId> IntersectionResults = {};
+    };
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include "Preprocessing/HeaderCache.h"
+
+namespace PREPROCESSING
+{
+    /// A file included while preprocessing a translation unit.
+    /// Recording the contents each file had when it was included allows
+    /// cached results for a translation unit to be checked for staleness.
+    struct IncludedFile
+    {
+        /// Determines if the file still has the same contents.
+        /// @param[in,out] header_cache - The cache of included files, so each file is only read once per run.
+        /// @return True if the file is unchanged; false if it changed or can't be read.
+        bool IsUnchanged(HeaderCache& header_cache) const
+        {
+            std::optional<std::uint64_t> current_content_hash = header_cache.GetContentHash(Filepath);
+            bool unchanged = (current_content_hash && ContentHash == *current_content_hash);
+            return unchanged;
+        }
+
+        /// The canonical path of the file.
+        std::filesystem::path Filepath = "";
+        /// The hash of the file's contents when it was included.
+        std::uint64_t ContentHash = 0;
+    };
+}
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CustomString.h"
+#include "Preprocessing/HideSetTable.h"
+#include "Preprocessing/MacroTable.h"
+#include "Tokenization/Token.h"
+#include "Tokenization/Tokenizer.cpp"
+
+namespace PREPROCESSING
+{
+    /// A token being macro-expanded, along with the macros that may not be expanded for it.
+    struct MacroToken
+    {
+        /// The token.
+        TOKENIZATION::Token Token = {};
+        /// The macros that produced the token, which must not be expanded again for it.
+        HideSetId HideSet = HideSetTable::EMPTY;
+    };
+
+    /// Expands macros in tokens.
+    ///
+    /// Expansion follows Prosser's algorithm, where each token carries a hide
+    /// set of the macros that produced it.  A replacement is rescanned by itself,
+    /// and anything that can't be finished without later tokens (such as the name
+    /// of a function-like macro at the very end) is handed back to be rescanned
+    /// with what follows.  Tokens are written directly to the final output
+    /// rather than copied up through each level of nesting, so the work done is
+    /// linear in the size of the output.
+    ///
+    /// Expansions of macros without arguments that appear directly in source
+    /// code are memoized until any macro definition changes, since such
+    /// macros are typically expanded many times with identical results.
+    struct MacroExpander
+    {
+        /// Creates an expander.
+        /// @param[in] macros - The macros to expand.  Must outlive the expander.
+        explicit MacroExpander(const MacroTable& macros) :
+            Macros(macros)
+        {}
+
+        /// Expands all macros in tokens.
+        /// @param[in] tokens - The tokens to expand.
+        /// @param[in,out] output - The vector to append expanded tokens to.
+        void Expand(const std::vector<TOKENIZATION::Token>& tokens, std::vector<TOKENIZATION::Token>& output)
+        {
+            // Pending tokens are stored in reverse order so that the next token can be cheaply removed from the end.
+            std::vector<MacroToken> pending_tokens;
+            pending_tokens.reserve(tokens.size());
+            for (auto token = tokens.rbegin(); token != tokens.rend(); ++token)
+            {
+                pending_tokens.push_back(MacroToken { .Token = *token });
+            }
+
+            std::vector<MacroToken> expanded_tokens;
+            ExpandPendingTokens(pending_tokens, expanded_tokens, false);
+            output.reserve(output.size() + expanded_tokens.size());
+            for (MacroToken& expanded_token : expanded_tokens)
+            {
+                output.push_back(std::move(expanded_token.Token));
+            }
+        }
+
+        /// Any errors from expansion, one per line.
+        std::string Messages = "";
+        /// True if any error has occurred.
+        bool ErrorOccurred = false;
+        /// The number of times a memoized expansion was reused.
+        std::size_t MemoizedExpansionCount = 0;
+
+    private:
+        /// A memoized expansion of a macro without arguments.
+        struct MemoizedExpansion
+        {
+            /// The fully expanded tokens.
+            std::vector<MacroToken> ExpandedTokens = {};
+            /// Tokens at the end of the expansion that depend on what follows.
+            std::vector<MacroToken> OpenTokens = {};
+        };
+
+        /// Expands pending tokens.
+        /// @param[in,out] pending_tokens - The tokens to expand, in reverse order.
+        /// @param[in,out] output - The vector to append fully expanded tokens to.
+        /// @param[in] allow_open_tokens - True if an expansion that needs tokens after the end
+        ///     of the pending tokens should stop, leaving the remaining tokens pending
+        ///     (in reverse order); false if such expansions should be treated as complete.
+        void ExpandPendingTokens(std::vector<MacroToken>& pending_tokens, std::vector<MacroToken>& output, const bool allow_open_tokens)
+        {
+            using namespace TOKENIZATION;
+
+            while (!pending_tokens.empty())
+            {
+                MacroToken token = std::move(pending_tokens.back());
+                pending_tokens.pop_back();
+
+                // CHECK IF THE TOKEN IS A MACRO THAT CAN BE EXPANDED.
+                std::optional<std::uint32_t> macro_index;
+                bool is_word = !token.Token.Value.empty() && String::IsIdentifierCharacter(token.Token.Value.front()) && TokenType::CONSTANT != token.Token.Type;
+                if (is_word)
+                {
+                    macro_index = Macros.FindIndex(token.Token.Value);
+                }
+                const MacroDefinition* macro = macro_index ? Macros.GetByIndex(*macro_index) : nullptr;
+                bool expandable = macro && !HideSets.Contains(token.HideSet, *macro_index);
+                if (!expandable)
+                {
+                    output.push_back(std::move(token));
+                    continue;
+                }
+
+                // EXPAND OBJECT-LIKE MACROS.
+                std::vector<MacroToken> open_tokens;
+                if (!macro->FunctionLike)
+                {
+                    HideSetId hide_set = HideSets.Add(token.HideSet, *macro_index);
+                    ExpandInvocation(*macro, *macro_index, token, hide_set, {}, output, open_tokens);
+                    PushPendingTokens(open_tokens, pending_tokens);
+                    continue;
+                }
+
+                // CHECK FOR AN INVOCATION OF A FUNCTION-LIKE MACRO.
+                // Without a following parenthesis, the name is just an identifier.
+                std::size_t next_token_index = pending_tokens.size();
+                while (next_token_index > 0 && TokenType::COMMENT == pending_tokens[next_token_index - 1].Token.Type)
+                {
+                    --next_token_index;
+                }
+                bool next_token_exists = (next_token_index > 0);
+                if (!next_token_exists && allow_open_tokens)
+                {
+                    pending_tokens.push_back(std::move(token));
+                    return;
+                }
+                bool is_invocation = next_token_exists && TokenType::OPENING_PARENTHESIS == pending_tokens[next_token_index - 1].Token.Type;
+                if (!is_invocation)
+                {
+                    output.push_back(std::move(token));
+                    continue;
+                }
+
+                // COLLECT THE ARGUMENTS.
+                std::vector<MacroToken> consumed_tokens;
+                std::vector<std::vector<MacroToken>> arguments;
+                std::optional<HideSetId> closing_parenthesis_hide_set = CollectArguments(*macro, pending_tokens, consumed_tokens, arguments);
+                if (!closing_parenthesis_hide_set)
+                {
+                    if (allow_open_tokens)
+                    {
+                        // The invocation may be completed by tokens that follow, so everything is left pending.
+                        PushPendingTokens(consumed_tokens, pending_tokens);
+                        pending_tokens.push_back(std::move(token));
+                        return;
+                    }
+
+                    AddError(token.Token, "Unterminated invocation of macro " + macro->Name + ".");
+                    output.push_back(std::move(token));
+                    output.insert(output.end(), consumed_tokens.begin(), consumed_tokens.end());
+                    continue;
+                }
+                if (!CheckArgumentCount(*macro, token.Token, arguments))
+                {
+                    output.push_back(std::move(token));
+                    output.insert(output.end(), consumed_tokens.begin(), consumed_tokens.end());
+                    continue;
+                }
+
+                // EXPAND THE FUNCTION-LIKE MACRO.
+                HideSetId hide_set = HideSets.Add(HideSets.Intersection(token.HideSet, *closing_parenthesis_hide_set), *macro_index);
+                ExpandInvocation(*macro, *macro_index, token, hide_set, arguments, output, open_tokens);
+                PushPendingTokens(open_tokens, pending_tokens);
+            }
+        }
+
+        /// Expands a single invocation of a macro.
+        /// @param[in] macro - The macro.
+        /// @param[in] macro_index - The index of the macro.
+        /// @param[in] invocation_token - The name of the macro where it was invoked.
+        /// @param[in] hide_set - The hide set for the replacement tokens.
+        /// @param[in] arguments - The arguments for function-like macros.
+        /// @param[in,out] output - The vector to append fully expanded tokens to.
+        /// @param[out] open_tokens - Tokens at the end of the replacement that must be
+        ///     rescanned along with tokens following the invocation, in order.
+        void ExpandInvocation(
+            const MacroDefinition& macro,
+            const std::uint32_t macro_index,
+            const MacroToken& invocation_token,
+            const HideSetId hide_set,
+            const std::vector<std::vector<MacroToken>>& arguments,
+            std::vector<MacroToken>& output,
+            std::vector<MacroToken>& open_tokens)
+        {
+            // CHECK FOR A MEMOIZED EXPANSION.
+            // Only macros without arguments that appear directly in source code are memoized.  Their
+            // expansion depends only on the current macro definitions, and limiting memoization to
+            // the outermost level keeps memory for nested expansions linear in the output size.
+            bool memoizable = (arguments.empty() && HideSetTable::EMPTY == invocation_token.HideSet);
+            if (memoizable)
+            {
+                if (MemoizedExpansionsGeneration != Macros.Generation)
+                {
+                    MemoizedExpansionsByMacroIndex.clear();
+                    MemoizedExpansionsGeneration = Macros.Generation;
+                }
+
+                auto memoized_expansion = MemoizedExpansionsByMacroIndex.find(macro_index);
+                if (MemoizedExpansionsByMacroIndex.end() != memoized_expansion)
+                {
+                    ++MemoizedExpansionCount;
+                    std::size_t first_output_index = output.size();
+                    output.insert(output.end(), memoized_expansion->second.ExpandedTokens.begin(), memoized_expansion->second.ExpandedTokens.end());
+                    SetPositions(output, first_output_index, invocation_token.Token);
+                    open_tokens = memoized_expansion->second.OpenTokens;
+                    SetPositions(open_tokens, 0, invocation_token.Token);
+                    return;
+                }
+            }
+
+            // SUBSTITUTE ARGUMENTS INTO THE REPLACEMENT LIST.
+            std::vector<MacroToken> replacement_tokens = Substitute(macro, arguments, invocation_token.Token);
+            for (MacroToken& replacement_token : replacement_tokens)
+            {
+                replacement_token.HideSet = HideSets.Union(replacement_token.HideSet, hide_set);
+            }
+            SetPositions(replacement_tokens, 0, invocation_token.Token);
+
+            // RESCAN THE REPLACEMENT.
+            std::vector<MacroToken> pending_tokens(replacement_tokens.rbegin(), replacement_tokens.rend());
+            std::size_t first_output_index = output.size();
+            ExpandPendingTokens(pending_tokens, output, true);
+            open_tokens.assign(pending_tokens.rbegin(), pending_tokens.rend());
+
+            // MEMOIZE THE EXPANSION IF POSSIBLE.
+            if (memoizable)
+            {
+                MemoizedExpansionsByMacroIndex.emplace(macro_index, MemoizedExpansion
+                {
+                    .ExpandedTokens = std::vector<MacroToken>(output.begin() + first_output_index, output.end()),
+                    .OpenTokens = open_tokens,
+                });
+            }
+        }
+
+        /// Collects the arguments for an invocation of a function-like macro.
+        /// @param[in] macro - The macro.
+        /// @param[in,out] pending_tokens - Pending tokens, starting with the opening parenthesis (in reverse order).
+        /// @param[out] consumed_tokens - All tokens consumed, in order.
+        /// @param[out] arguments - The tokens of each argument.
+        /// @return The hide set of the closing parenthesis, if found; null otherwise.
+        std::optional<HideSetId> CollectArguments(
+            const MacroDefinition& macro,
+            std::vector<MacroToken>& pending_tokens,
+            std::vector<MacroToken>& consumed_tokens,
+            std::vector<std::vector<MacroToken>>& arguments)
+        {
+            using namespace TOKENIZATION;
+
+            std::size_t parenthesis_depth = 0;
+            arguments.emplace_back();
+            while (!pending_tokens.empty())
+            {
+                MacroToken token = std::move(pending_tokens.back());
+                pending_tokens.pop_back();
+                consumed_tokens.push_back(token);
+
+                // Comments act as whitespace within invocations.
+                if (TokenType::COMMENT == token.Token.Type)
+                {
+                    continue;
+                }
+
+                if (TokenType::OPENING_PARENTHESIS == token.Token.Type)
+                {
+                    ++parenthesis_depth;
+                    if (1 == parenthesis_depth)
+                    {
+                        continue;
+                    }
+                }
+                else if (TokenType::CLOSING_PARENTHESIS == token.Token.Type)
+                {
+                    --parenthesis_depth;
+                    if (0 == parenthesis_depth)
+                    {
+                        return token.HideSet;
+                    }
+                }
+                else if ("," == token.Token.Value && 1 == parenthesis_depth)
+                {
+                    // Commas within the variable arguments are part of them.
+                    bool in_variable_arguments = (macro.Variadic && arguments.size() == macro.ParameterNames.size());
+                    if (!in_variable_arguments)
+                    {
+                        arguments.emplace_back();
+                        continue;
+                    }
+                }
+
+                arguments.back().push_back(std::move(token));
+            }
+
+            return std::nullopt;
+        }
+
+        /// Checks that the number of arguments matches a macro's parameters.
+        /// @param[in] macro - The macro.
+        /// @param[in] invocation_token - The name of the macro where it was invoked.
+        /// @param[in,out] arguments - The arguments.  An empty argument list for a macro
+        ///     without parameters is converted to no arguments.
+        /// @return True if the number of arguments is valid; false otherwise.
+        bool CheckArgumentCount(const MacroDefinition& macro, const TOKENIZATION::Token& invocation_token, std::vector<std::vector<MacroToken>>& arguments)
+        {
+            // A macro without parameters is invoked with a single empty argument.
+            if (macro.ParameterNames.empty() && 1 == arguments.size() && arguments.front().empty())
+            {
+                arguments.clear();
+            }
+            // Variable arguments may be omitted entirely.
+            if (macro.Variadic && arguments.size() + 1 == macro.ParameterNames.size())
+            {
+                arguments.emplace_back();
+            }
+
+            if (arguments.size() != macro.ParameterNames.size())
+            {
+                AddError(
+                    invocation_token,
+                    "Macro " + macro.Name + " expects " + std::to_string(macro.ParameterNames.size()) +
+                    " arguments but was given " + std::to_string(arguments.size()) + ".");
+                return false;
+            }
+            return true;
+        }
+
+        /// Substitutes arguments into a macro's replacement list, applying the '#' and '##' operators.
+        /// @param[in] macro - The macro.
+        /// @param[in] arguments - The arguments for the macro's parameters.
+        /// @param[in] invocation_token - The name of the macro where it was invoked.
+        /// @return The tokens to rescan.
+        std::vector<MacroToken> Substitute(
+            const MacroDefinition& macro,
+            const std::vector<std::vector<MacroToken>>& arguments,
+            const TOKENIZATION::Token& invocation_token)
+        {
+            using namespace TOKENIZATION;
+
+            std::vector<MacroToken> substituted_tokens;
+            std::vector<std::optional<std::vector<MacroToken>>> expanded_arguments(arguments.size());
+            const std::vector<Token>& replacement_tokens = macro.ReplacementTokens;
+            for (std::size_t token_index = 0; token_index < replacement_tokens.size(); ++token_index)
+            {
+                const Token& replacement_token = replacement_tokens[token_index];
+                std::optional<std::size_t> parameter_index = macro.FindParameter(replacement_token.Value);
+
+                // STRINGIZE ARGUMENTS.
+                if (macro.FunctionLike && "#" == replacement_token.Value && token_index + 1 < replacement_tokens.size())
+                {
+                    std::optional<std::size_t> stringized_parameter_index = macro.FindParameter(replacement_tokens[token_index + 1].Value);
+                    if (stringized_parameter_index)
+                    {
+                        substituted_tokens.push_back(MacroToken { .Token = Stringize(arguments[*stringized_parameter_index]) });
+                        ++token_index;
+                        continue;
+                    }
+                }
+
+                // PASTE TOKENS.
+                if ("##" == replacement_token.Value && token_index + 1 < replacement_tokens.size())
+                {
+                    ++token_index;
+                    const Token& right_token = replacement_tokens[token_index];
+                    std::optional<std::size_t> right_parameter_index = macro.FindParameter(right_token.Value);
+                    std::vector<MacroToken> right_tokens;
+                    if (right_parameter_index)
+                    {
+                        right_tokens = arguments[*right_parameter_index];
+                    }
+                    else
+                    {
+                        right_tokens.push_back(MacroToken { .Token = right_token });
+                    }
+                    Paste(substituted_tokens, right_tokens, invocation_token);
+                    continue;
+                }
+
+                // SUBSTITUTE PARAMETERS.
+                // Arguments are fully expanded first, unless they are operands of '##'.
+                if (parameter_index)
+                {
+                    bool pasted = (token_index + 1 < replacement_tokens.size() && "##" == replacement_tokens[token_index + 1].Value);
+                    if (pasted)
+                    {
+                        const std::vector<MacroToken>& argument = arguments[*parameter_index];
+                        substituted_tokens.insert(substituted_tokens.end(), argument.begin(), argument.end());
+                        if (argument.empty())
+                        {
+                            substituted_tokens.push_back(CreatePlacemarker());
+                        }
+                        continue;
+                    }
+
+                    std::optional<std::vector<MacroToken>>& expanded_argument = expanded_arguments[*parameter_index];
+                    if (!expanded_argument)
+                    {
+                        const std::vector<MacroToken>& argument = arguments[*parameter_index];
+                        std::vector<MacroToken> pending_tokens(argument.rbegin(), argument.rend());
+                        expanded_argument.emplace();
+                        ExpandPendingTokens(pending_tokens, *expanded_argument, false);
+                    }
+                    substituted_tokens.insert(substituted_tokens.end(), expanded_argument->begin(), expanded_argument->end());
+                    continue;
+                }
+
+                substituted_tokens.push_back(MacroToken { .Token = replacement_token });
+            }
+
+            // REMOVE PLACEMARKERS.
+            std::erase_if(substituted_tokens, [](const MacroToken& token) { return IsPlacemarker(token); });
+            return substituted_tokens;
+        }
+
+        /// Converts an argument to a string literal for the '#' operator.
+        /// @param[in] argument - The argument.
+        /// @return The string literal token.
+        static TOKENIZATION::Token Stringize(const std::vector<MacroToken>& argument)
+        {
+            using namespace TOKENIZATION;
+
+            std::string string_literal = "\"";
+            const Token* previous_token = nullptr;
+            for (const MacroToken& argument_token : argument)
+            {
+                const Token& token = argument_token.Token;
+                if (TokenType::COMMENT == token.Type)
+                {
+                    continue;
+                }
+
+                // SEPARATE TOKENS THAT WERE SEPARATED IN THE SOURCE.
+                if (previous_token)
+                {
+                    bool adjacent = (
+                        previous_token->LineNumber == token.LineNumber &&
+                        previous_token->ColumnNumber + previous_token->Value.length() == token.ColumnNumber);
+                    if (!adjacent)
+                    {
+                        string_literal += ' ';
+                    }
+                }
+
+                // ESCAPE QUOTES AND BACKSLASHES IN LITERALS.
+                bool is_literal = (TokenType::STRING_LITERAL == token.Type || token.Value.starts_with('\''));
+                for (char character : token.Value)
+                {
+                    if (is_literal && ('"' == character || '\\' == character))
+                    {
+                        string_literal += '\\';
+                    }
+                    string_literal += character;
+                }
+                previous_token = &token;
+            }
+            string_literal += '"';
+
+            Token string_literal_token =
+            {
+                .Type = TokenType::STRING_LITERAL,
+                .Value = string_literal,
+            };
+            return string_literal_token;
+        }
+
+        /// Pastes tokens onto the end of substituted tokens for the '##' operator.
+        /// @param[in,out] substituted_tokens - The tokens substituted so far.  The last one is the left operand.
+        /// @param[in] right_tokens - The right operand.  Only the first token is pasted.
+        /// @param[in] invocation_token - The name of the macro where it was invoked.
+        void Paste(std::vector<MacroToken>& substituted_tokens, const std::vector<MacroToken>& right_tokens, const TOKENIZATION::Token& invocation_token)
+        {
+            using namespace TOKENIZATION;
+
+            // HANDLE EMPTY OPERANDS.
+            // Pasting with an empty argument just leaves the other operand.
+            if (right_tokens.empty())
+            {
+                return;
+            }
+            if (substituted_tokens.empty() || IsPlacemarker(substituted_tokens.back()))
+            {
+                if (!substituted_tokens.empty())
+                {
+                    substituted_tokens.pop_back();
+                }
+                substituted_tokens.insert(substituted_tokens.end(), right_tokens.begin(), right_tokens.end());
+                return;
+            }
+
+            // FORM A NEW TOKEN FROM THE SPELLING OF BOTH OPERANDS.
+            MacroToken& left_token = substituted_tokens.back();
+            std::string pasted_spelling = left_token.Token.Value + right_tokens.front().Token.Value;
+            TokenStream pasted_tokens = Tokenizer::Tokenize(pasted_spelling);
+            bool valid_token = (1 == pasted_tokens.Tokens.size() && pasted_spelling == pasted_tokens.Tokens.front().Value);
+            if (valid_token)
+            {
+                left_token.Token.Type = pasted_tokens.Tokens.front().Type;
+                left_token.Token.Value = std::move(pasted_spelling);
+                left_token.HideSet = HideSetTable::EMPTY;
+            }
+            else
+            {
+                AddError(invocation_token, "Pasting \"" + left_token.Token.Value + "\" and \"" + right_tokens.front().Token.Value + "\" does not give a valid token.");
+                substituted_tokens.push_back(right_tokens.front());
+            }
+            substituted_tokens.insert(substituted_tokens.end(), right_tokens.begin() + 1, right_tokens.end());
+        }
+
+        /// Creates a placemarker, which stands in for an empty argument during pasting.
+        /// @return The placemarker token.
+        static MacroToken CreatePlacemarker()
+        {
+            return MacroToken { .Token = { .Type = TOKENIZATION::TokenType::INVALID } };
+        }
+
+        /// Determines if a token is a placemarker.
+        /// @param[in] token - The token to check.
+        /// @return True if the token is a placemarker; false otherwise.
+        static bool IsPlacemarker(const MacroToken& token)
+        {
+            return TOKENIZATION::TokenType::INVALID == token.Token.Type && token.Token.Value.empty();
+        }
+
+        /// Adds tokens to be scanned next.
+        /// @param[in] tokens - The tokens, in order.
+        /// @param[in,out] pending_tokens - The pending tokens (in reverse order).
+        static void PushPendingTokens(const std::vector<MacroToken>& tokens, std::vector<MacroToken>& pending_tokens)
+        {
+            pending_tokens.insert(pending_tokens.end(), tokens.rbegin(), tokens.rend());
+        }
+
+        /// Sets the position of tokens from a macro expansion to the invocation of the macro.
+        /// @param[in,out] tokens - The tokens.
+        /// @param[in] first_token_index - The index of the first token to update.
+        /// @param[in] invocation_token - The name of the macro where it was invoked.
+        static void SetPositions(std::vector<MacroToken>& tokens, const std::size_t first_token_index, const TOKENIZATION::Token& invocation_token)
+        {
+            for (std::size_t token_index = first_token_index; token_index < tokens.size(); ++token_index)
+            {
+                TOKENIZATION::Token& token = tokens[token_index].Token;
+                token.Filepath = invocation_token.Filepath;
+                token.LineNumber = invocation_token.LineNumber;
+                token.ColumnNumber = invocation_token.ColumnNumber;
+            }
+        }
+
+        /// Adds an error.
+        /// @param[in] token - The token the error is about.
+        /// @param[in] message - The error message.
+        void AddError(const TOKENIZATION::Token& token, const std::string& message)
+        {
+            Messages += token.Filepath + ":" + std::to_string(token.LineNumber) + ": error: " + message + "\n";
+            ErrorOccurred = true;
+        }
+
+        /// The macros to expand.
+        const MacroTable& Macros;
+        /// The hide sets of tokens.
+        HideSetTable HideSets = {};
+        /// The macro definition generation that memoized expansions are valid for.
+        std::uint64_t MemoizedExpansionsGeneration = 0;
+        /// Memoized expansions of macros without arguments, by macro index.
+        std::unordered_map<std::uint32_t, MemoizedExpansion> MemoizedExpansionsByMacroIndex = {};
+    };
+}
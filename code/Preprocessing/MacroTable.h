@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Preprocessing/Directive.h"
+#include "Tokenization/Token.h"
+
+namespace PREPROCESSING
+{
+    /// A macro defined with #define.
+    struct MacroDefinition
+    {
+        /// Parses a macro definition from a #define directive.
+        /// @param[in] directive - The #define directive.
+        /// @param[out] error_message - A description of any error.
+        /// @return The macro definition, if valid; null otherwise.
+        static std::optional<MacroDefinition> Parse(const Directive& directive, std::string& error_message)
+        {
+            using namespace TOKENIZATION;
+
+            const std::vector<Token>& tokens = directive.ArgumentTokens;
+            if (directive.Name.empty())
+            {
+                error_message = "Missing macro name in #define.";
+                return std::nullopt;
+            }
+            bool name_is_identifier = !std::isdigit(static_cast<unsigned char>(directive.Name.front()));
+            if (!name_is_identifier)
+            {
+                error_message = "Macro names must be identifiers.";
+                return std::nullopt;
+            }
+            MacroDefinition macro = { .Name = directive.Name };
+
+            // PARSE ANY PARAMETERS.
+            // A macro is only function-like if its parameter list immediately follows the
+            // name.  Otherwise, a parenthesis just starts the replacement list.
+            std::size_t replacement_start_index = 1;
+            const Token& name_token = tokens.front();
+            bool is_function_like = (
+                tokens.size() > 1 &&
+                TokenType::OPENING_PARENTHESIS == tokens[1].Type &&
+                name_token.ColumnNumber + name_token.Value.length() == tokens[1].ColumnNumber);
+            if (is_function_like)
+            {
+                macro.FunctionLike = true;
+                std::size_t token_index = 2;
+                bool parameters_closed = false;
+                bool parameter_expected = false;
+                for (; token_index < tokens.size(); ++token_index)
+                {
+                    const Token& token = tokens[token_index];
+                    if (TokenType::CLOSING_PARENTHESIS == token.Type && !parameter_expected)
+                    {
+                        parameters_closed = true;
+                        ++token_index;
+                        break;
+                    }
+
+                    bool parameter_allowed = (macro.ParameterNames.empty() || parameter_expected) && !macro.Variadic;
+                    if ("," == token.Value && !parameter_expected && !macro.ParameterNames.empty() && !macro.Variadic)
+                    {
+                        parameter_expected = true;
+                    }
+                    else if ("..." == token.Value && parameter_allowed)
+                    {
+                        macro.Variadic = true;
+                        macro.ParameterNames.push_back(VARIADIC_PARAMETER_NAME);
+                        parameter_expected = false;
+                    }
+                    else if (TokenType::IDENTIFIER == token.Type && parameter_allowed)
+                    {
+                        macro.ParameterNames.push_back(token.Value);
+                        parameter_expected = false;
+                    }
+                    else
+                    {
+                        error_message = "Invalid parameter list for macro " + macro.Name + ".";
+                        return std::nullopt;
+                    }
+                }
+
+                if (!parameters_closed)
+                {
+                    error_message = "Missing ')' in parameter list for macro " + macro.Name + ".";
+                    return std::nullopt;
+                }
+                replacement_start_index = token_index;
+            }
+
+            // STORE THE REPLACEMENT LIST.
+            macro.ReplacementTokens.assign(tokens.begin() + replacement_start_index, tokens.end());
+            bool paste_at_edge = !macro.ReplacementTokens.empty() &&
+                ("##" == macro.ReplacementTokens.front().Value || "##" == macro.ReplacementTokens.back().Value);
+            if (paste_at_edge)
+            {
+                error_message = "'##' cannot appear at either end of the replacement list for macro " + macro.Name + ".";
+                return std::nullopt;
+            }
+
+            return macro;
+        }
+
+        /// Finds a parameter by name.
+        /// @param[in] name - The name of the identifier.
+        /// @return The index of the parameter, if the name is a parameter; null otherwise.
+        std::optional<std::size_t> FindParameter(const std::string& name) const
+        {
+            for (std::size_t parameter_index = 0; parameter_index < ParameterNames.size(); ++parameter_index)
+            {
+                if (name == ParameterNames[parameter_index])
+                {
+                    return parameter_index;
+                }
+            }
+            return std::nullopt;
+        }
+
+        /// Determines if another definition is the same as this one.
+        /// Redefining a macro identically is allowed without any warning.
+        /// @param[in] other - The other definition.
+        /// @return True if the definitions are equivalent; false otherwise.
+        bool IsEquivalentTo(const MacroDefinition& other) const
+        {
+            if (FunctionLike != other.FunctionLike || Variadic != other.Variadic || ParameterNames != other.ParameterNames)
+            {
+                return false;
+            }
+            if (ReplacementTokens.size() != other.ReplacementTokens.size())
+            {
+                return false;
+            }
+            for (std::size_t token_index = 0; token_index < ReplacementTokens.size(); ++token_index)
+            {
+                if (ReplacementTokens[token_index].Value != other.ReplacementTokens[token_index].Value)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// The name used for the variable arguments of variadic macros.
+        static constexpr const char* VARIADIC_PARAMETER_NAME = "__VA_ARGS__";
+
+        /// The name of the macro.
+        std::string Name = "";
+        /// True if the macro takes arguments; false if it is object-like.
+        bool FunctionLike = false;
+        /// True if the macro takes variable arguments (the last parameter is __VA_ARGS__).
+        bool Variadic = false;
+        /// The names of the macro's parameters.
+        std::vector<std::string> ParameterNames = {};
+        /// The tokens the macro is replaced with.
+        std::vector<TOKENIZATION::Token> ReplacementTokens = {};
+    };
+
+    /// The macros defined at a point during preprocessing.
+    /// Each distinct macro name is assigned a small index the first time it's
+    /// defined, which is used to represent the macro in hide sets.  A generation
+    /// number changes whenever any definition changes, so results that depend
+    /// on the definitions can be invalidated.
+    struct MacroTable
+    {
+        /// Defines a macro, replacing any previous definition.
+        /// @param[in] macro - The macro to define.
+        /// @return True if a different definition of the macro was replaced; false otherwise.
+        bool Define(MacroDefinition macro)
+        {
+            std::uint32_t macro_index = GetOrAddIndex(macro.Name);
+            std::optional<MacroDefinition>& definition = DefinitionsByIndex[macro_index];
+            if (definition && definition->IsEquivalentTo(macro))
+            {
+                return false;
+            }
+
+            bool redefined = definition.has_value();
+            definition = std::move(macro);
+            ++Generation;
+            return redefined;
+        }
+
+        /// Removes any definition of a macro.
+        /// @param[in] name - The name of the macro.
+        void Undefine(const std::string& name)
+        {
+            auto macro_index = IndicesByName.find(name);
+            if (IndicesByName.end() == macro_index)
+            {
+                return;
+            }
+
+            std::optional<MacroDefinition>& definition = DefinitionsByIndex[macro_index->second];
+            if (definition)
+            {
+                definition.reset();
+                ++Generation;
+            }
+        }
+
+        /// Determines if a macro is defined.
+        /// @param[in] name - The name of the macro.
+        /// @return True if the macro is defined; false otherwise.
+        bool IsDefined(const std::string& name) const
+        {
+            return nullptr != Find(name);
+        }
+
+        /// Finds the definition of a macro.
+        /// @param[in] name - The name of the macro.
+        /// @return The definition, if the macro is defined; null otherwise.
+        const MacroDefinition* Find(const std::string& name) const
+        {
+            auto macro_index = IndicesByName.find(name);
+            if (IndicesByName.end() == macro_index)
+            {
+                return nullptr;
+            }
+
+            const std::optional<MacroDefinition>& definition = DefinitionsByIndex[macro_index->second];
+            return definition ? &*definition : nullptr;
+        }
+
+        /// Gets the index of a macro name.
+        /// @param[in] name - The name of the macro.
+        /// @return The index of the macro, if it has ever been defined; null otherwise.
+        std::optional<std::uint32_t> FindIndex(const std::string& name) const
+        {
+            auto macro_index = IndicesByName.find(name);
+            if (IndicesByName.end() == macro_index)
+            {
+                return std::nullopt;
+            }
+            return macro_index->second;
+        }
+
+        /// Gets a macro definition by index.
+        /// @param[in] macro_index - The index of the macro.
+        /// @return The definition, if the macro is currently defined; null otherwise.
+        const MacroDefinition* GetByIndex(const std::uint32_t macro_index) const
+        {
+            const std::optional<MacroDefinition>& definition = DefinitionsByIndex[macro_index];
+            return definition ? &*definition : nullptr;
+        }
+
+        /// Gets the number of macro names that have ever been defined.
+        /// @return The number of macro indices.
+        std::size_t IndexCount() const
+        {
+            return DefinitionsByIndex.size();
+        }
+
+        /// Changes whenever any macro definition changes.
+        std::uint64_t Generation = 0;
+
+    private:
+        /// Gets the index for a macro name, assigning a new one if needed.
+        /// @param[in] name - The name of the macro.
+        /// @return The index of the macro.
+        std::uint32_t GetOrAddIndex(const std::string& name)
+        {
+            auto [macro_index, index_added] = IndicesByName.try_emplace(name, static_cast<std::uint32_t>(DefinitionsByIndex.size()));
+            if (index_added)
+            {
+                DefinitionsByIndex.emplace_back();
+            }
+            return macro_index->second;
+        }
+
+        /// The indices of macros by name.
+        std::unordered_map<std::string, std::uint32_t> IndicesByName = {};
+        /// Macro definitions by index, or null for macros that are currently undefined.
+        std::vector<std::optional<MacroDefinition>> DefinitionsByIndex = {};
+    };
+}
@@ -0,0 +1,611 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+#include "Preprocessing/ConstantExpressionEvaluator.h"
+#include "Preprocessing/Directive.h"
+#include "Preprocessing/HeaderCache.h"
+#include "Preprocessing/IncludedFile.h"
+#include "Preprocessing/MacroExpander.h"
+#include "Preprocessing/MacroTable.h"
+#include "Preprocessing/SourceFile.h"
+#include "Tokenization/TokenStream.h"
+
+namespace PREPROCESSING
+{
+    /// The results of preprocessing a translation unit.
+    struct PreprocessedTranslationUnit
+    {
+        /// True if preprocessing succeeded; false if any errors occurred.
+        bool Succeeded = false;
+        /// The tokens to parse, with directives executed and inactive sections removed.
+        TOKENIZATION::TokenStream Tokens = {};
+        /// The files included by the translation unit, in the order first included.
+        std::vector<IncludedFile> IncludedFiles = {};
+        /// Any errors or warnings, one per line.
+        std::string Messages = "";
+        /// The number of leading tokens restored from a prefix header snapshot rather than preprocessed.
+        std::size_t PrefixTokenCount = 0;
+    };
+
+    /// The state of the preprocessor after processing a prefix header on its own.
+    /// Translation units that start by including the header can restore this
+    /// state instead of processing the header (and everything it includes) again.
+    struct PreprocessorSnapshot
+    {
+        /// The canonical path of the prefix header.
+        std::filesystem::path HeaderFilepath = "";
+        /// The macros defined after the header.
+        MacroTable Macros = {};
+        /// Files that contained an active "#pragma once".
+        std::vector<std::string> OnceOnlyFilepaths = {};
+        /// The files included, starting with the header itself.
+        std::vector<IncludedFile> IncludedFiles = {};
+        /// The preprocessed tokens of the header.
+        TOKENIZATION::TokenStream Tokens = {};
+        /// Any warnings from the header, one per line.
+        std::string Messages = "";
+    };
+
+    /// Executes preprocessor directives and expands macros for a translation
+    /// unit, producing the tokens to parse.  Included files come from a
+    /// HeaderCache so that they are only lexed once per run, and files with
+    /// include guards or "#pragma once" are skipped entirely when included again.
+    struct Preprocessor
+    {
+        /// The deepest that includes may be nested, to stop runaway recursive includes.
+        static constexpr std::size_t MAX_INCLUDE_DEPTH = 200;
+
+        /// Creates the macros predefined for every translation unit from command line definitions.
+        /// @param[in] definitions - Definitions in the form NAME or NAME=VALUE.  A macro without
+        ///     a value is defined as 1.
+        /// @param[out] error_messages - Descriptions of any invalid definitions, one per line.
+        /// @return The predefined macros.
+        static MacroTable CreatePredefinedMacros(const std::vector<std::string>& definitions, std::string& error_messages)
+        {
+            MacroTable macros;
+            for (const std::string& definition : definitions)
+            {
+                // CONVERT THE DEFINITION TO A #define DIRECTIVE.
+                std::size_t equals_index = definition.find('=');
+                std::string name = definition.substr(0, equals_index);
+                std::string value = (std::string::npos == equals_index) ? "1" : definition.substr(equals_index + 1);
+                std::string directive_text = "#define " + name + " " + value;
+
+                // PARSE THE DIRECTIVE.
+                TOKENIZATION::TokenStream directive_tokens = TOKENIZATION::Tokenizer::Tokenize(directive_text);
+                bool is_single_directive = (
+                    1 == directive_tokens.Tokens.size() &&
+                    TOKENIZATION::TokenType::PREPROCESSOR_DIRECTIVE == directive_tokens.Tokens.front().Type);
+                if (!is_single_directive)
+                {
+                    error_messages += "Invalid macro definition: " + definition + "\n";
+                    continue;
+                }
+                directive_tokens.Tokens.front().Filepath = "<command line>";
+                Directive directive = Directive::Parse(directive_tokens.Tokens.front(), 0);
+
+                std::string error_message;
+                std::optional<MacroDefinition> macro = MacroDefinition::Parse(directive, error_message);
+                if (!macro)
+                {
+                    error_messages += "Invalid macro definition: " + definition + " (" + error_message + ")\n";
+                    continue;
+                }
+                macros.Define(std::move(*macro));
+            }
+            return macros;
+        }
+
+        /// Preprocesses a prefix header on its own, as if it were the first file
+        /// included by a translation unit.
+        /// @param[in] header_filepath - The path of the header.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @param[in] predefined_macros - The macros defined before the translation unit starts.
+        /// @param[out] error_messages - Any errors or warnings, one per line.
+        /// @return The state after the header, if it was preprocessed without errors; null otherwise.
+        static std::optional<PreprocessorSnapshot> PreprocessPrefixHeader(
+            const std::filesystem::path& header_filepath,
+            HeaderCache& header_cache,
+            const MacroTable& predefined_macros,
+            std::string& error_messages)
+        {
+            // READ THE HEADER.
+            std::error_code error;
+            std::filesystem::path canonical_header_filepath = std::filesystem::weakly_canonical(header_filepath, error);
+            std::shared_ptr<const SourceFile> header_file = error ? nullptr : header_cache.GetFile(canonical_header_filepath);
+            if (!header_file)
+            {
+                error_messages += "Failed to read prefix header: " + header_filepath.string() + "\n";
+                return std::nullopt;
+            }
+
+            // PREPROCESS THE HEADER.
+            Preprocessor preprocessor(header_cache, predefined_macros);
+            preprocessor.IncludedFilepaths.insert(canonical_header_filepath.string());
+            preprocessor.Result.IncludedFiles.push_back(IncludedFile
+            {
+                .Filepath = canonical_header_filepath,
+                .ContentHash = header_file->ContentHash,
+            });
+            preprocessor.ProcessFile(*header_file);
+            if (preprocessor.ErrorOccurred)
+            {
+                error_messages += preprocessor.Result.Messages;
+                return std::nullopt;
+            }
+
+            // CAPTURE THE FINAL STATE.
+            PreprocessorSnapshot snapshot =
+            {
+                .HeaderFilepath = canonical_header_filepath,
+                .Macros = std::move(preprocessor.Macros),
+                .OnceOnlyFilepaths = std::vector<std::string>(preprocessor.OnceOnlyFilepaths.begin(), preprocessor.OnceOnlyFilepaths.end()),
+                .IncludedFiles = std::move(preprocessor.Result.IncludedFiles),
+                .Tokens = std::move(preprocessor.Result.Tokens),
+                .Messages = std::move(preprocessor.Result.Messages),
+            };
+            return snapshot;
+        }
+
+        /// Preprocesses a translation unit.
+        /// @param[in] main_file - The main source file of the translation unit.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @param[in] predefined_macros - The macros defined before the translation unit starts.
+        /// @param[in] prefix_snapshot - The state after a prefix header, if one was precompiled.
+        ///     Only used if the translation unit starts by including the header.
+        /// @return The preprocessed translation unit.
+        static PreprocessedTranslationUnit Preprocess(
+            const SourceFile& main_file,
+            HeaderCache& header_cache,
+            const MacroTable& predefined_macros,
+            const PreprocessorSnapshot* const prefix_snapshot)
+        {
+            Preprocessor preprocessor(header_cache, predefined_macros);
+            std::size_t first_token_index = 0;
+            if (prefix_snapshot)
+            {
+                first_token_index = preprocessor.RestorePrefixSnapshot(main_file, *prefix_snapshot);
+            }
+            preprocessor.ProcessFile(main_file, first_token_index);
+
+            preprocessor.Result.Succeeded = !preprocessor.ErrorOccurred;
+            return std::move(preprocessor.Result);
+        }
+
+    private:
+        /// The state of a single #if/#ifdef/#ifndef section.
+        struct Conditional
+        {
+            /// True if the code containing the whole section is active.
+            bool ParentActive = false;
+            /// True if a branch of the section has already been taken.
+            bool BranchTaken = false;
+            /// True if the current branch is active.
+            bool Active = false;
+            /// True if the #else of the section has been seen.
+            bool ElseSeen = false;
+        };
+
+        /// Creates a preprocessor for a single translation unit.
+        /// @param[in,out] header_cache - The cache of included files.
+        /// @param[in] predefined_macros - The macros defined before the translation unit starts.
+        explicit Preprocessor(HeaderCache& header_cache, const MacroTable& predefined_macros) :
+            Headers(header_cache),
+            Macros(predefined_macros),
+            Expander(Macros)
+        {}
+
+        /// Restores the state after a prefix header if a file starts by including it.
+        /// @param[in] main_file - The main source file of the translation unit.
+        /// @param[in] prefix_snapshot - The state after the prefix header.
+        /// @return The index of the first token in the file to process (after the
+        ///     #include of the header if the state was restored; 0 otherwise).
+        std::size_t RestorePrefixSnapshot(const SourceFile& main_file, const PreprocessorSnapshot& prefix_snapshot)
+        {
+            using namespace TOKENIZATION;
+
+            // FIND THE FIRST DIRECTIVE.
+            // Only comments may come before it.
+            const std::vector<Token>& tokens = main_file.Tokens.Tokens;
+            std::size_t directive_token_index = 0;
+            while (directive_token_index < tokens.size() && TokenType::COMMENT == tokens[directive_token_index].Type)
+            {
+                ++directive_token_index;
+            }
+            bool starts_with_directive = (directive_token_index < tokens.size() && TokenType::PREPROCESSOR_DIRECTIVE == tokens[directive_token_index].Type);
+            if (!starts_with_directive)
+            {
+                return 0;
+            }
+
+            // CHECK IF THE DIRECTIVE INCLUDES THE PREFIX HEADER.
+            const Directive& directive = main_file.Directives.front();
+            if (DirectiveKind::INCLUDE != directive.Kind)
+            {
+                return 0;
+            }
+            std::optional<std::filesystem::path> included_filepath = Headers.ResolveInclude(directive, main_file.Filepath.parent_path());
+            bool includes_prefix_header = (included_filepath && prefix_snapshot.HeaderFilepath == *included_filepath);
+            if (!includes_prefix_header)
+            {
+                return 0;
+            }
+
+            // RESTORE THE STATE AFTER THE HEADER.
+            Macros = prefix_snapshot.Macros;
+            OnceOnlyFilepaths.insert(prefix_snapshot.OnceOnlyFilepaths.begin(), prefix_snapshot.OnceOnlyFilepaths.end());
+            for (const IncludedFile& included_file : prefix_snapshot.IncludedFiles)
+            {
+                IncludedFilepaths.insert(included_file.Filepath.string());
+            }
+            Result.IncludedFiles = prefix_snapshot.IncludedFiles;
+            Result.Tokens.Tokens.assign(tokens.begin(), tokens.begin() + directive_token_index);
+            Result.Tokens.Tokens.insert(Result.Tokens.Tokens.end(), prefix_snapshot.Tokens.Tokens.begin(), prefix_snapshot.Tokens.Tokens.end());
+            Result.Messages = prefix_snapshot.Messages;
+            Result.PrefixTokenCount = Result.Tokens.Tokens.size();
+            return directive_token_index + 1;
+        }
+
+        /// Processes the tokens of a file.
+        /// @param[in] source_file - The file to process.
+        /// @param[in] first_token_index - The index of the first token to process.
+        void ProcessFile(const SourceFile& source_file, const std::size_t first_token_index = 0)
+        {
+            using namespace TOKENIZATION;
+
+            // SKIP ANY DIRECTIVES BEFORE THE FIRST TOKEN.
+            const std::vector<Token>& tokens = source_file.Tokens.Tokens;
+            std::size_t directive_index = 0;
+            for (std::size_t token_index = 0; token_index < first_token_index; ++token_index)
+            {
+                if (TokenType::PREPROCESSOR_DIRECTIVE == tokens[token_index].Type)
+                {
+                    ++directive_index;
+                }
+            }
+
+            // Text between directives is collected so that it can be macro-expanded together,
+            // since a macro invocation may span multiple lines (but not a directive).
+            std::vector<Conditional> conditionals;
+            std::vector<Token> text_tokens;
+            for (std::size_t token_index = first_token_index; token_index < tokens.size(); ++token_index)
+            {
+                const Token& token = tokens[token_index];
+                if (TokenType::PREPROCESSOR_DIRECTIVE == token.Type)
+                {
+                    ExpandText(text_tokens);
+                    const Directive& directive = source_file.Directives[directive_index];
+                    ++directive_index;
+                    ProcessDirective(directive, source_file, conditionals);
+                    continue;
+                }
+
+                bool active = conditionals.empty() || conditionals.back().Active;
+                if (active)
+                {
+                    text_tokens.push_back(token);
+                }
+            }
+            ExpandText(text_tokens);
+
+            if (!conditionals.empty())
+            {
+                AddError(source_file.Filepath.string(), tokens.empty() ? 0 : tokens.back().LineNumber, "Unterminated conditional directive.");
+            }
+        }
+
+        /// Expands macros in text and adds it to the preprocessed tokens.
+        /// @param[in,out] text_tokens - The tokens of the text.  Cleared afterwards.
+        void ExpandText(std::vector<TOKENIZATION::Token>& text_tokens)
+        {
+            if (text_tokens.empty())
+            {
+                return;
+            }
+
+            Expander.Expand(text_tokens, Result.Tokens.Tokens);
+            AddExpansionErrors();
+            text_tokens.clear();
+        }
+
+        /// Executes a single directive.
+        /// @param[in] directive - The directive.
+        /// @param[in] source_file - The file containing the directive.
+        /// @param[in,out] conditionals - The conditional sections open in the file.
+        void ProcessDirective(const Directive& directive, const SourceFile& source_file, std::vector<Conditional>& conditionals)
+        {
+            bool active = conditionals.empty() || conditionals.back().Active;
+            switch (directive.Kind)
+            {
+                case DirectiveKind::IF:
+                case DirectiveKind::IFDEF:
+                case DirectiveKind::IFNDEF:
+                {
+                    // Conditions inside inactive sections aren't evaluated since they may be invalid.
+                    bool condition_met = active && EvaluateCondition(directive);
+                    conditionals.push_back(Conditional
+                    {
+                        .ParentActive = active,
+                        .BranchTaken = condition_met,
+                        .Active = condition_met,
+                    });
+                    return;
+                }
+                case DirectiveKind::ELIF:
+                {
+                    if (conditionals.empty() || conditionals.back().ElseSeen)
+                    {
+                        AddError(directive, "#elif without matching #if.");
+                        return;
+                    }
+                    Conditional& conditional = conditionals.back();
+                    bool condition_met = conditional.ParentActive && !conditional.BranchTaken && EvaluateCondition(directive);
+                    conditional.Active = condition_met;
+                    conditional.BranchTaken = conditional.BranchTaken || condition_met;
+                    return;
+                }
+                case DirectiveKind::ELSE:
+                {
+                    if (conditionals.empty() || conditionals.back().ElseSeen)
+                    {
+                        AddError(directive, "#else without matching #if.");
+                        return;
+                    }
+                    Conditional& conditional = conditionals.back();
+                    conditional.Active = conditional.ParentActive && !conditional.BranchTaken;
+                    conditional.BranchTaken = true;
+                    conditional.ElseSeen = true;
+                    return;
+                }
+                case DirectiveKind::ENDIF:
+                {
+                    if (conditionals.empty())
+                    {
+                        AddError(directive, "#endif without matching #if.");
+                        return;
+                    }
+                    conditionals.pop_back();
+                    return;
+                }
+                default:
+                    break;
+            }
+
+            // Remaining directives only have an effect in active sections.
+            if (!active)
+            {
+                return;
+            }
+
+            switch (directive.Kind)
+            {
+                case DirectiveKind::INCLUDE:
+                    IncludeFile(directive, source_file);
+                    break;
+                case DirectiveKind::DEFINE:
+                {
+                    std::string error_message;
+                    std::optional<MacroDefinition> macro = MacroDefinition::Parse(directive, error_message);
+                    if (!macro)
+                    {
+                        AddError(directive, error_message);
+                        break;
+                    }
+                    bool redefined = Macros.Define(std::move(*macro));
+                    if (redefined)
+                    {
+                        AddMessage(directive.Source.Filepath, directive.Source.LineNumber, "warning: Macro " + directive.Name + " redefined.");
+                    }
+                    break;
+                }
+                case DirectiveKind::UNDEF:
+                    Macros.Undefine(directive.Name);
+                    break;
+                case DirectiveKind::PRAGMA_ONCE:
+                    OnceOnlyFilepaths.insert(source_file.Filepath.string());
+                    break;
+                case DirectiveKind::ERROR:
+                    AddError(directive, "#error " + directive.Name);
+                    break;
+                case DirectiveKind::WARNING:
+                    AddMessage(directive.Source.Filepath, directive.Source.LineNumber, "warning: #warning " + directive.Name);
+                    break;
+                case DirectiveKind::UNKNOWN:
+                    AddError(directive, "Unknown directive #" + directive.Name + ".");
+                    break;
+                default:
+                    // Other directives (such as other pragmas) have no effect.
+                    break;
+            }
+        }
+
+        /// Evaluates the condition of an #if, #ifdef, #ifndef, or #elif directive.
+        /// @param[in] directive - The directive.
+        /// @return True if the condition is met; false otherwise (including if it's invalid).
+        bool EvaluateCondition(const Directive& directive)
+        {
+            using namespace TOKENIZATION;
+
+            // CHECK SIMPLE CONDITIONS.
+            if (DirectiveKind::IFDEF == directive.Kind)
+            {
+                return Macros.IsDefined(directive.Name);
+            }
+            if (DirectiveKind::IFNDEF == directive.Kind)
+            {
+                return !Macros.IsDefined(directive.Name);
+            }
+
+            // REPLACE ANY "defined" OPERATORS.
+            std::vector<Token> expression_tokens;
+            const std::vector<Token>& tokens = directive.ArgumentTokens;
+            for (std::size_t token_index = 0; token_index < tokens.size(); ++token_index)
+            {
+                if ("defined" != tokens[token_index].Value)
+                {
+                    expression_tokens.push_back(tokens[token_index]);
+                    continue;
+                }
+
+                // FIND THE MACRO NAME.
+                // It may optionally be in parentheses.
+                bool parenthesized = (token_index + 3 < tokens.size() &&
+                    TokenType::OPENING_PARENTHESIS == tokens[token_index + 1].Type &&
+                    TokenType::CLOSING_PARENTHESIS == tokens[token_index + 3].Type);
+                std::size_t macro_name_index = parenthesized ? (token_index + 2) : (token_index + 1);
+                if (macro_name_index >= tokens.size())
+                {
+                    AddError(directive, "Missing macro name after \"defined\".");
+                    return false;
+                }
+
+                bool macro_defined = Macros.IsDefined(tokens[macro_name_index].Value);
+                expression_tokens.push_back(Token
+                {
+                    .Type = TokenType::CONSTANT,
+                    .Value = macro_defined ? "1" : "0",
+                });
+                token_index = parenthesized ? (token_index + 3) : macro_name_index;
+            }
+
+            // EXPAND ANY MACROS.
+            std::vector<Token> expanded_expression_tokens;
+            Expander.Expand(expression_tokens, expanded_expression_tokens);
+            AddExpansionErrors();
+            std::erase_if(expanded_expression_tokens, [](const Token& token) { return TokenType::COMMENT == token.Type; });
+
+            // EVALUATE THE EXPRESSION.
+            std::optional<std::int64_t> value = ConstantExpressionEvaluator::Evaluate(expanded_expression_tokens);
+            if (!value)
+            {
+                AddError(directive, "Invalid expression in conditional directive.");
+                return false;
+            }
+            return 0 != *value;
+        }
+
+        /// Includes a file.
+        /// @param[in] directive - The #include directive.
+        /// @param[in] source_file - The file containing the directive.
+        void IncludeFile(const Directive& directive, const SourceFile& source_file)
+        {
+            // FIND THE FILE.
+            if (directive.Name.empty())
+            {
+                AddError(directive, "Expected \"file\" or <file> after #include.");
+                return;
+            }
+            std::optional<std::filesystem::path> included_filepath = Headers.ResolveInclude(directive, source_file.Filepath.parent_path());
+            if (!included_filepath)
+            {
+                AddError(directive, "Included file not found: " + directive.Name);
+                return;
+            }
+
+            // SKIP FILES THAT SHOULD ONLY BE INCLUDED ONCE.
+            std::string included_filepath_string = included_filepath->string();
+            if (OnceOnlyFilepaths.contains(included_filepath_string))
+            {
+                return;
+            }
+            std::shared_ptr<const SourceFile> included_file = Headers.GetFile(*included_filepath);
+            if (!included_file)
+            {
+                AddError(directive, "Failed to read included file: " + included_filepath_string);
+                return;
+            }
+            bool guarded_file_already_included = (
+                !included_file->IncludeGuardMacroName.empty() &&
+                Macros.IsDefined(included_file->IncludeGuardMacroName));
+            if (guarded_file_already_included)
+            {
+                return;
+            }
+
+            // RECORD THE FILE AS A DEPENDENCY.
+            bool first_inclusion = IncludedFilepaths.insert(included_filepath_string).second;
+            if (first_inclusion)
+            {
+                Result.IncludedFiles.push_back(IncludedFile
+                {
+                    .Filepath = *included_filepath,
+                    .ContentHash = included_file->ContentHash,
+                });
+            }
+
+            // PROCESS THE FILE.
+            if (IncludeDepth >= MAX_INCLUDE_DEPTH)
+            {
+                AddError(directive, "Includes nested too deeply.");
+                return;
+            }
+            ++IncludeDepth;
+            ProcessFile(*included_file);
+            --IncludeDepth;
+        }
+
+        /// Adds a message.
+        /// @param[in] filepath - The file the message is about.
+        /// @param[in] line_number - The line the message is about.
+        /// @param[in] message - The message.
+        void AddMessage(const std::string& filepath, const std::size_t line_number, const std::string& message)
+        {
+            Result.Messages += filepath + ":" + std::to_string(line_number) + ": " + message + "\n";
+        }
+
+        /// Adds an error.
+        /// @param[in] filepath - The file containing the error.
+        /// @param[in] line_number - The line containing the error.
+        /// @param[in] message - The error message.
+        void AddError(const std::string& filepath, const std::size_t line_number, const std::string& message)
+        {
+            AddMessage(filepath, line_number, "error: " + message);
+            ErrorOccurred = true;
+        }
+
+        /// Adds any errors from macro expansion.
+        void AddExpansionErrors()
+        {
+            if (Expander.ErrorOccurred)
+            {
+                Result.Messages += Expander.Messages;
+                Expander.Messages.clear();
+                Expander.ErrorOccurred = false;
+                ErrorOccurred = true;
+            }
+        }
+
+        /// Adds an error for a directive.
+        /// @param[in] directive - The directive with the error.
+        /// @param[in] message - The error message.
+        void AddError(const Directive& directive, const std::string& message)
+        {
+            AddError(directive.Source.Filepath, directive.Source.LineNumber, message);
+        }
+
+        /// The cache of included files.
+        HeaderCache& Headers;
+        /// The currently defined macros.
+        MacroTable Macros;
+        /// Expands macros using the current definitions.
+        MacroExpander Expander;
+        /// Files that contained an active "#pragma once".
+        std::unordered_set<std::string> OnceOnlyFilepaths = {};
+        /// Files included so far.
+        std::unordered_set<std::string> IncludedFilepaths = {};
+        /// The current depth of nested includes.
+        std::size_t IncludeDepth = 0;
+        /// True if any error has occurred.
+        bool ErrorOccurred = false;
+        /// The results of preprocessing.
+        PreprocessedTranslationUnit Result = {};
+    };
+}
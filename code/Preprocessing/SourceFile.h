@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "Caching/ContentHash.h"
+#include "Preprocessing/Directive.h"
+#include "Tokenization/TokenStream.h"
+#include "Tokenization/Tokenizer.cpp"
+
+namespace PREPROCESSING
+{
+    /// A source file that has been lexed for preprocessing.
+    /// Everything about a file that doesn't depend on where it's included
+    /// (its tokens, parsed directives, and any include guard) is computed
+    /// once, so files can be shared between many translation units.
+    struct SourceFile
+    {
+        /// Lexes a source file.
+        /// @param[in] filepath - The path of the file.
+        /// @param[in] source_code - The contents of the file.
+        /// @return The lexed file.
+        static SourceFile Lex(const std::filesystem::path& filepath, const std::string& source_code)
+        {
+            using namespace TOKENIZATION;
+
+            SourceFile source_file =
+            {
+                .Filepath = filepath,
+                .ContentHash = CACHING::ContentHash::Compute(source_code),
+                .Tokens = Tokenizer::Tokenize(source_code),
+            };
+
+            // RECORD WHERE EACH TOKEN CAME FROM AND PARSE DIRECTIVES.
+            std::string filepath_string = filepath.string();
+            for (std::size_t token_index = 0; token_index < source_file.Tokens.Tokens.size(); ++token_index)
+            {
+                Token& token = source_file.Tokens.Tokens[token_index];
+                token.Filepath = filepath_string;
+                if (TokenType::PREPROCESSOR_DIRECTIVE == token.Type)
+                {
+                    source_file.Directives.push_back(Directive::Parse(token, token_index));
+                }
+            }
+
+            source_file.IncludeGuardMacroName = FindIncludeGuard(source_file);
+            return source_file;
+        }
+
+        /// The path of the file.
+        std::filesystem::path Filepath = "";
+        /// The hash of the file's contents.
+        std::uint64_t ContentHash = 0;
+        /// The tokens of the file, including tokens for directives.
+        TOKENIZATION::TokenStream Tokens = {};
+        /// The directives in the file, in order.
+        std::vector<Directive> Directives = {};
+        /// The macro guarding the entire file against repeated inclusion, if the file
+        /// has a classic include guard; empty otherwise.  When this macro is already
+        /// defined, including the file has no effect, so it can be skipped entirely.
+        std::string IncludeGuardMacroName = "";
+
+    private:
+        /// Finds a classic include guard for a file.
+        /// A file is guarded if, ignoring comments, it starts with "#ifndef X" (or
+        /// "#if !defined X") then "#define X", and ends with the #endif matching
+        /// the first directive, with no #else or #elif for that first directive.
+        /// @param[in] source_file - The file to check.
+        /// @return The name of the guard macro, if the file has an include guard; empty otherwise.
+        static std::string FindIncludeGuard(const SourceFile& source_file)
+        {
+            using namespace TOKENIZATION;
+
+            // FIND THE FIRST AND LAST SIGNIFICANT TOKENS.
+            const std::vector<Token>& tokens = source_file.Tokens.Tokens;
+            std::size_t first_token_index = 0;
+            while (first_token_index < tokens.size() && TokenType::COMMENT == tokens[first_token_index].Type)
+            {
+                ++first_token_index;
+            }
+            std::size_t last_token_index = tokens.size();
+            while (last_token_index > first_token_index && TokenType::COMMENT == tokens[last_token_index - 1].Type)
+            {
+                --last_token_index;
+            }
+            if (last_token_index <= first_token_index)
+            {
+                return "";
+            }
+            --last_token_index;
+
+            // CHECK FOR THE OPENING CONDITIONAL.
+            const std::vector<Directive>& directives = source_file.Directives;
+            bool enough_directives = (directives.size() >= 3);
+            if (!enough_directives || directives.front().TokenIndex != first_token_index)
+            {
+                return "";
+            }
+            std::string guard_macro_name = GetGuardMacroName(directives.front());
+            if (guard_macro_name.empty())
+            {
+                return "";
+            }
+
+            // CHECK THAT THE GUARD MACRO IS DEFINED NEXT.
+            const Directive& define_directive = directives[1];
+            std::size_t define_token_index = first_token_index + 1;
+            while (define_token_index < tokens.size() && TokenType::COMMENT == tokens[define_token_index].Type)
+            {
+                ++define_token_index;
+            }
+            bool guard_macro_defined = (
+                DirectiveKind::DEFINE == define_directive.Kind &&
+                guard_macro_name == define_directive.Name &&
+                define_token_index == define_directive.TokenIndex);
+            if (!guard_macro_defined)
+            {
+                return "";
+            }
+
+            // CHECK THAT THE MATCHING #ENDIF IS THE LAST TOKEN.
+            std::size_t conditional_depth = 0;
+            for (const Directive& directive : directives)
+            {
+                if (directive.StartsConditional())
+                {
+                    ++conditional_depth;
+                }
+                else if (DirectiveKind::ENDIF == directive.Kind)
+                {
+                    --conditional_depth;
+                    if (0 == conditional_depth)
+                    {
+                        bool guard_ends_file = (last_token_index == directive.TokenIndex);
+                        return guard_ends_file ? guard_macro_name : "";
+                    }
+                }
+                else if (1 == conditional_depth && (DirectiveKind::ELSE == directive.Kind || DirectiveKind::ELIF == directive.Kind))
+                {
+                    return "";
+                }
+            }
+
+            return "";
+        }
+
+        /// Gets the macro tested by a directive that could open an include guard.
+        /// @param[in] directive - The directive to check.
+        /// @return The macro name if the directive is "#ifndef X", "#if !defined X", or
+        ///     "#if !defined(X)"; empty otherwise.
+        static std::string GetGuardMacroName(const Directive& directive)
+        {
+            if (DirectiveKind::IFNDEF == directive.Kind)
+            {
+                return directive.Name;
+            }
+            if (DirectiveKind::IF != directive.Kind)
+            {
+                return "";
+            }
+
+            const std::vector<TOKENIZATION::Token>& tokens = directive.ArgumentTokens;
+            bool is_not_defined = (tokens.size() >= 3 && "!" == tokens[0].Value && "defined" == tokens[1].Value);
+            if (!is_not_defined)
+            {
+                return "";
+            }
+            if (3 == tokens.size())
+            {
+                return tokens[2].Value;
+            }
+            bool is_parenthesized = (5 == tokens.size() && "(" == tokens[2].Value && ")" == tokens[4].Value);
+            return is_parenthesized ? tokens[3].Value : "";
+        }
+    };
+}
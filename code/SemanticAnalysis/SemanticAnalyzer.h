@@ -0,0 +1,843 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "SemanticAnalysis/SymbolTable.h"
+#include "SemanticAnalysis/Type.h"
+
+namespace SEMANTIC_ANALYSIS
+{
+    /// Resolves names and checks types throughout a program.
+    ///
+    /// Names are resolved through nested scopes (functions at the top level,
+    /// then parameters, then each block), and every expression is annotated
+    /// with its interned type.  Since types are interned, all type checks are
+    /// pointer comparisons, and each distinct type spelling in the syntax
+    /// tree is only parsed once no matter how often it appears.
+    struct SemanticAnalyzer
+    {
+        /// Analyzes a program, resolving the type of every expression.
+        /// @param[in,out] program - The program to analyze.  Expressions are annotated
+        ///     with their types, which are kept alive by the program.
+        /// @param[out] error_messages - Any errors, one per line.
+        /// @return True if the program is valid; false otherwise.
+        static bool Analyze(Program& program, std::string& error_messages)
+        {
+            std::shared_ptr<TypeTable> types = std::make_shared<TypeTable>();
+            SemanticAnalyzer analyzer(*types);
+            analyzer.Symbols.EnterScope();
+
+            // DECLARE ALL FUNCTIONS.
+            // Functions are declared up front (and in name order, for consistent errors)
+            // so that they can be called regardless of the order they're defined in.
+            std::vector<FunctionDefinition*> functions;
+            for (auto& [function_name, function_definition] : program.FunctionsByName)
+            {
+                functions.push_back(&function_definition);
+            }
+            std::sort(
+                functions.begin(),
+                functions.end(),
+                [](const FunctionDefinition* left, const FunctionDefinition* right) { return left->Header.Name < right->Header.Name; });
+            std::vector<const FunctionHeader*> function_declarations;
+            for (const auto& [function_name, function_header] : program.FunctionDeclarationsByName)
+            {
+                function_declarations.push_back(&function_header);
+            }
+            std::sort(
+                function_declarations.begin(),
+                function_declarations.end(),
+                [](const FunctionHeader* left, const FunctionHeader* right) { return left->Name < right->Name; });
+
+            for (const FunctionHeader* function_declaration : function_declarations)
+            {
+                analyzer.DeclareFunction(*function_declaration);
+            }
+            for (const FunctionDefinition* function : functions)
+            {
+                analyzer.DeclareFunction(function->Header);
+            }
+
+            // ANALYZE ALL FUNCTION BODIES.
+            for (FunctionDefinition* function : functions)
+            {
+                analyzer.AnalyzeFunction(*function);
+            }
+
+            program.Types = std::move(types);
+            error_messages += analyzer.ErrorMessages;
+            return analyzer.ErrorMessages.empty();
+        }
+
+        /// Converts array and function types to the pointer types their values decay to.
+        /// @param[in] type - The type of a value.
+        /// @param[in,out] types - The types to get pointer types from.
+        /// @return The type after any decay.
+        static const Type* Decay(const Type* const type, TypeTable& types)
+        {
+            if (TypeKind::ARRAY == type->Kind)
+            {
+                return types.GetPointerType(type->ElementType);
+            }
+            if (TypeKind::FUNCTION == type->Kind)
+            {
+                return types.GetPointerType(type);
+            }
+            return type;
+        }
+
+    private:
+        /// Creates an analyzer.
+        /// @param[in,out] types - The types for the program being analyzed.
+        explicit SemanticAnalyzer(TypeTable& types) :
+            Types(types)
+        {}
+
+        /// Declares a function in the global scope.
+        /// @param[in] header - The function's header.
+        void DeclareFunction(const FunctionHeader& header)
+        {
+            // RESOLVE THE FUNCTION'S TYPE.
+            CurrentFilepath = &header.Filepath;
+            std::optional<const Type*> function_type = ResolveFunctionType(header);
+            if (!function_type)
+            {
+                return;
+            }
+
+            // DECLARE THE FUNCTION.
+            // Declarations and definitions of the same function must agree.
+            const Symbol* existing_symbol = Symbols.Declare(Symbol
+            {
+                .Kind = SymbolKind::FUNCTION,
+                .Name = header.Name,
+                .DataType = *function_type,
+                .LineNumber = header.LineNumber,
+            });
+            if (existing_symbol && existing_symbol->DataType != *function_type)
+            {
+                AddError(header.LineNumber, "Conflicting types for function '" + header.Name + "' ('" + (*function_type)->Name + "' and '" + existing_symbol->DataType->Name + "').");
+            }
+        }
+
+        /// Resolves the type of a function.
+        /// @param[in] header - The function's header.
+        /// @return The function's type, if all of its types are valid; null otherwise.
+        std::optional<const Type*> ResolveFunctionType(const FunctionHeader& header)
+        {
+            const Type* return_type = Types.GetTypeForSpelling(header.ReturnType);
+            if (!return_type || TypeKind::ARRAY == return_type->Kind)
+            {
+                AddError(header.LineNumber, "Invalid return type '" + header.ReturnType + "' for function '" + header.Name + "'.");
+                return std::nullopt;
+            }
+
+            std::vector<const Type*> parameter_types;
+            for (const VariableDeclaration& parameter : header.Parameters)
+            {
+                const Type* parameter_type = Types.GetTypeForSpelling(parameter.DataType);
+                if (!parameter_type || TypeKind::VOID == parameter_type->Kind)
+                {
+                    AddError(header.LineNumber, "Invalid type '" + parameter.DataType + "' for parameter '" + parameter.Name + "' of function '" + header.Name + "'.");
+                    return std::nullopt;
+                }
+                parameter_types.push_back(Decay(parameter_type, Types));
+            }
+
+            const Type* function_type = Types.GetFunctionType(return_type, parameter_types, header.IsVariadic);
+            return function_type;
+        }
+
+        /// Analyzes a function definition.
+        /// @param[in,out] function - The function to analyze.
+        void AnalyzeFunction(FunctionDefinition& function)
+        {
+            // FIND THE FUNCTION'S TYPE.
+            // Functions with invalid types were already reported.
+            CurrentFilepath = &function.Header.Filepath;
+            const Symbol* function_symbol = Symbols.Find(function.Header.Name);
+            if (!function_symbol)
+            {
+                return;
+            }
+            CurrentFunction = &function.Header;
+            CurrentReturnType = function_symbol->DataType->ElementType;
+            std::vector<const Type*> parameter_types = function_symbol->DataType->ParameterTypes;
+
+            // DECLARE THE PARAMETERS.
+            // Parameters share a scope with the top level of the body.
+            Symbols.EnterScope();
+            for (std::size_t parameter_index = 0; parameter_index < function.Header.Parameters.size(); ++parameter_index)
+            {
+                const VariableDeclaration& parameter = function.Header.Parameters[parameter_index];
+                if (parameter.Name.empty())
+                {
+                    continue;
+                }
+
+                const Symbol* existing_symbol = Symbols.Declare(Symbol
+                {
+                    .Kind = SymbolKind::PARAMETER,
+                    .Name = parameter.Name,
+                    .DataType = parameter_types[parameter_index],
+                    .LineNumber = function.Header.LineNumber,
+                });
+                if (existing_symbol)
+                {
+                    AddError(function.Header.LineNumber, "Redefinition of parameter '" + parameter.Name + "'.");
+                }
+            }
+
+            // ANALYZE THE BODY.
+            for (Statement& statement : function.Body.Statements)
+            {
+                AnalyzeStatement(statement);
+            }
+            Symbols.ExitScope();
+        }
+
+        /// Analyzes a statement in its own scope, such as the body of a loop.
+        /// @param[in,out] statement - The statement to analyze.
+        void AnalyzeScopedStatement(Statement& statement)
+        {
+            Symbols.EnterScope();
+            AnalyzeStatement(statement);
+            Symbols.ExitScope();
+        }
+
+        /// Analyzes a statement.
+        /// @param[in,out] statement - The statement to analyze.
+        void AnalyzeStatement(Statement& statement)
+        {
+            switch (statement.Kind)
+            {
+                case StatementKind::EXPRESSION:
+                {
+                    AnalyzeExpression(*statement.Value);
+                    break;
+                }
+                case StatementKind::DECLARATION:
+                {
+                    AnalyzeDeclaration(statement);
+                    break;
+                }
+                case StatementKind::RETURN:
+                {
+                    bool returns_void = (TypeKind::VOID == CurrentReturnType->Kind);
+                    if (!statement.Value)
+                    {
+                        if (!returns_void)
+                        {
+                            AddError(statement.LineNumber, "Function '" + CurrentFunction->Name + "' must return a value.");
+                        }
+                        break;
+                    }
+
+                    const Type* value_type = AnalyzeExpression(*statement.Value);
+                    if (returns_void)
+                    {
+                        AddError(statement.LineNumber, "Function '" + CurrentFunction->Name + "' returns void, so it can't return a value.");
+                    }
+                    else if (value_type)
+                    {
+                        CheckConvertible(CurrentReturnType, *statement.Value, value_type, "return value");
+                    }
+                    break;
+                }
+                case StatementKind::IF:
+                {
+                    AnalyzeCondition(*statement.Condition);
+                    for (Statement& child_statement : statement.Body)
+                    {
+                        AnalyzeScopedStatement(child_statement);
+                    }
+                    break;
+                }
+                case StatementKind::WHILE:
+                case StatementKind::DO_WHILE:
+                {
+                    AnalyzeCondition(*statement.Condition);
+                    ++LoopDepth;
+                    AnalyzeScopedStatement(statement.Body.front());
+                    --LoopDepth;
+                    break;
+                }
+                case StatementKind::FOR:
+                {
+                    // Any variable declared by the initializer is only visible within the loop.
+                    Symbols.EnterScope();
+                    AnalyzeStatement(statement.Body.front());
+                    if (statement.Condition)
+                    {
+                        AnalyzeCondition(*statement.Condition);
+                    }
+                    if (statement.Step)
+                    {
+                        AnalyzeExpression(*statement.Step);
+                    }
+                    ++LoopDepth;
+                    AnalyzeScopedStatement(statement.Body.back());
+                    --LoopDepth;
+                    Symbols.ExitScope();
+                    break;
+                }
+                case StatementKind::BREAK:
+                case StatementKind::CONTINUE:
+                {
+                    if (0 == LoopDepth)
+                    {
+                        std::string keyword = (StatementKind::BREAK == statement.Kind) ? "break" : "continue";
+                        AddError(statement.LineNumber, "'" + keyword + "' is only allowed within a loop.");
+                    }
+                    break;
+                }
+                case StatementKind::BLOCK:
+                {
+                    Symbols.EnterScope();
+                    for (Statement& child_statement : statement.Body)
+                    {
+                        AnalyzeStatement(child_statement);
+                    }
+                    Symbols.ExitScope();
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        /// Analyzes a local variable declaration.
+        /// @param[in,out] statement - The declaration.
+        void AnalyzeDeclaration(Statement& statement)
+        {
+            // RESOLVE THE VARIABLE'S TYPE.
+            const VariableDeclaration& declaration = statement.Declaration;
+            const Type* variable_type = Types.GetTypeForSpelling(declaration.DataType);
+            if (!variable_type || TypeKind::VOID == variable_type->Kind)
+            {
+                AddError(statement.LineNumber, "Invalid type '" + declaration.DataType + "' for variable '" + declaration.Name + "'.");
+                if (statement.Value)
+                {
+                    AnalyzeExpression(*statement.Value);
+                }
+                return;
+            }
+
+            // DECLARE THE VARIABLE.
+            // The variable is in scope within its own initializer, as in C.
+            const Symbol* existing_symbol = Symbols.Declare(Symbol
+            {
+                .Kind = SymbolKind::LOCAL_VARIABLE,
+                .Name = declaration.Name,
+                .DataType = variable_type,
+                .LineNumber = statement.LineNumber,
+            });
+            if (existing_symbol)
+            {
+                AddError(statement.LineNumber, "Redefinition of '" + declaration.Name + "' (previously declared on line " + std::to_string(existing_symbol->LineNumber) + ").");
+            }
+
+            // CHECK ANY INITIALIZER.
+            if (!statement.Value)
+            {
+                return;
+            }
+            const Type* value_type = AnalyzeExpression(*statement.Value);
+            if (TypeKind::ARRAY == variable_type->Kind)
+            {
+                AddError(statement.LineNumber, "Array '" + declaration.Name + "' can't be initialized with an expression.");
+            }
+            else if (value_type)
+            {
+                CheckConvertible(variable_type, *statement.Value, value_type, "initializer of '" + declaration.Name + "'");
+            }
+        }
+
+        /// Analyzes the condition of an if statement or loop.
+        /// @param[in,out] condition - The condition.
+        void AnalyzeCondition(Expression& condition)
+        {
+            const Type* condition_type = AnalyzeExpression(condition);
+            if (condition_type && !Decay(condition_type, Types)->IsScalar())
+            {
+                AddError(condition.LineNumber, "Condition has non-scalar type '" + condition_type->Name + "'.");
+            }
+        }
+
+        /// Analyzes an expression, annotating it and all subexpressions with their types.
+        /// @param[in,out] expression - The expression to analyze.
+        /// @return The type of the expression, if it's valid; null otherwise.
+        ///     Errors are only reported once, so null results can be propagated silently.
+        const Type* AnalyzeExpression(Expression& expression)
+        {
+            expression.ResolvedType = ResolveExpressionType(expression);
+            return expression.ResolvedType;
+        }
+
+        /// Resolves the type of an expression.
+        /// @param[in,out] expression - The expression.
+        /// @return The type of the expression, if it's valid; null otherwise.
+        const Type* ResolveExpressionType(Expression& expression)
+        {
+            switch (expression.Kind)
+            {
+                case ExpressionKind::CONSTANT:
+                    return ResolveConstantType(expression);
+                case ExpressionKind::STRING_LITERAL:
+                    return Types.GetPointerType(Types.Char);
+                case ExpressionKind::IDENTIFIER:
+                {
+                    const Symbol* symbol = Symbols.Find(expression.Text);
+                    if (!symbol)
+                    {
+                        AddError(expression.LineNumber, "Undeclared identifier '" + expression.Text + "'.");
+                        return nullptr;
+                    }
+                    return symbol->DataType;
+                }
+                case ExpressionKind::CALL:
+                    return ResolveCallType(expression);
+                case ExpressionKind::UNARY:
+                case ExpressionKind::POSTFIX:
+                    return ResolveUnaryType(expression);
+                case ExpressionKind::BINARY:
+                    return ResolveBinaryType(expression);
+                case ExpressionKind::ASSIGNMENT:
+                {
+                    const Type* target_type = AnalyzeExpression(expression.Operands[0]);
+                    const Type* value_type = AnalyzeExpression(expression.Operands[1]);
+                    if (!target_type || !value_type)
+                    {
+                        return nullptr;
+                    }
+                    if (!IsModifiableLvalue(expression.Operands[0]))
+                    {
+                        AddError(expression.LineNumber, "Expression can't be assigned to.");
+                        return nullptr;
+                    }
+
+                    // A compound assignment stores the result of its operator on the target's current value.
+                    std::string_view operator_text = Expression::GetCompoundAssignmentOperator(expression.Text);
+                    if (!operator_text.empty())
+                    {
+                        const Type* result_type = ResolveBinaryOperatorType(expression, operator_text, target_type, value_type);
+                        if (!result_type)
+                        {
+                            return nullptr;
+                        }
+                        bool convertible = (result_type == target_type || (result_type->IsArithmetic() && target_type->IsArithmetic()));
+                        if (!convertible)
+                        {
+                            AddError(expression.LineNumber, "Can't convert '" + result_type->Name + "' to '" + target_type->Name + "' in assignment.");
+                        }
+                        return convertible ? target_type : nullptr;
+                    }
+
+                    bool convertible = CheckConvertible(target_type, expression.Operands[1], value_type, "assignment");
+                    return convertible ? target_type : nullptr;
+                }
+                case ExpressionKind::CONDITIONAL:
+                    return ResolveConditionalType(expression);
+                case ExpressionKind::INDEX:
+                {
+                    const Type* base_type = AnalyzeExpression(expression.Operands[0]);
+                    const Type* index_type = AnalyzeExpression(expression.Operands[1]);
+                    if (!base_type || !index_type)
+                    {
+                        return nullptr;
+                    }
+
+                    // Either operand may be the pointer, as in C.
+                    base_type = Decay(base_type, Types);
+                    index_type = Decay(index_type, Types);
+                    if (TypeKind::POINTER == index_type->Kind)
+                    {
+                        std::swap(base_type, index_type);
+                    }
+                    bool valid = (TypeKind::POINTER == base_type->Kind && base_type->ElementType->SizeInBytes > 0 && TypeKind::INTEGER == index_type->Kind);
+                    if (!valid)
+                    {
+                        AddError(expression.LineNumber, "Can't index '" + base_type->Name + "' with '" + index_type->Name + "'.");
+                        return nullptr;
+                    }
+                    return base_type->ElementType;
+                }
+                default:
+                    AddError(expression.LineNumber, "Invalid expression.");
+                    return nullptr;
+            }
+        }
+
+        /// Resolves the type of a constant.
+        /// @param[in] expression - The constant.
+        /// @return The smallest type from int, long, or unsigned long that holds the value.
+        const Type* ResolveConstantType(const Expression& expression)
+        {
+            // Character constants are ints in C.
+            bool is_character = (!expression.Text.empty() && '\'' == expression.Text.front());
+            if (is_character)
+            {
+                return Types.Int;
+            }
+
+            constexpr std::uint64_t MAX_INT = 0x7FFFFFFF;
+            constexpr std::uint64_t MAX_LONG = 0x7FFFFFFFFFFFFFFF;
+            std::uint64_t value = 0;
+            for (const char digit : expression.Text)
+            {
+                bool overflows = (value > (UINT64_MAX - static_cast<std::uint64_t>(digit - '0')) / 10);
+                if (digit < '0' || digit > '9' || overflows)
+                {
+                    AddError(expression.LineNumber, "Invalid constant '" + expression.Text + "'.");
+                    return nullptr;
+                }
+                value = value * 10 + static_cast<std::uint64_t>(digit - '0');
+            }
+
+            if (value <= MAX_INT)
+            {
+                return Types.Int;
+            }
+            return (value <= MAX_LONG) ? Types.Long : Types.UnsignedLong;
+        }
+
+        /// Resolves the type of a function call.
+        /// @param[in,out] expression - The call.
+        /// @return The return type of the function, if the call is valid; null otherwise.
+        const Type* ResolveCallType(Expression& expression)
+        {
+            // ANALYZE THE ARGUMENTS.
+            std::vector<const Type*> argument_types;
+            bool arguments_valid = true;
+            for (Expression& argument : expression.Operands)
+            {
+                const Type* argument_type = AnalyzeExpression(argument);
+                arguments_valid = arguments_valid && argument_type;
+                argument_types.push_back(argument_type);
+            }
+
+            // FIND THE FUNCTION.
+            const Symbol* function_symbol = Symbols.Find(expression.Text);
+            if (!function_symbol)
+            {
+                AddError(expression.LineNumber, "Call to undeclared function '" + expression.Text + "'.");
+                return nullptr;
+            }
+            const Type* function_type = function_symbol->DataType;
+            if (TypeKind::FUNCTION != function_type->Kind)
+            {
+                AddError(expression.LineNumber, "'" + expression.Text + "' is not a function.");
+                return nullptr;
+            }
+            if (!arguments_valid)
+            {
+                return nullptr;
+            }
+
+            // CHECK THE ARGUMENTS.
+            std::size_t parameter_count = function_type->ParameterTypes.size();
+            std::size_t argument_count = expression.Operands.size();
+            bool argument_count_valid = function_type->IsVariadic ? (argument_count >= parameter_count) : (argument_count == parameter_count);
+            if (!argument_count_valid)
+            {
+                AddError(
+                    expression.LineNumber,
+                    "Function '" + expression.Text + "' takes " + (function_type->IsVariadic ? "at least " : "") +
+                    std::to_string(parameter_count) + " arguments but was called with " + std::to_string(argument_count) + ".");
+                return nullptr;
+            }
+            for (std::size_t parameter_index = 0; parameter_index < parameter_count; ++parameter_index)
+            {
+                bool convertible = CheckConvertible(
+                    function_type->ParameterTypes[parameter_index],
+                    expression.Operands[parameter_index],
+                    argument_types[parameter_index],
+                    "argument " + std::to_string(parameter_index + 1) + " of '" + expression.Text + "'");
+                if (!convertible)
+                {
+                    return nullptr;
+                }
+            }
+
+            return function_type->ElementType;
+        }
+
+        /// Resolves the type of a prefix or postfix unary operator.
+        /// @param[in,out] expression - The operator.
+        /// @return The type of the result, if the operator is valid; null otherwise.
+        const Type* ResolveUnaryType(Expression& expression)
+        {
+            Expression& operand = expression.Operands[0];
+            const Type* operand_type = AnalyzeExpression(operand);
+            if (!operand_type)
+            {
+                return nullptr;
+            }
+
+            // The address of an array or function doesn't decay its type.
+            const std::string& operator_text = expression.Text;
+            if ("&" == operator_text)
+            {
+                bool addressable = (IsModifiableLvalue(operand) || TypeKind::ARRAY == operand_type->Kind || TypeKind::FUNCTION == operand_type->Kind);
+                if (!addressable)
+                {
+                    AddError(expression.LineNumber, "Can't take the address of this expression.");
+                    return nullptr;
+                }
+                return Types.GetPointerType(operand_type);
+            }
+
+            const Type* value_type = Decay(operand_type, Types);
+            const Type* result_type = nullptr;
+            if ("++" == operator_text || "--" == operator_text)
+            {
+                bool valid = IsModifiableLvalue(operand) && (value_type->IsArithmetic() || TypeKind::POINTER == value_type->Kind);
+                result_type = valid ? value_type : nullptr;
+            }
+            else if ("*" == operator_text)
+            {
+                bool valid = (TypeKind::POINTER == value_type->Kind && TypeKind::VOID != value_type->ElementType->Kind);
+                result_type = valid ? value_type->ElementType : nullptr;
+            }
+            else if ("!" == operator_text)
+            {
+                result_type = value_type->IsScalar() ? Types.Int : nullptr;
+            }
+            else if ("~" == operator_text)
+            {
+                result_type = (TypeKind::INTEGER == value_type->Kind) ? Types.PromoteInteger(value_type) : nullptr;
+            }
+            else if ("-" == operator_text || "+" == operator_text)
+            {
+                result_type = value_type->IsArithmetic() ? Types.PromoteInteger(value_type) : nullptr;
+            }
+
+            if (!result_type)
+            {
+                AddError(expression.LineNumber, "Invalid operand of type '" + operand_type->Name + "' for operator '" + operator_text + "'.");
+            }
+            return result_type;
+        }
+
+        /// Resolves the type of a binary operator.
+        /// @param[in,out] expression - The operator.
+        /// @return The type of the result, if the operator is valid; null otherwise.
+        const Type* ResolveBinaryType(Expression& expression)
+        {
+            const Type* left_type = AnalyzeExpression(expression.Operands[0]);
+            const Type* right_type = AnalyzeExpression(expression.Operands[1]);
+            if (!left_type || !right_type)
+            {
+                return nullptr;
+            }
+            return ResolveBinaryOperatorType(expression, expression.Text, left_type, right_type);
+        }
+
+        /// Resolves the type of a binary operator on analyzed operands.
+        /// @param[in] expression - The binary operator or compound assignment, whose operands are the operator's.
+        /// @param[in] operator_text - The binary operator.
+        /// @param[in] left_type - The type of the left operand.
+        /// @param[in] right_type - The type of the right operand.
+        /// @return The type of the result, if the operator is valid; null otherwise.
+        const Type* ResolveBinaryOperatorType(const Expression& expression, const std::string_view operator_text, const Type* left_type, const Type* right_type)
+        {
+            left_type = Decay(left_type, Types);
+            right_type = Decay(right_type, Types);
+
+            bool both_arithmetic = (left_type->IsArithmetic() && right_type->IsArithmetic());
+            bool both_integers = (TypeKind::INTEGER == left_type->Kind && TypeKind::INTEGER == right_type->Kind);
+            bool left_is_pointer = (TypeKind::POINTER == left_type->Kind);
+            bool right_is_pointer = (TypeKind::POINTER == right_type->Kind);
+            const Type* result_type = nullptr;
+            if ("&&" == operator_text || "||" == operator_text)
+            {
+                result_type = (left_type->IsScalar() && right_type->IsScalar()) ? Types.Int : nullptr;
+            }
+            else if ("==" == operator_text || "!=" == operator_text || "<" == operator_text || "<=" == operator_text || ">" == operator_text || ">=" == operator_text)
+            {
+                bool comparable = (
+                    both_arithmetic ||
+                    (left_is_pointer && right_is_pointer && ArePointersCompatible(left_type, right_type)) ||
+                    (left_is_pointer && IsNullPointerConstant(expression.Operands[1])) ||
+                    (right_is_pointer && IsNullPointerConstant(expression.Operands[0])));
+                result_type = comparable ? Types.Int : nullptr;
+            }
+            else if ("+" == operator_text)
+            {
+                if (both_arithmetic)
+                {
+                    result_type = Types.GetCommonArithmeticType(left_type, right_type);
+                }
+                else if (left_is_pointer && TypeKind::INTEGER == right_type->Kind && left_type->ElementType->SizeInBytes > 0)
+                {
+                    result_type = left_type;
+                }
+                else if (right_is_pointer && TypeKind::INTEGER == left_type->Kind && right_type->ElementType->SizeInBytes > 0)
+                {
+                    result_type = right_type;
+                }
+            }
+            else if ("-" == operator_text)
+            {
+                if (both_arithmetic)
+                {
+                    result_type = Types.GetCommonArithmeticType(left_type, right_type);
+                }
+                else if (left_is_pointer && TypeKind::INTEGER == right_type->Kind && left_type->ElementType->SizeInBytes > 0)
+                {
+                    result_type = left_type;
+                }
+                else if (left_is_pointer && left_type == right_type && left_type->ElementType->SizeInBytes > 0)
+                {
+                    result_type = Types.Long;
+                }
+            }
+            else if ("*" == operator_text || "/" == operator_text)
+            {
+                result_type = both_arithmetic ? Types.GetCommonArithmeticType(left_type, right_type) : nullptr;
+            }
+            else if ("%" == operator_text || "&" == operator_text || "|" == operator_text || "^" == operator_text)
+            {
+                result_type = both_integers ? Types.GetCommonArithmeticType(left_type, right_type) : nullptr;
+            }
+            else if ("<<" == operator_text || ">>" == operator_text)
+            {
+                result_type = both_integers ? Types.PromoteInteger(left_type) : nullptr;
+            }
+
+            if (!result_type)
+            {
+                AddError(expression.LineNumber, "Invalid operands of types '" + left_type->Name + "' and '" + right_type->Name + "' for operator '" + expression.Text + "'.");
+            }
+            return result_type;
+        }
+
+        /// Resolves the type of a conditional expression.
+        /// @param[in,out] expression - The conditional expression.
+        /// @return The type of the result, if the expression is valid; null otherwise.
+        const Type* ResolveConditionalType(Expression& expression)
+        {
+            AnalyzeCondition(expression.Operands[0]);
+            const Type* true_type = AnalyzeExpression(expression.Operands[1]);
+            const Type* false_type = AnalyzeExpression(expression.Operands[2]);
+            if (!true_type || !false_type)
+            {
+                return nullptr;
+            }
+            true_type = Decay(true_type, Types);
+            false_type = Decay(false_type, Types);
+
+            if (true_type->IsArithmetic() && false_type->IsArithmetic())
+            {
+                return Types.GetCommonArithmeticType(true_type, false_type);
+            }
+            if (true_type == false_type)
+            {
+                return true_type;
+            }
+            if (TypeKind::POINTER == true_type->Kind && IsNullPointerConstant(expression.Operands[2]))
+            {
+                return true_type;
+            }
+            if (TypeKind::POINTER == false_type->Kind && IsNullPointerConstant(expression.Operands[1]))
+            {
+                return false_type;
+            }
+            if (TypeKind::POINTER == true_type->Kind && TypeKind::POINTER == false_type->Kind && ArePointersCompatible(true_type, false_type))
+            {
+                return Types.GetPointerType(Types.Void);
+            }
+
+            AddError(expression.LineNumber, "Incompatible types '" + true_type->Name + "' and '" + false_type->Name + "' in conditional expression.");
+            return nullptr;
+        }
+
+        /// Checks that a value can be implicitly converted to a type, adding an error if not.
+        /// @param[in] target_type - The type to convert to.
+        /// @param[in] value - The value being converted.
+        /// @param[in] value_type - The type of the value.
+        /// @param[in] context - Describes the conversion for any error.
+        /// @return True if the conversion is valid; false otherwise.
+        bool CheckConvertible(const Type* const target_type, const Expression& value, const Type* const value_type, const std::string& context)
+        {
+            const Type* decayed_value_type = Decay(value_type, Types);
+            bool convertible = (
+                target_type == decayed_value_type ||
+                (target_type->IsArithmetic() && decayed_value_type->IsArithmetic()) ||
+                (TypeKind::POINTER == target_type->Kind && TypeKind::POINTER == decayed_value_type->Kind && ArePointersCompatible(target_type, decayed_value_type)) ||
+                (TypeKind::POINTER == target_type->Kind && IsNullPointerConstant(value)));
+            if (!convertible)
+            {
+                AddError(value.LineNumber, "Can't convert '" + value_type->Name + "' to '" + target_type->Name + "' in " + context + ".");
+            }
+            return convertible;
+        }
+
+        /// Determines if two pointer types can be converted to each other implicitly.
+        /// @param[in] left_type - A pointer type.
+        /// @param[in] right_type - Another pointer type.
+        /// @return True if the pointers point to the same type or either is a void pointer; false otherwise.
+        static bool ArePointersCompatible(const Type* const left_type, const Type* const right_type)
+        {
+            bool compatible = (
+                left_type == right_type ||
+                TypeKind::VOID == left_type->ElementType->Kind ||
+                TypeKind::VOID == right_type->ElementType->Kind);
+            return compatible;
+        }
+
+        /// Determines if an expression is a literal 0, which can be used as a null pointer.
+        /// @param[in] expression - The expression to check.
+        /// @return True if the expression is a null pointer constant; false otherwise.
+        static bool IsNullPointerConstant(const Expression& expression)
+        {
+            return ExpressionKind::CONSTANT == expression.Kind && "0" == expression.Text;
+        }
+
+        /// Determines if an expression designates an object that can be assigned to.
+        /// @param[in] expression - The analyzed expression to check.
+        /// @return True if the expression is a modifiable lvalue; false otherwise.
+        static bool IsModifiableLvalue(const Expression& expression)
+        {
+            bool designates_object = (
+                ExpressionKind::IDENTIFIER == expression.Kind ||
+                ExpressionKind::INDEX == expression.Kind ||
+                (ExpressionKind::UNARY == expression.Kind && "*" == expression.Text));
+            bool modifiable = (
+                designates_object &&
+                expression.ResolvedType &&
+                TypeKind::ARRAY != expression.ResolvedType->Kind &&
+                TypeKind::FUNCTION != expression.ResolvedType->Kind);
+            return modifiable;
+        }
+
+        /// Adds an error in the current function's file.
+        /// @param[in] line_number - The line of the error.
+        /// @param[in] message - The error message.
+        void AddError(const std::size_t line_number, const std::string& message)
+        {
+            ErrorMessages += *CurrentFilepath + ":" + std::to_string(line_number) + ": error: " + message + "\n";
+        }
+
+        /// The types for the program being analyzed.
+        TypeTable& Types;
+        /// The names currently in scope.
+        SymbolTable Symbols = {};
+        /// The path of the file containing the code being analyzed.
+        const std::string* CurrentFilepath = nullptr;
+        /// The header of the function being analyzed.
+        const FunctionHeader* CurrentFunction = nullptr;
+        /// The return type of the function being analyzed.
+        const Type* CurrentReturnType = nullptr;
+        /// The number of loops enclosing the code being analyzed.
+        std::size_t LoopDepth = 0;
+        /// The errors found so far, one per line.
+        std::string ErrorMessages = "";
+    };
+}
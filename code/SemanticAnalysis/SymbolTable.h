@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SemanticAnalysis/Type.h"
+
+namespace SEMANTIC_ANALYSIS
+{
+    /// The different kinds of named entities.
+    enum class SymbolKind
+    {
+        FUNCTION = 0,
+        PARAMETER,
+        LOCAL_VARIABLE,
+    };
+
+    /// A named entity declared in some scope.
+    struct Symbol
+    {
+        /// The kind of entity.
+        SymbolKind Kind = SymbolKind::LOCAL_VARIABLE;
+        /// The name of the entity.
+        std::string Name = "";
+        /// The type of the entity.
+        const Type* DataType = nullptr;
+        /// The line on which the entity was declared.
+        std::size_t LineNumber = 0;
+        /// An ID for the entity assigned by whoever declared it, such as a variable index during lowering.
+        std::uint32_t Id = 0;
+    };
+
+    /// Resolves names through nested scopes.
+    ///
+    /// Rather than a separate map per scope (which would make each lookup
+    /// search every enclosing scope), each name maps to a stack of the
+    /// symbols currently declared with it.  Innermost declarations are on
+    /// top, so lookups are a single hash lookup regardless of nesting depth,
+    /// and leaving a scope pops just the symbols it declared.
+    struct SymbolTable
+    {
+        /// Enters a new innermost scope.
+        void EnterScope()
+        {
+            ScopeStartIndices.push_back(DeclaredNames.size());
+        }
+
+        /// Leaves the innermost scope, removing all symbols declared in it.
+        void ExitScope()
+        {
+            std::size_t scope_start_index = ScopeStartIndices.back();
+            ScopeStartIndices.pop_back();
+            while (DeclaredNames.size() > scope_start_index)
+            {
+                auto symbols_with_name = SymbolsByName.find(DeclaredNames.back());
+                symbols_with_name->second.pop_back();
+                if (symbols_with_name->second.empty())
+                {
+                    SymbolsByName.erase(symbols_with_name);
+                }
+                DeclaredNames.pop_back();
+            }
+        }
+
+        /// Declares a symbol in the innermost scope.
+        /// @param[in] symbol - The symbol to declare.
+        /// @return The symbol already declared with the same name in the innermost
+        ///     scope, if any (in which case nothing is declared); null on success.
+        const Symbol* Declare(const Symbol& symbol)
+        {
+            // CHECK FOR AN EXISTING SYMBOL IN THE SAME SCOPE.
+            std::vector<ScopedSymbol>& symbols_with_name = SymbolsByName[symbol.Name];
+            bool declared_in_innermost_scope = (!symbols_with_name.empty() && symbols_with_name.back().ScopeDepth == ScopeStartIndices.size());
+            if (declared_in_innermost_scope)
+            {
+                return &symbols_with_name.back().Symbol;
+            }
+
+            // DECLARE THE SYMBOL.
+            symbols_with_name.push_back(ScopedSymbol { .Symbol = symbol, .ScopeDepth = ScopeStartIndices.size() });
+            DeclaredNames.push_back(symbol.Name);
+            return nullptr;
+        }
+
+        /// Finds the innermost symbol with a name.
+        /// @param[in] name - The name to find.
+        /// @return The symbol, if one is visible; null otherwise.
+        ///     Only valid until the next symbol is declared.
+        const Symbol* Find(const std::string& name) const
+        {
+            auto symbols_with_name = SymbolsByName.find(name);
+            if (SymbolsByName.end() == symbols_with_name)
+            {
+                return nullptr;
+            }
+            return &symbols_with_name->second.back().Symbol;
+        }
+
+    private:
+        /// A symbol along with the depth of the scope declaring it.
+        struct ScopedSymbol
+        {
+            /// The symbol.
+            SEMANTIC_ANALYSIS::Symbol Symbol = {};
+            /// The number of scopes entered when the symbol was declared.
+            std::size_t ScopeDepth = 0;
+        };
+
+        /// The visible symbols by name, with the innermost last.
+        std::unordered_map<std::string, std::vector<ScopedSymbol>> SymbolsByName = {};
+        /// The names of all visible symbols in the order they were declared.
+        std::vector<std::string> DeclaredNames = {};
+        /// The indices into the declared names where each entered scope starts.
+        std::vector<std::size_t> ScopeStartIndices = {};
+    };
+}
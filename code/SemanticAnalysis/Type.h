@@ -0,0 +1,431 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace SEMANTIC_ANALYSIS
+{
+    /// The different kinds of types.
+    enum class TypeKind
+    {
+        VOID = 0,
+        INTEGER,
+        FLOATING_POINT,
+        POINTER,
+        ARRAY,
+        FUNCTION,
+    };
+
+    /// A type.  Types are immutable and only created by a TypeTable, which
+    /// creates each distinct type exactly once, so two types from the same
+    /// table are equal if and only if they're the same object.
+    struct Type
+    {
+        /// The kind of type.
+        TypeKind Kind = TypeKind::VOID;
+        /// The type as written in C, such as "unsigned int*" or "int[10]".
+        std::string Name = "";
+        /// The size of values of the type, or 0 if it has no size (void and functions).
+        std::size_t SizeInBytes = 0;
+        /// True for signed integers; false otherwise.
+        bool IsSigned = false;
+        /// The type pointed to, the array's element type, or the function's return type.
+        const Type* ElementType = nullptr;
+        /// The number of elements, for arrays.
+        std::size_t ElementCount = 0;
+        /// The parameter types, for functions.
+        std::vector<const Type*> ParameterTypes = {};
+        /// True for functions taking additional arguments after their parameters.
+        bool IsVariadic = false;
+
+        /// Determines if the type is an integer or floating-point type.
+        /// @return True if the type is arithmetic; false otherwise.
+        bool IsArithmetic() const
+        {
+            return TypeKind::INTEGER == Kind || TypeKind::FLOATING_POINT == Kind;
+        }
+
+        /// Determines if values of the type can be used as conditions.
+        /// @return True if the type is arithmetic or a pointer; false otherwise.
+        bool IsScalar() const
+        {
+            return IsArithmetic() || TypeKind::POINTER == Kind;
+        }
+    };
+
+    /// Creates and interns types.  Each distinct type is created once and
+    /// never changes or moves, so types can be compared by pointer and
+    /// derived types (pointers, arrays, and functions) are only built the
+    /// first time they're needed.
+    ///
+    /// A table isn't safe to use from multiple threads at once.
+    struct TypeTable
+    {
+        /// Creates a table with all built-in types.
+        /// Sizes follow the LP64 data model used by x86-64 System V.
+        TypeTable()
+        {
+            Void = AddBuiltInType(TypeKind::VOID, "void", 0, false);
+            Char = AddBuiltInType(TypeKind::INTEGER, "char", 1, true);
+            SignedChar = AddBuiltInType(TypeKind::INTEGER, "signed char", 1, true);
+            UnsignedChar = AddBuiltInType(TypeKind::INTEGER, "unsigned char", 1, false);
+            Short = AddBuiltInType(TypeKind::INTEGER, "short", 2, true);
+            UnsignedShort = AddBuiltInType(TypeKind::INTEGER, "unsigned short", 2, false);
+            Int = AddBuiltInType(TypeKind::INTEGER, "int", 4, true);
+            UnsignedInt = AddBuiltInType(TypeKind::INTEGER, "unsigned int", 4, false);
+            Long = AddBuiltInType(TypeKind::INTEGER, "long", 8, true);
+            UnsignedLong = AddBuiltInType(TypeKind::INTEGER, "unsigned long", 8, false);
+            LongLong = AddBuiltInType(TypeKind::INTEGER, "long long", 8, true);
+            UnsignedLongLong = AddBuiltInType(TypeKind::INTEGER, "unsigned long long", 8, false);
+            Float = AddBuiltInType(TypeKind::FLOATING_POINT, "float", 4, true);
+            Double = AddBuiltInType(TypeKind::FLOATING_POINT, "double", 8, true);
+            LongDouble = AddBuiltInType(TypeKind::FLOATING_POINT, "long double", 16, true);
+
+            // ADD ALTERNATE SPELLINGS OF BUILT-IN TYPES.
+            TypesBySpelling.emplace("signed", Int);
+            TypesBySpelling.emplace("signed int", Int);
+            TypesBySpelling.emplace("unsigned", UnsignedInt);
+            TypesBySpelling.emplace("short int", Short);
+            TypesBySpelling.emplace("signed short", Short);
+            TypesBySpelling.emplace("signed short int", Short);
+            TypesBySpelling.emplace("unsigned short int", UnsignedShort);
+            TypesBySpelling.emplace("long int", Long);
+            TypesBySpelling.emplace("signed long", Long);
+            TypesBySpelling.emplace("signed long int", Long);
+            TypesBySpelling.emplace("unsigned long int", UnsignedLong);
+            TypesBySpelling.emplace("long long int", LongLong);
+            TypesBySpelling.emplace("signed long long", LongLong);
+            TypesBySpelling.emplace("signed long long int", LongLong);
+            TypesBySpelling.emplace("unsigned long long int", UnsignedLongLong);
+        }
+
+        // Types own their names and are pointed to, so tables are never copied.
+        TypeTable(const TypeTable&) = delete;
+        TypeTable& operator=(const TypeTable&) = delete;
+
+        /// Gets the type for a spelling from the syntax tree, such as "unsigned int*" or "char[16]".
+        /// Spellings are memoized, so each distinct spelling is only parsed once.
+        /// @param[in] spelling - The spelling of the type.
+        /// @return The type, if the spelling is valid; null otherwise.
+        const Type* GetTypeForSpelling(const std::string_view spelling)
+        {
+            // CHECK FOR A PREVIOUSLY SEEN SPELLING.
+            std::string spelling_key(spelling);
+            auto existing_type = TypesBySpelling.find(spelling_key);
+            if (TypesBySpelling.end() != existing_type)
+            {
+                return existing_type->second;
+            }
+
+            // RESOLVE ANY DERIVED TYPE FROM ITS BASE.
+            // Declarators are applied from the outside in: "int*[4]" is an array of 4 "int*".
+            const Type* type = nullptr;
+            if (!spelling.empty() && '*' == spelling.back())
+            {
+                const Type* target_type = GetTypeForSpelling(spelling.substr(0, spelling.size() - 1));
+                type = target_type ? GetPointerType(target_type) : nullptr;
+            }
+            else if (!spelling.empty() && ']' == spelling.back())
+            {
+                std::size_t opening_bracket_index = spelling.rfind('[');
+                if (std::string_view::npos != opening_bracket_index)
+                {
+                    std::string_view element_count_text = spelling.substr(opening_bracket_index + 1, spelling.size() - opening_bracket_index - 2);
+                    std::size_t element_count = 0;
+                    bool element_count_valid = !element_count_text.empty();
+                    for (const char digit : element_count_text)
+                    {
+                        element_count_valid = element_count_valid && (digit >= '0' && digit <= '9');
+                        element_count = element_count * 10 + static_cast<std::size_t>(digit - '0');
+                    }
+
+                    const Type* element_type = GetTypeForSpelling(spelling.substr(0, opening_bracket_index));
+                    bool array_valid = (element_count_valid && element_count > 0 && element_type && element_type->SizeInBytes > 0);
+                    type = array_valid ? GetArrayType(element_type, element_count) : nullptr;
+                }
+            }
+
+            // Invalid spellings are remembered too so they're only parsed once.
+            TypesBySpelling.emplace(std::move(spelling_key), type);
+            return type;
+        }
+
+        /// Finds the type for a spelling that has already been resolved, without modifying the table.
+        /// After semantic analysis, every spelling in the analyzed program can be found this way.
+        /// @param[in] spelling - The spelling of the type.
+        /// @return The type, if the spelling was previously resolved to a valid type; null otherwise.
+        const Type* FindTypeForSpelling(const std::string& spelling) const
+        {
+            auto existing_type = TypesBySpelling.find(spelling);
+            return (TypesBySpelling.end() != existing_type) ? existing_type->second : nullptr;
+        }
+
+        /// Finds the type of pointers to a type, if it has been created, without modifying the table.
+        /// @param[in] target_type - The type pointed to.
+        /// @return The pointer type, if it exists; null otherwise.
+        const Type* FindPointerType(const Type* const target_type) const
+        {
+            DerivedTypeKey key = { .Kind = TypeKind::POINTER, .ElementType = target_type };
+            auto existing_type = DerivedTypesByKey.find(key);
+            return (DerivedTypesByKey.end() != existing_type) ? existing_type->second : nullptr;
+        }
+
+        /// Gets the type of pointers to a type.
+        /// @param[in] target_type - The type pointed to.
+        /// @return The pointer type.
+        const Type* GetPointerType(const Type* const target_type)
+        {
+            DerivedTypeKey key = { .Kind = TypeKind::POINTER, .ElementType = target_type };
+            return GetDerivedType(key, [&]()
+            {
+                return Type
+                {
+                    .Kind = TypeKind::POINTER,
+                    .Name = target_type->Name + "*",
+                    .SizeInBytes = POINTER_SIZE_IN_BYTES,
+                    .ElementType = target_type,
+                };
+            });
+        }
+
+        /// Gets the type of arrays of a type.
+        /// @param[in] element_type - The type of elements.
+        /// @param[in] element_count - The number of elements.
+        /// @return The array type.
+        const Type* GetArrayType(const Type* const element_type, const std::size_t element_count)
+        {
+            DerivedTypeKey key = { .Kind = TypeKind::ARRAY, .ElementType = element_type, .ElementCount = element_count };
+            return GetDerivedType(key, [&]()
+            {
+                return Type
+                {
+                    .Kind = TypeKind::ARRAY,
+                    .Name = element_type->Name + "[" + std::to_string(element_count) + "]",
+                    .SizeInBytes = element_type->SizeInBytes * element_count,
+                    .ElementType = element_type,
+                    .ElementCount = element_count,
+                };
+            });
+        }
+
+        /// Gets the type of functions.
+        /// @param[in] return_type - The type returned by the functions.
+        /// @param[in] parameter_types - The types of the functions' parameters.
+        /// @param[in] is_variadic - True if the functions take additional arguments.
+        /// @return The function type.
+        const Type* GetFunctionType(const Type* const return_type, const std::vector<const Type*>& parameter_types, const bool is_variadic)
+        {
+            DerivedTypeKey key =
+            {
+                .Kind = TypeKind::FUNCTION,
+                .ElementType = return_type,
+                .ParameterTypes = parameter_types,
+                .IsVariadic = is_variadic,
+            };
+            return GetDerivedType(key, [&]()
+            {
+                std::string name = return_type->Name + "(";
+                for (std::size_t parameter_index = 0; parameter_index < parameter_types.size(); ++parameter_index)
+                {
+                    name += (parameter_index > 0 ? ", " : "") + parameter_types[parameter_index]->Name;
+                }
+                name += is_variadic ? (parameter_types.empty() ? "...)" : ", ...)") : ")";
+                return Type
+                {
+                    .Kind = TypeKind::FUNCTION,
+                    .Name = std::move(name),
+                    .ElementType = return_type,
+                    .ParameterTypes = parameter_types,
+                    .IsVariadic = is_variadic,
+                };
+            });
+        }
+
+        /// Applies integer promotions to a type.
+        /// @param[in] type - The type to promote.
+        /// @return Int for integers smaller than int; the type itself otherwise.
+        const Type* PromoteInteger(const Type* const type) const
+        {
+            bool promoted = (TypeKind::INTEGER == type->Kind && type->SizeInBytes < Int->SizeInBytes);
+            return promoted ? Int : type;
+        }
+
+        /// Gets the integer conversion rank of a type.
+        /// @param[in] type - An integer type.
+        /// @return The rank.  Types with larger ranks can represent at least as many values.
+        int GetIntegerRank(const Type* const type) const
+        {
+            if (type == LongLong || type == UnsignedLongLong) return 5;
+            if (type == Long || type == UnsignedLong) return 4;
+            if (type == Int || type == UnsignedInt) return 3;
+            if (type == Short || type == UnsignedShort) return 2;
+            return 1;
+        }
+
+        /// Gets the common type of two arithmetic operands (the usual arithmetic conversions).
+        /// @param[in] left_type - The type of the left operand.
+        /// @param[in] right_type - The type of the right operand.
+        /// @return The common type.
+        const Type* GetCommonArithmeticType(const Type* const left_type, const Type* const right_type) const
+        {
+            // USE THE LARGER FLOATING-POINT TYPE IF EITHER IS FLOATING-POINT.
+            if (TypeKind::FLOATING_POINT == left_type->Kind || TypeKind::FLOATING_POINT == right_type->Kind)
+            {
+                if (TypeKind::FLOATING_POINT != right_type->Kind)
+                {
+                    return left_type;
+                }
+                if (TypeKind::FLOATING_POINT != left_type->Kind)
+                {
+                    return right_type;
+                }
+                return (left_type->SizeInBytes >= right_type->SizeInBytes) ? left_type : right_type;
+            }
+
+            // CONVERT PROMOTED INTEGERS OF THE SAME SIGNEDNESS TO THE LARGER RANK.
+            const Type* promoted_left_type = PromoteInteger(left_type);
+            const Type* promoted_right_type = PromoteInteger(right_type);
+            if (promoted_left_type->IsSigned == promoted_right_type->IsSigned)
+            {
+                return (GetIntegerRank(promoted_left_type) >= GetIntegerRank(promoted_right_type)) ? promoted_left_type : promoted_right_type;
+            }
+
+            // OTHERWISE PREFER THE UNSIGNED TYPE UNLESS THE SIGNED ONE CAN HOLD ALL ITS VALUES.
+            const Type* unsigned_type = promoted_left_type->IsSigned ? promoted_right_type : promoted_left_type;
+            const Type* signed_type = promoted_left_type->IsSigned ? promoted_left_type : promoted_right_type;
+            if (GetIntegerRank(unsigned_type) >= GetIntegerRank(signed_type))
+            {
+                return unsigned_type;
+            }
+            if (signed_type->SizeInBytes > unsigned_type->SizeInBytes)
+            {
+                return signed_type;
+            }
+
+            // A signed type the same size as an unsigned one can't hold all its values.
+            return (signed_type == Long) ? UnsignedLong : UnsignedLongLong;
+        }
+
+        /// The number of distinct types created so far.
+        /// @return The number of types.
+        std::size_t TypeCount() const
+        {
+            return Types.size();
+        }
+
+        /// The size of pointers.
+        static constexpr std::size_t POINTER_SIZE_IN_BYTES = 8;
+
+        // BUILT-IN TYPES.
+        const Type* Void = nullptr;
+        const Type* Char = nullptr;
+        const Type* SignedChar = nullptr;
+        const Type* UnsignedChar = nullptr;
+        const Type* Short = nullptr;
+        const Type* UnsignedShort = nullptr;
+        const Type* Int = nullptr;
+        const Type* UnsignedInt = nullptr;
+        const Type* Long = nullptr;
+        const Type* UnsignedLong = nullptr;
+        const Type* LongLong = nullptr;
+        const Type* UnsignedLongLong = nullptr;
+        const Type* Float = nullptr;
+        const Type* Double = nullptr;
+        const Type* LongDouble = nullptr;
+
+    private:
+        /// Identifies a derived type by its structure.  Component types are
+        /// already interned, so they're compared and hashed by pointer.
+        struct DerivedTypeKey
+        {
+            /// The kind of derived type.
+            TypeKind Kind = TypeKind::VOID;
+            /// The pointed-to, element, or return type.
+            const Type* ElementType = nullptr;
+            /// The number of array elements.
+            std::size_t ElementCount = 0;
+            /// The function parameter types.
+            std::vector<const Type*> ParameterTypes = {};
+            /// True for variadic functions.
+            bool IsVariadic = false;
+
+            /// Compares keys for equality.
+            bool operator==(const DerivedTypeKey& other) const = default;
+        };
+
+        /// Hashes derived type keys.
+        struct DerivedTypeKeyHash
+        {
+            /// Hashes a key.
+            /// @param[in] key - The key to hash.
+            /// @return The hash.
+            std::size_t operator()(const DerivedTypeKey& key) const
+            {
+                std::uint64_t hash = static_cast<std::uint64_t>(key.Kind);
+                auto combine = [&hash](const std::uint64_t value)
+                {
+                    constexpr std::uint64_t MULTIPLIER = 0x9E3779B97F4A7C15;
+                    hash = (hash ^ value) * MULTIPLIER;
+                    hash ^= hash >> 29;
+                };
+                combine(reinterpret_cast<std::uintptr_t>(key.ElementType));
+                combine(key.ElementCount);
+                for (const Type* parameter_type : key.ParameterTypes)
+                {
+                    combine(reinterpret_cast<std::uintptr_t>(parameter_type));
+                }
+                combine(key.IsVariadic);
+                return static_cast<std::size_t>(hash);
+            }
+        };
+
+        /// Adds a built-in type.
+        /// @param[in] kind - The kind of type.
+        /// @param[in] name - The name of the type.
+        /// @param[in] size_in_bytes - The size of the type.
+        /// @param[in] is_signed - True if the type is signed.
+        /// @return The type.
+        const Type* AddBuiltInType(const TypeKind kind, const std::string& name, const std::size_t size_in_bytes, const bool is_signed)
+        {
+            const Type* type = &Types.emplace_back(Type
+            {
+                .Kind = kind,
+                .Name = name,
+                .SizeInBytes = size_in_bytes,
+                .IsSigned = is_signed,
+            });
+            TypesBySpelling.emplace(name, type);
+            return type;
+        }
+
+        /// Gets a derived type, creating it the first time it's needed.
+        /// @param[in] key - The structure of the type.
+        /// @param[in] create_type - Creates the type if it doesn't exist yet.
+        /// @return The type.
+        template <typename TypeCreator>
+        const Type* GetDerivedType(const DerivedTypeKey& key, const TypeCreator& create_type)
+        {
+            auto existing_type = DerivedTypesByKey.find(key);
+            if (DerivedTypesByKey.end() != existing_type)
+            {
+                return existing_type->second;
+            }
+
+            const Type* type = &Types.emplace_back(create_type());
+            DerivedTypesByKey.emplace(key, type);
+            return type;
+        }
+
+        /// All types.  A deque is used so that types never move once created.
+        std::deque<Type> Types = {};
+        /// Derived types by their structure.
+        std::unordered_map<DerivedTypeKey, const Type*, DerivedTypeKeyHash> DerivedTypesByKey = {};
+        /// Types (or null for invalid spellings) by spelling.
+        std::unordered_map<std::string, const Type*> TypesBySpelling = {};
+    };
+}
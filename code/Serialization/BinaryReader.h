@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace SERIALIZATION
+{
+    /// Reads values written by a BinaryWriter.
+    /// The reader never reads past the end of its data.  Any attempt to
+    /// do so returns null and leaves the reader in a failed state, so
+    /// truncated or corrupt data can be detected.
+    struct BinaryReader
+    {
+        /// Reads an unsigned 8-bit integer.
+        /// @return The value, if enough data remains; null otherwise.
+        std::optional<std::uint8_t> ReadUInt8()
+        {
+            std::optional<std::uint64_t> value = ReadLittleEndian(sizeof(std::uint8_t));
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            return static_cast<std::uint8_t>(*value);
+        }
+
+        /// Reads an unsigned 32-bit integer.
+        /// @return The value, if enough data remains; null otherwise.
+        std::optional<std::uint32_t> ReadUInt32()
+        {
+            std::optional<std::uint64_t> value = ReadLittleEndian(sizeof(std::uint32_t));
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            return static_cast<std::uint32_t>(*value);
+        }
+
+        /// Reads an unsigned 64-bit integer.
+        /// @return The value, if enough data remains; null otherwise.
+        std::optional<std::uint64_t> ReadUInt64()
+        {
+            return ReadLittleEndian(sizeof(std::uint64_t));
+        }
+
+        /// Reads a string prefixed with its 32-bit length.
+        /// @return A view of the string within the reader's data, if enough data remains; null otherwise.
+        std::optional<std::string_view> ReadString()
+        {
+            std::optional<std::uint32_t> length = ReadUInt32();
+            if (!length)
+            {
+                return std::nullopt;
+            }
+            return ReadBytes(*length);
+        }
+
+        /// Reads raw bytes.
+        /// @param[in] byte_count - The number of bytes to read.
+        /// @return A view of the bytes within the reader's data, if enough data remains; null otherwise.
+        std::optional<std::string_view> ReadBytes(const std::size_t byte_count)
+        {
+            bool enough_data_remains = !Failed && (byte_count <= Data.size() - CurrentOffset);
+            if (!enough_data_remains)
+            {
+                Failed = true;
+                return std::nullopt;
+            }
+
+            std::string_view bytes = Data.substr(CurrentOffset, byte_count);
+            CurrentOffset += byte_count;
+            return bytes;
+        }
+
+        /// The data being read.
+        std::string_view Data = {};
+        /// The offset of the next byte to read.
+        std::size_t CurrentOffset = 0;
+        /// True if an attempt was made to read past the end of the data.
+        bool Failed = false;
+
+    private:
+        /// Reads a little-endian integer.
+        /// @param[in] byte_count - The number of bytes in the integer.
+        /// @return The value, if enough data remains; null otherwise.
+        std::optional<std::uint64_t> ReadLittleEndian(const std::size_t byte_count)
+        {
+            std::optional<std::string_view> bytes = ReadBytes(byte_count);
+            if (!bytes)
+            {
+                return std::nullopt;
+            }
+
+            std::uint64_t value = 0;
+            for (std::size_t byte_index = byte_count; byte_index > 0; --byte_index)
+            {
+                value = (value << 8) | static_cast<unsigned char>((*bytes)[byte_index - 1]);
+            }
+            return value;
+        }
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace SERIALIZATION
+{
+    /// Appends values to a buffer in a compact binary form.
+    /// Integers are always written little-endian, regardless of the
+    /// platform, and strings are prefixed with their length.
+    struct BinaryWriter
+    {
+        /// Writes an unsigned 8-bit integer.
+        /// @param[in] value - The value to write.
+        void WriteUInt8(const std::uint8_t value)
+        {
+            Buffer.push_back(static_cast<char>(value));
+        }
+
+        /// Writes an unsigned 16-bit integer.
+        /// @param[in] value - The value to write.
+        void WriteUInt16(const std::uint16_t value)
+        {
+            WriteLittleEndian(value, sizeof(value));
+        }
+
+        /// Writes an unsigned 32-bit integer.
+        /// @param[in] value - The value to write.
+        void WriteUInt32(const std::uint32_t value)
+        {
+            WriteLittleEndian(value, sizeof(value));
+        }
+
+        /// Writes an unsigned 64-bit integer.
+        /// @param[in] value - The value to write.
+        void WriteUInt64(const std::uint64_t value)
+        {
+            WriteLittleEndian(value, sizeof(value));
+        }
+
+        /// Writes a string prefixed with its 32-bit length.
+        /// @param[in] value - The string to write.
+        void WriteString(const std::string_view value)
+        {
+            WriteUInt32(static_cast<std::uint32_t>(value.size()));
+            Buffer.append(value.data(), value.size());
+        }
+
+        /// Writes raw bytes with no length prefix.
+        /// @param[in] bytes - The bytes to write.
+        void WriteBytes(const std::string_view bytes)
+        {
+            Buffer.append(bytes.data(), bytes.size());
+        }
+
+        /// Overwrites a previously written unsigned 32-bit integer.
+        /// Useful for filling in sizes or offsets that aren't known until later data is written.
+        /// @param[in] offset - The offset of the integer in the buffer.
+        /// @param[in] value - The new value.
+        void OverwriteUInt32(const std::size_t offset, std::uint32_t value)
+        {
+            for (std::size_t byte_index = 0; byte_index < sizeof(value); ++byte_index)
+            {
+                Buffer[offset + byte_index] = static_cast<char>(value & 0xFF);
+                value >>= 8;
+            }
+        }
+
+        /// The buffer that values are written to.
+        std::string Buffer = "";
+
+    private:
+        /// Writes an integer in little-endian order.
+        /// @param[in] value - The value to write.
+        /// @param[in] byte_count - The number of bytes of the value to write.
+        void WriteLittleEndian(std::uint64_t value, const std::size_t byte_count)
+        {
+            for (std::size_t byte_index = 0; byte_index < byte_count; ++byte_index)
+            {
+                Buffer.push_back(static_cast<char>(value & 0xFF));
+                value >>= 8;
+            }
+        }
+    };
+}
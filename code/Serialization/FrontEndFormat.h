@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace SERIALIZATION
+{
+    /// Describes the binary format for front-end output (tokens and parsed programs).
+    ///
+    /// The format is designed to be memory-mapped and read in place:
+    /// - All integers are little-endian.
+    /// - Records have fixed sizes and are 4-byte aligned, so any record
+    ///   can be located directly from its index.
+    /// - References between parts of the file are offsets or indices
+    ///   rather than pointers.
+    /// - Strings are stored once in a string table, each prefixed with its
+    ///   32-bit length, and referenced by their offset within the table.
+    ///
+    /// The file starts with a header (see the HEADER_* offsets), followed by
+    /// the token records, node records, and string table.  The parsed
+    /// program is stored as a tree of generic nodes.  The children of
+    /// each node are stored contiguously after the node itself, and the
+    /// first ROOT_NODE_COUNT nodes are the top-level definitions and
+    /// declarations of the program.
+    ///
+    /// The format version must be incremented for any incompatible change.
+    struct FrontEndFormat
+    {
+        /// Identifies files in this format.  Includes a CRLF sequence to detect newline translation.
+        static constexpr std::string_view SIGNATURE = "CISHFE\r\n";
+        /// The current version of the format.
+        static constexpr std::uint32_t VERSION = 3;
+
+        // HEADER FIELD OFFSETS.
+        static constexpr std::size_t HEADER_SIGNATURE_OFFSET = 0;
+        static constexpr std::size_t HEADER_VERSION_OFFSET = 8;
+        static constexpr std::size_t HEADER_SIZE_OFFSET = 12;
+        static constexpr std::size_t HEADER_TOTAL_SIZE_OFFSET = 16;
+        static constexpr std::size_t HEADER_TOKEN_COUNT_OFFSET = 20;
+        static constexpr std::size_t HEADER_TOKENS_OFFSET_OFFSET = 24;
+        static constexpr std::size_t HEADER_NODE_COUNT_OFFSET = 28;
+        static constexpr std::size_t HEADER_NODES_OFFSET_OFFSET = 32;
+        static constexpr std::size_t HEADER_ROOT_NODE_COUNT_OFFSET = 36;
+        static constexpr std::size_t HEADER_STRINGS_OFFSET_OFFSET = 40;
+        static constexpr std::size_t HEADER_STRINGS_SIZE_OFFSET = 44;
+        /// The size of the header.
+        static constexpr std::size_t HEADER_SIZE_IN_BYTES = 48;
+
+        // TOKEN RECORD FIELD OFFSETS.
+        static constexpr std::size_t TOKEN_TYPE_OFFSET = 0;
+        static constexpr std::size_t TOKEN_VALUE_OFFSET = 4;
+        static constexpr std::size_t TOKEN_FILEPATH_OFFSET = 8;
+        static constexpr std::size_t TOKEN_LINE_NUMBER_OFFSET = 12;
+        static constexpr std::size_t TOKEN_COLUMN_NUMBER_OFFSET = 16;
+        /// The size of a token record.
+        static constexpr std::size_t TOKEN_RECORD_SIZE_IN_BYTES = 20;
+
+        // NODE RECORD FIELD OFFSETS.
+        static constexpr std::size_t NODE_KIND_OFFSET = 0;
+        static constexpr std::size_t NODE_FLAGS_OFFSET = 2;
+        static constexpr std::size_t NODE_TEXT_OFFSET = 4;
+        static constexpr std::size_t NODE_DETAIL_OFFSET = 8;
+        static constexpr std::size_t NODE_FIRST_CHILD_INDEX_OFFSET = 12;
+        static constexpr std::size_t NODE_CHILD_COUNT_OFFSET = 16;
+        static constexpr std::size_t NODE_LINE_NUMBER_OFFSET = 20;
+        static constexpr std::size_t NODE_FILEPATH_OFFSET = 24;
+        /// The size of a node record.
+        static constexpr std::size_t NODE_RECORD_SIZE_IN_BYTES = 28;
+
+        /// Set on functions that take a variable number of arguments.
+        static constexpr std::uint16_t FUNCTION_VARIADIC_FLAG = 0x1;
+        /// The bits holding the storage class (as a StorageClass value) of functions, parameters, and declarations.
+        static constexpr std::uint16_t STORAGE_CLASS_FLAGS_MASK = 0x70;
+        /// The position of the storage class within the flags.
+        static constexpr unsigned STORAGE_CLASS_FLAGS_SHIFT = 4;
+        /// Set on functions, parameters, and declarations whose base type is const.
+        static constexpr std::uint16_t CONST_FLAG = 0x80;
+        /// Set on functions, parameters, and declarations whose base type is volatile.
+        static constexpr std::uint16_t VOLATILE_FLAG = 0x100;
+        /// Set on for loops that have a condition.
+        static constexpr std::uint16_t FOR_HAS_CONDITION_FLAG = 0x1;
+        /// Set on for loops that have a step.
+        static constexpr std::uint16_t FOR_HAS_STEP_FLAG = 0x2;
+
+        /// The kinds of nodes in a parsed program.
+        /// Values are part of the format, so existing values must never change.
+        /// Only functions have a filepath; other nodes are in the same file as their function.
+        enum class NodeKind : std::uint16_t
+        {
+            INVALID = 0,
+            /// A function definition.  Text is the name, and detail is the return type.
+            /// Children are the parameters followed by the body.
+            FUNCTION_DEFINITION = 1,
+            /// A function parameter.  Text is the name, and detail is the data type.
+            PARAMETER = 2,
+            /// A block.  Children are the statements in the block.
+            BLOCK = 3,
+            /// A function declared without a definition.  Text is the name, and detail
+            /// is the return type.  Children are the parameters.
+            FUNCTION_DECLARATION = 4,
+
+            // STATEMENTS.
+            /// An empty statement.
+            EMPTY_STATEMENT = 5,
+            /// An expression statement.  The child is the expression.
+            EXPRESSION_STATEMENT = 6,
+            /// A local variable declaration.  Text is the name, and detail is the data type.
+            /// The child is the initializer, if any.
+            DECLARATION_STATEMENT = 7,
+            /// A return statement.  The child is the value, if any.
+            RETURN_STATEMENT = 8,
+            /// An if statement.  Children are the condition, the statement if true,
+            /// and the statement if false (if any).
+            IF_STATEMENT = 9,
+            /// A while loop.  Children are the condition and the loop's statement.
+            WHILE_STATEMENT = 10,
+            /// A do-while loop.  Children are the loop's statement and the condition.
+            DO_WHILE_STATEMENT = 11,
+            /// A for loop.  Children are the initializer statement, the condition and
+            /// step (if indicated by flags), and the loop's statement.
+            FOR_STATEMENT = 12,
+            /// A break statement.
+            BREAK_STATEMENT = 13,
+            /// A continue statement.
+            CONTINUE_STATEMENT = 14,
+
+            // EXPRESSIONS.
+            // Text is the expression's text (see ExpressionKind), and children are its operands.
+            CONSTANT_EXPRESSION = 15,
+            STRING_LITERAL_EXPRESSION = 16,
+            IDENTIFIER_EXPRESSION = 17,
+            UNARY_EXPRESSION = 18,
+            POSTFIX_EXPRESSION = 19,
+            BINARY_EXPRESSION = 20,
+            ASSIGNMENT_EXPRESSION = 21,
+            CONDITIONAL_EXPRESSION = 22,
+            CALL_EXPRESSION = 23,
+            INDEX_EXPRESSION = 24,
+        };
+
+        /// Reads a little-endian 16-bit value.
+        /// @param[in] bytes - The bytes to read from.
+        /// @return The value.
+        static std::uint16_t ReadUInt16(const char* bytes)
+        {
+            const unsigned char* unsigned_bytes = reinterpret_cast<const unsigned char*>(bytes);
+            std::uint16_t value = static_cast<std::uint16_t>(unsigned_bytes[0] | (unsigned_bytes[1] << 8));
+            return value;
+        }
+
+        /// Reads a little-endian 32-bit value.
+        /// @param[in] bytes - The bytes to read from.
+        /// @return The value.
+        static std::uint32_t ReadUInt32(const char* bytes)
+        {
+            const unsigned char* unsigned_bytes = reinterpret_cast<const unsigned char*>(bytes);
+            std::uint32_t value =
+                static_cast<std::uint32_t>(unsigned_bytes[0]) |
+                (static_cast<std::uint32_t>(unsigned_bytes[1]) << 8) |
+                (static_cast<std::uint32_t>(unsigned_bytes[2]) << 16) |
+                (static_cast<std::uint32_t>(unsigned_bytes[3]) << 24);
+            return value;
+        }
+    };
+}
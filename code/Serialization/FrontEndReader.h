@@ -0,0 +1,563 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Serialization/FrontEndFormat.h"
+#include "Tokenization/TokenStream.h"
+
+namespace SERIALIZATION
+{
+    /// A token read in place from binary front-end data.
+    struct TokenView
+    {
+        /// The type of the token.
+        TOKENIZATION::TokenType Type = TOKENIZATION::TokenType::INVALID;
+        /// The raw value of the token.
+        std::string_view Value = {};
+        /// The path of the file from which the token came.
+        std::string_view Filepath = {};
+        /// The line number in the file from which the token came.
+        std::uint32_t LineNumber = 0;
+        /// The column number in the file from which the token came.
+        std::uint32_t ColumnNumber = 0;
+    };
+
+    /// A node of a parsed program read in place from binary front-end data.
+    struct NodeView
+    {
+        /// The kind of node.
+        FrontEndFormat::NodeKind Kind = FrontEndFormat::NodeKind::INVALID;
+        /// Flags specific to the kind of node.
+        std::uint16_t Flags = 0;
+        /// The primary text of the node.
+        std::string_view Text = {};
+        /// The secondary text of the node.
+        std::string_view Detail = {};
+        /// The index of the node's first child.
+        std::uint32_t FirstChildIndex = 0;
+        /// The number of children of the node.
+        std::uint32_t ChildCount = 0;
+        /// The line of the source code for the node.
+        std::uint32_t LineNumber = 0;
+        /// The path of the file containing the node, for functions.
+        std::string_view Filepath = {};
+    };
+
+    /// Reads binary front-end data in place without copying it.
+    /// The data (typically a memory-mapped file) must outlive the reader
+    /// and any views obtained from it.
+    struct FrontEndReader
+    {
+        /// Opens binary front-end data for reading.
+        /// The header and all records are validated, so later accesses
+        /// by in-range index can't read outside of the data.
+        /// @param[in] data - The data to read.
+        /// @return A reader for the data, if it's valid; null otherwise.
+        static std::optional<FrontEndReader> Open(const std::string_view data)
+        {
+            // VALIDATE THE HEADER.
+            bool header_exists = (data.size() >= FrontEndFormat::HEADER_SIZE_IN_BYTES);
+            if (!header_exists)
+            {
+                return std::nullopt;
+            }
+
+            FrontEndReader reader;
+            reader.Data = data;
+            bool header_valid = (
+                FrontEndFormat::SIGNATURE == data.substr(FrontEndFormat::HEADER_SIGNATURE_OFFSET, FrontEndFormat::SIGNATURE.size()) &&
+                FrontEndFormat::VERSION == reader.ReadHeaderField(FrontEndFormat::HEADER_VERSION_OFFSET) &&
+                FrontEndFormat::HEADER_SIZE_IN_BYTES == reader.ReadHeaderField(FrontEndFormat::HEADER_SIZE_OFFSET) &&
+                data.size() == reader.ReadHeaderField(FrontEndFormat::HEADER_TOTAL_SIZE_OFFSET));
+            if (!header_valid)
+            {
+                return std::nullopt;
+            }
+
+            // VALIDATE THE SECTIONS ARE WITHIN THE DATA.
+            reader.TokenCount = reader.ReadHeaderField(FrontEndFormat::HEADER_TOKEN_COUNT_OFFSET);
+            reader.TokensOffset = reader.ReadHeaderField(FrontEndFormat::HEADER_TOKENS_OFFSET_OFFSET);
+            reader.NodeCount = reader.ReadHeaderField(FrontEndFormat::HEADER_NODE_COUNT_OFFSET);
+            reader.NodesOffset = reader.ReadHeaderField(FrontEndFormat::HEADER_NODES_OFFSET_OFFSET);
+            reader.RootNodeCount = reader.ReadHeaderField(FrontEndFormat::HEADER_ROOT_NODE_COUNT_OFFSET);
+            reader.StringsOffset = reader.ReadHeaderField(FrontEndFormat::HEADER_STRINGS_OFFSET_OFFSET);
+            reader.StringsSize = reader.ReadHeaderField(FrontEndFormat::HEADER_STRINGS_SIZE_OFFSET);
+            bool sections_valid = (
+                IsRangeWithin(reader.TokensOffset, static_cast<std::uint64_t>(reader.TokenCount) * FrontEndFormat::TOKEN_RECORD_SIZE_IN_BYTES, data.size()) &&
+                IsRangeWithin(reader.NodesOffset, static_cast<std::uint64_t>(reader.NodeCount) * FrontEndFormat::NODE_RECORD_SIZE_IN_BYTES, data.size()) &&
+                IsRangeWithin(reader.StringsOffset, reader.StringsSize, data.size()) &&
+                reader.RootNodeCount <= reader.NodeCount);
+            if (!sections_valid)
+            {
+                return std::nullopt;
+            }
+
+            // VALIDATE ALL REFERENCES WITHIN RECORDS.
+            for (std::uint32_t token_index = 0; token_index < reader.TokenCount; ++token_index)
+            {
+                const char* record = reader.Data.data() + reader.TokensOffset + token_index * FrontEndFormat::TOKEN_RECORD_SIZE_IN_BYTES;
+                bool token_valid = (
+                    reader.IsStringValid(FrontEndFormat::ReadUInt32(record + FrontEndFormat::TOKEN_VALUE_OFFSET)) &&
+                    reader.IsStringValid(FrontEndFormat::ReadUInt32(record + FrontEndFormat::TOKEN_FILEPATH_OFFSET)));
+                if (!token_valid)
+                {
+                    return std::nullopt;
+                }
+            }
+            for (std::uint32_t node_index = 0; node_index < reader.NodeCount; ++node_index)
+            {
+                const char* record = reader.Data.data() + reader.NodesOffset + node_index * FrontEndFormat::NODE_RECORD_SIZE_IN_BYTES;
+                std::uint64_t first_child_index = FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_FIRST_CHILD_INDEX_OFFSET);
+                std::uint64_t child_count = FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_CHILD_COUNT_OFFSET);
+                std::uint16_t flags = FrontEndFormat::ReadUInt16(record + FrontEndFormat::NODE_FLAGS_OFFSET);
+                unsigned storage_class = (flags & FrontEndFormat::STORAGE_CLASS_FLAGS_MASK) >> FrontEndFormat::STORAGE_CLASS_FLAGS_SHIFT;
+                // Children always follow their parent, which rules out cycles.
+                bool node_valid = (
+                    reader.IsStringValid(FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_TEXT_OFFSET)) &&
+                    reader.IsStringValid(FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_DETAIL_OFFSET)) &&
+                    reader.IsStringValid(FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_FILEPATH_OFFSET)) &&
+                    (first_child_index + child_count <= reader.NodeCount) &&
+                    (0 == child_count || first_child_index > node_index) &&
+                    (storage_class <= static_cast<unsigned>(StorageClass::AUTO)));
+                if (!node_valid)
+                {
+                    return std::nullopt;
+                }
+            }
+
+            return reader;
+        }
+
+        /// Gets a token.
+        /// @param[in] token_index - The index of the token.  Must be less than TokenCount.
+        /// @return The token.
+        TokenView GetToken(const std::uint32_t token_index) const
+        {
+            const char* record = Data.data() + TokensOffset + token_index * FrontEndFormat::TOKEN_RECORD_SIZE_IN_BYTES;
+            TokenView token =
+            {
+                .Type = static_cast<TOKENIZATION::TokenType>(FrontEndFormat::ReadUInt32(record + FrontEndFormat::TOKEN_TYPE_OFFSET)),
+                .Value = GetString(FrontEndFormat::ReadUInt32(record + FrontEndFormat::TOKEN_VALUE_OFFSET)),
+                .Filepath = GetString(FrontEndFormat::ReadUInt32(record + FrontEndFormat::TOKEN_FILEPATH_OFFSET)),
+                .LineNumber = FrontEndFormat::ReadUInt32(record + FrontEndFormat::TOKEN_LINE_NUMBER_OFFSET),
+                .ColumnNumber = FrontEndFormat::ReadUInt32(record + FrontEndFormat::TOKEN_COLUMN_NUMBER_OFFSET),
+            };
+            return token;
+        }
+
+        /// Gets a node.
+        /// @param[in] node_index - The index of the node.  Must be less than NodeCount.
+        /// @return The node.
+        NodeView GetNode(const std::uint32_t node_index) const
+        {
+            const char* record = Data.data() + NodesOffset + node_index * FrontEndFormat::NODE_RECORD_SIZE_IN_BYTES;
+            NodeView node =
+            {
+                .Kind = static_cast<FrontEndFormat::NodeKind>(FrontEndFormat::ReadUInt16(record + FrontEndFormat::NODE_KIND_OFFSET)),
+                .Flags = FrontEndFormat::ReadUInt16(record + FrontEndFormat::NODE_FLAGS_OFFSET),
+                .Text = GetString(FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_TEXT_OFFSET)),
+                .Detail = GetString(FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_DETAIL_OFFSET)),
+                .FirstChildIndex = FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_FIRST_CHILD_INDEX_OFFSET),
+                .ChildCount = FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_CHILD_COUNT_OFFSET),
+                .LineNumber = FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_LINE_NUMBER_OFFSET),
+                .Filepath = GetString(FrontEndFormat::ReadUInt32(record + FrontEndFormat::NODE_FILEPATH_OFFSET)),
+            };
+            return node;
+        }
+
+        /// Copies all tokens into a token stream.
+        /// @return The token stream.
+        TOKENIZATION::TokenStream ToTokenStream() const
+        {
+            TOKENIZATION::TokenStream token_stream;
+            token_stream.Tokens.reserve(TokenCount);
+            for (std::uint32_t token_index = 0; token_index < TokenCount; ++token_index)
+            {
+                TokenView token = GetToken(token_index);
+                token_stream.Tokens.push_back(TOKENIZATION::Token
+                {
+                    .Type = token.Type,
+                    .Value = std::string(token.Value),
+                    .Filepath = std::string(token.Filepath),
+                    .LineNumber = token.LineNumber,
+                    .ColumnNumber = token.ColumnNumber,
+                });
+            }
+            return token_stream;
+        }
+
+        /// Copies the parsed program.
+        /// @return The program, if the nodes form a valid program; null otherwise.
+        std::optional<Program> ToProgram() const
+        {
+            Program program;
+            for (std::uint32_t root_node_index = 0; root_node_index < RootNodeCount; ++root_node_index)
+            {
+                NodeView root_node = GetNode(root_node_index);
+
+                // READ ANY FUNCTION DECLARATION.
+                if (FrontEndFormat::NodeKind::FUNCTION_DECLARATION == root_node.Kind)
+                {
+                    std::optional<FunctionHeader> function_header = ReadFunctionHeader(root_node, root_node.ChildCount);
+                    if (!function_header)
+                    {
+                        return std::nullopt;
+                    }
+                    std::string function_name = function_header->Name;
+                    program.FunctionDeclarationsByName[function_name] = std::move(*function_header);
+                    continue;
+                }
+
+                // READ THE FUNCTION.
+                bool is_function = (FrontEndFormat::NodeKind::FUNCTION_DEFINITION == root_node.Kind && root_node.ChildCount > 0);
+                if (!is_function)
+                {
+                    return std::nullopt;
+                }
+
+                // The last child is the body.
+                std::uint32_t parameter_count = root_node.ChildCount - 1;
+                std::optional<FunctionHeader> function_header = ReadFunctionHeader(root_node, parameter_count);
+                if (!function_header)
+                {
+                    return std::nullopt;
+                }
+                FunctionDefinition function_definition = { .Header = std::move(*function_header) };
+
+                NodeView body_node = GetNode(root_node.FirstChildIndex + parameter_count);
+                if (FrontEndFormat::NodeKind::BLOCK != body_node.Kind)
+                {
+                    return std::nullopt;
+                }
+                std::optional<Statement> body = ReadStatement(body_node);
+                if (!body)
+                {
+                    return std::nullopt;
+                }
+                function_definition.Body.Statements = std::move(body->Body);
+
+                std::string function_name = function_definition.Header.Name;
+                program.FunctionsByName[function_name] = std::move(function_definition);
+            }
+            return program;
+        }
+
+        /// The number of tokens.
+        std::uint32_t TokenCount = 0;
+        /// The number of nodes.
+        std::uint32_t NodeCount = 0;
+        /// The number of top-level nodes, which are always the first nodes.
+        std::uint32_t RootNodeCount = 0;
+
+    private:
+        /// Checks if a range of bytes is within data of a given size.
+        /// @param[in] offset - The offset of the range.
+        /// @param[in] size_in_bytes - The size of the range.
+        /// @param[in] data_size_in_bytes - The size of the data.
+        /// @return True if the range is within the data; false otherwise.
+        static bool IsRangeWithin(const std::uint64_t offset, const std::uint64_t size_in_bytes, const std::uint64_t data_size_in_bytes)
+        {
+            bool range_within_data = (offset <= data_size_in_bytes) && (size_in_bytes <= data_size_in_bytes - offset);
+            return range_within_data;
+        }
+
+        /// Reads a field from the header.
+        /// @param[in] field_offset - The offset of the field.
+        /// @return The value of the field.
+        std::uint32_t ReadHeaderField(const std::size_t field_offset) const
+        {
+            return FrontEndFormat::ReadUInt32(Data.data() + field_offset);
+        }
+
+        /// Checks if a string reference is within the string table.
+        /// @param[in] string_offset - The offset of the string in the string table.
+        /// @return True if the entire string is within the string table; false otherwise.
+        bool IsStringValid(const std::uint32_t string_offset) const
+        {
+            constexpr std::uint64_t LENGTH_SIZE_IN_BYTES = sizeof(std::uint32_t);
+            bool length_within_table = IsRangeWithin(string_offset, LENGTH_SIZE_IN_BYTES, StringsSize);
+            if (!length_within_table)
+            {
+                return false;
+            }
+
+            std::uint32_t length = FrontEndFormat::ReadUInt32(Data.data() + StringsOffset + string_offset);
+            bool string_within_table = IsRangeWithin(static_cast<std::uint64_t>(string_offset) + LENGTH_SIZE_IN_BYTES, length, StringsSize);
+            return string_within_table;
+        }
+
+        /// Gets a string from the string table.
+        /// @param[in] string_offset - The offset of the string in the string table.  Must be valid.
+        /// @return The string.
+        std::string_view GetString(const std::uint32_t string_offset) const
+        {
+            const char* length_start = Data.data() + StringsOffset + string_offset;
+            std::uint32_t length = FrontEndFormat::ReadUInt32(length_start);
+            return std::string_view(length_start + sizeof(length), length);
+        }
+
+        /// Reads the storage class and qualifiers of a declaration.
+        /// @param[in] flags - The flags of the node for the declaration.
+        /// @return The specifiers recorded in the flags.
+        static DeclarationSpecifiers ReadSpecifiers(const std::uint16_t flags)
+        {
+            DeclarationSpecifiers specifiers =
+            {
+                .Storage = static_cast<StorageClass>((flags & FrontEndFormat::STORAGE_CLASS_FLAGS_MASK) >> FrontEndFormat::STORAGE_CLASS_FLAGS_SHIFT),
+                .IsConst = (0 != (flags & FrontEndFormat::CONST_FLAG)),
+                .IsVolatile = (0 != (flags & FrontEndFormat::VOLATILE_FLAG)),
+            };
+            return specifiers;
+        }
+
+        /// Reads a function header.
+        /// @param[in] function_node - The node for the function.
+        /// @param[in] parameter_count - The number of leading children that are parameters.
+        /// @return The header, if the nodes are valid; null otherwise.
+        std::optional<FunctionHeader> ReadFunctionHeader(const NodeView& function_node, const std::uint32_t parameter_count) const
+        {
+            FunctionHeader function_header =
+            {
+                .Name = std::string(function_node.Text),
+                .ReturnType = std::string(function_node.Detail),
+                .IsVariadic = (0 != (function_node.Flags & FrontEndFormat::FUNCTION_VARIADIC_FLAG)),
+                .Filepath = std::string(function_node.Filepath),
+                .LineNumber = function_node.LineNumber,
+                .Specifiers = ReadSpecifiers(function_node.Flags),
+            };
+
+            for (std::uint32_t parameter_index = 0; parameter_index < parameter_count; ++parameter_index)
+            {
+                NodeView parameter_node = GetNode(function_node.FirstChildIndex + parameter_index);
+                if (FrontEndFormat::NodeKind::PARAMETER != parameter_node.Kind)
+                {
+                    return std::nullopt;
+                }
+
+                function_header.Parameters.push_back(VariableDeclaration
+                {
+                    .DataType = std::string(parameter_node.Detail),
+                    .Name = std::string(parameter_node.Text),
+                    .Specifiers = ReadSpecifiers(parameter_node.Flags),
+                });
+            }
+            return function_header;
+        }
+
+        /// Reads a statement.
+        /// @param[in] statement_node - The node for the statement.
+        /// @return The statement, if the nodes are valid; null otherwise.
+        std::optional<Statement> ReadStatement(const NodeView& statement_node) const
+        {
+            using NodeKind = FrontEndFormat::NodeKind;
+
+            // DETERMINE THE EXPECTED CHILDREN.
+            // Each character describes a child: 'E' for an expression, 'e' for an optional
+            // expression, 'S' for a statement, and 's' for an optional statement.
+            Statement statement = { .LineNumber = statement_node.LineNumber };
+            std::string_view children_layout = "";
+            switch (statement_node.Kind)
+            {
+                case NodeKind::BLOCK:
+                    statement.Kind = StatementKind::BLOCK;
+                    break;
+                case NodeKind::EMPTY_STATEMENT:
+                    statement.Kind = StatementKind::EMPTY;
+                    break;
+                case NodeKind::EXPRESSION_STATEMENT:
+                    statement.Kind = StatementKind::EXPRESSION;
+                    children_layout = "E";
+                    break;
+                case NodeKind::DECLARATION_STATEMENT:
+                    statement.Kind = StatementKind::DECLARATION;
+                    statement.Declaration = VariableDeclaration { .DataType = std::string(statement_node.Detail), .Name = std::string(statement_node.Text), .Specifiers = ReadSpecifiers(statement_node.Flags) };
+                    children_layout = "e";
+                    break;
+                case NodeKind::RETURN_STATEMENT:
+                    statement.Kind = StatementKind::RETURN;
+                    children_layout = "e";
+                    break;
+                case NodeKind::IF_STATEMENT:
+                    statement.Kind = StatementKind::IF;
+                    children_layout = "ESs";
+                    break;
+                case NodeKind::WHILE_STATEMENT:
+                    statement.Kind = StatementKind::WHILE;
+                    children_layout = "ES";
+                    break;
+                case NodeKind::DO_WHILE_STATEMENT:
+                    statement.Kind = StatementKind::DO_WHILE;
+                    children_layout = "SE";
+                    break;
+                case NodeKind::FOR_STATEMENT:
+                {
+                    statement.Kind = StatementKind::FOR;
+                    bool has_condition = (0 != (statement_node.Flags & FrontEndFormat::FOR_HAS_CONDITION_FLAG));
+                    bool has_step = (0 != (statement_node.Flags & FrontEndFormat::FOR_HAS_STEP_FLAG));
+                    children_layout = has_condition ? (has_step ? "SEES" : "SES") : (has_step ? "SES" : "SS");
+                    break;
+                }
+                case NodeKind::BREAK_STATEMENT:
+                    statement.Kind = StatementKind::BREAK;
+                    break;
+                case NodeKind::CONTINUE_STATEMENT:
+                    statement.Kind = StatementKind::CONTINUE;
+                    break;
+                default:
+                    return std::nullopt;
+            }
+
+            // READ BLOCKS.
+            if (StatementKind::BLOCK == statement.Kind)
+            {
+                for (std::uint32_t child_index = 0; child_index < statement_node.ChildCount; ++child_index)
+                {
+                    std::optional<Statement> child_statement = ReadStatement(GetNode(statement_node.FirstChildIndex + child_index));
+                    if (!child_statement)
+                    {
+                        return std::nullopt;
+                    }
+                    statement.Body.push_back(std::move(*child_statement));
+                }
+                return statement;
+            }
+
+            // READ THE CHILDREN OF OTHER STATEMENTS.
+            std::size_t required_child_count = static_cast<std::size_t>(std::count_if(
+                children_layout.begin(),
+                children_layout.end(),
+                [](const char child) { return 'E' == child || 'S' == child; }));
+            bool child_count_valid = (statement_node.ChildCount >= required_child_count && statement_node.ChildCount <= children_layout.size());
+            if (!child_count_valid)
+            {
+                return std::nullopt;
+            }
+            std::vector<Expression> child_expressions;
+            for (std::uint32_t child_index = 0; child_index < statement_node.ChildCount; ++child_index)
+            {
+                NodeView child_node = GetNode(statement_node.FirstChildIndex + child_index);
+                char child_layout = children_layout[child_index];
+                if ('E' == child_layout || 'e' == child_layout)
+                {
+                    std::optional<Expression> child_expression = ReadExpression(child_node);
+                    if (!child_expression)
+                    {
+                        return std::nullopt;
+                    }
+                    child_expressions.push_back(std::move(*child_expression));
+                }
+                else
+                {
+                    std::optional<Statement> child_statement = ReadStatement(child_node);
+                    if (!child_statement)
+                    {
+                        return std::nullopt;
+                    }
+                    statement.Body.push_back(std::move(*child_statement));
+                }
+            }
+
+            // ASSIGN THE EXPRESSIONS TO THEIR ROLES.
+            if (StatementKind::IF == statement.Kind || StatementKind::WHILE == statement.Kind || StatementKind::DO_WHILE == statement.Kind)
+            {
+                statement.Condition = std::move(child_expressions.front());
+            }
+            else if (StatementKind::FOR == statement.Kind)
+            {
+                std::size_t expression_index = 0;
+                if (0 != (statement_node.Flags & FrontEndFormat::FOR_HAS_CONDITION_FLAG))
+                {
+                    statement.Condition = std::move(child_expressions[expression_index]);
+                    ++expression_index;
+                }
+                if (0 != (statement_node.Flags & FrontEndFormat::FOR_HAS_STEP_FLAG))
+                {
+                    statement.Step = std::move(child_expressions[expression_index]);
+                }
+            }
+            else if (!child_expressions.empty())
+            {
+                statement.Value = std::move(child_expressions.front());
+            }
+            return statement;
+        }
+
+        /// Reads an expression.
+        /// @param[in] expression_node - The node for the expression.
+        /// @return The expression, if the nodes are valid; null otherwise.
+        std::optional<Expression> ReadExpression(const NodeView& expression_node) const
+        {
+            using NodeKind = FrontEndFormat::NodeKind;
+
+            Expression expression = { .Text = std::string(expression_node.Text), .LineNumber = expression_node.LineNumber };
+            switch (expression_node.Kind)
+            {
+                case NodeKind::CONSTANT_EXPRESSION: expression.Kind = ExpressionKind::CONSTANT; break;
+                case NodeKind::STRING_LITERAL_EXPRESSION: expression.Kind = ExpressionKind::STRING_LITERAL; break;
+                case NodeKind::IDENTIFIER_EXPRESSION: expression.Kind = ExpressionKind::IDENTIFIER; break;
+                case NodeKind::UNARY_EXPRESSION: expression.Kind = ExpressionKind::UNARY; break;
+                case NodeKind::POSTFIX_EXPRESSION: expression.Kind = ExpressionKind::POSTFIX; break;
+                case NodeKind::BINARY_EXPRESSION: expression.Kind = ExpressionKind::BINARY; break;
+                case NodeKind::ASSIGNMENT_EXPRESSION: expression.Kind = ExpressionKind::ASSIGNMENT; break;
+                case NodeKind::CONDITIONAL_EXPRESSION: expression.Kind = ExpressionKind::CONDITIONAL; break;
+                case NodeKind::CALL_EXPRESSION: expression.Kind = ExpressionKind::CALL; break;
+                case NodeKind::INDEX_EXPRESSION: expression.Kind = ExpressionKind::INDEX; break;
+                default: return std::nullopt;
+            }
+
+            // Operand counts are checked so that later code can rely on them.
+            std::uint32_t expected_operand_count = 0;
+            switch (expression.Kind)
+            {
+                case ExpressionKind::UNARY:
+                case ExpressionKind::POSTFIX:
+                    expected_operand_count = 1;
+                    break;
+                case ExpressionKind::BINARY:
+                case ExpressionKind::ASSIGNMENT:
+                case ExpressionKind::INDEX:
+                    expected_operand_count = 2;
+                    break;
+                case ExpressionKind::CONDITIONAL:
+                    expected_operand_count = 3;
+                    break;
+                case ExpressionKind::CALL:
+                    expected_operand_count = expression_node.ChildCount;
+                    break;
+                default:
+                    break;
+            }
+            if (expected_operand_count != expression_node.ChildCount)
+            {
+                return std::nullopt;
+            }
+
+            for (std::uint32_t operand_index = 0; operand_index < expression_node.ChildCount; ++operand_index)
+            {
+                std::optional<Expression> operand = ReadExpression(GetNode(expression_node.FirstChildIndex + operand_index));
+                if (!operand)
+                {
+                    return std::nullopt;
+                }
+                expression.Operands.push_back(std::move(*operand));
+            }
+            return expression;
+        }
+
+        /// The data being read.
+        std::string_view Data = {};
+        /// The offset of the first token record.
+        std::uint32_t TokensOffset = 0;
+        /// The offset of the first node record.
+        std::uint32_t NodesOffset = 0;
+        /// The offset of the string table.
+        std::uint32_t StringsOffset = 0;
+        /// The size of the string table.
+        std::uint32_t StringsSize = 0;
+    };
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Serialization/FrontEndReader.h"
+#include "Serialization/FrontEndWriter.h"
+#include "Tokenization/TokenStream.h"
+
+namespace SERIALIZATION
+{
+    /// Verifies that front-end output survives conversion to and from
+    /// the binary format without any changes.
+    struct FrontEndRoundTripChecker
+    {
+        /// Checks that tokens and a program round-trip through the binary format.
+        /// Data is written, read back in place, compared against the original,
+        /// then written again to confirm the output is byte-for-byte identical.
+        /// @param[in] token_stream - The tokens to check.
+        /// @param[in] program - The program to check.
+        /// @return A description of the first difference found; null if the round-trip succeeded.
+        static std::optional<std::string> Check(const TOKENIZATION::TokenStream& token_stream, const Program& program)
+        {
+            // WRITE AND READ BACK THE DATA.
+            std::string binary_data = FrontEndWriter::Write(token_stream, program);
+            std::optional<FrontEndReader> reader = FrontEndReader::Open(binary_data);
+            if (!reader)
+            {
+                return "Written data could not be opened.";
+            }
+
+            // COMPARE THE TOKENS IN PLACE.
+            if (reader->TokenCount != token_stream.Tokens.size())
+            {
+                return "Token count changed from " + std::to_string(token_stream.Tokens.size()) + " to " + std::to_string(reader->TokenCount) + ".";
+            }
+            for (std::uint32_t token_index = 0; token_index < reader->TokenCount; ++token_index)
+            {
+                const TOKENIZATION::Token& original_token = token_stream.Tokens[token_index];
+                TokenView read_token = reader->GetToken(token_index);
+                bool tokens_match = (
+                    original_token.Type == read_token.Type &&
+                    original_token.Value == read_token.Value &&
+                    original_token.Filepath == read_token.Filepath &&
+                    original_token.LineNumber == read_token.LineNumber &&
+                    original_token.ColumnNumber == read_token.ColumnNumber);
+                if (!tokens_match)
+                {
+                    return "Token " + std::to_string(token_index) + " (" + original_token.Value + ") changed.";
+                }
+            }
+
+            // COMPARE THE PROGRAM.
+            std::optional<Program> read_program = reader->ToProgram();
+            if (!read_program)
+            {
+                return "Program could not be read.";
+            }
+            if (read_program->FunctionsByName.size() != program.FunctionsByName.size())
+            {
+                return "Function count changed.";
+            }
+            for (const auto& [function_name, original_function] : program.FunctionsByName)
+            {
+                auto read_function = read_program->FunctionsByName.find(function_name);
+                if (read_program->FunctionsByName.end() == read_function)
+                {
+                    return "Function " + function_name + " is missing.";
+                }
+
+                std::optional<std::string> function_difference = CompareFunctions(original_function, read_function->second);
+                if (function_difference)
+                {
+                    return "Function " + function_name + ": " + *function_difference;
+                }
+            }
+            if (read_program->FunctionDeclarationsByName.size() != program.FunctionDeclarationsByName.size())
+            {
+                return "Function declaration count changed.";
+            }
+            for (const auto& [function_name, original_header] : program.FunctionDeclarationsByName)
+            {
+                auto read_header = read_program->FunctionDeclarationsByName.find(function_name);
+                if (read_program->FunctionDeclarationsByName.end() == read_header)
+                {
+                    return "Function declaration " + function_name + " is missing.";
+                }
+
+                std::optional<std::string> header_difference = CompareFunctionHeaders(original_header, read_header->second);
+                if (header_difference)
+                {
+                    return "Function declaration " + function_name + ": " + *header_difference;
+                }
+            }
+
+            // CONFIRM THE DATA IS IDENTICAL WHEN WRITTEN AGAIN.
+            std::string rewritten_binary_data = FrontEndWriter::Write(reader->ToTokenStream(), *read_program);
+            if (rewritten_binary_data != binary_data)
+            {
+                return "Rewritten data differs from the original data.";
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        /// Compares two function definitions.
+        /// @param[in] original_function - The original function.
+        /// @param[in] read_function - The function read back from binary data.
+        /// @return A description of the first difference found; null if the functions match.
+        static std::optional<std::string> CompareFunctions(const FunctionDefinition& original_function, const FunctionDefinition& read_function)
+        {
+            std::optional<std::string> header_difference = CompareFunctionHeaders(original_function.Header, read_function.Header);
+            if (header_difference)
+            {
+                return header_difference;
+            }
+
+            bool bodies_match = StatementsMatch(original_function.Body.Statements, read_function.Body.Statements);
+            if (!bodies_match)
+            {
+                return "Body changed.";
+            }
+            return std::nullopt;
+        }
+
+        /// Compares two function headers.
+        /// @param[in] original_header - The original header.
+        /// @param[in] read_header - The header read back from binary data.
+        /// @return A description of the first difference found; null if the headers match.
+        static std::optional<std::string> CompareFunctionHeaders(const FunctionHeader& original_header, const FunctionHeader& read_header)
+        {
+            if (original_header.ReturnType != read_header.ReturnType)
+            {
+                return "Return type changed.";
+            }
+            if (original_header.IsVariadic != read_header.IsVariadic)
+            {
+                return "Variadic flag changed.";
+            }
+            if (original_header.Specifiers != read_header.Specifiers)
+            {
+                return "Specifiers changed.";
+            }
+            if (original_header.Filepath != read_header.Filepath || original_header.LineNumber != read_header.LineNumber)
+            {
+                return "Position changed.";
+            }
+            if (original_header.Parameters.size() != read_header.Parameters.size())
+            {
+                return "Parameter count changed.";
+            }
+            for (std::size_t parameter_index = 0; parameter_index < original_header.Parameters.size(); ++parameter_index)
+            {
+                const VariableDeclaration& original_parameter = original_header.Parameters[parameter_index];
+                const VariableDeclaration& read_parameter = read_header.Parameters[parameter_index];
+                bool parameters_match = (
+                    original_parameter.DataType == read_parameter.DataType &&
+                    original_parameter.Name == read_parameter.Name &&
+                    original_parameter.Specifiers == read_parameter.Specifiers);
+                if (!parameters_match)
+                {
+                    return "Parameter " + std::to_string(parameter_index) + " changed.";
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        /// Compares two lists of statements, including all nested statements and expressions.
+        /// @param[in] original_statements - The original statements.
+        /// @param[in] read_statements - The statements read back from binary data.
+        /// @return True if the statements match; false otherwise.
+        static bool StatementsMatch(const std::vector<Statement>& original_statements, const std::vector<Statement>& read_statements)
+        {
+            if (original_statements.size() != read_statements.size())
+            {
+                return false;
+            }
+            for (std::size_t statement_index = 0; statement_index < original_statements.size(); ++statement_index)
+            {
+                const Statement& original_statement = original_statements[statement_index];
+                const Statement& read_statement = read_statements[statement_index];
+                bool statements_match = (
+                    original_statement.Kind == read_statement.Kind &&
+                    original_statement.Declaration.DataType == read_statement.Declaration.DataType &&
+                    original_statement.Declaration.Name == read_statement.Declaration.Name &&
+                    original_statement.Declaration.Specifiers == read_statement.Declaration.Specifiers &&
+                    original_statement.LineNumber == read_statement.LineNumber &&
+                    OptionalExpressionsMatch(original_statement.Value, read_statement.Value) &&
+                    OptionalExpressionsMatch(original_statement.Condition, read_statement.Condition) &&
+                    OptionalExpressionsMatch(original_statement.Step, read_statement.Step) &&
+                    StatementsMatch(original_statement.Body, read_statement.Body));
+                if (!statements_match)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Compares two optional expressions.
+        /// @param[in] original_expression - The original expression, if any.
+        /// @param[in] read_expression - The expression read back from binary data, if any.
+        /// @return True if the expressions match (or are both absent); false otherwise.
+        static bool OptionalExpressionsMatch(const std::optional<Expression>& original_expression, const std::optional<Expression>& read_expression)
+        {
+            if (original_expression.has_value() != read_expression.has_value())
+            {
+                return false;
+            }
+            return !original_expression || ExpressionsMatch(*original_expression, *read_expression);
+        }
+
+        /// Compares two expressions, including all operands.
+        /// @param[in] original_expression - The original expression.
+        /// @param[in] read_expression - The expression read back from binary data.
+        /// @return True if the expressions match; false otherwise.
+        static bool ExpressionsMatch(const Expression& original_expression, const Expression& read_expression)
+        {
+            bool expressions_match = (
+                original_expression.Kind == read_expression.Kind &&
+                original_expression.Text == read_expression.Text &&
+                original_expression.LineNumber == read_expression.LineNumber &&
+                original_expression.Operands.size() == read_expression.Operands.size());
+            if (!expressions_match)
+            {
+                return false;
+            }
+            for (std::size_t operand_index = 0; operand_index < original_expression.Operands.size(); ++operand_index)
+            {
+                if (!ExpressionsMatch(original_expression.Operands[operand_index], read_expression.Operands[operand_index]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
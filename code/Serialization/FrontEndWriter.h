@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Serialization/BinaryWriter.h"
+#include "Serialization/FrontEndFormat.h"
+#include "Tokenization/TokenStream.h"
+
+namespace SERIALIZATION
+{
+    /// Writes front-end output in the binary format described by FrontEndFormat.
+    struct FrontEndWriter
+    {
+        /// Writes a token stream and program.
+        /// @param[in] token_stream - The tokens to write.
+        /// @param[in] program - The program to write.
+        /// @return The binary data.
+        static std::string Write(const TOKENIZATION::TokenStream& token_stream, const Program& program)
+        {
+            FrontEndWriter front_end_writer;
+
+            // CONVERT THE PROGRAM TO NODES.
+            // Functions are sorted by name so that identical programs produce identical output.
+            std::vector<const FunctionDefinition*> functions;
+            for (const auto& [function_name, function_definition] : program.FunctionsByName)
+            {
+                functions.push_back(&function_definition);
+            }
+            std::sort(
+                functions.begin(),
+                functions.end(),
+                [](const FunctionDefinition* left, const FunctionDefinition* right) { return left->Header.Name < right->Header.Name; });
+            std::vector<const FunctionHeader*> function_declarations;
+            for (const auto& [function_name, function_header] : program.FunctionDeclarationsByName)
+            {
+                function_declarations.push_back(&function_header);
+            }
+            std::sort(
+                function_declarations.begin(),
+                function_declarations.end(),
+                [](const FunctionHeader* left, const FunctionHeader* right) { return left->Name < right->Name; });
+
+            std::size_t root_node_count = functions.size() + function_declarations.size();
+            std::uint32_t first_function_node_index = front_end_writer.AllocateNodes(root_node_count);
+            for (std::size_t function_index = 0; function_index < functions.size(); ++function_index)
+            {
+                front_end_writer.WriteFunction(first_function_node_index + static_cast<std::uint32_t>(function_index), *functions[function_index]);
+            }
+            std::uint32_t first_declaration_node_index = first_function_node_index + static_cast<std::uint32_t>(functions.size());
+            for (std::size_t declaration_index = 0; declaration_index < function_declarations.size(); ++declaration_index)
+            {
+                front_end_writer.WriteFunctionHeader(
+                    first_declaration_node_index + static_cast<std::uint32_t>(declaration_index),
+                    FrontEndFormat::NodeKind::FUNCTION_DECLARATION,
+                    *function_declarations[declaration_index],
+                    0);
+            }
+
+            // WRITE THE HEADER.
+            // Offsets are filled in once each section has been written.
+            BinaryWriter& writer = front_end_writer.Writer;
+            writer.WriteBytes(FrontEndFormat::SIGNATURE);
+            writer.WriteUInt32(FrontEndFormat::VERSION);
+            writer.WriteUInt32(static_cast<std::uint32_t>(FrontEndFormat::HEADER_SIZE_IN_BYTES));
+            writer.Buffer.resize(FrontEndFormat::HEADER_SIZE_IN_BYTES, '\0');
+
+            // WRITE THE TOKENS.
+            std::uint32_t tokens_offset = static_cast<std::uint32_t>(writer.Buffer.size());
+            for (const TOKENIZATION::Token& token : token_stream.Tokens)
+            {
+                writer.WriteUInt32(static_cast<std::uint32_t>(token.Type));
+                writer.WriteUInt32(front_end_writer.AddString(token.Value));
+                writer.WriteUInt32(front_end_writer.AddString(token.Filepath));
+                writer.WriteUInt32(static_cast<std::uint32_t>(token.LineNumber));
+                writer.WriteUInt32(static_cast<std::uint32_t>(token.ColumnNumber));
+            }
+
+            // WRITE THE NODES.
+            std::uint32_t nodes_offset = static_cast<std::uint32_t>(writer.Buffer.size());
+            for (const Node& node : front_end_writer.Nodes)
+            {
+                writer.WriteUInt16(static_cast<std::uint16_t>(node.Kind));
+                writer.WriteUInt16(node.Flags);
+                writer.WriteUInt32(node.Text);
+                writer.WriteUInt32(node.Detail);
+                writer.WriteUInt32(node.FirstChildIndex);
+                writer.WriteUInt32(node.ChildCount);
+                writer.WriteUInt32(node.LineNumber);
+                writer.WriteUInt32(node.Filepath);
+            }
+
+            // WRITE THE STRING TABLE.
+            std::uint32_t strings_offset = static_cast<std::uint32_t>(writer.Buffer.size());
+            writer.WriteBytes(front_end_writer.Strings.Buffer);
+
+            // FILL IN THE HEADER.
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_TOTAL_SIZE_OFFSET, static_cast<std::uint32_t>(writer.Buffer.size()));
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_TOKEN_COUNT_OFFSET, static_cast<std::uint32_t>(token_stream.Tokens.size()));
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_TOKENS_OFFSET_OFFSET, tokens_offset);
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_NODE_COUNT_OFFSET, static_cast<std::uint32_t>(front_end_writer.Nodes.size()));
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_NODES_OFFSET_OFFSET, nodes_offset);
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_ROOT_NODE_COUNT_OFFSET, static_cast<std::uint32_t>(root_node_count));
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_STRINGS_OFFSET_OFFSET, strings_offset);
+            writer.OverwriteUInt32(FrontEndFormat::HEADER_STRINGS_SIZE_OFFSET, static_cast<std::uint32_t>(front_end_writer.Strings.Buffer.size()));
+
+            return std::move(writer.Buffer);
+        }
+
+    private:
+        /// A node being written.  Mirrors a node record in the format.
+        struct Node
+        {
+            /// The kind of node.
+            FrontEndFormat::NodeKind Kind = FrontEndFormat::NodeKind::INVALID;
+            /// Flags specific to the kind of node.
+            std::uint16_t Flags = 0;
+            /// The offset of the node's primary text in the string table.
+            std::uint32_t Text = 0;
+            /// The offset of the node's secondary text in the string table.
+            std::uint32_t Detail = 0;
+            /// The index of the node's first child.
+            std::uint32_t FirstChildIndex = 0;
+            /// The number of children of the node.
+            std::uint32_t ChildCount = 0;
+            /// The line of the source code for the node.
+            std::uint32_t LineNumber = 0;
+            /// The offset of the node's filepath in the string table.
+            std::uint32_t Filepath = 0;
+        };
+
+        /// Adds a string to the string table if it isn't already there.
+        /// @param[in] string - The string to add.
+        /// @return The offset of the string in the string table.
+        std::uint32_t AddString(const std::string& string)
+        {
+            auto existing_string = StringOffsets.find(string);
+            if (StringOffsets.end() != existing_string)
+            {
+                return existing_string->second;
+            }
+
+            std::uint32_t offset = static_cast<std::uint32_t>(Strings.Buffer.size());
+            Strings.WriteString(string);
+            StringOffsets.emplace(string, offset);
+            return offset;
+        }
+
+        /// Allocates contiguous nodes.
+        /// @param[in] node_count - The number of nodes to allocate.
+        /// @return The index of the first allocated node.
+        std::uint32_t AllocateNodes(const std::size_t node_count)
+        {
+            std::uint32_t first_node_index = static_cast<std::uint32_t>(Nodes.size());
+            Nodes.resize(Nodes.size() + node_count);
+            return first_node_index;
+        }
+
+        /// Writes a function definition and its children.
+        /// @param[in] node_index - The index of the node for the function.
+        /// @param[in] function - The function to write.
+        void WriteFunction(const std::uint32_t node_index, const FunctionDefinition& function)
+        {
+            // The body follows the parameters.
+            constexpr std::uint32_t BODY_CHILD_COUNT = 1;
+            std::uint32_t body_node_index = WriteFunctionHeader(node_index, FrontEndFormat::NodeKind::FUNCTION_DEFINITION, function.Header, BODY_CHILD_COUNT);
+            WriteStatements(body_node_index, FrontEndFormat::NodeKind::BLOCK, function.Body.Statements, function.Header.LineNumber);
+        }
+
+        /// Writes a function header and its parameters.
+        /// @param[in] node_index - The index of the node for the function.
+        /// @param[in] kind - The kind of node for the function.
+        /// @param[in] header - The header to write.
+        /// @param[in] extra_child_count - The number of children to allocate after the parameters.
+        /// @return The index of the first extra child.
+        std::uint32_t WriteFunctionHeader(
+            const std::uint32_t node_index,
+            const FrontEndFormat::NodeKind kind,
+            const FunctionHeader& header,
+            const std::uint32_t extra_child_count)
+        {
+            // WRITE THE FUNCTION.
+            // Children are allocated before being written so that they remain contiguous.
+            std::uint32_t child_count = static_cast<std::uint32_t>(header.Parameters.size()) + extra_child_count;
+            std::uint32_t first_child_index = AllocateNodes(child_count);
+            Nodes[node_index] = Node
+            {
+                .Kind = kind,
+                .Flags = static_cast<std::uint16_t>((header.IsVariadic ? FrontEndFormat::FUNCTION_VARIADIC_FLAG : 0) | GetSpecifierFlags(header.Specifiers)),
+                .Text = AddString(header.Name),
+                .Detail = AddString(header.ReturnType),
+                .FirstChildIndex = first_child_index,
+                .ChildCount = child_count,
+                .LineNumber = static_cast<std::uint32_t>(header.LineNumber),
+                .Filepath = AddString(header.Filepath),
+            };
+
+            // WRITE THE PARAMETERS.
+            for (std::size_t parameter_index = 0; parameter_index < header.Parameters.size(); ++parameter_index)
+            {
+                const VariableDeclaration& parameter = header.Parameters[parameter_index];
+                Nodes[first_child_index + parameter_index] = Node
+                {
+                    .Kind = FrontEndFormat::NodeKind::PARAMETER,
+                    .Flags = GetSpecifierFlags(parameter.Specifiers),
+                    .Text = AddString(parameter.Name),
+                    .Detail = AddString(parameter.DataType),
+                    .LineNumber = static_cast<std::uint32_t>(header.LineNumber),
+                    .Filepath = AddString(""),
+                };
+            }
+
+            return first_child_index + static_cast<std::uint32_t>(header.Parameters.size());
+        }
+
+        /// Gets the flags recording the storage class and qualifiers of a declaration.
+        /// @param[in] specifiers - The specifiers to record.
+        /// @return The flags for the specifiers.
+        static std::uint16_t GetSpecifierFlags(const DeclarationSpecifiers& specifiers)
+        {
+            std::uint16_t flags = static_cast<std::uint16_t>(static_cast<unsigned>(specifiers.Storage) << FrontEndFormat::STORAGE_CLASS_FLAGS_SHIFT);
+            flags |= specifiers.IsConst ? FrontEndFormat::CONST_FLAG : 0;
+            flags |= specifiers.IsVolatile ? FrontEndFormat::VOLATILE_FLAG : 0;
+            return flags;
+        }
+
+        /// Writes a node whose children are all statements, such as a block.
+        /// @param[in] node_index - The index of the node.
+        /// @param[in] kind - The kind of node.
+        /// @param[in] statements - The statements to write as children.
+        /// @param[in] line_number - The line of the node.
+        void WriteStatements(const std::uint32_t node_index, const FrontEndFormat::NodeKind kind, const std::vector<Statement>& statements, const std::size_t line_number)
+        {
+            std::uint32_t first_child_index = AllocateNodes(statements.size());
+            Nodes[node_index] = CreateNode(kind, "", "", first_child_index, statements.size(), line_number);
+            for (std::size_t statement_index = 0; statement_index < statements.size(); ++statement_index)
+            {
+                WriteStatement(first_child_index + static_cast<std::uint32_t>(statement_index), statements[statement_index]);
+            }
+        }
+
+        /// Writes a statement and its children.
+        /// @param[in] node_index - The index of the node for the statement.
+        /// @param[in] statement - The statement to write.
+        void WriteStatement(const std::uint32_t node_index, const Statement& statement)
+        {
+            using NodeKind = FrontEndFormat::NodeKind;
+
+            // BLOCKS ONLY CONTAIN STATEMENTS.
+            if (StatementKind::BLOCK == statement.Kind)
+            {
+                WriteStatements(node_index, NodeKind::BLOCK, statement.Body, statement.LineNumber);
+                return;
+            }
+
+            // GATHER THE CHILDREN IN THE ORDER DESCRIBED BY THE FORMAT.
+            std::vector<const Expression*> child_expressions;
+            std::vector<const Statement*> child_statements;
+            std::vector<bool> children_are_statements;
+            auto add_expression = [&](const std::optional<Expression>& expression)
+            {
+                if (expression)
+                {
+                    child_expressions.push_back(&*expression);
+                    children_are_statements.push_back(false);
+                }
+            };
+            auto add_statement = [&](const Statement& child_statement)
+            {
+                child_statements.push_back(&child_statement);
+                children_are_statements.push_back(true);
+            };
+
+            NodeKind kind = NodeKind::INVALID;
+            std::uint16_t flags = 0;
+            switch (statement.Kind)
+            {
+                case StatementKind::EMPTY:
+                    kind = NodeKind::EMPTY_STATEMENT;
+                    break;
+                case StatementKind::EXPRESSION:
+                    kind = NodeKind::EXPRESSION_STATEMENT;
+                    add_expression(statement.Value);
+                    break;
+                case StatementKind::DECLARATION:
+                    kind = NodeKind::DECLARATION_STATEMENT;
+                    flags |= GetSpecifierFlags(statement.Declaration.Specifiers);
+                    add_expression(statement.Value);
+                    break;
+                case StatementKind::RETURN:
+                    kind = NodeKind::RETURN_STATEMENT;
+                    add_expression(statement.Value);
+                    break;
+                case StatementKind::IF:
+                    kind = NodeKind::IF_STATEMENT;
+                    add_expression(statement.Condition);
+                    for (const Statement& child_statement : statement.Body)
+                    {
+                        add_statement(child_statement);
+                    }
+                    break;
+                case StatementKind::WHILE:
+                    kind = NodeKind::WHILE_STATEMENT;
+                    add_expression(statement.Condition);
+                    add_statement(statement.Body.front());
+                    break;
+                case StatementKind::DO_WHILE:
+                    kind = NodeKind::DO_WHILE_STATEMENT;
+                    add_statement(statement.Body.front());
+                    add_expression(statement.Condition);
+                    break;
+                case StatementKind::FOR:
+                    kind = NodeKind::FOR_STATEMENT;
+                    flags |= statement.Condition ? FrontEndFormat::FOR_HAS_CONDITION_FLAG : 0;
+                    flags |= statement.Step ? FrontEndFormat::FOR_HAS_STEP_FLAG : 0;
+                    add_statement(statement.Body.front());
+                    add_expression(statement.Condition);
+                    add_expression(statement.Step);
+                    add_statement(statement.Body.back());
+                    break;
+                case StatementKind::BREAK:
+                    kind = NodeKind::BREAK_STATEMENT;
+                    break;
+                case StatementKind::CONTINUE:
+                    kind = NodeKind::CONTINUE_STATEMENT;
+                    break;
+                default:
+                    break;
+            }
+
+            // WRITE THE STATEMENT.
+            std::uint32_t first_child_index = AllocateNodes(children_are_statements.size());
+            Nodes[node_index] = CreateNode(kind, statement.Declaration.Name, statement.Declaration.DataType, first_child_index, children_are_statements.size(), statement.LineNumber);
+            Nodes[node_index].Flags = flags;
+
+            // WRITE ITS CHILDREN.
+            std::size_t expression_index = 0;
+            std::size_t statement_index = 0;
+            for (std::size_t child_index = 0; child_index < children_are_statements.size(); ++child_index)
+            {
+                std::uint32_t child_node_index = first_child_index + static_cast<std::uint32_t>(child_index);
+                if (children_are_statements[child_index])
+                {
+                    WriteStatement(child_node_index, *child_statements[statement_index]);
+                    ++statement_index;
+                }
+                else
+                {
+                    WriteExpression(child_node_index, *child_expressions[expression_index]);
+                    ++expression_index;
+                }
+            }
+        }
+
+        /// Writes an expression and its operands.
+        /// @param[in] node_index - The index of the node for the expression.
+        /// @param[in] expression - The expression to write.
+        void WriteExpression(const std::uint32_t node_index, const Expression& expression)
+        {
+            using NodeKind = FrontEndFormat::NodeKind;
+
+            NodeKind kind = NodeKind::INVALID;
+            switch (expression.Kind)
+            {
+                case ExpressionKind::CONSTANT: kind = NodeKind::CONSTANT_EXPRESSION; break;
+                case ExpressionKind::STRING_LITERAL: kind = NodeKind::STRING_LITERAL_EXPRESSION; break;
+                case ExpressionKind::IDENTIFIER: kind = NodeKind::IDENTIFIER_EXPRESSION; break;
+                case ExpressionKind::UNARY: kind = NodeKind::UNARY_EXPRESSION; break;
+                case ExpressionKind::POSTFIX: kind = NodeKind::POSTFIX_EXPRESSION; break;
+                case ExpressionKind::BINARY: kind = NodeKind::BINARY_EXPRESSION; break;
+                case ExpressionKind::ASSIGNMENT: kind = NodeKind::ASSIGNMENT_EXPRESSION; break;
+                case ExpressionKind::CONDITIONAL: kind = NodeKind::CONDITIONAL_EXPRESSION; break;
+                case ExpressionKind::CALL: kind = NodeKind::CALL_EXPRESSION; break;
+                case ExpressionKind::INDEX: kind = NodeKind::INDEX_EXPRESSION; break;
+                default: break;
+            }
+
+            std::uint32_t first_child_index = AllocateNodes(expression.Operands.size());
+            Nodes[node_index] = CreateNode(kind, expression.Text, "", first_child_index, expression.Operands.size(), expression.LineNumber);
+            for (std::size_t operand_index = 0; operand_index < expression.Operands.size(); ++operand_index)
+            {
+                WriteExpression(first_child_index + static_cast<std::uint32_t>(operand_index), expression.Operands[operand_index]);
+            }
+        }
+
+        /// Creates a node that isn't a function.
+        /// @param[in] kind - The kind of node.
+        /// @param[in] text - The primary text of the node.
+        /// @param[in] detail - The secondary text of the node.
+        /// @param[in] first_child_index - The index of the node's first child.
+        /// @param[in] child_count - The number of children of the node.
+        /// @param[in] line_number - The line of the node.
+        /// @return The node.
+        Node CreateNode(
+            const FrontEndFormat::NodeKind kind,
+            const std::string& text,
+            const std::string& detail,
+            const std::uint32_t first_child_index,
+            const std::size_t child_count,
+            const std::size_t line_number)
+        {
+            Node node =
+            {
+                .Kind = kind,
+                .Text = AddString(text),
+                .Detail = AddString(detail),
+                .FirstChildIndex = first_child_index,
+                .ChildCount = static_cast<std::uint32_t>(child_count),
+                .LineNumber = static_cast<std::uint32_t>(line_number),
+                .Filepath = AddString(""),
+            };
+            return node;
+        }
+
+        /// The nodes written so far.
+        std::vector<Node> Nodes = {};
+        /// The string table.
+        BinaryWriter Strings = {};
+        /// The offsets of strings already in the string table.
+        std::unordered_map<std::string, std::uint32_t> StringOffsets = {};
+        /// The writer for the final output.
+        BinaryWriter Writer = {};
+    };
+}
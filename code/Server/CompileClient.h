@@ -0,0 +1,81 @@
+#pragma once
+
+#if __linux__
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Server/CompileServer.h"
+#include "Server/ServerProtocol.h"
+
+namespace SERVER
+{
+    /// A thin client that forwards a compile request to a running CompileServer.
+    struct CompileClient
+    {
+        /// Sends a request to a server and writes its output.
+        /// @param[in] socket_path - The path of the server's socket.
+        /// @param[in] request_type - The type of request to send.
+        /// @param[in] arguments - The command line arguments to forward (excluding the program name).
+        /// @return The exit code returned by the server, or a failure code if the server couldn't be reached.
+        static int Run(const std::filesystem::path& socket_path, const RequestType request_type, const std::vector<std::string>& arguments)
+        {
+            // CONNECT TO THE SERVER.
+            sockaddr_un address;
+            if (!CompileServer::GetSocketAddress(socket_path, address))
+            {
+                std::fprintf(stderr, "Socket path too long: %s\n", socket_path.string().c_str());
+                return EXIT_FAILURE;
+            }
+
+            int server_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (server_socket < 0)
+            {
+                std::fprintf(stderr, "Failed to create socket: %s\n", std::strerror(errno));
+                return EXIT_FAILURE;
+            }
+            bool connected = (0 == connect(server_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+            if (!connected)
+            {
+                std::fprintf(stderr, "Failed to connect to server at %s: %s\n", address.sun_path, std::strerror(errno));
+                close(server_socket);
+                return EXIT_FAILURE;
+            }
+
+            // SEND THE REQUEST.
+            std::error_code error;
+            Request request =
+            {
+                .Type = request_type,
+                .WorkingDirectory = std::filesystem::current_path(error).string(),
+                .Arguments = arguments,
+            };
+            std::optional<Response> response;
+            if (ServerProtocol::SendRequest(server_socket, request))
+            {
+                response = ServerProtocol::ReceiveResponse(server_socket);
+            }
+            close(server_socket);
+
+            // WRITE THE SERVER'S OUTPUT.
+            if (!response)
+            {
+                std::fprintf(stderr, "No response from server at %s.\n", address.sun_path);
+                return EXIT_FAILURE;
+            }
+            std::fwrite(response->Output.data(), 1, response->Output.size(), stdout);
+            return static_cast<int>(response->ExitCode);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,226 @@
+#pragma once
+
+#if __linux__
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Caching/ParsedFileCache.h"
+#include "Compilation/CommandLineArguments.h"
+#include "Compilation/Compiler.h"
+#include "Compilation/ThreadPool.h"
+#include "Server/FileWatcher.h"
+#include "Server/ServerProtocol.h"
+
+namespace SERVER
+{
+    /// A long-running compiler that accepts compile requests over a Unix domain socket.
+    /// Front-end results for files and the worker threads stay resident between
+    /// requests, so repeated compiles of mostly unchanged files avoid process
+    /// start-up and re-reading, tokenizing, and parsing unchanged files.
+    /// Files are watched for changes so that stale results are never reused.
+    struct CompileServer
+    {
+        /// Fills in the address for a Unix domain socket.
+        /// @param[in] socket_path - The path of the socket.
+        /// @param[out] address - The address.
+        /// @return True if the path fits in the address; false otherwise.
+        static bool GetSocketAddress(const std::filesystem::path& socket_path, sockaddr_un& address)
+        {
+            std::string socket_path_string = socket_path.string();
+            address = {};
+            address.sun_family = AF_UNIX;
+            bool path_fits = (socket_path_string.size() < sizeof(address.sun_path));
+            if (!path_fits)
+            {
+                return false;
+            }
+
+            std::memcpy(address.sun_path, socket_path_string.c_str(), socket_path_string.size() + 1);
+            return true;
+        }
+
+        /// Runs the server until a shutdown request is received.
+        /// @param[in] socket_path - The path of the socket to listen on.
+        ///     Any existing file at the path is replaced.
+        /// @param[in] thread_count - The number of threads for compiling translation units.
+        /// @return The exit code for the server process (0 on success).
+        static int Run(const std::filesystem::path& socket_path, const std::size_t thread_count)
+        {
+            // CREATE THE LISTENING SOCKET.
+            sockaddr_un address;
+            if (!GetSocketAddress(socket_path, address))
+            {
+                std::fprintf(stderr, "Socket path too long: %s\n", socket_path.string().c_str());
+                return EXIT_FAILURE;
+            }
+
+            int listening_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (listening_socket < 0)
+            {
+                std::fprintf(stderr, "Failed to create socket: %s\n", std::strerror(errno));
+                return EXIT_FAILURE;
+            }
+
+            // A socket file left behind by a previous server would prevent binding.
+            unlink(address.sun_path);
+            constexpr int MAX_PENDING_CONNECTION_COUNT = 16;
+            bool listening = (
+                0 == bind(listening_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) &&
+                0 == listen(listening_socket, MAX_PENDING_CONNECTION_COUNT));
+            if (!listening)
+            {
+                std::fprintf(stderr, "Failed to listen on %s: %s\n", address.sun_path, std::strerror(errno));
+                close(listening_socket);
+                return EXIT_FAILURE;
+            }
+
+            // SET UP THE RESIDENT STATE.
+            COMPILATION::ThreadPool thread_pool(thread_count);
+            CACHING::ParsedFileCache parsed_file_cache;
+            FileWatcher file_watcher(parsed_file_cache);
+            std::string preprocessing_configuration;
+            if (!file_watcher.IsValid())
+            {
+                std::fprintf(stderr, "File watching unavailable; results will not be kept between requests.\n");
+            }
+            std::printf("Listening on %s using %zu threads.\n", address.sun_path, thread_pool.ThreadCount());
+            std::fflush(stdout);
+
+            // HANDLE REQUESTS UNTIL ASKED TO STOP.
+            bool shutdown_requested = false;
+            while (!shutdown_requested)
+            {
+                int client_socket = accept4(listening_socket, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client_socket < 0)
+                {
+                    if (EINTR == errno)
+                    {
+                        continue;
+                    }
+                    std::fprintf(stderr, "Failed to accept connection: %s\n", std::strerror(errno));
+                    break;
+                }
+
+                std::optional<Request> request = ServerProtocol::ReceiveRequest(client_socket);
+                if (request)
+                {
+                    Response response;
+                    if (RequestType::SHUTDOWN == request->Type)
+                    {
+                        response.Output = "Server stopped.\n";
+                        shutdown_requested = true;
+                    }
+                    else
+                    {
+                        response = Compile(*request, thread_pool, parsed_file_cache, file_watcher, preprocessing_configuration);
+                    }
+                    ServerProtocol::SendResponse(client_socket, response);
+                }
+
+                close(client_socket);
+            }
+
+            // CLEAN UP THE SOCKET.
+            close(listening_socket);
+            unlink(address.sun_path);
+            return EXIT_SUCCESS;
+        }
+
+    private:
+        /// Handles a compile request.
+        /// @param[in] request - The request.
+        /// @param[in,out] thread_pool - The threads to compile on.
+        /// @param[in,out] parsed_file_cache - Front-end results kept between requests.
+        /// @param[in,out] file_watcher - Watches files in the cache for changes.
+        /// @param[in,out] preprocessing_configuration - The include directories and macro definitions
+        ///     that cached results were preprocessed with.  Updated for this request.
+        /// @return The response to send to the client.
+        static Response Compile(
+            const Request& request,
+            COMPILATION::ThreadPool& thread_pool,
+            CACHING::ParsedFileCache& parsed_file_cache,
+            FileWatcher& file_watcher,
+            std::string& preprocessing_configuration)
+        {
+            Response response;
+
+            // PARSE THE CLIENT'S ARGUMENTS.
+            // Options for connecting to the server are also accepted so that clients can
+            // forward their arguments unchanged, but they have no effect here.  The job
+            // count is also ignored since the server's threads are already running.
+            std::vector<const char*> arguments = { "Compiler" };
+            for (const std::string& argument : request.Arguments)
+            {
+                arguments.push_back(argument.c_str());
+            }
+            std::optional<COMPILATION::CommandLineArguments> parsed_arguments = COMPILATION::CommandLineArguments::Parse(
+                static_cast<int>(arguments.size()),
+                arguments.data());
+            bool arguments_valid = (parsed_arguments && !parsed_arguments->ServerSocketPath && !parsed_arguments->InputPaths.empty());
+            if (!arguments_valid)
+            {
+                response.ExitCode = EXIT_FAILURE;
+                response.Output = "Invalid arguments for server.\n";
+                return response;
+            }
+
+            // USE THE CLIENT'S WORKING DIRECTORY.
+            // Requests are handled one at a time, so temporarily switching directories
+            // resolves relative paths and produces output exactly as if the client had
+            // compiled the files itself.
+            std::error_code error;
+            std::filesystem::path server_working_directory = std::filesystem::current_path(error);
+            std::filesystem::current_path(request.WorkingDirectory, error);
+            if (error)
+            {
+                response.ExitCode = EXIT_FAILURE;
+                response.Output = "Invalid working directory: " + request.WorkingDirectory + "\n";
+                return response;
+            }
+
+            // DISCARD RESULTS PREPROCESSED DIFFERENTLY.
+            // Cached results are only keyed by file, so they can't be reused if the same
+            // file would preprocess differently.
+            std::string request_preprocessing_configuration;
+            for (const std::filesystem::path& include_directory : parsed_arguments->IncludeDirectories)
+            {
+                request_preprocessing_configuration += "-I" + std::filesystem::absolute(include_directory).string() + '\n';
+            }
+            for (const std::string& macro_definition : parsed_arguments->MacroDefinitions)
+            {
+                request_preprocessing_configuration += "-D" + macro_definition + '\n';
+            }
+            if (request_preprocessing_configuration != preprocessing_configuration)
+            {
+                parsed_file_cache.InvalidateAll();
+                preprocessing_configuration = std::move(request_preprocessing_configuration);
+            }
+
+            // COMPILE THE FILES.
+            // Pending changes are processed first so that no stale results are used.
+            file_watcher.ProcessPendingEvents();
+            int exit_code = COMPILATION::Compiler::CompileFiles(
+                *parsed_arguments,
+                thread_pool,
+                &parsed_file_cache,
+                [&response](const std::string_view output) { response.Output += output; });
+            response.ExitCode = static_cast<std::uint32_t>(exit_code);
+
+            std::filesystem::current_path(server_working_directory, error);
+            return response;
+        }
+    };
+}
+
+#endif
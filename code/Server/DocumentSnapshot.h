@@ -0,0 +1,628 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Compilation/TopLevelItemTracker.h"
+#include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "SemanticAnalysis/SemanticAnalyzer.h"
+#include "Tokenization/Tokenizer.cpp"
+
+namespace SERVER
+{
+    /// A position in a document, counting lines and characters from 0 as editors do.
+    struct DocumentPosition
+    {
+        /// The line, starting at 0.
+        std::size_t Line = 0;
+        /// The character (byte) within the line, starting at 0.
+        std::size_t Character = 0;
+    };
+
+    /// A range of text in a document, from its start up to (but not including) its end.
+    struct DocumentRange
+    {
+        /// The position of the first character.
+        DocumentPosition Start = {};
+        /// The position after the last character.
+        DocumentPosition End = {};
+    };
+
+    /// An error found in a document.
+    struct DocumentDiagnostic
+    {
+        /// The text the error applies to.
+        DocumentRange Range = {};
+        /// The error message.
+        std::string Message = "";
+    };
+
+    /// A function declared or defined in a document.
+    struct DocumentSymbol
+    {
+        /// The name of the function.
+        std::string Name = "";
+        /// The function's signature.
+        std::string Detail = "";
+        /// True if the function has a body; false if it's only declared.
+        bool IsDefinition = false;
+        /// The text of the entire declaration or definition.
+        DocumentRange Range = {};
+        /// The text of the function's name.
+        DocumentRange NameRange = {};
+    };
+
+    /// The tokens and syntax tree for one top-level item (like a function definition) in a document,
+    /// along with any whitespace and comments before it.
+    ///
+    /// Positions are relative to the start of the chunk, so a chunk stays valid
+    /// when edits elsewhere move it within the document.
+    struct DocumentChunk
+    {
+        /// The number of characters in the chunk.
+        std::size_t Length = 0;
+        /// True if the chunk ends at the end of a top-level item; false if it runs to the end of the document
+        /// without completing one (so later text could still change how it's parsed).
+        bool EndsItem = false;
+        /// The tokens in the chunk, with line and column numbers relative to the start of the chunk.
+        TOKENIZATION::TokenStream Tokens = {};
+        /// The functions parsed from the chunk, with line numbers relative to the start of the chunk.
+        Program ChunkProgram = {};
+    };
+
+    /// An analyzed version of a document being edited.
+    ///
+    /// Documents are split into chunks at the ends of top-level items.  When a document
+    /// is edited, chunks entirely before or after the edited text are reused from the
+    /// previous snapshot, so only the items overlapping an edit are tokenized and
+    /// parsed again.  Tokenizing restarts at the end of an item, where the tokenizer
+    /// has no pending state, and the parser never looks past the end of a top-level
+    /// item, so results match those from analyzing the entire document.
+    ///
+    /// Snapshots are never modified once analyzed, so they can be shared with
+    /// threads answering requests while newer versions are being analyzed.
+    struct DocumentSnapshot
+    {
+        /// Analyzes a version of a document.
+        /// @param[in] previous_snapshot - The previous version of the document, whose unchanged chunks
+        ///     are reused, if any.
+        /// @param[in] text - The text of the document.
+        /// @param[in] version - The editor's version number for the text.
+        /// @param[in] is_cancelled - Checked between steps to abandon analysis once it's no longer needed.
+        /// @return The analyzed document, if analysis wasn't cancelled; null otherwise.
+        static std::shared_ptr<const DocumentSnapshot> Analyze(
+            const DocumentSnapshot* const previous_snapshot,
+            std::string text,
+            const std::int64_t version,
+            const std::function<bool()>& is_cancelled)
+        {
+            using namespace TOKENIZATION;
+
+            std::shared_ptr<DocumentSnapshot> snapshot = std::make_shared<DocumentSnapshot>();
+            snapshot->Version = version;
+            snapshot->Text = std::move(text);
+            snapshot->LineStartOffsets = GetLineStartOffsets(snapshot->Text);
+            const std::string& current_text = snapshot->Text;
+
+            // FIND THE UNCHANGED TEXT AT THE START AND END OF THE DOCUMENT.
+            std::size_t unchanged_prefix_length = 0;
+            std::size_t unchanged_suffix_length = 0;
+            if (previous_snapshot)
+            {
+                const std::string& previous_text = previous_snapshot->Text;
+                std::size_t shorter_length = std::min(previous_text.size(), current_text.size());
+                auto first_difference = std::mismatch(previous_text.begin(), previous_text.begin() + shorter_length, current_text.begin());
+                unchanged_prefix_length = static_cast<std::size_t>(first_difference.first - previous_text.begin());
+
+                // The suffix can't overlap the prefix, or insertions of repeated text would be counted twice.
+                std::size_t maximum_suffix_length = shorter_length - unchanged_prefix_length;
+                while (unchanged_suffix_length < maximum_suffix_length &&
+                    previous_text[previous_text.size() - 1 - unchanged_suffix_length] == current_text[current_text.size() - 1 - unchanged_suffix_length])
+                {
+                    ++unchanged_suffix_length;
+                }
+            }
+
+            // REUSE CHUNKS ENDING BEFORE THE CHANGED TEXT.
+            std::size_t reanalyzed_start_offset = 0;
+            std::size_t first_reused_suffix_chunk_index = 0;
+            if (previous_snapshot)
+            {
+                const std::vector<std::shared_ptr<const DocumentChunk>>& previous_chunks = previous_snapshot->Chunks;
+                for (std::size_t chunk_index = 0; chunk_index < previous_chunks.size(); ++chunk_index)
+                {
+                    const DocumentChunk& chunk = *previous_chunks[chunk_index];
+                    std::size_t chunk_end_offset = previous_snapshot->ChunkStartOffsets[chunk_index] + chunk.Length;
+                    bool chunk_unchanged = (chunk.EndsItem && chunk_end_offset <= unchanged_prefix_length);
+                    if (!chunk_unchanged)
+                    {
+                        break;
+                    }
+                    snapshot->AddChunk(previous_chunks[chunk_index], reanalyzed_start_offset);
+                }
+
+                // FIND THE FIRST CHUNK STARTING AFTER THE CHANGED TEXT.
+                std::size_t unchanged_suffix_start_offset = previous_snapshot->Text.size() - unchanged_suffix_length;
+                first_reused_suffix_chunk_index = previous_chunks.size();
+                for (std::size_t chunk_index = snapshot->Chunks.size(); chunk_index < previous_chunks.size(); ++chunk_index)
+                {
+                    std::size_t chunk_start_offset = previous_snapshot->ChunkStartOffsets[chunk_index];
+                    bool chunk_unchanged = (chunk_start_offset >= unchanged_suffix_start_offset && chunk_start_offset >= reanalyzed_start_offset);
+                    if (chunk_unchanged)
+                    {
+                        first_reused_suffix_chunk_index = chunk_index;
+                        break;
+                    }
+                }
+            }
+
+            // RE-ANALYZE THE CHANGED TEXT.
+            // Text up to the first reused chunk after the edit is tokenized on its own, which only gives
+            // the same tokens as tokenizing the entire document if it ends exactly at the end of an item.
+            // Otherwise (such as when an edit leaves braces unbalanced), the rest of the document is re-analyzed.
+            bool suffix_chunks_reusable = (previous_snapshot && first_reused_suffix_chunk_index < previous_snapshot->Chunks.size());
+            std::vector<std::shared_ptr<DocumentChunk>> reanalyzed_chunks;
+            if (suffix_chunks_reusable)
+            {
+                // Unsigned arithmetic wraps, so this also works if the text got shorter.
+                std::size_t length_change = current_text.size() - previous_snapshot->Text.size();
+                std::size_t reanalyzed_end_offset = previous_snapshot->ChunkStartOffsets[first_reused_suffix_chunk_index] + length_change;
+                bool region_ends_item = SplitIntoChunks(current_text, reanalyzed_start_offset, reanalyzed_end_offset, reanalyzed_chunks);
+                suffix_chunks_reusable = region_ends_item;
+            }
+            if (!suffix_chunks_reusable)
+            {
+                reanalyzed_chunks.clear();
+                SplitIntoChunks(current_text, reanalyzed_start_offset, current_text.size(), reanalyzed_chunks);
+            }
+            for (std::shared_ptr<DocumentChunk>& chunk : reanalyzed_chunks)
+            {
+                if (is_cancelled())
+                {
+                    return nullptr;
+                }
+                while (chunk->Tokens.MoreTokens())
+                {
+                    ParseTopLevelItem(chunk->Tokens, chunk->ChunkProgram);
+                }
+                chunk->Tokens.CurrentIndex = 0;
+                snapshot->AddChunk(std::move(chunk), reanalyzed_start_offset);
+            }
+
+            // REUSE CHUNKS AFTER THE CHANGED TEXT.
+            if (suffix_chunks_reusable)
+            {
+                const std::vector<std::shared_ptr<const DocumentChunk>>& previous_chunks = previous_snapshot->Chunks;
+                for (std::size_t chunk_index = first_reused_suffix_chunk_index; chunk_index < previous_chunks.size(); ++chunk_index)
+                {
+                    snapshot->AddChunk(previous_chunks[chunk_index], reanalyzed_start_offset);
+                }
+            }
+
+            // ANALYZE THE ENTIRE PROGRAM.
+            if (is_cancelled())
+            {
+                return nullptr;
+            }
+            snapshot->MergeChunks();
+            if (is_cancelled())
+            {
+                return nullptr;
+            }
+            // Semantic analysis needs complete functions, so it's only done without parse errors, as when compiling.
+            if (snapshot->Diagnostics.empty())
+            {
+                std::string semantic_error_messages;
+                SEMANTIC_ANALYSIS::SemanticAnalyzer::Analyze(snapshot->AnalyzedProgram, semantic_error_messages);
+                snapshot->AddDiagnostics(semantic_error_messages, 0);
+            }
+            return snapshot;
+        }
+
+        /// Converts a position in the document to an offset in its text.
+        /// @param[in] position - The position.  Positions past the end of a line are clamped to the end of the line.
+        /// @return The offset of the position.
+        std::size_t GetOffset(const DocumentPosition& position) const
+        {
+            if (position.Line >= LineStartOffsets.size())
+            {
+                return Text.size();
+            }
+            std::size_t line_start_offset = LineStartOffsets[position.Line];
+            std::size_t line_end_offset = (position.Line + 1 < LineStartOffsets.size()) ? LineStartOffsets[position.Line + 1] - 1 : Text.size();
+            std::size_t offset = std::min(line_start_offset + position.Character, line_end_offset);
+            return offset;
+        }
+
+        /// Converts an offset in the text to a position in the document.
+        /// @param[in] offset - The offset.
+        /// @return The position of the offset.
+        DocumentPosition GetPosition(const std::size_t offset) const
+        {
+            auto line_after = std::upper_bound(LineStartOffsets.begin(), LineStartOffsets.end(), offset);
+            std::size_t line_index = static_cast<std::size_t>(line_after - LineStartOffsets.begin()) - 1;
+            DocumentPosition position = { .Line = line_index, .Character = offset - LineStartOffsets[line_index] };
+            return position;
+        }
+
+        /// Finds the function named at a position in the document.
+        /// @param[in] position - The position of the name.
+        /// @return The function's symbol (preferring its definition over declarations), if the position
+        ///     is on the name of a function; null otherwise.
+        const DocumentSymbol* FindFunctionDefinition(const DocumentPosition& position) const
+        {
+            using namespace TOKENIZATION;
+
+            // FIND THE CHUNK CONTAINING THE POSITION.
+            std::size_t offset = GetOffset(position);
+            auto chunk_after = std::upper_bound(ChunkStartOffsets.begin(), ChunkStartOffsets.end(), offset);
+            if (ChunkStartOffsets.begin() == chunk_after)
+            {
+                return nullptr;
+            }
+            std::size_t chunk_index = static_cast<std::size_t>(chunk_after - ChunkStartOffsets.begin()) - 1;
+            const DocumentChunk& chunk = *Chunks[chunk_index];
+
+            // FIND THE TOKEN AT THE POSITION.
+            // Token positions are relative to the chunk, and columns on the chunk's first line are relative to its start.
+            DocumentPosition chunk_start_position = GetPosition(ChunkStartOffsets[chunk_index]);
+            std::size_t line_number = position.Line - chunk_start_position.Line + 1;
+            std::size_t column_number = (position.Line == chunk_start_position.Line) ?
+                position.Character - chunk_start_position.Character + 1 :
+                position.Character + 1;
+            const std::vector<Token>& tokens = chunk.Tokens.Tokens;
+            auto token_after = std::upper_bound(tokens.begin(), tokens.end(), std::make_pair(line_number, column_number),
+                [](const std::pair<std::size_t, std::size_t>& line_and_column, const Token& token)
+                {
+                    return line_and_column < std::make_pair(token.LineNumber, token.ColumnNumber);
+                });
+            if (tokens.begin() == token_after)
+            {
+                return nullptr;
+            }
+            const Token& token = *(token_after - 1);
+            bool position_in_token = (token.LineNumber == line_number && column_number < token.ColumnNumber + token.Value.size());
+            if (!position_in_token || TokenType::IDENTIFIER != token.Type)
+            {
+                return nullptr;
+            }
+
+            // FIND THE FUNCTION WITH THE NAME.
+            bool is_function = (AnalyzedProgram.FunctionsByName.contains(token.Value) || AnalyzedProgram.FunctionDeclarationsByName.contains(token.Value));
+            if (!is_function)
+            {
+                return nullptr;
+            }
+            auto symbol_index = SymbolIndicesByName.find(token.Value);
+            return (SymbolIndicesByName.end() == symbol_index) ? nullptr : &Symbols[symbol_index->second];
+        }
+
+        /// The editor's version number for the text.
+        std::int64_t Version = 0;
+        /// The text of the document.
+        std::string Text = "";
+        /// The offset in the text where each line starts.
+        std::vector<std::size_t> LineStartOffsets = {};
+        /// The chunks covering the entire text, in order.  Shared with other snapshots that reuse them.
+        std::vector<std::shared_ptr<const DocumentChunk>> Chunks = {};
+        /// The offset in the text where each chunk starts.
+        std::vector<std::size_t> ChunkStartOffsets = {};
+        /// The functions from all chunks, with line numbers in the document, and with any types from semantic analysis.
+        Program AnalyzedProgram = {};
+        /// Any errors in the document, in order.
+        std::vector<DocumentDiagnostic> Diagnostics = {};
+        /// The functions declared or defined in the document, in order.
+        std::vector<DocumentSymbol> Symbols = {};
+        /// The index of each function's symbol, by name.  Definitions take precedence over declarations.
+        std::unordered_map<std::string, std::size_t> SymbolIndicesByName = {};
+
+    private:
+        /// Finds where each line starts in some text.
+        /// @param[in] text - The text.
+        /// @return The offset of each line's first character.
+        static std::vector<std::size_t> GetLineStartOffsets(const std::string_view text)
+        {
+            std::vector<std::size_t> line_start_offsets = { 0 };
+            for (std::size_t offset = text.find('\n'); std::string_view::npos != offset; offset = text.find('\n', offset + 1))
+            {
+                line_start_offsets.push_back(offset + 1);
+            }
+            return line_start_offsets;
+        }
+
+        /// Tokenizes text and splits it into chunks at the ends of top-level items.
+        /// @param[in] text - The text of the document.
+        /// @param[in] start_offset - The offset of the text to tokenize, which must be at the end of an item.
+        /// @param[in] end_offset - The offset after the text to tokenize.
+        /// @param[out] chunks - The chunks to add to.  Chunks aren't parsed yet.
+        /// @return True if the text ended exactly at the end of an item, with the tokens
+        ///     matching those from tokenizing the entire document; false otherwise.
+        static bool SplitIntoChunks(
+            const std::string& text,
+            const std::size_t start_offset,
+            const std::size_t end_offset,
+            std::vector<std::shared_ptr<DocumentChunk>>& chunks)
+        {
+            using namespace TOKENIZATION;
+
+            std::string region_text = text.substr(start_offset, end_offset - start_offset);
+            TokenStream region_tokens = Tokenizer::Tokenize(region_text);
+            std::vector<std::size_t> region_line_start_offsets = GetLineStartOffsets(region_text);
+
+            // SPLIT THE TOKENS AFTER EACH ITEM.
+            COMPILATION::TopLevelItemTracker item_tracker;
+            std::size_t chunk_start_offset = 0;
+            std::size_t chunk_start_line_number = 1;
+            std::size_t chunk_start_column_number = 1;
+            std::shared_ptr<DocumentChunk> chunk = std::make_shared<DocumentChunk>();
+            bool unterminated_comment_found = false;
+            for (Token& token : region_tokens.Tokens)
+            {
+                bool token_ends_item = item_tracker.EndsItem(token);
+                std::size_t token_offset = region_line_start_offsets[token.LineNumber - 1] + token.ColumnNumber - 1;
+                unterminated_comment_found |= (
+                    TokenType::OPERATOR == token.Type && "/" == token.Value &&
+                    token_offset + 1 < region_text.size() && '*' == region_text[token_offset + 1]);
+
+                // MAKE THE TOKEN'S POSITION RELATIVE TO THE CHUNK.
+                if (chunk_start_line_number == token.LineNumber)
+                {
+                    token.ColumnNumber -= chunk_start_column_number - 1;
+                }
+                token.LineNumber -= chunk_start_line_number - 1;
+                chunk->Tokens.Tokens.push_back(std::move(token));
+
+                if (token_ends_item)
+                {
+                    // The token ending an item is always a single character.
+                    std::size_t chunk_end_offset = token_offset + 1;
+                    chunk->Length = chunk_end_offset - chunk_start_offset;
+                    chunk->EndsItem = true;
+                    chunks.push_back(std::move(chunk));
+                    chunk = std::make_shared<DocumentChunk>();
+
+                    chunk_start_offset = chunk_end_offset;
+                    auto line_after = std::upper_bound(region_line_start_offsets.begin(), region_line_start_offsets.end(), chunk_start_offset);
+                    chunk_start_line_number = static_cast<std::size_t>(line_after - region_line_start_offsets.begin());
+                    chunk_start_column_number = chunk_start_offset - region_line_start_offsets[chunk_start_line_number - 1] + 1;
+                }
+            }
+
+            // ADD ANY TEXT AFTER THE LAST ITEM.
+            bool text_after_last_item = (chunk_start_offset < region_text.size());
+            if (text_after_last_item)
+            {
+                chunk->Length = region_text.size() - chunk_start_offset;
+                chunks.push_back(std::move(chunk));
+                return false;
+            }
+
+            // Unterminated multiline comments are tokenized as if they weren't comments,
+            // but later text could terminate them, so the tokens can't be trusted.
+            return !unterminated_comment_found;
+        }
+
+        /// Adds a chunk to the end of the document.
+        /// @param[in] chunk - The chunk to add.
+        /// @param[in,out] end_offset - The offset of the end of the chunks so far.  Updated to include the new chunk.
+        void AddChunk(std::shared_ptr<const DocumentChunk> chunk, std::size_t& end_offset)
+        {
+            ChunkStartOffsets.push_back(end_offset);
+            end_offset += chunk->Length;
+            Chunks.push_back(std::move(chunk));
+        }
+
+        /// Combines the functions from all chunks into a single program, in order,
+        /// converting their line numbers to lines in the document.
+        void MergeChunks()
+        {
+            using namespace TOKENIZATION;
+
+            // Chunks normally hold one item each, so their count bounds the number of functions.
+            AnalyzedProgram.FunctionsByName.reserve(Chunks.size());
+            Symbols.reserve(Chunks.size());
+            SymbolIndicesByName.reserve(Chunks.size());
+            for (std::size_t chunk_index = 0; chunk_index < Chunks.size(); ++chunk_index)
+            {
+                const DocumentChunk& chunk = *Chunks[chunk_index];
+                DocumentPosition chunk_start_position = GetPosition(ChunkStartOffsets[chunk_index]);
+                std::size_t line_offset = chunk_start_position.Line;
+                AddDiagnostics(chunk.ChunkProgram.ErrorMessages, line_offset);
+
+                // FIND THE TEXT OF THE CHUNK'S ITEM.
+                // Any whitespace and comments before the item aren't included.
+                const std::vector<Token>& tokens = chunk.Tokens.Tokens;
+                auto first_item_token = std::find_if(tokens.begin(), tokens.end(), [](const Token& token) { return TokenType::COMMENT != token.Type; });
+                DocumentRange item_range = {};
+                if (tokens.end() != first_item_token)
+                {
+                    item_range.Start = GetDocumentPosition(*first_item_token, chunk_start_position);
+                    item_range.End = GetDocumentPosition(tokens.back(), chunk_start_position);
+                    item_range.End.Character += tokens.back().Value.size();
+                }
+
+                // ADD THE CHUNK'S FUNCTIONS.
+                // Items are normally one per chunk, but any trailing text that didn't end an item could have more.
+                std::vector<std::pair<const FunctionHeader*, bool>> headers;
+                for (const auto& [function_name, function_header] : chunk.ChunkProgram.FunctionDeclarationsByName)
+                {
+                    FunctionHeader& merged_header = AnalyzedProgram.FunctionDeclarationsByName[function_name];
+                    merged_header = function_header;
+                    merged_header.LineNumber += line_offset;
+                    headers.emplace_back(&function_header, false);
+                }
+                for (const auto& [function_name, function_definition] : chunk.ChunkProgram.FunctionsByName)
+                {
+                    FunctionDefinition merged_definition = function_definition;
+                    merged_definition.Header.LineNumber += line_offset;
+                    for (Statement& statement : merged_definition.Body.Statements)
+                    {
+                        OffsetLineNumbers(statement, line_offset);
+                    }
+
+                    // Earlier definitions are kept, as when parsing, and any redefinition is reported.
+                    std::size_t error_messages_start_offset = AnalyzedProgram.ErrorMessages.size();
+                    bool function_added = AnalyzedProgram.AddFunction(std::move(merged_definition));
+                    if (!function_added)
+                    {
+                        AddDiagnostics(std::string_view(AnalyzedProgram.ErrorMessages).substr(error_messages_start_offset), 0);
+                    }
+                    headers.emplace_back(&function_definition.Header, true);
+                }
+                std::sort(headers.begin(), headers.end(), [](const auto& left, const auto& right) { return left.first->LineNumber < right.first->LineNumber; });
+
+                for (const auto& [header, is_definition] : headers)
+                {
+                    DocumentSymbol symbol =
+                    {
+                        .Name = header->Name,
+                        .Detail = GetSignature(*header),
+                        .IsDefinition = is_definition,
+                        .Range = item_range,
+                    };
+
+                    // FIND THE FUNCTION'S NAME.
+                    auto name_token = std::find_if(tokens.begin(), tokens.end(), [header](const Token& token)
+                    {
+                        return TokenType::IDENTIFIER == token.Type && header->LineNumber == token.LineNumber && header->Name == token.Value;
+                    });
+                    if (tokens.end() != name_token)
+                    {
+                        symbol.NameRange.Start = GetDocumentPosition(*name_token, chunk_start_position);
+                        symbol.NameRange.End = symbol.NameRange.Start;
+                        symbol.NameRange.End.Character += name_token->Value.size();
+                    }
+
+                    // Definitions replace declarations, but declarations and redefinitions never replace definitions.
+                    auto existing_symbol_index = SymbolIndicesByName.find(symbol.Name);
+                    bool replaces_existing_symbol = (
+                        SymbolIndicesByName.end() == existing_symbol_index ||
+                        !Symbols[existing_symbol_index->second].IsDefinition);
+                    if (replaces_existing_symbol)
+                    {
+                        SymbolIndicesByName[symbol.Name] = Symbols.size();
+                    }
+                    Symbols.push_back(std::move(symbol));
+                }
+            }
+        }
+
+        /// Adds diagnostics from error messages.
+        /// @param[in] error_messages - The error messages, one per line, in the form "file:line: error: message".
+        /// @param[in] line_offset - The number of lines before the first line the messages' line numbers count from.
+        void AddDiagnostics(const std::string_view error_messages, const std::size_t line_offset)
+        {
+            std::size_t message_start_offset = 0;
+            while (message_start_offset < error_messages.size())
+            {
+                std::size_t message_end_offset = error_messages.find('\n', message_start_offset);
+                message_end_offset = (std::string_view::npos == message_end_offset) ? error_messages.size() : message_end_offset;
+                std::string_view error_message = error_messages.substr(message_start_offset, message_end_offset - message_start_offset);
+                message_start_offset = message_end_offset + 1;
+
+                // PARSE THE LINE NUMBER.
+                // Messages without a location (like those at the end of a chunk) are shown at the start of the chunk.
+                constexpr std::string_view ERROR_PREFIX = ": error: ";
+                std::size_t error_prefix_offset = error_message.find(ERROR_PREFIX);
+                std::size_t line_number = 1;
+                std::string_view message = error_message;
+                if (std::string_view::npos != error_prefix_offset)
+                {
+                    std::size_t line_number_start_offset = error_message.rfind(':', error_prefix_offset - 1);
+                    std::string_view line_number_text = error_message.substr(line_number_start_offset + 1, error_prefix_offset - line_number_start_offset - 1);
+                    line_number = std::max<std::size_t>(1, std::strtoull(std::string(line_number_text).c_str(), nullptr, 10));
+                    message = error_message.substr(error_prefix_offset + ERROR_PREFIX.size());
+                }
+
+                // The entire line is highlighted since errors don't have columns.
+                std::size_t line_index = std::min(line_offset + line_number - 1, LineStartOffsets.size() - 1);
+                std::size_t line_end_offset = (line_index + 1 < LineStartOffsets.size()) ? LineStartOffsets[line_index + 1] - 1 : Text.size();
+                DocumentDiagnostic diagnostic =
+                {
+                    .Range =
+                    {
+                        .Start = { .Line = line_index, .Character = 0 },
+                        .End = { .Line = line_index, .Character = line_end_offset - LineStartOffsets[line_index] },
+                    },
+                    .Message = std::string(message),
+                };
+                Diagnostics.push_back(std::move(diagnostic));
+            }
+        }
+
+        /// Converts the position of a token in a chunk to a position in the document.
+        /// @param[in] token - The token, with a position relative to the chunk.
+        /// @param[in] chunk_start_position - The position of the chunk in the document.
+        /// @return The token's position in the document.
+        static DocumentPosition GetDocumentPosition(const TOKENIZATION::Token& token, const DocumentPosition& chunk_start_position)
+        {
+            bool on_first_line = (1 == token.LineNumber);
+            DocumentPosition position =
+            {
+                .Line = chunk_start_position.Line + token.LineNumber - 1,
+                .Character = (on_first_line ? chunk_start_position.Character : 0) + token.ColumnNumber - 1,
+            };
+            return position;
+        }
+
+        /// Moves the line numbers of a statement and everything in it.
+        /// @param[in,out] statement - The statement.
+        /// @param[in] line_offset - The number of lines to move by.
+        static void OffsetLineNumbers(Statement& statement, const std::size_t line_offset)
+        {
+            statement.LineNumber += line_offset;
+            for (std::optional<Expression>* expression : { &statement.Value, &statement.Condition, &statement.Step })
+            {
+                if (*expression)
+                {
+                    OffsetLineNumbers(**expression, line_offset);
+                }
+            }
+            for (Statement& nested_statement : statement.Body)
+            {
+                OffsetLineNumbers(nested_statement, line_offset);
+            }
+        }
+
+        /// Moves the line numbers of an expression and its operands.
+        /// @param[in,out] expression - The expression.
+        /// @param[in] line_offset - The number of lines to move by.
+        static void OffsetLineNumbers(Expression& expression, const std::size_t line_offset)
+        {
+            expression.LineNumber += line_offset;
+            for (Expression& operand : expression.Operands)
+            {
+                OffsetLineNumbers(operand, line_offset);
+            }
+        }
+
+        /// Gets the signature of a function, for showing to users.
+        /// @param[in] header - The function's header.
+        /// @return The signature, like "int add(int a, int b)".
+        static std::string GetSignature(const FunctionHeader& header)
+        {
+            std::string signature = header.Specifiers.ToString() + header.ReturnType + " " + header.Name + "(";
+            for (std::size_t parameter_index = 0; parameter_index < header.Parameters.size(); ++parameter_index)
+            {
+                const VariableDeclaration& parameter = header.Parameters[parameter_index];
+                signature += (parameter_index > 0) ? ", " : "";
+                signature += parameter.Specifiers.ToString() + parameter.DataType + (parameter.Name.empty() ? "" : " " + parameter.Name);
+            }
+            if (header.IsVariadic)
+            {
+                signature += header.Parameters.empty() ? "..." : ", ...";
+            }
+            signature += ")";
+            return signature;
+        }
+    };
+}
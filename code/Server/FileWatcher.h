@@ -0,0 +1,172 @@
+#pragma once
+
+#if __linux__
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "Caching/ParsedFileCache.h"
+
+namespace SERVER
+{
+    /// Watches files in a ParsedFileCache for changes using inotify,
+    /// invalidating cache entries for files that change.
+    ///
+    /// Directories are watched rather than individual files because many
+    /// editors save by writing a new file and renaming it over the old one,
+    /// which would silently end a watch on the original file.
+    ///
+    /// The kernel queues change events as soon as a change is made, so
+    /// processing pending events immediately before using the cache is
+    /// enough to never use stale entries, without needing a separate thread.
+    struct FileWatcher
+    {
+        /// Events that indicate a file in a watched directory may have changed.
+        static constexpr std::uint32_t WATCHED_EVENTS =
+            IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+            IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+            IN_DELETE_SELF | IN_MOVE_SELF;
+
+        /// Starts watching files as they are added to a cache.
+        /// @param[in,out] cache - The cache to invalidate entries in.  Must outlive the watcher.
+        explicit FileWatcher(CACHING::ParsedFileCache& cache) :
+            Cache(cache),
+            InotifyFileDescriptor(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+        {
+            Cache.WatchFile = [this](const std::filesystem::path& filepath) { WatchFile(filepath); };
+        }
+
+        /// Stops watching files.
+        ~FileWatcher()
+        {
+            Cache.WatchFile = nullptr;
+            if (InotifyFileDescriptor >= 0)
+            {
+                close(InotifyFileDescriptor);
+            }
+        }
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        /// Determines if files can be watched.
+        /// @return True if change notifications are available; false otherwise.
+        bool IsValid() const
+        {
+            return InotifyFileDescriptor >= 0;
+        }
+
+        /// Invalidates cache entries for all changes that have occurred so far.
+        void ProcessPendingEvents()
+        {
+            // Without notifications, no entries can be trusted.
+            if (!IsValid())
+            {
+                Cache.InvalidateAll();
+                return;
+            }
+
+            // READ ALL QUEUED EVENTS.
+            alignas(inotify_event) char event_buffer[16 * 1024];
+            for (;;)
+            {
+                ssize_t byte_count = read(InotifyFileDescriptor, event_buffer, sizeof(event_buffer));
+                if (byte_count < 0 && EINTR == errno)
+                {
+                    continue;
+                }
+                bool no_more_events = (byte_count <= 0);
+                if (no_more_events)
+                {
+                    break;
+                }
+
+                // HANDLE EACH EVENT.
+                for (std::size_t event_offset = 0; event_offset < static_cast<std::size_t>(byte_count);)
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(event_buffer + event_offset);
+                    HandleEvent(*event);
+                    event_offset += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+
+    private:
+        /// Starts watching the directory containing a file.
+        /// @param[in] filepath - The absolute path of the file.
+        void WatchFile(const std::filesystem::path& filepath)
+        {
+            if (!IsValid())
+            {
+                return;
+            }
+
+            std::string directory = filepath.lexically_normal().parent_path().string();
+            std::lock_guard<std::mutex> lock(WatchesMutex);
+            int watch_descriptor = inotify_add_watch(InotifyFileDescriptor, directory.c_str(), WATCHED_EVENTS);
+            if (watch_descriptor >= 0)
+            {
+                // Watching the same directory again returns the same descriptor.
+                DirectoriesByWatchDescriptor[watch_descriptor] = directory;
+            }
+        }
+
+        /// Invalidates cache entries affected by a single event.
+        /// @param[in] event - The event.
+        void HandleEvent(const inotify_event& event)
+        {
+            // HANDLE EVENTS THAT MAY HAVE BEEN LOST.
+            if (event.mask & IN_Q_OVERFLOW)
+            {
+                Cache.InvalidateAll();
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(WatchesMutex);
+            auto directory = DirectoriesByWatchDescriptor.find(event.wd);
+            if (DirectoriesByWatchDescriptor.end() == directory)
+            {
+                return;
+            }
+
+            // HANDLE CHANGES TO THE DIRECTORY ITSELF.
+            // Files in a directory that moved or was removed can't be tracked individually.
+            // The watch is forgotten so that it will be re-added if files are looked up again.
+            bool directory_changed = (event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED));
+            if (directory_changed)
+            {
+                Cache.InvalidateAll();
+                if (event.mask & IN_IGNORED)
+                {
+                    DirectoriesByWatchDescriptor.erase(directory);
+                }
+                return;
+            }
+
+            // HANDLE CHANGES TO A FILE IN THE DIRECTORY.
+            bool file_named = (event.len > 0);
+            if (file_named)
+            {
+                std::filesystem::path filepath = std::filesystem::path(directory->second) / event.name;
+                Cache.Invalidate(filepath);
+            }
+        }
+
+        /// The cache to invalidate entries in.
+        CACHING::ParsedFileCache& Cache;
+        /// The inotify instance, or -1 if it couldn't be created.
+        int InotifyFileDescriptor = -1;
+        /// Guards access to the watched directories, since files may be looked up from multiple threads.
+        std::mutex WatchesMutex = {};
+        /// The watched directories by inotify watch descriptor.
+        std::unordered_map<int, std::string> DirectoriesByWatchDescriptor = {};
+    };
+}
+
+#endif
@@ -0,0 +1,526 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace SERVER
+{
+    /// The kinds of JSON values.
+    enum class JsonKind
+    {
+        NULL_VALUE,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT,
+    };
+
+    /// A JSON value, for messages exchanged with editors.
+    /// Object members are kept in order so that output is deterministic.
+    struct JsonValue
+    {
+        /// Creates a null value.
+        JsonValue() = default;
+        /// Creates a boolean value.
+        /// @param[in] boolean - The value.
+        JsonValue(const bool boolean) : Kind(JsonKind::BOOLEAN), Boolean(boolean) {}
+        /// Creates a number.
+        /// @param[in] number - The value.
+        JsonValue(const double number) : Kind(JsonKind::NUMBER), Number(number) {}
+        /// Creates a number from an integer.
+        /// @param[in] number - The value.
+        JsonValue(const std::int64_t number) : Kind(JsonKind::NUMBER), Number(static_cast<double>(number)) {}
+        /// Creates a number from an integer.
+        /// @param[in] number - The value.
+        JsonValue(const int number) : Kind(JsonKind::NUMBER), Number(number) {}
+        /// Creates a number from a size.
+        /// @param[in] number - The value.
+        JsonValue(const std::size_t number) : Kind(JsonKind::NUMBER), Number(static_cast<double>(number)) {}
+        /// Creates a string.
+        /// @param[in] string - The value.
+        JsonValue(std::string string) : Kind(JsonKind::STRING), String(std::move(string)) {}
+        /// Creates a string.
+        /// @param[in] string - The value.
+        JsonValue(const char* const string) : Kind(JsonKind::STRING), String(string) {}
+
+        /// Creates an array.
+        /// @param[in] elements - The elements of the array.
+        /// @return The array.
+        static JsonValue MakeArray(std::vector<JsonValue> elements = {})
+        {
+            JsonValue array;
+            array.Kind = JsonKind::ARRAY;
+            array.Array = std::move(elements);
+            return array;
+        }
+
+        /// Creates an object.
+        /// @param[in] members - The names and values of the object's members, in order.
+        /// @return The object.
+        static JsonValue MakeObject(std::vector<std::pair<std::string, JsonValue>> members = {})
+        {
+            JsonValue object;
+            object.Kind = JsonKind::OBJECT;
+            object.Object = std::move(members);
+            return object;
+        }
+
+        /// Parses JSON text.
+        /// @param[in] text - The text to parse.
+        /// @return The value, if the text is valid JSON; null otherwise.
+        static std::optional<JsonValue> Parse(const std::string_view text)
+        {
+            Parser parser = { .Text = text };
+            std::optional<JsonValue> value = parser.ParseValue(0);
+            parser.SkipWhitespace();
+            bool all_text_parsed = (parser.Position == text.size());
+            if (!value || !all_text_parsed)
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        /// Finds a member of an object.
+        /// @param[in] name - The name of the member.
+        /// @return The member's value, if this is an object with the member; null otherwise.
+        const JsonValue* Find(const std::string_view name) const
+        {
+            for (const auto& [member_name, member_value] : Object)
+            {
+                if (name == member_name)
+                {
+                    return &member_value;
+                }
+            }
+            return nullptr;
+        }
+
+        /// Finds a member of an object by following a path of member names.
+        /// @param[in] names - The names of the members to follow.
+        /// @return The final member's value, if found; null otherwise.
+        const JsonValue* Find(const std::initializer_list<std::string_view> names) const
+        {
+            const JsonValue* value = this;
+            for (const std::string_view name : names)
+            {
+                value = value->Find(name);
+                if (!value)
+                {
+                    return nullptr;
+                }
+            }
+            return value;
+        }
+
+        /// Writes the value as compact JSON text.
+        /// @param[in,out] output - The text to append to.
+        void Write(std::string& output) const
+        {
+            switch (Kind)
+            {
+                case JsonKind::NULL_VALUE:
+                    output += "null";
+                    break;
+                case JsonKind::BOOLEAN:
+                    output += Boolean ? "true" : "false";
+                    break;
+                case JsonKind::NUMBER:
+                {
+                    // Integers (like positions and IDs) are written without any fractional part.
+                    char number_text[32];
+                    bool is_integer = (std::nearbyint(Number) == Number && std::fabs(Number) < 9.0e15);
+                    if (is_integer)
+                    {
+                        std::snprintf(number_text, sizeof(number_text), "%lld", static_cast<long long>(Number));
+                    }
+                    else
+                    {
+                        std::snprintf(number_text, sizeof(number_text), "%.17g", Number);
+                    }
+                    output += number_text;
+                    break;
+                }
+                case JsonKind::STRING:
+                    WriteString(String, output);
+                    break;
+                case JsonKind::ARRAY:
+                {
+                    output += '[';
+                    for (std::size_t element_index = 0; element_index < Array.size(); ++element_index)
+                    {
+                        if (element_index > 0)
+                        {
+                            output += ',';
+                        }
+                        Array[element_index].Write(output);
+                    }
+                    output += ']';
+                    break;
+                }
+                case JsonKind::OBJECT:
+                {
+                    output += '{';
+                    for (std::size_t member_index = 0; member_index < Object.size(); ++member_index)
+                    {
+                        if (member_index > 0)
+                        {
+                            output += ',';
+                        }
+                        WriteString(Object[member_index].first, output);
+                        output += ':';
+                        Object[member_index].second.Write(output);
+                    }
+                    output += '}';
+                    break;
+                }
+            }
+        }
+
+        /// Writes a string as a quoted JSON string.
+        /// @param[in] string - The string to write.
+        /// @param[in,out] output - The text to append to.
+        static void WriteString(const std::string_view string, std::string& output)
+        {
+            output += '"';
+            for (const char character : string)
+            {
+                switch (character)
+                {
+                    case '"':
+                        output += "\\\"";
+                        break;
+                    case '\\':
+                        output += "\\\\";
+                        break;
+                    case '\n':
+                        output += "\\n";
+                        break;
+                    case '\r':
+                        output += "\\r";
+                        break;
+                    case '\t':
+                        output += "\\t";
+                        break;
+                    default:
+                    {
+                        bool is_control_character = (static_cast<unsigned char>(character) < 0x20);
+                        if (is_control_character)
+                        {
+                            char escape[8];
+                            std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned int>(character));
+                            output += escape;
+                        }
+                        else
+                        {
+                            output += character;
+                        }
+                        break;
+                    }
+                }
+            }
+            output += '"';
+        }
+
+        /// The kind of value.
+        JsonKind Kind = JsonKind::NULL_VALUE;
+        /// The value of a boolean.
+        bool Boolean = false;
+        /// The value of a number.
+        double Number = 0.0;
+        /// The value of a string, in UTF-8.
+        std::string String = "";
+        /// The elements of an array.
+        std::vector<JsonValue> Array = {};
+        /// The names and values of an object's members, in order.
+        std::vector<std::pair<std::string, JsonValue>> Object = {};
+
+    private:
+        /// Parses JSON text one value at a time.
+        struct Parser
+        {
+            /// The maximum nesting of arrays and objects, to guard against exhausting the stack.
+            static constexpr std::size_t MAX_DEPTH = 256;
+
+            /// Parses the value at the current position.
+            /// @param[in] depth - The number of arrays and objects containing the value.
+            /// @return The value, if valid; null otherwise.
+            std::optional<JsonValue> ParseValue(const std::size_t depth)
+            {
+                SkipWhitespace();
+                if (Position >= Text.size() || depth > MAX_DEPTH)
+                {
+                    return std::nullopt;
+                }
+
+                char first_character = Text[Position];
+                switch (first_character)
+                {
+                    case 'n':
+                        return ConsumeLiteral("null") ? std::optional<JsonValue>(JsonValue()) : std::nullopt;
+                    case 't':
+                        return ConsumeLiteral("true") ? std::optional<JsonValue>(JsonValue(true)) : std::nullopt;
+                    case 'f':
+                        return ConsumeLiteral("false") ? std::optional<JsonValue>(JsonValue(false)) : std::nullopt;
+                    case '"':
+                    {
+                        std::optional<std::string> string = ParseString();
+                        return string ? std::optional<JsonValue>(JsonValue(std::move(*string))) : std::nullopt;
+                    }
+                    case '[':
+                    {
+                        ++Position;
+                        JsonValue array = MakeArray();
+                        SkipWhitespace();
+                        if (ConsumeCharacter(']'))
+                        {
+                            return array;
+                        }
+                        do
+                        {
+                            std::optional<JsonValue> element = ParseValue(depth + 1);
+                            if (!element)
+                            {
+                                return std::nullopt;
+                            }
+                            array.Array.push_back(std::move(*element));
+                            SkipWhitespace();
+                        } while (ConsumeCharacter(','));
+                        return ConsumeCharacter(']') ? std::optional<JsonValue>(std::move(array)) : std::nullopt;
+                    }
+                    case '{':
+                    {
+                        ++Position;
+                        JsonValue object = MakeObject();
+                        SkipWhitespace();
+                        if (ConsumeCharacter('}'))
+                        {
+                            return object;
+                        }
+                        do
+                        {
+                            SkipWhitespace();
+                            std::optional<std::string> name = (Position < Text.size() && '"' == Text[Position]) ? ParseString() : std::nullopt;
+                            SkipWhitespace();
+                            if (!name || !ConsumeCharacter(':'))
+                            {
+                                return std::nullopt;
+                            }
+                            std::optional<JsonValue> member_value = ParseValue(depth + 1);
+                            if (!member_value)
+                            {
+                                return std::nullopt;
+                            }
+                            object.Object.emplace_back(std::move(*name), std::move(*member_value));
+                            SkipWhitespace();
+                        } while (ConsumeCharacter(','));
+                        return ConsumeCharacter('}') ? std::optional<JsonValue>(std::move(object)) : std::nullopt;
+                    }
+                    default:
+                        return ParseNumber();
+                }
+            }
+
+            /// Parses a number at the current position.
+            /// @return The number, if valid; null otherwise.
+            std::optional<JsonValue> ParseNumber()
+            {
+                // strtod accepts more than JSON allows (like hexadecimal), so the characters are checked first.
+                std::size_t start_position = Position;
+                while (Position < Text.size() && std::string_view("+-0123456789.eE").find(Text[Position]) != std::string_view::npos)
+                {
+                    ++Position;
+                }
+                if (start_position == Position)
+                {
+                    return std::nullopt;
+                }
+
+                std::string number_text(Text.substr(start_position, Position - start_position));
+                char* number_end = nullptr;
+                double number = std::strtod(number_text.c_str(), &number_end);
+                bool entire_number_parsed = (number_text.c_str() + number_text.size() == number_end);
+                return entire_number_parsed ? std::optional<JsonValue>(JsonValue(number)) : std::nullopt;
+            }
+
+            /// Parses a quoted string at the current position.
+            /// @return The unescaped string, if valid; null otherwise.
+            std::optional<std::string> ParseString()
+            {
+                ++Position;
+                std::string string;
+                while (Position < Text.size())
+                {
+                    char character = Text[Position++];
+                    if ('"' == character)
+                    {
+                        return string;
+                    }
+                    if ('\\' != character)
+                    {
+                        string += character;
+                        continue;
+                    }
+
+                    // DECODE THE ESCAPE SEQUENCE.
+                    if (Position >= Text.size())
+                    {
+                        return std::nullopt;
+                    }
+                    char escaped_character = Text[Position++];
+                    switch (escaped_character)
+                    {
+                        case '"': string += '"'; break;
+                        case '\\': string += '\\'; break;
+                        case '/': string += '/'; break;
+                        case 'b': string += '\b'; break;
+                        case 'f': string += '\f'; break;
+                        case 'n': string += '\n'; break;
+                        case 'r': string += '\r'; break;
+                        case 't': string += '\t'; break;
+                        case 'u':
+                        {
+                            std::optional<std::uint32_t> code_point = ParseHexadecimalCodeUnit();
+                            if (!code_point)
+                            {
+                                return std::nullopt;
+                            }
+
+                            // Characters outside the basic multilingual plane are escaped as UTF-16 surrogate pairs.
+                            bool is_high_surrogate = (0xD800 <= *code_point && *code_point <= 0xDBFF);
+                            if (is_high_surrogate && ConsumeLiteral("\\u"))
+                            {
+                                std::optional<std::uint32_t> low_surrogate = ParseHexadecimalCodeUnit();
+                                if (!low_surrogate || *low_surrogate < 0xDC00 || *low_surrogate > 0xDFFF)
+                                {
+                                    return std::nullopt;
+                                }
+                                *code_point = 0x10000 + ((*code_point - 0xD800) << 10) + (*low_surrogate - 0xDC00);
+                            }
+                            AppendUtf8(*code_point, string);
+                            break;
+                        }
+                        default:
+                            return std::nullopt;
+                    }
+                }
+                return std::nullopt;
+            }
+
+            /// Parses the 4 hexadecimal digits of a \u escape sequence.
+            /// @return The UTF-16 code unit, if valid; null otherwise.
+            std::optional<std::uint32_t> ParseHexadecimalCodeUnit()
+            {
+                constexpr std::size_t DIGIT_COUNT = 4;
+                if (Position + DIGIT_COUNT > Text.size())
+                {
+                    return std::nullopt;
+                }
+
+                std::uint32_t code_unit = 0;
+                for (std::size_t digit_index = 0; digit_index < DIGIT_COUNT; ++digit_index)
+                {
+                    char digit = Text[Position++];
+                    std::uint32_t digit_value = 0;
+                    if ('0' <= digit && digit <= '9')
+                    {
+                        digit_value = static_cast<std::uint32_t>(digit - '0');
+                    }
+                    else if ('a' <= digit && digit <= 'f')
+                    {
+                        digit_value = static_cast<std::uint32_t>(digit - 'a' + 10);
+                    }
+                    else if ('A' <= digit && digit <= 'F')
+                    {
+                        digit_value = static_cast<std::uint32_t>(digit - 'A' + 10);
+                    }
+                    else
+                    {
+                        return std::nullopt;
+                    }
+                    code_unit = 16 * code_unit + digit_value;
+                }
+                return code_unit;
+            }
+
+            /// Appends a Unicode code point encoded as UTF-8.
+            /// @param[in] code_point - The code point.
+            /// @param[in,out] string - The string to append to.
+            static void AppendUtf8(const std::uint32_t code_point, std::string& string)
+            {
+                if (code_point < 0x80)
+                {
+                    string += static_cast<char>(code_point);
+                }
+                else if (code_point < 0x800)
+                {
+                    string += static_cast<char>(0xC0 | (code_point >> 6));
+                    string += static_cast<char>(0x80 | (code_point & 0x3F));
+                }
+                else if (code_point < 0x10000)
+                {
+                    string += static_cast<char>(0xE0 | (code_point >> 12));
+                    string += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                    string += static_cast<char>(0x80 | (code_point & 0x3F));
+                }
+                else
+                {
+                    string += static_cast<char>(0xF0 | (code_point >> 18));
+                    string += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                    string += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                    string += static_cast<char>(0x80 | (code_point & 0x3F));
+                }
+            }
+
+            /// Consumes text if it's next.
+            /// @param[in] literal - The text to consume.
+            /// @return True if the text was consumed; false otherwise.
+            bool ConsumeLiteral(const std::string_view literal)
+            {
+                if (Text.substr(Position, literal.size()) != literal)
+                {
+                    return false;
+                }
+                Position += literal.size();
+                return true;
+            }
+
+            /// Consumes a character if it's next.
+            /// @param[in] character - The character to consume.
+            /// @return True if the character was consumed; false otherwise.
+            bool ConsumeCharacter(const char character)
+            {
+                if (Position >= Text.size() || character != Text[Position])
+                {
+                    return false;
+                }
+                ++Position;
+                return true;
+            }
+
+            /// Skips any whitespace at the current position.
+            void SkipWhitespace()
+            {
+                while (Position < Text.size() && std::string_view(" \t\r\n").find(Text[Position]) != std::string_view::npos)
+                {
+                    ++Position;
+                }
+            }
+
+            /// The text being parsed.
+            std::string_view Text = {};
+            /// The position of the next character to parse.
+            std::size_t Position = 0;
+        };
+    };
+}
@@ -0,0 +1,692 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Compilation/ThreadPool.h"
+#include "Server/DocumentSnapshot.h"
+#include "Server/Json.h"
+
+namespace SERVER
+{
+    /// Provides editor support by speaking the Language Server Protocol over a pair of streams
+    /// (normally standard input and output).
+    ///
+    /// Messages are read and answered on a single thread, while documents are analyzed
+    /// in the background, so requests are answered immediately from the latest analyzed
+    /// version of a document rather than waiting behind analysis.  Each edit makes any
+    /// analysis of older versions stale, and stale analyses stop as soon as they next
+    /// check, so a burst of typing doesn't queue up work for versions nobody will see.
+    /// Analysis reuses results for text unaffected by an edit (see DocumentSnapshot),
+    /// so large documents are only partly re-analyzed for typical edits.
+    struct LanguageServer
+    {
+        /// Runs the server until the editor asks it to exit or closes the input stream.
+        /// @param[in] input - The stream to read messages from.
+        /// @param[in] output - The stream to write messages to.  Nothing else may write to it.
+        /// @param[in] thread_count - The number of threads for analyzing documents.
+        /// @return The exit code for the server process (0 if the editor shut it down properly).
+        static int Run(std::FILE* const input, std::FILE* const output, const std::size_t thread_count)
+        {
+            LanguageServer server(output, thread_count);
+            for (;;)
+            {
+                // READ THE NEXT MESSAGE.
+                std::string error_message;
+                std::optional<std::string> message_text = ReadMessage(input, error_message);
+                if (!message_text)
+                {
+                    // The editor went away without asking the server to exit.
+                    return EXIT_FAILURE;
+                }
+                if (!error_message.empty())
+                {
+                    server.SendError(JsonValue(), INVALID_REQUEST_ERROR_CODE, error_message);
+                    continue;
+                }
+                std::optional<JsonValue> message = JsonValue::Parse(*message_text);
+                if (!message)
+                {
+                    server.SendError(JsonValue(), PARSE_ERROR_CODE, "Invalid JSON message.");
+                    continue;
+                }
+                if (JsonKind::OBJECT != message->Kind)
+                {
+                    server.SendError(JsonValue(), INVALID_REQUEST_ERROR_CODE, "Messages must be JSON objects.");
+                    continue;
+                }
+
+                // HANDLE THE MESSAGE.
+                const JsonValue* id = message->Find("id");
+                const JsonValue* method = message->Find("method");
+                if (!method || JsonKind::STRING != method->Kind)
+                {
+                    // Responses to requests from the server aren't expected since it never sends any,
+                    // but anything else with an ID is a malformed request that still needs an answer.
+                    bool is_response = !method && (message->Find("result") || message->Find("error"));
+                    if (id && !is_response)
+                    {
+                        bool id_is_valid = (JsonKind::NUMBER == id->Kind || JsonKind::STRING == id->Kind);
+                        server.SendError(id_is_valid ? *id : JsonValue(), INVALID_REQUEST_ERROR_CODE, "Requests must have a method name.");
+                    }
+                    continue;
+                }
+                if ("exit" == method->String)
+                {
+                    return server.ShutdownRequested ? EXIT_SUCCESS : EXIT_FAILURE;
+                }
+                server.HandleMessage(method->String, *message);
+            }
+        }
+
+    private:
+        /// The error code for messages that aren't valid JSON.
+        static constexpr int PARSE_ERROR_CODE = -32700;
+        /// The error code for requests that aren't allowed, like those after shutting down.
+        static constexpr int INVALID_REQUEST_ERROR_CODE = -32600;
+        /// The error code for requests the server doesn't support.
+        static constexpr int METHOD_NOT_FOUND_ERROR_CODE = -32601;
+        /// The error code for requests with invalid parameters.
+        static constexpr int INVALID_PARAMS_ERROR_CODE = -32602;
+        /// The kind of document symbols for functions.
+        static constexpr int FUNCTION_SYMBOL_KIND = 12;
+        /// The kind of document synchronization where only changed text is sent.
+        static constexpr int INCREMENTAL_TEXT_DOCUMENT_SYNC = 2;
+        /// The largest message accepted, so a corrupt or hostile length can't exhaust memory.
+        static constexpr std::size_t MAX_MESSAGE_LENGTH = 64 * 1024 * 1024;
+
+        /// A document open in the editor.
+        struct OpenDocument
+        {
+            /// The latest text of the document.  Only accessed by the thread reading messages.
+            std::string Text = "";
+            /// The editor's version number for the latest text.  Only accessed by the thread reading messages.
+            std::int64_t Version = 0;
+            /// Increased with each edit (and when the document is closed), so analyses of older versions can tell they're stale.
+            std::atomic<std::uint64_t> EditCount = 0;
+            /// Guards the snapshot and publishing diagnostics for the document.
+            std::mutex SnapshotMutex = {};
+            /// The latest analyzed version of the document, if any analysis has finished.
+            std::shared_ptr<const DocumentSnapshot> Snapshot = nullptr;
+        };
+
+        /// Creates a server.
+        /// @param[in] output - The stream to write messages to.
+        /// @param[in] thread_count - The number of threads for analyzing documents.
+        explicit LanguageServer(std::FILE* const output, const std::size_t thread_count) :
+            Output(output),
+            AnalysisThreadPool(thread_count)
+        {}
+
+        /// Stops any analyses in progress before waiting for them to finish.
+        ~LanguageServer()
+        {
+            for (auto& [uri, document] : DocumentsByUri)
+            {
+                ++document->EditCount;
+            }
+        }
+
+        /// Reads a message, which consists of headers (including its length) followed by JSON.
+        /// @param[in] input - The stream to read from.
+        /// @param[out] error_message - Describes why the message is invalid, if it can be skipped but not read.
+        /// @return The JSON text of the message, if one could be read or skipped; null at the end of the stream.
+        static std::optional<std::string> ReadMessage(std::FILE* const input, std::string& error_message)
+        {
+            // READ THE HEADERS.
+            // Only the length is needed, since the content is always UTF-8 JSON.
+            std::optional<std::size_t> content_length;
+            for (;;)
+            {
+                std::string header;
+                int character = std::fgetc(input);
+                for (; EOF != character && '\n' != character; character = std::fgetc(input))
+                {
+                    header += static_cast<char>(character);
+                }
+                if (EOF == character)
+                {
+                    return std::nullopt;
+                }
+                if (!header.empty() && '\r' == header.back())
+                {
+                    header.pop_back();
+                }
+                if (header.empty())
+                {
+                    break;
+                }
+
+                constexpr std::string_view CONTENT_LENGTH_HEADER = "Content-Length:";
+                if (header.starts_with(CONTENT_LENGTH_HEADER))
+                {
+                    content_length = std::strtoull(header.c_str() + CONTENT_LENGTH_HEADER.size(), nullptr, 10);
+                }
+            }
+
+            // READ THE CONTENT.
+            // Messages without a length can't be separated from the next message, so they're treated as invalid.
+            if (!content_length)
+            {
+                error_message = "Missing Content-Length header.";
+                return std::string();
+            }
+            if (*content_length > MAX_MESSAGE_LENGTH)
+            {
+                // Oversized content is read in small pieces and discarded so that the next message can still be read.
+                error_message = "Message is larger than the limit of " + std::to_string(MAX_MESSAGE_LENGTH) + " bytes.";
+                char discarded_content[64 * 1024];
+                for (std::size_t remaining_length = *content_length; remaining_length > 0;)
+                {
+                    std::size_t read_length = std::fread(discarded_content, 1, std::min(remaining_length, sizeof(discarded_content)), input);
+                    if (0 == read_length)
+                    {
+                        return std::nullopt;
+                    }
+                    remaining_length -= read_length;
+                }
+                return std::string();
+            }
+            std::string content(*content_length, '\0');
+            std::size_t read_length = std::fread(content.data(), 1, content.size(), input);
+            if (read_length != content.size())
+            {
+                return std::nullopt;
+            }
+            return content;
+        }
+
+        /// Handles a message from the editor.
+        /// @param[in] method - The method of the message.
+        /// @param[in] message - The message.
+        void HandleMessage(const std::string& method, const JsonValue& message)
+        {
+            // Requests have IDs to respond to, but notifications don't.
+            const JsonValue* id = message.Find("id");
+            const JsonValue* parameters = message.Find("params");
+            static const JsonValue NO_PARAMETERS = JsonValue::MakeObject();
+            parameters = parameters ? parameters : &NO_PARAMETERS;
+
+            if (ShutdownRequested && id)
+            {
+                SendError(*id, INVALID_REQUEST_ERROR_CODE, "The server is shutting down.");
+                return;
+            }
+
+            if ("initialize" == method && id)
+            {
+                // Positions count UTF-16 code units unless the editor also supports counting bytes, which needs no conversion.
+                const JsonValue* position_encodings = parameters->Find({ "capabilities", "general", "positionEncodings" });
+                Utf8Positions = false;
+                for (std::size_t encoding_index = 0; position_encodings && encoding_index < position_encodings->Array.size(); ++encoding_index)
+                {
+                    Utf8Positions = Utf8Positions || ("utf-8" == position_encodings->Array[encoding_index].String);
+                }
+
+                JsonValue capabilities = JsonValue::MakeObject(
+                {
+                    { "positionEncoding", Utf8Positions ? "utf-8" : "utf-16" },
+                    { "textDocumentSync", JsonValue::MakeObject(
+                    {
+                        { "openClose", true },
+                        { "change", INCREMENTAL_TEXT_DOCUMENT_SYNC },
+                    }) },
+                    { "documentSymbolProvider", true },
+                    { "definitionProvider", true },
+                });
+                SendResult(*id, JsonValue::MakeObject({ { "capabilities", std::move(capabilities) } }));
+            }
+            else if ("shutdown" == method && id)
+            {
+                ShutdownRequested = true;
+                SendResult(*id, JsonValue());
+            }
+            else if ("textDocument/didOpen" == method)
+            {
+                const JsonValue* uri = parameters->Find({ "textDocument", "uri" });
+                const JsonValue* text = parameters->Find({ "textDocument", "text" });
+                const JsonValue* version = parameters->Find({ "textDocument", "version" });
+                if (uri && text)
+                {
+                    std::shared_ptr<OpenDocument>& document = DocumentsByUri[uri->String];
+                    if (document)
+                    {
+                        // A document reopened without being closed is treated as a new document.
+                        ++document->EditCount;
+                    }
+                    document = std::make_shared<OpenDocument>();
+                    document->Text = text->String;
+                    document->Version = version ? static_cast<std::int64_t>(version->Number) : 0;
+                    AnalyzeInBackground(uri->String, document);
+                }
+            }
+            else if ("textDocument/didChange" == method)
+            {
+                const JsonValue* uri = parameters->Find({ "textDocument", "uri" });
+                const JsonValue* version = parameters->Find({ "textDocument", "version" });
+                const JsonValue* changes = parameters->Find("contentChanges");
+                auto document = uri ? DocumentsByUri.find(uri->String) : DocumentsByUri.end();
+                if (DocumentsByUri.end() != document && changes)
+                {
+                    for (const JsonValue& change : changes->Array)
+                    {
+                        ApplyChange(change, document->second->Text);
+                    }
+                    document->second->Version = version ? static_cast<std::int64_t>(version->Number) : document->second->Version + 1;
+                    AnalyzeInBackground(uri->String, document->second);
+                }
+            }
+            else if ("textDocument/didClose" == method)
+            {
+                const JsonValue* uri = parameters->Find({ "textDocument", "uri" });
+                auto document = uri ? DocumentsByUri.find(uri->String) : DocumentsByUri.end();
+                if (DocumentsByUri.end() != document)
+                {
+                    // Diagnostics are cleared under the lock so that no analysis still in progress can publish them afterward.
+                    std::shared_ptr<OpenDocument> closed_document = std::move(document->second);
+                    DocumentsByUri.erase(document);
+                    ++closed_document->EditCount;
+                    std::lock_guard<std::mutex> snapshot_lock(closed_document->SnapshotMutex);
+                    PublishDiagnostics(uri->String, nullptr);
+                    closed_document->Snapshot = nullptr;
+                }
+            }
+            else if ("textDocument/documentSymbol" == method && id)
+            {
+                // Documents can have thousands of symbols, so the result is written directly rather than built as JSON values.
+                std::shared_ptr<const DocumentSnapshot> snapshot = GetSnapshot(*parameters);
+                constexpr std::size_t ESTIMATED_SYMBOL_JSON_SIZE = 192;
+                std::string symbols = "[";
+                symbols.reserve(snapshot ? ESTIMATED_SYMBOL_JSON_SIZE * snapshot->Symbols.size() : 2);
+                for (std::size_t symbol_index = 0; snapshot && symbol_index < snapshot->Symbols.size(); ++symbol_index)
+                {
+                    const DocumentSymbol& symbol = snapshot->Symbols[symbol_index];
+                    symbols += (symbol_index > 0) ? ",{\"name\":" : "{\"name\":";
+                    JsonValue::WriteString(symbol.Name, symbols);
+                    symbols += ",\"detail\":";
+                    JsonValue::WriteString(symbol.Detail, symbols);
+                    symbols += ",\"kind\":";
+                    WriteNumber(FUNCTION_SYMBOL_KIND, symbols);
+                    symbols += ",\"range\":";
+                    WriteRange(symbol.Range, *snapshot, symbols);
+                    symbols += ",\"selectionRange\":";
+                    WriteRange(symbol.NameRange, *snapshot, symbols);
+                    symbols += '}';
+                }
+                symbols += ']';
+                SendResultJson(*id, symbols);
+            }
+            else if ("textDocument/definition" == method && id)
+            {
+                std::shared_ptr<const DocumentSnapshot> snapshot = GetSnapshot(*parameters);
+                const JsonValue* uri = parameters->Find({ "textDocument", "uri" });
+                const JsonValue* line = parameters->Find({ "position", "line" });
+                const JsonValue* character = parameters->Find({ "position", "character" });
+                if (!uri || !line || !character)
+                {
+                    SendError(*id, INVALID_PARAMS_ERROR_CODE, "Missing document or position.");
+                    return;
+                }
+
+                // Positions are looked up in the latest analyzed version, which may lag behind very recent edits.
+                const DocumentSymbol* definition = nullptr;
+                if (snapshot)
+                {
+                    std::size_t line_index = ToSize(*line);
+                    std::size_t byte_index = ToByteIndex(GetLineText(*snapshot, line_index), ToSize(*character));
+                    definition = snapshot->FindFunctionDefinition({ .Line = line_index, .Character = byte_index });
+                }
+                std::string location = "null";
+                if (definition)
+                {
+                    location = "{\"uri\":";
+                    JsonValue::WriteString(uri->String, location);
+                    location += ",\"range\":";
+                    WriteRange(definition->NameRange, *snapshot, location);
+                    location += '}';
+                }
+                SendResultJson(*id, location);
+            }
+            else if (id)
+            {
+                SendError(*id, METHOD_NOT_FOUND_ERROR_CODE, "Unsupported method: " + method);
+            }
+
+            // Other notifications (like cancelling requests, which are always answered immediately) are ignored.
+        }
+
+        /// Applies a change from the editor to the text of a document.
+        /// @param[in] change - The change, which replaces either a range of text or all of it.
+        /// @param[in,out] text - The text to change.
+        void ApplyChange(const JsonValue& change, std::string& text) const
+        {
+            const JsonValue* new_text = change.Find("text");
+            if (!new_text)
+            {
+                return;
+            }
+
+            const JsonValue* range = change.Find("range");
+            if (!range)
+            {
+                text = new_text->String;
+                return;
+            }
+
+            const JsonValue* start_line = range->Find({ "start", "line" });
+            const JsonValue* start_character = range->Find({ "start", "character" });
+            const JsonValue* end_line = range->Find({ "end", "line" });
+            const JsonValue* end_character = range->Find({ "end", "character" });
+            if (!start_line || !start_character || !end_line || !end_character)
+            {
+                return;
+            }
+            std::size_t start_offset = GetOffset(text, ToSize(*start_line), ToSize(*start_character));
+            std::size_t end_offset = std::max(start_offset, GetOffset(text, ToSize(*end_line), ToSize(*end_character)));
+            text.replace(start_offset, end_offset - start_offset, new_text->String);
+        }
+
+        /// Converts a position from the editor to an offset in text.
+        /// @param[in] text - The text.
+        /// @param[in] line - The line, starting at 0.
+        /// @param[in] character - The character within the line in the negotiated encoding, starting at 0.
+        ///     Positions past the end of a line are clamped to the end of the line.
+        /// @return The offset of the position.
+        std::size_t GetOffset(const std::string_view text, const std::size_t line, const std::size_t character) const
+        {
+            std::size_t line_start_offset = 0;
+            for (std::size_t line_index = 0; line_index < line; ++line_index)
+            {
+                std::size_t newline_offset = text.find('\n', line_start_offset);
+                if (std::string_view::npos == newline_offset)
+                {
+                    return text.size();
+                }
+                line_start_offset = newline_offset + 1;
+            }
+            std::size_t line_end_offset = std::min(text.find('\n', line_start_offset), text.size());
+            std::string_view line_text = text.substr(line_start_offset, line_end_offset - line_start_offset);
+            std::size_t offset = line_start_offset + std::min(ToByteIndex(line_text, character), line_text.size());
+            return offset;
+        }
+
+        /// Gets the text of a line in an analyzed document.
+        /// @param[in] snapshot - The analyzed document.
+        /// @param[in] line - The line, starting at 0.
+        /// @return The text of the line, without its newline (empty if past the end of the document).
+        static std::string_view GetLineText(const DocumentSnapshot& snapshot, const std::size_t line)
+        {
+            std::string_view line_text = std::string_view(snapshot.Text).substr(snapshot.GetOffset({ .Line = line, .Character = 0 }));
+            return line_text.substr(0, line_text.find('\n'));
+        }
+
+        /// Converts a character within a line from the negotiated position encoding to a byte index.
+        /// @param[in] line_text - The text of the line.
+        /// @param[in] character - The character within the line, starting at 0.
+        /// @return The byte index within the line.  Characters past the end of the line are only clamped with UTF-16 positions.
+        std::size_t ToByteIndex(const std::string_view line_text, const std::size_t character) const
+        {
+            if (Utf8Positions)
+            {
+                return character;
+            }
+
+            // Characters outside the Basic Multilingual Plane (4-byte UTF-8 sequences) take 2 UTF-16 code units.
+            std::size_t byte_index = 0;
+            for (std::size_t utf16_index = 0; byte_index < line_text.size() && utf16_index < character;)
+            {
+                unsigned char lead_byte = static_cast<unsigned char>(line_text[byte_index]);
+                utf16_index += (lead_byte >= 0xF0) ? 2 : 1;
+                ++byte_index;
+                while (byte_index < line_text.size() && IsContinuationByte(line_text[byte_index]))
+                {
+                    ++byte_index;
+                }
+            }
+            return byte_index;
+        }
+
+        /// Converts a byte index within a line to a character in the negotiated position encoding.
+        /// @param[in] line_text - The text of the line.
+        /// @param[in] byte_index - The byte index within the line, starting at 0.
+        /// @return The character within the line.
+        std::size_t ToCharacter(const std::string_view line_text, const std::size_t byte_index) const
+        {
+            if (Utf8Positions)
+            {
+                return byte_index;
+            }
+
+            std::size_t line_byte_count = std::min(byte_index, line_text.size());
+            std::size_t utf16_index = byte_index - line_byte_count;
+            for (std::size_t line_byte_index = 0; line_byte_index < line_byte_count; ++line_byte_index)
+            {
+                unsigned char byte = static_cast<unsigned char>(line_text[line_byte_index]);
+                if (!IsContinuationByte(byte))
+                {
+                    utf16_index += (byte >= 0xF0) ? 2 : 1;
+                }
+            }
+            return utf16_index;
+        }
+
+        /// Determines if a byte continues a multi-byte UTF-8 sequence.
+        /// @param[in] byte - The byte.
+        /// @return True if the byte is a continuation byte; false if it starts a character.
+        static bool IsContinuationByte(const char byte)
+        {
+            return 0x80 == (static_cast<unsigned char>(byte) & 0xC0);
+        }
+
+        /// Starts analyzing the latest version of a document on a background thread,
+        /// publishing its diagnostics once done unless a newer version arrives first.
+        /// @param[in] uri - The URI of the document.
+        /// @param[in] document - The document.
+        void AnalyzeInBackground(const std::string& uri, const std::shared_ptr<OpenDocument>& document)
+        {
+            std::uint64_t edit_count = ++document->EditCount;
+            AnalysisThreadPool.Submit([this, uri, document, edit_count, text = document->Text, version = document->Version]() mutable
+            {
+                auto is_cancelled = [&document, edit_count]() { return document->EditCount.load(std::memory_order_relaxed) != edit_count; };
+                if (is_cancelled())
+                {
+                    return;
+                }
+
+                // ANALYZE THE DOCUMENT, REUSING RESULTS FROM THE LATEST ANALYZED VERSION.
+                std::shared_ptr<const DocumentSnapshot> previous_snapshot;
+                {
+                    std::lock_guard<std::mutex> snapshot_lock(document->SnapshotMutex);
+                    previous_snapshot = document->Snapshot;
+                }
+                std::shared_ptr<const DocumentSnapshot> snapshot = DocumentSnapshot::Analyze(previous_snapshot.get(), std::move(text), version, is_cancelled);
+                if (!snapshot)
+                {
+                    return;
+                }
+
+                // PUBLISH THE RESULTS IF STILL CURRENT.
+                std::lock_guard<std::mutex> snapshot_lock(document->SnapshotMutex);
+                if (is_cancelled())
+                {
+                    return;
+                }
+                document->Snapshot = snapshot;
+
+                PublishDiagnostics(uri, snapshot.get());
+            });
+        }
+
+        /// Gets the latest analyzed version of the document a request is for.
+        /// @param[in] parameters - The parameters of the request.
+        /// @return The latest analyzed version of the document, if any; null otherwise.
+        std::shared_ptr<const DocumentSnapshot> GetSnapshot(const JsonValue& parameters)
+        {
+            const JsonValue* uri = parameters.Find({ "textDocument", "uri" });
+            auto document = uri ? DocumentsByUri.find(uri->String) : DocumentsByUri.end();
+            if (DocumentsByUri.end() == document)
+            {
+                return nullptr;
+            }
+            std::lock_guard<std::mutex> snapshot_lock(document->second->SnapshotMutex);
+            return document->second->Snapshot;
+        }
+
+        /// Sends the errors in a document to the editor.
+        /// @param[in] uri - The URI of the document.
+        /// @param[in] snapshot - The analyzed version of the document, or null to clear any errors.
+        void PublishDiagnostics(const std::string& uri, const DocumentSnapshot* const snapshot)
+        {
+            constexpr int ERROR_SEVERITY = 1;
+            std::string parameters = "{\"uri\":";
+            JsonValue::WriteString(uri, parameters);
+            if (snapshot)
+            {
+                parameters += ",\"version\":";
+                JsonValue(snapshot->Version).Write(parameters);
+            }
+            parameters += ",\"diagnostics\":[";
+            for (std::size_t diagnostic_index = 0; snapshot && diagnostic_index < snapshot->Diagnostics.size(); ++diagnostic_index)
+            {
+                const DocumentDiagnostic& diagnostic = snapshot->Diagnostics[diagnostic_index];
+                parameters += (diagnostic_index > 0) ? ",{\"range\":" : "{\"range\":";
+                WriteRange(diagnostic.Range, *snapshot, parameters);
+                parameters += ",\"severity\":";
+                WriteNumber(ERROR_SEVERITY, parameters);
+                parameters += ",\"message\":";
+                JsonValue::WriteString(diagnostic.Message, parameters);
+                parameters += '}';
+            }
+            parameters += "]}";
+            SendNotification("textDocument/publishDiagnostics", parameters);
+        }
+
+        /// Writes a range as JSON, in the negotiated position encoding.
+        /// @param[in] range - The range.
+        /// @param[in] snapshot - The analyzed document containing the range.
+        /// @param[in,out] output - The text to append to.
+        void WriteRange(const DocumentRange& range, const DocumentSnapshot& snapshot, std::string& output) const
+        {
+            output += "{\"start\":{\"line\":";
+            WriteNumber(range.Start.Line, output);
+            output += ",\"character\":";
+            WriteNumber(ToCharacter(GetLineText(snapshot, range.Start.Line), range.Start.Character), output);
+            output += "},\"end\":{\"line\":";
+            WriteNumber(range.End.Line, output);
+            output += ",\"character\":";
+            WriteNumber(ToCharacter(GetLineText(snapshot, range.End.Line), range.End.Character), output);
+            output += "}}";
+        }
+
+        /// Writes a number as JSON without creating a temporary string.
+        /// @param[in] number - The number.
+        /// @param[in,out] output - The text to append to.
+        static void WriteNumber(const std::size_t number, std::string& output)
+        {
+            char digits[24];
+            std::to_chars_result digits_end = std::to_chars(std::begin(digits), std::end(digits), number);
+            output.append(digits, digits_end.ptr);
+        }
+
+        /// Converts a JSON number to a size.
+        /// @param[in] number - The number.
+        /// @return The number as a size, or 0 if it's not a non-negative number.
+        static std::size_t ToSize(const JsonValue& number)
+        {
+            bool is_size = (JsonKind::NUMBER == number.Kind && number.Number >= 0.0);
+            return is_size ? static_cast<std::size_t>(number.Number) : 0;
+        }
+
+        /// Sends a successful response to a request.
+        /// @param[in] id - The ID of the request.
+        /// @param[in] result - The result of the request.
+        void SendResult(const JsonValue& id, const JsonValue& result)
+        {
+            std::string result_json;
+            result.Write(result_json);
+            SendResultJson(id, result_json);
+        }
+
+        /// Sends a successful response to a request.
+        /// @param[in] id - The ID of the request.
+        /// @param[in] result_json - The result of the request, as JSON text.
+        void SendResultJson(const JsonValue& id, const std::string_view result_json)
+        {
+            std::string content = "{\"jsonrpc\":\"2.0\",\"id\":";
+            id.Write(content);
+            content += ",\"result\":";
+            content += result_json;
+            content += '}';
+            SendMessage(content);
+        }
+
+        /// Sends an error response to a request.
+        /// @param[in] id - The ID of the request (null if it couldn't be determined).
+        /// @param[in] code - The error code.
+        /// @param[in] message - Describes the error.
+        void SendError(const JsonValue& id, const int code, const std::string& message)
+        {
+            JsonValue response = JsonValue::MakeObject(
+            {
+                { "jsonrpc", "2.0" },
+                { "id", id },
+                { "error", JsonValue::MakeObject({ { "code", code }, { "message", message } }) },
+            });
+            std::string content;
+            response.Write(content);
+            SendMessage(content);
+        }
+
+        /// Sends a notification to the editor.
+        /// @param[in] method - The method of the notification.
+        /// @param[in] parameters_json - The parameters of the notification, as JSON text.
+        void SendNotification(const std::string_view method, const std::string_view parameters_json)
+        {
+            std::string content = "{\"jsonrpc\":\"2.0\",\"method\":";
+            JsonValue::WriteString(method, content);
+            content += ",\"params\":";
+            content += parameters_json;
+            content += '}';
+            SendMessage(content);
+        }
+
+        /// Sends a message to the editor.  May be called from any thread.
+        /// @param[in] content - The JSON text of the message.
+        void SendMessage(const std::string_view content)
+        {
+            std::string header = "Content-Length: " + std::to_string(content.size()) + "\r\n\r\n";
+
+            std::lock_guard<std::mutex> output_lock(OutputMutex);
+            std::fwrite(header.data(), 1, header.size(), Output);
+            std::fwrite(content.data(), 1, content.size(), Output);
+            std::fflush(Output);
+        }
+
+        /// The stream to write messages to.
+        std::FILE* const Output;
+        /// Keeps messages from different threads from interleaving.
+        std::mutex OutputMutex = {};
+        /// True once the editor has asked the server to shut down.
+        bool ShutdownRequested = false;
+        /// True if positions count UTF-8 bytes; false if they count UTF-16 code units (the protocol's default).
+        /// Only set while initializing, before any documents are analyzed.
+        bool Utf8Positions = false;
+        /// The documents open in the editor, by URI.  Only accessed by the thread reading messages.
+        std::unordered_map<std::string, std::shared_ptr<OpenDocument>> DocumentsByUri = {};
+        /// The threads analyzing documents.  Declared last so that analyses finish before anything they use is destroyed.
+        COMPILATION::ThreadPool AnalysisThreadPool;
+    };
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#if __linux__
+
+#include <cerrno>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include "Serialization/BinaryReader.h"
+#include "Serialization/BinaryWriter.h"
+
+namespace SERVER
+{
+    /// The types of requests a client can send to a compile server.
+    enum class RequestType : std::uint8_t
+    {
+        /// Compile files using command line arguments from the client.
+        COMPILE = 1,
+        /// Stop the server.
+        SHUTDOWN = 2,
+    };
+
+    /// A request from a client to a compile server.
+    struct Request
+    {
+        /// The type of request.
+        RequestType Type = RequestType::COMPILE;
+        /// The client's working directory, against which relative paths are resolved.
+        std::string WorkingDirectory = "";
+        /// The client's command line arguments (excluding the program name).
+        std::vector<std::string> Arguments = {};
+    };
+
+    /// A response from a compile server to a client.
+    struct Response
+    {
+        /// The exit code the client should return.
+        std::uint32_t ExitCode = 0;
+        /// Output the client should write to standard output.
+        std::string Output = "";
+    };
+
+    /// Sends and receives messages between compile servers and clients.
+    /// Each message is a 32-bit little-endian length followed by a payload
+    /// encoded with BinaryWriter, so messages can be read from a stream
+    /// socket without any delimiters.
+    struct ServerProtocol
+    {
+        /// The largest message that will be accepted, to guard against corrupt lengths.
+        static constexpr std::uint32_t MAX_MESSAGE_SIZE_IN_BYTES = 256 * 1024 * 1024;
+
+        /// Sends a request.
+        /// @param[in] socket - The connected socket.
+        /// @param[in] request - The request to send.
+        /// @return True if the request was sent; false otherwise.
+        static bool SendRequest(const int socket, const Request& request)
+        {
+            SERIALIZATION::BinaryWriter writer;
+            writer.WriteUInt8(static_cast<std::uint8_t>(request.Type));
+            writer.WriteString(request.WorkingDirectory);
+            writer.WriteUInt32(static_cast<std::uint32_t>(request.Arguments.size()));
+            for (const std::string& argument : request.Arguments)
+            {
+                writer.WriteString(argument);
+            }
+            return SendMessage(socket, writer.Buffer);
+        }
+
+        /// Receives a request.
+        /// @param[in] socket - The connected socket.
+        /// @return The request, if a valid one was received; null otherwise.
+        static std::optional<Request> ReceiveRequest(const int socket)
+        {
+            // RECEIVE THE MESSAGE.
+            std::optional<std::string> message = ReceiveMessage(socket);
+            if (!message)
+            {
+                return std::nullopt;
+            }
+
+            // DECODE THE REQUEST.
+            SERIALIZATION::BinaryReader reader = { .Data = *message };
+            std::optional<std::uint8_t> type = reader.ReadUInt8();
+            std::optional<std::string_view> working_directory = reader.ReadString();
+            std::optional<std::uint32_t> argument_count = reader.ReadUInt32();
+            if (reader.Failed)
+            {
+                return std::nullopt;
+            }
+            bool type_valid = (
+                static_cast<std::uint8_t>(RequestType::COMPILE) == *type ||
+                static_cast<std::uint8_t>(RequestType::SHUTDOWN) == *type);
+            if (!type_valid)
+            {
+                return std::nullopt;
+            }
+
+            Request request =
+            {
+                .Type = static_cast<RequestType>(*type),
+                .WorkingDirectory = std::string(*working_directory),
+            };
+            for (std::uint32_t argument_index = 0; argument_index < *argument_count; ++argument_index)
+            {
+                std::optional<std::string_view> argument = reader.ReadString();
+                if (!argument)
+                {
+                    return std::nullopt;
+                }
+                request.Arguments.emplace_back(*argument);
+            }
+
+            return request;
+        }
+
+        /// Sends a response.
+        /// @param[in] socket - The connected socket.
+        /// @param[in] response - The response to send.
+        /// @return True if the response was sent; false otherwise.
+        static bool SendResponse(const int socket, const Response& response)
+        {
+            SERIALIZATION::BinaryWriter writer;
+            writer.WriteUInt32(response.ExitCode);
+            writer.WriteString(response.Output);
+            return SendMessage(socket, writer.Buffer);
+        }
+
+        /// Receives a response.
+        /// @param[in] socket - The connected socket.
+        /// @return The response, if a valid one was received; null otherwise.
+        static std::optional<Response> ReceiveResponse(const int socket)
+        {
+            std::optional<std::string> message = ReceiveMessage(socket);
+            if (!message)
+            {
+                return std::nullopt;
+            }
+
+            SERIALIZATION::BinaryReader reader = { .Data = *message };
+            std::optional<std::uint32_t> exit_code = reader.ReadUInt32();
+            std::optional<std::string_view> output = reader.ReadString();
+            if (reader.Failed)
+            {
+                return std::nullopt;
+            }
+
+            Response response =
+            {
+                .ExitCode = *exit_code,
+                .Output = std::string(*output),
+            };
+            return response;
+        }
+
+    private:
+        /// Sends a length-prefixed message.
+        /// @param[in] socket - The connected socket.
+        /// @param[in] payload - The message payload.
+        /// @return True if the entire message was sent; false otherwise.
+        static bool SendMessage(const int socket, const std::string_view payload)
+        {
+            SERIALIZATION::BinaryWriter writer;
+            writer.WriteUInt32(static_cast<std::uint32_t>(payload.size()));
+            writer.WriteBytes(payload);
+
+            // SEND ALL BYTES.
+            // Sockets may accept only part of the data at a time.
+            // MSG_NOSIGNAL prevents a disconnected peer from killing the process with SIGPIPE.
+            std::size_t sent_byte_count = 0;
+            while (sent_byte_count < writer.Buffer.size())
+            {
+                ssize_t result = send(socket, writer.Buffer.data() + sent_byte_count, writer.Buffer.size() - sent_byte_count, MSG_NOSIGNAL);
+                if (result < 0)
+                {
+                    if (EINTR == errno)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                sent_byte_count += static_cast<std::size_t>(result);
+            }
+
+            return true;
+        }
+
+        /// Receives exactly a number of bytes.
+        /// @param[in] socket - The connected socket.
+        /// @param[in] byte_count - The number of bytes to receive.
+        /// @return The bytes, if all could be received; null otherwise.
+        static std::optional<std::string> ReceiveBytes(const int socket, const std::size_t byte_count)
+        {
+            std::string bytes(byte_count, '\0');
+            std::size_t received_byte_count = 0;
+            while (received_byte_count < byte_count)
+            {
+                ssize_t result = recv(socket, bytes.data() + received_byte_count, byte_count - received_byte_count, 0);
+                if (result < 0 && EINTR == errno)
+                {
+                    continue;
+                }
+                bool peer_disconnected_or_failed = (result <= 0);
+                if (peer_disconnected_or_failed)
+                {
+                    return std::nullopt;
+                }
+                received_byte_count += static_cast<std::size_t>(result);
+            }
+
+            return bytes;
+        }
+
+        /// Receives a length-prefixed message.
+        /// @param[in] socket - The connected socket.
+        /// @return The message payload, if one was received; null otherwise.
+        static std::optional<std::string> ReceiveMessage(const int socket)
+        {
+            std::optional<std::string> length_bytes = ReceiveBytes(socket, sizeof(std::uint32_t));
+            if (!length_bytes)
+            {
+                return std::nullopt;
+            }
+
+            SERIALIZATION::BinaryReader length_reader = { .Data = *length_bytes };
+            std::optional<std::uint32_t> payload_size_in_bytes = length_reader.ReadUInt32();
+            if (!payload_size_in_bytes || *payload_size_in_bytes > MAX_MESSAGE_SIZE_IN_BYTES)
+            {
+                return std::nullopt;
+            }
+
+            return ReceiveBytes(socket, *payload_size_in_bytes);
+        }
+    };
+}
+
+#endif
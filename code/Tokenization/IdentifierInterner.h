@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "Caching/ContentHash.h"
+
+namespace TOKENIZATION
+{
+    /// An identifier stored in an interner.  Each distinct identifier is stored
+    /// once, so interned identifiers can be compared and hashed by pointer.
+    struct InternedIdentifier
+    {
+        /// The ID of identifiers that haven't been assigned IDs yet.
+        static constexpr std::uint32_t UNASSIGNED_ID = UINT32_MAX;
+
+        /// The text of the identifier.  Remains valid for the lifetime of the interner.
+        std::string_view Text = {};
+        /// The hash of the text.
+        std::uint64_t Hash = 0;
+        /// The ID of the identifier, once assigned.
+        std::uint32_t Id = UNASSIGNED_ID;
+    };
+
+    /// Interns identifiers from many threads at once, such as when tokenizing
+    /// several files in parallel.
+    ///
+    /// Identifiers are spread across independent shards by hash so that threads
+    /// rarely touch the same shard.  Looking up an identifier that's already
+    /// interned never takes a lock: each shard is an open-addressed table whose
+    /// slots are only ever filled once, so readers just load them.  Only adding
+    /// a new identifier locks its shard.  Each thread also caches its recent
+    /// lookups, since the same identifiers tend to recur close together.
+    ///
+    /// Text is copied into fixed chunks that are never moved or freed until the
+    /// interner is destroyed, so interned identifiers remain valid for its lifetime.
+    ///
+    /// The order identifiers are first interned depends on thread scheduling,
+    /// so IDs are only assigned once interning is done, in sorted order.
+    /// IDs therefore depend only on the set of identifiers interned.
+    struct IdentifierInterner
+    {
+        /// Creates an empty interner.
+        IdentifierInterner() :
+            InternerNumber(NextInternerNumber().fetch_add(1, std::memory_order_relaxed))
+        {
+            for (Shard& shard : Shards)
+            {
+                shard.Grow();
+            }
+        }
+
+        IdentifierInterner(const IdentifierInterner&) = delete;
+        IdentifierInterner& operator=(const IdentifierInterner&) = delete;
+
+        /// Interns an identifier.  Safe to call from multiple threads at once.
+        /// @param[in] text - The text of the identifier.
+        /// @return The interned identifier.
+        const InternedIdentifier* Intern(const std::string_view text)
+        {
+            std::uint64_t hash = CACHING::ContentHash::Compute(text);
+
+            // CHECK THIS THREAD'S RECENT LOOKUPS.
+            // The cache may hold identifiers from an earlier interner, in which case it's started over.
+            LookupCache& lookup_cache = GetLookupCache();
+            if (InternerNumber != lookup_cache.InternerNumber)
+            {
+                lookup_cache.Identifiers.fill(nullptr);
+                lookup_cache.InternerNumber = InternerNumber;
+            }
+            const InternedIdentifier*& cached_identifier = lookup_cache.Identifiers[hash & (LOOKUP_CACHE_SIZE - 1)];
+            if (cached_identifier && hash == cached_identifier->Hash && text == cached_identifier->Text)
+            {
+                return cached_identifier;
+            }
+
+            // FIND OR ADD THE IDENTIFIER IN ITS SHARD.
+            // Shards are chosen by the highest bits of the hash since the lowest bits choose slots within a shard.
+            Shard& shard = Shards[hash >> (64 - SHARD_COUNT_BIT_COUNT)];
+            const InternedIdentifier* identifier = shard.Find(text, hash);
+            if (!identifier)
+            {
+                identifier = shard.Add(text, hash);
+            }
+            cached_identifier = identifier;
+            return identifier;
+        }
+
+        /// Assigns IDs to all interned identifiers, numbering them in sorted order from 0.
+        /// Must not be called while any thread is interning.  If more identifiers are
+        /// interned afterwards, calling this again renumbers all identifiers.
+        /// @return The number of identifiers.
+        std::size_t AssignIds()
+        {
+            // GATHER ALL IDENTIFIERS.
+            IdentifiersById.clear();
+            for (Shard& shard : Shards)
+            {
+                for (InternedIdentifier& identifier : shard.Identifiers)
+                {
+                    IdentifiersById.push_back(&identifier);
+                }
+            }
+
+            // NUMBER THEM IN SORTED ORDER.
+            std::sort(
+                IdentifiersById.begin(),
+                IdentifiersById.end(),
+                [](const InternedIdentifier* left, const InternedIdentifier* right) { return left->Text < right->Text; });
+            for (std::size_t id = 0; id < IdentifiersById.size(); ++id)
+            {
+                IdentifiersById[id]->Id = static_cast<std::uint32_t>(id);
+            }
+            return IdentifiersById.size();
+        }
+
+        /// Gets an identifier by ID.
+        /// @param[in] id - An ID from the last call to AssignIds().
+        /// @return The identifier, if the ID was assigned; null otherwise.
+        const InternedIdentifier* GetIdentifier(const std::uint32_t id) const
+        {
+            return (id < IdentifiersById.size()) ? IdentifiersById[id] : nullptr;
+        }
+
+    private:
+        /// The number of bits of hashes used to choose shards.
+        static constexpr std::size_t SHARD_COUNT_BIT_COUNT = 6;
+        /// The number of shards, which is enough that threads rarely add identifiers to the same shard.
+        static constexpr std::size_t SHARD_COUNT = std::size_t(1) << SHARD_COUNT_BIT_COUNT;
+        /// The initial number of slots in each shard's table.  Must be a power of 2.
+        static constexpr std::size_t INITIAL_SLOT_COUNT = 256;
+        /// The number of recent lookups cached by each thread.  Must be a power of 2.
+        static constexpr std::size_t LOOKUP_CACHE_SIZE = 1024;
+        /// The size of each chunk of text storage.  Longer identifiers get their own chunks.
+        static constexpr std::size_t TEXT_CHUNK_SIZE_IN_BYTES = 64 * 1024;
+        /// The size of a cache line, to keep threads using different shards from contending.
+        static constexpr std::size_t CACHE_LINE_SIZE_IN_BYTES = 64;
+
+        /// An open-addressed hash table of identifiers.
+        struct Table
+        {
+            /// The number of slots minus 1, for wrapping slot indices.
+            std::size_t SlotIndexMask = 0;
+            /// The slots, which are empty until filled once with an identifier.
+            std::unique_ptr<std::atomic<const InternedIdentifier*>[]> Slots = nullptr;
+        };
+
+        /// A portion of the identifiers, chosen by hash.
+        struct alignas(CACHE_LINE_SIZE_IN_BYTES) Shard
+        {
+            /// Finds an identifier without locking.
+            /// @param[in] text - The text of the identifier.
+            /// @param[in] hash - The hash of the text.
+            /// @return The identifier, if found; null otherwise.
+            const InternedIdentifier* Find(const std::string_view text, const std::uint64_t hash) const
+            {
+                const Table* table = CurrentTable.load(std::memory_order_acquire);
+                for (std::size_t slot_index = hash & table->SlotIndexMask; ; slot_index = (slot_index + 1) & table->SlotIndexMask)
+                {
+                    const InternedIdentifier* identifier = table->Slots[slot_index].load(std::memory_order_acquire);
+                    if (!identifier)
+                    {
+                        return nullptr;
+                    }
+                    if (hash == identifier->Hash && text == identifier->Text)
+                    {
+                        return identifier;
+                    }
+                }
+            }
+
+            /// Adds an identifier if no other thread has already.
+            /// @param[in] text - The text of the identifier.
+            /// @param[in] hash - The hash of the text.
+            /// @return The identifier.
+            const InternedIdentifier* Add(const std::string_view text, const std::uint64_t hash)
+            {
+                std::lock_guard lock(AdditionMutex);
+
+                // CHECK IF ANOTHER THREAD ALREADY ADDED THE IDENTIFIER.
+                // Readers may have been looking in an older table, so the current one is checked again.
+                const InternedIdentifier* existing_identifier = Find(text, hash);
+                if (existing_identifier)
+                {
+                    return existing_identifier;
+                }
+
+                // MAKE SURE THE TABLE STAYS AT MOST HALF FULL.
+                // This keeps probe sequences short and guarantees lookups reach an empty slot.
+                const Table* table = CurrentTable.load(std::memory_order_relaxed);
+                std::size_t slot_count = table->SlotIndexMask + 1;
+                if (2 * (Identifiers.size() + 1) > slot_count)
+                {
+                    Grow();
+                    table = CurrentTable.load(std::memory_order_relaxed);
+                }
+
+                // STORE THE IDENTIFIER.
+                InternedIdentifier& identifier = Identifiers.emplace_back(InternedIdentifier
+                {
+                    .Text = StoreText(text),
+                    .Hash = hash,
+                });
+
+                // PUBLISH IT.
+                // The release store makes the identifier visible to readers only once it's complete.
+                Insert(*table, identifier, std::memory_order_release);
+                return &identifier;
+            }
+
+            /// Replaces the table with one twice as large.
+            /// Must only be called while holding the addition mutex (or before any lookups).
+            void Grow()
+            {
+                // CREATE THE NEW TABLE.
+                const Table* old_table = CurrentTable.load(std::memory_order_relaxed);
+                std::size_t slot_count = old_table ? 2 * (old_table->SlotIndexMask + 1) : INITIAL_SLOT_COUNT;
+                std::unique_ptr<Table> new_table = std::make_unique<Table>(Table
+                {
+                    .SlotIndexMask = slot_count - 1,
+                    .Slots = std::make_unique<std::atomic<const InternedIdentifier*>[]>(slot_count),
+                });
+                for (const InternedIdentifier& identifier : Identifiers)
+                {
+                    Insert(*new_table, identifier, std::memory_order_relaxed);
+                }
+
+                // PUBLISH IT.
+                // Old tables are kept since other threads may still be reading them.
+                CurrentTable.store(new_table.get(), std::memory_order_release);
+                Tables.push_back(std::move(new_table));
+            }
+
+            /// Fills the first empty slot for an identifier.
+            /// @param[in,out] table - The table to add to.  Must have an empty slot.
+            /// @param[in] identifier - The identifier to add.
+            /// @param[in] memory_order - The ordering for storing the identifier in its slot.
+            static void Insert(const Table& table, const InternedIdentifier& identifier, const std::memory_order memory_order)
+            {
+                std::size_t slot_index = identifier.Hash & table.SlotIndexMask;
+                while (table.Slots[slot_index].load(std::memory_order_relaxed))
+                {
+                    slot_index = (slot_index + 1) & table.SlotIndexMask;
+                }
+                table.Slots[slot_index].store(&identifier, memory_order);
+            }
+
+            /// Copies text into storage that's never moved.
+            /// @param[in] text - The text to copy.
+            /// @return The stored text.
+            std::string_view StoreText(const std::string_view text)
+            {
+                if (text.size() > TextChunkRemainingByteCount)
+                {
+                    std::size_t chunk_size_in_bytes = std::max(TEXT_CHUNK_SIZE_IN_BYTES, text.size());
+                    TextChunks.push_back(std::make_unique<char[]>(chunk_size_in_bytes));
+                    TextChunkPosition = TextChunks.back().get();
+                    TextChunkRemainingByteCount = chunk_size_in_bytes;
+                }
+
+                char* stored_text = TextChunkPosition;
+                std::memcpy(stored_text, text.data(), text.size());
+                TextChunkPosition += text.size();
+                TextChunkRemainingByteCount -= text.size();
+                return std::string_view(stored_text, text.size());
+            }
+
+            /// The table currently used for lookups.
+            std::atomic<const Table*> CurrentTable = nullptr;
+            /// Serializes additions to the shard.
+            std::mutex AdditionMutex = {};
+            /// Every table the shard has used, since readers may still be using older ones.
+            std::vector<std::unique_ptr<Table>> Tables = {};
+            /// The identifiers in the shard, which never move once added.
+            std::deque<InternedIdentifier> Identifiers = {};
+            /// Storage for the text of identifiers.
+            std::vector<std::unique_ptr<char[]>> TextChunks = {};
+            /// Where the next text is stored in the last chunk.
+            char* TextChunkPosition = nullptr;
+            /// The number of bytes left in the last chunk.
+            std::size_t TextChunkRemainingByteCount = 0;
+        };
+
+        /// A thread's recent lookups.
+        struct LookupCache
+        {
+            /// The interner the cached identifiers are from, or 0 if none.
+            std::uint64_t InternerNumber = 0;
+            /// Recently interned identifiers, by the lowest bits of their hashes.
+            std::array<const InternedIdentifier*, LOOKUP_CACHE_SIZE> Identifiers = {};
+        };
+
+        /// Gets the counter used to number interners.
+        /// Numbers are never reused, so a thread's cache can't be mistaken as belonging to a later interner.
+        /// @return The number for the next interner.
+        static std::atomic<std::uint64_t>& NextInternerNumber()
+        {
+            static std::atomic<std::uint64_t> next_interner_number = 1;
+            return next_interner_number;
+        }
+
+        /// Gets the current thread's recent lookups.
+        /// @return The thread's lookup cache.
+        static LookupCache& GetLookupCache()
+        {
+            thread_local LookupCache lookup_cache;
+            return lookup_cache;
+        }
+
+        /// The number identifying this interner.
+        const std::uint64_t InternerNumber;
+        /// The shards holding identifiers.
+        std::array<Shard, SHARD_COUNT> Shards = {};
+        /// Identifiers by ID, as of the last time IDs were assigned.
+        std::vector<InternedIdentifier*> IdentifiersById = {};
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 #include "Tokenization/Token.h"
 #include "Tokenization/TokenType.h"
 
@@ -89,6 +90,36 @@ namespace TOKENIZATION
             return matching_next_tokens;
         }
         
+        /// Skips any comments at the current position in the stream.
+        void SkipComments()
+        {
+            while (MoreTokens() && TokenType::COMMENT == Tokens[CurrentIndex].Type)
+            {
+                ++CurrentIndex;
+            }
+        }
+
+        /// Peeks at an upcoming token without consuming anything, ignoring comments.
+        /// @param[in] lookahead_count - The number of non-comment tokens to look past.
+        /// @return The upcoming token, if it exists; null otherwise.
+        const Token* PeekNonCommentToken(const std::size_t lookahead_count = 0) const
+        {
+            std::size_t remaining_lookahead_count = lookahead_count;
+            for (std::size_t token_index = CurrentIndex; token_index < Tokens.size(); ++token_index)
+            {
+                if (TokenType::COMMENT == Tokens[token_index].Type)
+                {
+                    continue;
+                }
+                if (0 == remaining_lookahead_count)
+                {
+                    return &Tokens[token_index];
+                }
+                --remaining_lookahead_count;
+            }
+            return nullptr;
+        }
+
         /// The index of the current token in the stream.
         std::size_t CurrentIndex = 0;
         /// The remaining tokens in the stream.
@@ -26,6 +26,7 @@ namespace TOKENIZATION
         CLOSING_PARENTHESIS,
         OPENING_CURLY_BRACE,
         CLOSING_CURLY_BRACE,
+        PREPROCESSOR_DIRECTIVE, /// An entire directive line (such as "#include <file>"), including any continuations.
     };
 }
 
@@ -1,7 +1,14 @@
+#pragma once
+
+#include <functional>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 #include "LanguageConstructs/Identifier.h"
 #include "LanguageConstructs/MultilineComment.h"
 #include "LanguageConstructs/Number.h"
+#include "LanguageConstructs/PreprocessorDirective.h"
 #include "LanguageConstructs/SingleLineComment.h"
 #include "LanguageConstructs/StringLiteral.h"
 #include "Tokenization/TokenStream.h"
@@ -17,12 +24,60 @@ namespace TOKENIZATION
         static TokenStream Tokenize(const std::string& source_code)
         {
             TokenStream token_stream;
-            
+            TokenizeInBatches(source_code, 0, nullptr, token_stream);
+            return token_stream;
+        }
+
+        /// Converts a string of raw source code into tokens, handing them off in batches
+        /// as soon as they're complete so that later phases can start on them early.
+        /// @param[in] source_code - The source code to parse.
+        /// @param[in] batch_size - The minimum number of tokens in each batch (except the last).
+        /// @param[in] publish_batch - Called with each batch of tokens, in order.
+        ///     The final batch (possibly empty) is followed by no further calls.
+        static void Tokenize(
+            const std::string& source_code,
+            const std::size_t batch_size,
+            const std::function<void(std::vector<Token>&& batch)>& publish_batch)
+        {
+            TokenStream token_stream;
+            TokenizeInBatches(source_code, batch_size, &publish_batch, token_stream);
+            publish_batch(std::move(token_stream.Tokens));
+        }
+        
+    private:
+        /// Converts a string of raw source code into tokens.
+        /// @param[in] source_code - The source code to parse.
+        /// @param[in] batch_size - The minimum number of tokens in each published batch.
+        /// @param[in] publish_batch - Called with each full batch of tokens, if batches are published.
+        /// @param[out] token_stream - The stream to add tokens to.  Holds any tokens not yet published.
+        static void TokenizeInBatches(
+            const std::string& source_code,
+            const std::size_t batch_size,
+            const std::function<void(std::vector<Token>&& batch)>* const publish_batch,
+            TokenStream& token_stream)
+        {
             // PARSE EACH CHARACTER IN THE SOURCE CODE.
             std::size_t character_index = 0;
             std::size_t source_code_character_count = source_code.length();
+            std::size_t positioned_token_count = 0;
+            SourcePosition token_start_position;
             while (character_index < source_code_character_count)
             {
+                // RECORD WHERE ANY TOKENS FROM THE PREVIOUS CHARACTER STARTED.
+                SetTokenPositions(token_start_position, token_stream, positioned_token_count);
+                token_start_position.AdvanceTo(source_code, character_index);
+
+                // PUBLISH ANY FULL BATCH OF TOKENS.
+                // Tokens are never revisited once they have positions, so they're complete.
+                bool batch_full = (publish_batch && positioned_token_count > 0 && positioned_token_count >= batch_size);
+                if (batch_full)
+                {
+                    (*publish_batch)(std::move(token_stream.Tokens));
+                    token_stream.Tokens.clear();
+                    token_stream.Tokens.reserve(batch_size);
+                    positioned_token_count = 0;
+                }
+                
                 // PROCESS THE CURRENT CHARACTER.
                 char current_character = source_code[character_index];
                 //std::printf("%c", current_character);
@@ -55,6 +110,20 @@ namespace TOKENIZATION
                                 character_index += multiline_comment->Value.length();
                                 continue;
                             }
+                            else if ('=' == String::GetCharacterIfExists(source_code, character_index + 1))
+                            {
+                                // ADD THE DIVISION ASSIGNMENT OPERATOR.
+                                Token division_assignment_operator =
+                                {
+                                    .Type = TokenType::OPERATOR,
+                                    .Value = "/=",
+                                };
+                                token_stream.Tokens.push_back(division_assignment_operator);
+
+                                // ADVANCE TO THE NEXT CHARACTER.
+                                character_index += division_assignment_operator.Value.length();
+                                continue;
+                            }
                             else
                             {
                                 // ADD THE DIVISION OPERATOR.
@@ -80,7 +149,7 @@ namespace TOKENIZATION
                         Token opening_curly_brace = 
                         {
                             .Type = TokenType::OPENING_CURLY_BRACE,
-                            .Value = '{'
+                            .Value = "{"
                         };
                         token_stream.Tokens.push_back(opening_curly_brace);
                         break;
@@ -91,7 +160,7 @@ namespace TOKENIZATION
                         Token closing_curly_brace = 
                         {
                             .Type = TokenType::CLOSING_CURLY_BRACE,
-                            .Value = '}'
+                            .Value = "}"
                         };
                         token_stream.Tokens.push_back(closing_curly_brace);
                         break;
@@ -124,7 +193,7 @@ namespace TOKENIZATION
                         Token opening_parenthesis = 
                         {
                             .Type = TokenType::OPENING_PARENTHESIS,
-                            .Value = '('
+                            .Value = "("
                         };
                         token_stream.Tokens.push_back(opening_parenthesis);
                         break;
@@ -135,7 +204,7 @@ namespace TOKENIZATION
                         Token closing_parenthesis = 
                         {
                             .Type = TokenType::CLOSING_PARENTHESIS,
-                            .Value = ')'
+                            .Value = ")"
                         };
                         token_stream.Tokens.push_back(closing_parenthesis);
                         break;
@@ -212,14 +281,30 @@ namespace TOKENIZATION
                         }
                         else if ('<' == next_character)
                         {
-                            // ADD THE LEFT-SHIFT OPERATOR.
-                            Token left_shift_operator =
+                            std::size_t third_character_index = next_character_index + 1;
+                            std::optional<char> third_character = String::GetCharacterIfExists(source_code, third_character_index);
+                            if ('=' == third_character)
                             {
-                                .Type = TokenType::OPERATOR,
-                                .Value = "<<"
-                            };
-                            token_stream.Tokens.push_back(left_shift_operator);
-                            character_index = next_character_index;
+                                // ADD THE LEFT-SHIFT ASSIGNMENT OPERATOR.
+                                Token left_shift_assignment_operator =
+                                {
+                                    .Type = TokenType::OPERATOR,
+                                    .Value = "<<="
+                                };
+                                token_stream.Tokens.push_back(left_shift_assignment_operator);
+                                character_index = third_character_index;
+                            }
+                            else
+                            {
+                                // ADD THE LEFT-SHIFT OPERATOR.
+                                Token left_shift_operator =
+                                {
+                                    .Type = TokenType::OPERATOR,
+                                    .Value = "<<"
+                                };
+                                token_stream.Tokens.push_back(left_shift_operator);
+                                character_index = next_character_index;
+                            }
                         }
                         else
                         {
@@ -250,14 +335,30 @@ namespace TOKENIZATION
                         }
                         else if ('>' == next_character)
                         {
-                            // ADD THE LEFT-SHIFT OPERATOR.
-                            Token right_shift_operator =
+                            std::size_t third_character_index = next_character_index + 1;
+                            std::optional<char> third_character = String::GetCharacterIfExists(source_code, third_character_index);
+                            if ('=' == third_character)
                             {
-                                .Type = TokenType::OPERATOR,
-                                .Value = ">>"
-                            };
-                            token_stream.Tokens.push_back(right_shift_operator);
-                            character_index = next_character_index;
+                                // ADD THE RIGHT-SHIFT ASSIGNMENT OPERATOR.
+                                Token right_shift_assignment_operator =
+                                {
+                                    .Type = TokenType::OPERATOR,
+                                    .Value = ">>="
+                                };
+                                token_stream.Tokens.push_back(right_shift_assignment_operator);
+                                character_index = third_character_index;
+                            }
+                            else
+                            {
+                                // ADD THE RIGHT-SHIFT OPERATOR.
+                                Token right_shift_operator =
+                                {
+                                    .Type = TokenType::OPERATOR,
+                                    .Value = ">>"
+                                };
+                                token_stream.Tokens.push_back(right_shift_operator);
+                                character_index = next_character_index;
+                            }
                         }
                         else
                         {
@@ -286,6 +387,17 @@ namespace TOKENIZATION
                             token_stream.Tokens.push_back(logical_or_operator);
                             character_index = next_character_index;
                         }
+                        else if ('=' == next_character)
+                        {
+                            // ADD THE BITWISE OR ASSIGNMENT OPERATOR.
+                            Token bitwise_or_assignment_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "|="
+                            };
+                            token_stream.Tokens.push_back(bitwise_or_assignment_operator);
+                            character_index = next_character_index;
+                        }
                         else
                         {
                             // ADD THE BITWISE OR OPERATOR.
@@ -313,6 +425,17 @@ namespace TOKENIZATION
                             token_stream.Tokens.push_back(logical_and_operator);
                             character_index = next_character_index;
                         }
+                        else if ('=' == next_character)
+                        {
+                            // ADD THE BITWISE AND ASSIGNMENT OPERATOR.
+                            Token bitwise_and_assignment_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "&="
+                            };
+                            token_stream.Tokens.push_back(bitwise_and_assignment_operator);
+                            character_index = next_character_index;
+                        }
                         else
                         {
                             // ADD THE BITWISE AND OPERATOR.
@@ -340,6 +463,17 @@ namespace TOKENIZATION
                             token_stream.Tokens.push_back(increment_operator);
                             character_index = next_character_index;
                         }
+                        else if ('=' == next_character)
+                        {
+                            // ADD THE ADDITION ASSIGNMENT OPERATOR.
+                            Token addition_assignment_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "+="
+                            };
+                            token_stream.Tokens.push_back(addition_assignment_operator);
+                            character_index = next_character_index;
+                        }
                         else
                         {
                             // ADD THE PLUS OPERATOR.
@@ -378,6 +512,17 @@ namespace TOKENIZATION
                             token_stream.Tokens.push_back(decrement_operator);
                             character_index = next_character_index;
                         }
+                        else if ('=' == next_character)
+                        {
+                            // ADD THE SUBTRACTION ASSIGNMENT OPERATOR.
+                            Token subtraction_assignment_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "-="
+                            };
+                            token_stream.Tokens.push_back(subtraction_assignment_operator);
+                            character_index = next_character_index;
+                        }
                         else
                         {
                             // ADD THE MINUS OPERATOR.
@@ -392,13 +537,69 @@ namespace TOKENIZATION
                     }
                     case '*':
                     {
-                        // ADD THE MULTIPLICATION OPERATOR.
-                        Token multiplication_operator =
+                        std::size_t next_character_index = character_index + 1;
+                        std::optional<char> next_character = String::GetCharacterIfExists(source_code, next_character_index);
+                        if ('=' == next_character)
                         {
-                            .Type = TokenType::OPERATOR,
-                            .Value = "*"
-                        };
-                        token_stream.Tokens.push_back(multiplication_operator);
+                            // ADD THE MULTIPLICATION ASSIGNMENT OPERATOR.
+                            Token multiplication_assignment_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "*="
+                            };
+                            token_stream.Tokens.push_back(multiplication_assignment_operator);
+                            character_index = next_character_index;
+                        }
+                        else
+                        {
+                            // ADD THE MULTIPLICATION OPERATOR.
+                            Token multiplication_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "*"
+                            };
+                            token_stream.Tokens.push_back(multiplication_operator);
+                        }
+                        break;
+                    }
+                    // PREPROCESSING.
+                    case '#':
+                    {
+                        // TRY PARSING A PREPROCESSOR DIRECTIVE.
+                        std::optional<Token> preprocessor_directive = PreprocessorDirective::Parse(source_code, character_index);
+                        if (preprocessor_directive)
+                        {
+                            // ADD THE PREPROCESSOR DIRECTIVE.
+                            token_stream.Tokens.push_back(*preprocessor_directive);
+                            
+                            // ADVANCE TO THE NEXT CHARACTER.
+                            character_index += preprocessor_directive->Value.length();
+                            continue;
+                        }
+                        
+                        std::size_t next_character_index = character_index + 1;
+                        std::optional<char> next_character = String::GetCharacterIfExists(source_code, next_character_index);
+                        if ('#' == next_character)
+                        {
+                            // ADD THE TOKEN-PASTING OPERATOR.
+                            Token token_pasting_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "##"
+                            };
+                            token_stream.Tokens.push_back(token_pasting_operator);
+                            character_index = next_character_index;
+                        }
+                        else
+                        {
+                            // ADD THE STRINGIZING OPERATOR.
+                            Token stringizing_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "#"
+                            };
+                            token_stream.Tokens.push_back(stringizing_operator);
+                        }
                         break;
                     }
                     // STATEMENT TERMINATOR.
@@ -413,11 +614,137 @@ namespace TOKENIZATION
                         token_stream.Tokens.push_back(statement_terminator);
                         break;
                     }
+                    // SEPARATORS.
+                    case ',':
+                    {
+                        // ADD THE COMMA.
+                        Token comma =
+                        {
+                            .Type = TokenType::PUNCTUATOR,
+                            .Value = ","
+                        };
+                        token_stream.Tokens.push_back(comma);
+                        break;
+                    }
+                    case '.':
+                    {
+                        const std::string ELLIPSIS = "...";
+                        bool is_ellipsis = String::CharactersMatch(source_code, character_index, ELLIPSIS);
+                        if (is_ellipsis)
+                        {
+                            // ADD THE ELLIPSIS.
+                            Token ellipsis =
+                            {
+                                .Type = TokenType::PUNCTUATOR,
+                                .Value = ELLIPSIS
+                            };
+                            token_stream.Tokens.push_back(ellipsis);
+                            character_index += ELLIPSIS.length();
+                            continue;
+                        }
+                        
+                        // ADD THE MEMBER ACCESS OPERATOR.
+                        Token member_access_operator =
+                        {
+                            .Type = TokenType::OPERATOR,
+                            .Value = "."
+                        };
+                        token_stream.Tokens.push_back(member_access_operator);
+                        break;
+                    }
+                    case ':':
+                    {
+                        // ADD THE COLON.
+                        Token colon =
+                        {
+                            .Type = TokenType::PUNCTUATOR,
+                            .Value = ":"
+                        };
+                        token_stream.Tokens.push_back(colon);
+                        break;
+                    }
+                    // ADDITIONAL OPERATORS.
+                    case '%':
+                    {
+                        std::size_t next_character_index = character_index + 1;
+                        std::optional<char> next_character = String::GetCharacterIfExists(source_code, next_character_index);
+                        if ('=' == next_character)
+                        {
+                            // ADD THE REMAINDER ASSIGNMENT OPERATOR.
+                            Token remainder_assignment_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "%="
+                            };
+                            token_stream.Tokens.push_back(remainder_assignment_operator);
+                            character_index = next_character_index;
+                        }
+                        else
+                        {
+                            // ADD THE REMAINDER OPERATOR.
+                            Token remainder_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "%"
+                            };
+                            token_stream.Tokens.push_back(remainder_operator);
+                        }
+                        break;
+                    }
+                    case '^':
+                    {
+                        std::size_t next_character_index = character_index + 1;
+                        std::optional<char> next_character = String::GetCharacterIfExists(source_code, next_character_index);
+                        if ('=' == next_character)
+                        {
+                            // ADD THE BITWISE EXCLUSIVE OR ASSIGNMENT OPERATOR.
+                            Token bitwise_exclusive_or_assignment_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "^="
+                            };
+                            token_stream.Tokens.push_back(bitwise_exclusive_or_assignment_operator);
+                            character_index = next_character_index;
+                        }
+                        else
+                        {
+                            // ADD THE BITWISE EXCLUSIVE OR OPERATOR.
+                            Token bitwise_exclusive_or_operator =
+                            {
+                                .Type = TokenType::OPERATOR,
+                                .Value = "^"
+                            };
+                            token_stream.Tokens.push_back(bitwise_exclusive_or_operator);
+                        }
+                        break;
+                    }
+                    case '~':
+                    {
+                        // ADD THE BITWISE NOT OPERATOR.
+                        Token bitwise_not_operator =
+                        {
+                            .Type = TokenType::OPERATOR,
+                            .Value = "~"
+                        };
+                        token_stream.Tokens.push_back(bitwise_not_operator);
+                        break;
+                    }
+                    case '?':
+                    {
+                        // ADD THE CONDITIONAL OPERATOR.
+                        Token conditional_operator =
+                        {
+                            .Type = TokenType::OPERATOR,
+                            .Value = "?"
+                        };
+                        token_stream.Tokens.push_back(conditional_operator);
+                        break;
+                    }
                     // KEYWORD PARSING.
                     case 'a':
                     {
                         const std::string AUTO_KEYWORD = "auto";
-                        bool is_auto = String::CharactersMatch(source_code, character_index, AUTO_KEYWORD);
+                        bool is_auto = String::WordMatches(source_code, character_index, AUTO_KEYWORD);
                         if (is_auto)
                         {
                             Token auto_keyword =
@@ -441,7 +768,7 @@ namespace TOKENIZATION
                     case 'b':
                     {
                         const std::string BREAK_KEYWORD = "break";
-                        bool is_break = String::CharactersMatch(source_code, character_index, BREAK_KEYWORD);
+                        bool is_break = String::WordMatches(source_code, character_index, BREAK_KEYWORD);
                         if (is_break)
                         {
                             Token break_keyword =
@@ -465,7 +792,7 @@ namespace TOKENIZATION
                     case 'c':
                     {
                         const std::string CASE_KEYWORD = "case";
-                        bool is_case = String::CharactersMatch(source_code, character_index, CASE_KEYWORD);
+                        bool is_case = String::WordMatches(source_code, character_index, CASE_KEYWORD);
                         if (is_case)
                         {
                             Token case_keyword =
@@ -479,7 +806,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string CHAR_KEYWORD = "char";
-                        bool is_char = String::CharactersMatch(source_code, character_index, CHAR_KEYWORD);
+                        bool is_char = String::WordMatches(source_code, character_index, CHAR_KEYWORD);
                         if (is_char)
                         {
                             Token char_keyword =
@@ -493,7 +820,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string CONST_KEYWORD = "const";
-                        bool is_const = String::CharactersMatch(source_code, character_index, CONST_KEYWORD);
+                        bool is_const = String::WordMatches(source_code, character_index, CONST_KEYWORD);
                         if (is_const)
                         {
                             Token const_keyword =
@@ -507,7 +834,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string CONTINUE_KEYWORD = "continue";
-                        bool is_continue = String::CharactersMatch(source_code, character_index, CONTINUE_KEYWORD);
+                        bool is_continue = String::WordMatches(source_code, character_index, CONTINUE_KEYWORD);
                         if (is_continue)
                         {
                             Token continue_keyword =
@@ -528,7 +855,7 @@ namespace TOKENIZATION
                     case 'd':
                     {
                         const std::string DEFAULT_KEYWORD = "default";
-                        bool is_default = String::CharactersMatch(source_code, character_index, DEFAULT_KEYWORD);
+                        bool is_default = String::WordMatches(source_code, character_index, DEFAULT_KEYWORD);
                         if (is_default)
                         {
                             Token default_keyword =
@@ -542,7 +869,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string DOUBLE_KEYWORD = "double";
-                        bool is_double = String::CharactersMatch(source_code, character_index, DOUBLE_KEYWORD);
+                        bool is_double = String::WordMatches(source_code, character_index, DOUBLE_KEYWORD);
                         if (is_double)
                         {
                             Token double_keyword =
@@ -556,7 +883,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string DO_KEYWORD = "do";
-                        bool is_do = String::CharactersMatch(source_code, character_index, DO_KEYWORD);
+                        bool is_do = String::WordMatches(source_code, character_index, DO_KEYWORD);
                         if (is_do)
                         {
                             Token do_keyword =
@@ -577,7 +904,7 @@ namespace TOKENIZATION
                     case 'e':
                     {
                         const std::string ELSE_KEYWORD = "else";
-                        bool is_else = String::CharactersMatch(source_code, character_index, ELSE_KEYWORD);
+                        bool is_else = String::WordMatches(source_code, character_index, ELSE_KEYWORD);
                         if (is_else)
                         {
                             Token else_keyword =
@@ -591,7 +918,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string ENUM_KEYWORD = "enum";
-                        bool is_enum = String::CharactersMatch(source_code, character_index, ENUM_KEYWORD);
+                        bool is_enum = String::WordMatches(source_code, character_index, ENUM_KEYWORD);
                         if (is_enum)
                         {
                             Token enum_keyword =
@@ -605,7 +932,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string EXTERN_KEYWORD = "extern";
-                        bool is_extern = String::CharactersMatch(source_code, character_index, EXTERN_KEYWORD);
+                        bool is_extern = String::WordMatches(source_code, character_index, EXTERN_KEYWORD);
                         if (is_extern)
                         {
                             Token extern_keyword =
@@ -626,7 +953,7 @@ namespace TOKENIZATION
                     case 'f':
                     {
                         const std::string FLOAT_KEYWORD = "float";
-                        bool is_float = String::CharactersMatch(source_code, character_index, FLOAT_KEYWORD);
+                        bool is_float = String::WordMatches(source_code, character_index, FLOAT_KEYWORD);
                         if (is_float)
                         {
                             Token float_keyword =
@@ -640,7 +967,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string FOR_KEYWORD = "for";
-                        bool is_for = String::CharactersMatch(source_code, character_index, FOR_KEYWORD);
+                        bool is_for = String::WordMatches(source_code, character_index, FOR_KEYWORD);
                         if (is_for)
                         {
                             Token for_keyword =
@@ -661,7 +988,7 @@ namespace TOKENIZATION
                     case 'g':
                     {
                         const std::string GOTO_KEYWORD = "goto";
-                        bool is_goto = String::CharactersMatch(source_code, character_index, GOTO_KEYWORD);
+                        bool is_goto = String::WordMatches(source_code, character_index, GOTO_KEYWORD);
                         if (is_goto)
                         {
                             Token goto_keyword =
@@ -685,7 +1012,7 @@ namespace TOKENIZATION
                     case 'i':
                     {
                         const std::string IF_KEYWORD = "if";
-                        bool is_if_keyword = String::CharactersMatch(source_code, character_index, IF_KEYWORD);
+                        bool is_if_keyword = String::WordMatches(source_code, character_index, IF_KEYWORD);
                         if (is_if_keyword)
                         {
                             // ADD THE IF KEYWORD.
@@ -702,7 +1029,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string INT_KEYWORD = "int";
-                        bool is_int_keyword = String::CharactersMatch(source_code, character_index, INT_KEYWORD);
+                        bool is_int_keyword = String::WordMatches(source_code, character_index, INT_KEYWORD);
                         if (is_int_keyword)
                         {
                             // ADD THE INT KEYWORD.
@@ -727,7 +1054,7 @@ namespace TOKENIZATION
                     case 'l':
                     {
                         const std::string LONG_KEYWORD = "long";
-                        bool is_long = String::CharactersMatch(source_code, character_index, LONG_KEYWORD);
+                        bool is_long = String::WordMatches(source_code, character_index, LONG_KEYWORD);
                         if (is_long)
                         {
                             Token long_keyword =
@@ -751,7 +1078,7 @@ namespace TOKENIZATION
                     case 'r':
                     {
                         const std::string REGISTER_KEYWORD = "register";
-                        bool is_register = String::CharactersMatch(source_code, character_index, REGISTER_KEYWORD);
+                        bool is_register = String::WordMatches(source_code, character_index, REGISTER_KEYWORD);
                         if (is_register)
                         {
                             Token register_keyword =
@@ -765,7 +1092,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string RETURN_KEYWORD = "return";
-                        bool is_return = String::CharactersMatch(source_code, character_index, RETURN_KEYWORD);
+                        bool is_return = String::WordMatches(source_code, character_index, RETURN_KEYWORD);
                         if (is_return)
                         {
                             Token return_keyword =
@@ -786,7 +1113,7 @@ namespace TOKENIZATION
                     case 's':
                     {
                         const std::string SHORT_KEYWORD = "short";
-                        bool is_short = String::CharactersMatch(source_code, character_index, SHORT_KEYWORD);
+                        bool is_short = String::WordMatches(source_code, character_index, SHORT_KEYWORD);
                         if (is_short)
                         {
                             Token short_keyword =
@@ -800,7 +1127,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string SIGNED_KEYWORD = "signed";
-                        bool is_signed = String::CharactersMatch(source_code, character_index, SIGNED_KEYWORD);
+                        bool is_signed = String::WordMatches(source_code, character_index, SIGNED_KEYWORD);
                         if (is_signed)
                         {
                             Token signed_keyword =
@@ -814,7 +1141,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string SIZE_OF_KEYWORD = "sizeof";
-                        bool is_sizeof = String::CharactersMatch(source_code, character_index, SIZE_OF_KEYWORD);
+                        bool is_sizeof = String::WordMatches(source_code, character_index, SIZE_OF_KEYWORD);
                         if (is_sizeof)
                         {
                             Token sizeof_keyword =
@@ -828,7 +1155,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string STATIC_KEYWORD = "static";
-                        bool is_static = String::CharactersMatch(source_code, character_index, STATIC_KEYWORD);
+                        bool is_static = String::WordMatches(source_code, character_index, STATIC_KEYWORD);
                         if (is_static)
                         {
                             Token static_keyword =
@@ -837,12 +1164,12 @@ namespace TOKENIZATION
                                 .Value = STATIC_KEYWORD
                             };
                             token_stream.Tokens.push_back(static_keyword);
-                            character_index = STATIC_KEYWORD.length();
+                            character_index += STATIC_KEYWORD.length();
                             continue;
                         }
                         
                         const std::string STRUCT_KEYWORD = "struct";
-                        bool is_struct = String::CharactersMatch(source_code, character_index, STRUCT_KEYWORD);
+                        bool is_struct = String::WordMatches(source_code, character_index, STRUCT_KEYWORD);
                         if (is_struct)
                         {
                             Token struct_keyword =
@@ -856,7 +1183,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string SWITCH_KEYWORD = "switch";
-                        bool is_switch = String::CharactersMatch(source_code, character_index, SWITCH_KEYWORD);
+                        bool is_switch = String::WordMatches(source_code, character_index, SWITCH_KEYWORD);
                         if (is_switch)
                         {
                             Token switch_keyword =
@@ -877,7 +1204,7 @@ namespace TOKENIZATION
                     case 't':
                     {
                         const std::string TYPEDEF_KEYWORD = "typedef";
-                        bool is_typedef = String::CharactersMatch(source_code, character_index, TYPEDEF_KEYWORD);
+                        bool is_typedef = String::WordMatches(source_code, character_index, TYPEDEF_KEYWORD);
                         if (is_typedef)
                         {
                             Token typedef_keyword =
@@ -901,7 +1228,7 @@ namespace TOKENIZATION
                     case 'u':
                     {
                         const std::string UNION_KEYWORD = "union";
-                        bool is_union = String::CharactersMatch(source_code, character_index, UNION_KEYWORD);
+                        bool is_union = String::WordMatches(source_code, character_index, UNION_KEYWORD);
                         if (is_union)
                         {
                             Token union_keyword =
@@ -915,7 +1242,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string UNSIGNED_KEYWORD = "unsigned";
-                        bool is_unsigned = String::CharactersMatch(source_code, character_index, UNSIGNED_KEYWORD);
+                        bool is_unsigned = String::WordMatches(source_code, character_index, UNSIGNED_KEYWORD);
                         if (is_unsigned)
                         {
                             Token unsigned_keyword =
@@ -936,7 +1263,7 @@ namespace TOKENIZATION
                     case 'v':
                     {
                         const std::string VOID_KEYWORD = "void";
-                        bool is_void = String::CharactersMatch(source_code, character_index, VOID_KEYWORD);
+                        bool is_void = String::WordMatches(source_code, character_index, VOID_KEYWORD);
                         if (is_void)
                         {
                             Token void_keyword =
@@ -950,7 +1277,7 @@ namespace TOKENIZATION
                         }
                         
                         const std::string VOLATILE_KEYWORD = "volatile";
-                        bool is_volatile = String::CharactersMatch(source_code, character_index, VOLATILE_KEYWORD);
+                        bool is_volatile = String::WordMatches(source_code, character_index, VOLATILE_KEYWORD);
                         if (is_volatile)
                         {
                             Token volatile_keyword =
@@ -971,7 +1298,7 @@ namespace TOKENIZATION
                     case 'w':
                     {
                         const std::string WHILE_KEYWORD = "while";
-                        bool is_while = String::CharactersMatch(source_code, character_index, WHILE_KEYWORD);
+                        bool is_while = String::WordMatches(source_code, character_index, WHILE_KEYWORD);
                         if (is_while)
                         {
                             Token while_keyword =
@@ -1011,13 +1338,23 @@ namespace TOKENIZATION
                         character_index += string_literal.Value.length();
                         continue;
                     }
+                    // CHARACTER CONSTANTS.
+                    case '\'':
+                    {
+                        // ADD A CHARACTER CONSTANT.
+                        Token character_constant = StringLiteral::Parse(source_code, character_index);
+                        character_constant.Type = TokenType::CONSTANT;
+                        token_stream.Tokens.push_back(character_constant);
+                        character_index += character_constant.Value.length();
+                        continue;
+                    }
                     // REMAINING IDENTIFIER PARSING.
                     case 'h': case 'j': case 'k': case 'm': case 'n': case 'o':
                     case 'p': case 'q': case 'x': case 'y': case 'z':
                     case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': 
-                    case 'H': case 'I': case 'J': case 'K': case 'M': case 'N': case 'O': 
+                    case 'H': case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': 
                     case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': 
-                    case 'W': case 'X': case 'Y': case 'Z':
+                    case 'W': case 'X': case 'Y': case 'Z': case '_':
                     {
                         // ADD AN IDENTIFIER.
                         Token identifier = Identifier::Parse(source_code, character_index);
@@ -1030,9 +1367,52 @@ namespace TOKENIZATION
                 // MOVE TO THE NEXT CHARACTER.
                 ++character_index;
             }
+            SetTokenPositions(token_start_position, token_stream, positioned_token_count);
+        }
+        
+        /// A position within source code.
+        struct SourcePosition
+        {
+            /// Moves the position forward to a later character.
+            /// @param[in] source_code - The source code being tokenized.
+            /// @param[in] character_index - The index of the later character.
+            void AdvanceTo(const std::string& source_code, const std::size_t character_index)
+            {
+                for (; CharacterIndex < character_index; ++CharacterIndex)
+                {
+                    bool is_newline = ('\n' == source_code[CharacterIndex]);
+                    if (is_newline)
+                    {
+                        ++LineNumber;
+                        ColumnNumber = 1;
+                    }
+                    else
+                    {
+                        ++ColumnNumber;
+                    }
+                }
+            }
             
-            // RETURN ANY PARSED TOKEN STREAM.
-            return token_stream;
+            /// The index of the character in the source code.
+            std::size_t CharacterIndex = 0;
+            /// The line number of the character (starting at 1).
+            std::size_t LineNumber = 1;
+            /// The column number of the character (starting at 1).
+            std::size_t ColumnNumber = 1;
+        };
+        
+        /// Sets the position of any tokens that don't have one yet.
+        /// @param[in] position - The position where the tokens started.
+        /// @param[in,out] token_stream - The tokens parsed so far.
+        /// @param[in,out] positioned_token_count - The number of tokens that already have positions.
+        static void SetTokenPositions(const SourcePosition& position, TokenStream& token_stream, std::size_t& positioned_token_count)
+        {
+            for (; positioned_token_count < token_stream.Tokens.size(); ++positioned_token_count)
+            {
+                Token& token = token_stream.Tokens[positioned_token_count];
+                token.LineNumber = position.LineNumber;
+                token.ColumnNumber = position.ColumnNumber;
+            }
         }
     };
 }
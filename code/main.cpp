@@ -1,13 +1,23 @@
 #include <cstdio>
+#include <cstdlib>
 #include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "Compilation/CommandLineArguments.h"
+#include "Compilation/Compiler.h"
+#include "Compilation/PipelinedFrontEnd.h"
+#include "Debugging/AllocationTracker.h"
 #include "GrammarAnalysis/AbstractSyntaxTree.cpp"
+#include "Server/CompileClient.h"
+#include "Server/CompileServer.h"
+#include "Server/LanguageServer.h"
 #include "Tokenization/Tokenizer.cpp"
 
+using namespace COMPILATION;
+using namespace DEBUGGING;
 using namespace TOKENIZATION;
 
 const std::string SOURCE_CODE_OLD = R"(
@@ -34,13 +44,13 @@ int main()
 }
 )";
 
-int main(const int command_line_argument_count, const char* command_line_arguments[])
+/// Compiles the built-in source code, printing intermediate results.
+/// Used when no input files are specified.
+void CompileBuiltInSourceCode()
 {
-    // Source code -> Tokenizer -> TokenStream -> GrammarAnalysisAlgorithm -> AbstractSyntaxTree -> Code Generator -> Assembly Code
-    
-    std::printf("Starting compiler...\n");
-    
-    TokenStream token_stream = Tokenizer::Tokenize(SOURCE_CODE);
+    // The tokenizer and parser run concurrently, so tokens are only printed once both finish.
+    TokenStream token_stream;
+    Program program = PipelinedFrontEnd::TokenizeAndParse(SOURCE_CODE, token_stream);
 
     std::printf("\nTokens:\n");
     for (const Token& token : token_stream.Tokens)
@@ -48,14 +58,79 @@ int main(const int command_line_argument_count, const char* command_line_argumen
         /// @todo   Token type strings!
         std::printf("%d = %s\n", token.Type, token.Value.c_str());
     }
-
-    Program program = Parse(token_stream);
     
     for (const auto& [function_name, function_definition] : program.FunctionsByName)
     {
         std::printf("Function %s returning %s", function_definition.Header.Name.c_str(), function_definition.Header.ReturnType.c_str());
     }
+}
+
+int main(const int command_line_argument_count, const char* command_line_arguments[])
+{
+    // Source code -> Tokenizer -> TokenStream -> GrammarAnalysisAlgorithm -> AbstractSyntaxTree -> Code Generator -> Assembly Code
+    
+    // PARSE THE COMMAND LINE ARGUMENTS.
+    std::optional<CommandLineArguments> arguments = CommandLineArguments::Parse(command_line_argument_count, command_line_arguments);
+    if (!arguments)
+    {
+        CommandLineArguments::PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    // RUN AS A LANGUAGE SERVER IF REQUESTED.
+    // Standard output only carries protocol messages in this mode, so nothing else is printed.
+    if (arguments->LanguageServerRequested)
+    {
+        return SERVER::LanguageServer::Run(stdin, stdout, arguments->JobCount);
+    }
+
+    std::printf("Starting compiler...\n");
+    if (arguments->HelpRequested)
+    {
+        CommandLineArguments::PrintUsage();
+        return EXIT_SUCCESS;
+    }
+    
+    // COMPILE THE APPROPRIATE SOURCE CODE.
+    int exit_code = EXIT_SUCCESS;
+    bool input_files_specified = !arguments->InputPaths.empty();
+    bool server_mode_requested = (arguments->ServerSocketPath || arguments->ClientSocketPath);
+    if (server_mode_requested)
+    {
+#if __linux__
+        if (arguments->ServerSocketPath)
+        {
+            exit_code = SERVER::CompileServer::Run(*arguments->ServerSocketPath, arguments->JobCount);
+        }
+        else
+        {
+            // Arguments are forwarded unchanged so the server interprets them exactly as this process would.
+            std::vector<std::string> forwarded_arguments(command_line_arguments + 1, command_line_arguments + command_line_argument_count);
+            SERVER::RequestType request_type = arguments->StopServerRequested ? SERVER::RequestType::SHUTDOWN : SERVER::RequestType::COMPILE;
+            exit_code = SERVER::CompileClient::Run(*arguments->ClientSocketPath, request_type, forwarded_arguments);
+        }
+#else
+        std::fprintf(stderr, "Compile server mode is only supported on Linux.\n");
+        exit_code = EXIT_FAILURE;
+#endif
+    }
+    else if (input_files_specified)
+    {
+        exit_code = Compiler::CompileFiles(*arguments);
+    }
+    else
+    {
+        CompileBuiltInSourceCode();
+    }
+    
+#if ALLOCATION_TRACKING
+    {
+        ScopedCompilerPhase reporting_phase(CompilerPhase::REPORTING);
+        constexpr std::size_t TOP_ALLOCATION_CALL_SITE_COUNT = 20;
+        AllocationTracker::WriteReport(stderr, TOP_ALLOCATION_CALL_SITE_COUNT);
+    }
+#endif
     
     std::printf("\nExiting...\n");
-    return 0;
+    return exit_code;
 }